@@ -249,6 +249,23 @@ function(parse_automake AM_FILE_NAME)
     list(APPEND AM_PROGRAMS ${AM_TARGET})
   endforeach()
 
+  # Search for benchmarks, creating CMake targets
+  set(AM_BENCHMARKS)
+  foreach(AM_FILE ${BENCHMARKS})
+    string(REPLACE "." "_" AM_NAME "${AM_FILE}")
+    string(REPLACE "/" "_" AM_NAME "${AM_NAME}")
+    am_add_target(bin ${AM_FOLDER} ${AM_FILE} "${${AM_NAME}_SOURCES}" "${${AM_NAME}_LDADD}")
+
+    am_target_name(${AM_FOLDER} ${AM_FILE} AM_TARGET)
+    set(${AM_TARGET}_LINK_TARGETS ${${AM_TARGET}_LINK_TARGETS} PARENT_SCOPE)
+
+    am_set_flags(${AM_TARGET} "${${AM_NAME}_CXXFLAGS}")
+
+    am_find_directories(${AM_FILE} AM_DIRECTORIES)
+
+    list(APPEND AM_BENCHMARKS ${AM_TARGET})
+  endforeach()
+
   set(AM_MAN1_MANS)
   foreach(AM_MAN ${dist_man1_MANS})
     list(APPEND AM_MAN1_MANS ${AM_MAN})
@@ -271,6 +288,7 @@ function(parse_automake AM_FILE_NAME)
   set(AM_TARGETS ${AM_TARGETS} PARENT_SCOPE)
   set(AM_STATIC_LIBRARIES ${AM_STATIC_LIBRARIES} PARENT_SCOPE)
   set(AM_PROGRAMS ${AM_PROGRAMS} PARENT_SCOPE)
+  set(AM_BENCHMARKS ${AM_BENCHMARKS} PARENT_SCOPE)
   set(AM_MAN1_MANS ${AM_MAN1_MANS} PARENT_SCOPE)
   set(AM_MAN6_MANS ${AM_MAN6_MANS} PARENT_SCOPE)
   set(AM_DOCS ${AM_DOCS} PARENT_SCOPE)
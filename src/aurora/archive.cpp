@@ -23,6 +23,8 @@
  */
 
 #include "src/common/system.h"
+#include "src/common/memreadstream.h"
+#include "src/common/mappedfile.h"
 
 #include "src/aurora/archive.h"
 
@@ -45,6 +47,10 @@ Common::HashAlgo Archive::getNameHashAlgo() const {
 	return Common::kHashNone;
 }
 
+bool Archive::getResourceLocations(ResourceLocations &UNUSED(locations)) const {
+	return false;
+}
+
 uint32 Archive::findResource(uint64 hash) const {
 	if (getNameHashAlgo() == Common::kHashNone)
 		return 0xFFFFFFFF;
@@ -64,4 +70,19 @@ uint32 Archive::findResource(const Common::UString &name, FileType type) const {
 	return 0xFFFFFFFF;
 }
 
+Common::MemoryReadStream *Archive::readArchiveData(Common::SeekableReadStream &file,
+                                                  size_t offset, size_t size) const {
+
+	// A mapped file has no shared cursor, so we can just hand out a view into it
+	const Common::MappedReadStream *mapped = dynamic_cast<const Common::MappedReadStream *>(&file);
+	if (mapped)
+		return mapped->subStream(offset, offset + size);
+
+	Common::StackLock lock(_mutex);
+
+	file.seek(offset);
+
+	return file.readStream(size);
+}
+
 } // End of namespace Aurora
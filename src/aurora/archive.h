@@ -26,22 +26,32 @@
 #define AURORA_ARCHIVE_H
 
 #include <list>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
 #include "src/common/hash.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReadStream;
 }
 
 namespace Aurora {
 
-/** An abstract file archive. */
+/** An abstract file archive.
+ *
+ *  getResource() is safe to be called concurrently from several threads
+ *  on the same archive. The archive file's data is either read directly
+ *  out of a memory mapping, or the seek and read on the shared archive
+ *  stream happen under a lock. Any decompression or decryption of the
+ *  resource's data happens outside of that lock.
+ */
 class Archive : boost::noncopyable {
 public:
 	/** A resource within the archive. */
@@ -56,6 +66,15 @@ public:
 
 	typedef std::list<Resource> ResourceList;
 
+	/** The location of a resource's data within the archive file. */
+	struct ResourceLocation {
+		uint32 offset; ///< The offset of the resource's data.
+		uint32 size;   ///< The size of the resource's data.
+	};
+
+	/** The locations of all resources, indexed by their local index. */
+	typedef std::vector<ResourceLocation> ResourceLocations;
+
 	Archive();
 	virtual ~Archive();
 
@@ -68,7 +87,10 @@ public:
 	/** Return a stream of the resource's contents.
 	 *
 	 *  @param  index The index of the resource we want.
-	 *  @param  tryNoCopy Try to return a SeekableSubReadStream of the archive instead of copying.
+	 *  @param  tryNoCopy Try to avoid copying the resource's data. This is only a hint:
+	 *                    since the archive stream's position can't be shared between
+	 *                    threads, the data is only left uncopied if the archive file is
+	 *                    memory-mapped.
 	 *  @return A (sub)stream of the resource's contents.
 	 */
 	virtual Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const = 0;
@@ -76,10 +98,38 @@ public:
 	/** Return with which algorithm the name is hashed. */
 	virtual Common::HashAlgo getNameHashAlgo() const;
 
+	/** Return where the data of all resources can be found within the archive file.
+	 *
+	 *  This only works for archives that store all their resources plainly,
+	 *  without any compression or encryption, so that a resource can be read
+	 *  by directly seeking into the archive file.
+	 *
+	 *  @param  locations The locations of the resources, indexed by their local index.
+	 *  @return true if all resources are stored plainly, false otherwise.
+	 */
+	virtual bool getResourceLocations(ResourceLocations &locations) const;
+
 	/** Return the index of the resource matching the hash, or 0xFFFFFFFF if not found. */
 	uint32 findResource(uint64 hash) const;
 	/** Return the index of the resource matching the name and type, or 0xFFFFFFFF if not found. */
 	uint32 findResource(const Common::UString &name, FileType type) const;
+
+protected:
+	/** Guards access to the archive stream's position. */
+	mutable Common::Mutex _mutex;
+
+	/** Read a chunk of data out of the archive file.
+	 *
+	 *  If the archive file is memory-mapped, this returns a view into the mapping
+	 *  without copying. Otherwise, the data is read under the archive's lock.
+	 *  Either way, this can be called from several threads at once.
+	 *
+	 *  @param  file The archive file to read from.
+	 *  @param  offset The offset of the data within the archive file.
+	 *  @param  size The size of the data.
+	 *  @return A stream of the data.
+	 */
+	Common::MemoryReadStream *readArchiveData(Common::SeekableReadStream &file, size_t offset, size_t size) const;
 };
 
 } // End of namespace Aurora
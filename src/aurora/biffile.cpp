@@ -138,15 +138,21 @@ uint32 BIFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
-Common::SeekableReadStream *BIFFile::getResource(uint32 index, bool tryNoCopy) const {
+Common::SeekableReadStream *BIFFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
-	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_bif.get(), res.offset, res.offset + res.size);
+	return readArchiveData(*_bif, res.offset, res.size);
+}
+
+bool BIFFile::getResourceLocations(ResourceLocations &locations) const {
+	locations.resize(_iResources.size());
 
-	_bif->seek(res.offset);
+	for (size_t i = 0; i < _iResources.size(); i++) {
+		locations[i].offset = _iResources[i].offset;
+		locations[i].size   = _iResources[i].size;
+	}
 
-	return _bif->readStream(res.size);
+	return true;
 }
 
 } // End of namespace Aurora
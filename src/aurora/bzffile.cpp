@@ -28,6 +28,7 @@
 #include <cassert>
 
 #include "src/common/util.h"
+#include "src/common/scopedptr.h"
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
@@ -145,10 +146,10 @@ uint32 BZFFile::getResourceSize(uint32 index) const {
 Common::SeekableReadStream *BZFFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
-	_bzf->seek(res.offset);
-
 #ifdef ENABLE_LZMA
-	return Common::decompressLZMA1(*_bzf, res.packedSize, res.size, true);
+	Common::ScopedPtr<Common::MemoryReadStream> packed(readArchiveData(*_bzf, res.offset, res.packedSize));
+
+	return Common::decompressLZMA1(*packed, res.packedSize, res.size, true);
 #else
 	throw Common::Exception("LZMA decompression disabled when building without liblzma");
 #endif
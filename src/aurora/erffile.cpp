@@ -709,16 +709,11 @@ uint32 ERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).unpackedSize;
 }
 
-Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) const {
+Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
-	if (tryNoCopy && (_header.encryption == kEncryptionNone) && (_header.compression == kCompressionNone))
-		return new Common::SeekableSubReadStream(_erf.get(), res.offset, res.offset + res.packedSize);
-
-	_erf->seek(res.offset);
-
 	// Read
-	Common::MemoryReadStream *stream = _erf->readStream(res.packedSize);
+	Common::MemoryReadStream *stream = readArchiveData(*_erf, res.offset, res.packedSize);
 
 	// Decrypt
 	if (_header.encryption != kEncryptionNone)
@@ -728,6 +723,24 @@ Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) c
 	return decompress(stream, res.unpackedSize);
 }
 
+bool ERFFile::getResourceLocations(ResourceLocations &locations) const {
+	if ((_header.encryption != kEncryptionNone) || (_header.compression != kCompressionNone))
+		return false;
+
+	locations.resize(_iResources.size());
+
+	for (size_t i = 0; i < _iResources.size(); i++) {
+		// Resources are cut down to their unpacked size, but never padded
+		if (_iResources[i].unpackedSize > _iResources[i].packedSize)
+			return false;
+
+		locations[i].offset = _iResources[i].offset;
+		locations[i].size   = _iResources[i].unpackedSize;
+	}
+
+	return true;
+}
+
 Common::MemoryReadStream *ERFFile::decrypt(Common::SeekableReadStream &cryptStream,
                                            Encryption encryption, const std::vector<byte> &password) {
 	switch (encryption) {
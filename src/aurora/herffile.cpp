@@ -156,15 +156,10 @@ uint32 HERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
-Common::SeekableReadStream *HERFFile::getResource(uint32 index, bool tryNoCopy) const {
+Common::SeekableReadStream *HERFFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
-	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_herf.get(), res.offset, res.offset + res.size);
-
-	_herf->seek(res.offset);
-
-	return _herf->readStream(res.size);
+	return readArchiveData(*_herf, res.offset, res.size);
 }
 
 Common::HashAlgo HERFFile::getNameHashAlgo() const {
@@ -0,0 +1,548 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of archive resource tables.
+ */
+
+#include <cassert>
+
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+#include "src/common/error.h"
+#include "src/common/strutil.h"
+#include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/writestream.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+#include "src/common/mappedfile.h"
+#include "src/common/filepath.h"
+
+#include "src/aurora/indexcache.h"
+
+static const uint32 kIndexCacheID = MKTAG('X', 'I', 'D', 'X');
+static const uint32 kVersion10    = MKTAG('V', '1', '.', '0');
+
+static const size_t kHeaderSize   = 40;
+static const size_t kEntrySize    = 32;
+static const size_t kDataFileSize = 32;
+static const size_t kResourceSize = 32;
+
+/** The upper limit of a resource's local index.
+ *
+ *  KEY files store the index of a resource within its BIF in 20 bits,
+ *  and ERF and RIM resource indices are way below that.
+ */
+static const uint32 kMaxResourceIndex = 0x100000;
+
+namespace Aurora {
+
+IndexCache::Resource::Resource() : hash(0), type(kFileTypeNone), index(0xFFFFFFFF), offset(0), size(0) {
+}
+
+IndexCache::DataFile::DataFile() : size(0), modificationTime(0), hashAlgo(Common::kHashNone) {
+}
+
+IndexCache::Entry::Entry() : size(0), modificationTime(0) {
+}
+
+
+IndexCache::IndexCache() : _modified(false) {
+}
+
+IndexCache::~IndexCache() {
+}
+
+void IndexCache::clear() {
+	_entries.clear();
+
+	_modified = false;
+}
+
+bool IndexCache::empty() const {
+	return _entries.empty();
+}
+
+size_t IndexCache::size() const {
+	return _entries.size();
+}
+
+bool IndexCache::isModified() const {
+	return _modified;
+}
+
+const IndexCache::Entry *IndexCache::find(const Common::UString &path) const {
+	Entries::const_iterator e = _entries.find(path);
+	if (e == _entries.end())
+		return 0;
+
+	return &e->second;
+}
+
+void IndexCache::add(const Entry &entry) {
+	_entries[entry.path] = entry;
+
+	_modified = true;
+}
+
+void IndexCache::remove(const Common::UString &path) {
+	if (_entries.erase(path) > 0)
+		_modified = true;
+}
+
+void IndexCache::prune() {
+	for (Entries::iterator e = _entries.begin(); e != _entries.end(); ) {
+		if (Common::FilePath::isRegularFile(e->first)) {
+			++e;
+			continue;
+		}
+
+		_entries.erase(e++);
+		_modified = true;
+	}
+}
+
+bool IndexCache::isUpToDate(const Common::UString &path, uint64 size, uint64 modificationTime) {
+	if (!Common::FilePath::isRegularFile(path))
+		return false;
+
+	return (Common::FilePath::getFileSize(path)         == size) &&
+	       (Common::FilePath::getModificationTime(path) == modificationTime);
+}
+
+bool IndexCache::isUpToDate(const Entry &entry) {
+	if (!isUpToDate(entry.path, entry.size, entry.modificationTime))
+		return false;
+
+	for (DataFiles::const_iterator d = entry.dataFiles.begin(); d != entry.dataFiles.end(); ++d)
+		if ((d->path != entry.path) && !isUpToDate(d->path, d->size, d->modificationTime))
+			return false;
+
+	return true;
+}
+
+bool IndexCache::createEntry(const Common::UString &path, Entry &entry) {
+	const size_t size = Common::FilePath::getFileSize(path);
+	if (size == Common::kFileInvalid)
+		return false;
+
+	entry.path             = path;
+	entry.size             = size;
+	entry.modificationTime = Common::FilePath::getModificationTime(path);
+
+	entry.dataFiles.clear();
+
+	return entry.modificationTime != 0;
+}
+
+bool IndexCache::createDataFile(const Common::UString &path, const Archive &archive, DataFile &dataFile) {
+	Archive::ResourceLocations locations;
+	if (!archive.getResourceLocations(locations))
+		return false;
+
+	const size_t size = Common::FilePath::getFileSize(path);
+	if (size == Common::kFileInvalid)
+		return false;
+
+	dataFile.path             = path;
+	dataFile.size             = size;
+	dataFile.modificationTime = Common::FilePath::getModificationTime(path);
+	dataFile.hashAlgo         = archive.getNameHashAlgo();
+
+	if (dataFile.modificationTime == 0)
+		return false;
+
+	const Archive::ResourceList &resources = archive.getResources();
+
+	dataFile.resources.clear();
+	dataFile.resources.reserve(resources.size());
+
+	for (Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		if (r->index >= locations.size())
+			return false;
+
+		dataFile.resources.push_back(Resource());
+		Resource &res = dataFile.resources.back();
+
+		res.name   = r->name;
+		res.hash   = r->hash;
+		res.type   = r->type;
+		res.index  = r->index;
+		res.offset = locations[r->index].offset;
+		res.size   = locations[r->index].size;
+	}
+
+	return true;
+}
+
+bool IndexCache::load(const Common::UString &file) {
+	clear();
+
+	if (!Common::FilePath::isRegularFile(file))
+		return false;
+
+	try {
+		// Map the cache into memory if we can, so that it's not copied before parsing
+		Common::ScopedPtr<Common::SeekableReadStream> cacheFile;
+		if (Common::MappedFile::isSupported())
+			cacheFile.reset(new Common::MappedReadStream(file));
+		else
+			cacheFile.reset(new Common::ReadFile(file));
+
+		load(*cacheFile);
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to load index cache \"%s\"", file.c_str());
+		Common::printException(e, "WARNING: ");
+
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool IndexCache::save(const Common::UString &file) {
+	try {
+		Common::WriteFile cacheFile(file);
+
+		save(cacheFile);
+		cacheFile.flush();
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to save index cache \"%s\"", file.c_str());
+		Common::printException(e, "WARNING: ");
+
+		return false;
+	}
+
+	_modified = false;
+	return true;
+}
+
+static const char *getString(const byte *strings, uint32 stringsSize, uint32 offset) {
+	// The string table is guaranteed to end in a 0, so any offset within it is a valid string
+	if (offset >= stringsSize)
+		throw Common::Exception("String offset out of range (%u/%u)", offset, stringsSize);
+
+	return reinterpret_cast<const char *>(strings + offset);
+}
+
+static void checkTable(size_t fileSize, uint32 offset, uint32 count, size_t recordSize, const char *name) {
+	if ((offset > fileSize) || (count > ((fileSize - offset) / recordSize)))
+		throw Common::Exception("Index cache %s table out of range", name);
+}
+
+void IndexCache::load(Common::SeekableReadStream &stream) {
+	clear();
+
+	/* Work directly on the flat data. If the cache is already in memory
+	 * (for example because it was mapped), use it in-place. Otherwise,
+	 * read the whole cache at once. */
+
+	const size_t fileSize = stream.size();
+	if (fileSize < kHeaderSize)
+		throw Common::Exception("Index cache too small");
+
+	Common::ScopedArray<byte> buffer;
+	const byte *data = 0;
+
+	Common::MemoryReadStream *memStream = dynamic_cast<Common::MemoryReadStream *>(&stream);
+	if (memStream) {
+		data = memStream->getData();
+	} else {
+		buffer.reset(new byte[fileSize]);
+
+		stream.seek(0);
+		if (stream.read(buffer.get(), fileSize) != fileSize)
+			throw Common::Exception(Common::kReadError);
+
+		data = buffer.get();
+	}
+
+	if (READ_BE_UINT32(data) != kIndexCacheID)
+		throw Common::Exception("Not an index cache (%s)", Common::debugTag(READ_BE_UINT32(data)).c_str());
+
+	if (READ_BE_UINT32(data + 4) != kVersion10)
+		throw Common::Exception("Unsupported index cache version %s",
+		                        Common::debugTag(READ_BE_UINT32(data + 4)).c_str());
+
+	const uint32 entryCount     = READ_LE_UINT32(data +  8);
+	const uint32 dataFileCount  = READ_LE_UINT32(data + 12);
+	const uint32 resourceCount  = READ_LE_UINT32(data + 16);
+	const uint32 stringsSize    = READ_LE_UINT32(data + 20);
+	const uint32 offEntries     = READ_LE_UINT32(data + 24);
+	const uint32 offDataFiles   = READ_LE_UINT32(data + 28);
+	const uint32 offResources   = READ_LE_UINT32(data + 32);
+	const uint32 offStrings     = READ_LE_UINT32(data + 36);
+
+	checkTable(fileSize, offEntries  , entryCount   , kEntrySize   , "archive");
+	checkTable(fileSize, offDataFiles, dataFileCount, kDataFileSize, "data file");
+	checkTable(fileSize, offResources, resourceCount, kResourceSize, "resource");
+	checkTable(fileSize, offStrings  , stringsSize  , 1            , "string");
+
+	const byte *strings = data + offStrings;
+	if ((stringsSize == 0) || (strings[stringsSize - 1] != 0))
+		throw Common::Exception("Index cache string table not terminated");
+
+	for (uint32 i = 0; i < entryCount; i++) {
+		const byte *entryData = data + offEntries + i * kEntrySize;
+
+		Entry entry;
+
+		entry.size             = READ_LE_UINT64(entryData +  0);
+		entry.modificationTime = READ_LE_UINT64(entryData +  8);
+		entry.path             = getString(strings, stringsSize, READ_LE_UINT32(entryData + 16));
+
+		const uint32 firstDataFile = READ_LE_UINT32(entryData + 20);
+		const uint32 entryDataFiles = READ_LE_UINT32(entryData + 24);
+
+		if ((firstDataFile > dataFileCount) || (entryDataFiles > (dataFileCount - firstDataFile)))
+			throw Common::Exception("Index cache data files out of range");
+
+		entry.dataFiles.resize(entryDataFiles);
+		for (uint32 j = 0; j < entryDataFiles; j++) {
+			const byte *fileData = data + offDataFiles + (firstDataFile + j) * kDataFileSize;
+
+			DataFile &dataFile = entry.dataFiles[j];
+
+			dataFile.size             = READ_LE_UINT64(fileData +  0);
+			dataFile.modificationTime = READ_LE_UINT64(fileData +  8);
+			dataFile.path             = getString(strings, stringsSize, READ_LE_UINT32(fileData + 16));
+
+			const int32 hashAlgo = (int32) READ_LE_UINT32(fileData + 20);
+			if ((hashAlgo != Common::kHashNone) && ((hashAlgo < 0) || (hashAlgo >= Common::kHashMAX)))
+				throw Common::Exception("Index cache data file \"%s\" has invalid hash algorithm %d",
+				                        dataFile.path.c_str(), hashAlgo);
+
+			dataFile.hashAlgo = (Common::HashAlgo) hashAlgo;
+
+			const uint32 firstResource = READ_LE_UINT32(fileData + 24);
+			const uint32 fileResources = READ_LE_UINT32(fileData + 28);
+
+			if ((firstResource > resourceCount) || (fileResources > (resourceCount - firstResource)))
+				throw Common::Exception("Index cache resources out of range");
+
+			dataFile.resources.resize(fileResources);
+			for (uint32 k = 0; k < fileResources; k++) {
+				const byte *resData = data + offResources + (firstResource + k) * kResourceSize;
+
+				Resource &res = dataFile.resources[k];
+
+				res.hash   = READ_LE_UINT64(resData +  0);
+				res.name   = getString(strings, stringsSize, READ_LE_UINT32(resData + 8));
+				res.type   = (FileType) READ_LE_UINT32(resData + 12);
+				res.index  = READ_LE_UINT32(resData + 16);
+				res.offset = READ_LE_UINT32(resData + 20);
+				res.size   = READ_LE_UINT32(resData + 24);
+
+				if ((res.index >= kMaxResourceIndex) ||
+				    (res.offset > dataFile.size) || (res.size > (dataFile.size - res.offset)))
+					throw Common::Exception("Index cache resource \"%s\" out of range", res.name.c_str());
+			}
+		}
+
+		_entries[entry.path] = entry;
+	}
+
+	_modified = false;
+}
+
+/** Collects all strings written into an index cache, each only once. */
+class IndexCacheStrings {
+public:
+	IndexCacheStrings() : _size(0) {
+		add("");
+	}
+
+	uint32 add(const Common::UString &str) {
+		std::pair<Offsets::iterator, bool> result = _offsets.insert(std::make_pair(str, _size));
+		if (result.second) {
+			_strings.push_back(&result.first->first);
+			_size += str.size() + 1;
+		}
+
+		return result.first->second;
+	}
+
+	uint32 size() const {
+		return _size;
+	}
+
+	void write(Common::WriteStream &stream) const {
+		for (std::vector<const Common::UString *>::const_iterator s = _strings.begin(); s != _strings.end(); ++s)
+			stream.write((*s)->c_str(), (*s)->size() + 1);
+	}
+
+private:
+	typedef std::map<Common::UString, uint32> Offsets;
+
+	Offsets _offsets;
+	std::vector<const Common::UString *> _strings;
+
+	uint32 _size;
+};
+
+void IndexCache::save(Common::WriteStream &stream) const {
+	IndexCacheStrings strings;
+
+	uint32 dataFileCount = 0, resourceCount = 0;
+	for (Entries::const_iterator e = _entries.begin(); e != _entries.end(); ++e) {
+		strings.add(e->second.path);
+
+		dataFileCount += e->second.dataFiles.size();
+
+		for (DataFiles::const_iterator d = e->second.dataFiles.begin(); d != e->second.dataFiles.end(); ++d) {
+			strings.add(d->path);
+
+			resourceCount += d->resources.size();
+
+			for (Resources::const_iterator r = d->resources.begin(); r != d->resources.end(); ++r)
+				strings.add(r->name);
+		}
+	}
+
+	const uint32 offEntries   = kHeaderSize;
+	const uint32 offDataFiles = offEntries   + _entries.size() * kEntrySize;
+	const uint32 offResources = offDataFiles + dataFileCount   * kDataFileSize;
+	const uint32 offStrings   = offResources + resourceCount   * kResourceSize;
+
+	stream.writeUint32BE(kIndexCacheID);
+	stream.writeUint32BE(kVersion10);
+
+	stream.writeUint32LE(_entries.size());
+	stream.writeUint32LE(dataFileCount);
+	stream.writeUint32LE(resourceCount);
+	stream.writeUint32LE(strings.size());
+
+	stream.writeUint32LE(offEntries);
+	stream.writeUint32LE(offDataFiles);
+	stream.writeUint32LE(offResources);
+	stream.writeUint32LE(offStrings);
+
+	uint32 firstDataFile = 0;
+	for (Entries::const_iterator e = _entries.begin(); e != _entries.end(); ++e) {
+		stream.writeUint64LE(e->second.size);
+		stream.writeUint64LE(e->second.modificationTime);
+		stream.writeUint32LE(strings.add(e->second.path));
+		stream.writeUint32LE(firstDataFile);
+		stream.writeUint32LE(e->second.dataFiles.size());
+		stream.writeUint32LE(0);
+
+		firstDataFile += e->second.dataFiles.size();
+	}
+
+	uint32 firstResource = 0;
+	for (Entries::const_iterator e = _entries.begin(); e != _entries.end(); ++e) {
+		for (DataFiles::const_iterator d = e->second.dataFiles.begin(); d != e->second.dataFiles.end(); ++d) {
+			stream.writeUint64LE(d->size);
+			stream.writeUint64LE(d->modificationTime);
+			stream.writeUint32LE(strings.add(d->path));
+			stream.writeUint32LE((uint32) d->hashAlgo);
+			stream.writeUint32LE(firstResource);
+			stream.writeUint32LE(d->resources.size());
+
+			firstResource += d->resources.size();
+		}
+	}
+
+	for (Entries::const_iterator e = _entries.begin(); e != _entries.end(); ++e) {
+		for (DataFiles::const_iterator d = e->second.dataFiles.begin(); d != e->second.dataFiles.end(); ++d) {
+			for (Resources::const_iterator r = d->resources.begin(); r != d->resources.end(); ++r) {
+				stream.writeUint64LE(r->hash);
+				stream.writeUint32LE(strings.add(r->name));
+				stream.writeUint32LE((uint32) r->type);
+				stream.writeUint32LE(r->index);
+				stream.writeUint32LE(r->offset);
+				stream.writeUint32LE(r->size);
+				stream.writeUint32LE(0);
+			}
+		}
+	}
+
+	strings.write(stream);
+}
+
+
+CachedArchive::CachedArchive(Common::SeekableReadStream *file, const IndexCache::DataFile &dataFile) :
+	_file(file), _hashAlgo(dataFile.hashAlgo) {
+
+	assert(_file);
+
+	if (_file->size() != dataFile.size)
+		throw Common::Exception("Cached archive \"%s\" changed size", dataFile.path.c_str());
+
+	for (IndexCache::Resources::const_iterator r = dataFile.resources.begin(); r != dataFile.resources.end(); ++r) {
+		Resource res;
+
+		res.name  = r->name;
+		res.hash  = r->hash;
+		res.type  = r->type;
+		res.index = r->index;
+
+		_resources.push_back(res);
+
+		if (r->index >= _locations.size()) {
+			ResourceLocation invalid = { 0xFFFFFFFF, 0 };
+
+			_locations.resize(r->index + 1, invalid);
+		}
+
+		_locations[r->index].offset = r->offset;
+		_locations[r->index].size   = r->size;
+	}
+}
+
+CachedArchive::~CachedArchive() {
+}
+
+const Archive::ResourceList &CachedArchive::getResources() const {
+	return _resources;
+}
+
+Common::HashAlgo CachedArchive::getNameHashAlgo() const {
+	return _hashAlgo;
+}
+
+const Archive::ResourceLocation &CachedArchive::getLocation(uint32 index) const {
+	if ((index >= _locations.size()) || (_locations[index].offset == 0xFFFFFFFF))
+		throw Common::Exception("Resource index out of range (%u/%u)", index, (uint)_locations.size());
+
+	return _locations[index];
+}
+
+uint32 CachedArchive::getResourceSize(uint32 index) const {
+	return getLocation(index).size;
+}
+
+Common::SeekableReadStream *CachedArchive::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
+	const ResourceLocation &location = getLocation(index);
+
+	return readArchiveData(*_file, location.offset, location.size);
+}
+
+bool CachedArchive::getResourceLocations(ResourceLocations &locations) const {
+	locations = _locations;
+
+	return true;
+}
+
+} // End of namespace Aurora
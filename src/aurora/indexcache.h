@@ -0,0 +1,230 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of archive resource tables.
+ */
+
+#ifndef AURORA_INDEXCACHE_H
+#define AURORA_INDEXCACHE_H
+
+#include <vector>
+#include <map>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/hash.h"
+#include "src/common/scopedptr.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/archive.h"
+
+namespace Common {
+	class SeekableReadStream;
+	class WriteStream;
+}
+
+namespace Aurora {
+
+/** A persistent cache of archive resource tables.
+ *
+ *  Reading the resource tables of all archives of a game, and of the
+ *  KEY files with all their BIFs in particular, can take a noticeable
+ *  amount of time on each start. The index cache stores these tables
+ *  in one flat file, together with the size and modification time of
+ *  every file involved, so that archives that haven't changed since
+ *  can be indexed without parsing them again.
+ *
+ *  Only archives that store their resources plainly, uncompressed and
+ *  unencrypted, can be cached, since the cached resources are read
+ *  directly out of the archive files.
+ *
+ *  The cache file consists of a header, followed by tables of fixed-size
+ *  little-endian records for the archives, their data files and their
+ *  resources, and finally a table of all strings. All records refer to
+ *  each other by index, and to strings by offset.
+ */
+class IndexCache : boost::noncopyable {
+public:
+	/** A cached resource. */
+	struct Resource {
+		Common::UString name;  ///< The resource's name.
+		uint64          hash;  ///< The resource's hashed name.
+		FileType        type;  ///< The resource's type.
+		uint32          index; ///< The resource's local index within the data file.
+
+		uint32 offset; ///< The offset of the resource's data within the data file.
+		uint32 size;   ///< The size of the resource's data.
+
+		Resource();
+	};
+
+	typedef std::vector<Resource> Resources;
+
+	/** A file holding the data of cached resources. */
+	struct DataFile {
+		Common::UString path;             ///< The path of the file.
+		uint64          size;             ///< The size of the file.
+		uint64          modificationTime; ///< The time the file was last modified.
+
+		/** With which algorithm the resource names are hashed. */
+		Common::HashAlgo hashAlgo;
+
+		Resources resources; ///< All resources within this file.
+
+		DataFile();
+	};
+
+	typedef std::vector<DataFile> DataFiles;
+
+	/** A cached archive.
+	 *
+	 *  For ERF and RIM archives, the archive file itself is its only data
+	 *  file. For KEY archives, the data files are the KEY's BIFs.
+	 */
+	struct Entry {
+		Common::UString path;             ///< The path of the archive file.
+		uint64          size;             ///< The size of the archive file.
+		uint64          modificationTime; ///< The time the archive file was last modified.
+
+		DataFiles dataFiles; ///< The files holding the archive's resource data.
+
+		Entry();
+	};
+
+	IndexCache();
+	~IndexCache();
+
+	/** Remove all cached archives. */
+	void clear();
+
+	/** Are there no cached archives? */
+	bool empty() const;
+	/** Return the number of cached archives. */
+	size_t size() const;
+
+	/** Were archives added or removed since the cache was loaded or saved? */
+	bool isModified() const;
+
+	/** Load a cache file, replacing the current contents.
+	 *
+	 *  @param  file The cache file to load.
+	 *  @return true if the cache file was loaded, false if it doesn't exist or is invalid.
+	 */
+	bool load(const Common::UString &file);
+
+	/** Save the cache into a file.
+	 *
+	 *  @param  file The cache file to write.
+	 *  @return true if the cache file was written, false otherwise.
+	 */
+	bool save(const Common::UString &file);
+
+	/** Read the cache out of a stream, replacing the current contents. */
+	void load(Common::SeekableReadStream &stream);
+	/** Write the cache into a stream. */
+	void save(Common::WriteStream &stream) const;
+
+	/** Return the cached archive with this path, or 0 if there is none. */
+	const Entry *find(const Common::UString &path) const;
+
+	/** Add an archive to the cache, replacing an existing entry with the same path. */
+	void add(const Entry &entry);
+
+	/** Remove an archive from the cache. */
+	void remove(const Common::UString &path);
+
+	/** Remove all archives that don't exist on disk anymore. */
+	void prune();
+
+	/** Is the archive and all its data files still the same on disk?
+	 *
+	 *  That is, do they still exist, and are their sizes and modification
+	 *  times still the ones recorded in the cache?
+	 */
+	static bool isUpToDate(const Entry &entry);
+
+	/** Describe a file and its archive as a cacheable data file.
+	 *
+	 *  @param  path The path of the data file.
+	 *  @param  archive The parsed archive of the data file.
+	 *  @param  dataFile The description of the data file will be stored here.
+	 *  @return true if the archive can be cached, false otherwise.
+	 */
+	static bool createDataFile(const Common::UString &path, const Archive &archive, DataFile &dataFile);
+
+	/** Describe an archive file itself, without any data files. */
+	static bool createEntry(const Common::UString &path, Entry &entry);
+
+private:
+	typedef std::map<Common::UString, Entry> Entries;
+
+	Entries _entries;
+
+	bool _modified;
+
+	static bool isUpToDate(const Common::UString &path, uint64 size, uint64 modificationTime);
+};
+
+/** An archive read through a cached resource table.
+ *
+ *  Instead of parsing the archive file, the list of resources and the
+ *  locations of their data are taken out of the index cache.
+ */
+class CachedArchive : public Archive {
+public:
+	/** Take over this stream of the data file and use the cached data file description. */
+	CachedArchive(Common::SeekableReadStream *file, const IndexCache::DataFile &dataFile);
+	~CachedArchive();
+
+	/** Return the list of resources. */
+	const ResourceList &getResources() const;
+
+	/** Return the size of a resource. */
+	uint32 getResourceSize(uint32 index) const;
+
+	/** Return a stream of the resource's contents. */
+	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
+
+	/** Return with which algorithm the name is hashed. */
+	Common::HashAlgo getNameHashAlgo() const;
+
+	/** Return where the data of all resources can be found within the archive file. */
+	bool getResourceLocations(ResourceLocations &locations) const;
+
+private:
+	Common::ScopedPtr<Common::SeekableReadStream> _file;
+
+	Common::HashAlgo _hashAlgo;
+
+	/** External list of resource names and types. */
+	ResourceList _resources;
+
+	/** Internal list of resource offsets and sizes. */
+	ResourceLocations _locations;
+
+	const ResourceLocation &getLocation(uint32 index) const;
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_INDEXCACHE_H
@@ -163,17 +163,10 @@ uint32 NDSFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
-Common::SeekableReadStream *NDSFile::getResource(uint32 index, bool tryNoCopy) const {
+Common::SeekableReadStream *NDSFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
-	_nds->seek(res.offset);
-
-	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_nds.get(), res.offset, res.offset + res.size);
-
-	_nds->seek(res.offset);
-
-	return _nds->readStream(res.size);
+	return readArchiveData(*_nds, res.offset, res.size);
 }
 
 } // End of namespace Aurora
@@ -330,6 +330,8 @@ Common::SeekableReadStream *NSBTXFile::getResource(uint32 index, bool UNUSED(try
 
 	Common::MemoryWriteStreamDynamic stream(true, getITEXSize(_textures[index]));
 
+	Common::StackLock lock(_mutex);
+
 	ReadContext ctx(*_nsbtx, _textures[index], stream);
 	writeITEXHeader(ctx);
 
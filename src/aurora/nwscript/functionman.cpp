@@ -103,10 +103,24 @@ FunctionContext FunctionManager::createContext(uint32 function) const {
 }
 
 void FunctionManager::call(uint32 function, FunctionContext &ctx) const {
+	call(find(function).func, ctx);
+}
+
+bool FunctionManager::bind(uint32 function, Function &func, FunctionContext &ctx) const {
+	if ((function >= _functionArray.size()) || _functionArray[function].empty)
+		return false;
+
+	func = _functionArray[function].func;
+	ctx  = _functionArray[function].ctx;
+
+	return true;
+}
+
+void FunctionManager::call(const Function &func, FunctionContext &ctx) const {
 	debugCN(Common::kDebugEngineScripts, 5, "%s %s(%s)", formatType(ctx.getReturn().getType()).c_str(),
 	        ctx.getName().c_str(), formatParams(ctx).c_str());
 
-	find(function).func(ctx);
+	func(ctx);
 
 	const Common::UString r = formatReturn(ctx);
 	debugC(Common::kDebugEngineScripts, 5, "%s%s", r.empty() ? "" : " => ", r.c_str());
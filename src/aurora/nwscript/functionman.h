@@ -57,6 +57,17 @@ public:
 	FunctionContext createContext(uint32 function) const;
 	void call(uint32 function, FunctionContext &ctx) const;
 
+	/** Look up a function once, so that it can be called repeatedly without searching for it.
+	 *
+	 *  @param  function The ID of the function.
+	 *  @param  func The function itself will be copied into here.
+	 *  @param  ctx A fresh context for the function will be copied into here.
+	 *  @return false if there is no such function.
+	 */
+	bool bind(uint32 function, Function &func, FunctionContext &ctx) const;
+	/** Call a function previously looked up with bind(). */
+	void call(const Function &func, FunctionContext &ctx) const;
+
 private:
 	struct FunctionEntry {
 		bool empty;
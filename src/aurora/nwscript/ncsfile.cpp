@@ -188,84 +188,84 @@ void NCSStack::print() const {
 }
 
 
-#define OPCODE(x) { &NCSFile::x, #x }
-#define OPCODE0() { 0, "" }
+#define OPCODE(x, args) { &NCSFile::x, #x, args }
+#define OPCODE0() { 0, "", kArgsNone }
 
 void NCSFile::setupOpcodes() {
 	static const Opcode opcodes[] = {
 		// 0x00
-		OPCODE(o_nop), // Doesn't exist
-		OPCODE(o_cpdownsp),
-		OPCODE(o_rsadd),
-		OPCODE(o_cptopsp),
+		OPCODE(o_nop,            kArgsNone), // Doesn't exist
+		OPCODE(o_cpdownsp,       kArgsInt32Int16),
+		OPCODE(o_rsadd,          kArgsNone),
+		OPCODE(o_cptopsp,        kArgsInt32Int16),
 		// 0x04
-		OPCODE(o_const),
-		OPCODE(o_action),
-		OPCODE(o_logand),
-		OPCODE(o_logor),
+		OPCODE(o_const,          kArgsConst),
+		OPCODE(o_action,         kArgsAction),
+		OPCODE(o_logand,         kArgsNone),
+		OPCODE(o_logor,          kArgsNone),
 		// 0x08
-		OPCODE(o_incor),
-		OPCODE(o_excor),
-		OPCODE(o_booland),
-		OPCODE(o_eq),
+		OPCODE(o_incor,          kArgsNone),
+		OPCODE(o_excor,          kArgsNone),
+		OPCODE(o_booland,        kArgsNone),
+		OPCODE(o_eq,             kArgsStructSize),
 		// 0x0C
-		OPCODE(o_neq),
-		OPCODE(o_geq),
-		OPCODE(o_gt),
-		OPCODE(o_lt),
+		OPCODE(o_neq,            kArgsStructSize),
+		OPCODE(o_geq,            kArgsNone),
+		OPCODE(o_gt,             kArgsNone),
+		OPCODE(o_lt,             kArgsNone),
 		// 0x10
-		OPCODE(o_leq),
-		OPCODE(o_shleft),
-		OPCODE(o_shright),
-		OPCODE(o_ushright),
+		OPCODE(o_leq,            kArgsNone),
+		OPCODE(o_shleft,         kArgsNone),
+		OPCODE(o_shright,        kArgsNone),
+		OPCODE(o_ushright,       kArgsNone),
 		// 0x14
-		OPCODE(o_add),
-		OPCODE(o_sub),
-		OPCODE(o_mul),
-		OPCODE(o_div),
+		OPCODE(o_add,            kArgsNone),
+		OPCODE(o_sub,            kArgsNone),
+		OPCODE(o_mul,            kArgsNone),
+		OPCODE(o_div,            kArgsNone),
 		// 0x18
-		OPCODE(o_mod),
-		OPCODE(o_neg),
-		OPCODE(o_comp),
-		OPCODE(o_movsp),
+		OPCODE(o_mod,            kArgsNone),
+		OPCODE(o_neg,            kArgsNone),
+		OPCODE(o_comp,           kArgsNone),
+		OPCODE(o_movsp,          kArgsInt32),
 		// 0x1C
-		OPCODE(o_storestateall),
-		OPCODE(o_jmp),
-		OPCODE(o_jsr),
-		OPCODE(o_jz),
+		OPCODE(o_storestateall,  kArgsNone),
+		OPCODE(o_jmp,            kArgsJump),
+		OPCODE(o_jsr,            kArgsJump),
+		OPCODE(o_jz,             kArgsJump),
 		// 0x20
-		OPCODE(o_retn),
-		OPCODE(o_destruct),
-		OPCODE(o_not),
-		OPCODE(o_decsp),
+		OPCODE(o_retn,           kArgsNone),
+		OPCODE(o_destruct,       kArgsInt16x3),
+		OPCODE(o_not,            kArgsNone),
+		OPCODE(o_decsp,          kArgsInt32),
 		// 0x24
-		OPCODE(o_incsp),
-		OPCODE(o_jnz),
-		OPCODE(o_cpdownbp),
-		OPCODE(o_cptopbp),
+		OPCODE(o_incsp,          kArgsInt32),
+		OPCODE(o_jnz,            kArgsJump),
+		OPCODE(o_cpdownbp,       kArgsInt32Int16),
+		OPCODE(o_cptopbp,        kArgsInt32Int16),
 		// 0x28
-		OPCODE(o_decbp),
-		OPCODE(o_incbp),
-		OPCODE(o_savebp),
-		OPCODE(o_restorebp),
+		OPCODE(o_decbp,          kArgsInt32),
+		OPCODE(o_incbp,          kArgsInt32),
+		OPCODE(o_savebp,         kArgsNone),
+		OPCODE(o_restorebp,      kArgsNone),
 		// 0x2C
-		OPCODE(o_storestate),
-		OPCODE(o_nop),
+		OPCODE(o_storestate,     kArgsUint32x2),
+		OPCODE(o_nop,            kArgsNone),
 		OPCODE0(),
 		OPCODE0(),
 		// 0x30
-		OPCODE(o_writearray),
+		OPCODE(o_writearray,     kArgsInt32Int16),
 		OPCODE0(),
-		OPCODE(o_readarray),
+		OPCODE(o_readarray,      kArgsInt32Int16),
 		OPCODE0(),
 		// 0x34
 		OPCODE0(),
 		OPCODE0(),
 		OPCODE0(),
-		OPCODE(o_getref),
+		OPCODE(o_getref,         kArgsInt32Int16),
 		// 0x38
 		OPCODE0(),
-		OPCODE(o_getrefarray)
+		OPCODE(o_getrefarray,    kArgsInt32Int16)
 	};
 
 	_opcodes = opcodes;
@@ -273,6 +273,7 @@ void NCSFile::setupOpcodes() {
 }
 
 #undef OPCODE
+#undef OPCODE0
 
 NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _script(ncs) {
 	assert(_script);
@@ -332,19 +333,195 @@ void NCSFile::load() {
 
 	setupOpcodes();
 
+	decode();
+	resolveJumps();
+	bindEngineCalls();
+
+	// Everything we need is in the decoded instructions now
+	_script.reset();
+
 	reset();
 }
 
+void NCSFile::decode() {
+	/* Decode all instructions up front, so that running the script doesn't
+	 * need to go through the stream, nor figure out the size of each
+	 * instruction again and again.
+	 *
+	 * An instruction we can't decode will only throw when it is actually
+	 * executed, same as it would when interpreting the bytecode directly.
+	 * Since we then don't know where the next instruction starts, we have
+	 * to stop decoding there, though. */
+
+	_script->seek(13); // 8 byte header + 5 byte program size dummy op
+
+	_endAddress = 0xFFFFFFFF;
+
+	const size_t size = _script->size();
+	while ((size - _script->pos()) >= 2) {
+		Instruction instr;
+
+		instr.address  = _script->pos();
+		instr.opcode   = _script->readByte();
+		instr.type     = (InstructionType) _script->readByte();
+		instr.proc     = &NCSFile::o_illegal;
+		instr.argFloat = 0.0f;
+		instr.target   = SIZE_MAX;
+
+		instr.args[0] = instr.args[1] = instr.args[2] = 0;
+
+		bool decoded = false;
+		try {
+			decoded = decodeArguments(instr);
+		} catch (...) {
+			// The instruction is truncated
+			instr.proc = &NCSFile::o_illegal;
+		}
+
+		_instructions.push_back(instr);
+
+		if (!decoded)
+			return;
+	}
+
+	_endAddress = _script->pos();
+}
+
+bool NCSFile::decodeArguments(Instruction &instr) {
+	if ((instr.opcode >= _opcodeListSize) || (!_opcodes[instr.opcode].proc))
+		return false;
+
+	const Opcode &opcode = _opcodes[instr.opcode];
+
+	switch (opcode.args) {
+		case kArgsNone:
+			break;
+
+		case kArgsInt32:
+		case kArgsJump:
+			instr.args[0] = _script->readSint32BE();
+			break;
+
+		case kArgsInt32Int16:
+			instr.args[0] = _script->readSint32BE();
+			instr.args[1] = _script->readSint16BE();
+			break;
+
+		case kArgsInt16x3:
+			instr.args[0] = _script->readSint16BE();
+			instr.args[1] = _script->readSint16BE();
+			instr.args[2] = _script->readSint16BE();
+			break;
+
+		case kArgsUint32x2:
+			instr.args[0] = (int32) _script->readUint32BE();
+			instr.args[1] = (int32) _script->readUint32BE();
+			break;
+
+		case kArgsAction:
+			instr.args[0] = _script->readUint16BE();
+			instr.args[1] = _script->readByte();
+			break;
+
+		case kArgsStructSize:
+			if (instr.type == kInstTypeStructStruct)
+				instr.args[0] = _script->readUint16BE();
+			break;
+
+		case kArgsConst:
+			switch (instr.type) {
+				case kInstTypeInt:
+				case kInstTypeObject:
+					instr.args[0] = _script->readSint32BE();
+					break;
+
+				case kInstTypeFloat:
+					instr.argFloat = _script->readIEEEFloatBE();
+					break;
+
+				case kInstTypeString:
+				case kInstTypeResource:
+					instr.target = _strings.size();
+					_strings.push_back(Common::readStringFixed(*_script, Common::kEncodingASCII, _script->readUint16BE()));
+					break;
+
+				default:
+					// Unknown constant type, we don't know its size. o_const() will throw
+					instr.proc = opcode.proc;
+					return false;
+			}
+			break;
+	}
+
+	instr.proc = opcode.proc;
+	return true;
+}
+
+void NCSFile::resolveJumps() {
+	for (std::vector<Instruction>::iterator i = _instructions.begin(); i != _instructions.end(); ++i) {
+		if ((i->proc == &NCSFile::o_illegal) || (_opcodes[i->opcode].args != kArgsJump))
+			continue;
+
+		try {
+			i->target = findInstruction(i->address + i->args[0]);
+		} catch (...) {
+			// Leave the target invalid. Only throw if the jump is actually taken
+		}
+	}
+}
+
+void NCSFile::bindEngineCalls() {
+	/* Look up each called engine function only once, and give each ACTION
+	 * its own context to reuse. Then we neither need to search for the
+	 * function nor copy a new context with all its parameters every time.
+	 *
+	 * An unknown function will only throw when it is actually called. */
+
+	for (std::vector<Instruction>::iterator i = _instructions.begin(); i != _instructions.end(); ++i) {
+		if ((i->proc != &NCSFile::o_action) || (i->type != kInstTypeNone))
+			continue;
+
+		EngineCall call;
+		if (!FunctionMan.bind(i->args[0], call.function, call.prototype))
+			continue;
+
+		call.context = call.prototype;
+		call.busy    = false;
+
+		i->target = _engineCalls.size();
+		_engineCalls.push_back(call);
+	}
+}
+
+size_t NCSFile::findInstruction(uint32 address) const {
+	if (address == _endAddress)
+		return _instructions.size();
+
+	size_t lower = 0, upper = _instructions.size();
+	while (lower < upper) {
+		const size_t middle = lower + (upper - lower) / 2;
+
+		if      (_instructions[middle].address < address)
+			lower = middle + 1;
+		else if (_instructions[middle].address > address)
+			upper = middle;
+		else
+			return middle;
+	}
+
+	throw Common::Exception("NCSFile::findInstruction(): No instruction at offset 0x%08X", address);
+}
+
 void NCSFile::reset() {
 	_stack.reset();
 
-	while (!_returnOffsets.empty())
-		_returnOffsets.pop();
+	while (!_returnIndices.empty())
+		_returnIndices.pop();
 
 	_storedState.setType(kTypeVoid);
 	_return.setType(kTypeVoid);
 
-	_script->seek(13); // 8 byte header + 5 byte program size dummy op
+	_pc = 0;
 }
 
 const Variable &NCSFile::run(Object *owner, Object *triggerer) {
@@ -365,7 +542,7 @@ const Variable &NCSFile::run(const ScriptState &state, const ObjectReference own
 
 	reset();
 
-	_script->seek(state.offset);
+	_pc = findInstruction(state.offset);
 
 	// Push global variables
 	std::vector<class Variable>::const_reverse_iterator var;
@@ -385,8 +562,18 @@ const Variable &NCSFile::execute(const ObjectReference owner, const ObjectRefere
 	_owner     = owner;
 	_triggerer = triggerer;
 
-	while (executeStep())
-		;
+	_debug = DebugMan.isEnabled(kDebugScripts, 1);
+
+	if (_debug) {
+		while (executeStep())
+			;
+	} else {
+		while (_pc < _instructions.size()) {
+			const Instruction &instr = _instructions[_pc++];
+
+			(this->*(instr.proc))(instr);
+		}
+	}
 
 	if (!_stack.empty())
 		_return = _stack.top();
@@ -402,43 +589,39 @@ const Variable &NCSFile::execute(const ObjectReference owner, const ObjectRefere
 }
 
 bool NCSFile::executeStep() {
-	byte opcode, type;
-
-	try {
-		opcode = _script->readByte();
-		type   = _script->readByte();
-	} catch (...) {
+	if (_pc >= _instructions.size())
 		return false;
-	}
 
-	if ((opcode >= _opcodeListSize) || (!_opcodes[opcode].proc))
-		throw Common::Exception("NCSFile::executeStep(): Illegal instruction 0x%02x", opcode);
+	const Instruction &instr = _instructions[_pc++];
 
-	debugC(kDebugScripts, 1, "NWScript opcode %s [0x%02X]", _opcodes[opcode].desc, opcode);
+	const char *desc = (instr.opcode < _opcodeListSize) ? _opcodes[instr.opcode].desc : "";
+	debugC(kDebugScripts, 1, "NWScript opcode %s [0x%02X]", desc, instr.opcode);
 
-	(this->*(_opcodes[opcode].proc))((InstructionType)type);
+	(this->*(instr.proc))(instr);
 
 	_stack.print();
 	debugC(kDebugScripts, 2, "[RETURN: %d]",
-	       _returnOffsets.empty() ? -1 : _returnOffsets.top());
+	       _returnIndices.empty() ? -1 : (int) _returnIndices.top());
 
 	return true;
 }
 
-void NCSFile::decompile() {
-	uint32 oldScriptPos = _script->pos();
-	_script->seek(13); // 8 byte header + 5 byte program size dummy op
+void NCSFile::jump(size_t target) {
+	if (target > _instructions.size())
+		throw Common::Exception("NCSFile::jump(): Jump to an invalid offset");
 
-	// TODO
+	_pc = target;
+}
 
-	_script->seek(oldScriptPos);
+void NCSFile::decompile() {
+	// TODO
 }
 
 // OPCODES!
 
 /** RSADD: push an empty variable onto the stack. */
-void NCSFile::o_rsadd(InstructionType type) {
-	switch (type) {
+void NCSFile::o_rsadd(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeInt:
 			_stack.push(kTypeInt);
 			break;
@@ -474,24 +657,24 @@ void NCSFile::o_rsadd(InstructionType type) {
 			_stack.push(kTypeArray);
 			break;
 		default:
-			throw Common::Exception("NCSFile::o_rsadd(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_rsadd(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** CONST: push a constant (predetermined value) variable onto the stack. */
-void NCSFile::o_const(InstructionType type) {
-	switch (type) {
+void NCSFile::o_const(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeInt:
-			_stack.push(_script->readSint32BE());
+			_stack.push(instr.args[0]);
 			break;
 
 		case kInstTypeFloat:
-			_stack.push(_script->readIEEEFloatBE());
+			_stack.push(instr.argFloat);
 			break;
 
 		case kInstTypeString:
 		case kInstTypeResource: {
-			_stack.push(Common::readStringFixed(*_script, Common::kEncodingASCII, _script->readUint16BE()));
+			_stack.push(_strings[instr.target]);
 			break;
 		}
 
@@ -504,7 +687,7 @@ void NCSFile::o_const(InstructionType type) {
 			 * magic values. They *should* all have the same effect, though.
 			 */
 
-			uint32 objectID = _script->readUint32BE();
+			uint32 objectID = (uint32) instr.args[0];
 
 			if      (objectID == kScriptObjectSelf)
 				_stack.push(_owner);
@@ -521,13 +704,13 @@ void NCSFile::o_const(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_const(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_const(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** Helper function for o_action(), doing the actual engine function calling. */
 void NCSFile::callEngine(Aurora::NWScript::FunctionContext &ctx,
-                         uint32 function, uint8 argCount) {
+                         uint32 function, uint8 argCount, const Function *bound) {
 
 	if ((argCount < ctx.getParamMin()) || (argCount > ctx.getParamMax()))
 		throw Common::Exception("NCSFile::callEngine(): Argument count mismatch (%u vs %u - %u)",
@@ -585,7 +768,10 @@ void NCSFile::callEngine(Aurora::NWScript::FunctionContext &ctx,
 
 	// Call the engine function
 	debugC(kDebugScripts, 1, "NWScript engine function %s (%d)", ctx.getName().c_str(), function);
-	FunctionMan.call(function, ctx);
+	if (bound)
+		FunctionMan.call(*bound, ctx);
+	else
+		FunctionMan.call(function, ctx);
 
 	// Push return values
 	Variable &retVal = ctx.getReturn();
@@ -622,28 +808,60 @@ void NCSFile::callEngine(Aurora::NWScript::FunctionContext &ctx,
 }
 
 /** ACTION: call a game-specific engine function. */
-void NCSFile::o_action(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_action(): Illegal type %d", type);
+void NCSFile::o_action(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_action(): Illegal instr.type %d", instr.type);
+
+	uint16 routineNumber = instr.args[0];
+	uint8  argCount      = instr.args[1];
+
+	// The function couldn't be bound on load, or its context is in use by a recursive call
+	if ((instr.target >= _engineCalls.size()) || _engineCalls[instr.target].busy) {
+		Aurora::NWScript::FunctionContext ctx = FunctionMan.createContext(routineNumber);
+
+		try {
+			callEngine(ctx, routineNumber, argCount);
+		} catch (Common::Exception &e) {
+			e.add("Failed running engine function \"%s\" (%d)",
+			      ctx.getName().c_str(), routineNumber);
+			throw;
+		}
+
+		return;
+	}
 
-	uint16 routineNumber = _script->readUint16BE();
-	uint8  argCount      = _script->readByte();
+	EngineCall &call = _engineCalls[instr.target];
 
-	Aurora::NWScript::FunctionContext ctx = FunctionMan.createContext(routineNumber);
+	/* Undo what the last call might have changed: the return value, the parameters
+	 * that were defaulted, and the types of parameters that can take any type. */
+
+	Parameters &params = call.context.getParams();
+	const Parameters &defaults = call.prototype.getParams();
+
+	call.context.getReturn() = call.prototype.getReturn();
+	for (size_t i = 0; i < params.size(); i++)
+		if ((i >= argCount) || (defaults[i].getType() == kTypeAny))
+			params[i] = defaults[i];
+
+	call.busy = true;
 
 	try {
-		callEngine(ctx, routineNumber, argCount);
+		callEngine(call.context, routineNumber, argCount, &call.function);
 	} catch (Common::Exception &e) {
+		call.busy = false;
+
 		e.add("Failed running engine function \"%s\" (%d)",
-		      ctx.getName().c_str(), routineNumber);
+		      call.context.getName().c_str(), routineNumber);
 		throw;
 	}
+
+	call.busy = false;
 }
 
 /** LOGAND: perform a logical boolean AND (&&). */
-void NCSFile::o_logand(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_logand(): Illegal type %d", type);
+void NCSFile::o_logand(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_logand(): Illegal instr.type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -651,9 +869,9 @@ void NCSFile::o_logand(InstructionType type) {
 }
 
 /** LOGOR: perform a logical boolean OR (||). */
-void NCSFile::o_logor(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_logor(): Illegal type %d", type);
+void NCSFile::o_logor(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_logor(): Illegal instr.type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -661,9 +879,9 @@ void NCSFile::o_logor(InstructionType type) {
 }
 
 /** INCOR: perform a bit-wise inclusive OR (|). */
-void NCSFile::o_incor(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_incor(): Illegal type %d", type);
+void NCSFile::o_incor(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_incor(): Illegal instr.type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -671,9 +889,9 @@ void NCSFile::o_incor(InstructionType type) {
 }
 
 /** EXCOR: perform a bit-wise exclusive OR (^). */
-void NCSFile::o_excor(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_excor(): Illegal type %d", type);
+void NCSFile::o_excor(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_excor(): Illegal instr.type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -681,9 +899,9 @@ void NCSFile::o_excor(InstructionType type) {
 }
 
 /** BOOLAND: perform a bit-wise AND (&). */
-void NCSFile::o_booland(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_booland(): Illegal type %d", type);
+void NCSFile::o_booland(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_booland(): Illegal instr.type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -691,13 +909,13 @@ void NCSFile::o_booland(InstructionType type) {
 }
 
 /** EQ: compare the top-most stack elements for equality (==). */
-void NCSFile::o_eq(InstructionType type) {
+void NCSFile::o_eq(const Instruction &instr) {
 	size_t n = 1;
 
-	if (type == kInstTypeStructStruct) {
-		// Comparisons between two structs (or two vectors) come with the size of the type
+	if (instr.type == kInstTypeStructStruct) {
+		// Comparisons between two structs (or two vectors) come with the size of the instr.type
 
-		const size_t size = _script->readUint16BE();
+		const size_t size = instr.args[0];
 
 		if ((size % 4) != 0)
 			throw Common::Exception("NCSFile::o_eq(): size %% 4 != 0");
@@ -720,13 +938,13 @@ void NCSFile::o_eq(InstructionType type) {
 }
 
 /** NEQ: compare the top-most stack elements for inequality (!=). */
-void NCSFile::o_neq(InstructionType type) {
+void NCSFile::o_neq(const Instruction &instr) {
 	size_t n = 1;
 
-	if (type == kInstTypeStructStruct) {
-		// Comparisons between two structs (or two vectors) come with the size of the type
+	if (instr.type == kInstTypeStructStruct) {
+		// Comparisons between two structs (or two vectors) come with the size of the instr.type
 
-		const size_t size = _script->readUint16BE();
+		const size_t size = instr.args[0];
 
 		if ((size % 4) != 0)
 			throw Common::Exception("NCSFile::o_neq(): size %% 4 != 0");
@@ -749,8 +967,8 @@ void NCSFile::o_neq(InstructionType type) {
 }
 
 /** GEQ: compare the top-most stack elements, greater-or-equal (>=). */
-void NCSFile::o_geq(InstructionType type) {
-	switch (type) {
+void NCSFile::o_geq(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -768,13 +986,13 @@ void NCSFile::o_geq(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_geq(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_geq(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** GT: compare the top-most stack elements, greater (>). */
-void NCSFile::o_gt(InstructionType type) {
-	switch (type) {
+void NCSFile::o_gt(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -792,13 +1010,13 @@ void NCSFile::o_gt(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_gt(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_gt(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** LT: compare the top-most stack elements, less (<). */
-void NCSFile::o_lt(InstructionType type) {
-	switch (type) {
+void NCSFile::o_lt(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -816,13 +1034,13 @@ void NCSFile::o_lt(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_lt(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_lt(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** LEQ: compare the top-most stack elements, less-or-equal (<=). */
-void NCSFile::o_leq(InstructionType type) {
-	switch (type) {
+void NCSFile::o_leq(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -840,14 +1058,14 @@ void NCSFile::o_leq(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_leq(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_leq(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** SHLEFT: shift the top-most stack element to the left (<<). */
-void NCSFile::o_shleft(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_shleft(): Illegal type %d", type);
+void NCSFile::o_shleft(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_shleft(): Illegal instr.type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -855,15 +1073,15 @@ void NCSFile::o_shleft(InstructionType type) {
 }
 
 /** SHRIGHT: signed-shift the top-most stack element to the right (>>>). */
-void NCSFile::o_shright(InstructionType type) {
+void NCSFile::o_shright(const Instruction &instr) {
 	/* According to Skywing's NWNScriptLib
 	 * (<https://github.com/SkywingvL/nwn2dev-public/blob/master/NWNScriptLib/NWScriptVM.cpp#L2233>):
 	 * "The operation implemented here is actually a complex sequence that, if
 	 *  the amount to be shifted is negative, involves both a front-loaded and
 	 *  end-loaded negate built on top of a signed shift." */
 
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_shright(): Illegal type %d", type);
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_shright(): Illegal instr.type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -876,14 +1094,14 @@ void NCSFile::o_shright(InstructionType type) {
 }
 
 /** USHRIGHT: shift the top-most stack element to the right (>>). */
-void NCSFile::o_ushright(InstructionType type) {
+void NCSFile::o_ushright(const Instruction &instr) {
 	/* According to Skywing's NWNScriptLib
 	 * (<https://github.com/SkywingvL/nwn2dev-public/blob/master/NWNScriptLib/NWScriptVM.cpp#L2272>):
 	 * "While this operator may have originally been intended to implement
 	 *  an unsigned shift, it actually performs an arithmetic (signed) shift." */
 
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_ushright(): Illegal type %d", type);
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_ushright(): Illegal instr.type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -891,9 +1109,9 @@ void NCSFile::o_ushright(InstructionType type) {
 }
 
 /** MOD: calculate the remainder (modulo) of an integer division (%). */
-void NCSFile::o_mod(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_mod(): Illegal type %d", type);
+void NCSFile::o_mod(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_mod(): Illegal instr.type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -907,8 +1125,8 @@ void NCSFile::o_mod(InstructionType type) {
 }
 
 /** NEQ: negate the top-most stack element (unary -). */
-void NCSFile::o_neg(InstructionType type) {
-	switch (type) {
+void NCSFile::o_neg(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeInt:
 			_stack.push(-_stack.pop().getInt());
 			break;
@@ -918,101 +1136,96 @@ void NCSFile::o_neg(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_neg(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_neg(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** COMP: calculate the 1-complement of the top-most stack element (~). */
-void NCSFile::o_comp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_comp(): Illegal type %d", type);
+void NCSFile::o_comp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_comp(): Illegal instr.type %d", instr.type);
 
 	_stack.push(~_stack.pop().getInt());
 }
 
 /** MOVSP: pop elements off the stack. */
-void NCSFile::o_movsp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_movsp(): Illegal type %d", type);
+void NCSFile::o_movsp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_movsp(): Illegal instr.type %d", instr.type);
 
-	_stack.setStackPtr(_stack.getStackPtr() - _script->readSint32BE());
+	_stack.setStackPtr(_stack.getStackPtr() - instr.args[0]);
 }
 
 /** JMP: jump directly to a different script offset. */
-void NCSFile::o_jmp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jmp(): Illegal type %d", type);
+void NCSFile::o_jmp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jmp(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	_script->skip(offset - 6);
+	jump(instr.target);
 }
 
 /** JZ: jump conditionally if the top-most stack element is 0. */
-void NCSFile::o_jz(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jz(): Illegal type %d", type);
-
-	int32 offset = _script->readSint32BE();
+void NCSFile::o_jz(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jz(): Illegal instr.type %d", instr.type);
 
 	if (!_stack.pop().getInt())
-		_script->skip(offset - 6);
+		jump(instr.target);
 }
 
 /** NOT: boolean-negate the top-most stack element (!). */
-void NCSFile::o_not(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_not(): Illegal type %d", type);
+void NCSFile::o_not(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_not(): Illegal instr.type %d", instr.type);
 
 	_stack.push(!_stack.pop().getInt());
 }
 
 /** DECSP: decrement the value of a stack element (--). */
-void NCSFile::o_decsp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_decsp(): Illegal type %d", type);
+void NCSFile::o_decsp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_decsp(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	const int32 offset = instr.args[0];
 
 	_stack.setRelSP(offset, _stack.getRelSP(offset).getInt() - 1);
 }
 
 /** INCSP: increment the value of a stack element (++). */
-void NCSFile::o_incsp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_incsp(): Illegal type %d", type);
+void NCSFile::o_incsp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_incsp(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	const int32 offset = instr.args[0];
 
 	_stack.setRelSP(offset, _stack.getRelSP(offset).getInt() + 1);
 }
 
 /** JNZ: jump conditionally if the top-most stack element is not 0. */
-void NCSFile::o_jnz(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jnz(): Illegal type %d", type);
-
-	int32 offset = _script->readSint32BE();
+void NCSFile::o_jnz(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jnz(): Illegal instr.type %d", instr.type);
 
 	if (_stack.pop().getInt())
-		_script->skip(offset - 6);
+		jump(instr.target);
 }
 
 /** DECBP: decrement the value of a base-pointer stack element (--). */
-void NCSFile::o_decbp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_decbp(): Illegal type %d", type);
+void NCSFile::o_decbp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_decbp(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	const int32 offset = instr.args[0];
 
 	_stack.setRelBP(offset, _stack.getRelBP(offset).getInt() - 1);
 }
 
 /** INCBP: increment the value of a base-pointer stack element (++). */
-void NCSFile::o_incbp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_incbp(): Illegal type %d", type);
+void NCSFile::o_incbp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_incbp(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	const int32 offset = instr.args[0];
 
 	_stack.setRelBP(offset, _stack.getRelBP(offset).getInt() + 1);
 }
@@ -1021,9 +1234,9 @@ void NCSFile::o_incbp(InstructionType type) {
  *
  *  Used to create an anchor point to access global variables.
  */
-void NCSFile::o_savebp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_savebp(): Illegal type %d", type);
+void NCSFile::o_savebp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_savebp(): Illegal instr.type %d", instr.type);
 
 	_stack.push(_stack.getBasePtr());
 	_stack.setBasePtr(_stack.getStackPtr());
@@ -1033,25 +1246,25 @@ void NCSFile::o_savebp(InstructionType type) {
  *
  *  Destroy the global variables anchor point after use.
  */
-void NCSFile::o_restorebp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_restorebp(): Illegal type %d", type);
+void NCSFile::o_restorebp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_restorebp(): Illegal instr.type %d", instr.type);
 
 	_stack.setBasePtr(_stack.pop().getInt());
 }
 
 /** NOP: no operation. */
-void NCSFile::o_nop(InstructionType UNUSED(type)) {
+void NCSFile::o_nop(const Instruction &UNUSED(instr)) {
 	// Nothing! Yay!
 }
 
 /** CPDOWNSP: copy a value into an existing stack element. */
-void NCSFile::o_cpdownsp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal type %d", type);
+void NCSFile::o_cpdownsp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal size %d", size);
@@ -1067,12 +1280,12 @@ void NCSFile::o_cpdownsp(InstructionType type) {
 }
 
 /** CPTOPSP: push a copy of a stack element on top of the stack. */
-void NCSFile::o_cptopsp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cptopsp(): Illegal type %d", type);
+void NCSFile::o_cptopsp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cptopsp(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cptopsp(): Illegal size %d", size);
@@ -1085,8 +1298,8 @@ void NCSFile::o_cptopsp(InstructionType type) {
 }
 
 /** ADD: add the top-most stack elements (+). */
-void NCSFile::o_add(InstructionType type) {
-	switch (type) {
+void NCSFile::o_add(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1142,13 +1355,13 @@ void NCSFile::o_add(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_add(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_add(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** SUB: subtract the top-most stack elements (-). */
-void NCSFile::o_sub(InstructionType type) {
-	switch (type) {
+void NCSFile::o_sub(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1196,13 +1409,13 @@ void NCSFile::o_sub(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_sub(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_sub(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** MUL: multiply the top-most stack elements (*). */
-void NCSFile::o_mul(InstructionType type) {
-	switch (type) {
+void NCSFile::o_mul(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1260,13 +1473,13 @@ void NCSFile::o_mul(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_mul(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_mul(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** DIV: divide the top-most stack elements (/). */
-void NCSFile::o_div(InstructionType type) {
-	switch (type) {
+void NCSFile::o_div(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1345,13 +1558,13 @@ void NCSFile::o_div(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_div(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_div(): Illegal instr.type %d", instr.type);
 	}
 }
 
 /** STORESTATEALL: unused, obsolete opcode. Hopefully. */
-void NCSFile::o_storestateall(InstructionType type) {
-	uint8  offset = (uint8) type;
+void NCSFile::o_storestateall(const Instruction &instr) {
+	uint8  offset = (uint8) instr.type;
 
 	// TODO: NCSFile::o_storestateall(): See o_storestate.
 	//       Supposedly obsolete. Whether it's used anywhere remains to be seen.
@@ -1359,37 +1572,35 @@ void NCSFile::o_storestateall(InstructionType type) {
 }
 
 /** JSR: call a subroutine. */
-void NCSFile::o_jsr(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jsr(): Illegal type %d", type);
-
-	int32 offset = _script->readSint32BE();
+void NCSFile::o_jsr(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jsr(): Illegal instr.type %d", instr.type);
 
-	// Push the current script position
-	_returnOffsets.push(_script->pos());
+	// Push the index of the next instruction
+	_returnIndices.push(_pc);
 
-	_script->skip(offset - 6);
+	jump(instr.target);
 }
 
 /** RETN: return from a subroutine call. */
-void NCSFile::o_retn(InstructionType UNUSED(type)) {
-	uint32 returnAddress = _script->size();
-	if (!_returnOffsets.empty()) {
-		returnAddress = _returnOffsets.top();
-		_returnOffsets.pop();
+void NCSFile::o_retn(const Instruction &UNUSED(instr)) {
+	size_t returnIndex = _instructions.size();
+	if (!_returnIndices.empty()) {
+		returnIndex = _returnIndices.top();
+		_returnIndices.pop();
 	}
 
-	_script->seek(returnAddress);
+	_pc = returnIndex;
 }
 
 /** DESTRUCT: remove elements from the stack.
  *
  *  Used to isolate struct elements.
  */
-void NCSFile::o_destruct(InstructionType UNUSED(type)) {
-	int16 stackSize        = _script->readSint16BE();
-	int16 dontRemoveOffset = _script->readSint16BE();
-	int16 dontRemoveSize   = _script->readSint16BE();
+void NCSFile::o_destruct(const Instruction &instr) {
+	int16 stackSize        = instr.args[0];
+	int16 dontRemoveOffset = instr.args[1];
+	int16 dontRemoveSize   = instr.args[2];
 
 	if ((stackSize % 4) != 0)
 		throw Common::Exception("NCSFile::o_destruct(): Illegal stack size %d", stackSize);
@@ -1420,12 +1631,12 @@ void NCSFile::o_destruct(InstructionType UNUSED(type)) {
  *
  *  Used to write into a global variable.
  */
-void NCSFile::o_cpdownbp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal type %d", type);
+void NCSFile::o_cpdownbp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE() - 4;
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0] - 4;
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal size %d", size);
@@ -1444,12 +1655,12 @@ void NCSFile::o_cpdownbp(InstructionType type) {
  *
  *  Used to read from a global variable.
  */
-void NCSFile::o_cptopbp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cptopbp(): Illegal type %d", type);
+void NCSFile::o_cptopbp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cptopbp(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE() - 4;
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0] - 4;
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cptopbp(): Illegal size %d", size);
@@ -1467,10 +1678,10 @@ void NCSFile::o_cptopbp(InstructionType type) {
  *  Used to create the "action" variables when calling an engine function that
  *  assigns a function to an object, or delays a function, or similar.
  */
-void NCSFile::o_storestate(InstructionType type) {
-	uint8  offset = (uint8) type;
-	uint32 sizeBP = _script->readUint32BE();
-	uint32 sizeSP = _script->readUint32BE();
+void NCSFile::o_storestate(const Instruction &instr) {
+	uint8  offset = (uint8) instr.type;
+	uint32 sizeBP = (uint32) instr.args[0];
+	uint32 sizeSP = (uint32) instr.args[1];
 
 	if ((sizeBP % 4) != 0)
 		throw Common::Exception("NCSFile::o_storestate(): Illegal BP size %d", sizeBP);
@@ -1480,7 +1691,7 @@ void NCSFile::o_storestate(InstructionType type) {
 	_storedState.setType(kTypeScriptState);
 	ScriptState &state = _storedState.getScriptState();
 
-	state.offset = _script->pos() - 10 + offset;
+	state.offset = instr.address + offset;
 
 	sizeBP /= 4;
 	sizeSP /= 4;
@@ -1503,12 +1714,12 @@ void NCSFile::o_storestate(InstructionType type) {
  *
  *  The index is popped off the stack, but the value written remains.
  */
-void NCSFile::o_writearray(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_writearray(): Illegal type %d", type);
+void NCSFile::o_writearray(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_writearray(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_writearray(): Invalid size %d", size);
@@ -1538,12 +1749,12 @@ void NCSFile::o_writearray(InstructionType type) {
  *  The index is popped off the stack, and the value read out of the
  *  array is pushed on top.
  */
-void NCSFile::o_readarray(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_readarray(): Illegal type %d", type);
+void NCSFile::o_readarray(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_readarray(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_readarray(): Invalid size %d", size);
@@ -1570,12 +1781,12 @@ void NCSFile::o_readarray(InstructionType type) {
  *  The offset to the variable to create a reference to is passed
  *  as a direct argument to the instruction.
  */
-void NCSFile::o_getref(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_getref(): Illegal type %d", type);
+void NCSFile::o_getref(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_getref(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_getref(): Invalid size %d", size);
@@ -1601,12 +1812,12 @@ void NCSFile::o_getref(InstructionType type) {
  *  The index is popped off the stack, and the reference to the
  *  variable inside the array is pushed on top.
  */
-void NCSFile::o_getrefarray(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_getrefarray(): Illegal type %d", type);
+void NCSFile::o_getrefarray(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_getrefarray(): Illegal instr.type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_getrefarray(): Invalid size %d", size);
@@ -1624,6 +1835,12 @@ void NCSFile::o_getrefarray(InstructionType type) {
 	_stack.top().setReference(&*array[index]);
 }
 
+/** Not a real opcode: an instruction that couldn't be decoded. */
+void NCSFile::o_illegal(const Instruction &instr) {
+	throw Common::Exception("NCSFile::o_illegal(): Illegal instruction 0x%02x at offset 0x%08X",
+	                        instr.opcode, instr.address);
+}
+
 } // End of namespace NWScript
 
 } // End of namespace Aurora
@@ -38,6 +38,7 @@
 #include "src/aurora/nwscript/variable.h"
 #include "src/aurora/nwscript/variablecontainer.h"
 #include "src/aurora/nwscript/objectref.h"
+#include "src/aurora/nwscript/functioncontext.h"
 
 namespace Common {
 	class UString;
@@ -80,7 +81,7 @@ private:
 	int32 _basePtr;
 };
 
-#define DECLARE_OPCODE(x) void x(InstructionType type)
+#define DECLARE_OPCODE(x) void x(const Instruction &instr)
 
 /** An NCS, BioWare's NWN Compile Script. */
 class NCSFile : public AuroraFile {
@@ -164,11 +165,73 @@ private:
 		kInstTypeFloatVector            = 60
 	};
 
+	/** The layout of the direct arguments following an instruction. */
+	enum ArgumentLayout {
+		kArgsNone,       ///< No arguments.
+		kArgsInt32,      ///< One 32-bit integer.
+		kArgsInt32Int16, ///< A 32-bit integer, followed by a 16-bit integer.
+		kArgsInt16x3,    ///< Three 16-bit integers.
+		kArgsUint32x2,   ///< Two 32-bit integers.
+		kArgsAction,     ///< A 16-bit engine function number and an 8-bit argument count.
+		kArgsJump,       ///< A 32-bit jump offset, relative to the instruction.
+		kArgsConst,      ///< A constant value, depending on the instruction type.
+		kArgsStructSize  ///< A 16-bit struct size, only if the type is kInstTypeStructStruct.
+	};
+
+	struct Instruction;
+
+	typedef void (NCSFile::*OpcodeProc)(const Instruction &instr);
+
+	/** An instruction, decoded out of the script's bytecode. */
+	struct Instruction {
+		uint32 address;       ///< The offset of the instruction within the NCS.
+
+		byte opcode;          ///< The instruction's opcode.
+		InstructionType type; ///< The instruction's type.
+
+		OpcodeProc proc;      ///< The function executing this instruction.
+
+		int32 args[3];        ///< The direct integer arguments.
+		float argFloat;       ///< The direct argument of a float CONST.
+
+		/** The index of the instruction a jump leads to, of a string CONST's string,
+		 *  or of an ACTION's bound engine function. */
+		size_t target;
+	};
+
+	/** An engine function called by an ACTION instruction, looked up once on load. */
+	struct EngineCall {
+		Function function;         ///< The engine function.
+		FunctionContext prototype; ///< A pristine context, with the default parameters.
+		FunctionContext context;   ///< The context reused for every call.
+
+		bool busy; ///< Is the context currently in use?
+	};
+
+	struct Opcode {
+		OpcodeProc proc;
+		const char *desc;
+		ArgumentLayout args;
+	};
+
 	Common::UString _name;
 
 	NCSStack _stack;
 	Common::ScopedPtr<Common::SeekableReadStream> _script;
 
+	/** The decoded script, sorted by address. */
+	std::vector<Instruction> _instructions;
+	/** The constant strings used by the script. */
+	std::vector<Common::UString> _strings;
+	/** The engine functions called by the script. */
+	std::vector<EngineCall> _engineCalls;
+
+	/** The address right behind the last instruction, or 0xFFFFFFFF if the decoding failed. */
+	uint32 _endAddress;
+
+	/** The index of the next instruction to execute. */
+	size_t _pc;
+
 	Variable _return;
 
 	ObjectReference _owner;
@@ -176,21 +239,32 @@ private:
 
 	VariableContainer _env;
 
-	std::stack<uint32> _returnOffsets;
+	/** The indices of the instructions to return to from subroutines. */
+	std::stack<size_t> _returnIndices;
 
 	Variable _storedState;
 
-	typedef void (NCSFile::*OpcodeProc)(InstructionType type);
-	struct Opcode {
-		OpcodeProc proc;
-		const char *desc;
-	};
+	/** Print debug information for every executed instruction? */
+	bool _debug;
+
 	const Opcode *_opcodes;
 	size_t _opcodeListSize;
 	void setupOpcodes();
 
 	void load();
 
+	/** Decode the whole bytecode into instructions. */
+	void decode();
+	/** Read the arguments of an instruction. Return false if the instruction's size is unknown. */
+	bool decodeArguments(Instruction &instr);
+	/** Resolve the targets of all jump instructions. */
+	void resolveJumps();
+	/** Look up the engine functions called by all ACTION instructions. */
+	void bindEngineCalls();
+
+	/** Return the index of the instruction at this address. */
+	size_t findInstruction(uint32 address) const;
+
 	/** Reset the script for another execution. */
 	void reset();
 
@@ -200,9 +274,13 @@ private:
 	/** Execute one script step. */
 	bool executeStep();
 
+	/** Jump to the instruction with this index. */
+	void jump(size_t target);
+
 	void decompile(); // TODO
 
-	void callEngine(Aurora::NWScript::FunctionContext &ctx, uint32 function, uint8 argCount);
+	void callEngine(Aurora::NWScript::FunctionContext &ctx, uint32 function, uint8 argCount,
+	                const Function *bound = 0);
 
 	// Opcode declarations
 	DECLARE_OPCODE(o_nop);
@@ -254,6 +332,9 @@ private:
 	DECLARE_OPCODE(o_readarray);
 	DECLARE_OPCODE(o_getref);
 	DECLARE_OPCODE(o_getrefarray);
+
+	/** Not a real opcode: an instruction that couldn't be decoded. */
+	DECLARE_OPCODE(o_illegal);
 };
 
 #undef DECLARE_OPCODE
@@ -162,7 +162,9 @@ Variable &Variable::operator=(const Variable &var) {
 	if (&var == this)
 		return *this;
 
-	setType(var._type);
+	// Keep the storage of string, object and script state values if we can
+	if (_type != var._type)
+		setType(var._type);
 
 	if      (_type == kTypeString)
 		*_value._string = *var._value._string;
@@ -191,6 +191,9 @@ Common::SeekableReadStream *OBBFile::getResource(uint32 index, bool UNUSED(tryNo
 
 	const IResource &res = getIResource(index);
 
+	// We don't know the compressed size up front, so we decompress straight out of the archive
+	Common::StackLock lock(_mutex);
+
 	_obb->seek(res.offset);
 
 	Common::ScopedArray<byte> data(new byte[res.uncompressedSize]);
@@ -24,6 +24,8 @@
 
 #include <cassert>
 
+#include <algorithm>
+
 #include <boost/scope_exit.hpp>
 
 #include "src/common/util.h"
@@ -32,6 +34,7 @@
 #include "src/common/readstream.h"
 #include "src/common/filepath.h"
 #include "src/common/readfile.h"
+#include "src/common/mappedfile.h"
 #include "src/common/writefile.h"
 
 #include "src/aurora/resman.h"
@@ -57,13 +60,17 @@ DECLARE_SINGLETON(Aurora::ResourceManager)
 
 namespace Aurora {
 
+static const uint32 kInvalidResource = 0xFFFFFFFF;
+
+static const bool kMapArchives = Common::MappedFile::isSupported() && (sizeof(void *) >= 8);
+
 ResourceManager::KnownArchive::KnownArchive() :
-	type(kArchiveMAX), resource(0), opened(0) {
+	type(kArchiveMAX), resource(kInvalidResource), opened(0) {
 
 }
 
-ResourceManager::KnownArchive::KnownArchive(ArchiveType t, const Common::UString &n, Resource &r) :
-	name(n), type(t), resource(&r), opened(0) {
+ResourceManager::KnownArchive::KnownArchive(ArchiveType t, const Common::UString &n, uint32 r) :
+	name(n), type(t), resource(r), opened(0) {
 
 }
 
@@ -71,7 +78,7 @@ ResourceManager::KnownArchive::KnownArchive(ArchiveType t, const Common::UString
 ResourceManager::OpenedArchive::OpenedArchive() : archive(0), known(0), parent(0) {
 }
 
-void ResourceManager::OpenedArchive::set(KnownArchive &kA, Archive &a) {
+void ResourceManager::OpenedArchive::set(KnownArchive &kA, Archive &a, const Resource &r) {
 	archive = &a;
 	known   = &kA;
 
@@ -85,26 +92,21 @@ void ResourceManager::OpenedArchive::set(KnownArchive &kA, Archive &a) {
 	 * child-archives still open.
 	 */
 
-	assert(known->resource);
-	if (known->resource->source == kSourceArchive) {
-		assert(known->resource->archive);
+	if (r.source == kSourceArchive) {
+		assert(r.archive);
 
-		parent = known->resource->archive;
+		parent = r.archive;
 		parent->children.push_back(this);
 	}
 }
 
 
-ResourceManager::Resource::Resource() : type(kFileTypeNone), isSmall(false), priority(0),
-		source(kSourceNone), archive(0), archiveIndex(0xFFFFFFFF) {
+ResourceManager::Resource::Resource() : name(""), type(kFileTypeNone), isSmall(false),
+		source(kSourceNone), path(""), archive(0), archiveIndex(0xFFFFFFFF) {
 
 	selfArchive.first = 0;
 }
 
-bool ResourceManager::Resource::operator<(const Resource &right) const {
-	return priority < right.priority;
-}
-
 
 ResourceManager::ResourceManager() : _hasSmall(false),
 	_hashAlgo(Common::kHashFNV64) {
@@ -182,6 +184,9 @@ void ResourceManager::clear() {
 
 	setRIMsAreERFs(false);
 	clearResources();
+
+	_indexCache.clear();
+	_indexCacheFile.clear();
 }
 
 void ResourceManager::clearResources() {
@@ -197,7 +202,10 @@ void ResourceManager::clearResources() {
 		delete a->archive;
 	_openedArchives.clear();
 
+	_index.clear();
 	_resources.clear();
+	_freeResources.clear();
+	_names.clear();
 
 	_changes.clear();
 }
@@ -224,7 +232,7 @@ void ResourceManager::setHasSmall(bool hasSmall) {
 }
 
 void ResourceManager::setHashAlgo(Common::HashAlgo algo) {
-	if ((algo != _hashAlgo) && !_resources.empty())
+	if ((algo != _hashAlgo) && !_index.empty())
 		throw Common::Exception("ResourceManager::setHashAlgo(): We already have resources!");
 
 	_hashAlgo = algo;
@@ -264,6 +272,29 @@ const Common::UString &ResourceManager::getDataBase() const {
 	return _baseDir;
 }
 
+void ResourceManager::setIndexCache(const Common::UString &file) {
+	_indexCache.clear();
+	_indexCacheFile = file;
+
+	if (_indexCacheFile.empty())
+		return;
+
+	if (_indexCache.load(_indexCacheFile))
+		status("Loaded index cache with %u archives", (uint) _indexCache.size());
+
+	// Forget about archives that were removed in the meantime
+	_indexCache.prune();
+}
+
+void ResourceManager::saveIndexCache() {
+	if (_indexCacheFile.empty() || !_indexCache.isModified())
+		return;
+
+	Common::FilePath::createDirectories(Common::FilePath::getDirectory(_indexCacheFile));
+
+	_indexCache.save(_indexCacheFile);
+}
+
 ResourceManager::KnownArchive *ResourceManager::findArchive(const Common::UString &file) {
 	ArchiveType archiveType = getArchiveType(file);
 	if (((size_t) archiveType) >= kArchiveMAX)
@@ -294,10 +325,23 @@ bool ResourceManager::hasArchive(const Common::UString &file) {
 }
 
 Common::SeekableReadStream *ResourceManager::openArchiveStream(const KnownArchive &archive) const {
-	if (!archive.resource)
+	if (archive.resource >= _resources.size())
 		throw Common::Exception("Archive without resource reference");
 
-	return getResource(*archive.resource, true);
+	const Resource &resource = _resources[archive.resource];
+
+	/* Map archive files directly into memory, so that their resources can be
+	 * read without copying. Only do that with a 64-bit address space, though,
+	 * since the archives of some games are several gigabytes big. */
+	if (kMapArchives && (resource.source == kSourceFile) && !resource.isSmall) {
+		try {
+			return new Common::MappedReadStream(resource.path);
+		} catch (...) {
+			// Fall back to reading the file normally
+		}
+	}
+
+	return getResource(resource, true);
 }
 
 void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
@@ -314,12 +358,15 @@ void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
 	if (changeID)
 		change = newChangeSet(*changeID);
 
+	if (indexCachedArchive(*knownArchive, priority, change))
+		return;
+
 	Common::SeekableReadStream *archiveStream = openArchiveStream(*knownArchive);
 
 	Common::ScopedPtr<Archive> archive;
 	switch (knownArchive->type) {
 		case kArchiveKEY:
-			indexKEY(archiveStream, priority, change);
+			indexKEY(*knownArchive, archiveStream, priority, change);
 			break;
 
 		case kArchiveNDS:
@@ -354,8 +401,13 @@ void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
 			throw Common::Exception("Invalid archive type %d", knownArchive->type);
 	}
 
-	if (archive)
+	if (archive) {
+		IndexCache::Entry cacheEntry;
+		if (createCacheEntry(*knownArchive, cacheEntry) && addCacheDataFile(*knownArchive, *archive, cacheEntry))
+			_indexCache.add(cacheEntry);
+
 		indexArchive(*knownArchive, archive.release(), priority, change);
+	}
 }
 
 void ResourceManager::indexArchive(const Common::UString &file, uint32 priority, Common::ChangeID *changeID) {
@@ -403,16 +455,124 @@ uint32 ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream,
 	return archives.size();
 }
 
-void ResourceManager::indexKEY(Common::SeekableReadStream *stream, uint32 priority, Change *change) {
+void ResourceManager::indexKEY(const KnownArchive &keyArchive, Common::SeekableReadStream *stream,
+                               uint32 priority, Change *change) {
+
 	std::vector<KnownArchive *> archives;
 	std::vector<KEYDataFile *> keyData;
 
 	const uint32 count = openKEYBIFs(stream, archives, keyData);
 
+	IndexCache::Entry cacheEntry;
+	bool cacheable = createCacheEntry(keyArchive, cacheEntry);
+	for (uint32 i = 0; cacheable && (i < count); i++)
+		cacheable = addCacheDataFile(*archives[i], *keyData[i], cacheEntry);
+
+	if (cacheable)
+		_indexCache.add(cacheEntry);
+
 	for (uint32 i = 0; i < count; i++)
 		indexArchive(*archives[i], keyData[i], priority, change);
 }
 
+const char *ResourceManager::getCacheablePath(const KnownArchive &archive) const {
+	if (_indexCacheFile.empty() || (archive.resource >= _resources.size()))
+		return 0;
+
+	// Only archives that are plain files on disk can be checked for changes
+	const Resource &resource = _resources[archive.resource];
+	if ((resource.source != kSourceFile) || resource.isSmall)
+		return 0;
+
+	return resource.path;
+}
+
+bool ResourceManager::createCacheEntry(const KnownArchive &archive, IndexCache::Entry &entry) const {
+	const char *path = getCacheablePath(archive);
+	if (!path)
+		return false;
+
+	return IndexCache::createEntry(path, entry);
+}
+
+bool ResourceManager::addCacheDataFile(const KnownArchive &archive, const Archive &data,
+                                       IndexCache::Entry &entry) const {
+
+	const char *path = getCacheablePath(archive);
+	if (!path)
+		return false;
+
+	entry.dataFiles.push_back(IndexCache::DataFile());
+
+	return IndexCache::createDataFile(path, data, entry.dataFiles.back());
+}
+
+bool ResourceManager::indexCachedArchive(KnownArchive &knownArchive, uint32 priority, Change *change) {
+	if ((knownArchive.type != kArchiveKEY) && (knownArchive.type != kArchiveERF) &&
+	    (knownArchive.type != kArchiveRIM))
+		return false;
+
+	const char *path = getCacheablePath(knownArchive);
+	if (!path)
+		return false;
+
+	const IndexCache::Entry *entry = _indexCache.find(path);
+	if (!entry)
+		return false;
+
+	if (!IndexCache::isUpToDate(*entry)) {
+		_indexCache.remove(path);
+		return false;
+	}
+
+	// Find the known archives of all data files. For a KEY, these are the BIFs
+	std::vector<KnownArchive *> archives(entry->dataFiles.size(), 0);
+	for (size_t i = 0; i < archives.size(); i++) {
+		const Common::UString &dataPath = entry->dataFiles[i].path;
+
+		if (knownArchive.type != kArchiveKEY) {
+			if ((archives.size() == 1) && (dataPath == path))
+				archives[i] = &knownArchive;
+
+		} else {
+			KnownArchives &bifs = _knownArchives[kArchiveBIF];
+			for (KnownArchives::iterator b = bifs.begin(); b != bifs.end(); ++b) {
+				const char *bifPath = getCacheablePath(*b);
+				if (bifPath && (dataPath == bifPath)) {
+					archives[i] = &*b;
+					break;
+				}
+			}
+		}
+
+		if (!archives[i] || archives[i]->opened)
+			return false;
+	}
+
+	// Open all data files first, so that we can still fall back to parsing the archive
+	std::vector<Archive *> cached;
+	BOOST_SCOPE_EXIT( (&cached) ) {
+		for (std::vector<Archive *>::iterator c = cached.begin(); c != cached.end(); ++c)
+			delete *c;
+	} BOOST_SCOPE_EXIT_END
+
+	try {
+		for (size_t i = 0; i < archives.size(); i++)
+			cached.push_back(new CachedArchive(openArchiveStream(*archives[i]), entry->dataFiles[i]));
+	} catch (...) {
+		return false;
+	}
+
+	for (size_t i = 0; i < archives.size(); i++) {
+		Archive *archive = cached[i];
+		cached[i] = 0;
+
+		indexArchive(*archives[i], archive, priority, change);
+	}
+
+	return true;
+}
+
 void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
                                    uint32 priority, Change *change) {
 
@@ -431,7 +591,7 @@ void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
 		}
 	} BOOST_SCOPE_EXIT_END
 
-	_openedArchives.back().set(knownArchive, *archive);
+	_openedArchives.back().set(knownArchive, *archive, _resources[knownArchive.resource]);
 	couldSet = true;
 
 	// Add the information of the new archive to the change set
@@ -442,31 +602,30 @@ void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
 	for (Archive::ResourceList::const_iterator resource = resources.begin(); resource != resources.end(); ++resource) {
 		// Build the resource record
 		Resource res;
-		res.priority     = priority;
 		res.source       = kSourceArchive;
 		res.archive      = &_openedArchives.back();
 		res.archiveIndex = resource->index;
-		res.name         = resource->name;
+		res.name         = _names.intern(resource->name);
 		res.type         = resource->type;
 
 		// Get the hash or calculate if we have to
-		uint64 hash = (hashAlgo == Common::kHashNone) ? getHash(res.name, res.type) : resource->hash;
+		uint64 hash = (hashAlgo == Common::kHashNone) ? getHash(resource->name, res.type) : resource->hash;
 
 		// Normalize the file types if we can and recalculate the hash
-		if ((res.name != "") && (res.type != kFileTypeNone))
+		if (!resource->name.empty() && (res.type != kFileTypeNone))
 			if (normalizeType(res))
-				hash = getHash(res.name, res.type);
+				hash = getHash(resource->name, res.type);
 
 		// Handle "small" files
 		if (_hasSmall && (res.type == kFileTypeSMALL)) {
 			res.isSmall = true;
 
-			res.name = Common::FilePath::getStem(resource->name);
+			res.name = _names.intern(Common::FilePath::getStem(resource->name));
 			res.type = TypeMan.getFileType(resource->name);
 		}
 
 		// And add it to our list
-		addResource(res, hash, change);
+		addResource(res, hash, priority, change);
 	}
 }
 
@@ -572,8 +731,8 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 			throw Common::Exception("Attempted to deindex an archive that's still opened");
 
 		// Remove us from the resource
-		assert(kaChange->second->resource);
-		kaChange->second->resource->selfArchive.first = 0;
+		assert(kaChange->second->resource < _resources.size());
+		_resources[kaChange->second->resource].selfArchive.first = 0;
 
 		kaChange->first->erase(kaChange->second);
 	}
@@ -582,20 +741,22 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 	for (ResourceChanges::iterator resChange = change->_change->resources.begin();
 	     resChange != change->_change->resources.end(); ++resChange) {
 
+		Resource &res = _resources[resChange->id];
+
 		// If the resource still has an archive attached, it was added by a
 		// declareResources() call and needs to be removed manually
-		if (resChange->resIt->selfArchive.first) {
-			if (resChange->resIt->selfArchive.second->opened)
+		if (res.selfArchive.first) {
+			if (res.selfArchive.second->opened)
 				throw Common::Exception("Attempted to deindex an archive resource that's still opened");
 
-			resChange->resIt->selfArchive.first->erase(resChange->resIt->selfArchive.second);
+			res.selfArchive.first->erase(res.selfArchive.second);
 		}
 
-		// Remove the resource, and the name list too if it's empty
-		resChange->hashIt->second.erase(resChange->resIt);
+		// Remove the resource from the index, and free its ID for reuse
+		_index.remove(resChange->hash, resChange->id);
 
-		if (resChange->hashIt->second.empty())
-			_resources.erase(resChange->hashIt);
+		res = Resource();
+		_freeResources.push_back(resChange->id);
 	}
 
 	// Now we can remove the change set from our list of change sets
@@ -610,36 +771,40 @@ void ResourceManager::addTypeAlias(FileType alias, FileType realType) {
 }
 
 void ResourceManager::blacklist(const Common::UString &name, FileType type) {
-	ResourceMap::iterator resList = _resources.find(getHash(name, type));
-	if (resList == _resources.end())
-		return;
+	size_t count;
+	ResourceIndex::Entry *entries = _index.find(getHash(name, type), count);
 
-	for (ResourceList::iterator res = resList->second.begin(); res != resList->second.end(); ++res)
-		res->priority = 0;
+	for (size_t i = 0; i < count; i++)
+		entries[i].priority = 0;
 }
 
 void ResourceManager::declareResource(const Common::UString &name, FileType type) {
 	bool isSmall = false;
 
-	ResourceMap::iterator resList = _resources.find(getHash(name, type));
-	if (resList == _resources.end()) {
+	size_t count;
+	const ResourceIndex::Entry *entries = _index.find(getHash(name, type), count);
+	if (!entries) {
 		if (_hasSmall) {
 			Common::UString smallName = TypeMan.addFileType(TypeMan.setFileType(name, type), kFileTypeSMALL);
 
-			resList = _resources.find(getHash(smallName));
+			entries = _index.find(getHash(smallName), count);
 			isSmall = true;
 		}
 
-		if (resList == _resources.end())
+		if (!entries)
 			return;
 	}
 
-	for (ResourceList::iterator r = resList->second.begin(); r != resList->second.end(); ++r) {
-		r->name    = name;
-		r->type    = type;
-		r->isSmall = isSmall;
+	const char *internedName = _names.intern(name);
+
+	for (size_t i = 0; i < count; i++) {
+		Resource &r = _resources[entries[i].id];
+
+		r.name    = internedName;
+		r.type    = type;
+		r.isSmall = isSmall;
 
-		checkResourceIsArchive(*r, 0);
+		checkResourceIsArchive(entries[i].id, 0);
 	}
 }
 
@@ -800,31 +965,36 @@ Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 void ResourceManager::getAvailableResources(FileType type,
 		std::list<ResourceID> &list) const {
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
-		if (!r->second.empty() && (r->second.front().type == type)) {
-			list.push_back(ResourceID());
+	std::vector<FileType> types(1, type);
 
-			list.back().name = r->second.front().name;
-			list.back().type = r->second.front().type;
-			list.back().hash = r->first;
-		}
-	}
+	getAvailableResources(types, list);
 }
 
 void ResourceManager::getAvailableResources(const std::vector<FileType> &types,
 		std::list<ResourceID> &list) const {
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
-		for (std::vector<FileType>::const_iterator t = types.begin(); t != types.end(); ++t) {
-			if (!r->second.empty() && (r->second.front().type == *t)) {
-				list.push_back(ResourceID());
+	// The index is unordered, so sort the hashes to keep the list stable
+	std::vector<std::pair<uint64, uint32> > found;
 
-				list.back().name = r->second.front().name;
-				list.back().type = r->second.front().type;
-				list.back().hash = r->first;
-			}
-		}
+	for (ResourceIndex::const_iterator r = _index.begin(); r != _index.end(); ++r) {
+		size_t count;
+		const ResourceIndex::Entry *entries = r.getEntries(count);
+
+		const Resource &res = _resources[entries[0].id];
 
+		for (std::vector<FileType>::const_iterator t = types.begin(); t != types.end(); ++t)
+			if (res.type == *t)
+				found.push_back(std::make_pair(r.getHash(), entries[0].id));
+	}
+
+	std::sort(found.begin(), found.end());
+
+	for (std::vector<std::pair<uint64, uint32> >::const_iterator f = found.begin(); f != found.end(); ++f) {
+		list.push_back(ResourceID());
+
+		list.back().name = _resources[f->second].name;
+		list.back().type = _resources[f->second].type;
+		list.back().hash = f->first;
 	}
 }
 
@@ -900,17 +1070,23 @@ inline uint64 ResourceManager::getHash(const Common::UString &name) const {
 	return Common::hashString(name.toLower(), _hashAlgo);
 }
 
-void ResourceManager::checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList) {
-	if (resource.name.empty() || resList->second.empty())
+void ResourceManager::checkHashCollision(const Resource &resource, uint64 hash) {
+	size_t count;
+	const ResourceIndex::Entry *entries = _index.find(hash, count);
+
+	if (!*resource.name || !entries)
 		return;
 
 	Common::UString newName = TypeMan.setFileType(resource.name, resource.type).toLower();
 
-	for (ResourceList::const_iterator r = resList->second.begin(); r != resList->second.end(); ++r) {
-		if (r->name.empty())
+	for (size_t i = 0; i < count; i++) {
+		const Resource &r = _resources[entries[i].id];
+
+		// Interned names are the same string if and only if they're the same pointer
+		if (!*r.name || ((r.name == resource.name) && (r.type == resource.type)))
 			continue;
 
-		Common::UString oldName = TypeMan.setFileType(r->name, r->type).toLower();
+		Common::UString oldName = TypeMan.setFileType(r.name, r.type).toLower();
 		if (oldName != newName) {
 			warning("ResourceManager: Found hash collision: %s (\"%s\" and \"%s\")",
 					Common::formatHash(getHash(oldName)).c_str(), oldName.c_str(), newName.c_str());
@@ -919,8 +1095,9 @@ void ResourceManager::checkHashCollision(const Resource &resource, ResourceMap::
 	}
 }
 
-bool ResourceManager::checkResourceIsArchive(Resource &resource, Change *change) {
-	if ((resource.source == kSourceNone) || resource.name.empty())
+bool ResourceManager::checkResourceIsArchive(uint32 id, Change *change) {
+	Resource &resource = _resources[id];
+	if ((resource.source == kSourceNone) || !*resource.name)
 		return false;
 
 	ArchiveType type = getArchiveType(resource.type);
@@ -940,7 +1117,7 @@ bool ResourceManager::checkResourceIsArchive(Resource &resource, Change *change)
 
 	KnownArchives &archives = _knownArchives[type];
 
-	archives.push_back(KnownArchive(type, name, resource));
+	archives.push_back(KnownArchive(type, name, id));
 
 	resource.selfArchive = std::make_pair(&archives, --archives.end());
 
@@ -950,62 +1127,60 @@ bool ResourceManager::checkResourceIsArchive(Resource &resource, Change *change)
 	return true;
 }
 
-void ResourceManager::addResource(Resource &resource, uint64 hash, Change *change) {
-	ResourceMap::iterator resList = _resources.find(hash);
-	if (resList == _resources.end()) {
-		// We don't have a resource with this name yet, create a new resource list for it
+void ResourceManager::addResource(const Resource &resource, uint64 hash, uint32 priority, Change *change) {
+#ifdef CHECK_HASH_COLLISION
+	checkHashCollision(resource, hash);
+#endif
 
-		std::pair<ResourceMap::iterator, bool> result;
+	// Put the resource into a free spot in our pool
+	uint32 id;
+	if (!_freeResources.empty()) {
+		id = _freeResources.back();
+		_freeResources.pop_back();
 
-		result = _resources.insert(std::make_pair(hash, ResourceList()));
+		_resources[id] = resource;
+	} else {
+		id = _resources.size();
 
-		resList = result.first;
+		_resources.push_back(resource);
 	}
 
-#ifdef CHECK_HASH_COLLISION
-	checkHashCollision(resource, resList);
-#endif
+	// Add the resource to the index, sorted by priority
+	_index.add(hash, id, priority);
 
-	// Add the resource to the list
-	resList->second.push_back(resource);
-	Resource *res = &resList->second.back();
-
-	checkResourceIsArchive(*res, change);
+	checkResourceIsArchive(id, change);
 
 	// Remember the resource in the change set
 	if (change) {
 		change->_change->resources.push_back(ResourceChange());
-		change->_change->resources.back().hashIt = resList;
-		change->_change->resources.back().resIt  = --resList->second.end();
+		change->_change->resources.back().hash = hash;
+		change->_change->resources.back().id   = id;
 	}
-
-	// Resort the list by priority
-	resList->second.sort();
 }
 
 void ResourceManager::addResource(const Common::UString &path, Change *change, uint32 priority) {
+	Common::UString name = Common::FilePath::getStem(path);
+
 	Resource res;
-	res.priority = priority;
-	res.source   = kSourceFile;
-	res.path     = path;
-	res.name     = Common::FilePath::getStem(path);
-	res.type     = TypeMan.getFileType(path);
+	res.source = kSourceFile;
+	res.path   = _names.intern(path);
+	res.type   = TypeMan.getFileType(path);
 
 	// Handle "small" files
 	if (_hasSmall && (res.type == kFileTypeSMALL)) {
-		const Common::UString name = res.name;
-
 		res.isSmall = true;
 
-		res.name = Common::FilePath::getStem(name);
 		res.type = TypeMan.getFileType(name);
+		name     = Common::FilePath::getStem(name);
 	}
 
-	uint64 hash = getHash(res.name, res.type);
+	res.name = _names.intern(name);
+
+	uint64 hash = getHash(name, res.type);
 	if (normalizeType(res))
-		hash = getHash(res.name, res.type);
+		hash = getHash(name, res.type);
 
-	addResource(res, hash, change);
+	addResource(res, hash, priority, change);
 }
 
 void ResourceManager::addResources(const Common::FileList &files, Change *change, uint32 priority) {
@@ -1013,34 +1188,45 @@ void ResourceManager::addResources(const Common::FileList &files, Change *change
 		addResource(*file, change, priority);
 }
 
+const ResourceIndex::Entry *ResourceManager::findRes(uint64 hash) const {
+	const ResourceIndex::Entry *entry = _index.findTop(hash);
+	if (!entry || (entry->priority == 0))
+		return 0;
+
+	return entry;
+}
+
 const ResourceManager::Resource *ResourceManager::getRes(uint64 hash) const {
-	ResourceMap::const_iterator r = _resources.find(hash);
-	if ((r == _resources.end()) || r->second.empty() || (r->second.back().priority == 0))
+	const ResourceIndex::Entry *entry = findRes(hash);
+	if (!entry)
 		return 0;
 
-	return &r->second.back();
+	return &_resources[entry->id];
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name,
 		const std::vector<FileType> &types) const {
 
-	const Resource *result = 0;
+	const ResourceIndex::Entry *result = 0;
 	for (std::vector<FileType>::const_iterator type = types.begin(); type != types.end(); ++type) {
-		const Resource *res = getRes(getHash(name, *type));
-		if (res && (!result || *result < *res))
+		const ResourceIndex::Entry *res = findRes(getHash(name, *type));
+		if (res && (!result || (result->priority < res->priority)))
 			result = res;
 	}
 	if (!result && _hasSmall) {
 		for (std::vector<FileType>::const_iterator type = types.begin(); type != types.end(); ++type) {
 			Common::UString smallName = TypeMan.addFileType(TypeMan.setFileType(name, *type), kFileTypeSMALL);
 
-			const Resource *res = getRes(getHash(smallName));
-			if (res && (!result || *result < *res))
+			const ResourceIndex::Entry *res = findRes(getHash(smallName));
+			if (res && (!result || (result->priority < res->priority)))
 				result = res;
 		}
 	}
 
-	return result;
+	if (!result)
+		return 0;
+
+	return &_resources[result->id];
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name, FileType type) const {
@@ -1058,19 +1244,29 @@ void ResourceManager::dumpResourcesList(const Common::UString &fileName) const {
 	file.writeString("                Name                 |        Hash        |     Size    \n");
 	file.writeString("-------------------------------------|--------------------|-------------\n");
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
-		if (r->second.empty())
-			continue;
+	// The index is unordered, so sort the hashes to keep the list stable
+	std::vector<std::pair<uint64, uint32> > resources;
+	resources.reserve(_index.size());
+
+	for (ResourceIndex::const_iterator r = _index.begin(); r != _index.end(); ++r) {
+		size_t count;
+		const ResourceIndex::Entry *entries = r.getEntries(count);
+
+		resources.push_back(std::make_pair(r.getHash(), entries[count - 1].id));
+	}
+
+	std::sort(resources.begin(), resources.end());
 
-		const Resource &res = r->second.back();
+	for (std::vector<std::pair<uint64, uint32> >::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		const Resource &res = _resources[r->second];
 
-		const Common::UString &name = res.name;
+		const char            *name = res.name;
 		const Common::UString   ext = TypeMan.setFileType("", res.type);
 		const uint64           hash = r->first;
 		const uint32           size = getResourceSize(res);
 
 		const Common::UString line =
-			Common::UString::format("%32s%4s | %s | %12d\n", name.c_str(), ext.c_str(),
+			Common::UString::format("%32s%4s | %s | %12d\n", name, ext.c_str(),
                                Common::formatHash(hash).c_str(), size);
 
 		file.writeString(line);
@@ -36,8 +36,11 @@
 #include "src/common/filelist.h"
 #include "src/common/hash.h"
 #include "src/common/changeid.h"
+#include "src/common/stringarena.h"
 
 #include "src/aurora/types.h"
+#include "src/aurora/resourceindex.h"
+#include "src/aurora/indexcache.h"
 
 namespace Common {
 	class SeekableReadStream;
@@ -51,6 +54,13 @@ class KEYDataFile;
 
 /** A resource manager holding information about and handling all request for all
  *  resources usable by the game.
+ *
+ *  The const query methods, i.e. hasResource(), getResourceSize(), findResourceFile(),
+ *  getResource() and getAvailableResources(), may be called from any thread, even
+ *  concurrently. Each returned stream is owned by the caller and independent of all
+ *  others. Anything that changes the set of known resources (indexing, undoing,
+ *  declaring, blacklisting, clearing, ...) however must not run concurrently with
+ *  any other call into the resource manager.
  */
 class ResourceManager : public Common::Singleton<ResourceManager> {
 public:
@@ -107,6 +117,24 @@ public:
 	const Common::UString &getDataBase() const;
 	// '---
 
+	// .--- Index cache
+	/** Use a persistent cache file for the resource tables of archives.
+	 *
+	 *  Archives that are found in the cache, and that haven't changed on
+	 *  disk since, are indexed without parsing them again. Archives that
+	 *  do need to be parsed are added to the cache.
+	 *
+	 *  Only KEY, ERF and RIM archives that are direct files, and that store
+	 *  their resources uncompressed and unencrypted, are cached.
+	 *
+	 *  @param file The cache file to use, or an empty string to disable the cache.
+	 */
+	void setIndexCache(const Common::UString &file);
+
+	/** Write the index cache back into its file, if anything changed. */
+	void saveIndexCache();
+	// '---
+
 	// .--- Archives
 	/** Does a specific archive exist?
 	 *
@@ -351,14 +379,14 @@ private:
 		Common::UString name; ///< The archive's name.
 		ArchiveType     type; ///< The archive's type.
 
-		/** The resource this archive is. */
-		Resource *resource;
+		/** The ID of the resource this archive is. */
+		uint32 resource;
 
 		/** The opened archive, if it was. */
 		OpenedArchive *opened;
 
 		KnownArchive();
-		KnownArchive(ArchiveType t, const Common::UString &n, Resource &r);
+		KnownArchive(ArchiveType t, const Common::UString &n, uint32 r);
 	};
 
 	struct OpenedArchive {
@@ -375,7 +403,7 @@ private:
 
 		OpenedArchive();
 
-		void set(KnownArchive &kA, Archive &a);
+		void set(KnownArchive &kA, Archive &a, const Resource &r);
 	};
 
 	/** List of all known archive files. */
@@ -392,17 +420,18 @@ private:
 		kSourceArchive  ///< Within an archive.
 	};
 
-	/** A resource. */
+	/** A resource.
+	 *
+	 *  The priority of a resource is not stored here, but in the
+	 *  resource index, next to the resource's ID.
+	 */
 	struct Resource {
-		Common::UString name; ///< The resource's name.
-		FileType        type; ///< The resource's type.
+		const char *name; ///< The resource's name, interned in the name arena.
+		FileType    type; ///< The resource's type.
 
 		/** Is this a "small" (compressed Nintendo DS) file? */
 		bool isSmall;
 
-		/** The resource's priority over others with the same name and type. */
-		uint32 priority;
-
 		/** The archive this resource itself is. */
 		std::pair<KnownArchives *, KnownArchives::iterator> selfArchive;
 
@@ -410,21 +439,17 @@ private:
 		Source source;
 
 		// For kSourceFile
-		Common::UString path; ///< The file's path.
+		const char *path; ///< The file's path, interned in the name arena.
 
 		// For kSourceArchive
 		OpenedArchive *archive;      ///< Pointer to the opened archive.
 		uint32         archiveIndex; ///< Index into the archive.
 
 		Resource();
-
-		bool operator<(const Resource &right) const;
 	};
 
-	/** List of resources, sorted by priority. */
-	typedef std::list<Resource> ResourceList;
-	/** Map over resources, indexed by their hashed name. */
-	typedef std::map<uint64, ResourceList> ResourceMap;
+	/** All resources, indexed by their ID. */
+	typedef std::vector<Resource> ResourcePool;
 	// '---
 
 	// .--- Changes
@@ -434,8 +459,8 @@ private:
 	typedef OpenedArchives::iterator OpenedArchiveChange;
 	/** A change produced by indexing archive resources. */
 	struct ResourceChange {
-		ResourceMap::iterator  hashIt;
-		ResourceList::iterator resIt;
+		uint64 hash; ///< The hashed name of the added resource.
+		uint32 id;   ///< The ID of the added resource.
 	};
 
 	typedef std::list<KnownArchiveChange>  KnownArchiveChanges;
@@ -487,8 +512,16 @@ private:
 	/** The current type aliases, changing one type to another. */
 	std::map<FileType, FileType> _typeAliases;
 
-	ResourceMap   _resources; ///< All currently known resources.
-	ChangeSetList _changes;   ///< Changes produced by indexing the currently known resources.
+	ResourcePool        _resources;     ///< All currently known resources.
+	std::vector<uint32> _freeResources; ///< IDs of removed resources, to be reused.
+
+	ResourceIndex       _index; ///< Index over all resources, by hashed name and priority.
+	Common::StringArena _names; ///< The names and paths of all resources.
+
+	IndexCache      _indexCache;     ///< Cached resource tables of archives.
+	Common::UString _indexCacheFile; ///< The file the index cache is stored in.
+
+	ChangeSetList _changes; ///< Changes produced by indexing the currently known resources.
 
 	FileTypeSet  _archiveTypeTypes [kArchiveMAX];  ///< All valid archive types file types.
 	FileTypeList _resourceTypeTypes[kResourceMAX]; ///< All valid resource type file types.
@@ -502,7 +535,8 @@ private:
 	// '---
 
 	// .--- Indexing archives
-	void indexKEY(Common::SeekableReadStream *stream, uint32 priority, Change *change);
+	void indexKEY(const KnownArchive &keyArchive, Common::SeekableReadStream *stream,
+	              uint32 priority, Change *change);
 	uint32 openKEYBIFs(Common::SeekableReadStream *keyStream,
 	                   std::vector<KnownArchive *> &archives, std::vector<KEYDataFile *> &keyData);
 
@@ -512,17 +546,28 @@ private:
 	Common::SeekableReadStream *openArchiveStream(const KnownArchive &archive) const;
 	// '---
 
+	// .--- Index cache
+	const char *getCacheablePath(const KnownArchive &archive) const;
+
+	bool indexCachedArchive(KnownArchive &knownArchive, uint32 priority, Change *change);
+
+	bool createCacheEntry(const KnownArchive &archive, IndexCache::Entry &entry) const;
+	bool addCacheDataFile(const KnownArchive &archive, const Archive &data, IndexCache::Entry &entry) const;
+	// '---
+
 	// .--- Adding resources
 
-	bool checkResourceIsArchive(Resource &resource, Change *change);
+	bool checkResourceIsArchive(uint32 id, Change *change);
 
-	void addResource(Resource &resource, uint64 hash, Change *change);
+	void addResource(const Resource &resource, uint64 hash, uint32 priority, Change *change);
 	void addResource(const Common::UString &path, Change *change, uint32 priority);
 
 	void addResources(const Common::FileList &files, Change *change, uint32 priority);
 	// '---
 
 	// .--- Finding and getting resources
+	const ResourceIndex::Entry *findRes(uint64 hash) const;
+
 	const Resource *getRes(uint64 hash) const;
 	const Resource *getRes(const Common::UString &name, const std::vector<FileType> &types) const;
 	const Resource *getRes(const Common::UString &name, FileType type) const;
@@ -544,7 +589,7 @@ private:
 	inline uint64 getHash(const Common::UString &name, FileType type) const;
 	inline uint64 getHash(const Common::UString &name) const;
 
-	void checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList);
+	void checkHashCollision(const Resource &resource, uint64 hash);
 
 	Change *newChangeSet(Common::ChangeID &changeID);
 	// '---
@@ -0,0 +1,311 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A flat hash index over resource name hashes.
+ */
+
+#include <cstring>
+
+#include "src/common/util.h"
+
+#include "src/aurora/resourceindex.h"
+
+namespace Aurora {
+
+ResourceIndex::Entry *ResourceIndex::Slot::getEntries() {
+	return (capacity == 0) ? local : external;
+}
+
+const ResourceIndex::Entry *ResourceIndex::Slot::getEntries() const {
+	return (capacity == 0) ? local : external;
+}
+
+
+ResourceIndex::const_iterator::const_iterator(const Slot *slot, const Slot *end) : _slot(slot), _end(end) {
+	while ((_slot != _end) && (_slot->count == 0))
+		++_slot;
+}
+
+ResourceIndex::const_iterator &ResourceIndex::const_iterator::operator++() {
+	do {
+		++_slot;
+	} while ((_slot != _end) && (_slot->count == 0));
+
+	return *this;
+}
+
+bool ResourceIndex::const_iterator::operator==(const const_iterator &it) const {
+	return _slot == it._slot;
+}
+
+bool ResourceIndex::const_iterator::operator!=(const const_iterator &it) const {
+	return _slot != it._slot;
+}
+
+uint64 ResourceIndex::const_iterator::getHash() const {
+	return _slot->hash;
+}
+
+const ResourceIndex::Entry *ResourceIndex::const_iterator::getEntries(size_t &count) const {
+	count = _slot->count;
+
+	return _slot->getEntries();
+}
+
+
+ResourceIndex::ResourceIndex() : _count(0) {
+}
+
+ResourceIndex::~ResourceIndex() {
+	clear();
+}
+
+bool ResourceIndex::empty() const {
+	return _count == 0;
+}
+
+size_t ResourceIndex::size() const {
+	return _count;
+}
+
+void ResourceIndex::clear() {
+	for (std::vector<Slot>::iterator s = _slots.begin(); s != _slots.end(); ++s)
+		freeEntries(*s);
+
+	_slots.clear();
+	_count = 0;
+}
+
+ResourceIndex::const_iterator ResourceIndex::begin() const {
+	if (_slots.empty())
+		return const_iterator(0, 0);
+
+	return const_iterator(&_slots.front(), &_slots.front() + _slots.size());
+}
+
+ResourceIndex::const_iterator ResourceIndex::end() const {
+	if (_slots.empty())
+		return const_iterator(0, 0);
+
+	return const_iterator(&_slots.front() + _slots.size(), &_slots.front() + _slots.size());
+}
+
+size_t ResourceIndex::getHome(uint64 hash, size_t mask) {
+	/* The name hashes might only be 32 bits wide (CRC32, DJB2, FNV32), and
+	 * are not necessarily evenly spread over the lower bits. Mix them up,
+	 * using the finalizer of MurmurHash3. */
+
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+
+	return (size_t) hash & mask;
+}
+
+size_t ResourceIndex::findSlot(uint64 hash) const {
+	const size_t mask = _slots.size() - 1;
+
+	for (size_t i = getHome(hash, mask); ; i = (i + 1) & mask)
+		if ((_slots[i].count == 0) || (_slots[i].hash == hash))
+			return i;
+}
+
+const ResourceIndex::Entry *ResourceIndex::find(uint64 hash, size_t &count) const {
+	count = 0;
+	if (_count == 0)
+		return 0;
+
+	const Slot &slot = _slots[findSlot(hash)];
+	if (slot.count == 0)
+		return 0;
+
+	count = slot.count;
+	return slot.getEntries();
+}
+
+ResourceIndex::Entry *ResourceIndex::find(uint64 hash, size_t &count) {
+	count = 0;
+	if (_count == 0)
+		return 0;
+
+	Slot &slot = _slots[findSlot(hash)];
+	if (slot.count == 0)
+		return 0;
+
+	count = slot.count;
+	return slot.getEntries();
+}
+
+const ResourceIndex::Entry *ResourceIndex::findTop(uint64 hash) const {
+	size_t count;
+	const Entry *entries = find(hash, count);
+	if (!entries)
+		return 0;
+
+	return &entries[count - 1];
+}
+
+void ResourceIndex::add(uint64 hash, uint32 id, uint32 priority) {
+	// Keep the load factor below 3/4
+	if (((_count + 1) * 4) > (_slots.size() * 3))
+		grow();
+
+	Slot &slot = _slots[findSlot(hash)];
+	if (slot.count == 0) {
+		slot.hash     = hash;
+		slot.capacity = 0;
+
+		_count++;
+	}
+
+	insertEntry(slot, id, priority);
+}
+
+bool ResourceIndex::remove(uint64 hash, uint32 id) {
+	if (_count == 0)
+		return false;
+
+	const size_t index = findSlot(hash);
+	if ((_slots[index].count == 0) || !removeEntry(_slots[index], id))
+		return false;
+
+	if (_slots[index].count == 0)
+		erase(index);
+
+	return true;
+}
+
+void ResourceIndex::grow() {
+	std::vector<Slot> oldSlots(MAX<size_t>(_slots.size() * 2, 1024));
+	oldSlots.swap(_slots);
+
+	// The slots are plain data, the entry arrays just move along with them
+	const size_t mask = _slots.size() - 1;
+	for (std::vector<Slot>::const_iterator s = oldSlots.begin(); s != oldSlots.end(); ++s) {
+		if (s->count == 0)
+			continue;
+
+		size_t i = getHome(s->hash, mask);
+		while (_slots[i].count != 0)
+			i = (i + 1) & mask;
+
+		_slots[i] = *s;
+	}
+}
+
+void ResourceIndex::erase(size_t index) {
+	freeEntries(_slots[index]);
+
+	/* Backward shift deletion: move following slots of the same probe
+	 * sequence up into the hole, so that lookups never need tombstones. */
+
+	const size_t mask = _slots.size() - 1;
+
+	size_t hole = index;
+	for (size_t i = (hole + 1) & mask; _slots[i].count != 0; i = (i + 1) & mask) {
+		const size_t home = getHome(_slots[i].hash, mask);
+
+		// Can this slot be moved into the hole without ending up before its home?
+		const bool stays = (hole <= i) ? ((hole < home) && (home <= i)) : ((hole < home) || (home <= i));
+		if (stays)
+			continue;
+
+		_slots[hole] = _slots[i];
+		hole = i;
+	}
+
+	_slots[hole].count    = 0;
+	_slots[hole].capacity = 0;
+
+	_count--;
+}
+
+void ResourceIndex::insertEntry(Slot &slot, uint32 id, uint32 priority) {
+	if ((slot.capacity == 0) && (slot.count == kLocalEntryCount)) {
+		// Out of local space, move the entries into an external array
+
+		Entry *entries = new Entry[kLocalEntryCount * 2];
+		std::memcpy(entries, slot.local, kLocalEntryCount * sizeof(Entry));
+
+		slot.external = entries;
+		slot.capacity = kLocalEntryCount * 2;
+
+	} else if ((slot.capacity != 0) && (slot.count == slot.capacity)) {
+		Entry *entries = new Entry[slot.capacity * 2];
+		std::memcpy(entries, slot.external, slot.count * sizeof(Entry));
+
+		delete[] slot.external;
+
+		slot.external  = entries;
+		slot.capacity *= 2;
+	}
+
+	Entry *entries = slot.getEntries();
+
+	// Sort after all entries with a lower or equal priority
+	size_t pos = slot.count;
+	while ((pos > 0) && (entries[pos - 1].priority > priority)) {
+		entries[pos] = entries[pos - 1];
+		pos--;
+	}
+
+	entries[pos].priority = priority;
+	entries[pos].id       = id;
+
+	slot.count++;
+}
+
+bool ResourceIndex::removeEntry(Slot &slot, uint32 id) {
+	Entry *entries = slot.getEntries();
+
+	size_t pos = 0;
+	while ((pos < slot.count) && (entries[pos].id != id))
+		pos++;
+
+	if (pos == slot.count)
+		return false;
+
+	for (slot.count--; pos < slot.count; pos++)
+		entries[pos] = entries[pos + 1];
+
+	if ((slot.capacity != 0) && (slot.count <= kLocalEntryCount)) {
+		// Move the remaining entries back into the slot
+
+		Entry local[kLocalEntryCount];
+		std::memcpy(local, entries, slot.count * sizeof(Entry));
+
+		delete[] slot.external;
+
+		std::memcpy(slot.local, local, slot.count * sizeof(Entry));
+		slot.capacity = 0;
+	}
+
+	return true;
+}
+
+void ResourceIndex::freeEntries(Slot &slot) {
+	if (slot.capacity != 0)
+		delete[] slot.external;
+
+	slot.capacity = 0;
+}
+
+} // End of namespace Aurora
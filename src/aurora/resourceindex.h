@@ -0,0 +1,155 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A flat hash index over resource name hashes.
+ */
+
+#ifndef AURORA_RESOURCEINDEX_H
+#define AURORA_RESOURCEINDEX_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Aurora {
+
+/** A flat, open-addressed hash index over resource name hashes.
+ *
+ *  For each name hash, the index holds a list of resource IDs together
+ *  with their priorities, sorted by ascending priority. Among resources
+ *  of the same priority, the one added last is sorted last.
+ *
+ *  All slots live in one contiguous array, and the first few entries
+ *  of each hash are stored inline in their slot. Only hashes with many
+ *  competing resources need an extra allocation.
+ */
+class ResourceIndex : boost::noncopyable {
+public:
+	/** A resource within the index. */
+	struct Entry {
+		uint32 priority; ///< The priority of the resource over others with the same hash.
+		uint32 id;       ///< The ID of the resource.
+	};
+
+private:
+	static const size_t kLocalEntryCount = 2;
+
+	struct Slot {
+		uint64 hash;     ///< The name hash this slot is for.
+		uint32 count;    ///< The number of entries. 0 if the slot is empty.
+		uint32 capacity; ///< The capacity of the external entry array. 0 if the entries are local.
+
+		union {
+			Entry  local[kLocalEntryCount];
+			Entry *external;
+		};
+
+		Entry *getEntries();
+		const Entry *getEntries() const;
+	};
+
+public:
+	/** Iterating over all hashes in the index, in no particular order. */
+	class const_iterator {
+	public:
+		const_iterator &operator++();
+
+		bool operator==(const const_iterator &it) const;
+		bool operator!=(const const_iterator &it) const;
+
+		/** Return the name hash. */
+		uint64 getHash() const;
+
+		/** Return the resources of this hash, sorted by ascending priority. */
+		const Entry *getEntries(size_t &count) const;
+
+	private:
+		const_iterator(const Slot *slot, const Slot *end);
+
+		const Slot *_slot;
+		const Slot *_end;
+
+		friend class ResourceIndex;
+	};
+
+	ResourceIndex();
+	~ResourceIndex();
+
+	/** Are there no resources in the index? */
+	bool empty() const;
+	/** Return the number of distinct hashes in the index. */
+	size_t size() const;
+
+	/** Remove all resources from the index. */
+	void clear();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	/** Add a resource to the index.
+	 *
+	 *  @param hash The hash of the resource's name.
+	 *  @param id The ID of the resource.
+	 *  @param priority The priority of the resource.
+	 */
+	void add(uint64 hash, uint32 id, uint32 priority);
+
+	/** Remove a resource from the index.
+	 *
+	 *  @param  hash The hash of the resource's name.
+	 *  @param  id The ID of the resource.
+	 *  @return true if the resource was found and removed.
+	 */
+	bool remove(uint64 hash, uint32 id);
+
+	/** Return all resources for this hash, sorted by ascending priority.
+	 *
+	 *  @param  hash The hash to look for.
+	 *  @param  count The number of resources found will be stored here.
+	 *  @return The resources, or 0 if there are none.
+	 */
+	const Entry *find(uint64 hash, size_t &count) const;
+	Entry *find(uint64 hash, size_t &count);
+
+	/** Return the resource with the highest priority for this hash, or 0 if there is none. */
+	const Entry *findTop(uint64 hash) const;
+
+private:
+	std::vector<Slot> _slots;
+	size_t _count; ///< The number of used slots.
+
+	static size_t getHome(uint64 hash, size_t mask);
+
+	size_t findSlot(uint64 hash) const;
+
+	void grow();
+	void erase(size_t index);
+
+	static void insertEntry(Slot &slot, uint32 id, uint32 priority);
+	static bool removeEntry(Slot &slot, uint32 id);
+	static void freeEntries(Slot &slot);
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_RESOURCEINDEX_H
@@ -105,15 +105,21 @@ uint32 RIMFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
-Common::SeekableReadStream *RIMFile::getResource(uint32 index, bool tryNoCopy) const {
+Common::SeekableReadStream *RIMFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
-	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_rim.get(), res.offset, res.offset + res.size);
+	return readArchiveData(*_rim, res.offset, res.size);
+}
+
+bool RIMFile::getResourceLocations(ResourceLocations &locations) const {
+	locations.resize(_iResources.size());
 
-	_rim->seek(res.offset);
+	for (size_t i = 0; i < _iResources.size(); i++) {
+		locations[i].offset = _iResources[i].offset;
+		locations[i].size   = _iResources[i].size;
+	}
 
-	return _rim->readStream(res.size);
+	return true;
 }
 
 } // End of namespace Aurora
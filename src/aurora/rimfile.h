@@ -73,6 +73,9 @@ public:
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
+	/** Return where the data of all resources can be found within the archive file. */
+	bool getResourceLocations(ResourceLocations &locations) const;
+
 private:
 	/** Internal resource information. */
 	struct IResource {
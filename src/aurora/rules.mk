@@ -38,6 +38,8 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/rimfile.h \
     src/aurora/ndsrom.h \
     src/aurora/zipfile.h \
+    src/aurora/resourceindex.h \
+    src/aurora/indexcache.h \
     src/aurora/resman.h \
     src/aurora/talktable.h \
     src/aurora/talktable_tlk.h \
@@ -86,6 +88,8 @@ src_aurora_libaurora_la_SOURCES += \
     src/aurora/rimfile.cpp \
     src/aurora/ndsrom.cpp \
     src/aurora/zipfile.cpp \
+    src/aurora/resourceindex.cpp \
+    src/aurora/indexcache.cpp \
     src/aurora/resman.cpp \
     src/aurora/talktable.cpp \
     src/aurora/talktable_tlk.cpp \
@@ -22,6 +22,9 @@
  *  Handling TheWitcherSave Archives.
  */
 
+#include "src/common/system.h"
+#include "src/common/memreadstream.h"
+
 #include "src/aurora/thewitchersavefile.h"
 #include "src/aurora/util.h"
 
@@ -43,16 +46,10 @@ const Archive::ResourceList &TheWitcherSaveFile::getResources() const {
 	return _resourceList;
 }
 
-Common::SeekableReadStream *TheWitcherSaveFile::getResource(uint32 index, bool tryNoCopy) const {
-	IResource resource = _resources[index];
+Common::SeekableReadStream *TheWitcherSaveFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
+	const IResource &resource = _resources[index];
 
-	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_tws.get(), resource.offset, resource.offset + resource.length);
-	else {
-		_tws->seek(resource.offset);
-		Common::SeekableReadStream *readStream = _tws->readStream(resource.length);
-		return readStream;
-	}
+	return readArchiveData(*_tws, resource.offset, resource.length);
 }
 
 void TheWitcherSaveFile::load() {
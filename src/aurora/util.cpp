@@ -353,14 +353,20 @@ const FileTypeManager::Type FileTypeManager::types[] = {
 
 
 FileTypeManager::FileTypeManager() {
+	/* Build all the lookup tables right away. Afterwards, they're only ever
+	 * read, so that file types can be looked up from several threads at once. */
+
+	buildExtensionLookup();
+	buildTypeLookup();
+
+	for (int algo = 0; algo < Common::kHashMAX; algo++)
+		buildHashLookup((Common::HashAlgo) algo);
 }
 
 FileTypeManager::~FileTypeManager() {
 }
 
-FileType FileTypeManager::getFileType(const Common::UString &path) {
-	buildExtensionLookup();
-
+FileType FileTypeManager::getFileType(const Common::UString &path) const {
 	Common::UString ext = Common::FilePath::getExtension(path).toLower();
 
 	ExtensionLookup::const_iterator t = _extensionLookup.find(ext);
@@ -370,13 +376,11 @@ FileType FileTypeManager::getFileType(const Common::UString &path) {
 	return kFileTypeNone;
 }
 
-Common::UString FileTypeManager::addFileType(const Common::UString &path, FileType type) {
+Common::UString FileTypeManager::addFileType(const Common::UString &path, FileType type) const {
 	return setFileType(path + ".", type);
 }
 
-Common::UString FileTypeManager::setFileType(const Common::UString &path, FileType type) {
-	buildTypeLookup();
-
+Common::UString FileTypeManager::setFileType(const Common::UString &path, FileType type) const {
 	Common::UString ext;
 	TypeLookup::const_iterator t = _typeLookup.find(type);
 	if (t != _typeLookup.end())
@@ -385,12 +389,10 @@ Common::UString FileTypeManager::setFileType(const Common::UString &path, FileTy
 	return Common::FilePath::changeExtension(path, ext);
 }
 
-FileType FileTypeManager::getFileType(Common::HashAlgo algo, uint64 hashedExtension) {
+FileType FileTypeManager::getFileType(Common::HashAlgo algo, uint64 hashedExtension) const {
 	if ((algo < 0) || (algo >= Common::kHashMAX))
 		return kFileTypeNone;
 
-	buildHashLookup(algo);
-
 	HashLookup::const_iterator t = _hashLookup[algo].find(hashedExtension);
 	if (t != _hashLookup[algo].end())
 		return t->second->type;
@@ -399,25 +401,16 @@ FileType FileTypeManager::getFileType(Common::HashAlgo algo, uint64 hashedExtens
 }
 
 void FileTypeManager::buildExtensionLookup() {
-	if (!_extensionLookup.empty())
-		return;
-
 	for (size_t i = 0; i < ARRAYSIZE(types); i++)
 		_extensionLookup.insert(std::make_pair(Common::UString(types[i].extension), &types[i]));
 }
 
 void FileTypeManager::buildTypeLookup() {
-	if (!_typeLookup.empty())
-		return;
-
 	for (size_t i = 0; i < ARRAYSIZE(types); i++)
 		_typeLookup.insert(std::make_pair(types[i].type, &types[i]));
 }
 
 void FileTypeManager::buildHashLookup(Common::HashAlgo algo) {
-	if (!_hashLookup[algo].empty())
-		return;
-
 	for (size_t i = 0; i < ARRAYSIZE(types); i++) {
 		const char *ext = types[i].extension;
 		if (ext[0] == '.')
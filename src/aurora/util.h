@@ -39,21 +39,25 @@ namespace Aurora {
 Common::UString getPlatformDescription(Platform platform);
 
 
+/** Mapping between file types and file name extensions.
+ *
+ *  All lookups are read-only and may happen from several threads at once.
+ */
 class FileTypeManager : public Common::Singleton<FileTypeManager> {
 public:
 	FileTypeManager();
 	~FileTypeManager();
 
 	/** Return the file type of a file name, detected by its extension. */
-	FileType getFileType(const Common::UString &path);
+	FileType getFileType(const Common::UString &path) const;
 
 	/** Return the file type of a file name, detected by its hashed extension. */
-	FileType getFileType(Common::HashAlgo algo, uint64 hashedExtension);
+	FileType getFileType(Common::HashAlgo algo, uint64 hashedExtension) const;
 
 	/** Return the file name with an added extensions according to the specified file type. */
-	Common::UString addFileType(const Common::UString &path, FileType type);
+	Common::UString addFileType(const Common::UString &path, FileType type) const;
 	/** Return the file name with a swapped extensions according to the specified file type. */
-	Common::UString setFileType(const Common::UString &path, FileType type);
+	Common::UString setFileType(const Common::UString &path, FileType type) const;
 
 
 private:
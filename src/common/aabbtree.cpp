@@ -0,0 +1,429 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy of axis-aligned bounding boxes.
+ */
+
+#include <cassert>
+
+#include <algorithm>
+
+#include "glm/common.hpp"
+#include "glm/vector_relational.hpp"
+
+#include "src/common/aabbtree.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+bool AABBTree::Hit::operator<(const Hit &right) const {
+	return distance < right.distance;
+}
+
+bool AABBTree::Node::isLeaf() const {
+	return child1 == kInvalidProxy;
+}
+
+
+AABBTree::AABBTree(float margin) : _margin(margin), _root(kInvalidProxy), _freeList(kInvalidProxy), _leafCount(0) {
+}
+
+AABBTree::~AABBTree() {
+}
+
+void AABBTree::clear() {
+	_nodes.clear();
+
+	_root      = kInvalidProxy;
+	_freeList  = kInvalidProxy;
+	_leafCount = 0;
+}
+
+size_t AABBTree::size() const {
+	return _leafCount;
+}
+
+uint32 AABBTree::getHeight() const {
+	if (_root == kInvalidProxy)
+		return 0;
+
+	return _nodes[_root].height + 1;
+}
+
+uint32 AABBTree::allocateNode() {
+	if (_freeList == kInvalidProxy) {
+		_nodes.push_back(Node());
+		_nodes.back().parent = _freeList;
+		_nodes.back().height = -1;
+
+		_freeList = _nodes.size() - 1;
+	}
+
+	const uint32 node = _freeList;
+	Node &n = _nodes[node];
+
+	_freeList = n.parent;
+
+	n.data   = 0;
+	n.parent = kInvalidProxy;
+	n.child1 = kInvalidProxy;
+	n.child2 = kInvalidProxy;
+	n.height = 0;
+
+	return node;
+}
+
+void AABBTree::freeNode(uint32 node) {
+	_nodes[node].parent = _freeList;
+	_nodes[node].height = -1;
+
+	_freeList = node;
+}
+
+uint32 AABBTree::insert(const glm::vec3 &min, const glm::vec3 &max, void *data) {
+	const uint32 leaf = allocateNode();
+	Node &node = _nodes[leaf];
+
+	node.data = data;
+	setFatBox(node, min, max);
+
+	insertLeaf(leaf);
+	_leafCount++;
+
+	return leaf;
+}
+
+void AABBTree::remove(uint32 proxy) {
+	assert((proxy < _nodes.size()) && _nodes[proxy].isLeaf() && (_nodes[proxy].height == 0));
+
+	removeLeaf(proxy);
+	freeNode(proxy);
+
+	_leafCount--;
+}
+
+bool AABBTree::update(uint32 proxy, const glm::vec3 &min, const glm::vec3 &max) {
+	assert((proxy < _nodes.size()) && _nodes[proxy].isLeaf() && (_nodes[proxy].height == 0));
+
+	Node &node = _nodes[proxy];
+
+	if (glm::all(glm::greaterThanEqual(min, node.min)) && glm::all(glm::lessThanEqual(max, node.max))) {
+		// Still within the fat box, the tree can stay as it is
+		node.objectMin = min;
+		node.objectMax = max;
+
+		return false;
+	}
+
+	removeLeaf(proxy);
+	setFatBox(_nodes[proxy], min, max);
+	insertLeaf(proxy);
+
+	return true;
+}
+
+void *AABBTree::getData(uint32 proxy) const {
+	assert(proxy < _nodes.size());
+
+	return _nodes[proxy].data;
+}
+
+void AABBTree::setFatBox(Node &node, const glm::vec3 &min, const glm::vec3 &max) {
+	node.objectMin = min;
+	node.objectMax = max;
+
+	node.min = min - glm::vec3(_margin);
+	node.max = max + glm::vec3(_margin);
+}
+
+void AABBTree::setUnion(Node &node, const Node &child1, const Node &child2) {
+	node.min = glm::min(child1.min, child2.min);
+	node.max = glm::max(child1.max, child2.max);
+}
+
+float AABBTree::getArea(const glm::vec3 &min, const glm::vec3 &max) {
+	const glm::vec3 d = max - min;
+
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+float AABBTree::getUnionArea(const Node &node1, const Node &node2) {
+	return getArea(glm::min(node1.min, node2.min), glm::max(node1.max, node2.max));
+}
+
+void AABBTree::insertLeaf(uint32 leaf) {
+	if (_root == kInvalidProxy) {
+		_root = leaf;
+		_nodes[leaf].parent = kInvalidProxy;
+		return;
+	}
+
+	/* Find the best sibling for the new leaf, by walking down the tree
+	 * along the cheapest path. The cost of a node is the surface area
+	 * its box would gain, for itself and all its ancestors. */
+
+	const Node &leafNode = _nodes[leaf];
+
+	uint32 index = _root;
+	while (!_nodes[index].isLeaf()) {
+		const Node &node = _nodes[index];
+
+		const float area         = getArea(node.min, node.max);
+		const float combinedArea = getUnionArea(node, leafNode);
+
+		// Cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		const uint32 children[2] = { node.child1, node.child2 };
+
+		for (int i = 0; i < 2; i++) {
+			const Node &child = _nodes[children[i]];
+
+			childCost[i] = getUnionArea(child, leafNode) + inheritanceCost;
+			if (!child.isLeaf())
+				childCost[i] -= getArea(child.min, child.max);
+		}
+
+		if ((cost < childCost[0]) && (cost < childCost[1]))
+			break;
+
+		index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+	}
+
+	const uint32 sibling   = index;
+	const uint32 oldParent = _nodes[sibling].parent;
+
+	// Create a new parent for the sibling and the leaf
+
+	const uint32 newParent = allocateNode();
+
+	Node &parent = _nodes[newParent];
+
+	parent.parent = oldParent;
+	parent.child1 = sibling;
+	parent.child2 = leaf;
+	parent.height = _nodes[sibling].height + 1;
+	setUnion(parent, _nodes[sibling], _nodes[leaf]);
+
+	if (oldParent != kInvalidProxy) {
+		if (_nodes[oldParent].child1 == sibling)
+			_nodes[oldParent].child1 = newParent;
+		else
+			_nodes[oldParent].child2 = newParent;
+	} else
+		_root = newParent;
+
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf].parent    = newParent;
+
+	refit(_nodes[leaf].parent);
+}
+
+void AABBTree::removeLeaf(uint32 leaf) {
+	if (leaf == _root) {
+		_root = kInvalidProxy;
+		return;
+	}
+
+	const uint32 parent      = _nodes[leaf].parent;
+	const uint32 grandParent = _nodes[parent].parent;
+	const uint32 sibling     = (_nodes[parent].child1 == leaf) ? _nodes[parent].child2 : _nodes[parent].child1;
+
+	// Replace the parent with the sibling
+
+	freeNode(parent);
+
+	if (grandParent == kInvalidProxy) {
+		_root = sibling;
+		_nodes[sibling].parent = kInvalidProxy;
+		return;
+	}
+
+	if (_nodes[grandParent].child1 == parent)
+		_nodes[grandParent].child1 = sibling;
+	else
+		_nodes[grandParent].child2 = sibling;
+
+	_nodes[sibling].parent = grandParent;
+
+	refit(grandParent);
+}
+
+void AABBTree::refit(uint32 node) {
+	while (node != kInvalidProxy) {
+		node = balance(node);
+
+		Node &n = _nodes[node];
+
+		const Node &child1 = _nodes[n.child1];
+		const Node &child2 = _nodes[n.child2];
+
+		n.height = 1 + MAX(child1.height, child2.height);
+		setUnion(n, child1, child2);
+
+		node = n.parent;
+	}
+}
+
+uint32 AABBTree::balance(uint32 iA) {
+	/* If one child of A is higher than the other by more than one level,
+	 * rotate that child up:
+	 *
+	 *         A                  C
+	 *       /   \              /   \
+	 *      B     C     =>     A     F
+	 *           / \          / \
+	 *          F   G        B   G
+	 *
+	 * (or symmetrically), with F being the higher of C's children. */
+
+	Node &A = _nodes[iA];
+	if (A.isLeaf() || (A.height < 2))
+		return iA;
+
+	const uint32 iB = A.child1;
+	const uint32 iC = A.child2;
+
+	const int32 balance = _nodes[iC].height - _nodes[iB].height;
+	if ((balance >= -1) && (balance <= 1))
+		return iA;
+
+	// Rotate the higher child up
+	const uint32 iUp    = (balance > 1) ? iC : iB;
+	const uint32 iOther = (balance > 1) ? iB : iC;
+
+	Node &up = _nodes[iUp];
+
+	const uint32 iF = up.child1;
+	const uint32 iG = up.child2;
+
+	// Swap A and the higher child
+	up.child1 = iA;
+	up.parent = A.parent;
+	A.parent  = iUp;
+
+	if (up.parent != kInvalidProxy) {
+		if (_nodes[up.parent].child1 == iA)
+			_nodes[up.parent].child1 = iUp;
+		else
+			_nodes[up.parent].child2 = iUp;
+	} else
+		_root = iUp;
+
+	// Keep the higher grandchild with the new root, give the other one to A
+	const bool fHigher = _nodes[iF].height > _nodes[iG].height;
+
+	const uint32 iKeep = fHigher ? iF : iG;
+	const uint32 iMove = fHigher ? iG : iF;
+
+	up.child2 = iKeep;
+
+	if (balance > 1)
+		A.child2 = iMove;
+	else
+		A.child1 = iMove;
+
+	_nodes[iMove].parent = iA;
+
+	setUnion(A, _nodes[A.child1], _nodes[A.child2]);
+	A.height = 1 + MAX(_nodes[iOther].height, _nodes[iMove].height);
+
+	setUnion(up, A, _nodes[iKeep]);
+	up.height = 1 + MAX(A.height, _nodes[iKeep].height);
+
+	return iUp;
+}
+
+bool AABBTree::intersectLine(const glm::vec3 &from, const glm::vec3 &delta,
+                             const glm::vec3 &min, const glm::vec3 &max, float &distance) {
+
+	// Clip the line against the three slabs of the box
+
+	float tMin = 0.0f, tMax = 1.0f;
+
+	for (int i = 0; i < 3; i++) {
+		if (delta[i] == 0.0f) {
+			if ((from[i] < min[i]) || (from[i] > max[i]))
+				return false;
+
+			continue;
+		}
+
+		float t1 = (min[i] - from[i]) / delta[i];
+		float t2 = (max[i] - from[i]) / delta[i];
+		if (t1 > t2)
+			std::swap(t1, t2);
+
+		tMin = MAX(tMin, t1);
+		tMax = MIN(tMax, t2);
+
+		if (tMin > tMax)
+			return false;
+	}
+
+	distance = tMin;
+	return true;
+}
+
+void AABBTree::findLine(const glm::vec3 &from, const glm::vec3 &to, std::vector<Hit> &hits) const {
+	hits.clear();
+
+	if (_root == kInvalidProxy)
+		return;
+
+	const glm::vec3 delta = to - from;
+
+	std::vector<uint32> stack;
+	stack.reserve(64);
+
+	stack.push_back(_root);
+	while (!stack.empty()) {
+		const Node &node = _nodes[stack.back()];
+		stack.pop_back();
+
+		float distance;
+		if (!intersectLine(from, delta, node.min, node.max, distance))
+			continue;
+
+		if (!node.isLeaf()) {
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+			continue;
+		}
+
+		if (!intersectLine(from, delta, node.objectMin, node.objectMax, distance))
+			continue;
+
+		Hit hit;
+		hit.distance = distance;
+		hit.data     = node.data;
+
+		hits.push_back(hit);
+	}
+
+	std::stable_sort(hits.begin(), hits.end());
+}
+
+} // End of namespace Common
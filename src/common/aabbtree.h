@@ -0,0 +1,160 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy of axis-aligned bounding boxes.
+ */
+
+#ifndef COMMON_AABBTREE_H
+#define COMMON_AABBTREE_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "glm/vec3.hpp"
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A dynamic tree of axis-aligned bounding boxes.
+ *
+ *  Each object in the tree is represented by a leaf, which holds a
+ *  slightly enlarged ("fat") copy of the object's bounding box. As long
+ *  as a moving object stays within its fat box, the tree doesn't need to
+ *  change. Otherwise, the leaf is taken out and reinserted, and the tree
+ *  is rebalanced by rotations along the way up. The tree therefore stays
+ *  at logarithmic height while objects come, go and move.
+ *
+ *  Modelled after the dynamic tree of Erin Catto's Box2D.
+ */
+class AABBTree : boost::noncopyable {
+public:
+	static const uint32 kInvalidProxy = 0xFFFFFFFF;
+
+	/** An object intersected by a line. */
+	struct Hit {
+		float distance; ///< Where the line enters the object's box, as a fraction of the line's length.
+		void *data;     ///< The object's user data.
+
+		bool operator<(const Hit &right) const;
+	};
+
+	/** Create a tree.
+	 *
+	 *  @param margin How far to enlarge the boxes of the objects.
+	 */
+	AABBTree(float margin = 0.5f);
+	~AABBTree();
+
+	/** Remove all objects from the tree. */
+	void clear();
+
+	/** Return the number of objects in the tree. */
+	size_t size() const;
+
+	/** Return the height of the tree. An empty tree has a height of 0. */
+	uint32 getHeight() const;
+
+	/** Add an object to the tree.
+	 *
+	 *  @param  min  The minimum corner of the object's bounding box.
+	 *  @param  max  The maximum corner of the object's bounding box.
+	 *  @param  data The object's user data.
+	 *  @return The proxy ID identifying the object within the tree.
+	 */
+	uint32 insert(const glm::vec3 &min, const glm::vec3 &max, void *data);
+
+	/** Remove an object from the tree. */
+	void remove(uint32 proxy);
+
+	/** Change the bounding box of an object in the tree.
+	 *
+	 *  @return true if the object had to be moved within the tree.
+	 */
+	bool update(uint32 proxy, const glm::vec3 &min, const glm::vec3 &max);
+
+	/** Return the user data of an object in the tree. */
+	void *getData(uint32 proxy) const;
+
+	/** Find all objects whose bounding box intersects the line.
+	 *
+	 *  @param from The start of the line.
+	 *  @param to   The end of the line.
+	 *  @param hits The objects found, sorted from the nearest to the start to the furthest.
+	 */
+	void findLine(const glm::vec3 &from, const glm::vec3 &to, std::vector<Hit> &hits) const;
+
+private:
+	struct Node {
+		glm::vec3 min; ///< The fat box of a leaf, or the union of the children's boxes.
+		glm::vec3 max;
+
+		glm::vec3 objectMin; ///< A leaf's exact bounding box.
+		glm::vec3 objectMax;
+
+		void *data;
+
+		/** The parent of a node in the tree, or the next free node. */
+		uint32 parent;
+
+		uint32 child1;
+		uint32 child2;
+
+		/** The height of the node's subtree. 0 for leaves, -1 for free nodes. */
+		int32 height;
+
+		bool isLeaf() const;
+	};
+
+	float _margin;
+
+	std::vector<Node> _nodes;
+
+	uint32 _root;
+	uint32 _freeList;
+	size_t _leafCount;
+
+	uint32 allocateNode();
+	void freeNode(uint32 node);
+
+	void insertLeaf(uint32 leaf);
+	void removeLeaf(uint32 leaf);
+
+	/** Fix the boxes and heights on the way from a node up to the root, rebalancing the tree. */
+	void refit(uint32 node);
+
+	/** If the node's subtree is unbalanced, rotate it. Returns the new root of the subtree. */
+	uint32 balance(uint32 node);
+
+	void setFatBox(Node &node, const glm::vec3 &min, const glm::vec3 &max);
+	void setUnion(Node &node, const Node &child1, const Node &child2);
+
+	static float getArea(const glm::vec3 &min, const glm::vec3 &max);
+	static float getUnionArea(const Node &node1, const Node &node2);
+
+	static bool intersectLine(const glm::vec3 &from, const glm::vec3 &delta,
+	                          const glm::vec3 &min, const glm::vec3 &max, float &distance);
+};
+
+} // End of namespace Common
+
+#endif // COMMON_AABBTREE_H
@@ -30,9 +30,12 @@
 #include <boost/noncopyable.hpp>
 
 #include "src/common/types.h"
+#include "src/common/endianness.h"
+#include "src/common/scopedptr.h"
 #include "src/common/disposableptr.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 
 namespace Common {
 
@@ -66,6 +69,16 @@ public:
 	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
 	virtual void addBit(uint32 &x, size_t n) = 0;
 
+	/** Read a multi-bit value from the bit stream, without advancing it.
+	 *
+	 *  The bits are ordered the same way as for getBits(). Bits past the
+	 *  end of the stream read as 0.
+	 */
+	virtual uint32 peekBits(size_t n) = 0;
+
+	/** Are the bits read MSB first? If so, the first bit read is the highest in a value. */
+	virtual bool isMSBFirst() const = 0;
+
 protected:
 	BitStream() {
 	}
@@ -209,6 +222,50 @@ public:
 			x = (x & ~(1 << n)) | (getBit() << n);
 	}
 
+	/** Read a multi-bit value from the bit stream, without advancing it. */
+	uint32 peekBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		// Are all the bits we want in the current value already?
+		if ((_inValue != 0) && (n <= (size_t) (valueBits - _inValue))) {
+			if (isMSB2LSB)
+				return (uint32) (_value >> (64 - n));
+
+			return (uint32) (_value & (0xFFFFFFFFFFFFFFFFULL >> (64 - n)));
+		}
+
+		// Otherwise, read as much as is available and then go back
+
+		const size_t streamPos = _stream->pos();
+		const uint64 value     = _value;
+		const uint8  inValue   = _inValue;
+
+		const size_t curPos    = pos();
+		const size_t available = (curPos < size()) ? ((n < (size() - curPos)) ? n : (size() - curPos)) : 0;
+
+		uint32 v = getBits(available);
+
+		_stream->seek(streamPos);
+
+		_value   = value;
+		_inValue = inValue;
+
+		// Pad with zeros
+		if (isMSB2LSB && (available > 0))
+			v <<= n - available;
+
+		return v;
+	}
+
+	/** Are the bits read MSB first? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
 	/** Rewind the bit stream back to the start. */
 	void rewind() {
 		_stream->seek(0);
@@ -219,8 +276,24 @@ public:
 
 	/** Skip the specified amount of bits. */
 	void skip(size_t n) {
-		while (n-- > 0)
-			getBit();
+		while (n > 0) {
+			// Check if we need the next value
+			if (_inValue == 0)
+				readValue();
+
+			// Skip as many bits as we can within the current value
+			const size_t count = (n < (size_t) (valueBits - _inValue)) ? n : (size_t) (valueBits - _inValue);
+
+			if (count >= 64)
+				_value = 0;
+			else if (isMSB2LSB)
+				_value <<= count;
+			else
+				_value >>= count;
+
+			_inValue = (_inValue + count) % valueBits;
+			n -= count;
+		}
 	}
 
 	/** Return the stream position in bits. */
@@ -276,6 +349,271 @@ typedef BitStreamImpl<64, false, true > BitStream64BEMSB;
 /** 64-bit big-endian data, LSB to MSB. */
 typedef BitStreamImpl<64, false, false> BitStream64BELSB;
 
+/** A bit stream reading directly out of a contiguous block of memory.
+ *
+ *  This bit stream has the same memory layouts as BitStreamImpl. Instead
+ *  of reading one value at a time through a read stream, though, it keeps
+ *  up to 64 not yet read bits in a cache word, refilled straight from
+ *  memory when needed. This way, reading, peeking at and skipping bits
+ *  works on several bits at once.
+ *
+ *  The class is final. Calls on a MemoryBitStreamImpl itself, instead of
+ *  through the BitStream interface, don't need to be dispatched virtually.
+ *  Decoders should use it directly, together with templated helpers like
+ *  Huffman::getSymbol().
+ */
+template<int valueBits, bool isLE, bool isMSB2LSB>
+class MemoryBitStreamImpl final : boost::noncopyable, public BitStream {
+private:
+	/** The number of bits loaded into the cache at once. 64-bit values are loaded in two halves. */
+	static const size_t kUnitBits  = (valueBits == 64) ? 32 : valueBits;
+	static const size_t kUnitBytes = kUnitBits / 8;
+
+	ScopedArray<byte> _ownData; ///< Our own copy of the data, if we needed one.
+
+	const byte *_data; ///< The data.
+	size_t      _size; ///< The size of the data in bytes, rounded down to whole values.
+
+	size_t _dataPos; ///< The position of the next unit to load into the cache, in bytes.
+
+	uint64 _cache;     ///< The bits not yet read, starting at the MSB (MSB2LSB) or LSB (LSB2MSB).
+	size_t _cacheBits; ///< The number of bits in the cache.
+
+	void init(const byte *data, size_t size) {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32) && (valueBits != 64))
+			throw Exception("BitStream: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+
+		_data = data;
+		_size = size & ~((size_t) ((valueBits >> 3) - 1));
+
+		rewind();
+	}
+
+	/** Read the next unit from memory. */
+	inline uint32 readUnit() {
+		const byte *data = _data + _dataPos;
+
+		if (valueBits == 64) {
+			/* Whether the upper or the lower half of a 64-bit value is read first
+			 * depends on the bit order. Where it's stored depends on the endianness. */
+
+			const size_t half = (_dataPos & 4) ? 1 : 0;
+			data = _data + (_dataPos & ~((size_t) 7)) + (((isLE == isMSB2LSB) ? (1 - half) : half) * 4);
+		}
+
+		_dataPos += kUnitBytes;
+
+		if (kUnitBits == 8)
+			return *data;
+		if (kUnitBits == 16)
+			return isLE ? READ_LE_UINT16(data) : READ_BE_UINT16(data);
+
+		return isLE ? READ_LE_UINT32(data) : READ_BE_UINT32(data);
+	}
+
+	/** Fill up the cache as far as possible. */
+	inline void refill() {
+		while ((_cacheBits <= (64 - kUnitBits)) && (_dataPos < _size)) {
+			const uint64 unit = readUnit();
+
+			if (isMSB2LSB)
+				_cache |= unit << (64 - kUnitBits - _cacheBits);
+			else
+				_cache |= unit << _cacheBits;
+
+			_cacheBits += kUnitBits;
+		}
+	}
+
+	/** Return the first n (1 to 32) bits in the cache. */
+	inline uint32 cachedBits(size_t n) const {
+		if (isMSB2LSB)
+			return (uint32) (_cache >> (64 - n));
+
+		return (uint32) (_cache & (0xFFFFFFFFFFFFFFFFULL >> (64 - n)));
+	}
+
+	/** Remove n bits from the cache. */
+	inline void consume(size_t n) {
+		if (n >= 64)
+			_cache = 0;
+		else if (isMSB2LSB)
+			_cache <<= n;
+		else
+			_cache >>= n;
+
+		_cacheBits -= n;
+	}
+
+public:
+	/** Create a bit stream over this data. The data is not copied and needs to outlive the bit stream. */
+	MemoryBitStreamImpl(const byte *data, size_t size) {
+		init(data, size);
+	}
+
+	/** Create a bit stream over the rest of this stream, starting at its current position.
+	 *
+	 *  If this is a MemoryReadStream, its data is used directly. Otherwise, it's
+	 *  read into memory first.
+	 */
+	MemoryBitStreamImpl(SeekableReadStream &stream) {
+		const size_t size = stream.size() - stream.pos();
+
+		const MemoryReadStream *memory = dynamic_cast<const MemoryReadStream *>(&stream);
+		if (memory) {
+			init(memory->getData() + stream.pos(), size);
+			return;
+		}
+
+		_ownData.reset(new byte[size]);
+		if (stream.read(_ownData.get(), size) != size)
+			throw Exception(kReadError);
+
+		init(_ownData.get(), size);
+	}
+
+	~MemoryBitStreamImpl() {
+	}
+
+	/** Read a bit from the bit stream. */
+	uint32 getBit() {
+		return getBits(1);
+	}
+
+	/** Read a multi-bit value from the bit stream. */
+	uint32 getBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (_cacheBits < n) {
+			refill();
+
+			if (_cacheBits < n)
+				throw Exception("BitStream::getBits(): End of bit stream reached");
+		}
+
+		const uint32 v = cachedBits(n);
+		consume(n);
+
+		return v;
+	}
+
+	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
+	void addBit(uint32 &x, size_t n) {
+		if (n >= 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (isMSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	/** Read a multi-bit value from the bit stream, without advancing it. */
+	uint32 peekBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (_cacheBits < n)
+			refill();
+
+		// Past the end of the data, the cache is filled with zeros
+		return cachedBits(n);
+	}
+
+	/** Skip the specified amount of bits. */
+	void skip(size_t n) {
+		if (n <= _cacheBits) {
+			consume(n);
+			return;
+		}
+
+		if (n > (size() - pos()))
+			throw Exception("BitStream::skip(): End of bit stream reached");
+
+		n -= _cacheBits;
+		consume(_cacheBits);
+
+		// Jump over all whole units, then take the rest out of the cache again
+
+		const size_t units = n / kUnitBits;
+
+		_dataPos += units * kUnitBytes;
+		n        -= units * kUnitBits;
+
+		if (n > 0) {
+			refill();
+			consume(n);
+		}
+	}
+
+	/** Are the bits read MSB first? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
+	/** Rewind the bit stream back to the start. */
+	void rewind() {
+		_dataPos   = 0;
+		_cache     = 0;
+		_cacheBits = 0;
+	}
+
+	/** Return the stream position in bits. */
+	size_t pos() const {
+		return _dataPos * 8 - _cacheBits;
+	}
+
+	/** Return the stream size in bits. */
+	size_t size() const {
+		return _size * 8;
+	}
+
+	bool eos() const {
+		return pos() >= size();
+	}
+};
+
+// typedefs for various memory layouts.
+
+/** 8-bit data in memory, MSB to LSB. */
+typedef MemoryBitStreamImpl<8, false, true > MemoryBitStream8MSB;
+/** 8-bit data in memory, LSB to MSB. */
+typedef MemoryBitStreamImpl<8, false, false> MemoryBitStream8LSB;
+
+/** 16-bit little-endian data in memory, MSB to LSB. */
+typedef MemoryBitStreamImpl<16, true , true > MemoryBitStream16LEMSB;
+/** 16-bit little-endian data in memory, LSB to MSB. */
+typedef MemoryBitStreamImpl<16, true , false> MemoryBitStream16LELSB;
+/** 16-bit big-endian data in memory, MSB to LSB. */
+typedef MemoryBitStreamImpl<16, false, true > MemoryBitStream16BEMSB;
+/** 16-bit big-endian data in memory, LSB to MSB. */
+typedef MemoryBitStreamImpl<16, false, false> MemoryBitStream16BELSB;
+
+/** 32-bit little-endian data in memory, MSB to LSB. */
+typedef MemoryBitStreamImpl<32, true , true > MemoryBitStream32LEMSB;
+/** 32-bit little-endian data in memory, LSB to MSB. */
+typedef MemoryBitStreamImpl<32, true , false> MemoryBitStream32LELSB;
+/** 32-bit big-endian data in memory, MSB to LSB. */
+typedef MemoryBitStreamImpl<32, false, true > MemoryBitStream32BEMSB;
+/** 32-bit big-endian data in memory, LSB to MSB. */
+typedef MemoryBitStreamImpl<32, false, false> MemoryBitStream32BELSB;
+
+/** 64-bit little-endian data in memory, MSB to LSB. */
+typedef MemoryBitStreamImpl<64, true , true > MemoryBitStream64LEMSB;
+/** 64-bit little-endian data in memory, LSB to MSB. */
+typedef MemoryBitStreamImpl<64, true , false> MemoryBitStream64LELSB;
+/** 64-bit big-endian data in memory, MSB to LSB. */
+typedef MemoryBitStreamImpl<64, false, true > MemoryBitStream64BEMSB;
+/** 64-bit big-endian data in memory, LSB to MSB. */
+typedef MemoryBitStreamImpl<64, false, false> MemoryBitStream64BELSB;
+
 } // End of namespace Common
 
 #endif // COMMON_BITSTREAM_H
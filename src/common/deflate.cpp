@@ -130,23 +130,20 @@ byte *decompressDeflateWithoutOutputSize(const byte *data, size_t inputSize, siz
 SeekableReadStream *decompressDeflate(ReadStream &input, size_t inputSize,
                                       size_t outputSize, int windowBits) {
 
-	ScopedArray<byte> compressedData(new byte[inputSize]);
-	if (input.read(compressedData.get(), inputSize) != inputSize)
-		throw Exception(kReadError);
+	// Memory-backed streams might hand out their compressed data without copying it
+	ScopedPtr<MemoryReadStream> compressedData(input.readStream(inputSize));
 
-	const byte *decompressedData = decompressDeflate(compressedData.get(), inputSize, outputSize, windowBits);
+	const byte *decompressedData = decompressDeflate(compressedData->getData(), inputSize, outputSize, windowBits);
 
 	return new MemoryReadStream(decompressedData, outputSize, true);
 }
 
 SeekableReadStream *decompressDeflateWithoutOutputSize(ReadStream &input, size_t inputSize,
                                                        int windowBits, unsigned int frameSize) {
-	ScopedArray<byte> compressedData(new byte[inputSize]);
-	if (input.read(compressedData.get(), inputSize) != inputSize)
-		throw Exception(kReadError);
+	ScopedPtr<MemoryReadStream> compressedData(input.readStream(inputSize));
 
 	size_t size = 0;
-	byte *decompressedData = decompressDeflateWithoutOutputSize(compressedData.get(), inputSize, size, windowBits, frameSize);
+	byte *decompressedData = decompressDeflateWithoutOutputSize(compressedData->getData(), inputSize, size, windowBits, frameSize);
 
 	return new MemoryReadStream(decompressedData, size, true);
 }
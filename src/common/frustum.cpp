@@ -0,0 +1,83 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A view frustum, for culling objects that can't be seen.
+ */
+
+#include "glm/geometric.hpp"
+
+#include "src/common/frustum.h"
+
+namespace Common {
+
+Frustum::Frustum() {
+	for (int i = 0; i < 6; i++)
+		_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+void Frustum::set(const glm::mat4 &projectionModelview) {
+	const glm::mat4 &m = projectionModelview;
+
+	// The rows of the matrix
+	const glm::vec4 x(m[0][0], m[1][0], m[2][0], m[3][0]);
+	const glm::vec4 y(m[0][1], m[1][1], m[2][1], m[3][1]);
+	const glm::vec4 z(m[0][2], m[1][2], m[2][2], m[3][2]);
+	const glm::vec4 w(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+	_planes[0] = w + x; // Left
+	_planes[1] = w - x; // Right
+	_planes[2] = w + y; // Bottom
+	_planes[3] = w - y; // Top
+	_planes[4] = w + z; // Near
+	_planes[5] = w - z; // Far
+
+	for (int i = 0; i < 6; i++) {
+		const float length = glm::length(glm::vec3(_planes[i]));
+		if (length > 0.0f)
+			_planes[i] /= length;
+	}
+}
+
+bool Frustum::isVisible(const glm::vec3 &point) const {
+	for (int i = 0; i < 6; i++)
+		if (glm::dot(glm::vec3(_planes[i]), point) + _planes[i].w < 0.0f)
+			return false;
+
+	return true;
+}
+
+bool Frustum::isVisible(const glm::vec3 &min, const glm::vec3 &max) const {
+	for (int i = 0; i < 6; i++) {
+		const glm::vec4 &plane = _planes[i];
+
+		// The corner of the box furthest along the plane's normal
+		const glm::vec3 corner((plane.x >= 0.0f) ? max.x : min.x,
+		                       (plane.y >= 0.0f) ? max.y : min.y,
+		                       (plane.z >= 0.0f) ? max.z : min.z);
+
+		if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+} // End of namespace Common
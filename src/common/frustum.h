@@ -0,0 +1,64 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A view frustum, for culling objects that can't be seen.
+ */
+
+#ifndef COMMON_FRUSTUM_H
+#define COMMON_FRUSTUM_H
+
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/mat4x4.hpp"
+
+namespace Common {
+
+/** The volume of space visible through a camera.
+ *
+ *  The frustum is described by its six planes, extracted out of the
+ *  combined projection and modelview matrix (after Gribb and Hartmann).
+ */
+class Frustum {
+public:
+	/** Create a frustum that contains everything. */
+	Frustum();
+
+	/** Set the frustum seen through this combined projection and modelview matrix. */
+	void set(const glm::mat4 &projectionModelview);
+
+	/** Is any part of this point visible? */
+	bool isVisible(const glm::vec3 &point) const;
+
+	/** Is any part of this axis-aligned box visible?
+	 *
+	 *  This test is conservative: a box that's close to a corner of the
+	 *  frustum might be reported as visible, even though it's not.
+	 */
+	bool isVisible(const glm::vec3 &min, const glm::vec3 &max) const;
+
+private:
+	/** The planes, with the normals pointing into the frustum. */
+	glm::vec4 _planes[6];
+};
+
+} // End of namespace Common
+
+#endif // COMMON_FRUSTUM_H
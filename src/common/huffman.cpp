@@ -24,6 +24,8 @@
 
 #include <cassert>
 
+#include <algorithm>
+
 #include "src/common/huffman.h"
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -31,7 +33,10 @@
 
 namespace Common {
 
-Huffman::Symbol::Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+Huffman::Symbol::Symbol(uint32 c, uint8 l, uint32 s) : code(c), length(l), symbol(s) {
+}
+
+Huffman::LookupEntry::LookupEntry() : value(0), length(0), subBits(0) {
 }
 
 
@@ -59,19 +64,18 @@ void Huffman::init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 
 	assert(maxLength <= 32);
 
-	_codes.resize(maxLength);
-	_symbols.resize(codeCount);
+	_symbols.reserve(codeCount);
 
 	for (size_t i = 0; i < codeCount; i++) {
+		assert((lengths[i] > 0) && (lengths[i] <= maxLength));
+
 		// The symbol. If none were specified, just assume it's identical to the code index
 		uint32 symbol = symbols ? symbols[i] : i;
 
-		// Put the code and symbol into the correct list
-		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol));
-
-		// And put the pointer to the symbol/code struct into the symbol list.
-		_symbols[i] = &_codes[lengths[i] - 1].back();
+		_symbols.push_back(Symbol(codes[i], lengths[i], symbol));
 	}
+
+	buildTables();
 }
 
 Huffman::~Huffman() {
@@ -79,21 +83,96 @@ Huffman::~Huffman() {
 
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (size_t i = 0; i < _symbols.size(); i++)
-		_symbols[i]->symbol = symbols ? *symbols++ : i;
+		_symbols[i].symbol = symbols ? *symbols++ : i;
+
+	buildTables();
 }
 
-uint32 Huffman::getSymbol(BitStream &bits) const {
-	uint32 code = 0;
+bool Huffman::compareLength(const Symbol &a, const Symbol &b) {
+	return a.length < b.length;
+}
+
+void Huffman::buildTables() {
+	/* If codes are ambiguous, the shortest one wins. If several codes are
+	 * identical, the one that was given first wins. */
+	SymbolList codes = _symbols;
+	std::stable_sort(codes.begin(), codes.end(), compareLength);
+
+	for (size_t i = 0; i < 2; i++) {
+		_tables[i].clear();
+
+		buildTable(_tables[i], codes, i == 0, _rootBits);
+	}
+}
+
+size_t Huffman::buildTable(LookupTable &table, const SymbolList &codes, bool msbFirst, uint8 &bits) {
+	uint8 maxLength = 0;
+	for (SymbolList::const_iterator c = codes.begin(); c != codes.end(); ++c)
+		maxLength = MAX(maxLength, c->length);
+
+	bits = MIN(maxLength, kLookupBits);
+
+	const size_t offset = table.size();
+	table.resize(offset + (1 << bits));
 
-	for (size_t i = 0; i < _codes.size(); i++) {
-		bits.addBit(code, i);
+	// The codes too long for this table, sorted by the entry that will lead to their sub-table
+	std::vector<SymbolList> subCodes(1 << bits);
 
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
+	for (SymbolList::const_iterator c = codes.begin(); c != codes.end(); ++c) {
+		const uint32 code = c->code & (0xFFFFFFFF >> (32 - c->length));
+
+		if (c->length <= bits) {
+			/* Fill in all entries starting with this code. Depending on the bit
+			 * order, the remaining bits are either the lower or the upper ones. */
+
+			const size_t fillBits = bits - c->length;
+			for (size_t i = 0; i < (1U << fillBits); i++) {
+				const size_t index = msbFirst ? ((code << fillBits) | i) : (code | (i << c->length));
+
+				LookupEntry &entry = table[offset + index];
+				if (entry.length != 0)
+					continue;
+
+				entry.value  = c->symbol;
+				entry.length = c->length;
+			}
+
+			continue;
+		}
+
+		// Split the code into the part for this table and the rest for a sub-table
+
+		const uint8  subLength = c->length - bits;
+		const size_t index     = msbFirst ? (code >> subLength) : (code & ((1 << bits) - 1));
+		const uint32 subCode   = msbFirst ? (code & (0xFFFFFFFF >> (32 - subLength))) : (code >> bits);
+
+		// Already hidden by a shorter code?
+		if (table[offset + index].length != 0)
+			continue;
+
+		subCodes[index].push_back(Symbol(subCode, subLength, c->symbol));
 	}
 
-	throw Exception("Unknown Huffman code");
+	for (size_t i = 0; i < subCodes.size(); i++) {
+		if (subCodes[i].empty())
+			continue;
+
+		uint8 subBits;
+		const size_t subOffset = buildTable(table, subCodes[i], msbFirst, subBits);
+
+		// The table might have been moved, so we can only now grab the entry
+		LookupEntry &entry = table[offset + i];
+
+		entry.value   = subOffset;
+		entry.length  = bits;
+		entry.subBits = subBits;
+	}
+
+	return offset;
+}
+
+uint32 Huffman::getSymbol(BitStream &bits) const {
+	return getSymbol<BitStream>(bits);
 }
 
 } // End of namespace Common
@@ -26,9 +26,9 @@
 #define COMMON_HUFFMAN_H
 
 #include <vector>
-#include <list>
 
 #include "src/common/types.h"
+#include "src/common/error.h"
 
 namespace Common {
 
@@ -43,7 +43,13 @@ struct HuffmanTable {
 	const uint32 *symbols; ///< The symbols, 0 if identical to the codes.
 };
 
-/** Decode a Huffman'd bitstream. */
+/** Decode a Huffman'd bitstream.
+ *
+ *  The codes are resolved with multi-level lookup tables, built when
+ *  the decoder is constructed: the next few bits of the stream are
+ *  peeked at and looked up, which directly finds all short codes. Only
+ *  longer codes need to look up the following bits in a sub-table.
+ */
 class Huffman {
 public:
 	/** Construct a Huffman decoder.
@@ -65,26 +71,79 @@ public:
 	/** Return the next symbol in the bitstream. */
 	uint32 getSymbol(BitStream &bits) const;
 
+	/** Return the next symbol in the bitstream.
+	 *
+	 *  Calls the bit stream's methods directly. For concrete bit stream
+	 *  classes, like MemoryBitStreamImpl, this avoids the virtual calls.
+	 */
+	template<class BitStreamType>
+	uint32 getSymbol(BitStreamType &bits) const {
+		const LookupTable &table = _tables[bits.isMSBFirst() ? 0 : 1];
+
+		size_t offset    = 0;
+		size_t indexBits = _rootBits;
+
+		while (true) {
+			const LookupEntry &entry = table[offset + bits.peekBits(indexBits)];
+			if (entry.length == 0)
+				break;
+
+			bits.skip(entry.length);
+
+			if (entry.subBits == 0)
+				return entry.value;
+
+			offset    = entry.value;
+			indexBits = entry.subBits;
+		}
+
+		throw Exception("Unknown Huffman code");
+	}
+
 private:
+	/** The number of bits looked up at once. */
+	static const uint8 kLookupBits = 9;
+
 	struct Symbol {
 		uint32 code;
+		uint8  length;
 		uint32 symbol;
 
-		Symbol(uint32 c, uint32 s);
+		Symbol(uint32 c, uint8 l, uint32 s);
 	};
 
-	typedef std::list<Symbol>     CodeList;
-	typedef std::vector<CodeList> CodeLists;
-	typedef std::vector<Symbol *> SymbolList;
+	/** An entry in a lookup table. */
+	struct LookupEntry {
+		/** The symbol, or the offset of the sub-table if subBits is not 0. */
+		uint32 value;
+		/** The number of bits to consume. 0 if there's no code for these bits. */
+		uint8 length;
+		/** The number of bits the sub-table is indexed with. 0 if this is a symbol. */
+		uint8 subBits;
+
+		LookupEntry();
+	};
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	typedef std::vector<Symbol>      SymbolList;
+	typedef std::vector<LookupEntry> LookupTable;
 
-	/** Sorted list of pointers to the symbols. */
+	/** All codes and their symbols, in the order they were given. */
 	SymbolList _symbols;
 
+	/** The lookup tables for bit streams reading MSB first and LSB first. */
+	LookupTable _tables[2];
+	/** The number of bits the first level of the lookup tables is indexed with. */
+	uint8 _rootBits;
+
 	void init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 	          const uint8 *lengths, const uint32 *symbols);
+
+	void buildTables();
+
+	static bool compareLength(const Symbol &a, const Symbol &b);
+
+	/** Build a (sub-)table for these codes, returning its offset and index bits. */
+	static size_t buildTable(LookupTable &table, const SymbolList &codes, bool msbFirst, uint8 &bits);
 };
 
 } // End of namespace Common
@@ -0,0 +1,96 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Implementing the stream reading interfaces for memory-mapped files.
+ */
+
+#include "src/common/mappedfile.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+#include "src/common/ustring.h"
+
+namespace Common {
+
+MappedFile::MappedFile(const UString &fileName) : _data(0), _size(0) {
+	_data = Platform::mapFile(fileName, _size);
+	if (!_data)
+		throw Exception("Can't map file \"%s\"", fileName.c_str());
+}
+
+MappedFile::~MappedFile() {
+	Platform::unmapFile(_data, _size);
+}
+
+const byte *MappedFile::getData() const {
+	return _data;
+}
+
+size_t MappedFile::size() const {
+	return _size;
+}
+
+bool MappedFile::isSupported() {
+#if defined(WIN32) || defined(UNIX)
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+MappedReadStream::MappedReadStream(const UString &fileName) :
+	MappedReadStream(MappedFilePtr(new MappedFile(fileName)), 0, SIZE_MAX) {
+
+}
+
+MappedReadStream::MappedReadStream(const MappedFilePtr &file, size_t begin, size_t end) :
+	MemoryReadStream(file->getData() + begin, MIN(end, file->size()) - begin), _file(file), _offset(begin) {
+
+}
+
+MappedReadStream::~MappedReadStream() {
+}
+
+MemoryReadStream *MappedReadStream::readStream(size_t dataSize) {
+	const size_t begin = pos();
+	if (dataSize > (size() - begin)) {
+		// Run into the end of the stream, just like a failed normal read would
+		byte dummy;
+		seek(0, kOriginEnd);
+		read(&dummy, 1);
+
+		throw Exception(kReadError);
+	}
+
+	seek(dataSize, kOriginCurrent);
+
+	return new MappedReadStream(_file, _offset + begin, _offset + begin + dataSize);
+}
+
+MappedReadStream *MappedReadStream::subStream(size_t begin, size_t end) const {
+	if ((begin > end) || (end > size()))
+		throw Exception("Sub-stream (%u, %u) out of range (%u)", (uint) begin, (uint) end, (uint) size());
+
+	return new MappedReadStream(_file, _offset + begin, _offset + end);
+}
+
+} // End of namespace Common
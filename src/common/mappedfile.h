@@ -0,0 +1,90 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Implementing the stream reading interfaces for memory-mapped files.
+ */
+
+#ifndef COMMON_MAPPEDFILE_H
+#define COMMON_MAPPEDFILE_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "src/common/types.h"
+#include "src/common/memreadstream.h"
+
+namespace Common {
+
+class UString;
+
+/** A whole file, mapped read-only into memory. */
+class MappedFile : boost::noncopyable {
+public:
+	/** Map this file into memory. Throws if mapping the file failed. */
+	MappedFile(const UString &fileName);
+	~MappedFile();
+
+	/** Return the mapped file contents. */
+	const byte *getData() const;
+	/** Return the size of the file. */
+	size_t size() const;
+
+	/** Can files be mapped into memory on this platform at all? */
+	static bool isSupported();
+
+private:
+	const byte *_data;
+	size_t _size;
+};
+
+/** A stream reading out of a memory-mapped file.
+ *
+ *  All streams created by readStream() reference the same mapping
+ *  instead of copying the data out of it. The mapping is shared
+ *  between all of these streams, and stays valid until the last of
+ *  them is destroyed. Since each stream has its own position, several
+ *  threads can each read from their own streams into the same file
+ *  at the same time.
+ */
+class MappedReadStream : public MemoryReadStream {
+public:
+	/** Map this file and read from it. Throws if mapping the file failed. */
+	MappedReadStream(const UString &fileName);
+	~MappedReadStream();
+
+	/** Return a stream referencing the next dataSize bytes of the mapping. */
+	MemoryReadStream *readStream(size_t dataSize);
+
+	/** Return a stream referencing a part of the mapping, without changing the position. */
+	MappedReadStream *subStream(size_t begin, size_t end) const;
+
+private:
+	typedef boost::shared_ptr<const MappedFile> MappedFilePtr;
+
+	MappedFilePtr _file;
+	size_t _offset; ///< The offset of this stream's data within the mapped file.
+
+	MappedReadStream(const MappedFilePtr &file, size_t begin, size_t end);
+};
+
+} // End of namespace Common
+
+#endif // COMMON_MAPPEDFILE_H
@@ -34,6 +34,9 @@
 #if defined(UNIX)
 	#include <pwd.h>
 	#include <unistd.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
 #endif
 
 #include <cassert>
@@ -118,6 +121,95 @@ std::FILE *Platform::openFile(const UString &fileName, FileMode mode) {
 }
 // '--- openFile() ---'
 
+// .--- mapFile() ---.
+#if defined(WIN32)
+
+const byte *Platform::mapFile(const UString &fileName, size_t &size) {
+	size = 0;
+
+	HANDLE file = CreateFileW(boost::filesystem::path(fileName.c_str()).c_str(), GENERIC_READ, FILE_SHARE_READ,
+	                          0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE)
+		return 0;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart <= 0) ||
+	    ((uint64) fileSize.QuadPart > (uint64) SIZE_MAX)) {
+
+		CloseHandle(file);
+		return 0;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, 0, PAGE_READONLY, 0, 0, 0);
+	CloseHandle(file);
+
+	if (!mapping)
+		return 0;
+
+	// The view stays valid after the mapping handle is closed
+	const byte *data = static_cast<const byte *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	CloseHandle(mapping);
+
+	if (!data)
+		return 0;
+
+	size = fileSize.QuadPart;
+	return data;
+}
+
+void Platform::unmapFile(const byte *data, size_t UNUSED(size)) {
+	if (data)
+		UnmapViewOfFile(data);
+}
+
+#elif defined(UNIX)
+
+const byte *Platform::mapFile(const UString &fileName, size_t &size) {
+	size = 0;
+
+	int fd = open(boost::filesystem::path(fileName.c_str()).c_str(), O_RDONLY);
+	if (fd == -1)
+		return 0;
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) != 0) || (fileStat.st_size <= 0) ||
+	    ((uint64) fileStat.st_size > (uint64) SIZE_MAX)) {
+
+		close(fd);
+		return 0;
+	}
+
+	// The mapping stays valid after the file descriptor is closed
+	void *data = mmap(0, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return 0;
+
+	size = fileStat.st_size;
+	return static_cast<const byte *>(data);
+}
+
+void Platform::unmapFile(const byte *data, size_t size) {
+	if (data)
+		munmap(const_cast<byte *>(data), size);
+}
+
+#else
+
+/* Fallback: No memory mapping. */
+const byte *Platform::mapFile(const UString &UNUSED(fileName), size_t &size) {
+	size = 0;
+
+	return 0;
+}
+
+void Platform::unmapFile(const byte *UNUSED(data), size_t UNUSED(size)) {
+}
+
+#endif
+// '--- mapFile() ---'
+
 // .--- Windows utility functions ---.
 #if defined(WIN32)
 
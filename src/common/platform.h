@@ -29,6 +29,7 @@
 
 #include <vector>
 
+#include "src/common/types.h"
 #include "src/common/ustring.h"
 
 namespace Common {
@@ -51,6 +52,17 @@ public:
 	/** Open a file with an UTF-8 encoded name. */
 	static std::FILE *openFile(const UString &fileName, FileMode mode);
 
+	/** Map a whole file with an UTF-8 encoded name into memory, read-only.
+	 *
+	 *  @param  fileName The name of the file to map.
+	 *  @param  size The size of the file will be stored here.
+	 *  @return The mapped memory, or 0 if the file could not be mapped.
+	 */
+	static const byte *mapFile(const UString &fileName, size_t &size);
+
+	/** Unmap a file previously mapped with mapFile(). */
+	static void unmapFile(const byte *data, size_t size);
+
 	/** Return the OS-specific path of the user's home directory. */
 	static UString getHomeDirectory();
 	/** Return the OS-specific path of the config directory. */
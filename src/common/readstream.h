@@ -255,9 +255,13 @@ public:
 	/** Read the specified amount of data into a new[]'ed buffer
 	 *  which then is wrapped into a MemoryReadStream.
 	 *
+	 *  Streams that already hold all their data in memory that stays
+	 *  valid can override this to return a stream referencing the data
+	 *  directly, without copying it.
+	 *
 	 *  When reading fails, a kReadError exception is thrown.
 	 */
-	MemoryReadStream *readStream(size_t dataSize);
+	virtual MemoryReadStream *readStream(size_t dataSize);
 };
 
 
@@ -0,0 +1,125 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A lock-free ring buffer for one writing and one reading thread.
+ */
+
+#ifndef COMMON_RINGBUFFER_H
+#define COMMON_RINGBUFFER_H
+
+#include <algorithm>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/atomic.h"
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+
+namespace Common {
+
+/** A lock-free ring buffer.
+ *
+ *  One thread may write into the buffer while another thread reads out
+ *  of it at the same time, without any locking. More than one writing
+ *  or reading thread need to be synchronized by the caller.
+ */
+template<typename T>
+class RingBuffer : boost::noncopyable {
+public:
+	RingBuffer(size_t capacity) : _data(new T[capacity]), _capacity(capacity), _readPos(0), _writePos(0) {
+	}
+
+	/** Return the number of elements the buffer can hold. */
+	size_t getCapacity() const {
+		return _capacity;
+	}
+
+	/** Return the number of elements that can be read out of the buffer. */
+	size_t getReadable() const {
+		return _writePos.load(boost::memory_order_acquire) - _readPos.load(boost::memory_order_acquire);
+	}
+
+	/** Return the number of elements that can be written into the buffer. */
+	size_t getWritable() const {
+		return _capacity - getReadable();
+	}
+
+	/** Is the buffer empty? */
+	bool empty() const {
+		return getReadable() == 0;
+	}
+
+	/** Write up to n elements into the buffer, returning the number of elements written. */
+	size_t write(const T *data, size_t n) {
+		const size_t writePos = _writePos.load(boost::memory_order_relaxed);
+		const size_t readPos  = _readPos.load(boost::memory_order_acquire);
+
+		n = MIN(n, _capacity - (writePos - readPos));
+
+		// Copy up to the end of the buffer, then wrap around to the start
+		const size_t start = writePos % _capacity;
+		const size_t first = MIN(n, _capacity - start);
+
+		std::copy(data, data + first, _data.get() + start);
+		std::copy(data + first, data + n, _data.get());
+
+		_writePos.store(writePos + n, boost::memory_order_release);
+		return n;
+	}
+
+	/** Read up to n elements out of the buffer, returning the number of elements read. */
+	size_t read(T *data, size_t n) {
+		const size_t readPos  = _readPos.load(boost::memory_order_relaxed);
+		const size_t writePos = _writePos.load(boost::memory_order_acquire);
+
+		n = MIN(n, writePos - readPos);
+
+		const size_t start = readPos % _capacity;
+		const size_t first = MIN(n, _capacity - start);
+
+		std::copy(_data.get() + start, _data.get() + start + first, data);
+		std::copy(_data.get(), _data.get() + (n - first), data + first);
+
+		_readPos.store(readPos + n, boost::memory_order_release);
+		return n;
+	}
+
+	/** Throw away all elements in the buffer. Must not be called while another thread writes. */
+	void clear() {
+		_readPos.store(_writePos.load(boost::memory_order_acquire), boost::memory_order_release);
+	}
+
+private:
+	ScopedArray<T> _data;
+	size_t _capacity;
+
+	/* Both positions only ever increase, and are wrapped around the
+	 * capacity when accessing the data. Their difference is the number
+	 * of elements in the buffer. */
+
+	boost::atomic<size_t> _readPos;  ///< The total number of elements read.
+	boost::atomic<size_t> _writePos; ///< The total number of elements written.
+};
+
+} // End of namespace Common
+
+#endif // COMMON_RINGBUFFER_H
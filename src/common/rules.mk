@@ -67,8 +67,10 @@ src_common_libcommon_la_SOURCES += \
     src/common/memwritestream.h \
     src/common/streamtokenizer.h \
     src/common/stringmap.h \
+    src/common/stringarena.h \
     src/common/readline.h \
     src/common/readfile.h \
+    src/common/mappedfile.h \
     src/common/writefile.h \
     src/common/filepath.h \
     src/common/filelist.h \
@@ -77,6 +79,12 @@ src_common_libcommon_la_SOURCES += \
     src/common/bitstreamwriter.h \
     src/common/huffman.h \
     src/common/boundingbox.h \
+    src/common/aabbtree.h \
+    src/common/frustum.h \
+    src/common/spatialhash.h \
+    src/common/threadpool.h \
+    src/common/ringbuffer.h \
+    src/common/workpass.h \
     src/common/configfile.h \
     src/common/configman.h \
     src/common/foxpro.h \
@@ -120,13 +128,19 @@ src_common_libcommon_la_SOURCES += \
     src/common/memwritestream.cpp \
     src/common/streamtokenizer.cpp \
     src/common/stringmap.cpp \
+    src/common/stringarena.cpp \
     src/common/readline.cpp \
     src/common/readfile.cpp \
+    src/common/mappedfile.cpp \
     src/common/writefile.cpp \
     src/common/filepath.cpp \
     src/common/filelist.cpp \
     src/common/huffman.cpp \
     src/common/boundingbox.cpp \
+    src/common/aabbtree.cpp \
+    src/common/frustum.cpp \
+    src/common/spatialhash.cpp \
+    src/common/threadpool.cpp \
     src/common/configfile.cpp \
     src/common/configman.cpp \
     src/common/foxpro.cpp \
@@ -0,0 +1,257 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A spatial hash of axis-aligned rectangles on a uniform grid.
+ */
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+
+#include "src/common/spatialhash.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+/** The largest cell coordinate, so that the cell ranges of huge rectangles can't overflow. */
+static const int32 kMaxCell = 0x3FFFFFFF;
+
+SpatialHash::SpatialHash(float cellSize) : _cellSize(cellSize), _freeList(kInvalidProxy),
+	_count(0), _queryStamp(0) {
+
+	assert(_cellSize > 0.0f);
+}
+
+SpatialHash::~SpatialHash() {
+}
+
+void SpatialHash::clear() {
+	_proxies.clear();
+	_cells.clear();
+
+	_freeList   = kInvalidProxy;
+	_count      = 0;
+	_queryStamp = 0;
+}
+
+size_t SpatialHash::size() const {
+	return _count;
+}
+
+int32 SpatialHash::getCell(float coordinate) const {
+	const float cell = std::floor(coordinate / _cellSize);
+
+	// This also catches NaNs
+	if (!(cell > -kMaxCell))
+		return -kMaxCell;
+	if (!(cell <  kMaxCell))
+		return  kMaxCell;
+
+	return (int32) cell;
+}
+
+uint64 SpatialHash::getCellKey(int32 x, int32 y) {
+	return (((uint64) (uint32) x) << 32) | ((uint64) (uint32) y);
+}
+
+uint32 SpatialHash::insert(float minX, float minY, float maxX, float maxY, void *data) {
+	if (_freeList == kInvalidProxy) {
+		_proxies.push_back(Proxy());
+		_proxies.back().nextFree = kInvalidProxy;
+
+		_freeList = _proxies.size() - 1;
+	}
+
+	const uint32 proxy = _freeList;
+	Proxy &p = _proxies[proxy];
+
+	_freeList = p.nextFree;
+
+	p.minX = minX;
+	p.minY = minY;
+	p.maxX = maxX;
+	p.maxY = maxY;
+
+	p.cellX1 = getCell(minX);
+	p.cellY1 = getCell(minY);
+	p.cellX2 = getCell(maxX);
+	p.cellY2 = getCell(maxY);
+
+	p.data       = data;
+	p.nextFree   = kInvalidProxy;
+	p.used       = true;
+	p.queryStamp = 0;
+
+	addToCells(proxy);
+	_count++;
+
+	return proxy;
+}
+
+void SpatialHash::remove(uint32 proxy) {
+	assert((proxy < _proxies.size()) && _proxies[proxy].used);
+
+	removeFromCells(proxy);
+
+	Proxy &p = _proxies[proxy];
+
+	p.data     = 0;
+	p.used     = false;
+	p.nextFree = _freeList;
+
+	_freeList = proxy;
+	_count--;
+}
+
+void SpatialHash::update(uint32 proxy, float minX, float minY, float maxX, float maxY) {
+	assert((proxy < _proxies.size()) && _proxies[proxy].used);
+
+	Proxy &p = _proxies[proxy];
+
+	p.minX = minX;
+	p.minY = minY;
+	p.maxX = maxX;
+	p.maxY = maxY;
+
+	const int32 cellX1 = getCell(minX);
+	const int32 cellY1 = getCell(minY);
+	const int32 cellX2 = getCell(maxX);
+	const int32 cellY2 = getCell(maxY);
+
+	// Still within the same cells?
+	if ((cellX1 == p.cellX1) && (cellY1 == p.cellY1) && (cellX2 == p.cellX2) && (cellY2 == p.cellY2))
+		return;
+
+	removeFromCells(proxy);
+
+	p.cellX1 = cellX1;
+	p.cellY1 = cellY1;
+	p.cellX2 = cellX2;
+	p.cellY2 = cellY2;
+
+	addToCells(proxy);
+}
+
+void *SpatialHash::getData(uint32 proxy) const {
+	assert((proxy < _proxies.size()) && _proxies[proxy].used);
+
+	return _proxies[proxy].data;
+}
+
+void SpatialHash::addToCells(uint32 proxy) {
+	const Proxy &p = _proxies[proxy];
+
+	for (int32 y = p.cellY1; y <= p.cellY2; y++)
+		for (int32 x = p.cellX1; x <= p.cellX2; x++)
+			_cells[getCellKey(x, y)].push_back(proxy);
+}
+
+void SpatialHash::removeFromCells(uint32 proxy) {
+	const Proxy &p = _proxies[proxy];
+
+	for (int32 y = p.cellY1; y <= p.cellY2; y++) {
+		for (int32 x = p.cellX1; x <= p.cellX2; x++) {
+			CellMap::iterator cell = _cells.find(getCellKey(x, y));
+			assert(cell != _cells.end());
+
+			std::vector<uint32> &proxies = cell->second;
+
+			std::vector<uint32>::iterator it = std::find(proxies.begin(), proxies.end(), proxy);
+			assert(it != proxies.end());
+
+			*it = proxies.back();
+			proxies.pop_back();
+
+			if (proxies.empty())
+				_cells.erase(cell);
+		}
+	}
+}
+
+void SpatialHash::findInCell(const std::vector<uint32> &cell, float minX, float minY, float maxX, float maxY,
+                             std::vector<uint32> &found) const {
+
+	for (std::vector<uint32>::const_iterator c = cell.begin(); c != cell.end(); ++c) {
+		const Proxy &p = _proxies[*c];
+
+		// Already seen in another cell during this query?
+		if (p.queryStamp == _queryStamp)
+			continue;
+
+		p.queryStamp = _queryStamp;
+
+		if ((p.minX <= maxX) && (p.maxX >= minX) && (p.minY <= maxY) && (p.maxY >= minY))
+			found.push_back(*c);
+	}
+}
+
+void SpatialHash::find(float minX, float minY, float maxX, float maxY, std::vector<void *> &data) const {
+	data.clear();
+	if (_count == 0)
+		return;
+
+	if (++_queryStamp == 0) {
+		// The stamp wrapped around, reset all objects
+		for (std::vector<Proxy>::const_iterator p = _proxies.begin(); p != _proxies.end(); ++p)
+			p->queryStamp = 0;
+
+		_queryStamp = 1;
+	}
+
+	const int32 cellX1 = getCell(minX);
+	const int32 cellY1 = getCell(minY);
+	const int32 cellX2 = getCell(maxX);
+	const int32 cellY2 = getCell(maxY);
+
+	std::vector<uint32> found;
+
+	const uint64 cellCount = ((uint64) (cellX2 - cellX1 + 1)) * ((uint64) (cellY2 - cellY1 + 1));
+	if (cellCount > _cells.size()) {
+		// The rectangle covers more cells than there are filled, just look at all of them
+
+		for (CellMap::const_iterator cell = _cells.begin(); cell != _cells.end(); ++cell)
+			findInCell(cell->second, minX, minY, maxX, maxY, found);
+
+	} else {
+
+		for (int32 y = cellY1; y <= cellY2; y++) {
+			for (int32 x = cellX1; x <= cellX2; x++) {
+				CellMap::const_iterator cell = _cells.find(getCellKey(x, y));
+				if (cell != _cells.end())
+					findInCell(cell->second, minX, minY, maxX, maxY, found);
+			}
+		}
+
+	}
+
+	std::sort(found.begin(), found.end());
+
+	data.reserve(found.size());
+	for (std::vector<uint32>::const_iterator f = found.begin(); f != found.end(); ++f)
+		data.push_back(_proxies[*f].data);
+}
+
+void SpatialHash::find(float x, float y, std::vector<void *> &data) const {
+	find(x, y, x, y, data);
+}
+
+} // End of namespace Common
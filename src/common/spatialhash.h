@@ -0,0 +1,143 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A spatial hash of axis-aligned rectangles on a uniform grid.
+ */
+
+#ifndef COMMON_SPATIALHASH_H
+#define COMMON_SPATIALHASH_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered/unordered_map.hpp>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A spatial hash of axis-aligned rectangles in the XY plane.
+ *
+ *  The plane is divided into a uniform grid of square cells, and each
+ *  object is sorted into all cells its bounding rectangle overlaps. Only
+ *  the cells that actually hold objects are stored, in a hash map, so the
+ *  grid is unbounded. A query only needs to look at the objects in the
+ *  cells it touches.
+ *
+ *  Moving an object only touches the cells it leaves and enters.
+ */
+class SpatialHash : boost::noncopyable {
+public:
+	static const uint32 kInvalidProxy = 0xFFFFFFFF;
+
+	/** Create a spatial hash.
+	 *
+	 *  @param cellSize The length of a cell's side.
+	 */
+	SpatialHash(float cellSize = 8.0f);
+	~SpatialHash();
+
+	/** Remove all objects from the hash. */
+	void clear();
+
+	/** Return the number of objects in the hash. */
+	size_t size() const;
+
+	/** Add an object to the hash.
+	 *
+	 *  @param  minX The minimum X coordinate of the object's bounding rectangle.
+	 *  @param  minY The minimum Y coordinate of the object's bounding rectangle.
+	 *  @param  maxX The maximum X coordinate of the object's bounding rectangle.
+	 *  @param  maxY The maximum Y coordinate of the object's bounding rectangle.
+	 *  @param  data The object's user data.
+	 *  @return The proxy ID identifying the object within the hash.
+	 */
+	uint32 insert(float minX, float minY, float maxX, float maxY, void *data);
+
+	/** Remove an object from the hash. */
+	void remove(uint32 proxy);
+
+	/** Change the bounding rectangle of an object in the hash. */
+	void update(uint32 proxy, float minX, float minY, float maxX, float maxY);
+
+	/** Return the user data of an object in the hash. */
+	void *getData(uint32 proxy) const;
+
+	/** Find all objects whose bounding rectangle overlaps the rectangle.
+	 *
+	 *  The objects are returned in ascending order of their proxy IDs.
+	 */
+	void find(float minX, float minY, float maxX, float maxY, std::vector<void *> &data) const;
+
+	/** Find all objects whose bounding rectangle contains the point.
+	 *
+	 *  The objects are returned in ascending order of their proxy IDs.
+	 */
+	void find(float x, float y, std::vector<void *> &data) const;
+
+private:
+	struct Proxy {
+		float minX;
+		float minY;
+		float maxX;
+		float maxY;
+
+		/** The range of cells the object is sorted into. */
+		int32 cellX1;
+		int32 cellY1;
+		int32 cellX2;
+		int32 cellY2;
+
+		void *data;
+
+		/** The next free proxy, or kInvalidProxy if this one is used. */
+		uint32 nextFree;
+		bool used;
+
+		/** The last query this object was found by, to only report it once. */
+		mutable uint32 queryStamp;
+	};
+
+	typedef boost::unordered_map<uint64, std::vector<uint32> > CellMap;
+
+	float _cellSize;
+
+	std::vector<Proxy> _proxies;
+	uint32 _freeList;
+	size_t _count;
+
+	CellMap _cells;
+
+	mutable uint32 _queryStamp;
+
+	int32 getCell(float coordinate) const;
+	static uint64 getCellKey(int32 x, int32 y);
+
+	void addToCells(uint32 proxy);
+	void removeFromCells(uint32 proxy);
+
+	void findInCell(const std::vector<uint32> &cell, float minX, float minY, float maxX, float maxY,
+	                std::vector<uint32> &found) const;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_SPATIALHASH_H
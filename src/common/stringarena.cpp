@@ -0,0 +1,176 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An arena of interned, immutable strings.
+ */
+
+#include <cstring>
+
+#include "src/common/stringarena.h"
+#include "src/common/util.h"
+#include "src/common/hash.h"
+
+namespace Common {
+
+static const char *kEmptyString = "";
+
+static uint32 hashBytes(const char *str, size_t length) {
+	uint32 hash = 0x811C9DC5;
+
+	for (size_t i = 0; i < length; i++)
+		hash = hashFNV32(hash, (byte) str[i]);
+
+	return hash;
+}
+
+StringArena::StringArena(size_t blockSize) : _blockSize(MAX<size_t>(blockSize, 64)),
+	_current(0), _available(0), _memoryUsage(0), _count(0) {
+
+}
+
+StringArena::~StringArena() {
+	clear();
+}
+
+void StringArena::clear() {
+	for (std::vector<char *>::iterator b = _blocks.begin(); b != _blocks.end(); ++b)
+		delete[] *b;
+
+	_blocks.clear();
+	_slots.clear();
+
+	_current     = 0;
+	_available   = 0;
+	_memoryUsage = 0;
+	_count       = 0;
+}
+
+size_t StringArena::size() const {
+	return _count;
+}
+
+size_t StringArena::getMemoryUsage() const {
+	return _memoryUsage;
+}
+
+size_t StringArena::findSlot(const char *str, size_t length, uint32 hash) const {
+	const size_t mask = _slots.size() - 1;
+
+	for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+		const Slot &slot = _slots[i];
+		if (!slot.string)
+			return i;
+
+		if ((slot.hash == hash) && !std::strncmp(slot.string, str, length) && (slot.string[length] == '\0'))
+			return i;
+	}
+}
+
+const char *StringArena::find(const char *str) const {
+	if (!str || !*str)
+		return kEmptyString;
+
+	if (_slots.empty())
+		return 0;
+
+	const size_t length = std::strlen(str);
+
+	return _slots[findSlot(str, length, hashBytes(str, length))].string;
+}
+
+const char *StringArena::intern(const UString &str) {
+	return intern(str.c_str());
+}
+
+const char *StringArena::intern(const char *str) {
+	if (!str || !*str)
+		return kEmptyString;
+
+	// Keep the load factor below 3/4
+	if (((_count + 1) * 4) > (_slots.size() * 3))
+		grow();
+
+	const size_t length = std::strlen(str);
+	const uint32 hash   = hashBytes(str, length);
+
+	Slot &slot = _slots[findSlot(str, length, hash)];
+	if (slot.string)
+		return slot.string;
+
+	slot.string = store(str, length);
+	slot.hash   = hash;
+
+	_count++;
+
+	return slot.string;
+}
+
+const char *StringArena::store(const char *str, size_t length) {
+	const size_t size = length + 1;
+
+	char *data = 0;
+	if (size > (_blockSize / 4)) {
+		// Big strings get a block of their own, so we don't waste the rest of the current block
+
+		data = new char[size];
+		_blocks.push_back(data);
+
+		_memoryUsage += size;
+
+	} else {
+		if (size > _available) {
+			_current   = new char[_blockSize];
+			_available = _blockSize;
+
+			_blocks.push_back(_current);
+
+			_memoryUsage += _blockSize;
+		}
+
+		data = _current;
+
+		_current   += size;
+		_available -= size;
+	}
+
+	std::memcpy(data, str, size);
+
+	return data;
+}
+
+void StringArena::grow() {
+	std::vector<Slot> oldSlots(MAX<size_t>(_slots.size() * 2, 256));
+	oldSlots.swap(_slots);
+
+	const size_t mask = _slots.size() - 1;
+	for (std::vector<Slot>::const_iterator s = oldSlots.begin(); s != oldSlots.end(); ++s) {
+		if (!s->string)
+			continue;
+
+		size_t i = s->hash & mask;
+		while (_slots[i].string)
+			i = (i + 1) & mask;
+
+		_slots[i] = *s;
+	}
+}
+
+} // End of namespace Common
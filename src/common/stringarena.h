@@ -0,0 +1,102 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An arena of interned, immutable strings.
+ */
+
+#ifndef COMMON_STRINGARENA_H
+#define COMMON_STRINGARENA_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+namespace Common {
+
+/** An arena of interned, immutable strings.
+ *
+ *  Strings are copied back to back into big memory blocks, and each
+ *  distinct string is only ever stored once. The returned pointers
+ *  stay valid until the arena is cleared or destroyed, and two
+ *  strings interned into the same arena are equal if and only if
+ *  their pointers are equal.
+ *
+ *  This is meant for large sets of small strings that are seldom
+ *  removed, like the names of all resources of a game.
+ */
+class StringArena : boost::noncopyable {
+public:
+	static const size_t kDefaultBlockSize = 65536;
+
+	StringArena(size_t blockSize = kDefaultBlockSize);
+	~StringArena();
+
+	/** Remove all strings, invalidating all pointers handed out. */
+	void clear();
+
+	/** Return the number of distinct strings in the arena. */
+	size_t size() const;
+
+	/** Return the number of bytes allocated for string data. */
+	size_t getMemoryUsage() const;
+
+	/** Add a string to the arena and return its interned copy.
+	 *
+	 *  The empty string is never stored, the same static "" is
+	 *  always returned for it instead.
+	 */
+	const char *intern(const char *str);
+	const char *intern(const UString &str);
+
+	/** Find the interned copy of a string, or 0 if it's not in the arena. */
+	const char *find(const char *str) const;
+
+private:
+	struct Slot {
+		const char *string; ///< The interned string, 0 if the slot is empty.
+		uint32      hash;   ///< The hash of the string.
+	};
+
+	size_t _blockSize;
+
+	std::vector<char *> _blocks; ///< All allocated memory blocks.
+
+	char  *_current;   ///< The position of the next string in the current block.
+	size_t _available; ///< The bytes still free in the current block.
+
+	size_t _memoryUsage;
+
+	std::vector<Slot> _slots; ///< Open-addressed hash table over all strings.
+	size_t            _count; ///< Number of strings in the table.
+
+	size_t findSlot(const char *str, size_t length, uint32 hash) const;
+
+	const char *store(const char *str, size_t length);
+
+	void grow();
+};
+
+} // End of namespace Common
+
+#endif // COMMON_STRINGARENA_H
@@ -54,9 +54,15 @@ bool Thread::createThread(const UString &name) {
 
 	_name = name;
 
+	/* Mark the thread as running before it actually starts. Otherwise, destroying
+	 * it right away would wait for a thread that was never told to stop. */
+	_threadRunning.store(true, boost::memory_order_seq_cst);
+
 	// Try to create the thread
-	if (!(_thread = SDL_CreateThread(threadHelper, _name.empty() ? 0 : _name.c_str(), static_cast<void *>(this))))
+	if (!(_thread = SDL_CreateThread(threadHelper, _name.empty() ? 0 : _name.c_str(), static_cast<void *>(this)))) {
+		_threadRunning.store(false, boost::memory_order_seq_cst);
 		return false;
+	}
 
 	return true;
 }
@@ -0,0 +1,170 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of threads running jobs.
+ */
+
+#include "src/common/threadpool.h"
+#include "src/common/thread.h"
+
+namespace Common {
+
+/** How long a worker waits for a new job before checking whether it should stop. */
+static const uint32 kWorkerTimeout = 100;
+
+/** A thread running queued jobs. */
+class ThreadPool::Worker : public Thread {
+public:
+	Worker(ThreadPool &pool) : _pool(&pool) {
+	}
+
+	~Worker() {
+		destroyThread();
+	}
+
+private:
+	ThreadPool *_pool;
+
+	void threadMethod() {
+		while (!_killThread.load(boost::memory_order_relaxed) && !_pool->_stop.load(boost::memory_order_relaxed)) {
+			Job job;
+			if (!_pool->takeJob(job))
+				continue;
+
+			_pool->runJob(job);
+		}
+	}
+};
+
+
+ThreadPool::ThreadPool(size_t threadCount) : _queued(0), _finished(_mutex), _stop(false),
+	_pendingCount(0), _finishedCount(0) {
+
+	for (size_t i = 0; i < threadCount; i++) {
+		_workers.push_back(new Worker(*this));
+
+		if (!_workers.back()->createThread(UString::format("ThreadPool%u", (uint) i)))
+			throw Exception("Failed to create a thread pool thread");
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	// Wake up all workers, so that they notice they should stop
+	_stop.store(true);
+	for (size_t i = 0; i < _workers.size(); i++)
+		_queued.unlock();
+
+	// Destroying the workers waits for them to finish their current job
+	_workers.clear();
+}
+
+size_t ThreadPool::getThreadCount() const {
+	return _workers.size();
+}
+
+void ThreadPool::add(const Job &job) {
+	if (_workers.empty()) {
+		{
+			StackLock lock(_mutex);
+			_pendingCount++;
+		}
+
+		runJob(job);
+		return;
+	}
+
+	StackLock lock(_mutex);
+
+	_jobs.push_back(job);
+	_pendingCount++;
+
+	_queued.unlock();
+}
+
+size_t ThreadPool::getPendingCount() const {
+	StackLock lock(_mutex);
+
+	return _pendingCount;
+}
+
+size_t ThreadPool::getFinishedCount() const {
+	StackLock lock(_mutex);
+
+	return _finishedCount;
+}
+
+bool ThreadPool::wait(uint32 timeout) {
+	StackLock lock(_mutex);
+
+	while (_pendingCount > 0)
+		if (!_finished.wait(timeout) && (timeout != 0) && (_pendingCount > 0))
+			return false;
+
+	if (_error) {
+		Exception error(*_error);
+		_error.reset();
+
+		throw error;
+	}
+
+	return true;
+}
+
+bool ThreadPool::takeJob(Job &job) {
+	if (!_queued.lock(kWorkerTimeout))
+		return false;
+
+	StackLock lock(_mutex);
+
+	// Woken up to stop
+	if (_jobs.empty())
+		return false;
+
+	job = _jobs.front();
+	_jobs.pop_front();
+
+	return true;
+}
+
+void ThreadPool::runJob(const Job &job) {
+	ScopedPtr<Exception> error;
+
+	try {
+		job();
+	} catch (Exception &e) {
+		error.reset(new Exception(e));
+	} catch (std::exception &e) {
+		error.reset(new Exception(e));
+	} catch (...) {
+		error.reset(new Exception("Unknown exception"));
+	}
+
+	StackLock lock(_mutex);
+
+	if (error && !_error)
+		_error.swap(error);
+
+	_finishedCount++;
+	if (--_pendingCount == 0)
+		_finished.signal();
+}
+
+} // End of namespace Common
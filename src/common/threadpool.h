@@ -0,0 +1,114 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of threads running jobs.
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include <list>
+
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+
+#include "src/common/types.h"
+#include "src/common/atomic.h"
+#include "src/common/mutex.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/error.h"
+
+namespace Common {
+
+/** A pool of threads running jobs in parallel.
+ *
+ *  Jobs can be added at any time, even by other jobs. The thread owning
+ *  the pool can then wait for all of them to finish. If a job throws, the
+ *  first exception is handed on to the waiting thread.
+ *
+ *  A pool without any threads runs each job right away, when it's added.
+ */
+class ThreadPool : boost::noncopyable {
+public:
+	typedef boost::function<void ()> Job;
+
+	/** Create a pool of threads.
+	 *
+	 *  @param threadCount The number of threads to run the jobs on.
+	 */
+	ThreadPool(size_t threadCount);
+	/** Stop all threads, dropping all jobs that haven't been started yet. */
+	~ThreadPool();
+
+	/** Return the number of threads in the pool. */
+	size_t getThreadCount() const;
+
+	/** Queue a job. */
+	void add(const Job &job);
+
+	/** Return the number of jobs that are queued or running. */
+	size_t getPendingCount() const;
+	/** Return the number of jobs that have finished, successfully or not. */
+	size_t getFinishedCount() const;
+
+	/** Wait for all jobs to finish.
+	 *
+	 *  If one of the jobs threw an exception, it is thrown here, once all
+	 *  jobs finished.
+	 *
+	 *  @param  timeout Only wait for that many milliseconds. 0 means wait forever.
+	 *  @return true if all jobs finished, false if the wait timed out.
+	 */
+	bool wait(uint32 timeout = 0);
+
+private:
+	class Worker;
+
+	typedef std::list<Job> Jobs;
+
+	PtrVector<Worker> _workers;
+
+	/** Protects the job list and the counters. */
+	mutable Mutex _mutex;
+	/** Counts the queued jobs. */
+	Semaphore _queued;
+	/** Signalled when the last pending job finished. */
+	Condition _finished;
+
+	boost::atomic<bool> _stop; ///< Should the workers stop?
+
+	Jobs _jobs; ///< Jobs waiting to be run.
+
+	size_t _pendingCount;  ///< The number of jobs queued or running.
+	size_t _finishedCount; ///< The number of jobs finished.
+
+	ScopedPtr<Exception> _error; ///< The first exception thrown by a job.
+
+	/** Take the next job out of the queue. Returns false if the worker should check whether to stop. */
+	bool takeJob(Job &job);
+	/** Run a job, and record its outcome. */
+	void runJob(const Job &job);
+};
+
+} // End of namespace Common
+
+#endif // COMMON_THREADPOOL_H
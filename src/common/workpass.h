@@ -0,0 +1,105 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A single pass over a list of items, shared between several threads.
+ */
+
+#ifndef COMMON_WORKPASS_H
+#define COMMON_WORKPASS_H
+
+#include <vector>
+#include <algorithm>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/atomic.h"
+
+namespace Common {
+
+/** A single pass over a list of items, shared between several threads.
+ *
+ *  The items are first copied out of their list into the pass. Threads
+ *  then claim them one at a time, through one shared atomic index, until
+ *  all items are claimed. Each item is claimed exactly once.
+ *
+ *  Since the pass works on its own copy, the original list may change
+ *  while the pass is going on. Items added to it are only seen by the
+ *  next pass. Items removed from it need to be removed from the pass as
+ *  well, and are then skipped. Removing must not happen while threads
+ *  are claiming items.
+ */
+template<typename T>
+class WorkPass : boost::noncopyable {
+public:
+	WorkPass() : _next(0) {
+	}
+
+	/** Add an item to the pass. Must not be called while threads are claiming items. */
+	void add(T *item) {
+		_items.push_back(item);
+	}
+
+	/** End the pass, forgetting all items, claimed or not. */
+	void clear() {
+		_items.clear();
+
+		_next.store(0);
+	}
+
+	/** Return the number of items in the pass, claimed or not. */
+	size_t size() const {
+		return _items.size();
+	}
+
+	/** Have all items been claimed? */
+	bool done() const {
+		return _next.load() >= _items.size();
+	}
+
+	/** Claim the next item, returning false if all items have been claimed. */
+	bool claim(T *&item) {
+		while (true) {
+			const size_t index = _next.fetch_add(1);
+			if (index >= _items.size())
+				return false;
+
+			if (_items[index]) {
+				item = _items[index];
+				return true;
+			}
+		}
+	}
+
+	/** Remove an item from the pass, so that it won't be claimed anymore. */
+	void remove(const T *item) {
+		std::replace(_items.begin(), _items.end(), const_cast<T *>(item), static_cast<T *>(0));
+	}
+
+private:
+	std::vector<T *> _items;
+
+	boost::atomic<size_t> _next; ///< The index of the next item to be claimed.
+};
+
+} // End of namespace Common
+
+#endif // COMMON_WORKPASS_H
@@ -158,34 +158,38 @@ size_t ZipFile::getFileSize(uint32 index) const {
 	return getIFile(index).size;
 }
 
-SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
+SeekableReadStream *ZipFile::getFile(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IFile &file = getIFile(index);
 
 	uint16 compMethod;
 	uint32 compSize;
 	uint32 realSize;
 
-	getFileProperties(*_zip, file, compMethod, compSize, realSize);
+	MemoryReadStream *packed = 0;
+	{
+		StackLock lock(_mutex);
 
-	if (tryNoCopy && (compMethod == 0))
-		return new SeekableSubReadStream(_zip.get(), _zip->pos(), _zip->pos() + compSize);
+		getFileProperties(*_zip, file, compMethod, compSize, realSize);
 
-	return decompressFile(*_zip, compMethod, compSize, realSize);
+		packed = _zip->readStream(compSize);
+	}
+
+	return decompressFile(packed, compMethod, realSize);
 }
 
-SeekableReadStream *ZipFile::decompressFile(SeekableReadStream &zip, uint32 method,
-		uint32 compSize, uint32 realSize) {
+SeekableReadStream *ZipFile::decompressFile(MemoryReadStream *packed, uint32 method, uint32 realSize) {
+	ScopedPtr<MemoryReadStream> stream(packed);
 
 	if (method == 0) {
 		// Uncompressed
 
-		return zip.readStream(compSize);
+		return stream.release();
 	}
 
 	if (method != 8)
 		throw Exception("Unhandled Zip compression %d", method);
 
-	return decompressDeflate(zip, compSize, realSize, kWindowBitsMaxRaw);
+	return decompressDeflate(*stream, stream->size(), realSize, kWindowBitsMaxRaw);
 }
 
 } // End of namespace Common
@@ -33,12 +33,18 @@
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
+#include "src/common/mutex.h"
 
 namespace Common {
 
 class SeekableReadStream;
+class MemoryReadStream;
 
-/** A class encapsulating ZIP file access. */
+/** A class encapsulating ZIP file access.
+ *
+ *  getFile() may be called concurrently from several threads. Only the
+ *  reading of the compressed data is serialized, the decompression is not.
+ */
 class ZipFile : boost::noncopyable {
 public:
 	/** A file. */
@@ -58,7 +64,11 @@ public:
 	/** Return the size of a file. */
 	size_t getFileSize(uint32 index) const;
 
-	/** Return a stream of the file's contents. */
+	/** Return a stream of the file's contents.
+	 *
+	 *  tryNoCopy is only a hint: an uncompressed file's data is only left
+	 *  uncopied if the ZIP itself is a memory-mapped stream.
+	 */
 	SeekableReadStream *getFile(uint32 index, bool tryNoCopy = false) const;
 
 private:
@@ -72,6 +82,9 @@ private:
 
 	ScopedPtr<SeekableReadStream> _zip;
 
+	/** Guards access to the ZIP stream's position. */
+	mutable Mutex _mutex;
+
 	/** External list of file names and types. */
 	FileList _files;
 
@@ -80,8 +93,7 @@ private:
 
 	void load(SeekableReadStream &zip);
 
-	static SeekableReadStream *decompressFile(SeekableReadStream &zip, uint32 method,
-			uint32 compSize, uint32 realSize);
+	static SeekableReadStream *decompressFile(MemoryReadStream *packed, uint32 method, uint32 realSize);
 
 	const IFile &getIFile(uint32 index) const;
 	void getFileProperties(SeekableReadStream &zip, const IFile &file,
@@ -745,6 +745,8 @@ Console::Console(Engine &engine, const Common::UString &font, int fontHeight) :
 			"Usage: setoption <option> <value>\nSet the value of a config option for this session");
 	registerCommand("showfps"    , boost::bind(&Console::cmdShowFPS    , this, _1),
 			"Usage: showfps <true/false>\nShow/Hide the frames-per-second display");
+	registerCommand("renderstats", boost::bind(&Console::cmdRenderStats, this, _1),
+			"Usage: renderstats\nPrint how much world geometry was drawn in the last frame");
 	registerCommand("listlangs"  , boost::bind(&Console::cmdListLangs  , this, _1),
 			"Usage: listlangs\nLists all languages supported by this game version");
 	registerCommand("getlang"    , boost::bind(&Console::cmdGetLang    , this, _1),
@@ -1322,6 +1324,14 @@ void Console::cmdShowFPS(const CommandLine &cl) {
 	_engine->showFPS();
 }
 
+void Console::cmdRenderStats(const CommandLine &UNUSED(cl)) {
+	const Graphics::Aurora::NodeRenderQueue::Statistics stats = GfxMan.getRenderStatistics();
+
+	printf("Draw calls   : %u", stats.drawCalls);
+	printf("State changes: %u", stats.stateChanges);
+	printf("Triangles    : %u", stats.triangles);
+}
+
 void Console::cmdListLangs(const CommandLine &UNUSED(cl)) {
 	std::vector<Aurora::Language> langs;
 	if (_engine->detectLanguages(langs)) {
@@ -29,10 +29,17 @@
 
 #include "src/events/events.h"
 
+#include "src/sound/sound.h"
+
 #include "src/engines/aurora/resources.h"
 
 namespace Engines {
 
+/** The indexed resources changed, so cached sounds might be shadowed or gone. */
+static void invalidateSoundCache() {
+	SoundMan.clearSoundCache();
+}
+
 void indexMandatoryArchive(const Common::UString &file, uint32 priority, const std::vector<byte> &password,
                            Common::ChangeID *changeID) {
 
@@ -45,6 +52,8 @@ void indexMandatoryArchive(const Common::UString &file, uint32 priority, const s
 		e.add("Failed to index mandatory archive \"%s\"", file.c_str());
 		throw;
 	}
+
+	invalidateSoundCache();
 }
 
 void indexMandatoryArchive(const Common::UString &file, uint32 priority, const std::vector<byte> &password,
@@ -82,6 +91,8 @@ bool indexOptionalArchive(const Common::UString &file, uint32 priority, const st
 		throw;
 	}
 
+	invalidateSoundCache();
+
 	return true;
 }
 
@@ -121,6 +132,8 @@ void indexMandatoryDirectory(const Common::UString &dir, const char *glob, int d
 		e.add("Failed to index mandatory directory \"%s\"", dir.c_str());
 		throw;
 	}
+
+	invalidateSoundCache();
 }
 
 void indexMandatoryDirectory(const Common::UString &dir, const char *glob, int depth,
@@ -146,6 +159,8 @@ bool indexOptionalDirectory(const Common::UString &dir, const char *glob, int de
 		throw;
 	}
 
+	invalidateSoundCache();
+
 	return true;
 }
 
@@ -162,7 +177,12 @@ bool indexOptionalDirectory(const Common::UString &dir, const char *glob, int de
 }
 
 void deindexResources(Common::ChangeID &changeID) {
+	if (changeID.empty())
+		return;
+
 	ResMan.undo(changeID);
+
+	invalidateSoundCache();
 }
 
 void deindexResources(ChangeList &changes) {
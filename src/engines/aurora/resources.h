@@ -40,6 +40,9 @@ namespace Engines {
 
 typedef std::list<Common::ChangeID> ChangeList;
 
+/* Adding or removing resources clears the sound cache, since the cached sounds
+ * might have been shadowed by new resources, or come out of removed ones. */
+
 /** Add an archive file to the resource manager, erroring out if it does not exist. */
 void indexMandatoryArchive(const Common::UString &file, uint32 priority, Common::ChangeID *changeID = 0);
 void indexMandatoryArchive(const Common::UString &file, uint32 priority, ChangeList &changes);
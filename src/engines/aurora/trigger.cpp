@@ -44,6 +44,10 @@ void Trigger::setVisible(bool visible) {
 	_visible = visible;
 }
 
+const Common::BoundingBox &Trigger::getBoundingBox() const {
+	return _boundingbox;
+}
+
 /*
  * Return true if the (x, y) coordinates are located within
  * the horizontal projection of this closed polygon.
@@ -84,14 +84,22 @@ Sound::ChannelHandle playSound(const Common::UString &sound, Sound::SoundType so
 	Aurora::ResourceType resType =
 		(soundType == Sound::kSoundTypeMusic) ? Aurora::kResourceMusic : Aurora::kResourceSound;
 
+	// Music is too long to be worth caching
+	const Common::UString cacheName = (resType == Aurora::kResourceSound) ? sound : "";
+
 	Sound::ChannelHandle channel;
 
 	try {
-		Common::SeekableReadStream *soundStream = ResMan.getResource(resType, sound);
-		if (!soundStream)
-			return channel;
+		if (!cacheName.empty())
+			channel = SoundMan.playCachedSound(cacheName, soundType, loop);
+
+		if (!SoundMan.isValidChannel(channel)) {
+			Common::SeekableReadStream *soundStream = ResMan.getResource(resType, sound);
+			if (!soundStream)
+				return channel;
 
-		channel = SoundMan.playSoundFile(soundStream, soundType, loop);
+			channel = SoundMan.playSoundFile(soundStream, soundType, loop, cacheName);
+		}
 
 		debugC(Common::kDebugEngineSound, 1, "Playing sound \"%s\" in %s",
 		       sound.c_str(), SoundMan.formatChannel(channel).c_str());
@@ -113,6 +121,25 @@ Sound::ChannelHandle playSound(const Common::UString &sound, Sound::SoundType so
 	return channel;
 }
 
+void preloadSounds(const std::vector<Common::UString> &sounds) {
+	for (std::vector<Common::UString>::const_iterator s = sounds.begin(); s != sounds.end(); ++s) {
+		if (s->empty() || SoundMan.isSoundCached(*s))
+			continue;
+
+		try {
+			Common::SeekableReadStream *soundStream = ResMan.getResource(Aurora::kResourceSound, *s);
+			if (!soundStream)
+				continue;
+
+			if (SoundMan.cacheSoundFile(*s, soundStream))
+				debugC(Common::kDebugEngineSound, 2, "Preloaded sound \"%s\"", s->c_str());
+
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed to preload sound \"%s\"", s->c_str());
+		}
+	}
+}
+
 void checkConfigInt(const Common::UString &key, int min, int max) {
 	const int def = ConfigMan.getDefaultInt(key);
 
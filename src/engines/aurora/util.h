@@ -25,6 +25,8 @@
 #ifndef ENGINES_AURORA_UTIL_H
 #define ENGINES_AURORA_UTIL_H
 
+#include <vector>
+
 #include "src/common/ustring.h"
 
 #include "src/aurora/types.h"
@@ -44,10 +46,16 @@ namespace Engines {
 /** Play this video resource. */
 void playVideo(const Common::UString &video);
 
-/** Play this sound resource. */
+/** Play this sound resource.
+ *
+ *  Short sounds are decoded once and then played out of the sound cache.
+ */
 Sound::ChannelHandle playSound(const Common::UString &sound, Sound::SoundType soundType,
 		bool loop = false, float volume = 1.0f, bool pitchVariance = false);
 
+/** Decode these sound resources ahead of time and put them into the sound cache. */
+void preloadSounds(const std::vector<Common::UString> &sounds);
+
 /** Make sure that an int config value is in the right range. */
 void checkConfigInt   (const Common::UString &key, int    min, int    max);
 /** Make sure that a double config value is in the right range. */
@@ -222,6 +222,10 @@ void GameInstanceEngine::listLanguages() {
 void GameInstanceEngine::run() {
 	createEngine();
 
+	// Remember the resource tables of the game's archives across runs, next to the config file
+	if (ConfigMan.getBool("indexcache", true))
+		ResMan.setIndexCache(Common::FilePath::getDirectory(ConfigMan.getConfigFile()) + "/indexcache.bin");
+
 	_engine->start(_probe->getGameID(), _target, _probe->getPlatform());
 
 	destroyEngine();
@@ -277,6 +281,8 @@ void EngineManager::cleanup() const {
 		LangMan.clear();
 		TalkMan.clear();
 		TwoDAReg.clear();
+
+		ResMan.saveIndexCache();
 		ResMan.clear();
 
 		ConfigMan.setGame();
@@ -99,6 +99,7 @@ bool ActionExecutor::moveTo(Creature &creature, Area &area, float x, float y, fl
 	if (haveMovement) {
 		creature.playAnimation(run ? "run" : "walk", false, -1.0f);
 		creature.setPosition(newX, newY, z);
+		area.notifyObjectMoved(creature);
 	}
 	else
 		creature.playDefaultAnimation();
@@ -22,11 +22,17 @@
  *  The context holding a Star Wars: Knights of the Old Republic area.
  */
 
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+
 #include "src/common/scopedptr.h"
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
 #include "src/common/maths.h"
+#include "src/common/threadpool.h"
 
 #include "src/aurora/resman.h"
 #include "src/aurora/gff3file.h"
@@ -57,13 +63,24 @@ namespace Engines {
 
 namespace KotOR {
 
+/** The number of threads the rooms and files of an area are loaded on. */
+static const size_t kLoadThreadCount = 4;
+
+/** How often, in milliseconds, the loading progress is updated. */
+static const uint32 kLoadProgressInterval = 50;
+
+/** The loading progress once all rooms and files have been loaded. */
+static const unsigned int kLoadProgressFiles = 80;
+/** The loading progress once the area properties have been read. */
+static const unsigned int kLoadProgressARE   = 85;
+
 Area::CameraStyle::CameraStyle()
 		: distance(0.0f),
 		  pitch(0.0f),
 		  height(0.0f) {
 }
 
-Area::Area(Module &module, const Common::UString &resRef)
+Area::Area(Module &module, const Common::UString &resRef, const LoadingProgressFunc &progress)
 		: Object(kObjectTypeArea),
 		  _module(&module),
 		  _resRef(resRef),
@@ -75,7 +92,7 @@ Area::Area(Module &module, const Common::UString &resRef)
 		  _walkmeshInvisible(true) {
 
 	try {
-		load();
+		load(progress);
 	} catch (...) {
 		clear();
 		throw;
@@ -95,17 +112,62 @@ Area::~Area() {
 	clear();
 }
 
-void Area::load() {
-	loadLYT(); // Room layout
-	loadVIS(); // Room visibilities
+static void reportProgress(const LoadingProgressFunc &progress, unsigned int &current, unsigned int value) {
+	// The number of jobs grows while loading, so don't let the progress go backwards
+	if (!progress || (value <= current))
+		return;
+
+	current = value;
+	progress(current);
+}
+
+void Area::load(const LoadingProgressFunc &progress) {
+	unsigned int currentProgress = 0;
+
+	Common::ScopedPtr<Aurora::GFF3File> are, git;
+
+	/* The layout, the room models (and their walkmeshes), the visibilities
+	 * and the ARE and GIT files can all be read independently of each other.
+	 * Load them in parallel. The rooms are started once the layout is known.
+	 *
+	 * All OpenGL work is already deferred to the main thread by the graphics
+	 * manager, so the models can be created on any thread. */
+
+	Common::PtrVector<Room> rooms;
+
+	{
+		Common::ThreadPool pool(kLoadThreadCount);
+
+		pool.add(boost::bind(&Area::loadRooms, this, boost::ref(pool), boost::ref(rooms)));
+		pool.add(boost::bind(&Area::loadVIS, this));
+		pool.add(boost::bind(&Area::loadGFF, this, boost::ref(are), Aurora::kFileTypeARE, MKTAG('A', 'R', 'E', ' ')));
+		pool.add(boost::bind(&Area::loadGFF, this, boost::ref(git), Aurora::kFileTypeGIT, MKTAG('G', 'I', 'T', ' ')));
+
+		while (!pool.wait(kLoadProgressInterval)) {
+			const size_t finished = pool.getFinishedCount();
+			const size_t total    = finished + pool.getPendingCount();
+
+			reportProgress(progress, currentProgress, (unsigned int) ((finished * kLoadProgressFiles) / total));
+		}
+	}
+
+	for (Common::PtrVector<Room>::iterator r = rooms.begin(); r != rooms.end(); ++r) {
+		_rooms.push_back(*r);
+		*r = 0;
+	}
+
+	reportProgress(progress, currentProgress, kLoadProgressFiles);
 
-	loadRooms();
+	/* Creating the objects uses the 2DA registry and the scripting system,
+	 * neither of which is thread-safe. This needs to happen on this thread. */
 
-	Aurora::GFF3File are(_resRef, Aurora::kFileTypeARE, MKTAG('A', 'R', 'E', ' '));
-	loadARE(are.getTopLevel());
+	loadARE(are->getTopLevel());
+	reportProgress(progress, currentProgress, kLoadProgressARE);
 
-	Aurora::GFF3File git(_resRef, Aurora::kFileTypeGIT, MKTAG('G', 'I', 'T', ' '));
-	loadGIT(git.getTopLevel());
+	loadGIT(git->getTopLevel());
+	preloadSounds();
+
+	reportProgress(progress, currentProgress, 100);
 }
 
 void Area::clear() {
@@ -118,6 +180,10 @@ void Area::clear() {
 	_triggers.clear();
 	_situatedObjects.clear();
 	_activeTrigger = 0;
+
+	_tagMap.clear();
+	_spatialHash.clear();
+	_spatialProxies.clear();
 }
 
 uint32 Area::getMusicDayTrack() const {
@@ -301,6 +367,10 @@ void Area::loadVIS() {
 	}
 }
 
+void Area::loadGFF(Common::ScopedPtr<Aurora::GFF3File> &gff, Aurora::FileType type, uint32 id) {
+	gff.reset(new Aurora::GFF3File(_resRef, type, id));
+}
+
 void Area::loadARE(const Aurora::GFF3Struct &are) {
 	// Tag
 	_tag = are.getString("Tag");
@@ -388,17 +458,28 @@ void Area::loadProperties(const Aurora::GFF3Struct &props) {
 	setMusicBattleTrack(props.getUint("MusicBattle", Aurora::kStrRefInvalid));
 }
 
-void Area::loadRooms() {
-	const Aurora::LYTFile::RoomArray &rooms = _lyt.getRooms();
-	for (Aurora::LYTFile::RoomArray::const_iterator r = rooms.begin(); r != rooms.end(); ++r) {
-		_rooms.push_back(new Room(r->model, r->x, r->y, r->z));
-	}
+void Area::loadRooms(Common::ThreadPool &pool, Common::PtrVector<Room> &rooms) {
+	loadLYT(); // Room layout
+
+	const Aurora::LYTFile::RoomArray &lytRooms = _lyt.getRooms();
+
+	// Each room job fills in its own, already existing slot
+	rooms.resize(lytRooms.size(), 0);
+
+	for (size_t i = 0; i < lytRooms.size(); i++)
+		pool.add(boost::bind(&Area::loadRoom, this, boost::ref(rooms[i]), boost::cref(lytRooms[i])));
+}
+
+void Area::loadRoom(Room *&room, const Aurora::LYTFile::Room &lytRoom) {
+	room = new Room(lytRoom.model, lytRoom.x, lytRoom.y, lytRoom.z);
 }
 
 void Area::loadObject(KotOR::Object &object) {
 	_objects.push_back(&object);
 	_module->addObject(object);
 
+	addToIndices(object);
+
 	if (!object.isStatic()) {
 		const std::list<uint32> &ids = object.getIDs();
 
@@ -409,6 +490,79 @@ void Area::loadObject(KotOR::Object &object) {
 	notifyObjectMoved(object);
 }
 
+void Area::addToIndices(KotOR::Object &object) {
+	_tagMap[object.getTag().toLower()].push_back(&object);
+
+	float minX, minY, maxX, maxY;
+	if (getSpatialBounds(object, minX, minY, maxX, maxY))
+		_spatialProxies[&object] = _spatialHash.insert(minX, minY, maxX, maxY, &object);
+}
+
+void Area::removeFromIndices(KotOR::Object &object) {
+	TagMap::iterator tag = _tagMap.find(object.getTag().toLower());
+	if (tag != _tagMap.end()) {
+		std::vector<KotOR::Object *> &objects = tag->second;
+
+		objects.erase(std::remove(objects.begin(), objects.end(), &object), objects.end());
+		if (objects.empty())
+			_tagMap.erase(tag);
+	}
+
+	ProxyMap::iterator proxy = _spatialProxies.find(&object);
+	if (proxy != _spatialProxies.end()) {
+		_spatialHash.remove(proxy->second);
+		_spatialProxies.erase(proxy);
+	}
+}
+
+bool Area::getSpatialBounds(const KotOR::Object &object,
+                            float &minX, float &minY, float &maxX, float &maxY) {
+
+	float z;
+
+	switch (object.getType()) {
+		case kObjectTypeTrigger: {
+			const Common::BoundingBox &box = static_cast<const Trigger &>(object).getBoundingBox();
+			if (box.empty())
+				return false;
+
+			box.getMin(minX, minY, z);
+			box.getMax(maxX, maxY, z);
+			return true;
+		}
+
+		case kObjectTypeDoor:
+		case kObjectTypePlaceable: {
+			// Without a walkmesh, a situated object can't collide with anything
+			const Common::BoundingBox box = static_cast<const Situated &>(object).getWalkmeshBoundingBox();
+			if (box.empty())
+				return false;
+
+			box.getMin(minX, minY, z);
+			box.getMax(maxX, maxY, z);
+			return true;
+		}
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
+void Area::findSpatial(float minX, float minY, float maxX, float maxY,
+                       std::vector<KotOR::Object *> &objects) const {
+
+	std::vector<void *> found;
+	_spatialHash.find(minX, minY, maxX, maxY, found);
+
+	objects.clear();
+	objects.reserve(found.size());
+
+	for (std::vector<void *>::const_iterator f = found.begin(); f != found.end(); ++f)
+		objects.push_back(static_cast<KotOR::Object *>(*f));
+}
+
 void Area::loadWaypoints(const Aurora::GFF3List &list) {
 	for (Aurora::GFF3List::const_iterator w = list.begin(); w != list.end(); ++w) {
 		Waypoint *waypoint = new Waypoint(**w);
@@ -461,6 +615,18 @@ void Area::loadSounds(const Aurora::GFF3List &list) {
 	}
 }
 
+void Area::preloadSounds() {
+	std::vector<Common::UString> sounds;
+	for (std::list<Situated *>::const_iterator s = _situatedObjects.begin(); s != _situatedObjects.end(); ++s)
+		(*s)->getSounds(sounds);
+
+	// Many objects share the same sounds
+	std::sort(sounds.begin(), sounds.end());
+	sounds.erase(std::unique(sounds.begin(), sounds.end()), sounds.end());
+
+	::Engines::preloadSounds(sounds);
+}
+
 void Area::addEvent(const Events::Event &event) {
 	_eventQueue.push_back(event);
 }
@@ -585,11 +751,18 @@ float Area::evaluateElevation(Object *object, float x, float y, bool doHighlight
 }
 
 bool Area::testCollision(const glm::vec3 &orig, const glm::vec3 &dest) const {
-	for (std::list<Situated *>::const_iterator s = _situatedObjects.begin();
-			s != _situatedObjects.end(); ++s) {
-		if ((*s)->testCollision(orig, dest))
+	std::vector<KotOR::Object *> objects;
+	findSpatial(MIN(orig.x, dest.x), MIN(orig.y, dest.y), MAX(orig.x, dest.x), MAX(orig.y, dest.y), objects);
+
+	for (std::vector<KotOR::Object *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
+		const ObjectType type = (*o)->getType();
+		if ((type != kObjectTypeDoor) && (type != kObjectTypePlaceable))
+			continue;
+
+		if (static_cast<const Situated *>(*o)->testCollision(orig, dest))
 			return true;
 	}
+
 	return false;
 }
 
@@ -619,10 +792,14 @@ void Area::toggleTriggers() {
 void Area::evaluateTriggers(float x, float y) {
 	Trigger *trigger = 0;
 
-	for (std::vector<Trigger *>::iterator it = _triggers.begin();
-			it != _triggers.end();
-			++it) {
-		Trigger *t = *it;
+	std::vector<KotOR::Object *> objects;
+	findSpatial(x, y, x, y, objects);
+
+	for (std::vector<KotOR::Object *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
+		if ((*o)->getType() != kObjectTypeTrigger)
+			continue;
+
+		Trigger *t = static_cast<Trigger *>(*o);
 		if (t->contains(x, y)) {
 			trigger = t;
 			break;
@@ -660,6 +837,13 @@ void Area::notifyObjectMoved(Object &o) {
 	float x, y, z;
 	o.getPosition(x, y, z);
 	o.setRoom(getRoomAt(x, y));
+
+	ProxyMap::iterator proxy = _spatialProxies.find(&o);
+	if (proxy != _spatialProxies.end()) {
+		float minX, minY, maxX, maxY;
+		if (getSpatialBounds(o, minX, minY, maxX, maxY))
+			_spatialHash.update(proxy->second, minX, minY, maxX, maxY);
+	}
 }
 
 void Area::notifyPCMoved() {
@@ -726,12 +910,11 @@ KotOR::Object *Area::getActiveObject() {
 }
 
 KotOR::Object *Area::getObjectByTag(const Common::UString &tag) {
-	for (ObjectList::iterator o = _objects.begin();
-			o != _objects.end(); ++o) {
-		if ((*o)->getTag().stricmp(tag) == 0)
-			return *o;
-	}
-	return 0;
+	TagMap::const_iterator t = _tagMap.find(tag.toLower());
+	if (t == _tagMap.end())
+		return 0;
+
+	return t->second.front();
 }
 
 void Area::processCreaturesActions(float dt) {
@@ -757,6 +940,8 @@ void Area::removeObject(KotOR::Object *object) {
 	if (object == _activeTrigger)
 		_activeTrigger = 0;
 
+	removeFromIndices(*object);
+
 	if (!object->isStatic()) {
 		const std::list<uint32> &ids = object->getIDs();
 
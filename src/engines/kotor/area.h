@@ -29,9 +29,14 @@
 #include <list>
 #include <map>
 
+#include <boost/unordered/unordered_map.hpp>
+
 #include "src/common/ptrlist.h"
+#include "src/common/ptrvector.h"
 #include "src/common/ustring.h"
 #include "src/common/mutex.h"
+#include "src/common/spatialhash.h"
+#include "src/common/scopedptr.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/lytfile.h"
@@ -45,6 +50,10 @@
 #include "src/engines/kotor/object.h"
 #include "src/engines/kotor/trigger.h"
 
+namespace Common {
+	class ThreadPool;
+}
+
 namespace Engines {
 
 namespace KotOR {
@@ -64,7 +73,14 @@ class Creature;
  */
 class Area : public KotOR::Object, public Events::Notifyable {
 public:
-	Area(Module &module, const Common::UString &resRef);
+	/** Load an area.
+	 *
+	 *  @param module The module this area is in.
+	 *  @param resRef The resref of the area.
+	 *  @param progress If given, called with the loading progress, from 0 to 100.
+	 */
+	Area(Module &module, const Common::UString &resRef,
+	     const LoadingProgressFunc &progress = LoadingProgressFunc());
 	~Area();
 
 	// General properties
@@ -162,6 +178,10 @@ private:
 	typedef Common::PtrList<KotOR::Object> ObjectList;
 	typedef std::map<uint32, KotOR::Object *> ObjectMap;
 
+	typedef boost::unordered_map<Common::UString, std::vector<KotOR::Object *>,
+	                             Common::hashUStringCaseSensitive> TagMap;
+	typedef std::map<const KotOR::Object *, uint32> ProxyMap;
+
 
 	Module *_module; ///< The module this area is in.
 
@@ -202,6 +222,18 @@ private:
 	ObjectList _objects;   ///< List of all objects in the area.
 	ObjectMap  _objectMap; ///< Map of all non-static objects in the area.
 
+	/** All objects in the area, by their lowercased tag, in the order they were loaded. */
+	TagMap _tagMap;
+
+	/** The triggers and situated objects in the area, by their position.
+	 *
+	 *  Creatures aren't included. They are moved by scripts, conversations
+	 *  and cutscenes alike, and nothing looks for them by position yet.
+	 */
+	Common::SpatialHash _spatialHash;
+	/** The proxy of each object within the spatial hash. */
+	ProxyMap _spatialProxies;
+
 	std::vector<Creature *> _creatures;
 
 	/** The currently active (highlighted) object. */
@@ -227,17 +259,19 @@ private:
 	// Loading helpers
 
 	void clear();
-	void load();
+	void load(const LoadingProgressFunc &progress);
 
 	void loadLYT();
 	void loadVIS();
+	void loadGFF(Common::ScopedPtr<Aurora::GFF3File> &gff, Aurora::FileType type, uint32 id);
 
 	void loadARE(const Aurora::GFF3Struct &are);
 	void loadGIT(const Aurora::GFF3Struct &git);
 
 	void loadCameraStyle(uint32 id);
 
-	void loadRooms();
+	void loadRooms(Common::ThreadPool &pool, Common::PtrVector<Room> &rooms);
+	void loadRoom(Room *&room, const Aurora::LYTFile::Room &lytRoom);
 
 	void loadProperties(const Aurora::GFF3Struct &props);
 
@@ -250,8 +284,24 @@ private:
 	void loadSounds    (const Aurora::GFF3List &list);
 	void loadTriggers  (const Aurora::GFF3List &list);
 
+	/** Decode the sounds of the situated objects ahead of time, so they're ready when triggered. */
+	void preloadSounds();
+
 	void unload();
 
+	// Object indices
+
+	void addToIndices(KotOR::Object &object);
+	void removeFromIndices(KotOR::Object &object);
+
+	/** Return the rectangle an object occupies in the spatial hash. */
+	static bool getSpatialBounds(const KotOR::Object &object,
+	                             float &minX, float &minY, float &maxX, float &maxY);
+
+	/** Find all objects in the spatial hash overlapping the rectangle. */
+	void findSpatial(float minX, float minY, float maxX, float maxY,
+	                 std::vector<KotOR::Object *> &objects) const;
+
 	// Highlight / active helpers
 
 	void checkActive(int x = -1, int y = -1);
@@ -132,7 +132,7 @@ void GUIBackground::update() {
 bool GUIBackground::tryBackground(int width, int height) {
 	Common::UString name = Common::UString::format("%ux%u%s", width, height, _type.c_str());
 	if (ResMan.hasResource(name, Aurora::kResourceImage)) {
-		_texture = TextureMan.get(name);
+		_texture = TextureMan.get(name, Graphics::Aurora::TextureManager::kLoadGUI);
 
 		_vertexX1 = (_screenWidth - width) / 2;
 		_vertexX2 = _vertexX1 + width;
@@ -25,10 +25,9 @@
 #ifndef ENGINES_KOTOR_GUI_LOADSCREEN_LOADSCREEN_H
 #define ENGINES_KOTOR_GUI_LOADSCREEN_LOADSCREEN_H
 
-#include <boost/function.hpp>
-
 #include "src/common/thread.h"
 
+#include "src/engines/kotor/types.h"
 #include "src/engines/kotor/module.h"
 #include "src/engines/kotor/gui/gui.h"
 
@@ -36,8 +35,6 @@ namespace Engines {
 
 namespace KotOR {
 
-typedef boost::function<void(unsigned int)> LoadingProgressFunc;
-
 class LoadScreen : public GUI {
 public:
 	LoadScreen(const Common::UString &loadScreenName, Console *console = 0);
@@ -22,6 +22,8 @@
  *  The context needed to run a Star Wars: Knights of the Old Republic module.
  */
 
+#include <boost/bind.hpp>
+
 #include "src/common/util.h"
 #include "src/common/maths.h"
 #include "src/common/error.h"
@@ -67,6 +69,13 @@ namespace Engines {
 
 namespace KotOR {
 
+/** The loading progress once the module resources are available. The area takes up the rest. */
+static const unsigned int kLoadProgressResources = 10;
+
+static void setAreaLoadingProgress(const LoadingProgressFunc &progress, unsigned int areaProgress) {
+	progress(kLoadProgressResources + (areaProgress * (100 - kLoadProgressResources)) / 100);
+}
+
 bool Module::Action::operator<(const Action &s) const {
 	return timestamp < s.timestamp;
 }
@@ -137,7 +146,7 @@ void Module::loadModule(const Common::UString &module, const Common::UString &en
 
 	try {
 
-		load();
+		load(loadScreen.getLoadingProgressFunc());
 
 	} catch (Common::Exception &e) {
 		_module.clear();
@@ -202,11 +211,18 @@ void Module::showMenu() {
 	// TODO: Module::showMenu()
 }
 
-void Module::load() {
+void Module::load(const LoadingProgressFunc &progress) {
 	loadTexturePack();
 	loadResources();
 	loadIFO();
-	loadArea();
+
+	if (!progress) {
+		loadArea();
+		return;
+	}
+
+	progress(kLoadProgressResources);
+	loadArea(boost::bind(&setAreaLoadingProgress, progress, _1));
 }
 
 void Module::loadResources() {
@@ -247,8 +263,8 @@ void Module::loadIFO() {
 	readScripts(*_ifo.getGFF());
 }
 
-void Module::loadArea() {
-	_area.reset(new Area(*this, _ifo.getEntryArea()));
+void Module::loadArea(const LoadingProgressFunc &progress) {
+	_area.reset(new Area(*this, _ifo.getEntryArea(), progress));
 }
 
 static const char * const texturePacks[3] = {
@@ -290,11 +290,11 @@ private:
 	// '---
 
 	// .--- Loading
-	void load();
+	void load(const LoadingProgressFunc &progress);
 
 	void loadResources();
 	void loadIFO();
-	void loadArea();
+	void loadArea(const LoadingProgressFunc &progress = LoadingProgressFunc());
 	// '---
 
 	/** Load the actual module. */
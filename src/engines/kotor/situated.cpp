@@ -89,6 +89,10 @@ void Situated::setWalkmeshInvisible(bool invisible) {
 	_walkmesh.setInvisible(invisible);
 }
 
+Common::BoundingBox Situated::getWalkmeshBoundingBox() const {
+	return _walkmesh.getBoundingBox();
+}
+
 void Situated::playAnimation(const Common::UString &anim, bool restart, float length, float speed) {
 	if (_model)
 		_model->playAnimation(anim, restart, length, speed);
@@ -118,6 +122,14 @@ const Common::UString &Situated::getConversation() const {
 	return _conversation;
 }
 
+void Situated::getSounds(std::vector<Common::UString> &sounds) const {
+	sounds.push_back(_soundOpened);
+	sounds.push_back(_soundClosed);
+	sounds.push_back(_soundDestroyed);
+	sounds.push_back(_soundUsed);
+	sounds.push_back(_soundLocked);
+}
+
 void Situated::load(const Aurora::GFF3Struct &instance, const Aurora::GFF3Struct *blueprint) {
 	// General properties
 
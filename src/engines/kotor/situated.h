@@ -25,9 +25,13 @@
 #ifndef ENGINES_KOTOR_SITUATED_H
 #define ENGINES_KOTOR_SITUATED_H
 
+#include <vector>
+
 #include "glm/vec3.hpp"
 
 #include "src/common/scopedptr.h"
+#include "src/common/ustring.h"
+#include "src/common/boundingbox.h"
 
 #include "src/aurora/types.h"
 
@@ -68,6 +72,9 @@ public:
 	/** Get the conversation for this object. */
 	const Common::UString &getConversation() const;
 
+	/** Add all sounds the situated object can make to the list. */
+	void getSounds(std::vector<Common::UString> &sounds) const;
+
 	// Positioning
 
 	/** Set the situated object's position. */
@@ -80,6 +87,9 @@ public:
 	virtual bool testCollision(const glm::vec3 &orig, const glm::vec3 &dest) const;
 	void setWalkmeshInvisible(bool invisible);
 
+	/** Return the bounding box around the situated object's walkmesh. */
+	Common::BoundingBox getWalkmeshBoundingBox() const;
+
 	void playAnimation(const Common::UString &anim,
 	                   bool restart = true,
 	                   float length = 0.0f,
@@ -25,6 +25,8 @@
 #ifndef ENGINES_KOTOR_TYPES_H
 #define ENGINES_KOTOR_TYPES_H
 
+#include <boost/function.hpp>
+
 namespace Engines {
 
 namespace KotOR {
@@ -197,6 +199,9 @@ enum ActionType {
 	kActionInvalid       = 65535
 };
 
+/** A function receiving the loading progress, from 0 to 100. */
+typedef boost::function<void(unsigned int)> LoadingProgressFunc;
+
 } // End of namespace KotOR
 
 } // End of namespace Engines
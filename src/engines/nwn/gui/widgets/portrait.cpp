@@ -228,7 +228,7 @@ void Portrait::setPortrait(const Common::UString &name) {
 	_texture.clear();
 	while (_texture.empty() && (curSize < kSizeMAX)) {
 		try {
-			_texture = TextureMan.get(name + kSuffix[curSize]);
+			_texture = TextureMan.get(name + kSuffix[curSize], Graphics::Aurora::TextureManager::kLoadGUI);
 		} catch (...) {
 			_texture.clear();
 		}
@@ -238,7 +238,7 @@ void Portrait::setPortrait(const Common::UString &name) {
 
 	if (_texture.empty()) {
 		try {
-			_texture = TextureMan.get(name);
+			_texture = TextureMan.get(name, Graphics::Aurora::TextureManager::kLoadGUI);
 		} catch (...) {
 			_texture.clear();
 		}
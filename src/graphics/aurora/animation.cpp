@@ -22,6 +22,8 @@
  *  An animation to be applied to a model.
  */
 
+#include <algorithm>
+
 #include "glm/gtc/type_ptr.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
@@ -35,6 +37,8 @@
 #include "src/graphics/aurora/modelnode.h"
 #include "src/graphics/aurora/animation.h"
 #include "src/graphics/aurora/animnode.h"
+#include "src/graphics/aurora/keyframetrack.h"
+#include "src/graphics/aurora/skinning.h"
 
 using Common::kDebugGraphics;
 
@@ -74,25 +78,62 @@ void Animation::setTransTime(float transtime) {
 void Animation::update(Model *model,
                        float UNUSED(lastFrame),
                        float nextFrame,
-                       const std::vector<ModelNode *> &modelNodeMap) {
+                       const std::vector<ModelNode *> &modelNodeMap,
+                       KeyFrameBatch &positions,
+                       KeyFrameBatch &orientations) {
 	// TODO: Also need to fire off associated events
 	//       for event in _events event->fire()
 
+	positions.clear();
+	orientations.clear();
+
+	/* Look up the key frames of all nodes first. Nodes that don't need to
+	 * interpolate between two key frames are updated directly. All others
+	 * are collected, and then interpolated all at once. */
 
 	float scale = model->getAnimationScale(_name);
 	for (NodeList::iterator n = nodeList.begin(); n != nodeList.end(); ++n) {
-		ModelNode *animNode = (*n)->_nodedata;
-		ModelNode *target = modelNodeMap[animNode->_nodeNumber];
+		const AnimNode &animNode = **n;
+
+		const uint16 nodeNumber = animNode._nodeNumber;
+
+		ModelNode *target = modelNodeMap[nodeNumber];
 		if (!target)
 			continue;
 
+		size_t frame;
+		float factor;
+
 		// Update position and orientation based on time
-		if (!animNode->_positionFrames.empty())
-			interpolatePosition(animNode, target, nextFrame, scale, model->_positionRelative);
-		if (!animNode->_orientationFrames.empty())
-			interpolateOrientation(animNode, target, nextFrame);
+		const KeyFrameTrack &position = animNode._positionTrack;
+		if (!position.empty()) {
+			if (position.find(nextFrame, frame, factor))
+				positions.add(position, frame, factor, nodeNumber);
+			else
+				applyPosition(target, position.getValue(frame, 0), position.getValue(frame, 1),
+				              position.getValue(frame, 2), scale, model->_positionRelative);
+		}
+
+		const KeyFrameTrack &orientation = animNode._orientationTrack;
+		if (!orientation.empty()) {
+			if (orientation.find(nextFrame, frame, factor))
+				orientations.add(orientation, frame, factor, nodeNumber);
+			else
+				applyOrientation(target, orientation.getValue(frame, 0), orientation.getValue(frame, 1),
+				                 orientation.getValue(frame, 2), orientation.getValue(frame, 3));
+		}
 	}
 
+	positions.interpolatePositions();
+	for (size_t i = 0; i < positions.size(); i++)
+		applyPosition(modelNodeMap[positions.getTag(i)], positions.getResult(i, 0), positions.getResult(i, 1),
+		              positions.getResult(i, 2), scale, model->_positionRelative);
+
+	orientations.interpolateOrientations();
+	for (size_t i = 0; i < orientations.size(); i++)
+		applyOrientation(modelNodeMap[orientations.getTag(i)], orientations.getResult(i, 0),
+		                 orientations.getResult(i, 1), orientations.getResult(i, 2), orientations.getResult(i, 3));
+
 	if (model->_skinned)
 		updateSkinnedModel(model);
 }
@@ -106,47 +147,12 @@ bool Animation::hasNode(const Common::UString &node) const {
 	return (nodeMap.find(node) != nodeMap.end());
 }
 
-ModelNode *Animation::getNode(const Common::UString &node) {
-	NodeMap::iterator n = nodeMap.find(node);
-	if (n == nodeMap.end())
-		return 0;
-
-	return n->second->_nodedata;
-}
-
-const ModelNode *Animation::getNode(const Common::UString &node) const {
-	NodeMap::const_iterator n = nodeMap.find(node);
-	if (n == nodeMap.end())
-		return 0;
-
-	return n->second->_nodedata;
-}
-
 const std::list<AnimNode *> &Animation::getNodes() const {
 	return nodeList;
 }
 
-/** Return the dot product of two quaternions. */
-static float dotQuaternion(float x1, float y1, float z1, float q1,
-                           float x2, float y2, float z2, float q2) {
-
-	return x1 * x2 + y1 * y2 + z1 * z2 + q1 * q2;
-}
-
-/** Normalize a quaternion. */
-static void normQuaternion(float  xIn , float  yIn , float  zIn , float  qIn,
-                           float &xOut, float &yOut, float &zOut, float &qOut) {
-
-	const float magnitude = sqrt(dotQuaternion(xIn, yIn, zIn, qIn, xIn, yIn, zIn, qIn));
-
-	xOut = xIn / magnitude;
-	yOut = yIn / magnitude;
-	zOut = zIn / magnitude;
-	qOut = qIn / magnitude;
-}
-
-void Animation::interpolatePosition(ModelNode *animNode, ModelNode *target, float time, float scale,
-                                    bool relative) const {
+void Animation::applyPosition(ModelNode *target, float x, float y, float z, float scale,
+                              bool relative) const {
 	float dx = 0;
 	float dy = 0;
 	float dz = 0;
@@ -157,168 +163,56 @@ void Animation::interpolatePosition(ModelNode *animNode, ModelNode *target, floa
 		dz = pos.z;
 	}
 
-	// If only one keyframe, don't interpolate, just set the only position
-	if (animNode->_positionFrames.size() == 1) {
-		const PositionKeyFrame &pos = animNode->_positionFrames[0];
-		target->setBufferedPosition((dx + pos.x) * scale,
-		                            (dy + pos.y) * scale,
-		                            (dz + pos.z) * scale);
-		return;
-	}
-
-	size_t lastFrame = 0;
-	for (size_t i = 0; i < animNode->_positionFrames.size(); i++) {
-		const PositionKeyFrame &pos = animNode->_positionFrames[i];
-		if (pos.time >= time)
-			break;
-
-		lastFrame = i;
-	}
-
-	const PositionKeyFrame &last = animNode->_positionFrames[lastFrame];
-	if (lastFrame + 1 >= animNode->_positionFrames.size() || last.time >= time) {
-		target->setBufferedPosition((dx + last.x) * scale,
-		                            (dy + last.y) * scale,
-		                            (dz + last.z) * scale);
-		return;
-	}
-
-	const PositionKeyFrame &next = animNode->_positionFrames[lastFrame + 1];
-
-	const float f = (time - last.time) / (next.time - last.time);
-	const float x = f * next.x + (1.0f - f) * last.x;
-	const float y = f * next.y + (1.0f - f) * last.y;
-	const float z = f * next.z + (1.0f - f) * last.z;
-
 	target->setBufferedPosition((dx + x) * scale,
 	                            (dy + y) * scale,
 	                            (dz + z) * scale);
 }
 
-void Animation::interpolateOrientation(ModelNode *animNode, ModelNode *target, float time) const {
-	// If only one keyframe, don't interpolate just set the only orientation
-	if (animNode->_orientationFrames.size() == 1) {
-		const QuaternionKeyFrame &ori = animNode->_orientationFrames[0];
-		target->setBufferedOrientation(ori.x, ori.y, ori.z, Common::rad2deg(acos(ori.q) * 2.0));
-		return;
-	}
-
-	size_t lastFrame = 0;
-	for (size_t i = 0; i < animNode->_orientationFrames.size(); i++) {
-		const QuaternionKeyFrame &ori = animNode->_orientationFrames[i];
-		if (ori.time >= time)
-			break;
-
-		lastFrame = i;
-	}
-
-	const QuaternionKeyFrame &last = animNode->_orientationFrames[lastFrame];
-	if (lastFrame + 1 >= animNode->_orientationFrames.size() || last.time >= time) {
-		target->setBufferedOrientation(last.x, last.y, last.z, Common::rad2deg(acos(last.q) * 2.0));
-		return;
-	}
-
-	const QuaternionKeyFrame &next = animNode->_orientationFrames[lastFrame + 1];
-
-	const float f = (time - last.time) / (next.time - last.time);
-
-	/* If the angle is > 90°, we need to flip the direction of one quaternion to
-	   get a smooth transition instead of wild jumps. */
-	const float angle = acos(dotQuaternion(last.x, last.y, last.z, last.q, next.x, next.y, next.z, next.q));
-	const float dir   = (angle >= (M_PI / 2)) ? -1.0f : 1.0f;
-
-	float x = f * dir * next.x + (1.0f - f) * last.x;
-	float y = f * dir * next.y + (1.0f - f) * last.y;
-	float z = f * dir * next.z + (1.0f - f) * last.z;
-	float q = f * dir * next.q + (1.0f - f) * last.q;
-
-	// Normalize the result for slightly better results
-	normQuaternion(x, y, z, q, x, y, z, q);
-
+void Animation::applyOrientation(ModelNode *target, float x, float y, float z, float q) const {
 	target->setBufferedOrientation(x, y, z, Common::rad2deg(acos(q) * 2.0));
 }
 
-static void multiply(const float *v, const glm::mat4 &m, float *rv) {
-	rv[0]   = v[0] * m[0][0] + v[1] * m[1][0] + v[2] * m[2][0] + m[3][0];
-	rv[1]   = v[0] * m[0][1] + v[1] * m[1][1] + v[2] * m[2][1] + m[3][1];
-	rv[2]   = v[0] * m[0][2] + v[1] * m[1][2] + v[2] * m[2][2] + m[3][2];
-	float w = v[0] * m[0][3] + v[1] * m[1][3] + v[2] * m[2][3] + m[3][3];
-	rv[0] /= w;
-	rv[1] /= w;
-	rv[2] /= w;
+bool Animation::isSkinnedNode(const ModelNode *node) {
+	if (!node->_mesh || !node->_mesh->skin)
+		return false;
+
+	// TODO:
+	// Handmaiden model in KotOR 2 has a node that is different
+	// from all the others in that it's parent is a bone. Because
+	// of this it has transformations applied twice to it: by the
+	// renderer and by the skeletal animation routine. This should
+	// probably be handled the other way.
+	if (node->_parent && node->_parent->_name.stricmp("f_jaw_g") == 0)
+		return false;
+
+	return true;
 }
 
 void Animation::updateSkinnedModel(Model *model) {
 	const std::list<ModelNode *> &nodes = model->getNodes();
+
+	// Find all bones moving skinned nodes, and update their transformations once
+	std::vector<ModelNode *> bones;
 	for (std::list<ModelNode *>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
-		ModelNode *node = *it;
-		if (!node->_mesh || !node->_mesh->skin)
+		if (!isSkinnedNode(*it))
 			continue;
 
-		// TODO:
-		// Handmaiden model in KotOR 2 has a node that is different
-		// from all the others in that it's parent is a bone. Because
-		// of this it has transformations applied twice to it: by the
-		// renderer and by the skeletal animation routine. This should
-		// probably be handled the other way.
-		if (node->_parent && node->_parent->_name.stricmp("f_jaw_g") == 0)
-			continue;
+		const ModelNode::Skin *skin = (*it)->_mesh->skin;
+		for (std::vector<ModelNode *>::const_iterator b = skin->boneNodeMap.begin(); b != skin->boneNodeMap.end(); ++b)
+			if (*b)
+				bones.push_back(*b);
+	}
 
-		glm::mat4 invTransform = node->_invBindPose;
-		glm::mat4 transform = glm::inverse(invTransform);
+	std::sort(bones.begin(), bones.end());
+	bones.erase(std::unique(bones.begin(), bones.end()), bones.end());
 
-		ModelNode::Skin *skin = node->_mesh->skin;
+	for (std::vector<ModelNode *>::iterator b = bones.begin(); b != bones.end(); ++b)
+		(*b)->computeAbsoluteTransform();
 
-		for (uint16 i = 0; i < skin->boneMappingCount; ++i) {
-			int index = static_cast<int>(skin->boneMapping[i]);
-			if (index != -1)
-				skin->boneNodeMap[index]->computeAbsoluteTransform();
-		}
-
-		// TODO: Use vertex shader
-
-		ModelNode::MeshData *meshData = node->_mesh->data;
-		VertexBuffer &vertexBuffer = *(meshData->rawMesh->getVertexBuffer());
-		uint32 vertexCount = vertexBuffer.getCount();
-
-		std::vector<float> &vcb = node->_vertexCoordsBuffer;
-		vcb.resize(3 * vertexCount);
-		float *v = &vcb[0];
-
-		float *iv = &meshData->initialVertexCoords[0];
-		float *boneWeights = &skin->boneWeights[0];
-		float *boneMappingId = &skin->boneMappingId[0];
-
-		for (uint32 i = 0; i < vertexCount; ++i) {
-			v[0] = 0;
-			v[1] = 0;
-			v[2] = 0;
-			for (uint8 j = 0; j < 4; ++j) {
-				int index = static_cast<int>(boneMappingId[j]);
-				if (index != -1) {
-					float rv[3];
-					float tv[3];
-					const glm::mat4 &invBindPose = skin->boneNodeMap[index]->_invBindPose;
-					const glm::mat4 &boneTransform = skin->boneNodeMap[index]->_absoluteTransform;
-
-					multiply(iv, transform, rv);
-					multiply(rv, invBindPose, tv);
-					multiply(tv, boneTransform, rv);
-					multiply(rv, invTransform, tv);
-
-					v[0] += tv[0] * boneWeights[j];
-					v[1] += tv[1] * boneWeights[j];
-					v[2] += tv[2] * boneWeights[j];
-				}
-			}
-			v += 3;
-			iv += 3;
-			boneWeights += 4;
-			boneMappingId += 4;
-		}
-
-		node->_vertexCoordsBuffered = true;
-	}
+	std::vector<glm::mat4> palette;
+	for (std::list<ModelNode *>::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+		if (isSkinnedNode(*it))
+			updateSkinnedNode(*it, palette);
 
 	for (std::map<Common::UString, Model *>::iterator m = model->_attachedModels.begin();
 			m != model->_attachedModels.end(); ++m) {
@@ -328,6 +222,41 @@ void Animation::updateSkinnedModel(Model *model) {
 	}
 }
 
+void Animation::updateSkinnedNode(ModelNode *node, std::vector<glm::mat4> &palette) {
+	const glm::mat4 &invTransform = node->_invBindPose;
+	const glm::mat4 transform = glm::inverse(invTransform);
+
+	const ModelNode::Skin *skin = node->_mesh->skin;
+
+	/* Combine all transformations of a vertex by a bone into one matrix:
+	 * into the bone's space at bind time, out of it again with its current
+	 * transformation, and back into the space of the node. */
+	palette.resize(skin->boneNodeMap.size());
+	for (size_t i = 0; i < skin->boneNodeMap.size(); i++) {
+		const ModelNode *bone = skin->boneNodeMap[i];
+		if (!bone) {
+			palette[i] = glm::mat4(0.0f);
+			continue;
+		}
+
+		palette[i] = invTransform * bone->_absoluteTransform * bone->_invBindPose * transform;
+	}
+
+	// TODO: Use vertex shader
+
+	ModelNode::MeshData *meshData = node->_mesh->data;
+	VertexBuffer &vertexBuffer = *(meshData->rawMesh->getVertexBuffer());
+	uint32 vertexCount = vertexBuffer.getCount();
+
+	std::vector<float> &vcb = node->_vertexCoordsBuffer;
+	vcb.resize(3 * vertexCount);
+
+	skinVertices(&vcb[0], &meshData->initialVertexCoords[0], &skin->boneMappingId[0], &skin->boneWeights[0],
+	             vertexCount, palette.empty() ? 0 : &palette[0], palette.size());
+
+	node->_vertexCoordsBuffered = true;
+}
+
 } // End of namespace Aurora
 
 } // End of namespace Graphics
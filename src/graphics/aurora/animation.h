@@ -26,8 +26,11 @@
 #define GRAPHICS_AURORA_ANIMATION_H
 
 #include <list>
+#include <vector>
 #include <map>
 
+#include "glm/mat4x4.hpp"
+
 #include "src/common/ustring.h"
 #include "src/common/boundingbox.h"
 
@@ -46,6 +49,7 @@ namespace Graphics {
 namespace Aurora {
 
 class AnimNode;
+class KeyFrameBatch;
 
 class Animation {
 public:
@@ -62,8 +66,17 @@ public:
 
 	void setTransTime(float transtime);
 
-	/** Update the model position and orientation */
-	void update(Model *model, float lastFrame, float nextFrame, const std::vector<ModelNode *> &modelNodeMap);
+	/** Update the model position and orientation.
+	 *
+	 *  @param model        The model to update.
+	 *  @param lastFrame    The time into the animation of the last update.
+	 *  @param nextFrame    The time into the animation to update the model to.
+	 *  @param modelNodeMap The nodes of the model, indexed by node number.
+	 *  @param positions    Scratch space for interpolating the positions.
+	 *  @param orientations Scratch space for interpolating the orientations.
+	 */
+	void update(Model *model, float lastFrame, float nextFrame, const std::vector<ModelNode *> &modelNodeMap,
+	            KeyFrameBatch &positions, KeyFrameBatch &orientations);
 
 	// Nodes
 
@@ -72,10 +85,6 @@ public:
 	/** Does the specified node exist? */
 	bool hasNode(const Common::UString &node) const;
 
-	/** Get the specified node. */
-	ModelNode *getNode(const Common::UString &node);
-	/** Get the specified node. */
-	const ModelNode *getNode(const Common::UString &node) const;
 	/** Get all animation nodes. */
 	const std::list<AnimNode *> &getNodes() const;
 
@@ -93,12 +102,16 @@ protected:
 	float _transtime;
 
 private:
-	void interpolatePosition(ModelNode *animNode, ModelNode *target, float time, float scale,
-	                         bool relative) const;
-	void interpolateOrientation(ModelNode *animNode, ModelNode *target, float time) const;
+	void applyPosition(ModelNode *target, float x, float y, float z, float scale, bool relative) const;
+	void applyOrientation(ModelNode *target, float x, float y, float z, float q) const;
+
+	/** Is this a skinned node whose vertices need to be transformed? */
+	static bool isSkinnedNode(const ModelNode *node);
 
 	/** Transform vertices for each node of the specified model based on current animation. */
 	void updateSkinnedModel(Model *model);
+	/** Transform the vertices of a skinned node by its current bone transformations. */
+	void updateSkinnedNode(ModelNode *node, std::vector<glm::mat4> &palette);
 };
 
 } // End of namespace Aurora
@@ -131,7 +131,7 @@ void AnimationChannel::manageAnimations(float dt) {
 
 	// The loop of the animation ended: make sure to play the last frame
 	if (lastFrame < _animationLoopLength && nextFrame >= _animationLoopLength) {
-		_currentAnimation->update(_model, lastFrame, _animationLoopLength, _modelNodeMap);
+		_currentAnimation->update(_model, lastFrame, _animationLoopLength, _modelNodeMap, _positionBatch, _orientationBatch);
 
 		_animationTime += dt;
 		_animationLoopTime = _animationLoopLength;
@@ -146,7 +146,7 @@ void AnimationChannel::manageAnimations(float dt) {
 		_nextAnimation = 0;
 
 		if (_currentAnimation)
-			_currentAnimation->update(_model, 0.0f, 0.0f, _modelNodeMap);
+			_currentAnimation->update(_model, 0.0f, 0.0f, _modelNodeMap, _positionBatch, _orientationBatch);
 
 		_model->createBound();
 		_manageSem.unlock();
@@ -155,7 +155,7 @@ void AnimationChannel::manageAnimations(float dt) {
 
 	// Start the next loop of the animation
 	if (lastFrame >= _animationLoopLength) {
-		_currentAnimation->update(_model, 0.0f, 0.0f, _modelNodeMap);
+		_currentAnimation->update(_model, 0.0f, 0.0f, _modelNodeMap, _positionBatch, _orientationBatch);
 
 		lastFrame = 0.0f;
 		nextFrame = _animationSpeed * dt;
@@ -163,8 +163,10 @@ void AnimationChannel::manageAnimations(float dt) {
 		_model->createBound();
 	}
 
-	// Update the animation
-	_currentAnimation->update(_model, lastFrame, nextFrame, _modelNodeMap);
+	/* Update the animation. The animation doesn't depend on the previous
+	 * frames, so models that can't be seen right now just keep their time. */
+	if (!_model->isCulled())
+		_currentAnimation->update(_model, lastFrame, nextFrame, _modelNodeMap, _positionBatch, _orientationBatch);
 
 	_animationTime += dt;
 	_animationLoopTime = nextFrame;
@@ -223,7 +225,7 @@ void AnimationChannel::makeModelNodeMap() {
 
 	for (std::list<AnimNode *>::const_iterator n = animNodes.begin();
 			n != animNodes.end(); ++n) {
-		int nodeNumber = (*n)->getNodeData()->getNodeNumber();
+		int nodeNumber = (*n)->getNodeNumber();
 		if (nodeNumber > maxNodeNumber)
 			maxNodeNumber = nodeNumber;
 	}
@@ -237,9 +239,8 @@ void AnimationChannel::makeModelNodeMap() {
 
 	for (std::list<AnimNode *>::const_iterator an = animNodes.begin();
 			an != animNodes.end(); ++an) {
-		ModelNode *animNode = (*an)->getNodeData();
-		int nodeNumber = animNode->getNodeNumber();
-		const Common::UString &animNodeName = animNode->getName();
+		int nodeNumber = (*an)->getNodeNumber();
+		const Common::UString &animNodeName = (*an)->getName();
 
 		// Search for the corresponding node in this model
 		Model::NodeMap::iterator n = _model->_currentState->nodeMap.find(animNodeName);
@@ -30,6 +30,8 @@
 
 #include "src/common/mutex.h"
 
+#include "src/graphics/aurora/keyframetrack.h"
+
 namespace Graphics {
 
 namespace Aurora {
@@ -92,6 +94,8 @@ private:
 	float _animationLoopTime; ///< The time the current loop of the current animation has played.
 	DefaultAnimations _defaultAnimations;
 	std::vector<ModelNode *> _modelNodeMap;
+	KeyFrameBatch _positionBatch;    ///< Scratch space for interpolating node positions.
+	KeyFrameBatch _orientationBatch; ///< Scratch space for interpolating node orientations.
 	Common::Semaphore _manageSem;
 
 	void playDefaultAnimationInternal();
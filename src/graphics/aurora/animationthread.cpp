@@ -22,14 +22,15 @@
  *  Dedicated animation thread.
  */
 
-#include "glm/gtc/type_ptr.hpp"
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
 
+#include "src/common/util.h"
+#include "src/common/ustring.h"
 #include "src/common/threads.h"
 
 #include "src/events/events.h"
 
-#include "src/graphics/camera.h"
-
 #include "src/graphics/aurora/animationthread.h"
 #include "src/graphics/aurora/model.h"
 
@@ -37,19 +38,69 @@ namespace Graphics {
 
 namespace Aurora {
 
+/** The number of extra threads animating models, next to the animation thread itself. */
+static const size_t kAnimationWorkerCount = 3;
+/** Timeout in ms between checking whether a worker thread should end. */
+static const uint32 kWorkerTimeout = 100;
+
+class AnimationThread::Worker : public Common::Thread {
+public:
+	Worker() {
+	}
+
+	~Worker() {
+		destroyThread();
+	}
+
+	/** Start running a job. */
+	void run(const boost::function<void ()> &job) {
+		_job = job;
+
+		_start.unlock();
+	}
+
+	/** Wait for the current job to finish. */
+	void wait() {
+		_done.lock();
+	}
+
+private:
+	boost::function<void ()> _job;
+
+	Common::Semaphore _start;
+	Common::Semaphore _done;
+
+	void threadMethod() {
+		while (!_killThread.load(boost::memory_order_relaxed)) {
+			if (!_start.lock(kWorkerTimeout))
+				continue;
+
+			_job();
+
+			_done.unlock();
+		}
+	}
+};
+
+
 AnimationThread::PoolModel::PoolModel(Model *m)
 		: model(m),
-		  lastChanged(0),
-		  skippedCount(0) {
+		  lastChanged(0) {
 }
 
 AnimationThread::AnimationThread()
 		: _paused(true),
 		  _flushing(false),
+		  _now(0),
 		  _modelsSem(1),
 		  _registerSem(1) {
 }
 
+AnimationThread::~AnimationThread() {
+	// Stop the thread before the workers it might be using go away
+	destroyThread();
+}
+
 void AnimationThread::pause() {
 	_paused.store(true);
 	_modelsSem.lock();
@@ -61,9 +112,12 @@ void AnimationThread::resume() {
 }
 
 void AnimationThread::registerModel(Model *model) {
-	if (_paused.load())
+	if (_paused.load()) {
+		// Models might be loaded on several threads at once
+		_modelsSem.lock();
 		registerModelInternal(model);
-	else {
+		_modelsSem.unlock();
+	} else {
 		_registerSem.lock();
 		_registerQueue.push(model);
 		_registerSem.unlock();
@@ -71,13 +125,9 @@ void AnimationThread::registerModel(Model *model) {
 }
 
 void AnimationThread::unregisterModel(Model *model) {
-	if (_paused.load())
-		unregisterModelInternal(model);
-	else {
-		_modelsSem.lock();
-		unregisterModelInternal(model);
-		_modelsSem.unlock();
-	}
+	_modelsSem.lock();
+	unregisterModelInternal(model);
+	_modelsSem.unlock();
 }
 
 void AnimationThread::flush() {
@@ -95,6 +145,8 @@ void AnimationThread::flush() {
 }
 
 void AnimationThread::threadMethod() {
+	createWorkers();
+
 	while (!_killThread.load(boost::memory_order_relaxed)) {
 		if (EventMan.quitRequested())
 			break;
@@ -121,37 +173,74 @@ void AnimationThread::threadMethod() {
 			continue;
 		}
 
-		for (ModelList::iterator m = _models.begin();
-				m != _models.end();
-				++m) {
-			if (EventMan.quitRequested() || _paused.load())
-				break;
+		animateModels();
 
-			if (m->skippedCount < getNumIterationsToSkip(m->model)) {
-				++m->skippedCount;
-				continue;
-			} else
-				m->skippedCount = 0;
-
-			if (_flushing.load()) {
-				_modelsSem.unlock();
-				while (_flushing.load()) // Spin until flushing is complete
-					;
-				_modelsSem.lock();
-			}
+		_modelsSem.unlock();
 
-			uint32 now = EventMan.getTimestamp();
-			float dt = 0;
-			if (m->lastChanged > 0)
-				dt = (now - m->lastChanged) / 1000.f;
-			m->lastChanged = now;
+		EventMan.delay(10);
+	}
 
-			m->model->manageAnimations(dt);
+	_workers.clear();
+}
+
+void AnimationThread::createWorkers() {
+	for (size_t i = 0; i < kAnimationWorkerCount; i++) {
+		Worker *worker = new Worker;
+
+		if (!worker->createThread(Common::UString::format("Animations%u", (uint) i))) {
+			warning("Failed to create an animation worker thread");
+
+			delete worker;
+			break;
 		}
 
-		_modelsSem.unlock();
+		_workers.push_back(worker);
+	}
+}
 
-		EventMan.delay(10);
+void AnimationThread::animateModels() {
+	_now = EventMan.getTimestamp();
+
+	/* Animate a snapshot of the model list. During a flush, models might be
+	 * registered or unregistered, and that mustn't shift the models around
+	 * under the threads. */
+	for (ModelList::iterator m = _models.begin(); m != _models.end(); ++m)
+		_pass.add(&*m);
+
+	while (!_pass.done()) {
+		if (EventMan.quitRequested() || _paused.load())
+			break;
+
+		if (_flushing.load()) {
+			_modelsSem.unlock();
+			while (_flushing.load()) // Spin until flushing is complete
+				;
+			_modelsSem.lock();
+		}
+
+		const boost::function<void ()> job = boost::bind(&AnimationThread::animateClaimedModels, this);
+
+		for (Common::PtrVector<Worker>::iterator w = _workers.begin(); w != _workers.end(); ++w)
+			(*w)->run(job);
+
+		animateClaimedModels();
+
+		for (Common::PtrVector<Worker>::iterator w = _workers.begin(); w != _workers.end(); ++w)
+			(*w)->wait();
+	}
+
+	_pass.clear();
+}
+
+void AnimationThread::animateClaimedModels() {
+	PoolModel *m = 0;
+	while (!_flushing.load() && !_paused.load() && _pass.claim(m)) {
+		float dt = 0;
+		if (m->lastChanged > 0)
+			dt = (_now - m->lastChanged) / 1000.f;
+		m->lastChanged = _now;
+
+		m->model->manageAnimations(dt);
 	}
 }
 
@@ -164,23 +253,15 @@ void AnimationThread::registerModelInternal(Model *model) {
 }
 
 void AnimationThread::unregisterModelInternal(Model *model) {
-	ModelList::iterator m;
-	for (m = _models.begin(); m != _models.end(); ++m) {
-		if (m->model == model)
-			break;
-	}
-	if (m != _models.end())
-		_models.erase(m);
-}
-
-uint8 AnimationThread::getNumIterationsToSkip(Model *model) const {
-	const float *campos = CameraMan.getPosition();
-
-	float x, y, z;
-	model->getPosition(x, y, z);
+	for (ModelList::iterator m = _models.begin(); m != _models.end(); ++m) {
+		if (m->model == model) {
+			// We might be in the middle of a flush, with a pass still going on
+			_pass.remove(&*m);
 
-	float dist = glm::distance(glm::make_vec3(campos), glm::vec3(x, y, z));
-	return roundf(dist) / 8;
+			_models.erase(m);
+			return;
+		}
+	}
 }
 
 } // End of namespace Aurora
@@ -25,15 +25,16 @@
 #ifndef GRAPHICS_AURORA_ANIMATIONTHREAD_H
 #define GRAPHICS_AURORA_ANIMATIONTHREAD_H
 
+#include <list>
 #include <queue>
 
 #include <boost/atomic.hpp>
 
-#include "glm/vec3.hpp"
-#include "glm/vec4.hpp"
-
+#include "src/common/types.h"
+#include "src/common/ptrvector.h"
 #include "src/common/mutex.h"
 #include "src/common/thread.h"
+#include "src/common/workpass.h"
 
 namespace Graphics {
 
@@ -41,9 +42,24 @@ namespace Aurora {
 
 class Model;
 
+/** The thread animating all visible models.
+ *
+ *  Each loop iteration, every model in the processing pool is animated
+ *  once. The models are handed out one by one to the animation thread
+ *  and a few worker threads: whichever thread is done with its model
+ *  claims the next one still waiting. So a few expensive skinned models
+ *  don't hold up all others.
+ *
+ *  Whenever the render thread wants to flush, the threads stop claiming
+ *  new models. Once the flush is done, they continue where they left off.
+ *  Models registered in the meantime are only animated in the next loop
+ *  iteration, and models unregistered in the meantime are skipped.
+ */
 class AnimationThread : public Common::Thread {
 public:
 	AnimationThread();
+	~AnimationThread();
+
 	void pause();
 	void resume();
 
@@ -56,10 +72,11 @@ public:
 	void flush();
 	// '---
 private:
+	class Worker;
+
 	struct PoolModel {
 		Model *model;
 		uint32 lastChanged;
-		uint8 skippedCount; ///< Number of skipped loop iterations.
 
 		PoolModel(Model *m);
 	};
@@ -70,16 +87,28 @@ private:
 	ModelList _models;
 	ModelQueue _registerQueue;
 
+	Common::WorkPass<PoolModel> _pass; ///< The models animated in the current loop iteration.
+
+	Common::PtrVector<Worker> _workers; ///< The extra animation threads.
+
 	boost::atomic<bool> _paused;
 	boost::atomic<bool> _flushing;
 
+	uint32 _now; ///< The timestamp of the current loop iteration.
+
 	Common::Semaphore _modelsSem;   ///< Semaphore protecting access to the model list.
 	Common::Semaphore _registerSem; ///< Semaphore protecting access to the registration queue.
 
 	void threadMethod();
 	void registerModelInternal(Model *model);
 	void unregisterModelInternal(Model *model);
-	uint8 getNumIterationsToSkip(Model *model) const;
+
+	void createWorkers();
+
+	/** Animate all models once, on this thread and all workers. */
+	void animateModels();
+	/** Claim and animate models until all are done, or until we're interrupted. */
+	void animateClaimedModels();
 };
 
 } // End of namespace Aurora
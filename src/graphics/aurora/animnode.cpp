@@ -36,11 +36,24 @@ namespace Aurora {
 
 
 AnimNode::AnimNode(ModelNode *modelnode) :
-	_parent(0) {
-	// Actual data is loaded as a generic modelnode
-	_nodedata = modelnode;
-	if (modelnode)
-		_name = modelnode->getName();
+	_parent(0), _nodeNumber(0) {
+	/* Actual data is loaded as a generic modelnode. Only its identity and
+	 * key frames are kept, so that the animation doesn't depend on the
+	 * model it was read from and can be shared between models. */
+	if (!modelnode)
+		return;
+
+	_name       = modelnode->getName();
+	_nodeNumber = modelnode->getNodeNumber();
+
+	// Compile the key frames, for faster lookup and interpolation
+	for (std::vector<PositionKeyFrame>::const_iterator p = modelnode->_positionFrames.begin();
+	     p != modelnode->_positionFrames.end(); ++p)
+		_positionTrack.addKeyFrame(p->time, p->x, p->y, p->z);
+
+	for (std::vector<QuaternionKeyFrame>::const_iterator o = modelnode->_orientationFrames.begin();
+	     o != modelnode->_orientationFrames.end(); ++o)
+		_orientationTrack.addKeyFrame(o->time, o->x, o->y, o->z, o->q);
 }
 
 AnimNode::~AnimNode() {
@@ -62,8 +75,8 @@ const Common::UString &AnimNode::getName() const {
 	return _name;
 }
 
-ModelNode *AnimNode::getNodeData() {
-	return _nodedata;
+uint16 AnimNode::getNodeNumber() const {
+	return _nodeNumber;
 }
 
 } // End of namespace Aurora
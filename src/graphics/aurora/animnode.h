@@ -33,6 +33,7 @@
 #include "src/graphics/types.h"
 
 #include "src/graphics/aurora/types.h"
+#include "src/graphics/aurora/keyframetrack.h"
 
 namespace Graphics {
 
@@ -45,8 +46,8 @@ public:
 
 	/** Get the node's name. */
 	const Common::UString &getName() const;
-	/** Get the node's model node. */
-	ModelNode *getNodeData();
+	/** Get the number of the model node this node animates. */
+	uint16 getNodeNumber() const;
 
 protected:
 	// Animation *_animation; ///< The animation this node belongs to.
@@ -55,7 +56,10 @@ protected:
 	std::list<AnimNode *> _children; ///< The node's children.
 
 	Common::UString _name; ///< The node's name.
-	ModelNode *_nodedata;
+	uint16 _nodeNumber;    ///< The number of the model node this node animates.
+
+	KeyFrameTrack _positionTrack;    ///< The position key frames of the model node.
+	KeyFrameTrack _orientationTrack; ///< The orientation key frames of the model node.
 
 public:
 	// General helpers
@@ -0,0 +1,273 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Compiled key frame tracks of animated nodes, and their interpolation.
+ */
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+
+#include "src/common/util.h"
+
+#include "src/graphics/aurora/keyframetrack.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define KEYFRAMETRACK_HAVE_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+namespace Graphics {
+
+namespace Aurora {
+
+KeyFrameTrack::KeyFrameTrack() {
+}
+
+void KeyFrameTrack::clear() {
+	_times.clear();
+
+	for (size_t i = 0; i < 4; i++)
+		_values[i].clear();
+}
+
+void KeyFrameTrack::addKeyFrame(float time, float x, float y, float z, float w) {
+	_times.push_back(time);
+
+	_values[0].push_back(x);
+	_values[1].push_back(y);
+	_values[2].push_back(z);
+	_values[3].push_back(w);
+}
+
+bool KeyFrameTrack::empty() const {
+	return _times.empty();
+}
+
+size_t KeyFrameTrack::size() const {
+	return _times.size();
+}
+
+float KeyFrameTrack::getTime(size_t frame) const {
+	assert(frame < _times.size());
+
+	return _times[frame];
+}
+
+float KeyFrameTrack::getValue(size_t frame, size_t component) const {
+	assert((frame < _times.size()) && (component < 4));
+
+	return _values[component][frame];
+}
+
+bool KeyFrameTrack::find(float time, size_t &frame, float &factor) const {
+	frame  = 0;
+	factor = 0.0f;
+
+	// The first key frame at or after this time
+	const size_t next = std::lower_bound(_times.begin(), _times.end(), time) - _times.begin();
+
+	// Before the first or after the last key frame: use that one
+	if (next == 0)
+		return false;
+
+	frame = next - 1;
+	if (next >= _times.size())
+		return false;
+
+	factor = (time - _times[frame]) / (_times[next] - _times[frame]);
+	return true;
+}
+
+
+KeyFrameBatch::KeyFrameBatch() {
+}
+
+void KeyFrameBatch::clear() {
+	_tags.clear();
+	_factors.clear();
+
+	for (size_t i = 0; i < 4; i++) {
+		_from[i].clear();
+		_to[i].clear();
+	}
+}
+
+size_t KeyFrameBatch::size() const {
+	return _tags.size();
+}
+
+void KeyFrameBatch::add(const KeyFrameTrack &track, size_t frame, float factor, uint32 tag) {
+	assert((frame + 1) < track.size());
+
+	_tags.push_back(tag);
+	_factors.push_back(factor);
+
+	for (size_t i = 0; i < 4; i++) {
+		_from[i].push_back(track.getValue(frame    , i));
+		_to  [i].push_back(track.getValue(frame + 1, i));
+	}
+}
+
+uint32 KeyFrameBatch::getTag(size_t i) const {
+	assert(i < _tags.size());
+
+	return _tags[i];
+}
+
+float KeyFrameBatch::getResult(size_t i, size_t component) const {
+	assert((i < _tags.size()) && (component < 4));
+
+	return _results[component][i];
+}
+
+bool KeyFrameBatch::hasSIMDInterpolation() {
+#ifdef KEYFRAMETRACK_HAVE_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+void KeyFrameBatch::resizeResults() {
+	for (size_t i = 0; i < 4; i++)
+		_results[i].resize(_tags.size());
+}
+
+/* The SSE2 kernels calculate the exact same values as the scalar code,
+ * four interpolations at a time. They do the same operations in the
+ * same order, just on four lanes at once. */
+
+#ifdef KEYFRAMETRACK_HAVE_SSE2
+static inline __m128 lerpSSE2(__m128 f, __m128 g, __m128 from, __m128 to) {
+	return _mm_add_ps(_mm_mul_ps(f, to), _mm_mul_ps(g, from));
+}
+#endif
+
+void KeyFrameBatch::interpolatePositions(bool simd) {
+	resizeResults();
+
+	const size_t count = _tags.size();
+
+	size_t i = 0;
+
+#ifdef KEYFRAMETRACK_HAVE_SSE2
+	if (simd) {
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		for (; (i + 4) <= count; i += 4) {
+			const __m128 f = _mm_loadu_ps(&_factors[i]);
+			const __m128 g = _mm_sub_ps(one, f);
+
+			for (size_t c = 0; c < 3; c++)
+				_mm_storeu_ps(&_results[c][i], lerpSSE2(f, g, _mm_loadu_ps(&_from[c][i]), _mm_loadu_ps(&_to[c][i])));
+		}
+	}
+#else
+	UNUSED(simd);
+#endif
+
+	for (; i < count; i++) {
+		const float f = _factors[i];
+
+		for (size_t c = 0; c < 3; c++)
+			_results[c][i] = f * _to[c][i] + (1.0f - f) * _from[c][i];
+
+		_results[3][i] = 0.0f;
+	}
+}
+
+void KeyFrameBatch::interpolateOrientations(bool simd) {
+	resizeResults();
+
+	const size_t count = _tags.size();
+
+	size_t i = 0;
+
+#ifdef KEYFRAMETRACK_HAVE_SSE2
+	if (simd) {
+		const __m128 zero     = _mm_setzero_ps();
+		const __m128 one      = _mm_set1_ps(1.0f);
+		const __m128 minusOne = _mm_set1_ps(-1.0f);
+
+		for (; (i + 4) <= count; i += 4) {
+			__m128 from[4], to[4];
+			for (size_t c = 0; c < 4; c++) {
+				from[c] = _mm_loadu_ps(&_from[c][i]);
+				to  [c] = _mm_loadu_ps(&_to  [c][i]);
+			}
+
+			const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(from[0], to[0]),
+			                                                    _mm_mul_ps(from[1], to[1])),
+			                                         _mm_mul_ps(from[2], to[2])),
+			                              _mm_mul_ps(from[3], to[3]));
+
+			const __m128 flip = _mm_cmple_ps(dot, zero);
+			const __m128 dir  = _mm_or_ps(_mm_and_ps(flip, minusOne), _mm_andnot_ps(flip, one));
+
+			const __m128 f  = _mm_loadu_ps(&_factors[i]);
+			const __m128 fd = _mm_mul_ps(f, dir);
+			const __m128 g  = _mm_sub_ps(one, f);
+
+			__m128 v[4];
+			for (size_t c = 0; c < 4; c++)
+				v[c] = lerpSSE2(fd, g, from[c], to[c]);
+
+			const __m128 magnitude = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(v[0], v[0]),
+			                                                                      _mm_mul_ps(v[1], v[1])),
+			                                                           _mm_mul_ps(v[2], v[2])),
+			                                                _mm_mul_ps(v[3], v[3])));
+
+			for (size_t c = 0; c < 4; c++)
+				_mm_storeu_ps(&_results[c][i], _mm_div_ps(v[c], magnitude));
+		}
+	}
+#else
+	UNUSED(simd);
+#endif
+
+	for (; i < count; i++) {
+		const float dot = _from[0][i] * _to[0][i] + _from[1][i] * _to[1][i] +
+		                  _from[2][i] * _to[2][i] + _from[3][i] * _to[3][i];
+
+		/* If the angle is >= 90°, we need to flip the direction of one quaternion to
+		   get a smooth transition instead of wild jumps. */
+		const float dir = (dot <= 0.0f) ? -1.0f : 1.0f;
+
+		const float f  = _factors[i];
+		const float fd = f * dir;
+
+		float v[4];
+		for (size_t c = 0; c < 4; c++)
+			v[c] = fd * _to[c][i] + (1.0f - f) * _from[c][i];
+
+		// Normalize the result for slightly better results
+		const float magnitude = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]);
+
+		for (size_t c = 0; c < 4; c++)
+			_results[c][i] = v[c] / magnitude;
+	}
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
@@ -0,0 +1,136 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Compiled key frame tracks of animated nodes, and their interpolation.
+ */
+
+#ifndef GRAPHICS_AURORA_KEYFRAMETRACK_H
+#define GRAPHICS_AURORA_KEYFRAMETRACK_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** The key frames of one animated property of a node.
+ *
+ *  The key times and each component of the values are stored in separate,
+ *  contiguous arrays. The key times need to be sorted in ascending order.
+ */
+class KeyFrameTrack {
+public:
+	KeyFrameTrack();
+
+	/** Remove all key frames. */
+	void clear();
+
+	/** Add a key frame to the end of the track. */
+	void addKeyFrame(float time, float x, float y, float z, float w = 0.0f);
+
+	/** Does the track have no key frames? */
+	bool empty() const;
+	/** Return the number of key frames in the track. */
+	size_t size() const;
+
+	/** Return the time of a key frame. */
+	float getTime(size_t frame) const;
+	/** Return one component (0 to 3, x to w) of a key frame's value. */
+	float getValue(size_t frame, size_t component) const;
+
+	/** Find the key frames to use at this time.
+	 *
+	 *  @param  time   The time into the animation.
+	 *  @param  frame  The key frame before this time. Or the first or last one,
+	 *                 if the time is outside the track.
+	 *  @param  factor The interpolation factor between frame and frame + 1.
+	 *  @return true if the value needs to be interpolated between frame and frame + 1,
+	 *          false if the value of frame is used as is.
+	 */
+	bool find(float time, size_t &frame, float &factor) const;
+
+private:
+	std::vector<float> _times;
+	std::vector<float> _values[4];
+};
+
+/** A batch of interpolations between pairs of key frames.
+ *
+ *  The key frames of many nodes are collected first, and then all
+ *  interpolated at once. All data is kept as a structure of arrays,
+ *  so that the interpolation can run on several nodes at a time.
+ */
+class KeyFrameBatch {
+public:
+	KeyFrameBatch();
+
+	/** Remove all interpolations from the batch. */
+	void clear();
+
+	/** Return the number of interpolations in the batch. */
+	size_t size() const;
+
+	/** Add an interpolation between two key frames of a track.
+	 *
+	 *  @param track  The track to interpolate in.
+	 *  @param frame  The first key frame. It's interpolated towards frame + 1.
+	 *  @param factor The interpolation factor.
+	 *  @param tag    Any value the caller wants to find this interpolation by.
+	 */
+	void add(const KeyFrameTrack &track, size_t frame, float factor, uint32 tag);
+
+	/** Linearly interpolate the x, y and z components of all pairs. */
+	void interpolatePositions(bool simd = true);
+
+	/** Interpolate all pairs as orientation quaternions.
+	 *
+	 *  The quaternions are linearly interpolated along the shorter
+	 *  arc, and the result is normalized.
+	 */
+	void interpolateOrientations(bool simd = true);
+
+	/** Return the tag of an interpolation. */
+	uint32 getTag(size_t i) const;
+	/** Return one component (0 to 3, x to w) of an interpolation's result. */
+	float getResult(size_t i, size_t component) const;
+
+	/** Do we have SIMD interpolation kernels? */
+	static bool hasSIMDInterpolation();
+
+private:
+	std::vector<uint32> _tags;
+	std::vector<float> _factors;
+
+	std::vector<float> _from[4];
+	std::vector<float> _to[4];
+
+	std::vector<float> _results[4];
+
+	void resizeResults();
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_KEYFRAMETRACK_H
@@ -45,6 +45,7 @@ STOP_IGNORE_IMPLICIT_FALLTHROUGH
 #include "src/graphics/aurora/modelnode.h"
 #include "src/graphics/aurora/animnode.h"
 #include "src/graphics/aurora/animationchannel.h"
+#include "src/graphics/aurora/noderenderqueue.h"
 
 #include "src/graphics/shader/surfaceman.h"
 #include "src/graphics/shader/materialman.h"
@@ -97,9 +98,6 @@ Model::~Model() {
 		delete c->second;
 	}
 
-	for (AnimationMap::iterator a = _animationMap.begin(); a != _animationMap.end(); ++a)
-		delete a->second;
-
 	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s) {
 		for (NodeList::iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
 			delete *n;
@@ -159,6 +157,16 @@ bool Model::isIn(float x1, float y1, float z1, float x2, float y2, float z2) con
 	return _absoluteBoundBox.isIn(x1, y1, z1, x2, y2, z2);
 }
 
+bool Model::getWorldBound(glm::vec3 &min, glm::vec3 &max) const {
+	if ((_type == kModelTypeGUIFront) || _absoluteBoundBox.empty())
+		return false;
+
+	_absoluteBoundBox.getMin(min.x, min.y, min.z);
+	_absoluteBoundBox.getMax(max.x, max.y, max.z);
+
+	return true;
+}
+
 float Model::getWidth() const {
 	return _boundBox.getWidth() * _scale[0];
 }
@@ -315,6 +323,8 @@ void Model::createAbsolutePosition() {
 	_absoluteBoundBox = _boundBox;
 	_absoluteBoundBox.transform(_absolutePosition);
 	_absoluteBoundBox.absolutize();
+
+	updatePickable();
 }
 
 const std::list<Common::UString> &Model::getStates() const {
@@ -503,7 +513,7 @@ Animation *Model::getAnimation(const Common::UString &anim) {
 		return 0;
 	}
 
-	return n->second;
+	return n->second.get();
 }
 
 bool Model::hasAnimation(const Common::UString &anim) const {
@@ -639,6 +649,13 @@ void Model::render(RenderPass pass) {
 		return;
 	}
 
+	// When the world is rendered, the nodes are drawn later, batched together
+	NodeRenderQueue *queue = GfxMan.getNodeRenderQueue();
+	if (queue) {
+		queueGeometry(*queue, glm::mat4(), pass);
+		return;
+	}
+
 	// Apply our global model transformation
 	glTranslatef(_position[0], _position[1], _position[2]);
 	glRotatef(_orientation[3], _orientation[0], _orientation[1], _orientation[2]);
@@ -663,6 +680,44 @@ void Model::render(RenderPass pass) {
 	doDrawSkeleton();
 }
 
+void Model::queueGeometry(NodeRenderQueue &queue, const glm::mat4 &parentTransform, RenderPass pass) {
+	if (!_currentState || (pass > kRenderPassAll))
+		return;
+
+	if (pass == kRenderPassAll) {
+		queueGeometry(queue, parentTransform, kRenderPassOpaque);
+		queueGeometry(queue, parentTransform, kRenderPassTransparent);
+		return;
+	}
+
+	// Apply our global model transformation, the same way render() does
+
+	glm::mat4 transform = glm::translate(parentTransform, glm::vec3(_position[0], _position[1], _position[2]));
+
+	if ((_orientation[3] != 0.0f) &&
+	    ((_orientation[0] != 0.0f) || (_orientation[1] != 0.0f) || (_orientation[2] != 0.0f)))
+		transform = glm::rotate(transform, Common::deg2rad(_orientation[3]),
+		                        glm::vec3(_orientation[0], _orientation[1], _orientation[2]));
+
+	transform = glm::scale(transform, glm::vec3(_scale[0], _scale[1], _scale[2]));
+
+	// The bounding box and skeleton are still drawn right away
+	if (_drawBound || _drawSkeleton) {
+		glPushMatrix();
+		glMultMatrixf(glm::value_ptr(transform));
+
+		doDrawBound();
+		doDrawSkeleton();
+
+		glPopMatrix();
+	}
+
+	// Queue the nodes
+	for (NodeList::iterator n = _currentState->rootNodes.begin();
+	     n != _currentState->rootNodes.end(); ++n)
+		(*n)->queueGeometry(queue, transform, pass);
+}
+
 void Model::renderImmediate(const glm::mat4 &parentTransform) {
 	if (!_currentState) {
 		return;
@@ -873,6 +928,8 @@ void Model::createBound() {
 	_absoluteBoundBox = _boundBox;
 	_absoluteBoundBox.transform(_absolutePosition);
 	_absoluteBoundBox.absolutize();
+
+	updatePickable();
 }
 
 void Model::readValue(Common::SeekableReadStream &stream, uint32 &value) {
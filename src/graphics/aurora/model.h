@@ -39,6 +39,7 @@
 #include "src/graphics/renderable.h"
 
 #include "src/graphics/aurora/modelnode.h"
+#include "src/graphics/aurora/modelprototype.h"
 #include "src/graphics/aurora/types.h"
 
 #include "src/graphics/shader/shaderrenderable.h"
@@ -95,6 +96,9 @@ public:
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with model's bounding box? */
 	bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Get the model's bounding box in world space. */
+	bool getWorldBound(glm::vec3 &min, glm::vec3 &max) const;
+
 
 	// Positioning
 
@@ -187,6 +191,9 @@ public:
 	void queueRender(const glm::mat4 &parentTransform);
 	void advanceTime(float dt);
 
+	/** Put the geometry of this model into the world render queue. */
+	void queueGeometry(NodeRenderQueue &queue, const glm::mat4 &parentTransform, RenderPass pass);
+
 	/** Apply buffered changes to model nodes position and geometry. */
 	void flushNodeBuffers();
 
@@ -196,7 +203,7 @@ public:
 protected:
 	typedef std::list<ModelNode *> NodeList;
 	typedef std::map<Common::UString, ModelNode *, Common::UString::iless> NodeMap;
-	typedef std::map<Common::UString, Animation *, Common::UString::iless> AnimationMap;
+	typedef ModelPrototype::AnimationMap AnimationMap;
 	typedef std::map<AnimationChannelName, AnimationChannel *> AnimationChannelMap;
 
 	/** A model state. */
@@ -217,6 +224,9 @@ protected:
 
 	Common::UString _fileName; ///< The model's file name.
 
+	/** The data shared with all other instances of the same model. */
+	ModelPrototypePtr _prototype;
+
 	Common::UString _name; ///< The model's name.
 
 	Common::UString _superModelName; ///< Name of the super model.
@@ -31,6 +31,7 @@
 #include "src/common/readstream.h"
 #include "src/common/encoding.h"
 #include "src/common/strutil.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/resman.h"
@@ -116,23 +117,12 @@ namespace Graphics {
 
 namespace Aurora {
 
-Model_KotOR::ParserContext::ParserContext(const Common::UString &name,
+Model_KotOR::ParserContext::ParserContext(ModelPrototype &p,
                                           const Common::UString &t, bool k2, bool x) :
 	mdl(0), mdx(0), state(0), texture(t), kotor2(k2), xbox(x), mdxStructSize(0), vertexCount(0),
-	offNodeData(0) {
+	offNodeData(0), prototype(&p) {
 
-	try {
-
-		if (!(mdl = ResMan.getResource(name, ::Aurora::kFileTypeMDL)))
-			throw Common::Exception("No such MDL \"%s\"", name.c_str());
-		if (!(mdx = ResMan.getResource(name, ::Aurora::kFileTypeMDX)))
-			throw Common::Exception("No such MDX \"%s\"", name.c_str());
-
-	} catch (...) {
-		delete mdl;
-		delete mdx;
-		throw;
-	}
+	mdl = prototype->openMDL();
 }
 
 Model_KotOR::ParserContext::~ParserContext() {
@@ -151,6 +141,17 @@ void Model_KotOR::ParserContext::clear() {
 	state = 0;
 }
 
+void Model_KotOR::ParserContext::openMDX() {
+	/* The MDX only holds the vertex data. When all meshes of this model
+	 * are already shared by other instances, it's not needed at all. */
+
+	if (mdx)
+		return;
+
+	if (!(mdx = ResMan.getResource(prototype->getName(), ::Aurora::kFileTypeMDX)))
+		throw Common::Exception("No such MDX \"%s\"", prototype->getName().c_str());
+}
+
 
 Model_KotOR::Model_KotOR(const Common::UString &name, bool kotor2, bool xbox, ModelType type,
                          const Common::UString &texture, ModelCache *modelCache) :
@@ -159,7 +160,9 @@ Model_KotOR::Model_KotOR(const Common::UString &name, bool kotor2, bool xbox, Mo
 	_fileName = name;
 	_positionRelative = true;
 
-	ParserContext ctx(name, texture, kotor2, xbox);
+	_prototype = ModelProtoMan.get(name);
+
+	ParserContext ctx(*_prototype, texture, kotor2, xbox);
 
 	load(ctx);
 
@@ -246,27 +249,32 @@ void Model_KotOR::load(ParserContext &ctx) {
 
 	addState(ctx);
 
+	// The animations only hold key frames, so they can be shared between all instances
+	if (_prototype->getAnimations(_animationMap))
+		return;
+
 	std::vector<uint32> animOffsets;
 	readArray(*ctx.mdl, ctx.offModelData + animOffset, animCount, animOffsets);
 
 	for (std::vector<uint32>::const_iterator offset = animOffsets.begin(); offset != animOffsets.end(); ++offset) {
 		newState(ctx);
 
-		if (readAnim(ctx, ctx.offModelData + *offset))
-			addState(ctx);
+		readAnim(ctx, ctx.offModelData + *offset);
 
 		ctx.clear();
 	}
+
+	_prototype->setAnimations(_animationMap);
 }
 
-bool Model_KotOR::readAnim(ParserContext &ctx, uint32 offset) {
+void Model_KotOR::readAnim(ParserContext &ctx, uint32 offset) {
 	ctx.mdl->seek(offset);
 
 	ctx.mdl->skip(8); // Function pointers
 
 	ctx.state->name = Common::readStringFixed(*ctx.mdl, Common::kEncodingASCII, 32);
 
-	if (_stateMap.find(ctx.state->name) != _stateMap.end()) {
+	if (_animationMap.find(ctx.state->name) != _animationMap.end()) {
 		/* TODO: This happens on two models in module 001EBO, the first area of
 		 * KotOR2 (the Ebon Hawk drifting in space):
 		 * - "f3p1a" in model "S_Female01" (90 and 93 model nodes)
@@ -277,7 +285,7 @@ bool Model_KotOR::readAnim(ParserContext &ctx, uint32 offset) {
 		 */
 
 		warning("Duplicate animation \"%s\" in model \"%s\"", ctx.state->name.c_str(), _name.c_str());
-		return false;
+		return;
 	}
 
 	uint32 nodeHeadPointer = ctx.mdl->readUint32LE();
@@ -305,7 +313,7 @@ bool Model_KotOR::readAnim(ParserContext &ctx, uint32 offset) {
 	ctx.mdl->seek(ctx.offModelData + nodeHeadPointer);
 	rootNode->load(ctx);
 
-	Animation *anim = new Animation();
+	boost::shared_ptr<Animation> anim(new Animation());
 
 	anim->setName(ctx.state->name);
 	anim->setLength(animLength);
@@ -313,17 +321,23 @@ bool Model_KotOR::readAnim(ParserContext &ctx, uint32 offset) {
 
 	_animationMap.insert(std::make_pair(ctx.state->name, anim));
 
+	/* The animation nodes copy the key frames out of the model nodes. The
+	 * model nodes themselves are then thrown away again, since nothing
+	 * sets a KotOR model into an animation state. */
 	for (std::list<ModelNode_KotOR *>::iterator n = ctx.nodes.begin(); n != ctx.nodes.end(); ++n) {
 		AnimNode *animnode = new AnimNode(*n);
 
 		anim->addAnimNode(animnode);
 	}
-
-	return true;
 }
 
+/** Protects the model caches, so that models can be loaded on several threads at once. */
+static Common::Mutex superModelMutex;
+
 void Model_KotOR::loadSuperModel(ModelCache *modelCache, bool kotor2, bool xbox) {
 	if (!_superModelName.empty() && _superModelName != "NULL") {
+		Common::StackLock lock(superModelMutex);
+
 		bool foundInCache = false;
 
 		if (modelCache) {
@@ -490,7 +504,8 @@ void ModelNode_KotOR::load(Model_KotOR::ParserContext &ctx) {
 	}
 
 	if (flags & kNodeFlagHasMesh) {
-		readMesh(ctx);
+		// Only skinned meshes modify their vertices, all others can be shared
+		readMesh(ctx, !(flags & kNodeFlagHasSkin));
 	}
 
 	if (flags & kNodeFlagHasSkin) {
@@ -523,16 +538,8 @@ void ModelNode_KotOR::load(Model_KotOR::ParserContext &ctx) {
 		childNode->load(ctx);
 	}
 
-	if (_mesh && _mesh->data) {
-		Common::UString meshName = ctx.mdlName;
-		meshName += ".";
-		if (ctx.state->name.size() != 0) {
-			meshName += ctx.state->name;
-		} else {
-			meshName += "xoreos.default";
-		}
-		meshName += ".";
-		meshName += _name;
+	if (_mesh && _mesh->data && (flags & kNodeFlagHasSkin)) {
+		Common::UString meshName = getMeshName(ctx);
 #ifdef MESH_KOTOR_USE_MESHMAN
 		/**
 		 * Dirty hack around an issue in KotOR2 where a tile can have multiple meshes
@@ -578,10 +585,24 @@ void ModelNode_KotOR::load(Model_KotOR::ParserContext &ctx) {
 
 		MeshMan.addMesh(_mesh->data->rawMesh);
 #endif
+	}
+
+	if (_mesh && _mesh->data && GfxMan.isRendererExperimental())
+		buildMaterial();
+}
 
-		if (GfxMan.isRendererExperimental())
-			buildMaterial();
+Common::UString ModelNode_KotOR::getMeshName(const Model_KotOR::ParserContext &ctx) const {
+	Common::UString meshName = ctx.mdlName;
+	meshName += ".";
+	if (ctx.state->name.size() != 0) {
+		meshName += ctx.state->name;
+	} else {
+		meshName += "xoreos.default";
 	}
+	meshName += ".";
+	meshName += _name;
+
+	return meshName;
 }
 
 void ModelNode_KotOR::readNodeControllers(Model_KotOR::ParserContext &ctx,
@@ -678,8 +699,8 @@ void ModelNode_KotOR::readOrientationController(uint8 columnCount, uint16 rowCou
 	}
 }
 
-void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
-	size_t P = ctx.mdl->pos();
+void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx, bool share) {
+	const uint32 meshOffset = ctx.mdl->pos();
 
 	ctx.mdl->skip(8); // Function pointers
 
@@ -780,7 +801,6 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 	_render = _mesh->render;
 	_mesh->data = new MeshData();
 	_mesh->data->envMapMode = kModeEnvironmentBlendedOver;
-	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	uint32 endPos = ctx.mdl->pos();
 
@@ -795,6 +815,18 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 	textures.resize(textureCount);
 	loadTextures(textures);
 
+	if (share && (_mesh->data->rawMesh = ctx.prototype->getMesh(meshOffset))) {
+		// Another instance of this model already read the geometry
+		createBound();
+
+		ctx.mdl->seek(endPos);
+		return;
+	}
+
+	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
+
+	ctx.openMDX();
+
 
 	// Read vertices (interleaved)
 
@@ -855,6 +887,11 @@ void ModelNode_KotOR::readMesh(Model_KotOR::ParserContext &ctx) {
 	for (uint32 i = 0; i < facesCount * 3; i++)
 		f[i] = ctx.mdl->readUint16LE();
 
+	if (share) {
+		_mesh->data->rawMesh->setName(getMeshName(ctx));
+		_mesh->data->rawMesh = ctx.prototype->addMesh(meshOffset, _mesh->data->rawMesh);
+	}
+
 	createBound();
 
 	ctx.mdl->seek(endPos);
@@ -864,6 +901,8 @@ void ModelNode_KotOR::readSkin(Model_KotOR::ParserContext &ctx) {
 	/* The models found in the Xbox versions store bone indices as int16,
 	 * while the Windows/Mac/Linux versions use floats. */
 
+	ctx.openMDX();
+
 	ctx.mdl->skip(ctx.xbox ? 8 : 12);
 	uint32 mdxOffsetBoneWeights = ctx.mdl->readUint32LE();
 	uint32 mdxOffsetBoneMappingId = ctx.mdl->readUint32LE();
@@ -70,10 +70,15 @@ private:
 		uint16 vertexCount;
 		uint32 offNodeData;
 
-		ParserContext(const Common::UString &name, const Common::UString &t, bool k2, bool x);
+		ModelPrototype *prototype;
+
+		ParserContext(ModelPrototype &p, const Common::UString &t, bool k2, bool x);
 		~ParserContext();
 
 		void clear();
+
+		/** Open the MDX, if it hasn't been opened yet. */
+		void openMDX();
 	};
 
 
@@ -81,7 +86,7 @@ private:
 	void addState(ParserContext &ctx);
 
 	void load(ParserContext &ctx);
-	bool readAnim(ParserContext &ctx, uint32 offset);
+	void readAnim(ParserContext &ctx, uint32 offset);
 
 	void loadSuperModel(ModelCache *modelCache, bool kotor2, bool xbox);
 
@@ -111,8 +116,10 @@ private:
 	                            uint16 dataIndex, std::vector<float> &data);
 	void readOrientationController(uint8 columnCount, uint16 rowCount, uint16 timeIndex,
 	                               uint16 dataIndex, std::vector<float> &dataFloat, std::vector<uint32> &dataInt);
-	void readMesh(Model_KotOR::ParserContext &ctx);
+	void readMesh(Model_KotOR::ParserContext &ctx, bool share);
 	void readSkin(Model_KotOR::ParserContext &ctx);
+
+	Common::UString getMeshName(const Model_KotOR::ParserContext &ctx) const;
 };
 
 } // End of namespace Aurora
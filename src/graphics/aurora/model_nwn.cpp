@@ -123,13 +123,10 @@ namespace Graphics {
 
 namespace Aurora {
 
-Model_NWN::ParserContext::ParserContext(const Common::UString &name,
-                                        const Common::UString &t) :
-	mdl(0), state(0), texture(t) {
+Model_NWN::ParserContext::ParserContext(ModelPrototype &p, const Common::UString &t) :
+	mdl(0), state(0), texture(t), prototype(&p) {
 
-	mdl = ResMan.getResource(name, ::Aurora::kFileTypeMDL);
-	if (!mdl)
-		throw Common::Exception("No such MDL \"%s\"", name.c_str());
+	mdl = prototype->openMDL();
 
 	mdl->seek(0);
 	isASCII = mdl->readUint32LE() != 0;
@@ -193,7 +190,9 @@ Model_NWN::Model_NWN(const Common::UString &name, ModelType type,
 
 	_fileName = name;
 
-	ParserContext ctx(name, texture);
+	_prototype = ModelProtoMan.get(name);
+
+	ParserContext ctx(*_prototype, texture);
 
 	if (ctx.isASCII)
 		loadASCII(ctx);
@@ -462,7 +461,7 @@ void Model_NWN::readAnimBinary(ParserContext &ctx, uint32 offset) {
 	// We read this in, but what do we do with it??
 	// Ah, we call addState, interesting
 	// Need to look at interaction with placeable states?
-	Animation *anim = new Animation();
+	boost::shared_ptr<Animation> anim(new Animation());
 	anim->setName(ctx.state->name);
 	anim->setLength(animLength);
 	anim->setTransTime(transTime);
@@ -701,6 +700,8 @@ static bool fuzzyEqual(const float *a, const float *b) {
 }
 
 void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
+	const uint32 meshOffset = ctx.mdl->pos();
+
 	ctx.mdl->skip(8); // Function pointers
 
 	uint32 facesOffset, facesCount;
@@ -808,13 +809,26 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 
 	_render = _mesh->render;
 	_mesh->data = new MeshData();
-	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
 
 	textures.resize(textureCount);
 	loadTextures(textures);
 
 	size_t endPos = ctx.mdl->pos();
 
+	if ((_mesh->data->rawMesh = ctx.prototype->getMesh(meshOffset))) {
+		// Another instance of this model already read the geometry
+		createBound();
+
+		ctx.mdl->seek(endPos);
+
+		if (GfxMan.isRendererExperimental())
+			buildMaterial();
+
+		return;
+	}
+
+	_mesh->data->rawMesh = new Graphics::Mesh::Mesh();
+
 
 	// Read vertices
 
@@ -955,15 +969,8 @@ void ModelNode_NWN_Binary::readMesh(Model_NWN::ParserContext &ctx) {
 	meshName += ".";
 	meshName += _name;
 
-	Graphics::Mesh::Mesh *checkMesh = MeshMan.getMesh(meshName);
-	if (checkMesh) {
-		delete _mesh->data->rawMesh;
-		_mesh->data->rawMesh = checkMesh;
-	} else {
-		_mesh->data->rawMesh->setName(meshName);
-		_mesh->data->rawMesh->init();
-		MeshMan.addMesh(_mesh->data->rawMesh);
-	}
+	_mesh->data->rawMesh->setName(meshName);
+	_mesh->data->rawMesh = ctx.prototype->addMesh(meshOffset, _mesh->data->rawMesh);
 
 	if (GfxMan.isRendererExperimental())
 		buildMaterial();
@@ -70,7 +70,9 @@ private:
 		Common::StreamTokenizer *tokenize;
 		std::vector<uint32> anims;
 
-		ParserContext(const Common::UString &name, const Common::UString &t);
+		ModelPrototype *prototype;
+
+		ParserContext(ModelPrototype &p, const Common::UString &t);
 		~ParserContext();
 
 		bool findNode(const Common::UString &name, ModelNode *&node) const;
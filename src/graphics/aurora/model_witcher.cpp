@@ -1261,8 +1261,9 @@ void ModelNode_Witcher::buildMaterial() {
 		material->setBlendDstRGB(GL_ONE_MINUS_SRC_COLOR);
 		material->setBlendDstAlpha(GL_ONE_MINUS_SRC_ALPHA);
 	}
-	MaterialMan.addMaterial(material);
-	SurfaceMan.addSurface(surface);
+
+	surface  = SurfaceMan.addSurface(surface);
+	material = MaterialMan.addMaterial(material);
 
 	if (penvmap) {
 		sampler = (Shader::ShaderSampler *)(material->getVariableData("sampler_7_id"));
@@ -40,6 +40,7 @@
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/texture.h"
 #include "src/graphics/aurora/model.h"
+#include "src/graphics/aurora/noderenderqueue.h"
 
 #include "src/graphics/shader/materialman.h"
 #include "src/graphics/shader/surfaceman.h"
@@ -352,13 +353,18 @@ void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
 		try {
 
 			if (!textures[t].empty() && (textures[t] != "NULL")) {
-				_mesh->data->textures[t] = TextureMan.get(textures[t]);
+				/* With a transparency hint, we don't need to look at the image's alpha
+				 * channel, so the image itself can be loaded in the background. */
+				const TextureManager::LoadPriority priority = _mesh->hasTransparencyHint ?
+					TextureManager::kLoadWorld : TextureManager::kLoadImmediate;
+
+				_mesh->data->textures[t] = TextureMan.get(textures[t], priority);
 				if (_mesh->data->textures[t].empty())
 					continue;
 
 				hasTexture = true;
 
-				if (!_mesh->data->textures[t].getTexture().hasAlpha())
+				if (!_mesh->hasTransparencyHint && !_mesh->data->textures[t].getTexture().hasAlpha())
 					hasAlpha = false;
 				if (_mesh->data->textures[t].getTexture().getTXI().getFeatures().alphaMean == 1.0f)
 					hasAlpha = false;
@@ -649,6 +655,27 @@ void ModelNode::render(RenderPass pass) {
 
 	glScalef(_scale[0], _scale[1], _scale[2]);
 
+	// Render the node's geometry
+
+	Mesh *mesh = getRenderMesh(pass);
+	if (mesh)
+		renderGeometry(*mesh);
+
+	if (_attachedModel) {
+		glPushMatrix();
+		_attachedModel->render(pass);
+		glPopMatrix();
+	}
+
+	// Render the node's children
+	for (std::list<ModelNode *>::iterator c = _children.begin(); c != _children.end(); ++c) {
+		glPushMatrix();
+		(*c)->render(pass);
+		glPopMatrix();
+	}
+}
+
+ModelNode::Mesh *ModelNode::getRenderMesh(RenderPass pass) {
 	Mesh *mesh = _mesh;
 	bool doRender = _render;
 	if (!_model->getState().empty() && !renderableMesh(mesh)) {
@@ -664,29 +691,46 @@ void ModelNode::render(RenderPass pass) {
 		_dirtyMesh = false;
 	}
 
-	// Render the node's geometry
-
 	bool isTransparent = mesh && mesh->isTransparent;
 	bool shouldRender = doRender && renderableMesh(mesh);
 	if (((pass == kRenderPassOpaque)      &&  isTransparent) ||
 	    ((pass == kRenderPassTransparent) && !isTransparent))
 		shouldRender = false;
 
-	if (shouldRender)
-		renderGeometry(*mesh);
+	return shouldRender ? mesh : 0;
+}
 
-	if (_attachedModel) {
-		glPushMatrix();
-		_attachedModel->render(pass);
-		glPopMatrix();
-	}
+void ModelNode::queueGeometry(NodeRenderQueue &queue, const glm::mat4 &parentTransform, RenderPass pass) {
+	// Apply the node's transformation, the same way render() does
 
-	// Render the node's children
-	for (std::list<ModelNode *>::iterator c = _children.begin(); c != _children.end(); ++c) {
-		glPushMatrix();
-		(*c)->render(pass);
-		glPopMatrix();
-	}
+	glm::mat4 transform = glm::translate(parentTransform, glm::vec3(_position[0], _position[1], _position[2]));
+
+	if ((_orientation[3] != 0.0f) &&
+	    ((_orientation[0] != 0.0f) || (_orientation[1] != 0.0f) || (_orientation[2] != 0.0f)))
+		transform = glm::rotate(transform, Common::deg2rad(_orientation[3]),
+		                        glm::vec3(_orientation[0], _orientation[1], _orientation[2]));
+
+	if (_rotation[0] != 0.0f)
+		transform = glm::rotate(transform, Common::deg2rad(_rotation[0]), glm::vec3(1.0f, 0.0f, 0.0f));
+	if (_rotation[1] != 0.0f)
+		transform = glm::rotate(transform, Common::deg2rad(_rotation[1]), glm::vec3(0.0f, 1.0f, 0.0f));
+	if (_rotation[2] != 0.0f)
+		transform = glm::rotate(transform, Common::deg2rad(_rotation[2]), glm::vec3(0.0f, 0.0f, 1.0f));
+
+	transform = glm::scale(transform, glm::vec3(_scale[0], _scale[1], _scale[2]));
+
+	// Queue the node's geometry
+
+	Mesh *mesh = getRenderMesh(pass);
+	if (mesh)
+		queue.add(pass, *mesh->data->rawMesh, mesh->data->textures, transform);
+
+	if (_attachedModel)
+		_attachedModel->queueGeometry(queue, transform, pass);
+
+	// Queue the node's children
+	for (std::list<ModelNode *>::iterator c = _children.begin(); c != _children.end(); ++c)
+		(*c)->queueGeometry(queue, transform, pass);
 }
 
 void ModelNode::calcRenderTransform(const glm::mat4 &parentTransform) {
@@ -1274,8 +1318,11 @@ void ModelNode::buildMaterial() {
 		material->setBlendDstRGB(GL_ONE_MINUS_SRC_COLOR);
 		material->setBlendDstAlpha(GL_ONE_MINUS_SRC_ALPHA);
 	}
-	MaterialMan.addMaterial(material);
-	SurfaceMan.addSurface(surface);
+
+	/* Add the surface first, so that it always exists once the material is found.
+	 * If another model built the same material in the meantime, use that one. */
+	surface  = SurfaceMan.addSurface(surface);
+	material = MaterialMan.addMaterial(material);
 
 	if (penvmap) {
 		sampler = (Shader::ShaderSampler *)(material->getVariableData("sampler_7_id"));
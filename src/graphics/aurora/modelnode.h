@@ -46,6 +46,7 @@ namespace Graphics {
 namespace Aurora {
 
 class Model;
+class NodeRenderQueue;
 
 struct PositionKeyFrame {
 	float time;
@@ -268,6 +269,8 @@ protected:
 	void createAbsoluteBound(Common::BoundingBox parentPosition);
 
 	void render(RenderPass pass);
+	/** Put the geometry of this node and its children into the world render queue. */
+	void queueGeometry(NodeRenderQueue &queue, const glm::mat4 &parentTransform, RenderPass pass);
 	void drawSkeleton(const glm::mat4 &parent, bool showInvisible);
 
 	/** Calculate the transform used for rendering. */
@@ -303,6 +306,9 @@ private:
 
 	static bool renderableMesh(Mesh *mesh);
 
+	/** Return the mesh to draw in this render pass, or 0 if there's nothing to draw. */
+	Mesh *getRenderMesh(RenderPass pass);
+
 public:
 	// General helpers
 
@@ -322,6 +328,7 @@ public:
 	void inheritOrientation(ModelNode &node) const;
 
 	friend class Model;
+	friend class AnimNode;
 	friend class Animation;
 	friend class AnimationChannel;
 };
@@ -0,0 +1,170 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Data shared between all instances of the same model.
+ */
+
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+
+#include "src/aurora/types.h"
+#include "src/aurora/resman.h"
+
+#include "src/graphics/mesh/mesh.h"
+
+#include "src/graphics/aurora/modelprototype.h"
+#include "src/graphics/aurora/animation.h"
+
+DECLARE_SINGLETON(Graphics::Aurora::ModelPrototypeManager)
+
+namespace Graphics {
+
+namespace Aurora {
+
+ModelPrototype::ModelPrototype(const Common::UString &name) : _name(name), _mdlSize(0), _hasAnimations(false) {
+}
+
+ModelPrototype::~ModelPrototype() {
+	for (MeshMap::iterator m = _meshes.begin(); m != _meshes.end(); ++m) {
+		// Make sure the GL resources are freed in the main thread
+		m->second->destroy();
+
+		delete m->second;
+	}
+}
+
+const Common::UString &ModelPrototype::getName() const {
+	return _name;
+}
+
+Common::SeekableReadStream *ModelPrototype::openMDL() {
+	Common::StackLock lock(_mutex);
+
+	if (!_mdl) {
+		Common::ScopedPtr<Common::SeekableReadStream> mdl(ResMan.getResource(_name, ::Aurora::kFileTypeMDL));
+		if (!mdl)
+			throw Common::Exception("No such MDL \"%s\"", _name.c_str());
+
+		_mdlSize = mdl->size();
+		_mdl.reset(new byte[_mdlSize]);
+
+		if (mdl->read(_mdl.get(), _mdlSize) != _mdlSize) {
+			_mdl.reset();
+			throw Common::Exception(Common::kReadError);
+		}
+	}
+
+	return new Common::MemoryReadStream(_mdl.get(), _mdlSize);
+}
+
+Graphics::Mesh::Mesh *ModelPrototype::getMesh(uint32 offset) {
+	Common::StackLock lock(_mutex);
+
+	MeshMap::const_iterator m = _meshes.find(offset);
+	if (m == _meshes.end())
+		return 0;
+
+	return m->second;
+}
+
+Graphics::Mesh::Mesh *ModelPrototype::addMesh(uint32 offset, Graphics::Mesh::Mesh *mesh) {
+	Common::StackLock lock(_mutex);
+
+	std::pair<MeshMap::iterator, bool> result = _meshes.insert(std::make_pair(offset, mesh));
+	if (!result.second) {
+		delete mesh;
+
+		return result.first->second;
+	}
+
+	mesh->init();
+
+	return mesh;
+}
+
+bool ModelPrototype::getAnimations(AnimationMap &animations) {
+	Common::StackLock lock(_mutex);
+
+	if (!_hasAnimations)
+		return false;
+
+	animations = _animations;
+	return true;
+}
+
+void ModelPrototype::setAnimations(AnimationMap &animations) {
+	Common::StackLock lock(_mutex);
+
+	if (_hasAnimations) {
+		animations = _animations;
+		return;
+	}
+
+	_animations    = animations;
+	_hasAnimations = true;
+}
+
+
+ModelPrototypeManager::ModelPrototypeManager() {
+}
+
+ModelPrototypeManager::~ModelPrototypeManager() {
+}
+
+ModelPrototypePtr ModelPrototypeManager::get(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	PrototypeMap::iterator p = _prototypes.find(name);
+	if (p != _prototypes.end()) {
+		ModelPrototypePtr prototype = p->second.lock();
+		if (prototype)
+			return prototype;
+	}
+
+	collect();
+
+	ModelPrototypePtr prototype(new ModelPrototype(name));
+	_prototypes[name] = prototype;
+
+	return prototype;
+}
+
+size_t ModelPrototypeManager::getCount() {
+	Common::StackLock lock(_mutex);
+
+	collect();
+
+	return _prototypes.size();
+}
+
+void ModelPrototypeManager::collect() {
+	PrototypeMap::iterator p = _prototypes.begin();
+	while (p != _prototypes.end()) {
+		if (p->second.expired())
+			_prototypes.erase(p++);
+		else
+			++p;
+	}
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
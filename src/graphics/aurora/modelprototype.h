@@ -0,0 +1,158 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Data shared between all instances of the same model.
+ */
+
+#ifndef GRAPHICS_AURORA_MODELPROTOTYPE_H
+#define GRAPHICS_AURORA_MODELPROTOTYPE_H
+
+#include <map>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/singleton.h"
+#include "src/common/mutex.h"
+#include "src/common/ustring.h"
+
+namespace Common {
+	class SeekableReadStream;
+}
+
+namespace Graphics {
+
+namespace Mesh {
+	class Mesh;
+}
+
+namespace Aurora {
+
+class Animation;
+
+/** The parts of a model that don't change between its instances.
+ *
+ *  Every model object placed into the world is loaded separately, since
+ *  its nodes carry their own state: textures, positions, animation state and
+ *  skinned vertices. The model file itself and the geometry of all nodes
+ *  that aren't deformed, however, are the same for every instance. The
+ *  prototype keeps these around, so that loading another instance of an
+ *  already loaded model neither reads the file from the archives again,
+ *  nor parses the geometry and uploads another copy of it into the GPU.
+ *  Likewise, the animations of a model only hold key frames and are
+ *  shared by all its instances.
+ *
+ *  The prototype stays alive for as long as any model references it.
+ */
+class ModelPrototype : boost::noncopyable {
+public:
+	typedef std::map<Common::UString, boost::shared_ptr<Animation>, Common::UString::iless> AnimationMap;
+
+	ModelPrototype(const Common::UString &name);
+	~ModelPrototype();
+
+	/** Return the name of the model. */
+	const Common::UString &getName() const;
+
+	/** Open the MDL file of the model.
+	 *
+	 *  The file is only read once, and then kept in memory. Every call
+	 *  returns a new stream with its own position over that memory.
+	 */
+	Common::SeekableReadStream *openMDL();
+
+	/** Return the shared mesh found at this offset within the MDL, or 0 if there is none yet. */
+	Graphics::Mesh::Mesh *getMesh(uint32 offset);
+
+	/** Share a mesh found at this offset within the MDL with all instances.
+	 *
+	 *  The prototype takes over the mesh, which must not have been
+	 *  initialized yet. If another instance has already added a mesh for
+	 *  this offset in the meantime, the given mesh is deleted and the
+	 *  existing one returned instead.
+	 */
+	Graphics::Mesh::Mesh *addMesh(uint32 offset, Graphics::Mesh::Mesh *mesh);
+
+	/** Copy the shared animations of the model into this map.
+	 *
+	 *  Returns false if no instance has read the animations yet.
+	 */
+	bool getAnimations(AnimationMap &animations);
+
+	/** Share the animations of the model with all instances.
+	 *
+	 *  If another instance has already shared its animations in the
+	 *  meantime, the given map is replaced with those instead.
+	 */
+	void setAnimations(AnimationMap &animations);
+
+private:
+	typedef std::map<uint32, Graphics::Mesh::Mesh *> MeshMap;
+
+	Common::UString _name;
+
+	Common::ScopedArray<byte> _mdl;
+	size_t _mdlSize;
+
+	MeshMap _meshes;
+
+	bool _hasAnimations;
+	AnimationMap _animations;
+
+	Common::Mutex _mutex;
+};
+
+typedef boost::shared_ptr<ModelPrototype> ModelPrototypePtr;
+
+/** The global registry of all model prototypes currently in use. */
+class ModelPrototypeManager : public Common::Singleton<ModelPrototypeManager> {
+public:
+	ModelPrototypeManager();
+	~ModelPrototypeManager();
+
+	/** Return the prototype of this model, creating it if necessary. */
+	ModelPrototypePtr get(const Common::UString &name);
+
+	/** Return the number of prototypes currently in use. */
+	size_t getCount();
+
+private:
+	typedef std::map<Common::UString, boost::weak_ptr<ModelPrototype>, Common::UString::iless> PrototypeMap;
+
+	PrototypeMap _prototypes;
+
+	Common::Mutex _mutex;
+
+	/** Remove all prototypes no model references anymore. */
+	void collect();
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+/** Shortcut for accessing the model prototype manager. */
+#define ModelProtoMan Graphics::Aurora::ModelPrototypeManager::instance()
+
+#endif // GRAPHICS_AURORA_MODELPROTOTYPE_H
@@ -0,0 +1,248 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A queue batching the model node geometry drawn in the world.
+ */
+
+#include <cassert>
+#include <algorithm>
+#include <functional>
+
+#include "glm/gtc/type_ptr.hpp"
+
+#include "src/graphics/graphics.h"
+
+#include "src/graphics/mesh/mesh.h"
+
+#include "src/graphics/aurora/noderenderqueue.h"
+#include "src/graphics/aurora/textureman.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+NodeRenderQueue::Statistics::Statistics() {
+	clear();
+}
+
+void NodeRenderQueue::Statistics::clear() {
+	drawCalls    = 0;
+	stateChanges = 0;
+	triangles    = 0;
+}
+
+
+NodeRenderQueue::NodeRenderQueue() : _collecting(false) {
+}
+
+NodeRenderQueue::~NodeRenderQueue() {
+}
+
+void NodeRenderQueue::begin(const glm::mat4 &modelview) {
+	_modelview  = modelview;
+	_collecting = true;
+
+	_statistics.clear();
+}
+
+void NodeRenderQueue::end() {
+	_collecting = false;
+
+	_packets[kRenderPassOpaque].clear();
+	_packets[kRenderPassTransparent].clear();
+
+	Common::StackLock lock(_mutex);
+	_lastStatistics = _statistics;
+}
+
+bool NodeRenderQueue::isCollecting() const {
+	return _collecting;
+}
+
+void NodeRenderQueue::add(RenderPass pass, Mesh::Mesh &mesh, const std::vector<TextureHandle> &textures,
+                          const glm::mat4 &transform) {
+
+	assert((pass == kRenderPassOpaque) || (pass == kRenderPassTransparent));
+
+	_packets[pass].push_back(Packet());
+	Packet &packet = _packets[pass].back();
+
+	packet.mesh     = &mesh;
+	packet.textures = &textures;
+
+	packet.transform = transform;
+
+	const glm::vec4 position = _modelview * transform * glm::vec4(mesh.getCentre(), 1.0f);
+	packet.distance = glm::dot(glm::vec3(position), glm::vec3(position));
+}
+
+const Texture *NodeRenderQueue::getStateTexture(const TextureHandle &texture) {
+	return texture.empty() ? 0 : &texture.getTexture();
+}
+
+bool NodeRenderQueue::sameState(const Packet &a, const Packet &b) {
+	// Compare all textures, since all of them are bound
+	const std::vector<TextureHandle> &texturesA = *a.textures;
+	const std::vector<TextureHandle> &texturesB = *b.textures;
+
+	if (&texturesA == &texturesB)
+		return true;
+
+	if (texturesA.size() != texturesB.size())
+		return false;
+
+	for (size_t t = 0; t < texturesA.size(); t++)
+		if (getStateTexture(texturesA[t]) != getStateTexture(texturesB[t]))
+			return false;
+
+	return true;
+}
+
+bool NodeRenderQueue::compareState(const Packet *a, const Packet *b) {
+	const std::vector<TextureHandle> &texturesA = *a->textures;
+	const std::vector<TextureHandle> &texturesB = *b->textures;
+
+	if (texturesA.size() != texturesB.size())
+		return texturesA.size() < texturesB.size();
+
+	for (size_t t = 0; t < texturesA.size(); t++) {
+		const Texture *textureA = getStateTexture(texturesA[t]);
+		const Texture *textureB = getStateTexture(texturesB[t]);
+
+		if (textureA != textureB)
+			return std::less<const Texture *>()(textureA, textureB);
+	}
+
+	return std::less<const Mesh::Mesh *>()(a->mesh, b->mesh);
+}
+
+bool NodeRenderQueue::compareDistance(const Packet *a, const Packet *b) {
+	// Back to front. Packets at the same distance can still share their state
+	if (a->distance != b->distance)
+		return a->distance > b->distance;
+
+	return compareState(a, b);
+}
+
+void NodeRenderQueue::bindState(const Packet &packet) {
+	const std::vector<TextureHandle> &textures = *packet.textures;
+
+	for (size_t t = 0; t < textures.size(); t++) {
+		TextureMan.activeTexture(t);
+		TextureMan.set(textures[t]);
+	}
+
+	if (textures.empty())
+		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+}
+
+void NodeRenderQueue::unbindState(const Packet &packet) {
+	const std::vector<TextureHandle> &textures = *packet.textures;
+
+	for (size_t t = 0; t < textures.size(); t++) {
+		TextureMan.activeTexture(t);
+		TextureMan.set();
+	}
+
+	if (textures.empty())
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+}
+
+void NodeRenderQueue::render(RenderPass pass) {
+	assert((pass == kRenderPassOpaque) || (pass == kRenderPassTransparent));
+
+	std::vector<Packet> &packets = _packets[pass];
+	if (packets.empty())
+		return;
+
+	_order.clear();
+	_order.reserve(packets.size());
+
+	for (std::vector<Packet>::const_iterator p = packets.begin(); p != packets.end(); ++p)
+		_order.push_back(&*p);
+
+	if (pass == kRenderPassOpaque)
+		std::sort(_order.begin(), _order.end(), compareState);
+	else
+		std::sort(_order.begin(), _order.end(), compareDistance);
+
+	const Packet *state = 0;
+	Mesh::Mesh   *mesh  = 0;
+
+	for (std::vector<const Packet *>::const_iterator p = _order.begin(); p != _order.end(); ++p) {
+		const Packet &packet = **p;
+
+		if (!state || !sameState(*state, packet)) {
+			if (mesh)
+				mesh->renderUnbind();
+			mesh = 0;
+
+			if (state)
+				unbindState(*state);
+
+			state = &packet;
+			bindState(*state);
+
+			_statistics.stateChanges++;
+		}
+
+		if (mesh != packet.mesh) {
+			if (mesh)
+				mesh->renderUnbind();
+
+			mesh = packet.mesh;
+			mesh->renderBind();
+		}
+
+		glPushMatrix();
+		glMultMatrixf(glm::value_ptr(packet.transform));
+
+		mesh->render();
+
+		glPopMatrix();
+
+		const uint32 indexCount = mesh->getIndexBuffer()->getCount();
+		const uint32 vertexCount = indexCount ? indexCount : mesh->getVertexBuffer()->getCount();
+
+		_statistics.drawCalls++;
+		_statistics.triangles += vertexCount / 3;
+	}
+
+	if (mesh)
+		mesh->renderUnbind();
+	if (state)
+		unbindState(*state);
+
+	// Reset the first texture units
+	TextureMan.reset();
+
+	packets.clear();
+}
+
+NodeRenderQueue::Statistics NodeRenderQueue::getStatistics() {
+	Common::StackLock lock(_mutex);
+
+	return _lastStatistics;
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
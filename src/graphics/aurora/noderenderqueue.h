@@ -0,0 +1,142 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A queue batching the model node geometry drawn in the world.
+ */
+
+#ifndef GRAPHICS_AURORA_NODERENDERQUEUE_H
+#define GRAPHICS_AURORA_NODERENDERQUEUE_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "glm/mat4x4.hpp"
+
+#include "src/common/types.h"
+#include "src/common/mutex.h"
+
+#include "src/graphics/types.h"
+
+#include "src/graphics/aurora/texturehandle.h"
+
+namespace Graphics {
+
+namespace Mesh {
+	class Mesh;
+}
+
+namespace Aurora {
+
+/** A queue collecting the geometry of all model nodes drawn in the world.
+ *
+ *  Instead of drawing each node while walking through the model trees,
+ *  the nodes are put into the queue as packets of mesh, textures and
+ *  transformation. The opaque packets are then sorted by their textures
+ *  and meshes, so that each texture set is only bound once and nodes
+ *  using the same mesh are drawn without rebinding the vertex buffers.
+ *  The transparent packets are sorted back to front instead, and only
+ *  neighbouring packets with the same state are batched.
+ */
+class NodeRenderQueue : boost::noncopyable {
+public:
+	/** Statistics of the geometry drawn in one frame. */
+	struct Statistics {
+		uint32 drawCalls;    ///< The number of meshes drawn.
+		uint32 stateChanges; ///< The number of times the textures were changed.
+		uint32 triangles;    ///< The number of triangles drawn.
+
+		Statistics();
+
+		void clear();
+	};
+
+	NodeRenderQueue();
+	~NodeRenderQueue();
+
+	/** Start collecting the geometry of a frame seen through this modelview matrix. */
+	void begin(const glm::mat4 &modelview);
+	/** Stop collecting geometry and publish the statistics of the frame. */
+	void end();
+
+	/** Are we currently collecting geometry? */
+	bool isCollecting() const;
+
+	/** Queue a mesh to be drawn.
+	 *
+	 *  @param pass The render pass the mesh belongs to.
+	 *  @param mesh The mesh to draw.
+	 *  @param textures The textures to draw the mesh with. Must stay valid until
+	 *                  the pass has been rendered.
+	 *  @param transform The transformation of the mesh, relative to the modelview.
+	 */
+	void add(RenderPass pass, Mesh::Mesh &mesh, const std::vector<TextureHandle> &textures,
+	         const glm::mat4 &transform);
+
+	/** Draw all queued meshes of this pass, and remove them from the queue.
+	 *
+	 *  The modelview matrix given to begin() has to be current.
+	 */
+	void render(RenderPass pass);
+
+	/** Return the statistics of the last completed frame. */
+	Statistics getStatistics();
+
+private:
+	/** A mesh to draw. */
+	struct Packet {
+		Mesh::Mesh *mesh;
+		/** The textures, which are also the key for sorting and comparing the state. */
+		const std::vector<TextureHandle> *textures;
+
+		glm::mat4 transform;
+
+		float distance; ///< Squared distance to the camera.
+	};
+
+	bool _collecting;
+
+	glm::mat4 _modelview;
+
+	std::vector<Packet> _packets[2];
+	std::vector<const Packet *> _order;
+
+	Statistics _statistics;
+	Statistics _lastStatistics;
+
+	Common::Mutex _mutex;
+
+	/** Return the texture identifying a texture unit's state. */
+	static const Texture *getStateTexture(const TextureHandle &texture);
+
+	static bool sameState(const Packet &a, const Packet &b);
+	static bool compareState(const Packet *a, const Packet *b);
+	static bool compareDistance(const Packet *a, const Packet *b);
+
+	static void bindState(const Packet &packet);
+	static void unbindState(const Packet &packet);
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_NODERENDERQUEUE_H
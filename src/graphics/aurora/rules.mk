@@ -27,6 +27,7 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/texture.h \
     src/graphics/aurora/texturehandle.h \
     src/graphics/aurora/textureman.h \
+    src/graphics/aurora/textureloader.h \
     src/graphics/aurora/pltfile.h \
     src/graphics/aurora/cursor.h \
     src/graphics/aurora/cursorman.h \
@@ -46,6 +47,10 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/geometryobject.h \
     src/graphics/aurora/modelnode.h \
     src/graphics/aurora/model.h \
+    src/graphics/aurora/modelprototype.h \
+    src/graphics/aurora/noderenderqueue.h \
+    src/graphics/aurora/keyframetrack.h \
+    src/graphics/aurora/skinning.h \
     src/graphics/aurora/animnode.h \
     src/graphics/aurora/animation.h \
     src/graphics/aurora/fadequad.h \
@@ -61,6 +66,7 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/kotordialogframe.h \
     src/graphics/aurora/animationthread.h \
     src/graphics/aurora/walkmesh.h \
+    src/graphics/aurora/walkmeshgrid.h \
     src/graphics/aurora/animationchannel.h \
     $(EMPTY)
 
@@ -68,6 +74,7 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/texture.cpp \
     src/graphics/aurora/texturehandle.cpp \
     src/graphics/aurora/textureman.cpp \
+    src/graphics/aurora/textureloader.cpp \
     src/graphics/aurora/pltfile.cpp \
     src/graphics/aurora/cursor.cpp \
     src/graphics/aurora/cursorman.cpp \
@@ -87,6 +94,10 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/geometryobject.cpp \
     src/graphics/aurora/modelnode.cpp \
     src/graphics/aurora/model.cpp \
+    src/graphics/aurora/modelprototype.cpp \
+    src/graphics/aurora/noderenderqueue.cpp \
+    src/graphics/aurora/keyframetrack.cpp \
+    src/graphics/aurora/skinning.cpp \
     src/graphics/aurora/animnode.cpp \
     src/graphics/aurora/animation.cpp \
     src/graphics/aurora/fadequad.cpp \
@@ -102,5 +113,6 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/kotordialogframe.cpp \
     src/graphics/aurora/animationthread.cpp \
     src/graphics/aurora/walkmesh.cpp \
+    src/graphics/aurora/walkmeshgrid.cpp \
     src/graphics/aurora/animationchannel.cpp \
     $(EMPTY)
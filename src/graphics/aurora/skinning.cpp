@@ -0,0 +1,131 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Skinning vertices with a palette of bone matrices.
+ */
+
+#include "glm/gtc/type_ptr.hpp"
+
+#include "src/common/util.h"
+
+#include "src/graphics/aurora/skinning.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define SKINNING_HAVE_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+namespace Graphics {
+
+namespace Aurora {
+
+bool hasSIMDSkinning() {
+#ifdef SKINNING_HAVE_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+static inline const float *getBone(float id, const glm::mat4 *palette, size_t paletteSize) {
+	const int index = static_cast<int>(id);
+	if ((index < 0) || ((size_t) index >= paletteSize))
+		return 0;
+
+	return glm::value_ptr(palette[index]);
+}
+
+static void skinVertex(float *dst, const float *src, const float *boneIDs, const float *boneWeights,
+                       const glm::mat4 *palette, size_t paletteSize) {
+
+	float v[3] = { 0.0f, 0.0f, 0.0f };
+
+	for (size_t j = 0; j < 4; j++) {
+		const float *m = getBone(boneIDs[j], palette, paletteSize);
+		if (!m)
+			continue;
+
+		// The matrices are column-major
+		for (size_t c = 0; c < 3; c++)
+			v[c] += (m[c] * src[0] + m[4 + c] * src[1] + m[8 + c] * src[2] + m[12 + c]) * boneWeights[j];
+	}
+
+	dst[0] = v[0];
+	dst[1] = v[1];
+	dst[2] = v[2];
+}
+
+#ifdef SKINNING_HAVE_SSE2
+/* The SSE2 kernel calculates the exact same values as the scalar code. It
+ * holds each column of a bone matrix in one register, and so transforms
+ * all coordinates of a vertex at once. */
+static inline void skinVertexSSE2(float *dst, const float *src, const float *boneIDs, const float *boneWeights,
+                                  const glm::mat4 *palette, size_t paletteSize) {
+
+	const __m128 x = _mm_set1_ps(src[0]);
+	const __m128 y = _mm_set1_ps(src[1]);
+	const __m128 z = _mm_set1_ps(src[2]);
+
+	__m128 v = _mm_setzero_ps();
+
+	for (size_t j = 0; j < 4; j++) {
+		const float *m = getBone(boneIDs[j], palette, paletteSize);
+		if (!m)
+			continue;
+
+		const __m128 t = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m     ), x),
+		                                                  _mm_mul_ps(_mm_loadu_ps(m +  4), y)),
+		                                       _mm_mul_ps(_mm_loadu_ps(m +  8), z)),
+		                            _mm_loadu_ps(m + 12));
+
+		v = _mm_add_ps(v, _mm_mul_ps(t, _mm_set1_ps(boneWeights[j])));
+	}
+
+	float result[4];
+	_mm_storeu_ps(result, v);
+
+	dst[0] = result[0];
+	dst[1] = result[1];
+	dst[2] = result[2];
+}
+#endif
+
+void skinVertices(float *dst, const float *src, const float *boneIDs, const float *boneWeights, size_t count,
+                  const glm::mat4 *palette, size_t paletteSize, bool simd) {
+
+#ifdef SKINNING_HAVE_SSE2
+	if (simd) {
+		for (size_t i = 0; i < count; i++, dst += 3, src += 3, boneIDs += 4, boneWeights += 4)
+			skinVertexSSE2(dst, src, boneIDs, boneWeights, palette, paletteSize);
+
+		return;
+	}
+#else
+	UNUSED(simd);
+#endif
+
+	for (size_t i = 0; i < count; i++, dst += 3, src += 3, boneIDs += 4, boneWeights += 4)
+		skinVertex(dst, src, boneIDs, boneWeights, palette, paletteSize);
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
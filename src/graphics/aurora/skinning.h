@@ -0,0 +1,60 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Skinning vertices with a palette of bone matrices.
+ */
+
+#ifndef GRAPHICS_AURORA_SKINNING_H
+#define GRAPHICS_AURORA_SKINNING_H
+
+#include "glm/mat4x4.hpp"
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** Transform vertices by a weighted sum of up to four bone matrices each.
+ *
+ *  The bone matrices need to be affine: each vertex is transformed as
+ *  (x, y, z, 1), and the resulting w is ignored.
+ *
+ *  @param dst         count * 3 floats to write the skinned vertex coordinates to.
+ *  @param src         count * 3 floats of vertex coordinates to skin.
+ *  @param boneIDs     count * 4 indices into the palette, stored as floats. -1 for no bone.
+ *  @param boneWeights count * 4 weights of these bones.
+ *  @param count       The number of vertices.
+ *  @param palette     The bone matrices.
+ *  @param paletteSize The number of bone matrices. Bones outside the palette are ignored.
+ *  @param simd        Use SIMD instructions, if available.
+ */
+void skinVertices(float *dst, const float *src, const float *boneIDs, const float *boneWeights, size_t count,
+                  const glm::mat4 *palette, size_t paletteSize, bool simd = true);
+
+/** Do we have a SIMD skinning kernel? */
+bool hasSIMDSkinning();
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_SKINNING_H
@@ -398,6 +398,24 @@ void Texture::set(const Common::UString &name, ImageDecoder *image, ::Aurora::Fi
 	_deswizzle = deswizzle;
 }
 
+void Texture::setLoadedImage(ImageDecoder *image, ::Aurora::FileType type) {
+	assert(image);
+
+	removeFromQueues();
+
+	// The placeholder was a 2D texture, but the real image might be a cube map
+	doDestroy();
+
+	_type = type;
+
+	_image.reset(image);
+
+	_width  = _image->getMipMap(0).width;
+	_height = _image->getMipMap(0).height;
+
+	addToQueues();
+}
+
 ImageDecoder *Texture::loadImage(const Common::UString &name, bool deswizzle) {
 	::Aurora::FileType type;
 
@@ -515,6 +533,32 @@ TXI *Texture::loadTXI(const Common::UString &name) {
 	return txi;
 }
 
+TXI *Texture::loadEmbeddedTXI(const Common::UString &name) {
+	// Only TPC and TXB images embed their TXI
+	if (!ResMan.hasResource(name, ::Aurora::kFileTypeTPC) && !ResMan.hasResource(name, ::Aurora::kFileTypeTXB))
+		return 0;
+
+	::Aurora::FileType type = ::Aurora::kFileTypeNone;
+	Common::ScopedPtr<Common::SeekableReadStream> imageStream(ResMan.getResource(::Aurora::kResourceImage, name, &type));
+	if (!imageStream || ((type != ::Aurora::kFileTypeTPC) && (type != ::Aurora::kFileTypeTXB)))
+		return 0;
+
+	Common::ScopedPtr<TXI> txi(new TXI);
+	try {
+		const bool hasTXI = (type == ::Aurora::kFileTypeTPC) ?
+			TPC::readEmbeddedTXI(*imageStream, *txi) : TXB::readEmbeddedTXI(*imageStream, *txi);
+
+		if (!hasTXI)
+			return 0;
+
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed loading embedded TXI \"%s\"", name.c_str());
+		return 0;
+	}
+
+	return txi.release();
+}
+
 } // End of namespace Aurora
 
 } // End of namespace Graphics
@@ -122,6 +122,9 @@ protected:
 	void setMipMapData(GLenum target, size_t layer, size_t mipMap);
 
 	static TXI *loadTXI(const Common::UString &name);
+	/** Load only the TXI embedded into this image resource, if it has one. */
+	static TXI *loadEmbeddedTXI(const Common::UString &name);
+
 	static ImageDecoder *loadImage(Common::SeekableReadStream *imageStream, ::Aurora::FileType type,
 	                               TXI *txi = 0, bool deswizzle = false);
 
@@ -129,6 +132,12 @@ protected:
 	                               bool deswizzle = false);
 
 	static Texture *createPLT(const Common::UString &name, Common::SeekableReadStream *imageStream);
+
+	/** Replace the placeholder image with the image that was loaded in the background. */
+	void setLoadedImage(ImageDecoder *image, ::Aurora::FileType type);
+
+	friend class TextureManager;
+	friend class TextureLoader;
 };
 
 } // End of namespace Aurora
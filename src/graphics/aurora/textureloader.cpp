@@ -0,0 +1,256 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of threads loading Aurora textures in the background.
+ */
+
+#include <cassert>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/thread.h"
+
+#include "src/graphics/images/txi.h"
+#include "src/graphics/images/decoder.h"
+
+#include "src/graphics/aurora/textureloader.h"
+#include "src/graphics/aurora/texture.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** How long a worker waits for a new request before checking whether it should stop. */
+static const uint32 kWorkerTimeout = 100;
+
+/** A thread loading queued texture images. */
+class TextureLoader::Worker : public Common::Thread {
+public:
+	Worker(TextureLoader &loader) : _loader(&loader) {
+	}
+
+	~Worker() {
+		destroyThread();
+	}
+
+private:
+	TextureLoader *_loader;
+
+	void threadMethod() {
+		while (!_killThread.load(boost::memory_order_relaxed)) {
+			Request request;
+			if (!_loader->takeRequest(request))
+				continue;
+
+			ImageDecoder *image = 0;
+			::Aurora::FileType type = ::Aurora::kFileTypeNone;
+
+			try {
+				image = Texture::loadImage(request.name, type, request.txi, request.deswizzle);
+			} catch (...) {
+				Common::exceptionDispatcherWarning("Failed loading texture \"%s\" in the background",
+				                                   request.name.c_str());
+			}
+
+			_loader->finishRequest(request, image, type);
+
+			freeRequest(request);
+		}
+	}
+};
+
+
+TextureLoader::Result::Result() : texture(0), image(0), type(::Aurora::kFileTypeNone) {
+}
+
+TextureLoader::Request::Request() : id(0), texture(0), txi(0), deswizzle(false) {
+}
+
+
+TextureLoader::TextureLoader() : _queued(0), _nextID(0) {
+}
+
+TextureLoader::~TextureLoader() {
+	stop();
+}
+
+void TextureLoader::start(size_t threadCount) {
+	stop();
+
+	for (size_t i = 0; i < threadCount; i++) {
+		_workers.push_back(new Worker(*this));
+
+		if (!_workers.back()->createThread(Common::UString::format("TextureLoader%u", (uint) i)))
+			throw Common::Exception("Failed to create a texture loader thread");
+	}
+}
+
+void TextureLoader::stop() {
+	// Destroying the workers waits for them to finish their current request
+	_workers.clear();
+
+	clear();
+}
+
+bool TextureLoader::isRunning() const {
+	return !_workers.empty();
+}
+
+void TextureLoader::add(Texture *texture, const Common::UString &name, const TXI *txi,
+                        bool deswizzle, Priority priority) {
+
+	assert(texture);
+	assert((priority >= 0) && (priority < kPriorityMAX));
+
+	Common::StackLock lock(_mutex);
+
+	_requests[priority].push_back(Request());
+
+	Request &request = _requests[priority].back();
+
+	request.id        = _nextID++;
+	request.texture   = texture;
+	request.name      = name;
+	request.txi       = txi ? new TXI(*txi) : 0;
+	request.deswizzle = deswizzle;
+
+	_queued.unlock();
+}
+
+void TextureLoader::cancel(Texture *texture) {
+	Common::StackLock lock(_mutex);
+
+	for (size_t i = 0; i < kPriorityMAX; i++) {
+		for (Requests::iterator r = _requests[i].begin(); r != _requests[i].end(); ) {
+			if (r->texture != texture) {
+				++r;
+				continue;
+			}
+
+			freeRequest(*r);
+			r = _requests[i].erase(r);
+		}
+	}
+
+	// The worker will notice that its request is gone and drop the image
+	for (Requests::iterator r = _inProgress.begin(); r != _inProgress.end(); ) {
+		if (r->texture == texture)
+			r = _inProgress.erase(r);
+		else
+			++r;
+	}
+
+	for (Results::iterator r = _finished.begin(); r != _finished.end(); ) {
+		if (r->texture != texture) {
+			++r;
+			continue;
+		}
+
+		freeResult(*r);
+		r = _finished.erase(r);
+	}
+}
+
+void TextureLoader::clear() {
+	Common::StackLock lock(_mutex);
+
+	for (size_t i = 0; i < kPriorityMAX; i++) {
+		for (Requests::iterator r = _requests[i].begin(); r != _requests[i].end(); ++r)
+			freeRequest(*r);
+
+		_requests[i].clear();
+	}
+
+	_inProgress.clear();
+
+	for (Results::iterator r = _finished.begin(); r != _finished.end(); ++r)
+		freeResult(*r);
+
+	_finished.clear();
+}
+
+void TextureLoader::getFinished(Results &results) {
+	Common::StackLock lock(_mutex);
+
+	results.splice(results.end(), _finished);
+}
+
+bool TextureLoader::takeRequest(Request &request) {
+	if (!_queued.lock(kWorkerTimeout))
+		return false;
+
+	Common::StackLock lock(_mutex);
+
+	for (size_t i = 0; i < kPriorityMAX; i++) {
+		if (_requests[i].empty())
+			continue;
+
+		request = _requests[i].front();
+		_requests[i].pop_front();
+
+		// The worker takes over the TXI, the copy in progress is only used to find the request
+		_inProgress.push_back(request);
+		_inProgress.back().txi = 0;
+
+		return true;
+	}
+
+	// All requests were cancelled in the meantime
+	return false;
+}
+
+void TextureLoader::finishRequest(const Request &request, ImageDecoder *image, ::Aurora::FileType type) {
+	Common::StackLock lock(_mutex);
+
+	for (Requests::iterator r = _inProgress.begin(); r != _inProgress.end(); ++r) {
+		if (r->id != request.id)
+			continue;
+
+		_inProgress.erase(r);
+
+		_finished.push_back(Result());
+
+		_finished.back().texture = request.texture;
+		_finished.back().image   = image;
+		_finished.back().type    = type;
+
+		return;
+	}
+
+	// The request was cancelled while we were loading it
+	delete image;
+}
+
+void TextureLoader::freeRequest(Request &request) {
+	delete request.txi;
+
+	request.txi = 0;
+}
+
+void TextureLoader::freeResult(Result &result) {
+	delete result.image;
+
+	result.image = 0;
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
@@ -0,0 +1,147 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of threads loading Aurora textures in the background.
+ */
+
+#ifndef GRAPHICS_AURORA_TEXTURELOADER_H
+#define GRAPHICS_AURORA_TEXTURELOADER_H
+
+#include <list>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+#include "src/common/ptrvector.h"
+
+#include "src/aurora/types.h"
+
+namespace Graphics {
+
+class ImageDecoder;
+class TXI;
+
+namespace Aurora {
+
+class Texture;
+
+/** A pool of threads reading and decoding texture images in the background.
+ *
+ *  The loader only ever produces images. Handing them over to the textures
+ *  they were loaded for, and uploading them into OpenGL, is left to the
+ *  TextureManager, on the main thread.
+ */
+class TextureLoader : boost::noncopyable {
+public:
+	/** The priority of a load request. */
+	enum Priority {
+		kPriorityGUI   = 0, ///< A GUI texture, loaded before all world textures.
+		kPriorityWorld    , ///< A texture in the game world.
+		kPriorityMAX        ///< For range checks.
+	};
+
+	/** A finished load request. */
+	struct Result {
+		Texture *texture; ///< The texture the image was loaded for.
+
+		ImageDecoder      *image; ///< The loaded image, or 0 if loading failed.
+		::Aurora::FileType type;  ///< The type of the image's file.
+
+		Result();
+	};
+
+	typedef std::list<Result> Results;
+
+	TextureLoader();
+	~TextureLoader();
+
+	/** Start the loading threads. */
+	void start(size_t threadCount);
+	/** Stop all loading threads, dropping all requests. */
+	void stop();
+
+	/** Are there any loading threads running? */
+	bool isRunning() const;
+
+	/** Queue the loading of a texture's image.
+	 *
+	 *  @param texture The texture the image is for. Only used to identify the request.
+	 *  @param name The name of the image resource.
+	 *  @param txi The TXI of the texture, if any. Will be copied.
+	 *  @param deswizzle Deswizzle SBM images?
+	 *  @param priority The priority of the request.
+	 */
+	void add(Texture *texture, const Common::UString &name, const TXI *txi, bool deswizzle, Priority priority);
+
+	/** Drop all requests for this texture, whether queued, in progress or finished. */
+	void cancel(Texture *texture);
+	/** Drop all requests. */
+	void clear();
+
+	/** Take over all finished requests. The caller takes over the images. */
+	void getFinished(Results &results);
+
+private:
+	class Worker;
+
+	/** A request to load a texture's image. */
+	struct Request {
+		uint32   id;
+		Texture *texture;
+
+		Common::UString name;
+		TXI *txi;
+		bool deswizzle;
+
+		Request();
+	};
+
+	typedef std::list<Request> Requests;
+
+	Common::PtrVector<Worker> _workers;
+
+	/** Protects the request lists. */
+	mutable Common::Mutex _mutex;
+	/** Counts the queued requests. */
+	Common::Semaphore _queued;
+
+	uint32 _nextID; ///< The ID of the next request.
+
+	Requests _requests[kPriorityMAX]; ///< Requests waiting to be loaded, by priority.
+	Requests _inProgress;             ///< Requests currently being loaded.
+	Results  _finished;               ///< Requests that finished loading.
+
+	/** Take the next request out of the queue. Returns false if the worker should check its kill flag. */
+	bool takeRequest(Request &request);
+	/** Hand over the result of a request. */
+	void finishRequest(const Request &request, ImageDecoder *image, ::Aurora::FileType type);
+
+	static void freeRequest(Request &request);
+	static void freeResult(Result &result);
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_TEXTURELOADER_H
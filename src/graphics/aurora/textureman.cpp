@@ -31,11 +31,15 @@
 #include "src/graphics/aurora/texture.h"
 
 #include "src/graphics/images/decoder.h"
+#include "src/graphics/images/surface.h"
+#include "src/graphics/images/txi.h"
 
 #include "src/graphics/graphics.h"
 
 #include "src/events/requests.h"
 
+#include "src/aurora/resman.h"
+
 DECLARE_SINGLETON(Graphics::Aurora::TextureManager)
 
 namespace Graphics {
@@ -90,6 +94,8 @@ TextureManager::~TextureManager() {
 void TextureManager::clear() {
 	Common::StackLock lock(_mutex);
 
+	_loader.clear();
+
 	_bogusTextures.clear();
 
 	for (TextureMap::iterator t = _textures.begin(); t != _textures.end(); ++t)
@@ -149,7 +155,7 @@ TextureHandle TextureManager::add(Texture *texture, Common::UString name) {
 	return TextureHandle(textureIterator);
 }
 
-TextureHandle TextureManager::get(Common::UString name) {
+TextureHandle TextureManager::get(Common::UString name, LoadPriority priority) {
 	Common::StackLock lock(_mutex);
 
 	if (_bogusTextures.find(name) != _bogusTextures.end())
@@ -159,7 +165,13 @@ TextureHandle TextureManager::get(Common::UString name) {
 	if (texture == _textures.end()) {
 		std::pair<TextureMap::iterator, bool> result;
 
-		ManagedTexture *managedTexture = new ManagedTexture(Texture::create(name, _deswizzleSBM));
+		Texture *newTexture = 0;
+		if (priority != kLoadImmediate)
+			newTexture = createPlaceholder(name, priority);
+		if (!newTexture)
+			newTexture = Texture::create(name, _deswizzleSBM);
+
+		ManagedTexture *managedTexture = new ManagedTexture(newTexture);
 
 		if (managedTexture->texture->isDynamic())
 			name = name + "#" + Common::generateIDRandomString();
@@ -188,6 +200,38 @@ TextureHandle TextureManager::getIfExist(const Common::UString &name) {
 	return TextureHandle();
 }
 
+Texture *TextureManager::createPlaceholder(const Common::UString &name, LoadPriority priority) {
+	if (!_loader.isRunning())
+		return 0;
+
+	/* Only plain images can be loaded in the background. Cube maps with
+	 * a file for each side, PLT textures (which are dynamic) and missing
+	 * images (which throw) are all left to the synchronous path. */
+	if (!ResMan.hasResource(name, ::Aurora::kResourceImage) || ResMan.hasResource(name, ::Aurora::kFileTypePLT))
+		return 0;
+
+	TXI *txi = Texture::loadTXI(name);
+
+	/* Without a TXI file, the TXI embedded into TPC and TXB images is used.
+	 * Callers check its features right away, long before the image itself
+	 * is loaded, so read it now. The loader still only gets the TXI file,
+	 * just like the synchronous path. */
+	TXI *textureTXI = txi ? txi : Texture::loadEmbeddedTXI(name);
+
+	Surface *placeholder = new Surface(1, 1);
+	if (priority == kLoadGUI)
+		placeholder->fill(0x00, 0x00, 0x00, 0x00);
+	else
+		placeholder->fill(0x80, 0x80, 0x80, 0xFF);
+
+	Texture *texture = new Texture(name, placeholder, ::Aurora::kFileTypeNone, textureTXI, _deswizzleSBM);
+
+	_loader.add(texture, name, txi, _deswizzleSBM,
+	            (priority == kLoadGUI) ? TextureLoader::kPriorityGUI : TextureLoader::kPriorityWorld);
+
+	return texture;
+}
+
 void TextureManager::startRecordNewTextures() {
 	Common::StackLock lock(_mutex);
 
@@ -219,6 +263,8 @@ void TextureManager::release(TextureHandle &texture) {
 
 	if (!texture._empty && (texture._it != _textures.end())) {
 		if (--texture._it->second->referenceCount == 0) {
+			_loader.cancel(texture._it->second->texture);
+
 			delete texture._it->second;
 			_textures.erase(texture._it);
 		}
@@ -245,6 +291,33 @@ void TextureManager::reloadAll() {
 	GfxMan.unlockFrame();
 }
 
+void TextureManager::startBackgroundLoading(size_t threadCount) {
+	Common::StackLock lock(_mutex);
+
+	_loader.start(threadCount);
+}
+
+void TextureManager::stopBackgroundLoading() {
+	Common::StackLock lock(_mutex);
+
+	_loader.stop();
+}
+
+void TextureManager::swapLoadedTextures() {
+	Common::StackLock lock(_mutex);
+
+	TextureLoader::Results loaded;
+	_loader.getFinished(loaded);
+
+	for (TextureLoader::Results::iterator l = loaded.begin(); l != loaded.end(); ++l) {
+		// Loading failed, keep the placeholder
+		if (!l->image)
+			continue;
+
+		l->texture->setLoadedImage(l->image, l->type);
+	}
+}
+
 void TextureManager::reset() {
 	for (size_t i = 0; i < kTextureUnitCount; i++) {
 		activeTexture(i);
@@ -34,6 +34,7 @@
 #include "src/common/ustring.h"
 
 #include "src/graphics/aurora/texturehandle.h"
+#include "src/graphics/aurora/textureloader.h"
 
 namespace Graphics {
 
@@ -48,6 +49,13 @@ public:
 		kModeEnvironmentMapReflective ///< A reflective environment map.
 	};
 
+	/** How urgently a texture is needed. */
+	enum LoadPriority {
+		kLoadImmediate, ///< Load the texture right away.
+		kLoadGUI,       ///< Load the texture in the background if possible, before any world textures.
+		kLoadWorld      ///< Load the texture in the background if possible.
+	};
+
 	TextureManager();
 	~TextureManager();
 
@@ -76,8 +84,16 @@ public:
 
 	/** Add this texture to the TextureManager. If name is empty, generate a random one. */
 	TextureHandle add(Texture *texture, Common::UString name = "");
-	/** Retrieve this named texture, loading it if it's not yet managed. */
-	TextureHandle get(Common::UString name);
+	/** Retrieve this named texture, loading it if it's not yet managed.
+	 *
+	 *  If background loading is enabled and the priority isn't kLoadImmediate,
+	 *  a new texture is returned as a 1x1 placeholder straight away. Its image
+	 *  is then loaded in the background, and swapped in on the main thread by
+	 *  swapLoadedTextures(). Only the TXI, from a TXI file or embedded into a
+	 *  TPC or TXB image, is available immediately, so this is only useful to
+	 *  callers that don't need to look at the image itself.
+	 */
+	TextureHandle get(Common::UString name, LoadPriority priority = kLoadImmediate);
 	/** Retrieve this named texture, returning an empty handle if it's not managed. */
 	TextureHandle getIfExist(const Common::UString &name);
 
@@ -90,6 +106,19 @@ public:
 	void reloadAll();
 	// '---
 
+	// .--- Background loading
+	/** Start loading textures in the background, with that many threads. */
+	void startBackgroundLoading(size_t threadCount);
+	/** Stop loading textures in the background. Unfinished textures keep their placeholder. */
+	void stopBackgroundLoading();
+
+	/** Swap all textures finished loading in the background into their placeholders.
+	 *
+	 *  Needs to be called from the main thread.
+	 */
+	void swapLoadedTextures();
+	// '---
+
 	// .--- Texture rendering
 	/** Bind this texture to the current texture unit. */
 	void set(const TextureHandle &handle, TextureMode mode = kModeDiffuse);
@@ -110,9 +139,14 @@ private:
 
 	Common::Mutex _mutex;
 
+	TextureLoader _loader;
+
 	bool _recordNewTextures;
 	std::list<Common::UString> _newTextureNames;
 
+	/** Create a placeholder texture and queue its image to be loaded in the background. */
+	Texture *createPlaceholder(const Common::UString &name, LoadPriority priority);
+
 	void assign(TextureHandle &texture, const TextureHandle &from);
 	void release(TextureHandle &texture);
 
@@ -22,10 +22,6 @@
  *  Generic renderable walkmesh.
  */
 
-#include "glm/gtc/type_ptr.hpp"
-#include "glm/gtx/intersect.hpp"
-
-#include "src/common/maths.h"
 #include "src/common/util.h"
 
 #include "src/graphics/aurora/walkmesh.h"
@@ -41,66 +37,20 @@ Walkmesh::Walkmesh()
 }
 
 float Walkmesh::getElevationAt(float x, float y, uint32 &faceIndex) const {
-	if (_indicesWalkable.empty())
-		return FLT_MIN;
-
-	size_t faceCount = _indicesWalkable.size() / 3;
-	const float *vertices = _vertices.data();
-	uint32 index = 0;
-
-	glm::vec3 v0, v1, v2, intersection;
-	glm::vec3 orig = glm::vec3(x, y, 1000.0f);
-
-	for (size_t i = 0; i < faceCount; ++i) {
-		v0 = glm::make_vec3(vertices + 3 * _indicesWalkable[index + 0]);
-		v1 = glm::make_vec3(vertices + 3 * _indicesWalkable[index + 1]);
-		v2 = glm::make_vec3(vertices + 3 * _indicesWalkable[index + 2]);
-		index += 3;
-
-		if (glm::intersectRayTriangle(orig, glm::vec3(0.0f, 0.0f, -1.0f), v0, v1, v2, intersection)) {
-			faceIndex = i;
-			return (v0 * (1.0f - intersection.x - intersection.y) +
-			        v1 * intersection.x +
-			        v2 * intersection.y).z;
-		}
-	}
-
-	return FLT_MIN;
+	return _gridWalkable.getElevationAt(x, y, faceIndex);
 }
 
 bool Walkmesh::testCollision(const glm::vec3 &orig, const glm::vec3 &dest) const {
-	if (_indicesNonWalkable.empty())
-		return false;
-
-	size_t faceCount = _indicesNonWalkable.size() / 3;
-	const float *vertices = _vertices.data();
-	uint32 index = 0;
+	return _gridNonWalkable.testCollision(orig, dest);
+}
 
-	glm::vec3 adjDest = glm::vec3(dest.x, dest.y, 1000.0f);
-	glm::vec3 v0, v1, v2, intersection;
-	glm::vec3 dir = glm::normalize(dest - orig);
+Common::BoundingBox Walkmesh::getBoundingBox() const {
+	Common::BoundingBox box;
 
-	for (size_t i = 0; i < faceCount; ++i) {
-		v0 = glm::make_vec3(vertices + 3 * _indicesNonWalkable[index + 0]);
-		v1 = glm::make_vec3(vertices + 3 * _indicesNonWalkable[index + 1]);
-		v2 = glm::make_vec3(vertices + 3 * _indicesNonWalkable[index + 2]);
-		index += 3;
+	for (size_t i = 0; (i + 2) < _vertices.size(); i += 3)
+		box.add(_vertices[i + 0], _vertices[i + 1], _vertices[i + 2]);
 
-		// Intersection with horizontal objects
-		if (glm::intersectRayTriangle(adjDest, glm::vec3(0.0f, 0.0f, -1.0f), v0, v1, v2, intersection))
-			return true;
-
-		// Intersection with vertical objects
-		if (glm::intersectRayTriangle(orig, dir, v0, v1, v2, intersection)) {
-			glm::vec3 absIntersection(v0 * (1.0f - intersection.x - intersection.y) +
-			                          v1 * intersection.x +
-			                          v2 * intersection.y);
-			if (glm::distance(orig, absIntersection) <= glm::distance(orig, dest))
-				return true;
-		}
-	}
-
-	return false;
+	return box;
 }
 
 void Walkmesh::highlightFace(uint32 index) {
@@ -167,6 +117,9 @@ void Walkmesh::refreshIndexGroups() {
 
 		index += 3;
 	}
+
+	_gridWalkable.build(_vertices, _indicesWalkable);
+	_gridNonWalkable.build(_vertices, _indicesNonWalkable);
 }
 
 } // End of namespace Aurora
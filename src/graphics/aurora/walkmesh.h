@@ -31,9 +31,12 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/boundingbox.h"
 
 #include "src/graphics/renderable.h"
 
+#include "src/graphics/aurora/walkmeshgrid.h"
+
 namespace Graphics {
 
 namespace Aurora {
@@ -51,6 +54,9 @@ public:
 
 	bool testCollision(const glm::vec3 &orig, const glm::vec3 &dest) const;
 
+	/** Return the bounding box around all faces of the walkmesh. */
+	Common::BoundingBox getBoundingBox() const;
+
 	// .--- Rendering
 
 	/** Highlight face with specified index.
@@ -74,6 +80,11 @@ protected:
 	int _highlightFaceIndex;
 	bool _invisible;
 
+	/** Spatial grids over the walkable and non-walkable faces, for elevation and collision queries. */
+	WalkmeshGrid _gridWalkable;
+	WalkmeshGrid _gridNonWalkable;
+
+	/** Sort the faces into walkable and non-walkable, and rebuild the grids. */
 	void refreshIndexGroups();
 };
 
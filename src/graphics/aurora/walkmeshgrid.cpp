@@ -0,0 +1,294 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A 2D grid over the faces of a walkmesh, for fast elevation and collision queries.
+ */
+
+#include <cmath>
+
+#include "glm/gtc/type_ptr.hpp"
+#include "glm/gtx/intersect.hpp"
+
+#include "src/common/maths.h"
+#include "src/common/util.h"
+
+#include "src/graphics/aurora/walkmeshgrid.h"
+
+/** How far to grow the bounding rectangle of each face.
+ *
+ *  A ray can be found to intersect a face even if it misses the face's
+ *  exact bounds by a rounding error. Overestimating the bounds a bit makes
+ *  sure the grid still sorts the face into the ray's cell.
+ */
+static const float kFacePadding = 0.01f;
+
+/** The maximum number of cells per face in the grid. */
+static const size_t kMaxCellsPerFace = 4;
+
+/** The maximum width and height of the grid. */
+static const uint32 kMaxGridSize = 1024;
+
+namespace Graphics {
+
+namespace Aurora {
+
+WalkmeshGrid::WalkmeshGrid() : _minX(0.0f), _minY(0.0f), _maxX(0.0f), _maxY(0.0f),
+	_cellSize(1.0f), _width(0), _height(0) {
+}
+
+void WalkmeshGrid::clear() {
+	_faces.clear();
+	_cellStart.clear();
+	_cellFaces.clear();
+
+	_width  = 0;
+	_height = 0;
+}
+
+size_t WalkmeshGrid::getFaceCount() const {
+	return _faces.size() / 9;
+}
+
+void WalkmeshGrid::getFace(uint32 face, glm::vec3 &v0, glm::vec3 &v1, glm::vec3 &v2) const {
+	const float *vertices = &_faces[9 * face];
+
+	v0 = glm::make_vec3(vertices + 0);
+	v1 = glm::make_vec3(vertices + 3);
+	v2 = glm::make_vec3(vertices + 6);
+}
+
+void WalkmeshGrid::build(const std::vector<float> &vertices, const std::vector<uint32> &indices) {
+	clear();
+
+	const size_t faceCount = indices.size() / 3;
+	if (faceCount == 0)
+		return;
+
+	_faces.resize(faceCount * 9);
+	for (size_t i = 0; i < faceCount * 3; i++)
+		for (size_t j = 0; j < 3; j++)
+			_faces[i * 3 + j] = vertices[indices[i] * 3 + j];
+
+	// Find the bounds of every face, and of the whole walkmesh
+
+	std::vector<float> bounds(faceCount * 4);
+
+	_minX = _minY =  FLT_MAX;
+	_maxX = _maxY = -FLT_MAX;
+
+	double extentSum = 0.0;
+	for (size_t i = 0; i < faceCount; i++) {
+		const float *v = &_faces[i * 9];
+
+		float *b = &bounds[i * 4];
+
+		b[0] = MIN(MIN(v[0], v[3]), v[6]) - kFacePadding;
+		b[1] = MIN(MIN(v[1], v[4]), v[7]) - kFacePadding;
+		b[2] = MAX(MAX(v[0], v[3]), v[6]) + kFacePadding;
+		b[3] = MAX(MAX(v[1], v[4]), v[7]) + kFacePadding;
+
+		_minX = MIN(_minX, b[0]);
+		_minY = MIN(_minY, b[1]);
+		_maxX = MAX(_maxX, b[2]);
+		_maxY = MAX(_maxY, b[3]);
+
+		extentSum += MAX(b[2] - b[0], b[3] - b[1]);
+	}
+
+	/* Make the cells about as large as an average face, but don't let the
+	 * grid grow too large when there are a few huge faces spread wide apart. */
+
+	_cellSize = MAX<float>(extentSum / faceCount, kFacePadding);
+
+	const float extentX = _maxX - _minX;
+	const float extentY = _maxY - _minY;
+
+	_cellSize = MAX(_cellSize, MAX(extentX, extentY) / kMaxGridSize);
+	while (((extentX / _cellSize) * (extentY / _cellSize)) > (faceCount * kMaxCellsPerFace))
+		_cellSize *= 1.5f;
+
+	_width  = MIN<uint32>((uint32) (extentX / _cellSize) + 1, kMaxGridSize);
+	_height = MIN<uint32>((uint32) (extentY / _cellSize) + 1, kMaxGridSize);
+
+	// Count the faces in each cell, then fill in the face lists, in ascending order
+
+	_cellStart.resize(_width * _height + 1, 0);
+
+	for (size_t pass = 0; pass < 2; pass++) {
+		std::vector<uint32> cellPos;
+		if (pass == 1) {
+			for (size_t i = 1; i < _cellStart.size(); i++)
+				_cellStart[i] += _cellStart[i - 1];
+
+			_cellFaces.resize(_cellStart.back());
+			cellPos.assign(_cellStart.begin(), _cellStart.end() - 1);
+		}
+
+		for (size_t i = 0; i < faceCount; i++) {
+			const float *b = &bounds[i * 4];
+
+			uint32 x1, y1, x2, y2;
+			if (!getCells(b[0], b[1], b[2], b[3], x1, y1, x2, y2))
+				continue;
+
+			for (uint32 y = y1; y <= y2; y++) {
+				for (uint32 x = x1; x <= x2; x++) {
+					if (pass == 0)
+						_cellStart[y * _width + x + 1]++;
+					else
+						_cellFaces[cellPos[y * _width + x]++] = i;
+				}
+			}
+		}
+	}
+}
+
+bool WalkmeshGrid::getCells(float minX, float minY, float maxX, float maxY,
+                            uint32 &x1, uint32 &y1, uint32 &x2, uint32 &y2) const {
+
+	if ((_width == 0) || (_height == 0))
+		return false;
+
+	// Also weeds out NaNs
+	if (!(maxX >= _minX) || !(maxY >= _minY) || !(minX <= _maxX) || !(minY <= _maxY))
+		return false;
+
+	x1 = MIN<uint32>((uint32) ((MAX(minX, _minX) - _minX) / _cellSize), _width  - 1);
+	y1 = MIN<uint32>((uint32) ((MAX(minY, _minY) - _minY) / _cellSize), _height - 1);
+	x2 = MIN<uint32>((uint32) ((MIN(maxX, _maxX) - _minX) / _cellSize), _width  - 1);
+	y2 = MIN<uint32>((uint32) ((MIN(maxY, _maxY) - _minY) / _cellSize), _height - 1);
+
+	return true;
+}
+
+bool WalkmeshGrid::testElevation(uint32 face, const glm::vec3 &orig, float &z) const {
+	glm::vec3 v0, v1, v2, intersection;
+	getFace(face, v0, v1, v2);
+
+	if (!glm::intersectRayTriangle(orig, glm::vec3(0.0f, 0.0f, -1.0f), v0, v1, v2, intersection))
+		return false;
+
+	z = (v0 * (1.0f - intersection.x - intersection.y) +
+	     v1 * intersection.x +
+	     v2 * intersection.y).z;
+
+	return true;
+}
+
+float WalkmeshGrid::getElevationAt(float x, float y, uint32 &faceIndex, bool bruteForce) const {
+	const glm::vec3 orig(x, y, 1000.0f);
+
+	float z;
+
+	if (bruteForce) {
+		const size_t faceCount = getFaceCount();
+
+		for (size_t i = 0; i < faceCount; i++) {
+			if (testElevation(i, orig, z)) {
+				faceIndex = i;
+				return z;
+			}
+		}
+
+		return FLT_MIN;
+	}
+
+	/* A face intersecting the ray has to overlap the point's cell. And since
+	 * the faces of a cell are sorted, the first one found is also the first
+	 * one the brute-force search would find. */
+
+	uint32 cellX, cellY, cellX2, cellY2;
+	if (!getCells(x, y, x, y, cellX, cellY, cellX2, cellY2))
+		return FLT_MIN;
+
+	const uint32 cell = cellY * _width + cellX;
+	for (uint32 i = _cellStart[cell]; i < _cellStart[cell + 1]; i++) {
+		if (testElevation(_cellFaces[i], orig, z)) {
+			faceIndex = _cellFaces[i];
+			return z;
+		}
+	}
+
+	return FLT_MIN;
+}
+
+bool WalkmeshGrid::testCollision(uint32 face, const glm::vec3 &orig, const glm::vec3 &dest,
+                                 const glm::vec3 &adjDest, const glm::vec3 &dir) const {
+
+	glm::vec3 v0, v1, v2, intersection;
+	getFace(face, v0, v1, v2);
+
+	// Intersection with horizontal objects
+	if (glm::intersectRayTriangle(adjDest, glm::vec3(0.0f, 0.0f, -1.0f), v0, v1, v2, intersection))
+		return true;
+
+	// Intersection with vertical objects
+	if (glm::intersectRayTriangle(orig, dir, v0, v1, v2, intersection)) {
+		glm::vec3 absIntersection(v0 * (1.0f - intersection.x - intersection.y) +
+		                          v1 * intersection.x +
+		                          v2 * intersection.y);
+		if (glm::distance(orig, absIntersection) <= glm::distance(orig, dest))
+			return true;
+	}
+
+	return false;
+}
+
+bool WalkmeshGrid::testCollision(const glm::vec3 &orig, const glm::vec3 &dest, bool bruteForce) const {
+	const glm::vec3 adjDest = glm::vec3(dest.x, dest.y, 1000.0f);
+	const glm::vec3 dir = glm::normalize(dest - orig);
+
+	if (bruteForce) {
+		const size_t faceCount = getFaceCount();
+
+		for (size_t i = 0; i < faceCount; i++)
+			if (testCollision(i, orig, dest, adjDest, dir))
+				return true;
+
+		return false;
+	}
+
+	/* Any intersection point lies on a face, and no farther away from orig
+	 * than dest. So all faces that can collide overlap the square around
+	 * orig that has dest within it. */
+
+	const float distance = glm::distance(orig, dest);
+
+	uint32 x1, y1, x2, y2;
+	if (!getCells(orig.x - distance, orig.y - distance, orig.x + distance, orig.y + distance, x1, y1, x2, y2))
+		return false;
+
+	for (uint32 y = y1; y <= y2; y++) {
+		for (uint32 x = x1; x <= x2; x++) {
+			const uint32 cell = y * _width + x;
+
+			for (uint32 i = _cellStart[cell]; i < _cellStart[cell + 1]; i++)
+				if (testCollision(_cellFaces[i], orig, dest, adjDest, dir))
+					return true;
+		}
+	}
+
+	return false;
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
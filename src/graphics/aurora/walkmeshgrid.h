@@ -0,0 +1,115 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A 2D grid over the faces of a walkmesh, for fast elevation and collision queries.
+ */
+
+#ifndef GRAPHICS_AURORA_WALKMESHGRID_H
+#define GRAPHICS_AURORA_WALKMESHGRID_H
+
+#include <vector>
+
+#include "glm/vec3.hpp"
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** A uniform grid over the XY plane, sorting the faces of a walkmesh into cells.
+ *
+ *  Each cell holds, in ascending order, the indices of all faces whose
+ *  bounding rectangle overlaps the cell. A query only needs to test the
+ *  faces in the cells it touches, instead of every face in the walkmesh.
+ *
+ *  All queries can also be run against all faces, in a brute-force way.
+ *  Both ways always produce the same results.
+ */
+class WalkmeshGrid {
+public:
+	WalkmeshGrid();
+
+	/** Sort the faces of a walkmesh into the grid.
+	 *
+	 *  @param vertices The vertices of the walkmesh, 3 floats each.
+	 *  @param indices  The vertex indices of the faces, 3 per face.
+	 */
+	void build(const std::vector<float> &vertices, const std::vector<uint32> &indices);
+
+	/** Remove all faces from the grid. */
+	void clear();
+
+	/** Return the number of faces in the grid. */
+	size_t getFaceCount() const;
+
+	/** Return the elevation of the first face found straight below the
+	 *  point, or FLT_MIN if there is none.
+	 *
+	 *  @param x          The X coordinate of the point.
+	 *  @param y          The Y coordinate of the point.
+	 *  @param faceIndex  The index of the face found.
+	 *  @param bruteForce Test all faces instead of only the ones in the point's cell.
+	 */
+	float getElevationAt(float x, float y, uint32 &faceIndex, bool bruteForce = false) const;
+
+	/** Does moving from orig to dest collide with any of the faces?
+	 *
+	 *  @param orig       The start of the movement.
+	 *  @param dest       The end of the movement.
+	 *  @param bruteForce Test all faces instead of only the ones in the cells along the movement.
+	 */
+	bool testCollision(const glm::vec3 &orig, const glm::vec3 &dest, bool bruteForce = false) const;
+
+private:
+	/** The vertices of all faces, 9 floats per face. */
+	std::vector<float> _faces;
+
+	float _minX;
+	float _minY;
+	float _maxX;
+	float _maxY;
+
+	float  _cellSize;
+	uint32 _width;
+	uint32 _height;
+
+	/** Where the faces of each cell start in _cellFaces, plus an end marker. */
+	std::vector<uint32> _cellStart;
+	/** The faces of all cells, one cell after the other. */
+	std::vector<uint32> _cellFaces;
+
+	void getFace(uint32 face, glm::vec3 &v0, glm::vec3 &v1, glm::vec3 &v2) const;
+
+	bool testElevation(uint32 face, const glm::vec3 &orig, float &z) const;
+	bool testCollision(uint32 face, const glm::vec3 &orig, const glm::vec3 &dest,
+	                   const glm::vec3 &adjDest, const glm::vec3 &dir) const;
+
+	/** Find the range of cells covering this rectangle. Returns false if it's outside the grid. */
+	bool getCells(float minX, float minY, float maxX, float maxY,
+	              uint32 &x1, uint32 &y1, uint32 &x2, uint32 &y2) const;
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_WALKMESHGRID_H
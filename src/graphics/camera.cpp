@@ -42,7 +42,14 @@ DECLARE_SINGLETON(Graphics::CameraManager)
 
 namespace Graphics {
 
-CameraManager::CameraManager() : _lastChanged(0), _needUpdate(false) {
+/** How far the camera needs to move before the object distances are recalculated.
+ *
+ *  The distances are only used to sort the objects, so small movements are
+ *  ignored. Measured in the same Manhattan metric the distances use.
+ */
+static const float kDistanceThreshold = 0.25f;
+
+CameraManager::CameraManager() : _lastChanged(0), _needUpdate(false), _needDistances(true) {
 	_minPosition[0] = -FLT_MAX;
 	_minPosition[1] = -FLT_MAX;
 	_minPosition[2] = -FLT_MAX;
@@ -63,6 +70,10 @@ CameraManager::CameraManager() : _lastChanged(0), _needUpdate(false) {
 	_orientationCache[0] = 0.0f;
 	_orientationCache[1] = 0.0f;
 	_orientationCache[2] = 0.0f;
+
+	_distancePosition[0] = 0.0f;
+	_distancePosition[1] = 0.0f;
+	_distancePosition[2] = 0.0f;
 }
 
 void CameraManager::update() {
@@ -78,12 +89,31 @@ void CameraManager::update() {
 	memcpy(_positionCache   , _position   , sizeof(_positionCache));
 	memcpy(_orientationCache, _orientation, sizeof(_orientationCache));
 
-	GfxMan.recalculateObjectDistances();
+	/* The object distances only depend on the camera position. Only
+	 * recalculate and resort them when the camera moved far enough. */
+	if (needDistances()) {
+		memcpy(_distancePosition, _positionCache, sizeof(_distancePosition));
+		_needDistances = false;
+
+		GfxMan.recalculateObjectDistances();
+	}
+
 	NotificationMan.cameraMoved();
 
 	GfxMan.unlockFrame();
 }
 
+bool CameraManager::needDistances() const {
+	if (_needDistances)
+		return true;
+
+	const float distance = ABS(_positionCache[0] - _distancePosition[0]) +
+	                       ABS(_positionCache[1] - _distancePosition[1]) +
+	                       ABS(_positionCache[2] - _distancePosition[2]);
+
+	return distance >= kDistanceThreshold;
+}
+
 const float *CameraManager::getPosition() const {
 	return _positionCache;
 }
@@ -109,7 +139,8 @@ void CameraManager::reset() {
 
 	_lastChanged = EventMan.getTimestamp();
 
-	_needUpdate = true;
+	_needUpdate    = true;
+	_needDistances = true;
 }
 
 void CameraManager::limit(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) {
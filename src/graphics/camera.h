@@ -74,7 +74,13 @@ private:
 	float _positionCache[3];    ///< Current position, cached.
 	float _orientationCache[3]; ///< Current orientation, cached.
 
+	float _distancePosition[3]; ///< The position the object distances were last calculated for.
+
 	bool _needUpdate;
+	bool _needDistances; ///< Do the object distances need to be recalculated regardless?
+
+	/** Has the camera moved far enough to warrant recalculating the object distances? */
+	bool needDistances() const;
 };
 
 } // End of namespace Graphics
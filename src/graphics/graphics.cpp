@@ -38,6 +38,7 @@
 #include "src/common/configman.h"
 #include "src/common/debugman.h"
 #include "src/common/threads.h"
+#include "src/common/frustum.h"
 
 #include "src/events/requests.h"
 #include "src/events/events.h"
@@ -62,12 +63,17 @@
 
 #include "src/graphics/render/renderman.h"
 
+#include "src/graphics/aurora/textureman.h"
+
 DECLARE_SINGLETON(Graphics::GraphicsManager)
 
 static glm::mat4 inverse(const glm::mat4 &m);
 
 namespace Graphics {
 
+/** The number of threads loading textures in the background, if enabled. */
+static const size_t kTextureLoaderThreadCount = 2;
+
 PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
 
 GraphicsManager::GraphicsManager() : Events::Notifyable() {
@@ -155,6 +161,9 @@ void GraphicsManager::init() {
 	if (!_animationThread.createThread("Animations"))
 		throw Common::Exception("Failed to create the animation thread");
 
+	if (ConfigMan.getBool("asynctextures", false))
+		TextureMan.startBackgroundLoading(kTextureLoaderThreadCount);
+
 	_ready = true;
 }
 
@@ -164,6 +173,8 @@ void GraphicsManager::deinit() {
 	if (!_ready)
 		return;
 
+	TextureMan.stopBackgroundLoading();
+
 	QueueMan.clearAllQueues();
 
 	_animationThread.pause();
@@ -204,6 +215,10 @@ uint32 GraphicsManager::getFPS() const {
 	return _fpsCounter->getFPS();
 }
 
+Aurora::NodeRenderQueue::Statistics GraphicsManager::getRenderStatistics() {
+	return _nodeRenderQueue.getStatistics();
+}
+
 bool GraphicsManager::setFSAA(int level) {
 	// Force calling it from the main thread
 	if (!Common::isMainThread()) {
@@ -730,8 +745,8 @@ void GraphicsManager::recalculateObjectDistances() {
 	// World objects
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
 
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o)
+	const QueueManager::Queue &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	for (QueueManager::Queue::const_iterator o = objects.begin(); o != objects.end(); ++o)
 		static_cast<Renderable *>(*o)->calculateDistance();
 
 	QueueMan.sortQueue(kQueueVisibleWorldObject);
@@ -740,8 +755,8 @@ void GraphicsManager::recalculateObjectDistances() {
 	// GUI front objects
 	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
 
-	const std::list<Queueable *> &guiFront = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
-	for (std::list<Queueable *>::const_iterator g = guiFront.begin(); g != guiFront.end(); ++g)
+	const QueueManager::Queue &guiFront = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
+	for (QueueManager::Queue::const_iterator g = guiFront.begin(); g != guiFront.end(); ++g)
 		static_cast<Renderable *>(*g)->calculateDistance();
 
 	QueueMan.sortQueue(kQueueVisibleGUIFrontObject);
@@ -750,8 +765,8 @@ void GraphicsManager::recalculateObjectDistances() {
 	// GUI back objects
 	QueueMan.lockQueue(kQueueVisibleGUIBackObject);
 
-	const std::list<Queueable *> &guiBack = QueueMan.getQueue(kQueueVisibleGUIBackObject);
-	for (std::list<Queueable *>::const_iterator g = guiBack.begin(); g != guiBack.end(); ++g)
+	const QueueManager::Queue &guiBack = QueueMan.getQueue(kQueueVisibleGUIBackObject);
+	for (QueueManager::Queue::const_iterator g = guiBack.begin(); g != guiBack.end(); ++g)
 		static_cast<Renderable *>(*g)->calculateDistance();
 
 	QueueMan.sortQueue(kQueueVisibleGUIBackObject);
@@ -821,10 +836,10 @@ Renderable *GraphicsManager::getGUIObjectAt(float x, float y) const {
 	Renderable *object = 0;
 
 	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
+	const QueueManager::Queue &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
 
 	// Go through the GUI elements, from nearest to furthest
-	for (std::list<Queueable *>::const_iterator g = gui.begin(); g != gui.end(); ++g) {
+	for (QueueManager::Queue::const_iterator g = gui.begin(); g != gui.end(); ++g) {
 		Renderable &r = static_cast<Renderable &>(**g);
 
 		if (!r.isClickable())
@@ -843,7 +858,9 @@ Renderable *GraphicsManager::getGUIObjectAt(float x, float y) const {
 }
 
 Renderable *GraphicsManager::getWorldObjectAt(float x, float y) const {
-	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject))
+	Common::StackLock lock(_pickMutex);
+
+	if (_pickTree.size() == 0)
 		return 0;
 
 		// Map the screen coordinates to OpenGL world screen coordinates
@@ -853,27 +870,42 @@ Renderable *GraphicsManager::getWorldObjectAt(float x, float y) const {
 	if (!unproject(x, y, x1, y1, z1, x2, y2, z2))
 		return 0;
 
-	Renderable *object = 0;
+	// Find all clickable objects along the line, sorted from nearest to furthest
+	std::vector<Common::AABBTree::Hit> hits;
+	_pickTree.findLine(glm::vec3(x1, y1, z1), glm::vec3(x2, y2, z2), hits);
 
-	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	for (std::vector<Common::AABBTree::Hit>::const_iterator h = hits.begin(); h != hits.end(); ++h) {
+		Renderable &r = *static_cast<Renderable *>(h->data);
 
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
-		Renderable &r = static_cast<Renderable &>(**o);
+		// If the line intersects with the object, return it
+		if (r.isIn(x1, y1, z1, x2, y2, z2))
+			return &r;
+	}
 
-		if (!r.isClickable())
-			// Object isn't clickable, don't check
-			continue;
+	return 0;
+}
 
-		// If the line intersects with the object, return it
-		if (r.isIn(x1, y1, z1, x2, y2, z2)) {
-			object = &r;
-			break;
-		}
+void GraphicsManager::updatePickable(Renderable &renderable) {
+	Common::StackLock lock(_pickMutex);
+
+	glm::vec3 min, max;
+
+	const bool pickable = (renderable._queueVisible == kQueueVisibleWorldObject) &&
+	                      renderable.isClickable() && renderable.isVisible() &&
+	                      renderable.getWorldBound(min, max);
+
+	if (!pickable) {
+		if (renderable._pickProxy != Common::AABBTree::kInvalidProxy)
+			_pickTree.remove(renderable._pickProxy);
+
+		renderable._pickProxy = Common::AABBTree::kInvalidProxy;
+		return;
 	}
 
-	QueueMan.unlockQueue(kQueueVisibleWorldObject);
-	return object;
+	if (renderable._pickProxy == Common::AABBTree::kInvalidProxy)
+		renderable._pickProxy = _pickTree.insert(min, max, &renderable);
+	else
+		_pickTree.update(renderable._pickProxy, min, max);
 }
 
 Renderable *GraphicsManager::getObjectAt(float x, float y) {
@@ -890,11 +922,11 @@ Renderable *GraphicsManager::getObjectAt(float x, float y) {
 
 void GraphicsManager::buildNewTextures() {
 	QueueMan.lockQueue(kQueueNewShader);
-	const std::list<Queueable *> &shadq = QueueMan.getQueue(kQueueNewShader);
+	const QueueManager::Queue &shadq = QueueMan.getQueue(kQueueNewShader);
 	if (shadq.empty()) {
 		QueueMan.unlockQueue(kQueueNewShader);
 	} else {
-		for (std::list<Queueable *>::const_iterator t = shadq.begin(); t != shadq.end(); ++t)
+		for (QueueManager::Queue::const_iterator t = shadq.begin(); t != shadq.end(); ++t)
 			static_cast<GLContainer *>(*t)->rebuild();
 
 		QueueMan.clearQueue(kQueueNewShader);
@@ -902,13 +934,13 @@ void GraphicsManager::buildNewTextures() {
 	}
 
 	QueueMan.lockQueue(kQueueNewTexture);
-	const std::list<Queueable *> &text = QueueMan.getQueue(kQueueNewTexture);
+	const QueueManager::Queue &text = QueueMan.getQueue(kQueueNewTexture);
 	if (text.empty()) {
 		QueueMan.unlockQueue(kQueueNewTexture);
 		return;
 	}
 
-	for (std::list<Queueable *>::const_iterator t = text.begin(); t != text.end(); ++t)
+	for (QueueManager::Queue::const_iterator t = text.begin(); t != text.end(); ++t)
 		static_cast<GLContainer *>(*t)->rebuild();
 
 	QueueMan.clearQueue(kQueueNewTexture);
@@ -939,9 +971,9 @@ bool GraphicsManager::playVideo() {
 	glLoadIdentity();
 
 	QueueMan.lockQueue(kQueueVisibleVideo);
-	const std::list<Queueable *> &videos = QueueMan.getQueue(kQueueVisibleVideo);
+	const QueueManager::Queue &videos = QueueMan.getQueue(kQueueVisibleVideo);
 
-	for (std::list<Queueable *>::const_iterator v = videos.begin(); v != videos.end(); ++v) {
+	for (QueueManager::Queue::const_iterator v = videos.begin(); v != videos.end(); ++v) {
 		glPushMatrix();
 		static_cast<Renderable *>(*v)->render(kRenderPassAll);
 		glPopMatrix();
@@ -984,34 +1016,71 @@ bool GraphicsManager::renderWorld() {
 	_modelview = glm::translate(_modelview, glm::vec3(-cPos[0], -cPos[1], -cPos[2]));
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	const QueueManager::Queue &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
 	_animationThread.flush();
 
+	/* Models put their nodes into the render queue instead of drawing them
+	 * directly. Everything else is still drawn while walking the objects. */
+	_nodeRenderQueue.begin(_modelview);
+
+	cullWorldObjects(objects);
+
 	// Draw opaque objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
+	for (QueueManager::Queue::const_reverse_iterator o = objects.rbegin();
 	     o != objects.rend(); ++o) {
 
+		Renderable &object = *static_cast<Renderable *>(*o);
+		if (object.isCulled())
+			continue;
+
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassOpaque);
+		object.render(kRenderPassOpaque);
 		glPopMatrix();
 	}
 
+	_nodeRenderQueue.render(kRenderPassOpaque);
+
 	// Draw transparent objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
+	for (QueueManager::Queue::const_reverse_iterator o = objects.rbegin();
 	     o != objects.rend(); ++o) {
 
+		Renderable &object = *static_cast<Renderable *>(*o);
+		if (object.isCulled())
+			continue;
+
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassTransparent);
+		object.render(kRenderPassTransparent);
 		glPopMatrix();
 	}
 
+	_nodeRenderQueue.render(kRenderPassTransparent);
+
+	_nodeRenderQueue.end();
+
 	QueueMan.unlockQueue(kQueueVisibleWorldObject);
 	return true;
 }
 
+void GraphicsManager::cullWorldObjects(const QueueManager::Queue &objects) {
+	/* The areas already hide whole rooms that can't be seen from the current
+	 * one. Of the rest, only draw what's actually in front of the camera. */
+
+	Common::Frustum frustum;
+	frustum.set(_projection * _modelview);
+
+	for (QueueManager::Queue::const_iterator o = objects.begin(); o != objects.end(); ++o) {
+		Renderable &object = *static_cast<Renderable *>(*o);
+
+		glm::vec3 min, max;
+		const bool culled = object.getWorldBound(min, max) && !frustum.isVisible(min, max);
+
+		object._culled.store(culled, boost::memory_order_relaxed);
+	}
+}
+
 bool GraphicsManager::renderGUIFront() {
 	return renderGUI(_scalingType, kQueueVisibleGUIFrontObject, false);
 }
@@ -1045,11 +1114,11 @@ bool GraphicsManager::renderGUI(ScalingType scalingType, QueueType guiQueue, boo
 	glLoadIdentity();
 
 	QueueMan.lockQueue(guiQueue);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(guiQueue);
+	const QueueManager::Queue &gui = QueueMan.getQueue(guiQueue);
 
 	buildNewTextures();
 
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
+	for (QueueManager::Queue::const_reverse_iterator g = gui.rbegin();
 	     g != gui.rend(); ++g) {
 
 		glPushMatrix();
@@ -1108,17 +1177,21 @@ bool GraphicsManager::renderWorldShader() {
 	_modelview = glm::translate(_modelview, glm::vec3(-cPos[0], -cPos[1], -cPos[2]));
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	const QueueManager::Queue &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
 	_animationThread.flush();
 
+	cullWorldObjects(objects);
+
 	glm::mat4 ident;
 	RenderMan.clear();
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
+	for (QueueManager::Queue::const_reverse_iterator o = objects.rbegin();
 	     o != objects.rend(); ++o) {
-		static_cast<Renderable *>(*o)->queueRender(ident);
+		Renderable &object = *static_cast<Renderable *>(*o);
+		if (!object.isCulled())
+			object.queueRender(ident);
 	}
 	RenderMan.sort();
 	RenderMan.render();
@@ -1154,13 +1227,13 @@ bool GraphicsManager::renderGUIShader(ScalingType scalingType, QueueType guiQueu
 	_projection = glm::scale(glm::mat4(), glm::vec3(2.0f / rasterWidth, 2.0f / rasterHeight, 0.0f));
 
 	QueueMan.lockQueue(guiQueue);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(guiQueue);
+	const QueueManager::Queue &gui = QueueMan.getQueue(guiQueue);
 	_modelview = glm::mat4();
 
 	buildNewTextures();
 
 	glm::mat4 ident;
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
+	for (QueueManager::Queue::const_reverse_iterator g = gui.rbegin();
 	     g != gui.rend(); ++g) {
 		static_cast<Renderable *>(*g)->renderImmediate(ident);
 	}
@@ -1221,6 +1294,8 @@ void GraphicsManager::renderScene() {
 		return;
 	}
 
+	TextureMan.swapLoadedTextures();
+
 	beginScene();
 
 	if (playVideo()) {
@@ -1287,6 +1362,10 @@ void GraphicsManager::unregisterAnimatedModel(Aurora::Model *model) {
 	_animationThread.unregisterModel(model);
 }
 
+Aurora::NodeRenderQueue *GraphicsManager::getNodeRenderQueue() {
+	return _nodeRenderQueue.isCollecting() ? &_nodeRenderQueue : 0;
+}
+
 bool GraphicsManager::isGL3() const {
 	return _renderType == WindowManager::kOpenGL32Compat;
 }
@@ -1294,8 +1373,8 @@ bool GraphicsManager::isGL3() const {
 void GraphicsManager::rebuildGLContainers() {
 	QueueMan.lockQueue(kQueueGLContainer);
 
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
+	const QueueManager::Queue &cont = QueueMan.getQueue(kQueueGLContainer);
+	for (QueueManager::Queue::const_iterator c = cont.begin(); c != cont.end(); ++c)
 		static_cast<GLContainer *>(*c)->rebuild();
 
 	QueueMan.unlockQueue(kQueueGLContainer);
@@ -1304,8 +1383,8 @@ void GraphicsManager::rebuildGLContainers() {
 void GraphicsManager::destroyGLContainers() {
 	QueueMan.lockQueue(kQueueGLContainer);
 
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
+	const QueueManager::Queue &cont = QueueMan.getQueue(kQueueGLContainer);
+	for (QueueManager::Queue::const_iterator c = cont.begin(); c != cont.end(); ++c)
 		static_cast<GLContainer *>(*c)->destroy();
 
 	QueueMan.unlockQueue(kQueueGLContainer);
@@ -36,12 +36,15 @@
 #include "src/common/scopedptr.h"
 #include "src/common/singleton.h"
 #include "src/common/mutex.h"
+#include "src/common/aabbtree.h"
 #include "src/common/ustring.h"
 
 #include "src/graphics/types.h"
 #include "src/graphics/windowman.h"
+#include "src/graphics/queueman.h"
 
 #include "src/graphics/aurora/animationthread.h"
+#include "src/graphics/aurora/noderenderqueue.h"
 
 #include "src/events/notifyable.h"
 
@@ -54,6 +57,7 @@ namespace Aurora {
 class FPSCounter;
 class Cursor;
 class Renderable;
+class Queueable;
 
 /** The graphics manager. */
 class GraphicsManager : public Common::Singleton<GraphicsManager>, public Events::Notifyable {
@@ -95,6 +99,9 @@ public:
 	/** How many frames per second to we render at the moments? */
 	uint32 getFPS() const;
 
+	/** Return how much world geometry was drawn in the last frame. */
+	Aurora::NodeRenderQueue::Statistics getRenderStatistics();
+
 	/** Enable/Disable face culling. */
 	void setCullFace(bool enabled, GLenum mode = GL_BACK);
 
@@ -128,6 +135,13 @@ public:
 	/** Recalculate all object distances to the camera and resort the objects. */
 	void recalculateObjectDistances();
 
+	/** Add, move or remove a renderable in the world picking tree, according to its current state.
+	 *
+	 *  Visible, clickable world objects with a bounding box are kept in
+	 *  the tree, all others are removed from it.
+	 */
+	void updatePickable(Renderable &renderable);
+
 	/** Increase the frame lock counter, disabling all frame rendering.
 	 *
 	 *  Frame locking is useful for updating several things in one batch,
@@ -183,6 +197,9 @@ public:
 	/** Unregister a model from the animation thread. */
 	void unregisterAnimatedModel(Aurora::Model *model);
 
+	/** Return the queue collecting the world's model geometry, or 0 if it's not being collected right now. */
+	Aurora::NodeRenderQueue *getNodeRenderQueue();
+
 private:
 	enum ProjectType {
 		kProjectTypePerspective,
@@ -247,8 +264,13 @@ private:
 
 	Common::Mutex _abandonMutex; ///< A mutex protecting abandoned structures.
 
+	Common::AABBTree      _pickTree;  ///< The visible, clickable world objects, for picking.
+	mutable Common::Mutex _pickMutex; ///< A mutex protecting the picking tree.
+
 	Aurora::AnimationThread _animationThread;
 
+	Aurora::NodeRenderQueue _nodeRenderQueue; ///< Batching the model geometry drawn in the world.
+
 	void setupScene();
 
 	bool setupSDLGL();
@@ -272,6 +294,9 @@ private:
 
 	void buildNewTextures();
 
+	/** Mark the world objects outside of the camera's view as culled. */
+	void cullWorldObjects(const QueueManager::Queue &objects);
+
 	void beginScene();
 	bool playVideo();
 	bool renderWorld();
@@ -22,11 +22,19 @@
  *  Manual S3TC DXTn decompression methods.
  */
 
+#include <cstring>
+
 #include "src/common/util.h"
+#include "src/common/error.h"
 #include "src/common/readstream.h"
 
 #include "src/graphics/images/s3tc.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define S3TC_HAVE_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 namespace Graphics {
 
 static inline uint32 convert565To8888(uint16 color) {
@@ -216,4 +224,305 @@ void decompressDXT5(byte *dest, Common::SeekableReadStream &src, uint32 width, u
 	}
 }
 
+// .--- Memory-based decompression
+
+/* Unlike the stream-based decoders above, these read the blocks directly
+ * from memory and only use integer arithmetic. They are carefully written
+ * to produce the exact same output, including the quirks of the originals:
+ *
+ * - The RGB565 colours are not bit-replicated when expanded to 8 bits.
+ * - The colour blends truncate a floating point blend with the weights
+ *   0.333333f and 0.666666f. These are a tiny bit below 1/3 and 2/3, so
+ *   when a blend lands exactly on an integer while moving upwards from
+ *   color_0 to color_1, it is truncated down by one.
+ * - The rows of the DXT3 alpha block are vertically flipped.
+ * - Images smaller than a block in either dimension consume the colour
+ *   indices in a packed, row-by-row order.
+ */
+
+enum DXTFormat {
+	kDXTFormat1,
+	kDXTFormat3,
+	kDXTFormat5
+};
+
+/** A completely decoded DXTn block. */
+struct DXTBlock {
+	uint32 colors[4];  ///< The four block colours, as RGBA8 pixels in memory order.
+	byte alpha[16];    ///< The alpha value of each pixel, if not DXT1.
+	const byte *index; ///< The four colour index bytes.
+};
+
+static inline size_t getDXTBlockSize(DXTFormat format) {
+	return (format == kDXTFormat1) ? 8 : 16;
+}
+
+static inline void unpackRGB565(uint16 color, byte *rgba) {
+	rgba[0] = (color & 0xF800) >> 8;
+	rgba[1] = (color & 0x07E0) >> 3;
+	rgba[2] = (color & 0x001F) << 3;
+}
+
+static void getDXTColors(const byte *src, bool dxt1, uint32 *colors) {
+	const uint16 color0 = READ_LE_UINT16(src + 0);
+	const uint16 color1 = READ_LE_UINT16(src + 2);
+
+	byte c[4][4];
+
+	unpackRGB565(color0, c[0]);
+	unpackRGB565(color1, c[1]);
+
+	c[0][3] = c[1][3] = dxt1 ? 0xFF : 0x00;
+
+	if (!dxt1 || (color0 > color1)) {
+		for (size_t i = 0; i < 4; i++) {
+			const int a = c[0][i];
+			const int b = c[1][i];
+
+			const int bias = (b > a) ? 1 : 0;
+
+			c[2][i] = (2 * a + b - bias) / 3;
+			c[3][i] = (a + 2 * b - bias) / 3;
+		}
+
+	} else {
+		for (size_t i = 0; i < 4; i++)
+			c[2][i] = (c[0][i] + c[1][i]) / 2;
+
+		std::memset(c[3], 0, 4);
+	}
+
+	std::memcpy(colors, c, sizeof(c));
+}
+
+static void getDXT5Alphas(const byte *src, byte *alphas) {
+	const int a = alphas[0] = src[0];
+	const int b = alphas[1] = src[1];
+
+	if (a > b) {
+		for (int i = 1; i < 7; i++)
+			alphas[i + 1] = ((7 - i) * a + i * b + 3) / 7;
+	} else {
+		for (int i = 1; i < 5; i++)
+			alphas[i + 1] = ((5 - i) * a + i * b + 2) / 5;
+
+		alphas[6] = 0;
+		alphas[7] = 255;
+	}
+}
+
+static inline uint64 getDXT5AlphaIndices(const byte *src) {
+	return ((uint64) READ_LE_UINT32(src + 2)) | (((uint64) READ_LE_UINT16(src + 6)) << 32);
+}
+
+/** Decode a block, with its alpha values in the order of the output rows. */
+static void decodeDXTBlock(const byte *src, DXTFormat format, DXTBlock &block) {
+	if (format == kDXTFormat3) {
+		for (size_t y = 0; y < 4; y++) {
+			const uint16 alpha = READ_LE_UINT16(src + 2 * (3 - y));
+
+			for (size_t x = 0; x < 4; x++)
+				block.alpha[y * 4 + x] = ((alpha >> (x * 4)) & 0xF) << 4;
+		}
+
+	} else if (format == kDXTFormat5) {
+		byte alphas[8];
+		getDXT5Alphas(src, alphas);
+
+		const uint64 indices = getDXT5AlphaIndices(src);
+		for (size_t i = 0; i < 16; i++)
+			block.alpha[i] = alphas[(indices >> (3 * i)) & 7];
+	}
+
+	if (format != kDXTFormat1)
+		src += 8;
+
+	getDXTColors(src, format == kDXTFormat1, block.colors);
+
+	block.index = src + 4;
+}
+
+static void writeDXTBlockScalar(byte *dest, uint32 pitch, const DXTBlock &block, bool alpha) {
+	for (size_t y = 0; y < 4; y++, dest += pitch) {
+		const byte index = block.index[y];
+
+		for (size_t x = 0; x < 4; x++) {
+			std::memcpy(dest + x * 4, &block.colors[(index >> (x * 2)) & 3], 4);
+
+			if (alpha)
+				dest[x * 4 + 3] = block.alpha[y * 4 + x];
+		}
+	}
+}
+
+#ifdef S3TC_HAVE_SSE2
+static void writeDXTBlockSSE2(byte *dest, uint32 pitch, const DXTBlock &block, bool alpha) {
+	/* Instead of looking up each pixel's colour, we compare the 2-bit index
+	 * of all four pixels of a row against each possible index at once, and
+	 * then combine the colours with the resulting masks. */
+
+	const __m128i zero  = _mm_setzero_si128();
+	const __m128i mask  = _mm_setr_epi32(0x03, 0x0C, 0x30, 0xC0);
+	const __m128i index1 = _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+	const __m128i index2 = _mm_setr_epi32(0x02, 0x08, 0x20, 0x80);
+
+	const __m128i color0 = _mm_set1_epi32((int) block.colors[0]);
+	const __m128i color1 = _mm_set1_epi32((int) block.colors[1]);
+	const __m128i color2 = _mm_set1_epi32((int) block.colors[2]);
+	const __m128i color3 = _mm_set1_epi32((int) block.colors[3]);
+
+	for (size_t y = 0; y < 4; y++, dest += pitch) {
+		const __m128i index = _mm_and_si128(_mm_set1_epi32(block.index[y]), mask);
+
+		__m128i row = _mm_or_si128(
+			_mm_or_si128(_mm_and_si128(_mm_cmpeq_epi32(index, zero  ), color0),
+			             _mm_and_si128(_mm_cmpeq_epi32(index, index1), color1)),
+			_mm_or_si128(_mm_and_si128(_mm_cmpeq_epi32(index, index2), color2),
+			             _mm_and_si128(_mm_cmpeq_epi32(index, mask  ), color3)));
+
+		if (alpha) {
+			int32 alphas;
+			std::memcpy(&alphas, block.alpha + y * 4, 4);
+
+			__m128i a = _mm_cvtsi32_si128(alphas);
+
+			a = _mm_unpacklo_epi8(a, zero);
+			a = _mm_unpacklo_epi16(a, zero);
+
+			row = _mm_or_si128(row, _mm_slli_epi32(a, 24));
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest), row);
+	}
+}
+#endif
+
+typedef void (*WriteDXTBlockFunc)(byte *dest, uint32 pitch, const DXTBlock &block, bool alpha);
+
+static WriteDXTBlockFunc getWriteDXTBlockFunc(bool simd) {
+#ifdef S3TC_HAVE_SSE2
+	if (simd)
+		return &writeDXTBlockSSE2;
+#else
+	UNUSED(simd);
+#endif
+
+	return &writeDXTBlockScalar;
+}
+
+/** Decompress an image that is at least one block wide and high. */
+static void decompressDXTBlocks(byte *dest, const byte *src, uint32 width, uint32 height,
+                                uint32 pitch, DXTFormat format, bool simd) {
+
+	const WriteDXTBlockFunc writeBlock = getWriteDXTBlockFunc(simd);
+
+	const size_t blockSize = getDXTBlockSize(format);
+	const bool   alpha     = format != kDXTFormat1;
+
+	DXTBlock block;
+	byte clipped[4 * 4 * 4];
+
+	for (uint32 by = 0; by < height; by += 4, dest += 4 * pitch) {
+		const uint32 rows = MIN<uint32>(height - by, 4);
+
+		for (uint32 bx = 0; bx < width; bx += 4, src += blockSize) {
+			const uint32 columns = MIN<uint32>(width - bx, 4);
+
+			decodeDXTBlock(src, format, block);
+
+			if ((rows == 4) && (columns == 4)) {
+				writeBlock(dest + bx * 4, pitch, block, alpha);
+				continue;
+			}
+
+			// Block at the right or bottom border, only partially within the image
+			writeBlock(clipped, 4 * 4, block, alpha);
+
+			for (uint32 y = 0; y < rows; y++)
+				std::memcpy(dest + y * pitch + bx * 4, clipped + y * 4 * 4, columns * 4);
+		}
+	}
+}
+
+/** Decompress an image that is smaller than one block in at least one dimension. */
+static void decompressDXTSmall(byte *dest, const byte *src, uint32 width, uint32 height,
+                               uint32 pitch, DXTFormat format) {
+
+	const size_t blockSize = getDXTBlockSize(format);
+
+	const uint32 blockWidth  = MIN<uint32>(width , 4);
+	const uint32 blockHeight = MIN<uint32>(height, 4);
+
+	for (int32 ty = height; ty > 0; ty -= 4) {
+		for (uint32 tx = 0; tx < width; tx += 4, src += blockSize) {
+			const byte *colorSrc = (format == kDXTFormat1) ? src : (src + 8);
+
+			uint32 colors[4];
+			getDXTColors(colorSrc, format == kDXTFormat1, colors);
+
+			byte alphas[8];
+			if (format == kDXTFormat5)
+				getDXT5Alphas(src, alphas);
+
+			const uint64 alphaIndices = (format == kDXTFormat5) ? getDXT5AlphaIndices(src) : 0;
+
+			uint32 cpx = READ_BE_UINT32(colorSrc + 4);
+
+			for (uint32 y = 0; y < blockHeight; ++y) {
+				for (uint32 x = 0; x < blockWidth; ++x, cpx >>= 2) {
+					const uint32 destX = tx + x;
+					const uint32 destY = height - 1 - (ty - blockHeight + y);
+
+					if ((destX >= width) || (destY >= height))
+						continue;
+
+					byte *pixel = dest + destY * pitch + destX * 4;
+
+					std::memcpy(pixel, &colors[cpx & 3], 4);
+
+					if      (format == kDXTFormat3)
+						pixel[3] = ((READ_LE_UINT16(src + 2 * y) >> (x * 4)) & 0xF) << 4;
+					else if (format == kDXTFormat5)
+						pixel[3] = alphas[(alphaIndices >> (3 * (4 * (3 - y) + x))) & 7];
+				}
+			}
+		}
+	}
+}
+
+static void decompressDXT(byte *dest, const byte *src, size_t size, uint32 width, uint32 height,
+                          uint32 pitch, DXTFormat format, bool simd) {
+
+	const size_t blockCount = (size_t) ((width + 3) / 4) * ((height + 3) / 4);
+	if (size < (blockCount * getDXTBlockSize(format)))
+		throw Common::Exception("Not enough DXT data for %ux%u pixels (%u bytes)", width, height, (uint) size);
+
+	if ((width >= 4) && (height >= 4))
+		decompressDXTBlocks(dest, src, width, height, pitch, format, simd);
+	else
+		decompressDXTSmall(dest, src, width, height, pitch, format);
+}
+
+void decompressDXT1(byte *dest, const byte *src, size_t size, uint32 width, uint32 height, uint32 pitch, bool simd) {
+	decompressDXT(dest, src, size, width, height, pitch, kDXTFormat1, simd);
+}
+
+void decompressDXT3(byte *dest, const byte *src, size_t size, uint32 width, uint32 height, uint32 pitch, bool simd) {
+	decompressDXT(dest, src, size, width, height, pitch, kDXTFormat3, simd);
+}
+
+void decompressDXT5(byte *dest, const byte *src, size_t size, uint32 width, uint32 height, uint32 pitch, bool simd) {
+	decompressDXT(dest, src, size, width, height, pitch, kDXTFormat5, simd);
+}
+
+bool hasSIMDDXTDecompression() {
+#ifdef S3TC_HAVE_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+// '---
+
 } // End of namespace Graphics
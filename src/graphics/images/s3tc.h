@@ -25,6 +25,8 @@
 #ifndef GRAPHICS_IMAGES_S3TC_H
 #define GRAPHICS_IMAGES_S3TC_H
 
+#include <cstddef>
+
 #include "src/common/types.h"
 
 namespace Common {
@@ -37,6 +39,28 @@ void decompressDXT1(byte *dest, Common::SeekableReadStream &src, uint32 width, u
 void decompressDXT3(byte *dest, Common::SeekableReadStream &src, uint32 width, uint32 height, uint32 pitch);
 void decompressDXT5(byte *dest, Common::SeekableReadStream &src, uint32 width, uint32 height, uint32 pitch);
 
+/** Decompress DXTn data directly from memory.
+ *
+ *  These produce the exact same output as the stream-based variants
+ *  above, but decode whole rows of blocks at once and use integer
+ *  arithmetic throughout. Where available (SSE2), the pixels of a block
+ *  are expanded with SIMD instructions.
+ *
+ *  @param dest   The RGBA8 output image.
+ *  @param src    The compressed DXTn data.
+ *  @param size   The size of the compressed data in bytes.
+ *  @param width  The width of the image in pixels.
+ *  @param height The height of the image in pixels.
+ *  @param pitch  The size of one row of the output image in bytes.
+ *  @param simd   Use the SIMD kernels, if available. If false, always use the scalar code.
+ */
+void decompressDXT1(byte *dest, const byte *src, size_t size, uint32 width, uint32 height, uint32 pitch, bool simd = true);
+void decompressDXT3(byte *dest, const byte *src, size_t size, uint32 width, uint32 height, uint32 pitch, bool simd = true);
+void decompressDXT5(byte *dest, const byte *src, size_t size, uint32 width, uint32 height, uint32 pitch, bool simd = true);
+
+/** Are the SIMD kernels of the memory-based DXTn decompressors available? */
+bool hasSIMDDXTDecompression();
+
 } // End of namespace Graphics
 
 #endif // GRAPHICS_IMAGES_S3TC_H
@@ -40,6 +40,9 @@ static const byte kEncodingSwizzledBGRA = 0x0C;
 
 namespace Graphics {
 
+TPC::TPC() {
+}
+
 TPC::TPC(Common::SeekableReadStream &tpc) {
 	load(tpc);
 }
@@ -64,6 +67,36 @@ void TPC::load(Common::SeekableReadStream &tpc) {
 	}
 }
 
+bool TPC::readEmbeddedTXI(Common::SeekableReadStream &tpc, TXI &txi) {
+	try {
+		// Parse the header to find the size of the image data, and skip over it
+
+		TPC image;
+
+		byte encoding;
+		image.readHeader(tpc, encoding);
+
+		size_t dataSize = 0;
+		for (MipMaps::const_iterator mipMap = image._mipMaps.begin(); mipMap != image._mipMaps.end(); ++mipMap)
+			dataSize += (*mipMap)->size;
+
+		tpc.seek(128 + dataSize);
+
+		image.readTXI(tpc);
+
+		if (image._txi.empty())
+			return false;
+
+		txi = image._txi;
+
+	} catch (Common::Exception &e) {
+		e.add("Failed reading TPC file");
+		throw;
+	}
+
+	return true;
+}
+
 void TPC::readHeader(Common::SeekableReadStream &tpc, byte &encoding) {
 	// Number of bytes for the pixel data in one full image
 	uint32 dataSize = tpc.readUint32LE();
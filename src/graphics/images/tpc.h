@@ -44,7 +44,17 @@ public:
 	TPC(Common::SeekableReadStream &tpc);
 	~TPC();
 
+	/** Read only the TXI embedded into a TPC, without decoding the image data.
+	 *
+	 *  @param  tpc The TPC to read.
+	 *  @param  txi The TXI will be loaded into this.
+	 *  @return true if the TPC has an embedded TXI.
+	 */
+	static bool readEmbeddedTXI(Common::SeekableReadStream &tpc, TXI &txi);
+
 private:
+	TPC();
+
 	// Loading helpers
 	void load(Common::SeekableReadStream &tpc);
 	void readHeader(Common::SeekableReadStream &tpc, byte &encoding);
@@ -37,6 +37,9 @@ static const byte kEncodingDXT5 = 0x0C;
 
 namespace Graphics {
 
+TXB::TXB() {
+}
+
 TXB::TXB(Common::SeekableReadStream &txb) {
 	load(txb);
 }
@@ -63,6 +66,33 @@ void TXB::load(Common::SeekableReadStream &txb) {
 	}
 }
 
+bool TXB::readEmbeddedTXI(Common::SeekableReadStream &txb, TXI &txi) {
+	try {
+
+		TXB image;
+
+		uint32 dataSize;
+		byte encoding;
+
+		image.readHeader(txb, encoding, dataSize);
+
+		txb.seek(dataSize + 128);
+
+		image.readTXI(txb);
+
+		if (image._txi.empty())
+			return false;
+
+		txi = image._txi;
+
+	} catch (Common::Exception &e) {
+		e.add("Failed reading TXB file");
+		throw;
+	}
+
+	return true;
+}
+
 static uint32 getTXBDataSize(byte encoding, PixelFormatRaw format, int32 width, int32 height) {
 	switch (encoding) {
 		case kEncodingBGRA:
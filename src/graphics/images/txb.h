@@ -46,7 +46,17 @@ public:
 	TXB(Common::SeekableReadStream &txb);
 	~TXB();
 
+	/** Read only the TXI embedded into a TXB, without decoding the image data.
+	 *
+	 *  @param  txb The TXB to read.
+	 *  @param  txi The TXI will be loaded into this.
+	 *  @return true if the TXB has an embedded TXI.
+	 */
+	static bool readEmbeddedTXI(Common::SeekableReadStream &txb, TXI &txi);
+
 private:
+	TXB();
+
 	// Loading helpers
 	void load(Common::SeekableReadStream &txb);
 	void readHeader(Common::SeekableReadStream &txb, byte &encoding, uint32 &dataSize);
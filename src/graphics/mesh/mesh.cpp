@@ -256,9 +256,10 @@ void Mesh::useIncrement() {
 }
 
 void Mesh::useDecrement() {
-	if (_usageCount) {
-		--_usageCount;
-	}
+	// Models might be built on several threads at once
+	uint32 count = _usageCount.load();
+	while ((count > 0) && !_usageCount.compare_exchange_weak(count, count - 1))
+		;
 }
 
 uint32 Mesh::useCount() const {
@@ -25,6 +25,8 @@
 #ifndef GRAPHICS_MESH_MESH_H
 #define GRAPHICS_MESH_MESH_H
 
+#include "src/common/atomic.h"
+
 #include "src/common/ustring.h"
 #include "src/common/mutex.h"
 
@@ -92,7 +94,7 @@ protected:
 
 private:
 	Common::UString _name;
-	uint32 _usageCount;
+	boost::atomic<uint32> _usageCount;
 
 	GLuint _vao;  ///< Vertex Array Object handle. GL3.x only.
 
@@ -63,6 +63,8 @@ void MeshManager::init() {
 }
 
 void MeshManager::deinit() {
+	Common::StackLock lock(_mutex);
+
 	for (std::map<Common::UString, Mesh *>::iterator iter = _resourceMap.begin(); iter != _resourceMap.end(); ++iter) {
 		delete iter->second;
 	}
@@ -70,6 +72,8 @@ void MeshManager::deinit() {
 }
 
 void MeshManager::cleanup() {
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, Mesh *>::iterator iter = _resourceMap.begin();
 	while (iter != _resourceMap.end()) {
 		Mesh *mesh = iter->second;
@@ -86,6 +90,8 @@ void MeshManager::addMesh(Mesh *mesh) {
 		return;
 	}
 
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, Mesh *>::iterator iter = _resourceMap.find(mesh->getName());
 	if (iter == _resourceMap.end()) {
 		_resourceMap[mesh->getName()] = mesh;
@@ -97,6 +103,8 @@ void MeshManager::delMesh(Mesh *mesh) {
 		return;
 	}
 
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, Mesh *>::iterator iter = _resourceMap.find(mesh->getName());
 	if (iter != _resourceMap.end()) {
 		delResource(iter);
@@ -104,6 +112,8 @@ void MeshManager::delMesh(Mesh *mesh) {
 }
 
 Mesh *MeshManager::getMesh(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, Mesh *>::iterator iter = _resourceMap.find(name);
 	if (iter != _resourceMap.end()) {
 		return iter->second;
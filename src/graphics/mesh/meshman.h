@@ -63,6 +63,9 @@ public:
 private:
 	std::map<Common::UString, Mesh *> _resourceMap;
 
+	/** Protects the resource map, for models loaded on several threads. */
+	Common::Mutex _mutex;
+
 	std::map<Common::UString, Mesh *>::iterator delResource(std::map<Common::UString, Mesh *>::iterator iter);
 };
 
@@ -22,6 +22,9 @@
  *  The graphics queue manager.
  */
 
+#include <cassert>
+#include <algorithm>
+
 #include "src/graphics/queueman.h"
 #include "src/graphics/queueable.h"
 
@@ -33,6 +36,27 @@ static bool queueComp(Queueable *a, Queueable *b) {
 	return *a < *b;
 }
 
+/** Does the order of the objects within this queue matter?
+ *
+ *  The queues of visible objects are sorted and then drawn front to back.
+ *  The other queues are merely collections of objects to process, whose
+ *  order is never relied upon.
+ */
+static bool isQueueOrdered(QueueType queue) {
+	switch (queue) {
+		case kQueueTexture:
+		case kQueueNewTexture:
+		case kQueueWorldObject:
+		case kQueueGLContainer:
+			return false;
+
+		default:
+			break;
+	}
+
+	return true;
+}
+
 
 QueueManager::QueueManager() {
 }
@@ -55,44 +79,84 @@ bool QueueManager::isQueueEmpty(QueueType queue) {
 	return _queue[queue].empty();
 }
 
-const std::list<Queueable *> &QueueManager::getQueue(QueueType queue) const {
+const QueueManager::Queue &QueueManager::getQueue(QueueType queue) const {
 	return _queue[queue];
 }
 
 void QueueManager::sortQueue(QueueType queue) {
 	lockQueue(queue);
 
-	_queue[queue].sort(queueComp);
+	Queue &q = _queue[queue];
+
+	/* Insertion sort, which is linear for an already sorted queue. If the
+	 * queue turns out to be far from sorted, for example after the camera
+	 * jumped, give up and sort the rest properly. Both sorts are stable. */
+
+	const size_t maxMoves = 8 * q.size();
+	size_t moves = 0;
+
+	for (size_t i = 1; i < q.size(); i++) {
+		Queueable *object = q[i];
+
+		size_t j = i;
+		for (; (j > 0) && queueComp(object, q[j - 1]); j--) {
+			q[j] = q[j - 1];
+			q[j]->_queueIndex[queue] = j;
+		}
+
+		q[j] = object;
+		object->_queueIndex[queue] = j;
+
+		moves += i - j;
+		if (moves > maxMoves) {
+			std::stable_sort(q.begin(), q.end(), queueComp);
+			reindexQueue(queue);
+			break;
+		}
+	}
 
 	unlockQueue(queue);
 }
 
-std::list<Queueable *>::iterator QueueManager::addToQueue(QueueType queue, Queueable &q) {
+void QueueManager::addToQueue(QueueType queue, Queueable &q) {
 	lockQueue(queue);
 
+	q._queueIndex[queue] = _queue[queue].size();
 	_queue[queue].push_back(&q);
-	std::list<Queueable *>::iterator ref = --_queue[queue].end();
 
 	unlockQueue(queue);
-
-	return ref;
 }
 
-void QueueManager::removeFromQueue(QueueType queue,
-		const std::list<Queueable *>::iterator &ref) {
-
+void QueueManager::removeFromQueue(QueueType queue, Queueable &q) {
 	lockQueue(queue);
 
-	_queue[queue].erase(ref);
+	const size_t index = q._queueIndex[queue];
+	assert((index < _queue[queue].size()) && (_queue[queue][index] == &q));
+
+	if (isQueueOrdered(queue)) {
+		// Keep the order of the queue intact, it might be sorted
+		_queue[queue].erase(_queue[queue].begin() + index);
+		reindexQueue(queue, index);
+	} else {
+		// Fill the hole with the last object in the queue
+		_queue[queue][index] = _queue[queue].back();
+		_queue[queue][index]->_queueIndex[queue] = index;
+
+		_queue[queue].pop_back();
+	}
 
 	unlockQueue(queue);
 }
 
+void QueueManager::reindexQueue(QueueType queue, size_t start) {
+	for (size_t i = start; i < _queue[queue].size(); i++)
+		_queue[queue][i]->_queueIndex[queue] = i;
+}
+
 void QueueManager::clearQueue(QueueType queue) {
 	lockQueue(queue);
 
-	for (std::list<Queueable *>::iterator q = _queue[queue].begin();
-	     q != _queue[queue].end(); ++q)
+	for (Queue::iterator q = _queue[queue].begin(); q != _queue[queue].end(); ++q)
 		(*q)->kickedOut(queue);
 
 	_queue[queue].clear();
@@ -25,7 +25,7 @@
 #ifndef GRAPHICS_QUEUEMAN_H
 #define GRAPHICS_QUEUEMAN_H
 
-#include <list>
+#include <vector>
 
 #include "src/common/types.h"
 #include "src/common/singleton.h"
@@ -40,6 +40,8 @@ class Queueable;
 /** The graphics queue manager. */
 class QueueManager : public Common::Singleton<QueueManager> {
 public:
+	typedef std::vector<Queueable *> Queue;
+
 	QueueManager();
 	~QueueManager();
 
@@ -48,8 +50,15 @@ public:
 	void lockQueue(QueueType queue);
 	void unlockQueue(QueueType queue);
 
-	const std::list<Queueable *> &getQueue(QueueType queue) const;
+	const Queue &getQueue(QueueType queue) const;
 
+	/** Sort the queue.
+	 *
+	 *  The queues are expected to be nearly sorted already, with only a few
+	 *  objects out of place after one moved or the camera moved a bit. So
+	 *  an insertion sort is used, which only falls back to a full sort when
+	 *  too many objects need to be moved.
+	 */
 	void sortQueue(QueueType queue);
 	void clearQueue(QueueType queue);
 
@@ -57,10 +66,12 @@ public:
 
 private:
 	Common::Mutex _queueMutex[kQueueMAX];
-	std::list<Queueable *> _queue[kQueueMAX];
+	Queue _queue[kQueueMAX];
+
+	void addToQueue(QueueType queue, Queueable &q);
+	void removeFromQueue(QueueType queue, Queueable &q);
 
-	std::list<Queueable *>::iterator addToQueue(QueueType queue, Queueable &q);
-	void removeFromQueue(QueueType queue, const std::list<Queueable *>::iterator &ref);
+	void reindexQueue(QueueType queue, size_t start = 0);
 
 	friend class Queueable;
 };
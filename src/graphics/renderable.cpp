@@ -24,13 +24,16 @@
 
 #include "src/common/system.h"
 #include "src/common/error.h"
+#include "src/common/aabbtree.h"
 
 #include "src/graphics/renderable.h"
 #include "src/graphics/graphics.h"
 
 namespace Graphics {
 
-Renderable::Renderable(RenderableType type) : _clickable(false), _distance(0.0f) {
+Renderable::Renderable(RenderableType type) : _clickable(false), _distance(0.0f),
+		_pickProxy(Common::AABBTree::kInvalidProxy), _culled(false) {
+
 	switch (type) {
 		case kRenderableTypeVideo:
 			_queueExists  = kQueueVideo;
@@ -93,6 +96,8 @@ bool Renderable::isClickable() const {
 
 void Renderable::setClickable(bool clickable) {
 	_clickable = clickable;
+
+	updatePickable();
 }
 
 const Common::UString &Renderable::getTag() const {
@@ -118,10 +123,14 @@ void Renderable::show() {
 	sortQueue(_queueVisible);
 
 	unlockQueue(_queueVisible);
+
+	updatePickable();
 }
 
 void Renderable::hide() {
 	removeFromQueue(_queueVisible);
+
+	updatePickable();
 }
 
 bool Renderable::isIn(float UNUSED(x), float UNUSED(y)) const {
@@ -138,6 +147,20 @@ bool Renderable::isIn(float UNUSED(x1), float UNUSED(y1), float UNUSED(z1),
 	return false;
 }
 
+bool Renderable::getWorldBound(glm::vec3 &UNUSED(min), glm::vec3 &UNUSED(max)) const {
+	return false;
+}
+
+bool Renderable::isCulled() const {
+	return _culled.load(boost::memory_order_relaxed);
+}
+
+void Renderable::updatePickable() {
+	// Only world objects can be picked
+	if (_queueVisible == kQueueVisibleWorldObject)
+		GfxMan.updatePickable(*this);
+}
+
 void Renderable::lockFrame() {
 	GfxMan.lockFrame();
 }
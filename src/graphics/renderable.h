@@ -25,8 +25,11 @@
 #ifndef GRAPHICS_RENDERABLE_H
 #define GRAPHICS_RENDERABLE_H
 
+#include "src/common/atomic.h"
+
 #include <boost/noncopyable.hpp>
 
+#include "glm/vec3.hpp"
 #include "glm/mat4x4.hpp"
 
 #include "src/common/ustring.h"
@@ -89,6 +92,12 @@ public:
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with the object? */
 	virtual bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Get the object's bounding box in world space. Returns false if it has none. */
+	virtual bool getWorldBound(glm::vec3 &min, glm::vec3 &max) const;
+
+	/** Was the object outside of the camera's view when the last frame was drawn? */
+	bool isCulled() const;
+
 protected:
 	QueueType _queueExists;
 	QueueType _queueVisible;
@@ -107,6 +116,17 @@ protected:
 
 	void lockFrameIfVisible();
 	void unlockFrameIfVisible();
+
+	/** Update the object in the graphics manager's world picking tree,
+	 *  after its visibility, clickability or world bounding box changed. */
+	void updatePickable();
+
+private:
+	uint32 _pickProxy; ///< The object's entry in the world picking tree.
+
+	boost::atomic<bool> _culled; ///< Was the object outside of the view in the last frame?
+
+	friend class GraphicsManager;
 };
 
 } // End of namespace Graphics
@@ -64,6 +64,8 @@ void MaterialManager::init() {
 }
 
 void MaterialManager::deinit() {
+	Common::StackLock lock(_mutex);
+
 	for (std::map<Common::UString, ShaderMaterial *>::iterator iter = _resourceMap.begin(); iter != _resourceMap.end(); ++iter) {
 		delete iter->second;
 	}
@@ -71,6 +73,8 @@ void MaterialManager::deinit() {
 }
 
 void MaterialManager::cleanup() {
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, ShaderMaterial *>::iterator iter = _resourceMap.begin();
 	while (iter != _resourceMap.end()) {
 		ShaderMaterial *material = iter->second;
@@ -82,15 +86,22 @@ void MaterialManager::cleanup() {
 	}
 }
 
-void MaterialManager::addMaterial(ShaderMaterial *material) {
+ShaderMaterial *MaterialManager::addMaterial(ShaderMaterial *material) {
 	if (!material) {
-		return;
+		return 0;
 	}
 
-	std::map<Common::UString, ShaderMaterial *>::iterator iter = _resourceMap.find(material->getName());
-	if (iter == _resourceMap.end()) {
-		_resourceMap[material->getName()] = material;
+	Common::StackLock lock(_mutex);
+
+	std::pair<std::map<Common::UString, ShaderMaterial *>::iterator, bool> result =
+		_resourceMap.insert(std::make_pair(material->getName(), material));
+
+	if (!result.second && (result.first->second != material)) {
+		// Another model built the same material in the meantime
+		delete material;
 	}
+
+	return result.first->second;
 }
 
 void MaterialManager::delMaterial(ShaderMaterial *material) {
@@ -98,6 +109,8 @@ void MaterialManager::delMaterial(ShaderMaterial *material) {
 		return;
 	}
 
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, ShaderMaterial *>::iterator iter = _resourceMap.find(material->getName());
 	if (iter != _resourceMap.end()) {
 		delResource(iter);
@@ -105,6 +118,8 @@ void MaterialManager::delMaterial(ShaderMaterial *material) {
 }
 
 ShaderMaterial *MaterialManager::getMaterial(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, ShaderMaterial *>::iterator iter = _resourceMap.find(name);
 	if (iter != _resourceMap.end()) {
 		return iter->second;
@@ -51,8 +51,12 @@ public:
 	/** Remove any resource that has a usage count of zero. */
 	void cleanup();
 
-	/** Adds a material to be managed. Cleanup will delete the material if usage count is zero. */
-	void addMaterial(ShaderMaterial *material);
+	/** Adds a material to be managed. Cleanup will delete the material if usage count is zero.
+	 *
+	 *  If a material of the same name is already managed, the given material is deleted
+	 *  and the existing one returned instead. Otherwise, the given material is returned.
+	 */
+	ShaderMaterial *addMaterial(ShaderMaterial *material);
 
 	/** Forcibly remove the material from the map. Consider using cleanup instead. */
 	void delMaterial(ShaderMaterial *material);
@@ -63,6 +67,9 @@ public:
 private:
 	std::map<Common::UString, ShaderMaterial *> _resourceMap;
 
+	/** Protects the resource map, for models loaded on several threads. */
+	Common::Mutex _mutex;
+
 	std::map<Common::UString, ShaderMaterial *>::iterator delResource(std::map<Common::UString, ShaderMaterial *>::iterator iter);
 };
 
@@ -186,6 +186,8 @@ ShaderObject *ShaderManager::getShaderObject(const Common::UString &name, Shader
 	Common::UString shaderString;
 	//ShaderObject *shaderObject = 0;
 	//ShaderObject *shaderObject = (ShaderObject *)(_shaderObjectMap[filename.c_str()]);
+	Common::StackLock lock(_shaderMutex);
+
 	std::map<Common::UString, Shader::ShaderObject *>::iterator it = _shaderObjectMap.find(name);
 	if (it != _shaderObjectMap.end()) {
 		return it->second;
@@ -195,12 +197,14 @@ ShaderObject *ShaderManager::getShaderObject(const Common::UString &name, Shader
 }
 
 ShaderObject *ShaderManager::getShaderObject(const Common::UString &name, const Common::UString &source, ShaderType type) {
-	_shaderMutex.lock();
+	/* Models might be built on several threads at once. Only publish the
+	 * shader object once it's complete, so that nobody else sees it half-built. */
+	Common::StackLock lock(_shaderMutex);
+
 	ShaderObject *shaderObject = 0;
 	//ShaderObject *shaderObject = (ShaderObject *)(_shaderObjectMap[filename.c_str()]);
 	std::map<Common::UString, Shader::ShaderObject *>::iterator it = _shaderObjectMap.find(name);
 	if (it != _shaderObjectMap.end()) {
-		_shaderMutex.unlock();
 		return it->second;
 	}
 
@@ -209,11 +213,6 @@ ShaderObject *ShaderManager::getShaderObject(const Common::UString &name, const
 	shaderObject->glid = 0;
 	shaderObject->shaderString = source;
 
-	status("shader %s loaded", name.c_str());
-
-	_shaderObjectMap.insert(std::pair<Common::UString, ShaderObject *>(name, shaderObject));
-	_shaderMutex.unlock();
-
 	parseShaderVariables(source, shaderObject->variablesSelf);
 	genShaderVariableList(shaderObject, shaderObject->variablesCombined);
 	if (shaderObject->type == SHADER_VERTEX) {
@@ -222,6 +221,10 @@ ShaderObject *ShaderManager::getShaderObject(const Common::UString &name, const
 		shaderObject->id = _counterFID++; // Post decrement intentional.
 	}
 
+	status("shader %s loaded", name.c_str());
+
+	_shaderObjectMap.insert(std::pair<Common::UString, ShaderObject *>(name, shaderObject));
+
 	return shaderObject;
 }
 
@@ -409,9 +409,9 @@ void ShaderMaterial::useIncrement() {
 }
 
 void ShaderMaterial::useDecrement() {
-	if (_usageCount) {
-		--_usageCount;
-	}
+	uint32 count = _usageCount.load();
+	while ((count > 0) && !_usageCount.compare_exchange_weak(count, count - 1))
+		;
 }
 
 uint32 ShaderMaterial::useCount() const {
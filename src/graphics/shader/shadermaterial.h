@@ -25,6 +25,8 @@
 #ifndef GRAPHICS_SHADER_SHADERMATERIAL_H
 #define GRAPHICS_SHADER_SHADERMATERIAL_H
 
+#include "src/common/atomic.h"
+
 #include "src/graphics/shader/shader.h"
 
 namespace Graphics {
@@ -111,7 +113,7 @@ private:
 	GLenum _blendDstAlpha;
 
 	Common::UString _name;
-	uint32 _usageCount;
+	boost::atomic<uint32> _usageCount;
 
 	uint32 _alphaIndex;
 
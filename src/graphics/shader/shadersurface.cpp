@@ -330,9 +330,9 @@ void ShaderSurface::useIncrement() {
 }
 
 void ShaderSurface::useDecrement() {
-	if (_usageCount) {
-		--_usageCount;
-	}
+	uint32 count = _usageCount.load();
+	while ((count > 0) && !_usageCount.compare_exchange_weak(count, count - 1))
+		;
 }
 
 uint32 ShaderSurface::useCount() const {
@@ -25,6 +25,8 @@
 #ifndef GRAPHICS_SHADER_SHADERSURFACE_H
 #define GRAPHICS_SHADER_SHADERSURFACE_H
 
+#include "src/common/atomic.h"
+
 #include "glm/mat4x4.hpp"
 
 #include "src/graphics/shader/shader.h"
@@ -99,7 +101,7 @@ private:
 	uint32 _flags;
 
 	Common::UString _name;
-	uint32 _usageCount;
+	boost::atomic<uint32> _usageCount;
 
 	uint32 _objectModelviewIndex;
 	uint32 _textureViewIndex;
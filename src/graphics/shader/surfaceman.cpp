@@ -52,6 +52,8 @@ void SurfaceManager::init() {
 }
 
 void SurfaceManager::deinit() {
+	Common::StackLock lock(_mutex);
+
 	for (std::map<Common::UString, ShaderSurface *>::iterator iter = _resourceMap.begin(); iter != _resourceMap.end(); ++iter) {
 		delete iter->second;
 	}
@@ -59,6 +61,8 @@ void SurfaceManager::deinit() {
 }
 
 void SurfaceManager::cleanup() {
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, ShaderSurface *>::iterator iter = _resourceMap.begin();
 	while (iter != _resourceMap.end()) {
 		ShaderSurface *surface = iter->second;
@@ -71,15 +75,22 @@ void SurfaceManager::cleanup() {
 	}
 }
 
-void SurfaceManager::addSurface(ShaderSurface *surface) {
+ShaderSurface *SurfaceManager::addSurface(ShaderSurface *surface) {
 	if (!surface) {
-		return;
+		return 0;
 	}
 
-	std::map<Common::UString, ShaderSurface *>::iterator iter = _resourceMap.find(surface->getName());
-	if (iter == _resourceMap.end()) {
-		_resourceMap[surface->getName()] = surface;
+	Common::StackLock lock(_mutex);
+
+	std::pair<std::map<Common::UString, ShaderSurface *>::iterator, bool> result =
+		_resourceMap.insert(std::make_pair(surface->getName(), surface));
+
+	if (!result.second && (result.first->second != surface)) {
+		// Another model built the same surface in the meantime
+		delete surface;
 	}
+
+	return result.first->second;
 }
 
 void SurfaceManager::delSurface(ShaderSurface *surface) {
@@ -87,6 +98,8 @@ void SurfaceManager::delSurface(ShaderSurface *surface) {
 		return;
 	}
 
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, ShaderSurface *>::iterator iter = _resourceMap.find(surface->getName());
 	if (iter != _resourceMap.end()) {
 		delResource(iter);
@@ -94,6 +107,8 @@ void SurfaceManager::delSurface(ShaderSurface *surface) {
 }
 
 ShaderSurface *SurfaceManager::getSurface(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
 	std::map<Common::UString, ShaderSurface *>::iterator iter = _resourceMap.find(name);
 	if (iter != _resourceMap.end()) {
 		return iter->second;
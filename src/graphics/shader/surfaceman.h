@@ -51,8 +51,12 @@ public:
 	/** Remove any resource that has a usage count of zero. */
 	void cleanup();
 
-	/** Adds a surface to be managed. Cleanup will delete the surface if usage count is zero. */
-	void addSurface(ShaderSurface *surface);
+	/** Adds a surface to be managed. Cleanup will delete the surface if usage count is zero.
+	 *
+	 *  If a surface of the same name is already managed, the given surface is deleted
+	 *  and the existing one returned instead. Otherwise, the given surface is returned.
+	 */
+	ShaderSurface *addSurface(ShaderSurface *surface);
 
 	/** Forcibly remove the surface from the map. Consider using cleanup instead. */
 	void delSurface(ShaderSurface *surface);
@@ -63,6 +67,9 @@ public:
 private:
 	std::map<Common::UString, ShaderSurface *> _resourceMap;
 
+	/** Protects the resource map, for models loaded on several threads. */
+	Common::Mutex _mutex;
+
 	std::map<Common::UString, ShaderSurface *>::iterator delResource(std::map<Common::UString, ShaderSurface *>::iterator iter);
 };
 
@@ -92,6 +92,11 @@
 
 #include "src/graphics/yuv_to_rgb.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define YUVTORGB_HAVE_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 DECLARE_SINGLETON(Graphics::YUVToRGBManager)
 
 namespace Graphics {
@@ -176,19 +181,124 @@ YUVToRGBManager::YUVToRGBManager() {
 		Cb_g_tab[i] = (int16) (-(0.114 / 0.331) * CB);
 		Cb_b_tab[i] = (int16) ( (0.587 / 0.331) * CB) + 2 * 768 + 256;
 	}
+
+	_lookup[kScaleFull].reset(new YUVToRGBLookup(kScaleFull));
+	_lookup[kScaleITU ].reset(new YUVToRGBLookup(kScaleITU ));
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
 }
 
-const YUVToRGBLookup *YUVToRGBManager::getLookup(LuminanceScale scale) {
-	if (_lookup && _lookup->getScale() == scale)
-		return _lookup.get();
+const YUVToRGBLookup *YUVToRGBManager::getLookup(LuminanceScale scale) const {
+	return _lookup[scale].get();
+}
+
+bool YUVToRGBManager::hasSIMDConversion() {
+#ifdef YUVTORGB_HAVE_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+#ifdef YUVTORGB_HAVE_SSE2
+/* The SSE2 kernel calculates the exact same pixels as the lookup tables.
+ *
+ * The chroma offsets in _colorTab are the products of the chroma values
+ * and a constant, truncated towards zero. They're recreated here by a
+ * fixed-point multiplication of the absolute value, with the constants
+ * chosen to produce the same results for all 256 possible values.
+ *
+ * The rgbToPix tables clamp the sum of luminance and offset to [0, 255]
+ * for the full scale. For the ITU scale, they clamp to [16, 235] and then
+ * scale by 255 / 219, which again has a fixed-point equivalent. */
+
+/** Return the chroma offset (c * m) >> 14, rounded towards zero. */
+static inline __m128i chromaOffset(__m128i c, __m128i sign, uint16 m, bool negative) {
+	const __m128i magnitude = _mm_mulhi_epu16(_mm_slli_epi16(_mm_sub_epi16(_mm_xor_si128(c, sign), sign), 2), _mm_set1_epi16(m));
+
+	if (negative)
+		sign = _mm_xor_si128(sign, _mm_set1_epi16(-1));
+
+	return _mm_sub_epi16(_mm_xor_si128(magnitude, sign), sign);
+}
+
+/** Calculate one color channel of 8 pixels, from their luminance and chroma offset. */
+static inline __m128i channelSSE2(YUVToRGBManager::LuminanceScale scale, __m128i y, __m128i offset) {
+	__m128i x = _mm_add_epi16(y, offset);
+
+	if (scale == YUVToRGBManager::kScaleITU) {
+		x = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(x, _mm_set1_epi16(16)), _mm_set1_epi16(235)), _mm_set1_epi16(16));
+		x = _mm_add_epi16(x, _mm_mulhi_epu16(x, _mm_set1_epi16(10774)));
+	}
+
+	return x;
+}
+
+/** Calculate one color channel of 16 pixels and pack them into bytes. */
+static inline __m128i channelSSE2(YUVToRGBManager::LuminanceScale scale, __m128i y, __m128i offset, __m128i zero) {
+	const __m128i lo = channelSSE2(scale, _mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi16(offset, offset));
+	const __m128i hi = channelSSE2(scale, _mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi16(offset, offset));
+
+	return _mm_packus_epi16(lo, hi);
+}
+
+/** Write 16 BGRA pixels. */
+static inline void storePixelsSSE2(byte *dst, __m128i r, __m128i g, __m128i b, __m128i a) {
+	const __m128i bgLo = _mm_unpacklo_epi8(b, g), bgHi = _mm_unpackhi_epi8(b, g);
+	const __m128i raLo = _mm_unpacklo_epi8(r, a), raHi = _mm_unpackhi_epi8(r, a);
+
+	__m128i *d = reinterpret_cast<__m128i *>(dst);
+
+	_mm_storeu_si128(d + 0, _mm_unpacklo_epi16(bgLo, raLo));
+	_mm_storeu_si128(d + 1, _mm_unpackhi_epi16(bgLo, raLo));
+	_mm_storeu_si128(d + 2, _mm_unpacklo_epi16(bgHi, raHi));
+	_mm_storeu_si128(d + 3, _mm_unpackhi_epi16(bgHi, raHi));
+}
+
+static inline void convertRowSSE2(YUVToRGBManager::LuminanceScale scale, byte *dst, const byte *ySrc, const byte *aSrc,
+                                  __m128i offR, __m128i offG, __m128i offB, __m128i zero) {
+
+	const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ySrc));
+	const __m128i a = aSrc ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(aSrc)) : _mm_set1_epi8(-1);
 
-	_lookup.reset(new YUVToRGBLookup(scale));
-	return _lookup.get();
+	storePixelsSSE2(dst, channelSSE2(scale, y, offR, zero), channelSSE2(scale, y, offG, zero),
+	                     channelSSE2(scale, y, offB, zero), a);
 }
 
+/** Convert two rows of pixels, 16 pixels at a time, for as long as possible.
+ *
+ *  @return The number of chroma values processed.
+ */
+static int convert420RowsSSE2(YUVToRGBManager::LuminanceScale scale, byte *dst, int dstPitch,
+                              const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                              int halfWidth, int yPitch) {
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16(128);
+
+	const int count = halfWidth & ~7;
+	for (int w = 0; w < count; w += 8) {
+		const __m128i u = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(uSrc + w)), zero), bias);
+		const __m128i v = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(vSrc + w)), zero), bias);
+
+		const __m128i uSign = _mm_srai_epi16(u, 15);
+		const __m128i vSign = _mm_srai_epi16(v, 15);
+
+		const __m128i offR = chromaOffset(v, vSign, 22960, false);
+		const __m128i offG = _mm_add_epi16(chromaOffset(v, vSign, 11692, true), chromaOffset(u, uSign, 5643, true));
+		const __m128i offB = chromaOffset(u, uSign, 29055, false);
+
+		const int x = w * 2;
+
+		convertRowSSE2(scale, dst + dstPitch + x * 4, ySrc + x, aSrc ? (aSrc + x) : 0, offR, offG, offB, zero);
+		convertRowSSE2(scale, dst + x * 4, ySrc + yPitch + x, aSrc ? (aSrc + yPitch + x) : 0, offR, offG, offB, zero);
+	}
+
+	return count;
+}
+#endif
+
 #define PUT_PIXEL(s, a, d) \
 	L = &rgbToPix[(s)]; \
 	*((d)) = L[cb_b]; \
@@ -196,7 +306,7 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(LuminanceScale scale) {
 	*((d) + 2) = L[cr_r]; \
 	*((d) + 3) = (a)
 
-void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, bool simd) {
 	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(scale);
 	const byte *rgbToPix = lookup->getRGBToPix();
 
@@ -206,7 +316,23 @@ void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch,
 	dst += dstPitch * (yHeight - 2);
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		int w = 0;
+
+#ifdef YUVTORGB_HAVE_SSE2
+		if (simd) {
+			w = convert420RowsSSE2(scale, dst, dstPitch, ySrc, uSrc, vSrc, aSrc, halfWidth, yPitch);
+
+			uSrc += w;
+			vSrc += w;
+			ySrc += w * 2;
+			aSrc += w * 2;
+			dst  += w * 8;
+		}
+#else
+		UNUSED(simd);
+#endif
+
+		for (; w < halfWidth; w++) {
 			const byte *L;
 
 			int16 cr_r  = _colorTab[*vSrc + 0 * 256];
@@ -235,7 +361,7 @@ void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch,
 	}
 }
 
-void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch, bool simd) {
 	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(scale);
 	const byte *rgbToPix = lookup->getRGBToPix();
 
@@ -245,7 +371,22 @@ void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch,
 	dst += dstPitch * (yHeight - 2);
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		int w = 0;
+
+#ifdef YUVTORGB_HAVE_SSE2
+		if (simd) {
+			w = convert420RowsSSE2(scale, dst, dstPitch, ySrc, uSrc, vSrc, 0, halfWidth, yPitch);
+
+			uSrc += w;
+			vSrc += w;
+			ySrc += w * 2;
+			dst  += w * 8;
+		}
+#else
+		UNUSED(simd);
+#endif
+
+		for (; w < halfWidth; w++) {
 			const byte *L;
 
 			int16 cr_r  = _colorTab[*vSrc + 0 * 256];
@@ -55,8 +55,9 @@ public:
 	 * @param yHeight  the height of the y surface (must be divisible by 2)
 	 * @param yPitch   the pitch of the y surface
 	 * @param uvPitch  the pitch of the u and v surfaces
+	 * @param simd     use the SIMD kernel, if available (the output is the same either way)
 	 */
-	void convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+	void convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch, bool simd = true);
 
 	/**
 	 * Convert a YUV420 image to an RGBA surface
@@ -72,17 +73,22 @@ public:
 	 * @param yHeight  the height of the y surface (must be divisible by 2)
 	 * @param yPitch   the pitch of the y and a surfaces
 	 * @param uvPitch  the pitch of the u and v surfaces
+	 * @param simd     use the SIMD kernel, if available (the output is the same either way)
 	 */
-	void convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+	void convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, bool simd = true);
+
+	/** Is a SIMD kernel for the YUV to RGB conversion available? */
+	static bool hasSIMDConversion();
 
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
 	~YUVToRGBManager();
 
-	const YUVToRGBLookup *getLookup(LuminanceScale scale);
+	const YUVToRGBLookup *getLookup(LuminanceScale scale) const;
 
-	Common::ScopedPtr<YUVToRGBLookup> _lookup;
+	/** The lookup tables for both luminance scales. Created up front, so that converting is thread-safe. */
+	Common::ScopedPtr<YUVToRGBLookup> _lookup[2];
 	int16 _colorTab[4 * 256]; // 2048 bytes
 };
 
@@ -0,0 +1,104 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Bookkeeping of the used and unused sound channel slots.
+ */
+
+#include <cassert>
+
+#include "src/common/error.h"
+
+#include "src/sound/channelslots.h"
+
+namespace Sound {
+
+/** Position within the list of used slots of a slot that's not used. */
+static const size_t kSlotUnused = SIZE_MAX;
+
+ChannelSlots::ChannelSlots(size_t count) : _usedIndex(count, kSlotUnused) {
+	clear();
+}
+
+ChannelSlots::~ChannelSlots() {
+}
+
+size_t ChannelSlots::getCount() const {
+	return _usedIndex.size();
+}
+
+bool ChannelSlots::isFull() const {
+	return _free.empty();
+}
+
+bool ChannelSlots::isUsed(size_t slot) const {
+	return (slot < _usedIndex.size()) && (_usedIndex[slot] != kSlotUnused);
+}
+
+size_t ChannelSlots::allocate() {
+	if (_free.empty())
+		throw Common::Exception("All sound channels occupied");
+
+	const size_t slot = _free.back();
+	_free.pop_back();
+
+	_usedIndex[slot] = _used.size();
+	_used.push_back(slot);
+
+	return slot;
+}
+
+void ChannelSlots::free(size_t slot) {
+	if (!isUsed(slot))
+		return;
+
+	// Move the last used slot into the place of the freed one
+	const size_t index = _usedIndex[slot];
+	assert((index < _used.size()) && (_used[index] == slot));
+
+	_used[index] = _used.back();
+	_usedIndex[_used[index]] = index;
+	_used.pop_back();
+
+	_usedIndex[slot] = kSlotUnused;
+
+	_free.push_back(slot);
+}
+
+void ChannelSlots::clear() {
+	const size_t count = _usedIndex.size();
+
+	_used.clear();
+	_used.reserve(count);
+
+	_usedIndex.assign(count, kSlotUnused);
+
+	// Hand out the lowest slots first
+	_free.clear();
+	_free.reserve(count);
+	for (size_t i = count; i-- > 0; )
+		_free.push_back(i);
+}
+
+const std::vector<size_t> &ChannelSlots::getUsed() const {
+	return _used;
+}
+
+} // End of namespace Sound
@@ -0,0 +1,80 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Bookkeeping of the used and unused sound channel slots.
+ */
+
+#ifndef SOUND_CHANNELSLOTS_H
+#define SOUND_CHANNELSLOTS_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Sound {
+
+/** The slots of the sound channels, sorted into used and unused ones.
+ *
+ *  The unused slots are kept on a stack, so that finding one is a constant
+ *  time operation. Initially, the lowest slots are handed out first.
+ *
+ *  The used slots are kept in a dense list, so that going through all
+ *  playing channels doesn't need to look at all the unused slots. To free
+ *  a slot in constant time, the last slot of that list is moved into its
+ *  place, so the list is not in any particular order.
+ */
+class ChannelSlots {
+public:
+	ChannelSlots(size_t count);
+	~ChannelSlots();
+
+	/** Return the total number of slots. */
+	size_t getCount() const;
+
+	/** Are all slots in use? */
+	bool isFull() const;
+
+	/** Is this slot in use? */
+	bool isUsed(size_t slot) const;
+
+	/** Take an unused slot and return it. Throws if all slots are in use. */
+	size_t allocate();
+
+	/** Mark this slot as unused again. */
+	void free(size_t slot);
+
+	/** Mark all slots as unused. */
+	void clear();
+
+	/** Return all slots currently in use. */
+	const std::vector<size_t> &getUsed() const;
+
+private:
+	std::vector<size_t> _free; ///< All unused slots, the next one to use at the back.
+	std::vector<size_t> _used; ///< All slots in use.
+
+	/** The position of each slot within the list of used slots. */
+	std::vector<size_t> _usedIndex;
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_CHANNELSLOTS_H
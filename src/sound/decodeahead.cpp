@@ -0,0 +1,275 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An audio stream decoding another audio stream ahead of time.
+ */
+
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include "src/common/atomic.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ringbuffer.h"
+#include "src/common/threadpool.h"
+
+#include "src/sound/audiostream.h"
+#include "src/sound/decodeahead.h"
+
+namespace Sound {
+
+/** Maximum number of samples to decode ahead. Twice what the SoundManager queues into OpenAL. */
+static const size_t kDecodeAheadSize = 163840;
+
+/** Number of samples to decode at once. */
+static const size_t kDecodeChunkSize = 4096;
+
+class DecodeAheadStream : public AudioStream {
+public:
+	DecodeAheadStream(AudioStream *stream, Common::ThreadPool &pool);
+	~DecodeAheadStream();
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples);
+
+	int getChannels() const;
+	int getRate() const;
+
+	bool endOfData() const;
+	bool endOfStream() const;
+
+private:
+	/** Everything the decoding threads work on.
+	 *
+	 *  A decoding job holds onto the state, so that it can finish safely
+	 *  even after the stream has been destroyed.
+	 */
+	struct State {
+		Common::ScopedPtr<AudioStream> stream;
+
+		Common::RingBuffer<int16> buffer;
+
+		/** Is somebody decoding the stream? Only one thread may touch it at a time. */
+		boost::atomic<bool> decoding;
+		/** Should the decoding stop? */
+		boost::atomic<bool> stop;
+
+		boost::atomic<bool> endOfData;   ///< The decoded stream's endOfData().
+		boost::atomic<bool> endOfStream; ///< The decoded stream's endOfStream().
+		boost::atomic<bool> error;       ///< Did decoding the stream fail?
+
+		State(AudioStream *s);
+	};
+
+	boost::shared_ptr<State> _state;
+
+	Common::ThreadPool *_pool;
+
+	int _channels;
+	int _rate;
+
+	/** Return the number of samples to decode ahead of the stream. */
+	static size_t getBufferSize(const AudioStream &stream);
+
+	/** Queue a decoding job, if the buffer needs more data. */
+	void scheduleDecode();
+
+	/** Decode as much as fits into the buffer. */
+	static void decode(boost::shared_ptr<State> state);
+	/** Decode directly, while already owning the stream. */
+	static size_t decodeDirect(State &state, int16 *buffer, size_t numSamples);
+};
+
+size_t DecodeAheadStream::getBufferSize(const AudioStream &stream) {
+	const size_t channels = MAX(stream.getChannels(), 1);
+
+	/* Short sounds don't need the whole buffer. Not allocating it keeps
+	 * the many short sound effects playing at the same time cheap. */
+	const RewindableAudioStream *rewindable = dynamic_cast<const RewindableAudioStream *>(&stream);
+	if (!rewindable || (rewindable->getLength() == RewindableAudioStream::kInvalidLength))
+		return kDecodeAheadSize;
+
+	if (rewindable->getLength() >= (kDecodeAheadSize / channels))
+		return kDecodeAheadSize;
+
+	// Always have room for at least one sample frame
+	return MAX<size_t>(rewindable->getLength(), 1) * channels;
+}
+
+DecodeAheadStream::State::State(AudioStream *s) : stream(s), buffer(getBufferSize(*s)),
+	decoding(false), stop(false), endOfData(false), endOfStream(false), error(false) {
+
+	endOfData.store(stream->endOfData());
+	endOfStream.store(stream->endOfStream());
+}
+
+DecodeAheadStream::DecodeAheadStream(AudioStream *stream, Common::ThreadPool &pool) :
+	_pool(&pool), _channels(0), _rate(0) {
+
+	Common::ScopedPtr<AudioStream> guard(stream);
+	if (!stream)
+		throw Common::Exception("DecodeAheadStream: No stream");
+
+	_channels = stream->getChannels();
+	_rate     = stream->getRate();
+
+	_state = boost::make_shared<State>(guard.release());
+}
+
+DecodeAheadStream::~DecodeAheadStream() {
+	// A running job still holds the state, and will delete it when it's done
+	_state->stop.store(true);
+}
+
+int DecodeAheadStream::getChannels() const {
+	return _channels;
+}
+
+int DecodeAheadStream::getRate() const {
+	return _rate;
+}
+
+bool DecodeAheadStream::endOfData() const {
+	// Check whether more data is coming first, so we don't miss what was decoded in the meantime
+	if (_state->decoding.load(boost::memory_order_acquire))
+		return false;
+
+	if (!_state->buffer.empty())
+		return false;
+
+	return _state->endOfData.load() || _state->error.load();
+}
+
+bool DecodeAheadStream::endOfStream() const {
+	if (_state->decoding.load(boost::memory_order_acquire))
+		return false;
+
+	if (!_state->buffer.empty())
+		return false;
+
+	return _state->endOfStream.load() || _state->error.load();
+}
+
+size_t DecodeAheadStream::readBuffer(int16 *buffer, const size_t numSamples) {
+	size_t samples = 0;
+
+	const bool decoding = _state->decoding.load(boost::memory_order_acquire);
+	if (decoding && (_state->buffer.getReadable() < numSamples)) {
+		/* More data is being decoded right now. Wait for it instead of
+		 * handing out a short read, which would end up as a short buffer. */
+
+	} else if (!_state->buffer.empty()) {
+		samples = _state->buffer.read(buffer, numSamples);
+
+	} else {
+		// Nothing decoded ahead and nobody decoding. Do it ourselves, then
+
+		bool expected = false;
+		if (_state->decoding.compare_exchange_strong(expected, true, boost::memory_order_acquire)) {
+			try {
+				// A job might have finished just now
+				samples = _state->buffer.read(buffer, numSamples);
+				if (samples == 0)
+					samples = decodeDirect(*_state, buffer, numSamples);
+
+			} catch (...) {
+				_state->decoding.store(false, boost::memory_order_release);
+				throw;
+			}
+
+			_state->decoding.store(false, boost::memory_order_release);
+		}
+	}
+
+	if (samples == kSizeInvalid)
+		return kSizeInvalid;
+
+	scheduleDecode();
+
+	return samples;
+}
+
+void DecodeAheadStream::scheduleDecode() {
+	if (_state->endOfStream.load() || _state->error.load())
+		return;
+
+	// Start decoding again once the buffer is half empty
+	if (_state->buffer.getReadable() >= (_state->buffer.getCapacity() / 2))
+		return;
+
+	bool expected = false;
+	if (!_state->decoding.compare_exchange_strong(expected, true, boost::memory_order_acquire))
+		return;
+
+	_pool->add(boost::bind(&DecodeAheadStream::decode, _state));
+}
+
+size_t DecodeAheadStream::decodeDirect(State &state, int16 *buffer, size_t numSamples) {
+	const size_t samples = state.stream->readBuffer(buffer, numSamples);
+	if (samples == kSizeInvalid)
+		state.error.store(true);
+
+	state.endOfData.store(state.stream->endOfData());
+	state.endOfStream.store(state.stream->endOfStream());
+
+	return samples;
+}
+
+void DecodeAheadStream::decode(boost::shared_ptr<State> state) {
+	try {
+		const size_t channels = MAX(state->stream->getChannels(), 1);
+
+		int16 chunk[kDecodeChunkSize];
+		while (!state->stop.load()) {
+			// Only decode whole sample frames, so that each chunk starts with the first channel
+			size_t count = MIN(state->buffer.getWritable(), kDecodeChunkSize);
+			count -= count % channels;
+
+			if (count == 0)
+				break;
+
+			const size_t samples = decodeDirect(*state, chunk, count);
+			if (samples == kSizeInvalid)
+				break;
+
+			state->buffer.write(chunk, samples);
+
+			// No more data for now
+			if (samples < count)
+				break;
+		}
+
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed decoding an audio stream ahead");
+
+		state->error.store(true);
+	}
+
+	state->decoding.store(false, boost::memory_order_release);
+}
+
+
+AudioStream *makeDecodeAheadStream(AudioStream *stream, Common::ThreadPool &pool) {
+	return new DecodeAheadStream(stream, pool);
+}
+
+} // End of namespace Sound
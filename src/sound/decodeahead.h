@@ -0,0 +1,55 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  An audio stream decoding another audio stream ahead of time.
+ */
+
+#ifndef SOUND_DECODEAHEAD_H
+#define SOUND_DECODEAHEAD_H
+
+namespace Common {
+	class ThreadPool;
+}
+
+namespace Sound {
+
+class AudioStream;
+
+/**
+ * Takes an audio stream and decodes it ahead of time, on a pool of threads.
+ *
+ * The decoded samples are kept in a ring buffer, and reading from the new
+ * stream only moves them out of there. Should the decoding fall behind, a
+ * read decodes directly instead.
+ *
+ * The decoding happens concurrently with the reading, so the input stream
+ * must not be touched by anybody else afterwards.
+ *
+ * @param stream  The stream to decode. Will be taken over.
+ * @param pool    The threads to decode on.
+ *
+ * @return A new AudioStream.
+ */
+AudioStream *makeDecodeAheadStream(AudioStream *stream, Common::ThreadPool &pool);
+
+} // End of namespace Sound
+
+#endif // SOUND_DECODEAHEAD_H
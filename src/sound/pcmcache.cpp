@@ -0,0 +1,305 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A cache of completely decoded sounds.
+ */
+
+#include <cassert>
+
+#include <vector>
+#include <algorithm>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+
+#include "src/sound/audiostream.h"
+#include "src/sound/pcmcache.h"
+
+namespace Sound {
+
+/** Number of samples to decode at once. */
+static const size_t kDecodeChunkSize = 16384;
+
+struct PCMCache::Samples {
+	std::vector<int16> data;
+
+	int channels;
+	int rate;
+};
+
+/** An audio stream playing decoded samples out of the cache. */
+class PCMCacheStream : public RewindableAudioStream {
+public:
+	PCMCacheStream(const boost::shared_ptr<const std::vector<int16> > &data, int channels, int rate);
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples);
+
+	int getChannels() const;
+	int getRate() const;
+
+	bool endOfData() const;
+
+	bool rewind();
+
+	uint64 getLength() const;
+
+private:
+	boost::shared_ptr<const std::vector<int16> > _data;
+
+	int _channels;
+	int _rate;
+
+	size_t _pos;
+};
+
+PCMCacheStream::PCMCacheStream(const boost::shared_ptr<const std::vector<int16> > &data, int channels, int rate) :
+	_data(data), _channels(channels), _rate(rate), _pos(0) {
+
+}
+
+size_t PCMCacheStream::readBuffer(int16 *buffer, const size_t numSamples) {
+	const size_t samples = MIN(numSamples, _data->size() - _pos);
+
+	std::copy(_data->begin() + _pos, _data->begin() + _pos + samples, buffer);
+	_pos += samples;
+
+	return samples;
+}
+
+int PCMCacheStream::getChannels() const {
+	return _channels;
+}
+
+int PCMCacheStream::getRate() const {
+	return _rate;
+}
+
+bool PCMCacheStream::endOfData() const {
+	return _pos >= _data->size();
+}
+
+bool PCMCacheStream::rewind() {
+	_pos = 0;
+
+	return true;
+}
+
+uint64 PCMCacheStream::getLength() const {
+	return _data->size() / MAX(_channels, 1);
+}
+
+
+PCMCache::PCMCache(size_t maxSize, size_t maxSoundSize) :
+	_maxSize(maxSize), _maxSoundSize(MIN(maxSoundSize, maxSize)), _size(0), _generation(0) {
+
+}
+
+PCMCache::~PCMCache() {
+}
+
+size_t PCMCache::getSize() const {
+	Common::StackLock lock(_mutex);
+
+	return _size;
+}
+
+bool PCMCache::has(const Common::UString &name) const {
+	Common::StackLock lock(_mutex);
+
+	return _entries.find(name.toLower()) != _entries.end();
+}
+
+RewindableAudioStream *PCMCache::get(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator entry = _entries.find(name.toLower());
+	if (entry == _entries.end())
+		return 0;
+
+	// Now the most recently used sound
+	_usage.splice(_usage.begin(), _usage, entry->second.usage);
+
+	const SamplesPtr &samples = entry->second.samples;
+
+	// The stream shares the samples, so they're kept alive even if the sound is dropped from the cache
+	return new PCMCacheStream(boost::shared_ptr<const std::vector<int16> >(samples, &samples->data),
+	                          samples->channels, samples->rate);
+}
+
+bool PCMCache::add(const Common::UString &name, RewindableAudioStream &stream) {
+	const Common::UString key = name.toLower();
+
+	uint32 generation = 0;
+	{
+		Common::StackLock lock(_mutex);
+
+		if (_entries.find(key) != _entries.end()) {
+			_reserved.erase(key);
+			return true;
+		}
+
+		if (_rejected.find(key) != _rejected.end()) {
+			_reserved.erase(key);
+			return false;
+		}
+
+		generation = _generation;
+	}
+
+	// Decode without holding the lock, so that other sounds can be played meanwhile
+	SamplesPtr samples;
+	try {
+		samples.reset(decode(stream));
+	} catch (...) {
+		Common::StackLock lock(_mutex);
+
+		_reserved.erase(key);
+		throw;
+	}
+
+	Common::StackLock lock(_mutex);
+
+	_reserved.erase(key);
+
+	// The cache was cleared in the meantime, so this sound might be outdated
+	if (generation != _generation)
+		return false;
+
+	if (!samples) {
+		_rejected.insert(key);
+		return false;
+	}
+
+	// Somebody else might have been faster
+	if (_entries.find(key) != _entries.end())
+		return true;
+
+	const size_t size = samples->data.size() * sizeof(int16);
+
+	makeRoom(size);
+
+	_usage.push_front(key);
+
+	Entry &entry = _entries[key];
+	entry.samples = samples;
+	entry.usage   = _usage.begin();
+
+	_size += size;
+
+	return true;
+}
+
+bool PCMCache::reserve(const Common::UString &name) {
+	const Common::UString key = name.toLower();
+
+	Common::StackLock lock(_mutex);
+
+	if ((_entries.find(key) != _entries.end()) || (_rejected.find(key) != _rejected.end()))
+		return false;
+
+	return _reserved.insert(key).second;
+}
+
+void PCMCache::reject(const Common::UString &name) {
+	const Common::UString key = name.toLower();
+
+	Common::StackLock lock(_mutex);
+
+	_reserved.erase(key);
+	_rejected.insert(key);
+}
+
+void PCMCache::clear() {
+	Common::StackLock lock(_mutex);
+
+	_entries.clear();
+	_usage.clear();
+	_rejected.clear();
+	_reserved.clear();
+
+	_size = 0;
+
+	_generation++;
+}
+
+PCMCache::Samples *PCMCache::decode(RewindableAudioStream &stream) const {
+	const size_t maxSamples = _maxSoundSize / sizeof(int16);
+
+	const int channels = stream.getChannels();
+
+	// Don't bother decoding if we already know the sound is too long
+	const uint64 length = stream.getLength();
+	if ((length != RewindableAudioStream::kInvalidLength) && ((length * MAX(channels, 1)) > maxSamples))
+		return 0;
+
+	Common::ScopedPtr<Samples> samples(new Samples);
+
+	samples->channels = channels;
+	samples->rate     = stream.getRate();
+
+	if (length != RewindableAudioStream::kInvalidLength)
+		samples->data.reserve(length * MAX(channels, 1));
+
+	while (!stream.endOfData()) {
+		const size_t pos = samples->data.size();
+		if (pos > maxSamples) {
+			// Too long after all. Let it play normally instead
+			stream.rewind();
+			return 0;
+		}
+
+		samples->data.resize(pos + kDecodeChunkSize);
+
+		const size_t count = stream.readBuffer(&samples->data[pos], kDecodeChunkSize);
+		if (count == AudioStream::kSizeInvalid)
+			throw Common::Exception("Failed to decode sound");
+
+		samples->data.resize(pos + count);
+
+		if (count < kDecodeChunkSize)
+			break;
+	}
+
+	if (samples->data.size() > maxSamples) {
+		stream.rewind();
+		return 0;
+	}
+
+	// Give back what we reserved too much
+	std::vector<int16>(samples->data).swap(samples->data);
+
+	return samples.release();
+}
+
+void PCMCache::makeRoom(size_t size) {
+	while (!_usage.empty() && ((_size + size) > _maxSize)) {
+		EntryMap::iterator entry = _entries.find(_usage.back());
+		assert(entry != _entries.end());
+
+		_size -= entry->second.samples->data.size() * sizeof(int16);
+
+		_entries.erase(entry);
+		_usage.pop_back();
+	}
+}
+
+} // End of namespace Sound
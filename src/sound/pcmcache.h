@@ -0,0 +1,146 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A cache of completely decoded sounds.
+ */
+
+#ifndef SOUND_PCMCACHE_H
+#define SOUND_PCMCACHE_H
+
+#include <list>
+#include <map>
+#include <set>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+
+namespace Sound {
+
+class AudioStream;
+class RewindableAudioStream;
+
+/** A size-bounded cache of completely decoded sounds.
+ *
+ *  Short sounds that are played again and again, like UI clicks or
+ *  footsteps, can be decoded once and then played out of memory.
+ *  Once the cache is full, the sounds that were played the longest
+ *  time ago are dropped.
+ *
+ *  Sounds are identified by their name, ignoring case. Streams handed
+ *  out by the cache keep their samples alive even when the sound is
+ *  dropped from the cache. All methods are thread-safe.
+ */
+class PCMCache : boost::noncopyable {
+public:
+	/** Create a sound cache.
+	 *
+	 *  @param maxSize The maximum number of bytes in all cached sounds.
+	 *  @param maxSoundSize The maximum number of bytes in a single cached sound.
+	 */
+	PCMCache(size_t maxSize, size_t maxSoundSize);
+	~PCMCache();
+
+	/** Return the number of bytes in all cached sounds. */
+	size_t getSize() const;
+
+	/** Is this sound in the cache? */
+	bool has(const Common::UString &name) const;
+
+	/** Return a new stream playing this sound from the cache, or 0 if it isn't cached. */
+	RewindableAudioStream *get(const Common::UString &name);
+
+	/** Decode a sound completely and add it to the cache.
+	 *
+	 *  If the sound is too long to be cached, the stream is rewound and
+	 *  left for playing as usual. The stream is never taken over.
+	 *
+	 *  If the cache is cleared while the sound is decoded, the sound is
+	 *  not added, since it might come from resources that are gone now.
+	 *
+	 *  @param  name The name of the sound.
+	 *  @param  stream The sound to decode.
+	 *  @return true if the sound is now in the cache.
+	 */
+	bool add(const Common::UString &name, RewindableAudioStream &stream);
+
+	/** Reserve a sound for adding it later, possibly on another thread.
+	 *
+	 *  @return false if the sound is already cached, can't be cached, or
+	 *          somebody else is about to add it.
+	 */
+	bool reserve(const Common::UString &name);
+
+	/** Remember that a sound can't be cached, and drop its reservation. */
+	void reject(const Common::UString &name);
+
+	/** Remove all sounds from the cache. */
+	void clear();
+
+private:
+	/** The decoded samples of a sound. */
+	struct Samples;
+
+	typedef boost::shared_ptr<const Samples> SamplesPtr;
+
+	typedef std::list<Common::UString> UsageList;
+
+	struct Entry {
+		SamplesPtr samples;
+		UsageList::iterator usage; ///< The sound's place in the usage list.
+	};
+
+	typedef std::map<Common::UString, Entry> EntryMap;
+
+	size_t _maxSize;
+	size_t _maxSoundSize;
+
+	size_t _size; ///< The number of bytes in all cached sounds.
+
+	EntryMap _entries;
+
+	/** The names of all cached sounds, from the most recently to the least recently used. */
+	UsageList _usage;
+
+	/** Sounds that were found to be too long for the cache, or failed to decode. */
+	std::set<Common::UString> _rejected;
+
+	/** Sounds reserved for adding, but not added yet. */
+	std::set<Common::UString> _reserved;
+
+	/** Counts how often the cache was cleared. */
+	uint32 _generation;
+
+	mutable Common::Mutex _mutex;
+
+	/** Decode a sound, as long as it fits. Returns 0 if it doesn't. */
+	Samples *decode(RewindableAudioStream &stream) const;
+
+	/** Drop the least recently used sounds until this many bytes fit. */
+	void makeRoom(size_t size);
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_PCMCACHE_H
@@ -27,6 +27,9 @@ src_sound_libsound_la_SOURCES += \
     src/sound/sound.h \
     src/sound/audiostream.h \
     src/sound/interleaver.h \
+    src/sound/decodeahead.h \
+    src/sound/pcmcache.h \
+    src/sound/channelslots.h \
     src/sound/xactwavebank.h \
     src/sound/xactwavebank_ascii.h \
     src/sound/xactwavebank_binary.h \
@@ -41,6 +44,9 @@ src_sound_libsound_la_SOURCES += \
     src/sound/sound.cpp \
     src/sound/audiostream.cpp \
     src/sound/interleaver.cpp \
+    src/sound/decodeahead.cpp \
+    src/sound/pcmcache.cpp \
+    src/sound/channelslots.cpp \
     src/sound/xactwavebank.cpp \
     src/sound/xactwavebank_ascii.cpp \
     src/sound/xactwavebank_binary.cpp \
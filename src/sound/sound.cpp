@@ -23,19 +23,23 @@
  */
 
 #include <cassert>
-#include <cstring>
 
 #include <boost/scope_exit.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
 
 #include "src/common/util.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/configman.h"
 #include "src/common/debug.h"
+#include "src/common/threadpool.h"
 
 #include "src/sound/sound.h"
 #include "src/sound/audiostream.h"
+#include "src/sound/decodeahead.h"
 #include "src/sound/decoders/asf.h"
 #ifdef ENABLE_MAD
 #include "src/sound/decoders/mp3.h"
@@ -62,17 +66,72 @@ static const size_t kOpenALBufferCount = 5;
  */
 static const size_t kOpenALBufferSize = 32768;
 
+/** Number of threads decoding sound streams ahead of time. */
+static const size_t kDecodeThreadCount = 2;
+
+/** Maximum number of bytes of decoded samples in the sound cache. */
+static const size_t kPCMCacheSize = 32 * 1024 * 1024;
+
+/** Maximum number of bytes of decoded samples of one sound in the sound cache.
+ *
+ *  @note That's about 6 seconds of 44.1kHz stereo. Longer sounds are played
+ *        too rarely to be worth keeping around.
+ */
+static const size_t kPCMCacheSoundSize = 1024 * 1024;
+
 namespace Sound {
 
 SoundManager::Channel::Channel(uint32 i, size_t idx, SoundType t,
                                const TypeList::iterator &ti, AudioStream *s, bool d) :
-	id(i), index(idx), state(AL_PAUSED), stream(s, d), source(0),
+	id(i), index(idx), lockers(0), state(AL_PAUSED), stream(s, d), source(0),
 	type(t), typeIt(ti), finishedBuffers(0), gain(1.0f) {
 
 }
 
 
-SoundManager::SoundManager() : _ready(false), _hasSound(false), _hasMultiChannel(false), _format51(0) {
+SoundManager::ChannelLock::ChannelLock(SoundManager &manager, const ChannelHandle &handle) : _channel(0) {
+	Channel *channel = 0;
+
+	{
+		Common::StackLock lock(manager._mutex);
+
+		channel = manager.getChannel(handle);
+		if (!channel)
+			return;
+
+		// Keep the channel from being deleted while we wait for its lock
+		channel->lockers++;
+	}
+
+	/* Don't hold the global mutex while waiting, or everybody else would wait
+	 * for the sound thread buffering this channel, too. */
+	channel->mutex.lock();
+
+	// The channel might have been freed in the meantime
+	if (channel->id != handle.id) {
+		channel->mutex.unlock();
+		channel->lockers--;
+		return;
+	}
+
+	_channel = channel;
+}
+
+SoundManager::ChannelLock::~ChannelLock() {
+	if (!_channel)
+		return;
+
+	_channel->mutex.unlock();
+	_channel->lockers--;
+}
+
+SoundManager::Channel *SoundManager::ChannelLock::get() const {
+	return _channel;
+}
+
+
+SoundManager::SoundManager() : _ready(false), _hasSound(false), _hasMultiChannel(false), _format51(0),
+	_slots(kChannelCount), _pcmCache(kPCMCacheSize, kPCMCacheSoundSize) {
 }
 
 SoundManager::~SoundManager() {
@@ -84,6 +143,8 @@ void SoundManager::init() {
 
 	_curID = 1;
 
+	_slots.clear();
+
 	_ctx = 0;
 
 	_hasSound = false;
@@ -109,6 +170,8 @@ void SoundManager::init() {
 		_hasMultiChannel = alIsExtensionPresent("AL_EXT_MCFORMATS") != 0;
 		_format51        = alGetEnumValue("AL_FORMAT_51CHN16");
 
+		_decodePool.reset(new Common::ThreadPool(kDecodeThreadCount));
+
 		if (!createThread("SoundManager"))
 			throw Common::Exception("Failed to create sound thread: %s", SDL_GetError());
 
@@ -116,6 +179,8 @@ void SoundManager::init() {
 
 	} catch (...) {
 		Common::exceptionDispatcherWarning("Failed to initialize OpenAL. Disabling sound output!");
+
+		_decodePool.reset();
 	}
 
 	_ready = true;
@@ -130,6 +195,7 @@ void SoundManager::init() {
 	setTypeGain(kSoundTypeVoice, ConfigMan.getDouble("volume_voice", 1.0));
 	setTypeGain(kSoundTypeVideo, ConfigMan.getDouble("volume_video", 1.0));
 
+	Common::StackLock alLock(_alMutex);
 	alDistanceModel(AL_LINEAR_DISTANCE_CLAMPED);
 }
 
@@ -139,8 +205,18 @@ void SoundManager::deinit() {
 
 	destroyThread();
 
-	for (size_t i = 0; i < kChannelCount; i++)
-		freeChannel(i);
+	stopAll();
+
+	{
+		Common::StackLock lock(_mutex);
+
+		deleteFreedChannels();
+	}
+
+	_decodePool.reset();
+	_bufferPool.clear();
+
+	_pcmCache.clear();
 
 	if (_hasSound) {
 		alcMakeContextCurrent(0);
@@ -172,21 +248,14 @@ bool SoundManager::isValidChannel(const ChannelHandle &handle) const {
 }
 
 bool SoundManager::isPlaying(const ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
-
-	if ((handle.channel >= kChannelCount) || (handle.id == 0) || !_channels[handle.channel])
-		return false;
-
-	if (_channels[handle.channel]->id != handle.id)
+	ChannelLock lock(*this, handle);
+	if (!lock.get())
 		return false;
 
-	return isPlaying(handle.channel);
+	return isPlaying(*lock.get());
 }
 
-bool SoundManager::isPlaying(size_t channel) const {
-	if ((channel >= kChannelCount) || !_channels[channel])
-		return false;
-
+bool SoundManager::isPlaying(Channel &channel) const {
 	// TODO: This might pose a problem should we ever need to wait
 	//       for sounds to finish (for syncing, ...). We need to
 	//       add a way for audio streams to tell us how long they are
@@ -194,51 +263,49 @@ bool SoundManager::isPlaying(size_t channel) const {
 	if (!_hasSound)
 		return true;
 
+	Common::StackLock alLock(_alMutex);
+
 	ALenum error = AL_NO_ERROR;
 
 	ALint val;
-	alGetSourcei(_channels[channel]->source, AL_SOURCE_STATE, &val);
+	alGetSourcei(channel.source, AL_SOURCE_STATE, &val);
 	if ((error = alGetError()) != AL_NO_ERROR)
 		throw Common::Exception("OpenAL error while getting source state in %s: 0x%X",
-		                        formatChannel(_channels[channel].get()).c_str(), error);
+		                        formatChannel(&channel).c_str(), error);
 
 	if (val != AL_PLAYING) {
-		if (!_channels[channel]->stream || _channels[channel]->stream->endOfStream()) {
+		if (!channel.stream || channel.stream->endOfStream()) {
 			ALint buffersQueued;
-			alGetSourcei(_channels[channel]->source, AL_BUFFERS_QUEUED, &buffersQueued);
+			alGetSourcei(channel.source, AL_BUFFERS_QUEUED, &buffersQueued);
 			if ((error = alGetError()) != AL_NO_ERROR)
 				throw Common::Exception("OpenAL error while getting queued buffers in %s: 0x%X",
-				                        formatChannel(_channels[channel].get()).c_str(), error);
+				                        formatChannel(&channel).c_str(), error);
 
 			ALint buffersProcessed;
-			alGetSourcei(_channels[channel]->source, AL_BUFFERS_PROCESSED, &buffersProcessed);
+			alGetSourcei(channel.source, AL_BUFFERS_PROCESSED, &buffersProcessed);
 			if ((error = alGetError()) != AL_NO_ERROR)
 				throw Common::Exception("OpenAL error while getting processed buffers in %s: 0x%X",
-				                        formatChannel(_channels[channel].get()).c_str(), error);
+				                        formatChannel(&channel).c_str(), error);
 
 			if (buffersQueued == buffersProcessed)
 				return false;
 		}
 
-		if (_channels[channel]->state != AL_PLAYING)
+		if (channel.state != AL_PLAYING)
 			return true;
 
-		alSourcePlay(_channels[channel]->source);
+		alSourcePlay(channel.source);
 	}
 
 	return true;
 }
 
 bool SoundManager::isPaused(const ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
-
-	if ((handle.channel == 0) || (handle.id == 0) || !_channels[handle.channel])
-		return false;
-
-	if (_channels[handle.channel]->id != handle.id)
+	ChannelLock lock(*this, handle);
+	if (!lock.get())
 		return false;
 
-	return _channels[handle.channel]->state == AL_PAUSED;
+	return lock.get()->state == AL_PAUSED;
 }
 
 AudioStream *SoundManager::makeAudioStream(Common::SeekableReadStream *stream) {
@@ -335,20 +402,50 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 	if (!audStream)
 		throw Common::Exception("No audio stream");
 
-	Common::StackLock lock(_mutex);
+	/* Decode the streams we own on the decoding threads, so that the sound
+	 * thread only has to move the samples into OpenAL. Streams we don't own
+	 * might still be fed by somebody else, so we leave them alone. */
+	if (_decodePool && disposeAfterUse)
+		audStream = makeDecodeAheadStream(audStream, *_decodePool);
+
+	return createChannel(audStream, type, disposeAfterUse);
+}
+
+ChannelHandle SoundManager::createChannel(AudioStream *audStream, SoundType type, bool disposeAfterUse) {
+	ChannelHandle handle;
+	Channel *newChan = 0;
 
-	ChannelHandle handle = newChannel();
+	{
+		Common::StackLock lock(_mutex);
+
+		// Without a sound thread, nobody else cleans up after stopped channels
+		if (!_hasSound)
+			deleteFreedChannels();
+
+		handle = newChannel();
+
+		_channels[handle.channel].reset(new Channel(handle.id, handle.channel, type, _types[type].list.end(),
+		                                            audStream, disposeAfterUse));
+		newChan = _channels[handle.channel].get();
+
+		// Add the channel to the correct type list
+		_types[type].list.push_back(newChan);
+		newChan->typeIt = --_types[type].list.end();
+
+		/* Fill the buffers with only the channel itself locked, so that
+		 * the sound thread and other channels don't have to wait. */
+		newChan->mutex.lock();
+	}
 
 	bool success = false;
-	BOOST_SCOPE_EXIT ( (&success) (&handle) (this_) ) {
+	BOOST_SCOPE_EXIT ( (&success) (&handle) (&newChan) (this_) ) {
+		newChan->mutex.unlock();
+
 		if (!success)
 			this_->freeChannel(handle);
 	} BOOST_SCOPE_EXIT_END
 
-	const TypeList::iterator typeEndIt = _types[type].list.end();
-
-	_channels[handle.channel].reset(new Channel(handle.id, handle.channel, type, typeEndIt, audStream, disposeAfterUse));
-	Channel &channel = *_channels[handle.channel];
+	Channel &channel = *newChan;
 
 	if (!channel.stream)
 		throw Common::Exception("Could not detect stream type");
@@ -356,22 +453,34 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 	ALenum error = AL_NO_ERROR;
 
 	if (_hasSound) {
-		// Create the source
-		alGenSources(1, &channel.source);
-		if ((error = alGetError()) != AL_NO_ERROR)
-			throw Common::Exception("OpenAL error while generating sources: 0x%X", error);
+		{
+			Common::StackLock alLock(_alMutex);
+
+			// Create the source
+			alGenSources(1, &channel.source);
+			if ((error = alGetError()) != AL_NO_ERROR)
+				throw Common::Exception("OpenAL error while generating sources: 0x%X", error);
+		}
 
 		// Create all needed buffers
 		for (size_t i = 0; i < kOpenALBufferCount; i++) {
 			ALuint buffer;
 
-			alGenBuffers(1, &buffer);
-			if ((error = alGetError()) != AL_NO_ERROR)
-				throw Common::Exception("OpenAL error while generating buffers: 0x%X", error);
+			{
+				Common::StackLock alLock(_alMutex);
+
+				alGenBuffers(1, &buffer);
+				if ((error = alGetError()) != AL_NO_ERROR)
+					throw Common::Exception("OpenAL error while generating buffers: 0x%X", error);
+			}
+
+			channel.buffers.push_back(buffer);
 
 			if (fillBuffer(channel, buffer, channel.stream.get(), channel.bufferSize[buffer])) {
 				// If we could fill the buffer with data, queue it
 
+				Common::StackLock alLock(_alMutex);
+
 				alSourceQueueBuffers(channel.source, 1, &buffer);
 				if ((error = alGetError()) != AL_NO_ERROR)
 					throw Common::Exception("OpenAL error while queueing buffers: 0x%X", error);
@@ -379,32 +488,55 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 			} else
 				// If not, put it into our free list
 				channel.freeBuffers.push_back(buffer);
-
-			channel.buffers.push_back(buffer);
 		}
 
+		Common::StackLock alLock(_alMutex);
+
 		// Set the gain to the current sound type gain
 		alSourcef(channel.source, AL_GAIN, _types[channel.type].gain);
 		// Set the sound per default as relative.
 		alSourcei(channel.source, AL_SOURCE_RELATIVE, AL_TRUE);
 	}
 
-	// Add the channel to the correct type list
-	_types[channel.type].list.push_back(&channel);
-	channel.typeIt = --_types[channel.type].list.end();
-
-	debugC(Common::kDebugSound, 2, "Created sound channel %s", formatChannel(handle).c_str());
+	debugC(Common::kDebugSound, 2, "Created sound channel %s", formatChannel(&channel).c_str());
 
 	success = true;
 	return handle;
 }
 
-ChannelHandle SoundManager::playSoundFile(Common::SeekableReadStream *wavStream, SoundType type, bool loop) {
+ChannelHandle SoundManager::playSoundFile(Common::SeekableReadStream *wavStream, SoundType type, bool loop,
+                                          const Common::UString &cacheName) {
 	checkReady();
 
 	if (!wavStream)
 		throw Common::Exception("No stream");
 
+	/* Decoding the whole sound here would delay playing it. Instead, we play
+	 * this one as usual, and fill the cache from a copy of the file on the
+	 * decoding threads. A file that's already larger than a cached sound
+	 * decodes into even more samples, so we don't bother with those. */
+	const size_t fileSize = wavStream->size();
+	if (!cacheName.empty() && _decodePool && (fileSize > 0) && (fileSize <= kPCMCacheSoundSize) &&
+	    _pcmCache.reserve(cacheName)) {
+
+		boost::shared_ptr< std::vector<byte> > data = boost::make_shared< std::vector<byte> >(fileSize);
+
+		try {
+			wavStream->seek(0);
+			if (wavStream->read(&(*data)[0], fileSize) != fileSize)
+				throw Common::Exception(Common::kReadError);
+			wavStream->seek(0);
+
+			_decodePool->add(boost::bind(&SoundManager::cacheSound, this, cacheName, data));
+
+		} catch (...) {
+			_pcmCache.reject(cacheName);
+
+			delete wavStream;
+			throw;
+		}
+	}
+
 	AudioStream *audioStream = makeAudioStream(wavStream);
 
 	if (!audioStream)
@@ -421,6 +553,64 @@ ChannelHandle SoundManager::playSoundFile(Common::SeekableReadStream *wavStream,
 	return playAudioStream(audioStream, type);
 }
 
+ChannelHandle SoundManager::playCachedSound(const Common::UString &name, SoundType type, bool loop) {
+	assert((type >= 0) && (type < kSoundTypeMAX));
+
+	checkReady();
+
+	RewindableAudioStream *reAudStream = _pcmCache.get(name);
+	if (!reAudStream)
+		return ChannelHandle();
+
+	AudioStream *audioStream = reAudStream;
+	if (loop)
+		audioStream = makeLoopingAudioStream(reAudStream, 0);
+
+	// The samples are already decoded, so there's no need to decode ahead
+	return createChannel(audioStream, type, true);
+}
+
+bool SoundManager::cacheSoundFile(const Common::UString &name, Common::SeekableReadStream *wavStream) {
+	if (!wavStream)
+		throw Common::Exception("No stream");
+
+	Common::ScopedPtr<AudioStream> audioStream(makeAudioStream(wavStream));
+
+	RewindableAudioStream *reAudStream = dynamic_cast<RewindableAudioStream *>(audioStream.get());
+	if (!reAudStream)
+		return false;
+
+	return _pcmCache.add(name, *reAudStream);
+}
+
+void SoundManager::cacheSound(const Common::UString &name, boost::shared_ptr< std::vector<byte> > data) {
+	try {
+		Common::ScopedPtr<AudioStream> audioStream(makeAudioStream(new Common::MemoryReadStream(&(*data)[0], data->size())));
+
+		RewindableAudioStream *reAudStream = dynamic_cast<RewindableAudioStream *>(audioStream.get());
+		if (!reAudStream) {
+			_pcmCache.reject(name);
+			return;
+		}
+
+		if (_pcmCache.add(name, *reAudStream))
+			debugC(Common::kDebugSound, 2, "Cached sound \"%s\"", name.c_str());
+
+	} catch (...) {
+		_pcmCache.reject(name);
+
+		Common::exceptionDispatcherWarning("Failed to cache sound \"%s\"", name.c_str());
+	}
+}
+
+bool SoundManager::isSoundCached(const Common::UString &name) const {
+	return _pcmCache.has(name);
+}
+
+void SoundManager::clearSoundCache() {
+	_pcmCache.clear();
+}
+
 const SoundManager::Channel *SoundManager::getChannel(const ChannelHandle &handle) const {
 	if ((handle.channel >= kChannelCount) || (handle.id == 0))
 		return 0;
@@ -448,23 +638,23 @@ SoundManager::Channel *SoundManager::getChannel(const ChannelHandle &handle) {
 }
 
 void SoundManager::startChannel(ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	channel->state = AL_PLAYING;
 
-	debugC(Common::kDebugSound, 1, "Start sound channel %s", formatChannel(handle).c_str());
+	debugC(Common::kDebugSound, 1, "Start sound channel %s", formatChannel(channel).c_str());
 
 	triggerUpdate();
 }
 
 void SoundManager::pauseChannel(ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
@@ -472,45 +662,66 @@ void SoundManager::pauseChannel(ChannelHandle &handle) {
 }
 
 void SoundManager::pauseChannel(ChannelHandle &handle, bool pause) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	debugC(Common::kDebugSound, 1, "%s sound channel %s", pause ? "Pause" : "Unpause",
-	       formatChannel(handle).c_str());
+	       formatChannel(channel).c_str());
 
 	pauseChannel(channel, pause);
 }
 
 void SoundManager::stopChannel(ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_mutex);
 
-	if (isValidChannel(handle))
-		debugC(Common::kDebugSound, 1, "Stop sound channel %s", formatChannel(handle).c_str());
+		if (isValidChannel(handle))
+			debugC(Common::kDebugSound, 1, "Stop sound channel %s", formatChannel(handle).c_str());
+	}
 
 	freeChannel(handle);
 }
 
 void SoundManager::pauseAll(bool pause) {
-	Common::StackLock lock(_mutex);
+	std::vector<ChannelHandle> handles;
 
-	for (size_t i = 0; i < kChannelCount; i++)
-		pauseChannel(_channels[i].get(), pause);
+	{
+		Common::StackLock lock(_mutex);
+
+		const std::vector<size_t> &used = _slots.getUsed();
+		for (std::vector<size_t>::const_iterator c = used.begin(); c != used.end(); ++c)
+			handles.push_back(getHandle(*_channels[*c]));
+	}
+
+	// Lock the channels one by one, without holding the global mutex
+	for (std::vector<ChannelHandle>::const_iterator h = handles.begin(); h != handles.end(); ++h) {
+		ChannelLock lock(*this, *h);
+
+		pauseChannel(lock.get(), pause);
+	}
 }
 
 void SoundManager::stopAll() {
-	Common::StackLock lock(_mutex);
+	std::vector<Channel *> channels;
+
+	{
+		Common::StackLock lock(_mutex);
 
-	for (size_t i = 0; i < kChannelCount; i++)
-		freeChannel(i);
+		while (!_slots.getUsed().empty())
+			channels.push_back(detachChannel(_slots.getUsed().back()));
+	}
+
+	for (std::vector<Channel *>::iterator c = channels.begin(); c != channels.end(); ++c)
+		discardChannel(*c);
 }
 
 void SoundManager::setListenerGain(float gain) {
 	checkReady();
 
-	Common::StackLock lock(_mutex);
+	Common::StackLock alLock(_alMutex);
 
 	if (_hasSound)
 		alListenerf(AL_GAIN, gain);
@@ -519,7 +730,7 @@ void SoundManager::setListenerGain(float gain) {
 void SoundManager::setListenerPosition(float x, float y, float z) {
 	checkReady();
 
-	Common::StackLock lock(_mutex);
+	Common::StackLock alLock(_alMutex);
 
 	alListener3f(AL_POSITION, x, y, z);
 }
@@ -527,140 +738,212 @@ void SoundManager::setListenerPosition(float x, float y, float z) {
 void SoundManager::setListenerOrientation(float dirX, float dirY, float dirZ, float upX, float upY, float upZ) {
 	checkReady();
 
-	Common::StackLock lock(_mutex);
+	Common::StackLock alLock(_alMutex);
 
 	float orientation[] = {dirX, dirY, dirZ, upX, upY, upZ};
 	alListenerfv(AL_ORIENTATION, orientation);
 }
 
 void SoundManager::setChannelPosition(const ChannelHandle &handle, float x, float y, float z) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	if (channel->stream->getChannels() > 1)
 		throw Common::Exception("Cannot set position of a non-mono sound in %s",
-		                        formatChannel(handle).c_str());
+		                        formatChannel(channel).c_str());
+
+	if (_hasSound) {
+		Common::StackLock alLock(_alMutex);
 
-	if (_hasSound)
 		alSource3f(channel->source, AL_POSITION, x, y, z);
+	}
 }
 
 void SoundManager::getChannelPosition(const ChannelHandle &handle, float &x, float &y, float &z) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	if (channel->stream->getChannels() > 1)
 		throw Common::Exception("Cannot get position of a non-mono sound in %s",
-		                        formatChannel(handle).c_str());
+		                        formatChannel(channel).c_str());
+
+	if (_hasSound) {
+		Common::StackLock alLock(_alMutex);
 
-	if (_hasSound)
 		alGetSource3f(channel->source, AL_POSITION, &x, &y, &z);
+	}
 }
 
 void SoundManager::setChannelGain(const ChannelHandle &handle, float gain) {
-	Common::StackLock lock(_mutex);
+	// We need the type gain as well
+	float typeGain = 1.0f;
+	{
+		Common::StackLock lock(_mutex);
+
+		const Channel *channel = getChannel(handle);
+		if (!channel)
+			throw Common::Exception("Invalid channel");
 
-	Channel *channel = getChannel(handle);
+		typeGain = _types[channel->type].gain;
+	}
+
+	ChannelLock lock(*this, handle);
+
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	channel->gain = gain;
 
-	if (_hasSound)
-		alSourcef(channel->source, AL_GAIN, _types[channel->type].gain * gain);
+	if (_hasSound) {
+		Common::StackLock alLock(_alMutex);
+
+		alSourcef(channel->source, AL_GAIN, typeGain * gain);
+	}
 }
 
 void SoundManager::setChannelPitch(const ChannelHandle &handle, float pitch) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
-	if (_hasSound)
+	if (_hasSound) {
+		Common::StackLock alLock(_alMutex);
+
 		alSourcef(channel->source, AL_PITCH, pitch);
+	}
 }
 
 void SoundManager::setChannelRelative(const ChannelHandle &handle, bool relative) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
-	if (_hasSound)
+	if (_hasSound) {
+		Common::StackLock alLock(_alMutex);
+
 		alSourcei(channel->source, AL_SOURCE_RELATIVE, relative ? AL_TRUE : AL_FALSE);
+	}
 }
 
 void SoundManager::setChannelDistance(const ChannelHandle &handle, float minDistance, float maxDistance) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
 	if (_hasSound) {
+		Common::StackLock alLock(_alMutex);
+
 		alSourcef(channel->source, AL_REFERENCE_DISTANCE, minDistance);
 		alSourcef(channel->source, AL_MAX_DISTANCE, maxDistance);
 	}
 }
 
 uint64 SoundManager::getChannelSamplesPlayed(const ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		return 0;
 
+	return getSamplesPlayed(*channel);
+}
+
+uint64 SoundManager::getChannelDurationPlayed(const ChannelHandle &handle) {
+	ChannelLock lock(*this, handle);
+
+	Channel *channel = lock.get();
+	if (!channel || !channel->stream)
+		return 0;
+
+	return (getSamplesPlayed(*channel) * 1000) / channel->stream->getRate();
+}
+
+uint64 SoundManager::getSamplesPlayed(Channel &channel) {
 	// Update the queued/unqueued buffers to make sure the channel is up-to-date
-	bufferData(*channel);
+	bufferData(channel);
 
 	// The position within the currently playing buffer
-	ALint currentPosition;
-	alGetSourcei(channel->source, AL_BYTE_OFFSET, &currentPosition);
+	ALint currentPosition = 0;
+	if (_hasSound) {
+		Common::StackLock alLock(_alMutex);
+
+		alGetSourcei(channel.source, AL_BYTE_OFFSET, &currentPosition);
+	}
 
 	// Total number of bytes processed
-	uint64 byteCount = channel->finishedBuffers + currentPosition;
+	uint64 byteCount = channel.finishedBuffers + currentPosition;
 
 	// Number of 16bit samples per channel
-	return byteCount / channel->stream->getChannels() / 2;
+	return byteCount / channel.stream->getChannels() / 2;
 }
 
-uint64 SoundManager::getChannelDurationPlayed(const ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
+void SoundManager::setTypeGain(SoundType type, float gain) {
+	assert((type >= 0) && (type < kSoundTypeMAX));
 
-	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
-		return 0;
+	std::vector<ChannelHandle> handles;
 
-	return (getChannelSamplesPlayed(handle) * 1000) / channel->stream->getRate();
-}
+	{
+		Common::StackLock lock(_mutex);
 
-void SoundManager::setTypeGain(SoundType type, float gain) {
-	assert((type >= 0) && (type < kSoundTypeMAX));
+		// Set the new type gain
+		_types[type].gain = gain;
 
-	Common::StackLock lock(_mutex);
+		for (TypeList::iterator t = _types[type].list.begin(); t != _types[type].list.end(); ++t) {
+			assert(*t);
 
-	// Set the new type gain
-	_types[type].gain = gain;
+			handles.push_back(getHandle(**t));
+		}
+	}
 
 	// Update all currently playing channels of that type
-	for (TypeList::iterator t = _types[type].list.begin(); t != _types[type].list.end(); ++t) {
-		assert(*t);
+	for (std::vector<ChannelHandle>::const_iterator h = handles.begin(); h != handles.end(); ++h) {
+		ChannelLock lock(*this, *h);
+
+		Channel *channel = lock.get();
+		if (!channel || !_hasSound)
+			continue;
 
-		if (_hasSound)
-			alSourcef((*t)->source, AL_GAIN, (*t)->gain * gain);
+		Common::StackLock alLock(_alMutex);
+
+		alSourcef(channel->source, AL_GAIN, channel->gain * gain);
 	}
 }
 
+byte *SoundManager::getPoolBuffer() {
+	Common::StackLock lock(_bufferPoolMutex);
+
+	if (_bufferPool.empty())
+		return new byte[kOpenALBufferSize];
+
+	// Take the buffer out of the pool, without deleting it
+	byte *buffer = _bufferPool.back();
+	_bufferPool.back() = 0;
+	_bufferPool.pop_back();
+
+	return buffer;
+}
+
+void SoundManager::returnPoolBuffer(byte *buffer) {
+	Common::StackLock lock(_bufferPoolMutex);
+
+	_bufferPool.push_back(buffer);
+}
+
 bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
-                              AudioStream *stream, ALsizei &bufferedSize) const {
+                              AudioStream *stream, ALsizei &bufferedSize) {
 
 	bufferedSize = 0;
 
@@ -698,17 +981,26 @@ bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
 	// Read in the required amount of samples
 	size_t numSamples = kOpenALBufferSize / 2;
 
-	Common::ScopedArray<byte> buffer(new byte[kOpenALBufferSize]);
-	std::memset(buffer.get(), 0, kOpenALBufferSize);
+	byte *buffer = getPoolBuffer();
+	BOOST_SCOPE_EXIT ( (&buffer) (this_) ) {
+		this_->returnPoolBuffer(buffer);
+	} BOOST_SCOPE_EXIT_END
 
-	numSamples = stream->readBuffer(reinterpret_cast<int16 *>(buffer.get()), numSamples);
+	numSamples = stream->readBuffer(reinterpret_cast<int16 *>(buffer), numSamples);
 	if (numSamples == AudioStream::kSizeInvalid) {
 		warning("Failed reading from stream while filling buffer in %s", formatChannel(&channel).c_str());
 		return false;
 	}
 
+	// No data ready yet
+	if (numSamples == 0)
+		return false;
+
 	bufferedSize = numSamples * 2;
-	alBufferData(alBuffer, format, buffer.get(), bufferedSize, stream->getRate());
+
+	Common::StackLock alLock(_alMutex);
+
+	alBufferData(alBuffer, format, buffer, bufferedSize, stream->getRate());
 
 	ALenum error = alGetError();
 	if (error != AL_NO_ERROR) {
@@ -719,13 +1011,6 @@ bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
 	return true;
 }
 
-void SoundManager::bufferData(size_t channel) {
-	if ((channel >= kChannelCount) || !_channels[channel])
-		return;
-
-	bufferData(*_channels[channel]);
-}
-
 void SoundManager::bufferData(Channel &channel) {
 	if (!channel.stream)
 		return;
@@ -735,25 +1020,30 @@ void SoundManager::bufferData(Channel &channel) {
 
 	ALenum error = AL_NO_ERROR;
 
-	// Get the number of buffers that have been processed
 	ALint buffersProcessed = -1;
-	alGetSourcei(channel.source, AL_BUFFERS_PROCESSED, &buffersProcessed);
-	if ((error = alGetError()) != AL_NO_ERROR)
-		throw Common::Exception("OpenAL error while getting processed buffers in %s: 0x%X",
-		                        formatChannel(&channel).c_str(), error);
+	ALuint freeBuffers[kOpenALBufferCount];
 
-	assert(buffersProcessed >= 0);
+	{
+		Common::StackLock alLock(_alMutex);
 
-	if ((size_t)buffersProcessed > kOpenALBufferCount)
-		throw Common::Exception("Got more processed buffers than total source buffers in %s?!?",
-		                        formatChannel(&channel).c_str());
+		// Get the number of buffers that have been processed
+		alGetSourcei(channel.source, AL_BUFFERS_PROCESSED, &buffersProcessed);
+		if ((error = alGetError()) != AL_NO_ERROR)
+			throw Common::Exception("OpenAL error while getting processed buffers in %s: 0x%X",
+			                        formatChannel(&channel).c_str(), error);
 
-	// Unqueue the processed buffers
-	ALuint freeBuffers[kOpenALBufferCount];
-	alSourceUnqueueBuffers(channel.source, buffersProcessed, freeBuffers);
-	if ((error = alGetError()) != AL_NO_ERROR)
-		throw Common::Exception("OpenAL error while unqueueing buffers in %s: 0x%X",
-		                        formatChannel(&channel).c_str(), error);
+		assert(buffersProcessed >= 0);
+
+		if ((size_t)buffersProcessed > kOpenALBufferCount)
+			throw Common::Exception("Got more processed buffers than total source buffers in %s?!?",
+			                        formatChannel(&channel).c_str());
+
+		// Unqueue the processed buffers
+		alSourceUnqueueBuffers(channel.source, buffersProcessed, freeBuffers);
+		if ((error = alGetError()) != AL_NO_ERROR)
+			throw Common::Exception("OpenAL error while unqueueing buffers in %s: 0x%X",
+			                        formatChannel(&channel).c_str(), error);
+	}
 
 	// Put them into the free buffers list
 	for (size_t i = 0; i < (size_t)buffersProcessed; i++) {
@@ -768,6 +1058,8 @@ void SoundManager::bufferData(Channel &channel) {
 		if (!fillBuffer(channel, *buffer, channel.stream.get(), channel.bufferSize[*buffer]))
 			break;
 
+		Common::StackLock alLock(_alMutex);
+
 		alSourceQueueBuffers(channel.source, 1, &*buffer);
 		if ((error = alGetError()) != AL_NO_ERROR)
 			throw Common::Exception("OpenAL error while queueing buffers in %s: 0x%X",
@@ -783,41 +1075,63 @@ void SoundManager::checkReady() {
 }
 
 void SoundManager::update() {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_mutex);
 
-	size_t channelCount = 0;
-	for (size_t i = 0; i < kChannelCount; i++) {
-		if (!_channels[i])
-			continue;
+		// We're not looking at the channels freed since the last update anymore
+		deleteFreedChannels();
+
+		const std::vector<size_t> &used = _slots.getUsed();
+
+		_updateChannels.clear();
+		for (std::vector<size_t>::const_iterator c = used.begin(); c != used.end(); ++c)
+			_updateChannels.push_back(_channels[*c].get());
+	}
+
+	/* Only lock one channel at a time while buffering, so that the game
+	 * can keep on using all the other channels in the meantime. Freeing
+	 * a channel waits for its lock, and then removes its stream. */
 
-		channelCount++;
+	std::vector<Channel *> finished;
+	for (std::vector<Channel *>::iterator c = _updateChannels.begin(); c != _updateChannels.end(); ++c) {
+		Common::StackLock channelLock((*c)->mutex);
+
+		if (!(*c)->stream)
+			continue;
 
 		// Free the channel if it is no longer playing
-		if (!isPlaying(i)) {
-			freeChannel(i);
+		if (!isPlaying(**c)) {
+			finished.push_back(*c);
 			continue;
 		}
 
 		// Try to buffer some more data
-		bufferData(i);
+		bufferData(**c);
 	}
 
-	debugC(Common::kDebugSound, 9, "Active sound channel: %s", Common::composeString(channelCount).c_str());
-}
+	if (!finished.empty()) {
+		std::vector<Channel *> freed;
 
-ChannelHandle SoundManager::newChannel() {
-	size_t foundChannel = kChannelInvalid;
+		{
+			Common::StackLock lock(_mutex);
+
+			for (std::vector<Channel *>::iterator c = finished.begin(); c != finished.end(); ++c)
+				if (_channels[(*c)->index].get() == *c)
+					freed.push_back(detachChannel((*c)->index));
+		}
 
-	for (size_t i = 0; (i < kChannelCount) && (foundChannel == kChannelInvalid); i++)
-		if (!_channels[i])
-			foundChannel = i;
+		for (std::vector<Channel *>::iterator c = freed.begin(); c != freed.end(); ++c)
+			discardChannel(*c);
+	}
 
-	if (foundChannel == kChannelInvalid)
-		throw Common::Exception("All sound channels occupied");
+	debugC(Common::kDebugSound, 9, "Active sound channel: %s",
+	       Common::composeString(_updateChannels.size()).c_str());
+}
 
+ChannelHandle SoundManager::newChannel() {
 	ChannelHandle handle;
 
-	handle.channel = foundChannel;
+	handle.channel = _slots.allocate();
 	handle.id      = _curID++;
 
 	// ID 0 is reserved for "invalid ID"
@@ -834,6 +1148,8 @@ void SoundManager::pauseChannel(Channel *channel, bool pause) {
 	ALenum error = AL_NO_ERROR;
 	if (pause) {
 		if (_hasSound) {
+			Common::StackLock alLock(_alMutex);
+
 			alSourcePause(channel->source);
 			if ((error = alGetError()) != AL_NO_ERROR)
 				warning("OpenAL error while attempting to pause channel %s: 0x%X",
@@ -858,44 +1174,99 @@ void SoundManager::pauseChannel(Channel *channel) {
 }
 
 void SoundManager::freeChannel(ChannelHandle &handle) {
-	if ((handle.channel < kChannelCount) && (handle.id != 0) && _channels[handle.channel])
-		// Only free if there is a channel to free
-		if (handle.id == _channels[handle.channel]->id)
-			// Only free if the IDs match
-			freeChannel(handle.channel);
+	Channel *channel = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		// Only free if there is a channel to free, and the IDs match
+		if (isValidChannel(handle))
+			channel = detachChannel(handle.channel);
+	}
+
+	discardChannel(channel);
 
 	handle.channel = kChannelInvalid;
 	handle.id      = 0;
 }
 
-void SoundManager::freeChannel(size_t channel) {
+SoundManager::Channel *SoundManager::detachChannel(size_t channel) {
 	if (channel >= kChannelCount)
-		return;
+		return 0;
 
 	Channel *c = _channels[channel].get();
 	if (!c)
 		// Nothing to do
+		return 0;
+
+	// Remove the channel from the type list
+	if (c->typeIt != _types[c->type].list.end())
+		_types[c->type].list.erase(c->typeIt);
+
+	c->typeIt = _types[c->type].list.end();
+
+	_slots.free(channel);
+
+	// Keep the channel alive until discardChannel() is done with it
+	c->lockers++;
+
+	/* The sound thread or a ChannelLock might still hold a pointer to the
+	 * channel, so it's only deleted once nobody is waiting for it anymore. */
+	_freedChannels.push_back(_channels[channel].release());
+
+	return c;
+}
+
+void SoundManager::discardChannel(Channel *channel) {
+	if (!channel)
 		return;
 
-	// Discard the stream
-	c->stream.reset();
+	{
+		Common::StackLock channelLock(channel->mutex);
 
-	if (_hasSound) {
-		// Delete the channel's OpenAL source
-		if (c->source)
-			alDeleteSources(1, &c->source);
+		// Mark the channel as freed for anybody still waiting for its lock
+		channel->id = 0;
+
+		// Discard the stream
+		channel->stream.reset();
+
+		if (_hasSound) {
+			Common::StackLock alLock(_alMutex);
 
-		// Delete the OpenAL buffers
-		for (std::list<ALuint>::iterator buffer = c->buffers.begin(); buffer != c->buffers.end(); ++buffer)
-			alDeleteBuffers(1, &*buffer);
+			// Delete the channel's OpenAL source
+			if (channel->source)
+				alDeleteSources(1, &channel->source);
+
+			// Delete the OpenAL buffers
+			for (std::list<ALuint>::iterator buffer = channel->buffers.begin(); buffer != channel->buffers.end(); ++buffer)
+				alDeleteBuffers(1, &*buffer);
+		}
+
+		channel->source = 0;
+		channel->buffers.clear();
+		channel->freeBuffers.clear();
 	}
 
-	// Remove the channel from the type list
-	if (c->typeIt != _types[c->type].list.end())
-		_types[c->type].list.erase(c->typeIt);
+	channel->lockers--;
+}
 
-	// And finally delete the channel itself
-	_channels[channel].reset();
+void SoundManager::deleteFreedChannels() {
+	for (size_t i = 0; i < _freedChannels.size(); ) {
+		if (_freedChannels[i]->lockers.load() == 0) {
+			std::swap(_freedChannels[i], _freedChannels.back());
+			_freedChannels.pop_back();
+		} else
+			i++;
+	}
+}
+
+ChannelHandle SoundManager::getHandle(const Channel &channel) {
+	ChannelHandle handle;
+
+	handle.channel = channel.index;
+	handle.id      = channel.id;
+
+	return handle;
 }
 
 void SoundManager::threadMethod() {
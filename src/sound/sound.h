@@ -36,10 +36,17 @@
 #endif
 
 #include <list>
+#include <vector>
 #include <map>
 
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
+
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/deallocator.h"
 #include "src/common/disposableptr.h"
 #include "src/common/singleton.h"
 #include "src/common/thread.h"
@@ -47,9 +54,12 @@
 #include "src/common/ustring.h"
 
 #include "src/sound/types.h"
+#include "src/sound/pcmcache.h"
+#include "src/sound/channelslots.h"
 
 namespace Common {
 	class SeekableReadStream;
+	class ThreadPool;
 }
 
 namespace Sound {
@@ -99,10 +109,13 @@ public:
 	 *  @param  wavStream The stream to play. Will be taken over.
 	 *  @param  type The type of the sound.
 	 *  @param  loop Should the sound loop?
+	 *  @param  cacheName If not empty, a short sound is decoded completely in the
+	 *                    background, and put into the sound cache under this name.
 	 *  @return The channel the sound has been assigned to, or -1 on error.
 	 */
 	ChannelHandle playSoundFile(Common::SeekableReadStream *wavStream,
-	                            SoundType type, bool loop = false);
+	                            SoundType type, bool loop = false,
+	                            const Common::UString &cacheName = "");
 
 	/** Play an audio stream.
 	 *
@@ -118,6 +131,34 @@ public:
 	                              SoundType type, bool disposeAfterUse = true);
 	// '---
 
+	// .--- Sound cache
+	/** Play a sound out of the sound cache.
+	 *
+	 *  Like playSoundFile(), this only allocates a channel for the sound.
+	 *
+	 *  @param  name The name the sound was cached under.
+	 *  @param  type The type of the sound.
+	 *  @param  loop Should the sound loop?
+	 *  @return The channel the sound has been assigned to, or an invalid
+	 *          handle if the sound is not in the cache.
+	 */
+	ChannelHandle playCachedSound(const Common::UString &name, SoundType type, bool loop = false);
+
+	/** Decode a sound file completely and put it into the sound cache.
+	 *
+	 *  @param  name The name to cache the sound under.
+	 *  @param  wavStream The sound file. Will be taken over.
+	 *  @return true if the sound is now in the cache, false if it's too long.
+	 */
+	bool cacheSoundFile(const Common::UString &name, Common::SeekableReadStream *wavStream);
+
+	/** Is this sound in the sound cache? */
+	bool isSoundCached(const Common::UString &name) const;
+
+	/** Remove all sounds from the sound cache. */
+	void clearSoundCache();
+	// '---
+
 	// .--- Starting/Pausing/Stopping channels
 	/** Start the channel. */
 	void startChannel(ChannelHandle &handle);
@@ -200,9 +241,15 @@ private:
 
 	/** A sound channel. */
 	struct Channel {
-		uint32 id;    ///< The channel's ID.
+		uint32 id;    ///< The channel's ID, 0 once the channel has been freed.
 		size_t index; ///< The channel's index.
 
+		/** Protects the channel's state, stream and OpenAL objects. */
+		Common::Mutex mutex;
+
+		/** Number of threads that found this channel, but might not have locked it yet. */
+		boost::atomic<uint32> lockers;
+
 		ALint state; ///< The sound's state.
 
 		Common::DisposablePtr<AudioStream> stream;  ///< The actual audio stream.
@@ -225,6 +272,19 @@ private:
 		Channel(uint32 i, size_t idx, SoundType t, const TypeList::iterator &ti, AudioStream *s, bool d);
 	};
 
+	/** Look up the channel a handle refers to, and hold its lock while in scope. */
+	class ChannelLock : boost::noncopyable {
+	public:
+		ChannelLock(SoundManager &manager, const ChannelHandle &handle);
+		~ChannelLock();
+
+		/** Return the locked channel, or 0 if the handle is invalid. */
+		Channel *get() const;
+
+	private:
+		Channel *_channel;
+	};
+
 	bool _ready; ///< Was the sound subsystem successfully initialized?
 
 	bool _hasSound; ///< Do we have working sound output?
@@ -235,10 +295,43 @@ private:
 	Common::ScopedPtr<Channel> _channels[kChannelCount]; ///< The sound channels.
 	Type _types[kSoundTypeMAX]; ///< The sound types.
 
+	ChannelSlots _slots; ///< Which channels are in use.
+
+	/** Freed channels the sound thread or a ChannelLock might still be looking at.
+	 *
+	 *  They're deleted at the start of the next update nobody locks them in,
+	 *  or, without a sound thread, when the next channel is created.
+	 */
+	Common::PtrVector<Channel> _freedChannels;
+
+	std::vector<Channel *> _updateChannels; ///< The channels the current update is looking at.
+
 	uint32 _curID; ///< The ID the next sound will get.
 
+	/** Protects the channel list and the sound types.
+	 *
+	 *  When also locking a channel, this mutex has to be locked first.
+	 */
 	Common::Mutex _mutex;
 
+	/** Protects the OpenAL context.
+	 *
+	 *  OpenAL only keeps one error state for the whole context, so every
+	 *  OpenAL call has to be made together with its error check while
+	 *  holding this mutex. No other mutex may be locked while holding it.
+	 */
+	mutable Common::Mutex _alMutex;
+
+	/** The threads decoding the channels' streams ahead of time. */
+	Common::ScopedPtr<Common::ThreadPool> _decodePool;
+
+	/** Short sounds, kept completely decoded. */
+	PCMCache _pcmCache;
+
+	/** Buffers to read sound data into, before handing them to OpenAL. */
+	Common::PtrVector<byte, Common::DeallocatorArray> _bufferPool;
+	Common::Mutex _bufferPoolMutex;
+
 	/** Condition to signal that an update is needed. */
 	Common::Condition _needUpdate;
 
@@ -254,23 +347,41 @@ private:
 	/** Look for a free place in the channel vector. */
 	ChannelHandle newChannel();
 
+	/** Create a channel playing this audio stream. */
+	ChannelHandle createChannel(AudioStream *audStream, SoundType type, bool disposeAfterUse);
+
 	/** Buffer more sound from the channel to the OpenAL buffers. */
 	void bufferData(Channel &channel);
-	/** Buffer more sound from the channel to the OpenAL buffers. */
-	void bufferData(size_t channel);
 
 	/** Is that channel currently playing a sound? */
-	bool isPlaying(size_t channel) const;
+	bool isPlaying(Channel &channel) const;
+
+	/** Return the number of samples this channel has already played. */
+	uint64 getSamplesPlayed(Channel &channel);
 
 	/** Pause/Unpause a channel. */
 	void pauseChannel(Channel *channel, bool pause);
 	/** Pause toggle channel. */
 	void pauseChannel(Channel *channe);
 
+	/** Decode a sound file into the sound cache. Runs on the decoding threads. */
+	void cacheSound(const Common::UString &name, boost::shared_ptr< std::vector<byte> > data);
+
 	/** Stop and free a channel. */
 	void freeChannel(ChannelHandle &handle);
-	/** Stop and free a channel. */
-	void freeChannel(size_t channel);
+
+	/** Take a channel out of use, without waiting for its lock. Needs the global mutex.
+	 *
+	 *  The channel is kept alive until it was stopped with discardChannel().
+	 */
+	Channel *detachChannel(size_t channel);
+	/** Stop a detached channel. Waits for its lock, so don't hold the global mutex. */
+	void discardChannel(Channel *channel);
+	/** Delete all freed channels nobody is waiting for anymore. Needs the global mutex. */
+	void deleteFreedChannels();
+
+	/** Return a handle to this channel. */
+	static ChannelHandle getHandle(const Channel &channel);
 
 	/** Return the channel the handle refers to. */
 	const Channel *getChannel(const ChannelHandle &handle) const;
@@ -281,7 +392,12 @@ private:
 
 	/** Fill the buffer with data from the audio stream. */
 	bool fillBuffer(const Channel &channel, ALuint alBuffer,
-	                AudioStream *stream, ALsizei &bufferedSize) const;
+	                AudioStream *stream, ALsizei &bufferedSize);
+
+	/** Take a buffer out of the pool, or create a new one. */
+	byte *getPoolBuffer();
+	/** Return a buffer to the pool. */
+	void returnPoolBuffer(byte *buffer);
 
 	/** Return a string representing this channel. */
 	Common::UString formatChannel(const Channel *channel) const;
@@ -76,13 +76,12 @@
 #include "src/common/types.h"
 #include "src/common/rational.h"
 #include "src/common/scopedptr.h"
+#include "src/common/bitstream.h"
 
 #include "src/video/decoder.h"
 
 namespace Common {
 	class SeekableReadStream;
-	class BitStream;
-	class Huffman;
 
 	class RDFT;
 	class DCT;
@@ -94,6 +93,8 @@ namespace Sound {
 
 namespace Video {
 
+class BinkVideoCodec;
+
 /** A decoder for RAD Game Tools' Bink videos. */
 class Bink : public VideoDecoder {
 public:
@@ -156,10 +157,7 @@ private:
 		uint32 offset;
 		uint32 size;
 
-		Common::BitStream *bits;
-
 		VideoFrame();
-		~VideoFrame();
 	};
 
 	Common::ScopedPtr<Common::SeekableReadStream> _bink;
@@ -175,6 +173,7 @@ private:
 	class BinkVideoTrack : public FixedRateVideoTrack {
 	public:
 		BinkVideoTrack(uint32 width, uint32 height, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id);
+		~BinkVideoTrack();
 
 		uint32 getWidth() const { return _width; }
 		uint32 getHeight() const { return _height; }
@@ -182,88 +181,14 @@ private:
 		int getFrameCount() const { return _frameCount; }
 
 		/** Decode a video packet. */
-		void decodePacket(Graphics::Surface &surface, VideoFrame &frame);
+		void decodePacket(Graphics::Surface &surface, Common::SeekableReadStream &packet);
 
 	protected:
 		Common::Rational getFrameRate() const { return _frameRate; }
 
 	private:
-		/** A decoder state. */
-		struct DecodeContext {
-			VideoFrame *video;
-
-			uint32 planeIdx;
-
-			uint32 blockX;
-			uint32 blockY;
-
-			byte *dest;
-			byte *prev;
-
-			byte *destStart, *destEnd;
-			byte *prevStart, *prevEnd;
-
-			uint32 pitch;
-
-			int coordMap[64];
-			int coordScaledMap1[64];
-			int coordScaledMap2[64];
-			int coordScaledMap3[64];
-			int coordScaledMap4[64];
-		};
-
-		/** IDs for different data types used in Bink video codec. */
-		enum Source {
-			kSourceBlockTypes    = 0, ///< 8x8 block types.
-			kSourceSubBlockTypes    , ///< 16x16 block types (a subset of 8x8 block types).
-			kSourceColors           , ///< Pixel values used for different block types.
-			kSourcePattern          , ///< 8-bit values for 2-color pattern fill.
-			kSourceXOff             , ///< X components of motion value.
-			kSourceYOff             , ///< Y components of motion value.
-			kSourceIntraDC          , ///< DC values for intrablocks with DCT.
-			kSourceInterDC          , ///< DC values for interblocks with DCT.
-			kSourceRun              , ///< Run lengths for special fill block.
-
-			kSourceMAX
-		};
-
-		/** Bink video block types. */
-		enum BlockType {
-			kBlockSkip    = 0,  ///< Skipped block.
-			kBlockScaled     ,  ///< Block has size 16x16.
-			kBlockMotion     ,  ///< Block is copied from previous frame with some offset.
-			kBlockRun        ,  ///< Block is composed from runs of colors with custom scan order.
-			kBlockResidue    ,  ///< Motion block with some difference added.
-			kBlockIntra      ,  ///< Intra DCT block.
-			kBlockFill       ,  ///< Block is filled with single color.
-			kBlockInter      ,  ///< Motion block with DCT applied to the difference.
-			kBlockPattern    ,  ///< Block is filled with two colors following custom pattern.
-			kBlockRaw           ///< Uncoded 8x8 block.
-		};
-
-		/** Data structure for decoding and translating Huffman'd data. */
-		struct Huffman {
-			int  index;       ///< Index of the Huffman codebook to use.
-			byte symbols[16]; ///< Huffman symbol => Bink symbol translation list.
-
-			Huffman();
-		};
-
-		/** Data structure used for decoding a single Bink data type. */
-		struct Bundle {
-			int countLengths[2]; ///< Lengths of number of entries to decode (in bits).
-			int countLength;     ///< Length of number of entries to decode (in bits) for the current plane.
-
-			Huffman huffman; ///< Huffman codebook.
-
-			Common::ScopedArray<byte> data; ///< Buffer for decoded symbols.
-
-			byte *dataEnd; ///< Pointer to the data end end.
-			byte *curDec;  ///< Pointer to the data that wasn't yet decoded.
-			byte *curPtr;  ///< Pointer to the data that wasn't yet read.
-
-			Bundle();
-		};
+		/** The number of extra threads decoding parts of a frame in parallel. */
+		static const size_t kDecodeThreadCount = 2;
 
 		uint32 _width;
 		uint32 _height;
@@ -273,83 +198,7 @@ private:
 
 		Common::Rational _frameRate; ///< The frame rate of the video.
 
-		bool _swapPlanes; ///< Are the planes ordered (A)YVU instead of (A)YUV?
-		bool _hasAlpha;   ///< Do video frames have alpha?
-
-		uint32 _id; ///< The BIK FourCC.
-
-		Bundle _bundles[kSourceMAX]; ///< Bundles for decoding all data types.
-
-		Common::ScopedPtr<Common::Huffman> _huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
-
-		/** Huffman codebooks to use for decoding high nibbles in color data types. */
-		Huffman _colHighHuffman[16];
-		/** Value of the last decoded high nibble in color data types. */
-		int _colLastVal;
-
-		Common::ScopedArray<byte> _curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
-		Common::ScopedArray<byte> _oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
-
-		/** Initialize the bundles. */
-		void initBundles();
-
-		/** Initialize the Huffman decoders. */
-		void initHuffman();
-
-		/** Decode a video packet. */
-		void videoPacket(VideoFrame &video);
-
-		/** Decode a plane. */
-		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
-
-		/** Read/Initialize a bundle for decoding a plane. */
-		void readBundle(VideoFrame &video, Source source);
-
-		/** Read the symbols for a Huffman code. */
-		void readHuffman(VideoFrame &video, Huffman &huffman);
-		/** Merge two Huffman symbol lists. */
-		void mergeHuffmanSymbols(VideoFrame &video, byte *dst, const byte *src, int size);
-
-		/** Read and translate a symbol out of a Huffman code. */
-		byte getHuffmanSymbol(VideoFrame &video, Huffman &huffman);
-
-		/** Get a direct value out of a bundle. */
-		int32 getBundleValue(Source source);
-		/** Read a count value out of a bundle. */
-		uint32 readBundleCount(VideoFrame &video, Bundle &bundle);
-
-		// Handle the block types
-		void blockSkip         (DecodeContext &ctx);
-		void blockScaledSkip   (DecodeContext &ctx);
-		void blockScaledRun    (DecodeContext &ctx);
-		void blockScaledIntra  (DecodeContext &ctx);
-		void blockScaledFill   (DecodeContext &ctx);
-		void blockScaledPattern(DecodeContext &ctx);
-		void blockScaledRaw    (DecodeContext &ctx);
-		void blockScaled       (DecodeContext &ctx);
-		void blockMotion       (DecodeContext &ctx);
-		void blockRun          (DecodeContext &ctx);
-		void blockResidue      (DecodeContext &ctx);
-		void blockIntra        (DecodeContext &ctx);
-		void blockFill         (DecodeContext &ctx);
-		void blockInter        (DecodeContext &ctx);
-		void blockPattern      (DecodeContext &ctx);
-		void blockRaw          (DecodeContext &ctx);
-
-		// Read the bundles
-		void readRuns        (VideoFrame &video, Bundle &bundle);
-		void readMotionValues(VideoFrame &video, Bundle &bundle);
-		void readBlockTypes  (VideoFrame &video, Bundle &bundle);
-		void readPatterns    (VideoFrame &video, Bundle &bundle);
-		void readColors      (VideoFrame &video, Bundle &bundle);
-		void readDCS         (VideoFrame &video, Bundle &bundle, int startBits, bool hasSign);
-		void readDCTCoeffs   (VideoFrame &video, int16 *block, bool isIntra);
-		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
-
-		// Bink video IDCT
-		void IDCT(int16 *block);
-		void IDCTPut(DecodeContext &ctx, int16 *block);
-		void IDCTAdd(DecodeContext &ctx, int16 *block);
+		Common::ScopedPtr<BinkVideoCodec> _codec;
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -372,16 +221,16 @@ private:
 		uint32 _curFrame;
 		Common::Timestamp _audioBuffered;
 
-		float getFloat(Common::BitStream &bits);
+		float getFloat(Common::MemoryBitStream32LELSB &bits);
 
 		/** Decode an audio block. */
-		void audioBlock(Common::BitStream &bits, int16 *out);
+		void audioBlock(Common::MemoryBitStream32LELSB &bits, int16 *out);
 		/** Decode a DCT'd audio block. */
-		void audioBlockDCT(Common::BitStream &bits);
+		void audioBlockDCT(Common::MemoryBitStream32LELSB &bits);
 		/** Decode a RDFT'd audio block. */
-		void audioBlockRDFT(Common::BitStream &bits);
+		void audioBlockRDFT(Common::MemoryBitStream32LELSB &bits);
 
-		void readAudioCoeffs(Common::BitStream &bits, float *coeffs);
+		void readAudioCoeffs(Common::MemoryBitStream32LELSB &bits, float *coeffs);
 
 		static void floatToInt16Interleave(int16 *dst, const float **src, uint32 length, uint8 channels);
 	};
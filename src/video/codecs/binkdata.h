@@ -68,8 +68,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
-#ifndef VIDEO_BINKDATA_H
-#define VIDEO_BINKDATA_H
+#ifndef VIDEO_CODECS_BINKDATA_H
+#define VIDEO_CODECS_BINKDATA_H
 
 #include "src/common/types.h"
 
@@ -619,4 +619,4 @@ static const uint32 binkInterQuant[16][64] = {
 },
 };
 
-#endif // VIDEO_BINKDATA_H
+#endif // VIDEO_CODECS_BINKDATA_H
@@ -0,0 +1,358 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The inverse discrete cosine transform of RAD Game Tools' Bink videos.
+ */
+
+/* Based on the Bink implementation in FFmpeg (<https://ffmpeg.org/)>,
+ * which is released under the terms of version 2 or later of the GNU
+ * Lesser General Public License.
+ *
+ * The original copyright notes in the files
+ * - libavcodec/binkdsp.c
+ * - libavcodec/binkdsp.h
+ * read as follows:
+ *
+ * Bink DSP routines
+ * Copyright (c) 2009 Konstantin Shishkov
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "src/common/util.h"
+
+#include "src/video/codecs/binkdsp.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define BINKDSP_HAVE_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+namespace Video {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+    const int a0 = (src)[s0] + (src)[s4]; \
+    const int a1 = (src)[s0] - (src)[s4]; \
+    const int a2 = (src)[s2] + (src)[s6]; \
+    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+    const int a4 = (src)[s5] + (src)[s3]; \
+    const int a5 = (src)[s5] - (src)[s3]; \
+    const int a6 = (src)[s1] + (src)[s7]; \
+    const int a7 = (src)[s1] - (src)[s7]; \
+    const int b0 = a4 + a6; \
+    const int b1 = (A3*(a5 + a7)) >> 11; \
+    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+    (dest)[d0] = munge(a0+a2   +b0); \
+    (dest)[d1] = munge(a1+a3-a2+b2); \
+    (dest)[d2] = munge(a1-a3+a2+b3); \
+    (dest)[d3] = munge(a0-a2   -b4); \
+    (dest)[d4] = munge(a0-a2   +b4); \
+    (dest)[d5] = munge(a1-a3+a2-b3); \
+    (dest)[d6] = munge(a1+a3-a2-b2); \
+    (dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int16 *dest, const int16 *src)
+{
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+static void IDCTScalar(int16 *block) {
+	int i;
+	int16 temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+static void IDCTPutScalar(byte *dest, uint32 pitch, const int16 *block) {
+	int i;
+	int16 temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+static void IDCTAddScalar(byte *dest, uint32 pitch, int16 *block) {
+	int i, j;
+
+	IDCTScalar(block);
+	for (i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (j = 0; j < 8; j++)
+			 dest[j] += block[j];
+}
+
+#ifdef BINKDSP_HAVE_SSE2
+/* The SSE2 kernels run the same transform over all eight columns (or rows)
+ * at once. Every product of IDCT_TRANSFORM is a difference or sum of two
+ * 16-bit inputs times a constant, so _mm_madd_epi16() can calculate it with
+ * the exact 32-bit results of the scalar code. Values are narrowed back down
+ * by truncation, just like the scalar code storing them into int16 and byte. */
+
+static inline __m128i pairConstant(int16 a, int16 b) {
+	return _mm_setr_epi16(a, b, a, b, a, b, a, b);
+}
+
+/** Sign-extend the lower or upper four 16-bit values to 32 bits. */
+template<bool high>
+static inline __m128i widen(__m128i x) {
+	return _mm_srai_epi32(high ? _mm_unpackhi_epi16(x, x) : _mm_unpacklo_epi16(x, x), 16);
+}
+
+/** Interleave the lower or upper four 16-bit values of two vectors. */
+template<bool high>
+static inline __m128i interleave(__m128i x, __m128i y) {
+	return high ? _mm_unpackhi_epi16(x, y) : _mm_unpacklo_epi16(x, y);
+}
+
+/** Transform four of the eight lanes of s[0] to s[7], into 32-bit values. */
+template<bool high>
+static inline void transformSSE2(const __m128i *s, __m128i *d) {
+	const __m128i s0 = widen<high>(s[0]), s1 = widen<high>(s[1]), s2 = widen<high>(s[2]), s3 = widen<high>(s[3]);
+	const __m128i s4 = widen<high>(s[4]), s5 = widen<high>(s[5]), s6 = widen<high>(s[6]), s7 = widen<high>(s[7]);
+
+	const __m128i p26 = interleave<high>(s[2], s[6]);
+	const __m128i p53 = interleave<high>(s[5], s[3]);
+	const __m128i p17 = interleave<high>(s[1], s[7]);
+
+	const __m128i a0 = _mm_add_epi32(s0, s4);
+	const __m128i a1 = _mm_sub_epi32(s0, s4);
+	const __m128i a2 = _mm_add_epi32(s2, s6);
+	const __m128i a3 = _mm_srai_epi32(_mm_madd_epi16(p26, pairConstant(A1, -A1)), 11);
+	const __m128i a4 = _mm_add_epi32(s5, s3);
+	const __m128i a6 = _mm_add_epi32(s1, s7);
+
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(p53, pairConstant(A3, -A3)),
+	                                                _mm_madd_epi16(p17, pairConstant(A3, -A3))), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(_mm_madd_epi16(p53, pairConstant(A4, -A4)), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(p17, pairConstant( A1,  A1)),
+	                                                              _mm_madd_epi16(p53, pairConstant(-A1, -A1))), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_madd_epi16(p17, pairConstant(A2, -A2)), 11), b3), b1);
+
+	const __m128i a02p = _mm_add_epi32(a0, a2);
+	const __m128i a02m = _mm_sub_epi32(a0, a2);
+	const __m128i a13m = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i a13p = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+
+	d[0] = _mm_add_epi32(a02p, b0);
+	d[1] = _mm_add_epi32(a13m, b2);
+	d[2] = _mm_add_epi32(a13p, b3);
+	d[3] = _mm_sub_epi32(a02m, b4);
+	d[4] = _mm_add_epi32(a02m, b4);
+	d[5] = _mm_sub_epi32(a13p, b3);
+	d[6] = _mm_sub_epi32(a13m, b2);
+	d[7] = _mm_sub_epi32(a02p, b0);
+}
+
+/** Truncate two vectors of 32-bit values to one vector of 16-bit values. */
+static inline __m128i truncate16(__m128i lo, __m128i hi) {
+	return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+}
+
+static inline void transpose8x8(__m128i *r) {
+	const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]), a1 = _mm_unpackhi_epi16(r[0], r[1]);
+	const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]), a3 = _mm_unpackhi_epi16(r[2], r[3]);
+	const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]), a5 = _mm_unpackhi_epi16(r[4], r[5]);
+	const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]), a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+	const __m128i b0 = _mm_unpacklo_epi32(a0, a2), b1 = _mm_unpackhi_epi32(a0, a2);
+	const __m128i b2 = _mm_unpacklo_epi32(a1, a3), b3 = _mm_unpackhi_epi32(a1, a3);
+	const __m128i b4 = _mm_unpacklo_epi32(a4, a6), b5 = _mm_unpackhi_epi32(a4, a6);
+	const __m128i b6 = _mm_unpacklo_epi32(a5, a7), b7 = _mm_unpackhi_epi32(a5, a7);
+
+	r[0] = _mm_unpacklo_epi64(b0, b4); r[1] = _mm_unpackhi_epi64(b0, b4);
+	r[2] = _mm_unpacklo_epi64(b1, b5); r[3] = _mm_unpackhi_epi64(b1, b5);
+	r[4] = _mm_unpacklo_epi64(b2, b6); r[5] = _mm_unpackhi_epi64(b2, b6);
+	r[6] = _mm_unpacklo_epi64(b3, b7); r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+/** Run both IDCT passes. Returns the unnarrowed results, with the
+ *  rows of the block in the lanes and the columns in the vectors. */
+static inline void IDCTSSE2(const int16 *block, __m128i *lo, __m128i *hi) {
+	__m128i r[8];
+	for (int i = 0; i < 8; i++)
+		r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 8 * i));
+
+	// Columns. There's no shortcut for all-zero ACs, it gives the same results anyway
+	transformSSE2<false>(r, lo);
+	transformSSE2<true >(r, hi);
+
+	for (int i = 0; i < 8; i++)
+		r[i] = truncate16(lo[i], hi[i]);
+
+	// Rows
+	transpose8x8(r);
+
+	transformSSE2<false>(r, lo);
+	transformSSE2<true >(r, hi);
+
+	const __m128i round = _mm_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i++) {
+		lo[i] = _mm_srai_epi32(_mm_add_epi32(lo[i], round), 8);
+		hi[i] = _mm_srai_epi32(_mm_add_epi32(hi[i], round), 8);
+	}
+}
+
+/** Run the IDCT and return the rows of the block, truncated to 16 bits. */
+static inline void IDCTRowsSSE2(const int16 *block, __m128i *r) {
+	__m128i lo[8], hi[8];
+	IDCTSSE2(block, lo, hi);
+
+	for (int i = 0; i < 8; i++)
+		r[i] = truncate16(lo[i], hi[i]);
+
+	transpose8x8(r);
+}
+
+static void IDCTSSE2(int16 *block) {
+	__m128i r[8];
+	IDCTRowsSSE2(block, r);
+
+	for (int i = 0; i < 8; i++)
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(block + 8 * i), r[i]);
+}
+
+static void IDCTPutSSE2(byte *dest, uint32 pitch, const int16 *block) {
+	__m128i lo[8], hi[8];
+	IDCTSSE2(block, lo, hi);
+
+	// Truncate to 8 bits, like storing an int into a byte
+	const __m128i mask = _mm_set1_epi32(0xFF);
+
+	__m128i r[8];
+	for (int i = 0; i < 8; i++)
+		r[i] = _mm_packs_epi32(_mm_and_si128(lo[i], mask), _mm_and_si128(hi[i], mask));
+
+	transpose8x8(r);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(dest), _mm_packus_epi16(r[i], r[i]));
+}
+
+static void IDCTAddSSE2(byte *dest, uint32 pitch, int16 *block) {
+	__m128i r[8];
+	IDCTRowsSSE2(block, r);
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mask = _mm_set1_epi16(0xFF);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(block + 8 * i), r[i]);
+
+		const __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(dest)), zero);
+		const __m128i sum    = _mm_and_si128(_mm_add_epi16(pixels, r[i]), mask);
+
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(dest), _mm_packus_epi16(sum, sum));
+	}
+}
+#endif
+
+void binkIDCT(int16 *block, bool simd) {
+#ifdef BINKDSP_HAVE_SSE2
+	if (simd) {
+		IDCTSSE2(block);
+		return;
+	}
+#else
+	UNUSED(simd);
+#endif
+
+	IDCTScalar(block);
+}
+
+void binkIDCTPut(byte *dest, uint32 pitch, const int16 *block, bool simd) {
+#ifdef BINKDSP_HAVE_SSE2
+	if (simd) {
+		IDCTPutSSE2(dest, pitch, block);
+		return;
+	}
+#else
+	UNUSED(simd);
+#endif
+
+	IDCTPutScalar(dest, pitch, block);
+}
+
+void binkIDCTAdd(byte *dest, uint32 pitch, int16 *block, bool simd) {
+#ifdef BINKDSP_HAVE_SSE2
+	if (simd) {
+		IDCTAddSSE2(dest, pitch, block);
+		return;
+	}
+#else
+	UNUSED(simd);
+#endif
+
+	IDCTAddScalar(dest, pitch, block);
+}
+
+bool hasSIMDBinkIDCT() {
+#ifdef BINKDSP_HAVE_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+} // End of namespace Video
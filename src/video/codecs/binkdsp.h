@@ -0,0 +1,92 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The inverse discrete cosine transform of RAD Game Tools' Bink videos.
+ */
+
+/* Based on the Bink implementation in FFmpeg (<https://ffmpeg.org/)>,
+ * which is released under the terms of version 2 or later of the GNU
+ * Lesser General Public License.
+ *
+ * The original copyright notes in the files
+ * - libavcodec/binkdsp.c
+ * - libavcodec/binkdsp.h
+ * read as follows:
+ *
+ * Bink DSP routines
+ * Copyright (c) 2009 Konstantin Shishkov
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef VIDEO_CODECS_BINKDSP_H
+#define VIDEO_CODECS_BINKDSP_H
+
+#include "src/common/types.h"
+
+namespace Video {
+
+/** Run the Bink IDCT over an 8x8 block of coefficients, in place.
+ *
+ *  The SIMD kernels produce the exact same output as the scalar code.
+ *
+ *  @param block The coefficients, replaced with the transformed values.
+ *  @param simd  Use the SIMD kernels, if available. If false, always use the scalar code.
+ */
+void binkIDCT(int16 *block, bool simd = true);
+
+/** Run the Bink IDCT over an 8x8 block of coefficients and write the resulting pixels.
+ *
+ *  @param dest  The top-left pixel of the 8x8 destination block.
+ *  @param pitch The size of one row of the destination in bytes.
+ *  @param block The coefficients.
+ *  @param simd  Use the SIMD kernels, if available.
+ */
+void binkIDCTPut(byte *dest, uint32 pitch, const int16 *block, bool simd = true);
+
+/** Run the Bink IDCT over an 8x8 block of coefficients, in place, and add the
+ *  resulting residue to the pixels.
+ *
+ *  @param dest  The top-left pixel of the 8x8 destination block.
+ *  @param pitch The size of one row of the destination in bytes.
+ *  @param block The coefficients, replaced with the transformed values.
+ *  @param simd  Use the SIMD kernels, if available.
+ */
+void binkIDCTAdd(byte *dest, uint32 pitch, int16 *block, bool simd = true);
+
+/** Are the SIMD kernels of the Bink IDCT available? */
+bool hasSIMDBinkIDCT();
+
+} // End of namespace Video
+
+#endif // VIDEO_CODECS_BINKDSP_H
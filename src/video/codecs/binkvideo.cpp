@@ -0,0 +1,1417 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Decoding RAD Game Tools' Bink video frames.
+ */
+
+/* Based on the Bink implementation in FFmpeg (<https://ffmpeg.org/)>,
+ * which is released under the terms of version 2 or later of the GNU
+ * Lesser General Public License.
+ *
+ * The original copyright notes in the files
+ * - libavcodec/bink.c
+ * - libavcodec/binkdata.h
+ * - libavcodec/binkdsp.c
+ * - libavcodec/binkdsp.h
+ * read as follows:
+ *
+ * Bink video decoder
+ * Copyright (c) 2009 Konstantin Shishkov
+ * Copyright (C) 2011 Peter Ross <pross@xvid.org>
+ *
+ * Bink video decoder
+ * Copyright (C) 2009 Konstantin Shishkov
+ *
+ * Bink DSP routines
+ * Copyright (c) 2009 Konstantin Shishkov
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/maths.h"
+#include "src/common/bitstream.h"
+#include "src/common/huffman.h"
+#include "src/common/mutex.h"
+#include "src/common/thread.h"
+
+#include "src/graphics/yuv_to_rgb.h"
+
+#include "src/graphics/images/surface.h"
+
+#include "src/video/codecs/binkvideo.h"
+#include "src/video/codecs/binkdata.h"
+#include "src/video/codecs/binkdsp.h"
+
+static const uint32 kBIKiID = MKTAG('B', 'I', 'K', 'i');
+
+// Number of bits used to store first DC value in bundle
+static const uint32 kDCStartBits = 11;
+
+/** How long a worker waits for a job before checking whether it should quit, in ms. */
+static const uint32 kWorkerTimeout = 100;
+
+namespace Video {
+
+/** A thread running decoding jobs for the codec. */
+class BinkVideoCodec::Worker : public Common::Thread {
+public:
+	Worker() {
+	}
+
+	~Worker() {
+		destroyThread();
+	}
+
+	/** Start running a job. */
+	void run(const boost::function<void ()> &job) {
+		_job = job;
+
+		_start.unlock();
+	}
+
+	/** Wait for the current job to finish. */
+	void wait() {
+		_done.lock();
+	}
+
+private:
+	boost::function<void ()> _job;
+
+	Common::Semaphore _start;
+	Common::Semaphore _done;
+
+	void threadMethod() {
+		while (!_killThread.load(boost::memory_order_relaxed)) {
+			if (!_start.lock(kWorkerTimeout))
+				continue;
+
+			_job();
+
+			_done.unlock();
+		}
+	}
+};
+
+
+BinkVideoCodec::Huffman::Huffman() : index(0) {
+	for (size_t i = 0; i < 16; i++)
+		symbols[i] = i;
+}
+
+
+BinkVideoCodec::Bundle::Bundle() : countLength(0), dataEnd(0), curDec(0), curPtr(0) {
+	countLengths[0] = countLengths[1] = 0;
+}
+
+
+BinkVideoCodec::DecodeState::DecodeState() : colLastVal(0) {
+}
+
+
+BinkVideoCodec::BinkVideoCodec(uint32 width, uint32 height, uint32 id, bool swapPlanes, bool hasAlpha,
+                               size_t threadCount) : _width(width), _height(height), _id(id),
+	_learnedOffsets(false), _parallelFrames(0), _packetSize(0), _packetCapacity(0) {
+
+	// Give the planes a bit extra space
+	width  = _width  + 32;
+	height = _height + 32;
+
+	_curPlanes[0].reset(new byte[ width       *  height      ]); // Y
+	_curPlanes[1].reset(new byte[(width >> 1) * (height >> 1)]); // U, 1/4 resolution
+	_curPlanes[2].reset(new byte[(width >> 1) * (height >> 1)]); // V, 1/4 resolution
+	_curPlanes[3].reset(new byte[ width       *  height      ]); // A
+	_oldPlanes[0].reset(new byte[ width       *  height      ]); // Y
+	_oldPlanes[1].reset(new byte[(width >> 1) * (height >> 1)]); // U, 1/4 resolution
+	_oldPlanes[2].reset(new byte[(width >> 1) * (height >> 1)]); // V, 1/4 resolution
+	_oldPlanes[3].reset(new byte[ width       *  height      ]); // A
+
+	// Initialize the video with solid black
+	std::memset(_curPlanes[0].get(),   0,  width       *  height      );
+	std::memset(_curPlanes[1].get(),   0, (width >> 1) * (height >> 1));
+	std::memset(_curPlanes[2].get(),   0, (width >> 1) * (height >> 1));
+	std::memset(_curPlanes[3].get(), 255,  width       *  height      );
+	std::memset(_oldPlanes[0].get(),   0,  width       *  height      );
+	std::memset(_oldPlanes[1].get(),   0, (width >> 1) * (height >> 1));
+	std::memset(_oldPlanes[2].get(),   0, (width >> 1) * (height >> 1));
+	std::memset(_oldPlanes[3].get(), 255,  width       *  height      );
+
+	// The planes in the order they're stored in a packet
+	const bool hasOffsets = _id == kBIKiID;
+
+	const PlaneInfo alpha  = { 3, false, hasOffsets, 0, kOffsetNone };
+	const PlaneInfo luma   = { 0, false, hasOffsets, 0, kOffsetNone };
+	const PlaneInfo chroma1 = { swapPlanes ? 2 : 1, true, false, 0, kOffsetNone };
+	const PlaneInfo chroma2 = { swapPlanes ? 1 : 2, true, false, 0, kOffsetNone };
+
+	if (hasAlpha)
+		_planes.push_back(alpha);
+
+	_planes.push_back(luma);
+	_planes.push_back(chroma1);
+	_planes.push_back(chroma2);
+
+	initHuffman();
+
+	for (size_t i = 0; i <= threadCount; i++)
+		_states.push_back(new DecodeState);
+
+	// Make sure the YUV converter exists before several threads use it at once
+	YUVToRGBMan;
+
+	for (size_t i = 0; i < threadCount; i++) {
+		_workers.push_back(new Worker);
+
+		if (!_workers.back()->createThread(Common::UString::format("BinkVideoCodec%u", (uint) i)))
+			throw Common::Exception("Failed to create a Bink decoding thread");
+	}
+}
+
+BinkVideoCodec::~BinkVideoCodec() {
+	// Stop the threads before the states they might be using go away
+	_workers.clear();
+}
+
+uint32 BinkVideoCodec::getParallelFrameCount() const {
+	return _parallelFrames;
+}
+
+void BinkVideoCodec::decodeFrame(Graphics::Surface &surface, Common::SeekableReadStream &data) {
+	readPacket(data);
+
+	if (!decodeParallel())
+		decodeSequential();
+
+	// Convert the YUVA data we have to BGRA
+	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
+	convert(surface);
+
+	// And swap the planes with the reference planes
+	for (int i = 0; i < 4; i++)
+		_oldPlanes[i].swap(_curPlanes[i]);
+}
+
+void BinkVideoCodec::readPacket(Common::SeekableReadStream &data) {
+	data.seek(0);
+
+	_packetSize = data.size();
+	if (_packetSize > _packetCapacity) {
+		_packet.reset(new byte[_packetSize]);
+		_packetCapacity = _packetSize;
+	}
+
+	if (data.read(_packet.get(), _packetSize) != _packetSize)
+		throw Common::Exception(Common::kReadError);
+}
+
+void BinkVideoCodec::openPacket(DecodeState &state, size_t offset) {
+	// The bundles are big, so only allocate them for threads that are actually used
+	if (!state.bundles[0].data)
+		initBundles(state);
+
+	state.bits.reset(new Common::MemoryBitStream32LELSB(_packet.get(), _packetSize));
+
+	state.bits->skip(offset);
+}
+
+bool BinkVideoCodec::decodePlanes(DecodeState &state, size_t firstPlane, size_t endPlane,
+                                  std::vector<size_t> *planeStarts, std::vector<uint32> *values) {
+
+	for (size_t i = firstPlane; i < endPlane; i++) {
+		const PlaneInfo &plane = _planes[i];
+
+		if (planeStarts)
+			planeStarts->push_back(state.bits->pos());
+
+		uint32 value = 0;
+		if (plane.hasValue)
+			value = state.bits->getBits(32);
+
+		if (values)
+			values->push_back(value);
+
+		decodePlane(state, plane.index, plane.isChroma);
+
+		// The packet might end early, but only after a color plane
+		if ((plane.index != 3) && (state.bits->pos() >= state.bits->size()))
+			return false;
+	}
+
+	return true;
+}
+
+size_t BinkVideoCodec::getOffsetTarget(OffsetType type, size_t valuePos, uint32 value) {
+	switch (type) {
+		case kOffsetAbsolute:
+			return value * 8;
+
+		case kOffsetFromValue:
+			return valuePos + value * 8;
+
+		case kOffsetAfterValue:
+			return valuePos + 32 + value * 8;
+
+		default:
+			break;
+	}
+
+	return SIZE_MAX;
+}
+
+void BinkVideoCodec::decodeSequential() {
+	DecodeState &state = *_states[0];
+
+	openPacket(state, 0);
+
+	if (_learnedOffsets) {
+		decodePlanes(state, 0, _planes.size());
+		return;
+	}
+
+	std::vector<size_t> planeStarts;
+	std::vector<uint32> values;
+
+	if (!decodePlanes(state, 0, _planes.size(), &planeStarts, &values) && (planeStarts.size() < _planes.size()))
+		return;
+
+	/* We now know where each plane started. Look for a plane an offset value
+	 * could point to, and remember how the value needs to be interpreted. */
+
+	static const OffsetType kOffsetTypes[] = { kOffsetAbsolute, kOffsetFromValue, kOffsetAfterValue };
+
+	for (size_t i = 0; i < _planes.size(); i++) {
+		if (!_planes[i].hasValue)
+			continue;
+
+		for (size_t j = i + 1; (j < _planes.size()) && (_planes[i].target == 0); j++) {
+			for (size_t k = 0; k < ARRAYSIZE(kOffsetTypes); k++) {
+				if (getOffsetTarget(kOffsetTypes[k], planeStarts[i], values[i]) != planeStarts[j])
+					continue;
+
+				_planes[i].target     = j;
+				_planes[i].offsetType = kOffsetTypes[k];
+				break;
+			}
+		}
+	}
+
+	_learnedOffsets = true;
+}
+
+bool BinkVideoCodec::decodeParallel() {
+	if (!_learnedOffsets || _workers.empty())
+		return false;
+
+	// Split the planes into parts, at the planes the offset values point to
+
+	std::vector<Part> parts;
+
+	Part part;
+	part.firstPlane = 0;
+	part.start      = 0;
+
+	while (parts.size() < _workers.size()) {
+		const PlaneInfo &plane = _planes[part.firstPlane];
+		if (!plane.hasValue || (plane.target == 0) || (part.start & 31) || ((part.start / 8 + 4) > _packetSize))
+			break;
+
+		const uint32 value  = READ_LE_UINT32(_packet.get() + part.start / 8);
+		const size_t target = getOffsetTarget(plane.offsetType, part.start, value);
+		if ((target <= part.start) || (target >= (_packetSize * 8)))
+			break;
+
+		part.endPlane = plane.target;
+		parts.push_back(part);
+
+		part.firstPlane = plane.target;
+		part.start      = target;
+	}
+
+	if (parts.empty())
+		return false;
+
+	part.endPlane = _planes.size();
+	parts.push_back(part);
+
+	// Decode all parts at the same time, the first one on this thread
+
+	for (size_t i = 1; i < parts.size(); i++)
+		_workers[i - 1]->run(boost::bind(&BinkVideoCodec::decodePart, this, boost::ref(*_states[i]), boost::ref(parts[i])));
+
+	decodePart(*_states[0], parts[0]);
+
+	for (size_t i = 1; i < parts.size(); i++)
+		_workers[i - 1]->wait();
+
+	/* Check that each part started exactly where the one before it ended.
+	 * Otherwise, the offset value didn't mean what we thought, and we have
+	 * to decode the rest of the planes again. */
+
+	for (size_t i = 0; i < parts.size(); i++) {
+		if (parts[i].failed)
+			throw parts[i].error;
+
+		if (!parts[i].complete)
+			break;
+
+		if (((i + 1) < parts.size()) && (parts[i].end != parts[i + 1].start)) {
+			warning("BinkVideoCodec::decodeParallel(): Plane offset points to bit %u, but the plane starts at bit %u",
+			        (uint)parts[i + 1].start, (uint)parts[i].end);
+
+			for (size_t j = 0; j < _planes.size(); j++)
+				_planes[j].target = 0;
+
+			openPacket(*_states[0], parts[i].end);
+			decodePlanes(*_states[0], parts[i + 1].firstPlane, _planes.size());
+
+			return true;
+		}
+	}
+
+	_parallelFrames++;
+	return true;
+}
+
+void BinkVideoCodec::decodePart(DecodeState &state, Part &part) {
+	part.end      = part.start;
+	part.complete = false;
+	part.failed   = false;
+
+	try {
+		openPacket(state, part.start);
+
+		part.complete = decodePlanes(state, part.firstPlane, part.endPlane);
+		part.end      = state.bits->pos();
+
+	} catch (Common::Exception &e) {
+		part.failed = true;
+		part.error  = e;
+	} catch (std::exception &e) {
+		part.failed = true;
+		part.error  = Common::Exception(e);
+	} catch (...) {
+		part.failed = true;
+		part.error  = Common::Exception("Unknown exception");
+	}
+}
+
+void BinkVideoCodec::convertRows(Graphics::Surface *surface, uint32 row, uint32 rowCount) {
+	/* The surface is upside down: row 0 of the planes is the last row of
+	 * the surface, and a range of rows ends up just above the rows after it. */
+
+	const int pitch = surface->getWidth() * 4;
+
+	byte *dst = surface->getData() + pitch * (_height - row - rowCount);
+
+	YUVToRGBMan.convert420(Graphics::YUVToRGBManager::kScaleITU, dst, pitch,
+			_curPlanes[0].get() + row * _width,
+			_curPlanes[1].get() + (row >> 1) * (_width >> 1),
+			_curPlanes[2].get() + (row >> 1) * (_width >> 1),
+			_curPlanes[3].get() + row * _width,
+			_width, rowCount, _width, _width >> 1);
+}
+
+void BinkVideoCodec::convert(Graphics::Surface &surface) {
+	const uint32 sliceCount = _workers.size() + 1;
+	const uint32 pairCount  = _height >> 1;
+
+	if ((sliceCount == 1) || (pairCount < sliceCount)) {
+		convertRows(&surface, 0, _height);
+		return;
+	}
+
+	// Split the rows into slices of row pairs, one slice for each thread
+
+	uint32 row = 0;
+	for (uint32 i = 1; i < sliceCount; i++) {
+		const uint32 rowCount = 2 * (pairCount / sliceCount);
+
+		_workers[i - 1]->run(boost::bind(&BinkVideoCodec::convertRows, this, &surface, row, rowCount));
+
+		row += rowCount;
+	}
+
+	convertRows(&surface, row, _height - row);
+
+	for (uint32 i = 1; i < sliceCount; i++)
+		_workers[i - 1]->wait();
+}
+
+void BinkVideoCodec::decodePlane(DecodeState &state, int planeIdx, bool isChroma) {
+	uint32 blockWidth  = isChroma ? ((_width  + 15) >> 4) : ((_width  + 7) >> 3);
+	uint32 blockHeight = isChroma ? ((_height + 15) >> 4) : ((_height + 7) >> 3);
+	uint32 width       = isChroma ?  (_width        >> 1) :   _width;
+	uint32 height      = isChroma ?  (_height       >> 1) :   _height;
+
+	DecodeContext ctx;
+
+	ctx.state     = &state;
+	ctx.planeIdx  = planeIdx;
+	ctx.destStart = _curPlanes[planeIdx].get();
+	ctx.destEnd   = _curPlanes[planeIdx].get() + width * height;
+	ctx.prevStart = _oldPlanes[planeIdx].get();
+	ctx.prevEnd   = _oldPlanes[planeIdx].get() + width * height;
+	ctx.pitch     = width;
+
+	for (int i = 0; i < 64; i++) {
+		ctx.coordMap[i] = (i & 7) + (i >> 3) * ctx.pitch;
+
+		ctx.coordScaledMap1[i] = ((i & 7) * 2 + 0) + (((i >> 3) * 2 + 0) * ctx.pitch);
+		ctx.coordScaledMap2[i] = ((i & 7) * 2 + 1) + (((i >> 3) * 2 + 0) * ctx.pitch);
+		ctx.coordScaledMap3[i] = ((i & 7) * 2 + 0) + (((i >> 3) * 2 + 1) * ctx.pitch);
+		ctx.coordScaledMap4[i] = ((i & 7) * 2 + 1) + (((i >> 3) * 2 + 1) * ctx.pitch);
+	}
+
+	for (int i = 0; i < kSourceMAX; i++) {
+		state.bundles[i].countLength = state.bundles[i].countLengths[isChroma ? 1 : 0];
+
+		readBundle(state, (Source) i);
+	}
+
+	for (ctx.blockY = 0; ctx.blockY < blockHeight; ctx.blockY++) {
+		readBlockTypes  (state, state.bundles[kSourceBlockTypes]);
+		readBlockTypes  (state, state.bundles[kSourceSubBlockTypes]);
+		readColors      (state, state.bundles[kSourceColors]);
+		readPatterns    (state, state.bundles[kSourcePattern]);
+		readMotionValues(state, state.bundles[kSourceXOff]);
+		readMotionValues(state, state.bundles[kSourceYOff]);
+		readDCS         (state, state.bundles[kSourceIntraDC], kDCStartBits, false);
+		readDCS         (state, state.bundles[kSourceInterDC], kDCStartBits, true);
+		readRuns        (state, state.bundles[kSourceRun]);
+
+		ctx.dest = ctx.destStart + 8 * ctx.blockY * ctx.pitch;
+		ctx.prev = ctx.prevStart + 8 * ctx.blockY * ctx.pitch;
+
+		for (ctx.blockX = 0; ctx.blockX < blockWidth; ctx.blockX++, ctx.dest += 8, ctx.prev += 8) {
+			BlockType blockType = (BlockType) getBundleValue(*ctx.state, kSourceBlockTypes);
+
+			// 16x16 block type on odd line means part of the already decoded block, so skip it
+			if ((ctx.blockY & 1) && (blockType == kBlockScaled)) {
+				ctx.blockX += 1;
+				ctx.dest   += 8;
+				ctx.prev   += 8;
+				continue;
+			}
+
+			switch (blockType) {
+				case kBlockSkip:
+					blockSkip(ctx);
+					break;
+
+				case kBlockScaled:
+					blockScaled(ctx);
+					break;
+
+				case kBlockMotion:
+					blockMotion(ctx);
+					break;
+
+				case kBlockRun:
+					blockRun(ctx);
+					break;
+
+				case kBlockResidue:
+					blockResidue(ctx);
+					break;
+
+				case kBlockIntra:
+					blockIntra(ctx);
+					break;
+
+				case kBlockFill:
+					blockFill(ctx);
+					break;
+
+				case kBlockInter:
+					blockInter(ctx);
+					break;
+
+				case kBlockPattern:
+					blockPattern(ctx);
+					break;
+
+				case kBlockRaw:
+					blockRaw(ctx);
+					break;
+
+				default:
+					throw Common::Exception("Unknown block type: %d", blockType);
+			}
+
+		}
+
+	}
+
+	if (state.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
+		state.bits->skip(32 - (state.bits->pos() & 0x1F));
+
+}
+
+void BinkVideoCodec::readBundle(DecodeState &state, Source source) {
+	if (source == kSourceColors) {
+		for (int i = 0; i < 16; i++)
+			readHuffman(state, state.colHighHuffman[i]);
+
+		state.colLastVal = 0;
+	}
+
+	if ((source != kSourceIntraDC) && (source != kSourceInterDC))
+		readHuffman(state, state.bundles[source].huffman);
+
+	state.bundles[source].curDec = state.bundles[source].data.get();
+	state.bundles[source].curPtr = state.bundles[source].data.get();
+}
+
+void BinkVideoCodec::readHuffman(DecodeState &state, Huffman &huffman) {
+	huffman.index = state.bits->getBits(4);
+
+	if (huffman.index == 0) {
+		// The first tree always gives raw nibbles
+
+		for (int i = 0; i < 16; i++)
+			huffman.symbols[i] = i;
+
+		return;
+	}
+
+	byte hasSymbol[16];
+
+	if (state.bits->getBit()) {
+		// Symbol selection
+
+		std::memset(hasSymbol, 0, 16);
+
+		uint8 length = state.bits->getBits(3);
+		for (int i = 0; i <= length; i++) {
+			huffman.symbols[i] = state.bits->getBits(4);
+			hasSymbol[huffman.symbols[i]] = 1;
+		}
+
+		// Duplicate symbols are invalid, but must not write past the list
+		for (int i = 0; (i < 16) && (length < 15); i++)
+			if (hasSymbol[i] == 0)
+				huffman.symbols[++length] = i;
+
+		return;
+	}
+
+	// Symbol shuffling
+
+	byte tmp1[16], tmp2[16];
+	byte *in = tmp1, *out = tmp2;
+
+	uint8 depth = state.bits->getBits(2);
+
+	for (int i = 0; i < 16; i++)
+		in[i] = i;
+
+	for (int i = 0; i <= depth; i++) {
+		int size = 1 << i;
+
+		for (int j = 0; j < 16; j += (size << 1))
+			mergeHuffmanSymbols(state, out + j, in + j, size);
+
+		SWAP(in, out);
+	}
+
+	std::memcpy(huffman.symbols, in, 16);
+}
+
+void BinkVideoCodec::mergeHuffmanSymbols(DecodeState &state, byte *dst, const byte *src, int size) {
+	const byte *src2  = src + size;
+	int         size2 = size;
+
+	do {
+		if (!state.bits->getBit()) {
+			*dst++ = *src++;
+			size--;
+		} else {
+			*dst++ = *src2++;
+			size2--;
+		}
+
+	} while (size && size2);
+
+	while (size--)
+		*dst++ = *src++;
+	while (size2--)
+		*dst++ = *src2++;
+}
+
+void BinkVideoCodec::initBundles(DecodeState &state) {
+	uint32 bw     = (_width  + 7) >> 3;
+	uint32 bh     = (_height + 7) >> 3;
+	uint32 blocks = bw * bh;
+
+	for (int i = 0; i < kSourceMAX; i++) {
+		state.bundles[i].data.reset(new byte[blocks * 64]);
+		state.bundles[i].dataEnd = state.bundles[i].data.get() + blocks * 64;
+	}
+
+	uint32 cbw[2] = { (_width + 7) >> 3, (_width  + 15) >> 4 };
+	uint32 cw [2] = {  _width          ,  _width        >> 1 };
+
+	// Calculate the lengths of an element count in bits
+	for (int i = 0; i < 2; i++) {
+		int width = MAX<uint32>(cw[i], 8);
+
+		state.bundles[kSourceBlockTypes   ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		state.bundles[kSourceSubBlockTypes].countLengths[i] = Common::intLog2(((width + 7) >> 4) + 511) + 1;
+		state.bundles[kSourceColors       ].countLengths[i] = Common::intLog2((cbw[i])     * 64  + 511) + 1;
+		state.bundles[kSourceIntraDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		state.bundles[kSourceInterDC      ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		state.bundles[kSourceXOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		state.bundles[kSourceYOff         ].countLengths[i] = Common::intLog2((width       >> 3) + 511) + 1;
+		state.bundles[kSourcePattern      ].countLengths[i] = Common::intLog2((cbw[i]      << 3) + 511) + 1;
+		state.bundles[kSourceRun          ].countLengths[i] = Common::intLog2((cbw[i])     * 48  + 511) + 1;
+	}
+}
+
+void BinkVideoCodec::initHuffman() {
+	for (int i = 0; i < 16; i++)
+		_huffman[i].reset(new Common::Huffman(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]));
+}
+
+byte BinkVideoCodec::getHuffmanSymbol(DecodeState &state, Huffman &huffman) {
+	return huffman.symbols[_huffman[huffman.index]->getSymbol(*state.bits)];
+}
+
+int32 BinkVideoCodec::getBundleValue(DecodeState &state, Source source) {
+	if ((source < kSourceXOff) || (source == kSourceRun))
+		return *state.bundles[source].curPtr++;
+
+	if ((source == kSourceXOff) || (source == kSourceYOff))
+		return (int8) *state.bundles[source].curPtr++;
+
+	int16 ret = *reinterpret_cast<int16 *>(state.bundles[source].curPtr);
+
+	state.bundles[source].curPtr += 2;
+
+	return ret;
+}
+
+uint32 BinkVideoCodec::readBundleCount(DecodeState &state, Bundle &bundle) {
+	if (!bundle.curDec || (bundle.curDec > bundle.curPtr))
+		return 0;
+
+	uint32 n = state.bits->getBits(bundle.countLength);
+	if (n == 0)
+		bundle.curDec = 0;
+
+	return n;
+}
+
+void BinkVideoCodec::blockSkip(DecodeContext &ctx) {
+	byte *dest = ctx.dest;
+	byte *prev = ctx.prev;
+
+	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
+		std::memcpy(dest, prev, 8);
+}
+
+void BinkVideoCodec::blockScaledSkip(DecodeContext &ctx) {
+	byte *dest = ctx.dest;
+	byte *prev = ctx.prev;
+
+	for (int j = 0; j < 16; j++, dest += ctx.pitch, prev += ctx.pitch)
+		std::memcpy(dest, prev, 16);
+}
+
+void BinkVideoCodec::blockScaledRun(DecodeContext &ctx) {
+	const uint8 *scan = binkPatterns[ctx.state->bits->getBits(4)];
+
+	int i = 0;
+	do {
+		int run = getBundleValue(*ctx.state, kSourceRun) + 1;
+
+		i += run;
+		if (i > 64)
+			throw Common::Exception("Run went out of bounds");
+
+		if (ctx.state->bits->getBit()) {
+
+			byte v = getBundleValue(*ctx.state, kSourceColors);
+			for (int j = 0; j < run; j++, scan++)
+				ctx.dest[ctx.coordScaledMap1[*scan]] =
+				ctx.dest[ctx.coordScaledMap2[*scan]] =
+				ctx.dest[ctx.coordScaledMap3[*scan]] =
+				ctx.dest[ctx.coordScaledMap4[*scan]] = v;
+
+		} else
+			for (int j = 0; j < run; j++, scan++)
+				ctx.dest[ctx.coordScaledMap1[*scan]] =
+				ctx.dest[ctx.coordScaledMap2[*scan]] =
+				ctx.dest[ctx.coordScaledMap3[*scan]] =
+				ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(*ctx.state, kSourceColors);
+
+	} while (i < 63);
+
+	if (i == 63)
+		ctx.dest[ctx.coordScaledMap1[*scan]] =
+		ctx.dest[ctx.coordScaledMap2[*scan]] =
+		ctx.dest[ctx.coordScaledMap3[*scan]] =
+		ctx.dest[ctx.coordScaledMap4[*scan]] = getBundleValue(*ctx.state, kSourceColors);
+}
+
+void BinkVideoCodec::blockScaledIntra(DecodeContext &ctx) {
+	int16 block[64];
+	std::memset(block, 0, 64 * sizeof(int16));
+
+	block[0] = getBundleValue(*ctx.state, kSourceIntraDC);
+
+	readDCTCoeffs(*ctx.state, block, true);
+
+	binkIDCT(block);
+
+	int16 *src   = block;
+	byte  *dest1 = ctx.dest;
+	byte  *dest2 = ctx.dest + ctx.pitch;
+	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16, src += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
+
+	}
+}
+
+void BinkVideoCodec::blockScaledFill(DecodeContext &ctx) {
+	byte v = getBundleValue(*ctx.state, kSourceColors);
+
+	byte *dest = ctx.dest;
+	for (int i = 0; i < 16; i++, dest += ctx.pitch)
+		std::memset(dest, v, 16);
+}
+
+void BinkVideoCodec::blockScaledPattern(DecodeContext &ctx) {
+	byte col[2];
+
+	for (int i = 0; i < 2; i++)
+		col[i] = getBundleValue(*ctx.state, kSourceColors);
+
+	byte *dest1 = ctx.dest;
+	byte *dest2 = ctx.dest + ctx.pitch;
+	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
+		byte v = getBundleValue(*ctx.state, kSourcePattern);
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2, v >>= 1)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = col[v & 1];
+	}
+}
+
+void BinkVideoCodec::blockScaledRaw(DecodeContext &ctx) {
+	byte row[8];
+
+	byte *dest1 = ctx.dest;
+	byte *dest2 = ctx.dest + ctx.pitch;
+	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
+		std::memcpy(row, ctx.state->bundles[kSourceColors].curPtr, 8);
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = row[i];
+
+		ctx.state->bundles[kSourceColors].curPtr += 8;
+	}
+}
+
+void BinkVideoCodec::blockScaled(DecodeContext &ctx) {
+	BlockType blockType = (BlockType) getBundleValue(*ctx.state, kSourceSubBlockTypes);
+
+	switch (blockType) {
+		case kBlockRun:
+			blockScaledRun(ctx);
+			break;
+
+		case kBlockIntra:
+			blockScaledIntra(ctx);
+			break;
+
+		case kBlockFill:
+			blockScaledFill(ctx);
+			break;
+
+		case kBlockPattern:
+			blockScaledPattern(ctx);
+			break;
+
+		case kBlockRaw:
+			blockScaledRaw(ctx);
+			break;
+
+		default:
+			throw Common::Exception("Invalid 16x16 block type: %d", blockType);
+	}
+
+	ctx.blockX += 1;
+	ctx.dest   += 8;
+	ctx.prev   += 8;
+}
+
+void BinkVideoCodec::blockMotion(DecodeContext &ctx) {
+	int8 xOff = getBundleValue(*ctx.state, kSourceXOff);
+	int8 yOff = getBundleValue(*ctx.state, kSourceYOff);
+
+	byte *dest = ctx.dest;
+	byte *prev = ctx.prev + yOff * ((int32) ctx.pitch) + xOff;
+	if ((prev < ctx.prevStart) || (prev > ctx.prevEnd))
+		throw Common::Exception("Copy out of bounds (%d | %d)", ctx.blockX * 8 + xOff, ctx.blockY * 8 + yOff);
+
+	for (int j = 0; j < 8; j++, dest += ctx.pitch, prev += ctx.pitch)
+		std::memcpy(dest, prev, 8);
+}
+
+void BinkVideoCodec::blockRun(DecodeContext &ctx) {
+	const uint8 *scan = binkPatterns[ctx.state->bits->getBits(4)];
+
+	int i = 0;
+	do {
+		int run = getBundleValue(*ctx.state, kSourceRun) + 1;
+
+		i += run;
+		if (i > 64)
+			throw Common::Exception("Run went out of bounds");
+
+		if (ctx.state->bits->getBit()) {
+
+			byte v = getBundleValue(*ctx.state, kSourceColors);
+			for (int j = 0; j < run; j++)
+				ctx.dest[ctx.coordMap[*scan++]] = v;
+
+		} else
+			for (int j = 0; j < run; j++)
+				ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(*ctx.state, kSourceColors);
+
+	} while (i < 63);
+
+	if (i == 63)
+		ctx.dest[ctx.coordMap[*scan++]] = getBundleValue(*ctx.state, kSourceColors);
+}
+
+void BinkVideoCodec::blockResidue(DecodeContext &ctx) {
+	blockMotion(ctx);
+
+	byte v = ctx.state->bits->getBits(7);
+
+	int16 block[64];
+	std::memset(block, 0, 64 * sizeof(int16));
+
+	readResidue(*ctx.state, block, v);
+
+	byte  *dst = ctx.dest;
+	int16 *src = block;
+	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
+		for (int j = 0; j < 8; j++)
+			dst[j] += src[j];
+}
+
+void BinkVideoCodec::blockIntra(DecodeContext &ctx) {
+	int16 block[64];
+	std::memset(block, 0, 64 * sizeof(int16));
+
+	block[0] = getBundleValue(*ctx.state, kSourceIntraDC);
+
+	readDCTCoeffs(*ctx.state, block, true);
+
+	binkIDCTPut(ctx.dest, ctx.pitch, block);
+}
+
+void BinkVideoCodec::blockFill(DecodeContext &ctx) {
+	byte v = getBundleValue(*ctx.state, kSourceColors);
+
+	byte *dest = ctx.dest;
+	for (int i = 0; i < 8; i++, dest += ctx.pitch)
+		std::memset(dest, v, 8);
+}
+
+void BinkVideoCodec::blockInter(DecodeContext &ctx) {
+	blockMotion(ctx);
+
+	int16 block[64];
+	std::memset(block, 0, 64 * sizeof(int16));
+
+	block[0] = getBundleValue(*ctx.state, kSourceInterDC);
+
+	readDCTCoeffs(*ctx.state, block, false);
+
+	binkIDCTAdd(ctx.dest, ctx.pitch, block);
+}
+
+void BinkVideoCodec::blockPattern(DecodeContext &ctx) {
+	byte col[2];
+
+	for (int i = 0; i < 2; i++)
+		col[i] = getBundleValue(*ctx.state, kSourceColors);
+
+	byte *dest = ctx.dest;
+	for (int i = 0; i < 8; i++, dest += ctx.pitch - 8) {
+		byte v = getBundleValue(*ctx.state, kSourcePattern);
+
+		for (int j = 0; j < 8; j++, v >>= 1)
+			*dest++ = col[v & 1];
+	}
+}
+
+void BinkVideoCodec::blockRaw(DecodeContext &ctx) {
+	byte *dest = ctx.dest;
+	byte *data = ctx.state->bundles[kSourceColors].curPtr;
+	for (int i = 0; i < 8; i++, dest += ctx.pitch, data += 8)
+		std::memcpy(dest, data, 8);
+
+	ctx.state->bundles[kSourceColors].curPtr += 64;
+}
+
+void BinkVideoCodec::readRuns(DecodeState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
+	if (n == 0)
+		return;
+
+	byte *decEnd = bundle.curDec + n;
+	if (decEnd > bundle.dataEnd)
+		throw Common::Exception("Run value went out of bounds");
+
+	if (state.bits->getBit()) {
+		byte v = state.bits->getBits(4);
+
+		std::memset(bundle.curDec, v, n);
+		bundle.curDec += n;
+
+	} else
+		while (bundle.curDec < decEnd)
+			*bundle.curDec++ = getHuffmanSymbol(state, bundle.huffman);
+}
+
+void BinkVideoCodec::readMotionValues(DecodeState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
+	if (n == 0)
+		return;
+
+	byte *decEnd = bundle.curDec + n;
+	if (decEnd > bundle.dataEnd)
+		throw Common::Exception("Too many motion values");
+
+	if (state.bits->getBit()) {
+		byte v = state.bits->getBits(4);
+
+		if (v) {
+			int sign = -((int)state.bits->getBit());
+			v = (v ^ sign) - sign;
+		}
+
+		std::memset(bundle.curDec, v, n);
+
+		bundle.curDec += n;
+		return;
+	}
+
+	do {
+		byte v = getHuffmanSymbol(state, bundle.huffman);
+
+		if (v) {
+			int sign = -((int)state.bits->getBit());
+			v = (v ^ sign) - sign;
+		}
+
+		*bundle.curDec++ = v;
+
+	} while (bundle.curDec < decEnd);
+}
+
+const uint8 rleLens[4] = { 4, 8, 12, 32 };
+void BinkVideoCodec::readBlockTypes(DecodeState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
+	if (n == 0)
+		return;
+
+	byte *decEnd = bundle.curDec + n;
+	if (decEnd > bundle.dataEnd)
+		throw Common::Exception("Too many block type values");
+
+	if (state.bits->getBit()) {
+		byte v = state.bits->getBits(4);
+
+		std::memset(bundle.curDec, v, n);
+
+		bundle.curDec += n;
+		return;
+	}
+
+	byte last = 0;
+	do {
+
+		byte v = getHuffmanSymbol(state, bundle.huffman);
+
+		if (v < 12) {
+			last = v;
+			*bundle.curDec++ = v;
+		} else {
+			int run = rleLens[v - 12];
+			if ((decEnd - bundle.curDec) < run)
+				throw Common::Exception("Block type run too long");
+
+			std::memset(bundle.curDec, last, run);
+
+			bundle.curDec += run;
+		}
+
+	} while (bundle.curDec < decEnd);
+}
+
+void BinkVideoCodec::readPatterns(DecodeState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
+	if (n == 0)
+		return;
+
+	byte *decEnd = bundle.curDec + n;
+	if (decEnd > bundle.dataEnd)
+		throw Common::Exception("Too many pattern values");
+
+	byte v;
+	while (bundle.curDec < decEnd) {
+		v  = getHuffmanSymbol(state, bundle.huffman);
+		v |= getHuffmanSymbol(state, bundle.huffman) << 4;
+		*bundle.curDec++ = v;
+	}
+}
+
+
+void BinkVideoCodec::readColors(DecodeState &state, Bundle &bundle) {
+	uint32 n = readBundleCount(state, bundle);
+	if (n == 0)
+		return;
+
+	byte *decEnd = bundle.curDec + n;
+	if (decEnd > bundle.dataEnd)
+		throw Common::Exception("Too many color values");
+
+	if (state.bits->getBit()) {
+		state.colLastVal = getHuffmanSymbol(state, state.colHighHuffman[state.colLastVal]);
+
+		byte v;
+		v = getHuffmanSymbol(state, bundle.huffman);
+		v = (state.colLastVal << 4) | v;
+
+		if (_id != kBIKiID) {
+			int sign = ((int8) v) >> 7;
+			v = ((v & 0x7F) ^ sign) - sign;
+			v += 0x80;
+		}
+
+		std::memset(bundle.curDec, v, n);
+		bundle.curDec += n;
+
+		return;
+	}
+
+	while (bundle.curDec < decEnd) {
+		state.colLastVal = getHuffmanSymbol(state, state.colHighHuffman[state.colLastVal]);
+
+		byte v;
+		v = getHuffmanSymbol(state, bundle.huffman);
+		v = (state.colLastVal << 4) | v;
+
+		if (_id != kBIKiID) {
+			int sign = ((int8) v) >> 7;
+			v = ((v & 0x7F) ^ sign) - sign;
+			v += 0x80;
+		}
+		*bundle.curDec++ = v;
+	}
+}
+
+void BinkVideoCodec::readDCS(DecodeState &state, Bundle &bundle, int startBits, bool hasSign) {
+	uint32 length = readBundleCount(state, bundle);
+	if (length == 0)
+		return;
+
+	if ((bundle.curDec + length * 2) > bundle.dataEnd)
+		throw Common::Exception("Too many DC values");
+
+	int16 *dest = reinterpret_cast<int16 *>(bundle.curDec);
+
+	int32 v = state.bits->getBits(startBits - (hasSign ? 1 : 0));
+	if (v && hasSign) {
+		int sign = -((int)state.bits->getBit());
+		v = (v ^ sign) - sign;
+	}
+
+	*dest++ = v;
+	length--;
+
+	for (uint32 i = 0; i < length; i += 8) {
+		uint32 length2 = MIN<uint32>(length - i, 8);
+
+		byte bSize = state.bits->getBits(4);
+
+		if (bSize) {
+
+			for (uint32 j = 0; j < length2; j++) {
+				int16 v2 = state.bits->getBits(bSize);
+				if (v2) {
+					int sign = -((int)state.bits->getBit());
+					v2 = (v2 ^ sign) - sign;
+				}
+
+				v += v2;
+				*dest++ = v;
+
+				if ((v < -32768) || (v > 32767))
+					throw Common::Exception("DC value went out of bounds: %d", v);
+			}
+
+		} else
+			for (uint32 j = 0; j < length2; j++)
+				*dest++ = v;
+	}
+
+	bundle.curDec = reinterpret_cast<byte *>(dest);
+}
+
+/* WORKAROUND: This fixes the NWN2 WotC logo.
+ * [cf. ffmpeg 47b71eea099b3fe2c7e16644878ad9b7067974e3] */
+static inline int16 dequant(int16 in, uint32 quant, bool dc) {
+	/* Note: multiplication is unsigned but we want signed shift
+	 * otherwise clipping breaks.
+	 *
+	 * TODO: The official decoder does not use clipping at all
+	 * but instead uses the full 32-bit result.
+	 * However clipping at least gets rid of the case that a
+	 * half-black half-white intra block gets black and white swapped
+	 * and should cause at most minor differences (except for DC).
+	 */
+
+	int32 res = ((int32) (in * quant)) >> 11;
+	if (!dc)
+		res = CLIP(res, -32768, 32767);
+
+	return res;
+}
+
+/** Reads 8x8 block of DCT coefficients. */
+void BinkVideoCodec::readDCTCoeffs(DecodeState &state, int16 *block, bool isIntra) {
+	int coefCount = 0;
+	int coefIdx[64];
+
+	int listStart = 64;
+	int listEnd   = 64;
+
+	int coefList[128];      int modeList[128];
+	coefList[listEnd] = 4;  modeList[listEnd++] = 0;
+	coefList[listEnd] = 24; modeList[listEnd++] = 0;
+	coefList[listEnd] = 44; modeList[listEnd++] = 0;
+	coefList[listEnd] = 1;  modeList[listEnd++] = 3;
+	coefList[listEnd] = 2;  modeList[listEnd++] = 3;
+	coefList[listEnd] = 3;  modeList[listEnd++] = 3;
+
+	int bits = state.bits->getBits(4) - 1;
+	for (int mask = 1 << (MAX<int>(bits, 0)); bits >= 0; mask >>= 1, bits--) {
+		int listPos = listStart;
+
+		while (listPos < listEnd) {
+
+			if (!(modeList[listPos] | coefList[listPos]) || !state.bits->getBit()) {
+				listPos++;
+				continue;
+			}
+
+			int ccoef = coefList[listPos];
+			int mode  = modeList[listPos];
+
+			switch (mode) {
+			case 0:
+				coefList[listPos] = ccoef + 4;
+				modeList[listPos] = 1;
+				XOREOS_FALLTHROUGH;
+			case 2:
+				if (mode == 2) {
+					coefList[listPos]   = 0;
+					modeList[listPos++] = 0;
+				}
+				for (int i = 0; i < 4; i++, ccoef++) {
+					if (state.bits->getBit()) {
+						coefList[--listStart] = ccoef;
+						modeList[  listStart] = 3;
+					} else {
+						int t;
+						if (!bits) {
+							t = 1 - (state.bits->getBit() << 1);
+						} else {
+							t = state.bits->getBits(bits) | mask;
+
+							int sign = -((int)state.bits->getBit());
+							t = (t ^ sign) - sign;
+						}
+						block[binkScan[ccoef]] = t;
+						coefIdx[coefCount++]   = ccoef;
+					}
+				}
+				break;
+
+			case 1:
+				modeList[listPos] = 2;
+				for (int i = 0; i < 3; i++) {
+					ccoef += 4;
+					coefList[listEnd]   = ccoef;
+					modeList[listEnd++] = 2;
+				}
+				break;
+
+			case 3:
+				int t;
+				if (!bits) {
+					t = 1 - (state.bits->getBit() << 1);
+				} else {
+					t = state.bits->getBits(bits) | mask;
+
+					int sign = -((int)state.bits->getBit());
+					t = (t ^ sign) - sign;
+				}
+				block[binkScan[ccoef]] = t;
+				coefIdx[coefCount++]   = ccoef;
+				coefList[listPos]      = 0;
+				modeList[listPos++]    = 0;
+				break;
+			}
+		}
+	}
+
+	uint8 quantIdx = state.bits->getBits(4);
+	const uint32 *quant = isIntra ? binkIntraQuant[quantIdx] : binkInterQuant[quantIdx];
+	block[0] = dequant(block[0], quant[0], true);
+
+	for (int i = 0; i < coefCount; i++) {
+		int idx = coefIdx[i];
+		block[binkScan[idx]] = dequant(block[binkScan[idx]], quant[idx], false);
+	}
+
+}
+
+/** Reads 8x8 block with residue after motion compensation. */
+void BinkVideoCodec::readResidue(DecodeState &state, int16 *block, int masksCount) {
+	int nzCoeff[64];
+	int nzCoeffCount = 0;
+
+	int listStart = 64;
+	int listEnd   = 64;
+
+	int coefList[128];      int modeList[128];
+	coefList[listEnd] =  4; modeList[listEnd++] = 0;
+	coefList[listEnd] = 24; modeList[listEnd++] = 0;
+	coefList[listEnd] = 44; modeList[listEnd++] = 0;
+	coefList[listEnd] =  0; modeList[listEnd++] = 2;
+
+	for (int mask = 1 << state.bits->getBits(3); mask; mask >>= 1) {
+
+		for (int i = 0; i < nzCoeffCount; i++) {
+			if (!state.bits->getBit())
+				continue;
+			if (block[nzCoeff[i]] < 0)
+				block[nzCoeff[i]] -= mask;
+			else
+				block[nzCoeff[i]] += mask;
+			masksCount--;
+			if (masksCount < 0)
+				return;
+		}
+
+		int listPos = listStart;
+		while (listPos < listEnd) {
+
+			if (!(coefList[listPos] | modeList[listPos]) || !state.bits->getBit()) {
+				listPos++;
+				continue;
+			}
+
+			int ccoef = coefList[listPos];
+			int mode  = modeList[listPos];
+
+			switch (mode) {
+			case 0:
+				coefList[listPos] = ccoef + 4;
+				modeList[listPos] = 1;
+				XOREOS_FALLTHROUGH;
+			case 2:
+				if (mode == 2) {
+					coefList[listPos]   = 0;
+					modeList[listPos++] = 0;
+				}
+
+				for (int i = 0; i < 4; i++, ccoef++) {
+					if (state.bits->getBit()) {
+						coefList[--listStart] = ccoef;
+						modeList[  listStart] = 3;
+					} else {
+						nzCoeff[nzCoeffCount++] = binkScan[ccoef];
+
+						int sign = -((int)state.bits->getBit());
+						block[binkScan[ccoef]] = (mask ^ sign) - sign;
+
+						masksCount--;
+						if (masksCount < 0)
+							return;
+					}
+				}
+				break;
+
+			case 1:
+				modeList[listPos] = 2;
+				for (int i = 0; i < 3; i++) {
+					ccoef += 4;
+					coefList[listEnd]   = ccoef;
+					modeList[listEnd++] = 2;
+				}
+				break;
+
+			case 3:
+				nzCoeff[nzCoeffCount++] = binkScan[ccoef];
+
+				int sign = -((int)state.bits->getBit());
+				block[binkScan[ccoef]] = (mask ^ sign) - sign;
+
+				coefList[listPos]   = 0;
+				modeList[listPos++] = 0;
+				masksCount--;
+				if (masksCount < 0)
+					return;
+				break;
+			}
+		}
+	}
+}
+
+} // End of namespace Video
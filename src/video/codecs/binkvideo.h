@@ -0,0 +1,345 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Decoding RAD Game Tools' Bink video frames.
+ */
+
+/* Based on the Bink implementation in FFmpeg (<https://ffmpeg.org/)>,
+ * which is released under the terms of version 2 or later of the GNU
+ * Lesser General Public License.
+ *
+ * The original copyright notes in the files
+ * - libavcodec/bink.c
+ * - libavcodec/binkdata.h
+ * - libavcodec/binkdsp.c
+ * - libavcodec/binkdsp.h
+ * read as follows:
+ *
+ * Bink video decoder
+ * Copyright (c) 2009 Konstantin Shishkov
+ * Copyright (C) 2011 Peter Ross <pross@xvid.org>
+ *
+ * Bink video decoder
+ * Copyright (C) 2009 Konstantin Shishkov
+ *
+ * Bink DSP routines
+ * Copyright (c) 2009 Konstantin Shishkov
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef VIDEO_CODECS_BINKVIDEO_H
+#define VIDEO_CODECS_BINKVIDEO_H
+
+#include <vector>
+
+#include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/error.h"
+#include "src/common/bitstream.h"
+
+#include "src/video/codecs/codec.h"
+
+namespace Common {
+	class Huffman;
+}
+
+namespace Video {
+
+/** The video codec of RAD Game Tools' Bink videos.
+ *
+ *  Each video packet holds the alpha (if any), Y, U and V planes, one after
+ *  the other. Bink 'i' videos prefix the alpha and the Y plane with a 32-bit
+ *  value that points further ahead into the packet, so that parts of a frame
+ *  can be decoded in parallel. Since we don't know its exact meaning, we
+ *  learn it on the first frame, and then decode the parts it marks on extra
+ *  threads. Every parallel decode is checked against where the previous part
+ *  actually ended, and redone sequentially if that doesn't match.
+ *
+ *  Converting the finished planes into the BGRA surface is done in slices of
+ *  rows on all threads as well.
+ */
+class BinkVideoCodec : public Codec {
+public:
+	/** Create a Bink video codec.
+	 *
+	 *  @param width The width of a video frame.
+	 *  @param height The height of a video frame.
+	 *  @param id The Bink FourCC.
+	 *  @param swapPlanes Are the planes ordered (A)YVU instead of (A)YUV?
+	 *  @param hasAlpha Do video frames have alpha?
+	 *  @param threadCount The number of extra threads to decode with. 0 decodes everything on the calling thread.
+	 */
+	BinkVideoCodec(uint32 width, uint32 height, uint32 id, bool swapPlanes, bool hasAlpha, size_t threadCount = 0);
+	~BinkVideoCodec();
+
+	/** Decode a video packet into the BGRA surface. */
+	void decodeFrame(Graphics::Surface &surface, Common::SeekableReadStream &data);
+
+	/** Return the number of frames that were decoded with parts in parallel. */
+	uint32 getParallelFrameCount() const;
+
+private:
+	class Worker;
+
+	/** IDs for different data types used in Bink video codec. */
+	enum Source {
+		kSourceBlockTypes    = 0, ///< 8x8 block types.
+		kSourceSubBlockTypes    , ///< 16x16 block types (a subset of 8x8 block types).
+		kSourceColors           , ///< Pixel values used for different block types.
+		kSourcePattern          , ///< 8-bit values for 2-color pattern fill.
+		kSourceXOff             , ///< X components of motion value.
+		kSourceYOff             , ///< Y components of motion value.
+		kSourceIntraDC          , ///< DC values for intrablocks with DCT.
+		kSourceInterDC          , ///< DC values for interblocks with DCT.
+		kSourceRun              , ///< Run lengths for special fill block.
+
+		kSourceMAX
+	};
+
+	/** Bink video block types. */
+	enum BlockType {
+		kBlockSkip    = 0,  ///< Skipped block.
+		kBlockScaled     ,  ///< Block has size 16x16.
+		kBlockMotion     ,  ///< Block is copied from previous frame with some offset.
+		kBlockRun        ,  ///< Block is composed from runs of colors with custom scan order.
+		kBlockResidue    ,  ///< Motion block with some difference added.
+		kBlockIntra      ,  ///< Intra DCT block.
+		kBlockFill       ,  ///< Block is filled with single color.
+		kBlockInter      ,  ///< Motion block with DCT applied to the difference.
+		kBlockPattern    ,  ///< Block is filled with two colors following custom pattern.
+		kBlockRaw           ///< Uncoded 8x8 block.
+	};
+
+	/** How a plane offset value is to be interpreted. */
+	enum OffsetType {
+		kOffsetNone = 0,    ///< We don't know what the value means.
+		kOffsetAbsolute,    ///< Bytes from the start of the packet.
+		kOffsetFromValue,   ///< Bytes from the start of the value.
+		kOffsetAfterValue   ///< Bytes from the end of the value.
+	};
+
+	/** Data structure for decoding and translating Huffman'd data. */
+	struct Huffman {
+		int  index;       ///< Index of the Huffman codebook to use.
+		byte symbols[16]; ///< Huffman symbol => Bink symbol translation list.
+
+		Huffman();
+	};
+
+	/** Data structure used for decoding a single Bink data type. */
+	struct Bundle {
+		int countLengths[2]; ///< Lengths of number of entries to decode (in bits).
+		int countLength;     ///< Length of number of entries to decode (in bits) for the current plane.
+
+		Huffman huffman; ///< Huffman codebook.
+
+		Common::ScopedArray<byte> data; ///< Buffer for decoded symbols.
+
+		byte *dataEnd; ///< Pointer to the data end end.
+		byte *curDec;  ///< Pointer to the data that wasn't yet decoded.
+		byte *curPtr;  ///< Pointer to the data that wasn't yet read.
+
+		Bundle();
+	};
+
+	/** The state of decoding planes out of a packet. Each thread needs its own. */
+	struct DecodeState {
+		Common::ScopedPtr<Common::MemoryBitStream32LELSB> bits; ///< The packet's bits.
+
+		Bundle bundles[kSourceMAX]; ///< Bundles for decoding all data types.
+
+		/** Huffman codebooks to use for decoding high nibbles in color data types. */
+		Huffman colHighHuffman[16];
+		/** Value of the last decoded high nibble in color data types. */
+		int colLastVal;
+
+		DecodeState();
+	};
+
+	/** A decoder state. */
+	struct DecodeContext {
+		DecodeState *state;
+
+		uint32 planeIdx;
+
+		uint32 blockX;
+		uint32 blockY;
+
+		byte *dest;
+		byte *prev;
+
+		byte *destStart, *destEnd;
+		byte *prevStart, *prevEnd;
+
+		uint32 pitch;
+
+		int coordMap[64];
+		int coordScaledMap1[64];
+		int coordScaledMap2[64];
+		int coordScaledMap3[64];
+		int coordScaledMap4[64];
+	};
+
+	/** A plane within a packet, in the order they are stored. */
+	struct PlaneInfo {
+		int  index;    ///< The index of the plane, YUVA.
+		bool isChroma; ///< Is this a chroma plane?
+		bool hasValue; ///< Is this plane preceded by a 32-bit offset value?
+
+		/** Which plane the offset value points to, or 0 if unknown. */
+		size_t target;
+		/** How the offset value is to be interpreted. */
+		OffsetType offsetType;
+	};
+
+	/** A consecutive run of planes decoded by one thread. */
+	struct Part {
+		size_t firstPlane; ///< The first plane to decode.
+		size_t endPlane;   ///< One past the last plane to decode.
+
+		size_t start; ///< The bit offset to start decoding at.
+		size_t end;   ///< The bit offset decoding ended at.
+
+		bool complete; ///< Were all the planes decoded?
+		bool failed;   ///< Did the decoding throw?
+
+		Common::Exception error; ///< The error, if the decoding failed.
+	};
+
+	uint32 _width;
+	uint32 _height;
+
+	uint32 _id; ///< The BIK FourCC.
+
+	std::vector<PlaneInfo> _planes; ///< The planes in each packet, in order.
+
+	/** Have the offset values been learned yet? */
+	bool _learnedOffsets;
+	/** Number of frames decoded with parts in parallel. */
+	uint32 _parallelFrames;
+
+	Common::ScopedPtr<Common::Huffman> _huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
+
+	Common::ScopedArray<byte> _curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
+	Common::ScopedArray<byte> _oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
+
+	Common::ScopedArray<byte> _packet; ///< The data of the current packet.
+	size_t _packetSize;                ///< The size of the current packet.
+	size_t _packetCapacity;            ///< The size of the packet buffer.
+
+	Common::PtrVector<DecodeState> _states; ///< One decoding state for each thread.
+	Common::PtrVector<Worker> _workers;     ///< The extra decoding threads.
+
+	/** Initialize the bundles. */
+	void initBundles(DecodeState &state);
+
+	/** Initialize the Huffman decoders. */
+	void initHuffman();
+
+	/** Read the whole packet into memory. */
+	void readPacket(Common::SeekableReadStream &data);
+	/** Open a decoding state onto the current packet, at this bit offset. */
+	void openPacket(DecodeState &state, size_t offset);
+
+	/** Decode all planes, one after the other, learning what the offset values mean. */
+	void decodeSequential();
+	/** Try to decode parts of the planes in parallel. Return false if not possible. */
+	bool decodeParallel();
+
+	/** Decode a part of the planes, not letting any exceptions escape. */
+	void decodePart(DecodeState &state, Part &part);
+	/** Decode a range of planes. Return false if the packet ended early. */
+	bool decodePlanes(DecodeState &state, size_t firstPlane, size_t endPlane,
+	                  std::vector<size_t> *planeStarts = 0, std::vector<uint32> *values = 0);
+
+	/** Figure out where the plane an offset value points to starts. */
+	static size_t getOffsetTarget(OffsetType type, size_t valuePos, uint32 value);
+
+	/** Convert rows of the YUVA planes into the BGRA surface. */
+	void convertRows(Graphics::Surface *surface, uint32 row, uint32 rowCount);
+	/** Convert the YUVA planes into the BGRA surface. */
+	void convert(Graphics::Surface &surface);
+
+	/** Decode a plane. */
+	void decodePlane(DecodeState &state, int planeIdx, bool isChroma);
+
+	/** Read/Initialize a bundle for decoding a plane. */
+	void readBundle(DecodeState &state, Source source);
+
+	/** Read the symbols for a Huffman code. */
+	void readHuffman(DecodeState &state, Huffman &huffman);
+	/** Merge two Huffman symbol lists. */
+	void mergeHuffmanSymbols(DecodeState &state, byte *dst, const byte *src, int size);
+
+	/** Read and translate a symbol out of a Huffman code. */
+	byte getHuffmanSymbol(DecodeState &state, Huffman &huffman);
+
+	/** Get a direct value out of a bundle. */
+	int32 getBundleValue(DecodeState &state, Source source);
+	/** Read a count value out of a bundle. */
+	uint32 readBundleCount(DecodeState &state, Bundle &bundle);
+
+	// Handle the block types
+	void blockSkip         (DecodeContext &ctx);
+	void blockScaledSkip   (DecodeContext &ctx);
+	void blockScaledRun    (DecodeContext &ctx);
+	void blockScaledIntra  (DecodeContext &ctx);
+	void blockScaledFill   (DecodeContext &ctx);
+	void blockScaledPattern(DecodeContext &ctx);
+	void blockScaledRaw    (DecodeContext &ctx);
+	void blockScaled       (DecodeContext &ctx);
+	void blockMotion       (DecodeContext &ctx);
+	void blockRun          (DecodeContext &ctx);
+	void blockResidue      (DecodeContext &ctx);
+	void blockIntra        (DecodeContext &ctx);
+	void blockFill         (DecodeContext &ctx);
+	void blockInter        (DecodeContext &ctx);
+	void blockPattern      (DecodeContext &ctx);
+	void blockRaw          (DecodeContext &ctx);
+
+	// Read the bundles
+	void readRuns        (DecodeState &state, Bundle &bundle);
+	void readMotionValues(DecodeState &state, Bundle &bundle);
+	void readBlockTypes  (DecodeState &state, Bundle &bundle);
+	void readPatterns    (DecodeState &state, Bundle &bundle);
+	void readColors      (DecodeState &state, Bundle &bundle);
+	void readDCS         (DecodeState &state, Bundle &bundle, int startBits, bool hasSign);
+	void readDCTCoeffs   (DecodeState &state, int16 *block, bool isIntra);
+	void readResidue     (DecodeState &state, int16 *block, int masksCount);
+};
+
+} // End of namespace Video
+
+#endif // VIDEO_CODECS_BINKVIDEO_H
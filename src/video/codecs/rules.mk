@@ -24,12 +24,17 @@ src_video_codecs_libcodecs_la_SOURCES =
 
 src_video_codecs_libcodecs_la_SOURCES += \
     src/video/codecs/codec.h \
+    src/video/codecs/binkdata.h \
+    src/video/codecs/binkvideo.h \
+    src/video/codecs/binkdsp.h \
     src/video/codecs/wmv2data.h \
     src/video/codecs/xmvwmv2.h \
     $(EMPTY)
 
 src_video_codecs_libcodecs_la_SOURCES += \
     src/video/codecs/codec.cpp \
+    src/video/codecs/binkvideo.cpp \
+    src/video/codecs/binkdsp.cpp \
     src/video/codecs/wmv2data.cpp \
     src/video/codecs/xmvwmv2.cpp \
     $(EMPTY)
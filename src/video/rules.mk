@@ -25,7 +25,6 @@ src_video_libvideo_la_SOURCES =
 src_video_libvideo_la_SOURCES += \
     src/video/decoder.h \
     src/video/bink.h \
-    src/video/binkdata.h \
     src/video/fader.h \
     src/video/quicktime.h \
     src/video/xmv.h \
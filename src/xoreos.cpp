@@ -65,6 +65,7 @@
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/cursorman.h"
 #include "src/graphics/aurora/fontman.h"
+#include "src/graphics/aurora/modelprototype.h"
 
 static void initPlatform();
 static void initConfig();
@@ -321,6 +322,7 @@ static void deinit() {
 	Graphics::Aurora::FontManager::destroy();
 	Graphics::Aurora::CursorManager::destroy();
 	Graphics::Aurora::TextureManager::destroy();
+	Graphics::Aurora::ModelPrototypeManager::destroy();
 
 	Aurora::LanguageManager::destroy();
 	Aurora::TalkManager::destroy();
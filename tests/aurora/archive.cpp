@@ -0,0 +1,222 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for concurrently reading resources out of archives.
+ */
+
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/ustring.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/readfile.h"
+#include "src/common/mappedfile.h"
+#include "src/common/platform.h"
+#include "src/common/thread.h"
+#include "src/common/mutex.h"
+
+#include "src/aurora/erfwriter.h"
+#include "src/aurora/erffile.h"
+
+static const size_t kResourceCount = 32;
+static const size_t kThreadCount   =  8;
+static const size_t kPassCount     = 64;
+
+static size_t getResourceSize(size_t index) {
+	return 1000 + index * 37;
+}
+
+static byte getResourceByte(size_t index, size_t pos) {
+	return (byte) ((index * 7 + pos) & 0xFF);
+}
+
+/** Create an ERF archive containing kResourceCount resources with distinct contents. */
+static void createERF(std::vector<byte> &data) {
+	Common::MemoryWriteStreamDynamic writeStream(true);
+	Aurora::ERFWriter erfWriter(MKTAG('E', 'R', 'F', ' '), kResourceCount, writeStream);
+
+	for (size_t i = 0; i < kResourceCount; i++) {
+		std::vector<byte> resData(getResourceSize(i));
+		for (size_t j = 0; j < resData.size(); j++)
+			resData[j] = getResourceByte(i, j);
+
+		Common::MemoryReadStream resStream(&resData[0], resData.size());
+		erfWriter.add(Common::UString::format("resource%02u", (uint) i), Aurora::kFileTypeTXT, resStream);
+	}
+
+	data.assign(writeStream.getData(), writeStream.getData() + writeStream.size());
+}
+
+/** A thread reading all resources of an archive over and over, checking their contents. */
+class ReadThread : public Common::Thread {
+public:
+	ReadThread(const Aurora::Archive &archive, size_t start, Common::Semaphore &done) :
+		_archive(&archive), _start(start), _done(&done), _errors(0) {
+	}
+
+	size_t getErrors() const {
+		return _errors;
+	}
+
+private:
+	const Aurora::Archive *_archive;
+	size_t _start;
+
+	Common::Semaphore *_done;
+
+	size_t _errors;
+
+	void threadMethod() {
+		for (size_t pass = 0; pass < kPassCount; pass++) {
+			for (size_t n = 0; n < kResourceCount; n++) {
+				const size_t index = (_start + n) % kResourceCount;
+
+				try {
+					Common::ScopedPtr<Common::SeekableReadStream> stream(_archive->getResource(index, (pass % 2) == 0));
+
+					if (!checkResource(index, *stream))
+						_errors++;
+
+				} catch (...) {
+					_errors++;
+				}
+			}
+		}
+
+		_done->unlock();
+	}
+
+	static bool checkResource(size_t index, Common::SeekableReadStream &stream) {
+		if (stream.size() != getResourceSize(index))
+			return false;
+
+		std::vector<byte> data(stream.size());
+		if (stream.read(&data[0], data.size()) != data.size())
+			return false;
+
+		for (size_t j = 0; j < data.size(); j++)
+			if (data[j] != getResourceByte(index, j))
+				return false;
+
+		return true;
+	}
+};
+
+/** Read all resources of the archive from several threads at once and count the errors. */
+static size_t readConcurrently(const Aurora::Archive &archive) {
+	Common::Semaphore done;
+
+	Common::PtrVector<ReadThread> threads;
+	for (size_t i = 0; i < kThreadCount; i++)
+		threads.push_back(new ReadThread(archive, i * (kResourceCount / kThreadCount), done));
+
+	for (size_t i = 0; i < kThreadCount; i++)
+		if (!threads[i]->createThread(Common::UString::format("ReadThread%u", (uint) i)))
+			return kThreadCount * kPassCount * kResourceCount;
+
+	for (size_t i = 0; i < kThreadCount; i++)
+		done.lock();
+
+	size_t errors = 0;
+	for (size_t i = 0; i < kThreadCount; i++) {
+		threads[i]->destroyThread();
+
+		errors += threads[i]->getErrors();
+	}
+
+	return errors;
+}
+
+/** Write the data into a temporary file. */
+static boost::filesystem::path createTemporaryFile(const std::vector<byte> &data) {
+	boost::filesystem::path tmpPath    = boost::filesystem::temp_directory_path();
+	boost::filesystem::path uniquePath = boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+	const boost::filesystem::path filePath = tmpPath / uniquePath;
+
+	boost::filesystem::ofstream file(filePath, std::ofstream::binary);
+
+	file.write(reinterpret_cast<const char *>(&data[0]), data.size());
+	file.close();
+
+	return filePath;
+}
+
+GTEST_TEST(ArchiveConcurrency, memoryStream) {
+	std::vector<byte> data;
+	createERF(data);
+
+	const Aurora::ERFFile erf(new Common::MemoryReadStream(&data[0], data.size()));
+	ASSERT_EQ(erf.getResources().size(), kResourceCount);
+
+	EXPECT_EQ(readConcurrently(erf), 0);
+}
+
+GTEST_TEST(ArchiveConcurrency, readFile) {
+	std::vector<byte> data;
+	createERF(data);
+
+	const boost::filesystem::path filePath = createTemporaryFile(data);
+
+	size_t errors = 0;
+	{
+		const Aurora::ERFFile erf(new Common::ReadFile(filePath.generic_string()));
+		ASSERT_EQ(erf.getResources().size(), kResourceCount);
+
+		errors = readConcurrently(erf);
+	}
+
+	boost::filesystem::remove(filePath);
+
+	EXPECT_EQ(errors, 0);
+}
+
+GTEST_TEST(ArchiveConcurrency, mappedFile) {
+	Common::Platform::init();
+
+	if (!Common::MappedFile::isSupported())
+		return;
+
+	std::vector<byte> data;
+	createERF(data);
+
+	const boost::filesystem::path filePath = createTemporaryFile(data);
+
+	size_t errors = 0;
+	{
+		const Aurora::ERFFile erf(new Common::MappedReadStream(filePath.generic_string()));
+		ASSERT_EQ(erf.getResources().size(), kResourceCount);
+
+		errors = readConcurrently(erf);
+	}
+
+	boost::filesystem::remove(filePath);
+
+	EXPECT_EQ(errors, 0);
+}
@@ -0,0 +1,360 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the persistent cache of archive resource tables.
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+
+#include "src/aurora/indexcache.h"
+
+static const Aurora::IndexCache::Entry *kNoEntry = 0;
+
+static const byte kData[] = "foobarquux";
+
+static Aurora::IndexCache::Entry makeEntry(const Common::UString &path) {
+	Aurora::IndexCache::Entry entry;
+
+	entry.path             = path;
+	entry.size             = 2342;
+	entry.modificationTime = 1500000000;
+
+	entry.dataFiles.resize(2);
+
+	entry.dataFiles[0].path             = path;
+	entry.dataFiles[0].size             = sizeof(kData);
+	entry.dataFiles[0].modificationTime = 1500000001;
+	entry.dataFiles[0].hashAlgo         = Common::kHashNone;
+
+	entry.dataFiles[0].resources.resize(2);
+
+	entry.dataFiles[0].resources[0].name   = "foo";
+	entry.dataFiles[0].resources[0].type   = Aurora::kFileTypeTXT;
+	entry.dataFiles[0].resources[0].index  = 0;
+	entry.dataFiles[0].resources[0].offset = 0;
+	entry.dataFiles[0].resources[0].size   = 3;
+
+	entry.dataFiles[0].resources[1].name   = "quux";
+	entry.dataFiles[0].resources[1].type   = Aurora::kFileType2DA;
+	entry.dataFiles[0].resources[1].index  = 2;
+	entry.dataFiles[0].resources[1].offset = 6;
+	entry.dataFiles[0].resources[1].size   = 4;
+
+	entry.dataFiles[1].path             = path + ".data";
+	entry.dataFiles[1].size             = 4223;
+	entry.dataFiles[1].modificationTime = 1500000002;
+	entry.dataFiles[1].hashAlgo         = Common::kHashFNV64;
+
+	entry.dataFiles[1].resources.resize(1);
+
+	entry.dataFiles[1].resources[0].name   = "foo";
+	entry.dataFiles[1].resources[0].hash   = 0x0123456789ABCDEFULL;
+	entry.dataFiles[1].resources[0].type   = Aurora::kFileTypeBMP;
+	entry.dataFiles[1].resources[0].index  = 1;
+	entry.dataFiles[1].resources[0].offset = 1000;
+	entry.dataFiles[1].resources[0].size   = 200;
+
+	return entry;
+}
+
+static void compareEntries(const Aurora::IndexCache::Entry &a, const Aurora::IndexCache::Entry &b) {
+	EXPECT_EQ(a.path, b.path);
+	EXPECT_EQ(a.size, b.size);
+	EXPECT_EQ(a.modificationTime, b.modificationTime);
+
+	ASSERT_EQ(a.dataFiles.size(), b.dataFiles.size());
+	for (size_t i = 0; i < a.dataFiles.size(); i++) {
+		const Aurora::IndexCache::DataFile &fileA = a.dataFiles[i];
+		const Aurora::IndexCache::DataFile &fileB = b.dataFiles[i];
+
+		EXPECT_EQ(fileA.path, fileB.path) << "At data file " << i;
+		EXPECT_EQ(fileA.size, fileB.size) << "At data file " << i;
+		EXPECT_EQ(fileA.modificationTime, fileB.modificationTime) << "At data file " << i;
+		EXPECT_EQ(fileA.hashAlgo, fileB.hashAlgo) << "At data file " << i;
+
+		ASSERT_EQ(fileA.resources.size(), fileB.resources.size()) << "At data file " << i;
+		for (size_t j = 0; j < fileA.resources.size(); j++) {
+			const Aurora::IndexCache::Resource &resA = fileA.resources[j];
+			const Aurora::IndexCache::Resource &resB = fileB.resources[j];
+
+			EXPECT_EQ(resA.name, resB.name) << "At resource " << i << "." << j;
+			EXPECT_EQ(resA.hash, resB.hash) << "At resource " << i << "." << j;
+			EXPECT_EQ(resA.type, resB.type) << "At resource " << i << "." << j;
+			EXPECT_EQ(resA.index, resB.index) << "At resource " << i << "." << j;
+			EXPECT_EQ(resA.offset, resB.offset) << "At resource " << i << "." << j;
+			EXPECT_EQ(resA.size, resB.size) << "At resource " << i << "." << j;
+		}
+	}
+}
+
+static Common::MemoryReadStream *saveCache(const Aurora::IndexCache &cache) {
+	Common::MemoryWriteStreamDynamic stream(false);
+
+	cache.save(stream);
+
+	return new Common::MemoryReadStream(stream.getData(), stream.size(), true);
+}
+
+GTEST_TEST(IndexCache, empty) {
+	Aurora::IndexCache cache;
+
+	EXPECT_TRUE(cache.empty());
+	EXPECT_EQ(cache.size(), 0);
+	EXPECT_FALSE(cache.isModified());
+
+	EXPECT_EQ(cache.find("/foo/bar.key"), kNoEntry);
+}
+
+GTEST_TEST(IndexCache, add) {
+	Aurora::IndexCache cache;
+
+	cache.add(makeEntry("/foo/bar.key"));
+	cache.add(makeEntry("/foo/quux.erf"));
+
+	EXPECT_FALSE(cache.empty());
+	EXPECT_EQ(cache.size(), 2);
+	EXPECT_TRUE(cache.isModified());
+
+	const Aurora::IndexCache::Entry *entry = cache.find("/foo/bar.key");
+	ASSERT_NE(entry, kNoEntry);
+	compareEntries(*entry, makeEntry("/foo/bar.key"));
+
+	EXPECT_NE(cache.find("/foo/quux.erf"), kNoEntry);
+	EXPECT_EQ(cache.find("/foo/foobar.rim"), kNoEntry);
+
+	// Replace an entry
+	Aurora::IndexCache::Entry changed = makeEntry("/foo/bar.key");
+	changed.size = 42;
+
+	cache.add(changed);
+	EXPECT_EQ(cache.size(), 2);
+
+	entry = cache.find("/foo/bar.key");
+	ASSERT_NE(entry, kNoEntry);
+	EXPECT_EQ(entry->size, 42);
+
+	cache.remove("/foo/bar.key");
+	EXPECT_EQ(cache.size(), 1);
+	EXPECT_EQ(cache.find("/foo/bar.key"), kNoEntry);
+
+	cache.clear();
+	EXPECT_TRUE(cache.empty());
+	EXPECT_FALSE(cache.isModified());
+}
+
+GTEST_TEST(IndexCache, saveLoad) {
+	Aurora::IndexCache cache1;
+
+	cache1.add(makeEntry("/foo/bar.key"));
+	cache1.add(makeEntry("/foo/quux.erf"));
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(saveCache(cache1));
+
+	Aurora::IndexCache cache2;
+	cache2.load(*stream);
+
+	EXPECT_EQ(cache2.size(), 2);
+	EXPECT_FALSE(cache2.isModified());
+
+	const Aurora::IndexCache::Entry *entry1 = cache2.find("/foo/bar.key");
+	ASSERT_NE(entry1, kNoEntry);
+	compareEntries(*entry1, makeEntry("/foo/bar.key"));
+
+	const Aurora::IndexCache::Entry *entry2 = cache2.find("/foo/quux.erf");
+	ASSERT_NE(entry2, kNoEntry);
+	compareEntries(*entry2, makeEntry("/foo/quux.erf"));
+}
+
+GTEST_TEST(IndexCache, saveLoadEmpty) {
+	Aurora::IndexCache cache1;
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(saveCache(cache1));
+
+	Aurora::IndexCache cache2;
+	cache2.add(makeEntry("/foo/bar.key"));
+
+	cache2.load(*stream);
+	EXPECT_TRUE(cache2.empty());
+}
+
+GTEST_TEST(IndexCache, loadInvalid) {
+	Aurora::IndexCache cache1;
+	cache1.add(makeEntry("/foo/bar.key"));
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(saveCache(cache1));
+
+	const size_t size = stream->size();
+	Common::ScopedArray<byte> data(new byte[size]);
+
+	std::memcpy(data.get(), stream->getData(), size);
+
+	Aurora::IndexCache cache2;
+
+	// Wrong ID
+	data[0] = 'Y';
+	Common::MemoryReadStream wrongID(data.get(), size);
+	EXPECT_THROW(cache2.load(wrongID), Common::Exception);
+	data[0] = 'X';
+
+	// Wrong version
+	data[5] = '2';
+	Common::MemoryReadStream wrongVersion(data.get(), size);
+	EXPECT_THROW(cache2.load(wrongVersion), Common::Exception);
+	data[5] = '1';
+
+	// Cut off
+	Common::MemoryReadStream truncated(data.get(), size - 1);
+	EXPECT_THROW(cache2.load(truncated), Common::Exception);
+
+	// Too many resources
+	data[16] = 0xFF;
+	Common::MemoryReadStream resourceCount(data.get(), size);
+	EXPECT_THROW(cache2.load(resourceCount), Common::Exception);
+	data[16] = 3;
+
+	// Unterminated string table
+	data[size - 1] = 'x';
+	Common::MemoryReadStream strings(data.get(), size);
+	EXPECT_THROW(cache2.load(strings), Common::Exception);
+	data[size - 1] = '\0';
+
+	EXPECT_TRUE(cache2.empty());
+
+	// And the fixed up data can be read again
+	Common::MemoryReadStream fixed(data.get(), size);
+	cache2.load(fixed);
+
+	const Aurora::IndexCache::Entry *entry = cache2.find("/foo/bar.key");
+	ASSERT_NE(entry, kNoEntry);
+	compareEntries(*entry, makeEntry("/foo/bar.key"));
+}
+
+GTEST_TEST(IndexCache, loadResourceOutOfRange) {
+	Aurora::IndexCache cache1;
+
+	Aurora::IndexCache::Entry entry = makeEntry("/foo/bar.key");
+	entry.dataFiles[0].resources[1].size = 6;
+
+	cache1.add(entry);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(saveCache(cache1));
+
+	Aurora::IndexCache cache2;
+	EXPECT_THROW(cache2.load(*stream), Common::Exception);
+}
+
+GTEST_TEST(IndexCache, loadIndexOutOfRange) {
+	Aurora::IndexCache cache1;
+
+	// Way more resources than any archive could hold
+	Aurora::IndexCache::Entry entry = makeEntry("/foo/bar.key");
+	entry.dataFiles[0].resources[1].index = 0x7FFFFFFF;
+
+	cache1.add(entry);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(saveCache(cache1));
+
+	Aurora::IndexCache cache2;
+	EXPECT_THROW(cache2.load(*stream), Common::Exception);
+}
+
+GTEST_TEST(IndexCache, loadInvalidHashAlgo) {
+	Aurora::IndexCache cache1;
+
+	Aurora::IndexCache::Entry entry = makeEntry("/foo/bar.key");
+	entry.dataFiles[1].hashAlgo = (Common::HashAlgo) 23;
+
+	cache1.add(entry);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(saveCache(cache1));
+
+	Aurora::IndexCache cache2;
+	EXPECT_THROW(cache2.load(*stream), Common::Exception);
+}
+
+GTEST_TEST(CachedArchive, getResources) {
+	const Aurora::IndexCache::Entry entry = makeEntry("/foo/bar.rim");
+
+	const Aurora::CachedArchive archive(new Common::MemoryReadStream(kData), entry.dataFiles[0]);
+
+	EXPECT_EQ(archive.getNameHashAlgo(), Common::kHashNone);
+
+	const Aurora::Archive::ResourceList &resources = archive.getResources();
+	ASSERT_EQ(resources.size(), 2);
+
+	Aurora::Archive::ResourceList::const_iterator res = resources.begin();
+
+	EXPECT_STREQ(res->name.c_str(), "foo");
+	EXPECT_EQ(res->type, Aurora::kFileTypeTXT);
+	EXPECT_EQ(res->index, 0);
+	++res;
+
+	EXPECT_STREQ(res->name.c_str(), "quux");
+	EXPECT_EQ(res->type, Aurora::kFileType2DA);
+	EXPECT_EQ(res->index, 2);
+	++res;
+
+	EXPECT_EQ(archive.findResource("quux", Aurora::kFileType2DA), 2);
+}
+
+GTEST_TEST(CachedArchive, getResource) {
+	const Aurora::IndexCache::Entry entry = makeEntry("/foo/bar.rim");
+
+	const Aurora::CachedArchive archive(new Common::MemoryReadStream(kData), entry.dataFiles[0]);
+
+	EXPECT_EQ(archive.getResourceSize(0), 3);
+	EXPECT_EQ(archive.getResourceSize(2), 4);
+
+	for (int noCopy = 0; noCopy < 2; noCopy++) {
+		Common::ScopedPtr<Common::SeekableReadStream> foo(archive.getResource(0, noCopy != 0));
+		ASSERT_EQ(foo->size(), 3);
+
+		byte fooData[3];
+		ASSERT_EQ(foo->read(fooData, 3), 3);
+		EXPECT_EQ(std::memcmp(fooData, "foo", 3), 0);
+
+		Common::ScopedPtr<Common::SeekableReadStream> quux(archive.getResource(2, noCopy != 0));
+		ASSERT_EQ(quux->size(), 4);
+
+		byte quuxData[4];
+		ASSERT_EQ(quux->read(quuxData, 4), 4);
+		EXPECT_EQ(std::memcmp(quuxData, "quux", 4), 0);
+	}
+
+	// Index 1 is not a resource in this data file
+	EXPECT_THROW(archive.getResource(1), Common::Exception);
+	EXPECT_THROW(archive.getResource(3), Common::Exception);
+}
+
+GTEST_TEST(CachedArchive, changedSize) {
+	const Aurora::IndexCache::Entry entry = makeEntry("/foo/bar.rim");
+
+	EXPECT_THROW(Aurora::CachedArchive archive(new Common::MemoryReadStream(kData, 5), entry.dataFiles[0]),
+	             Common::Exception);
+}
@@ -0,0 +1,244 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our NCSFile class.
+ */
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+
+#include "src/aurora/nwscript/ncsfile.h"
+#include "src/aurora/nwscript/variable.h"
+#include "src/aurora/nwscript/functioncontext.h"
+#include "src/aurora/nwscript/functionman.h"
+
+// Sum up the numbers from 1 to 10, in a loop
+static const byte kNCSLoop[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x5B,
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x00,             // 0x0D: CONST 0
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x0A,             // 0x13: CONST 10
+	0x03, 0x01, 0xFF, 0xFF, 0xFF, 0xFC, 0x00, 0x04, // 0x19: CPTOPSP -4, 4
+	0x1F, 0x00, 0x00, 0x00, 0x00, 0x32,             // 0x21: JZ 0x53
+	0x03, 0x01, 0xFF, 0xFF, 0xFF, 0xFC, 0x00, 0x04, // 0x27: CPTOPSP -4, 4
+	0x03, 0x01, 0xFF, 0xFF, 0xFF, 0xF4, 0x00, 0x04, // 0x2F: CPTOPSP -12, 4
+	0x14, 0x20,                                     // 0x37: ADDII
+	0x01, 0x01, 0xFF, 0xFF, 0xFF, 0xF4, 0x00, 0x04, // 0x39: CPDOWNSP -12, 4
+	0x1B, 0x00, 0xFF, 0xFF, 0xFF, 0xFC,             // 0x41: MOVSP -4
+	0x23, 0x03, 0xFF, 0xFF, 0xFF, 0xFC,             // 0x47: DECSP -4
+	0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xCC,             // 0x4D: JMP 0x19
+	0x1B, 0x00, 0xFF, 0xFF, 0xFF, 0xFC,             // 0x53: MOVSP -4
+	0x20, 0x00                                      // 0x59: RETN
+};
+
+// Call a subroutine multiplying two numbers
+static const byte kNCSSubroutine[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x25,
+	0x1E, 0x00, 0x00, 0x00, 0x00, 0x08, // 0x0D: JSR 0x15
+	0x20, 0x00,                         // 0x13: RETN
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x06, // 0x15: CONST 6
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x07, // 0x1B: CONST 7
+	0x16, 0x20,                         // 0x21: MULII
+	0x20, 0x00                          // 0x23: RETN
+};
+
+// Compare two string constants
+static const byte kNCSString[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x1D,
+	0x04, 0x05, 0x00, 0x03, 0x66, 0x6F, 0x6F, // 0x0D: CONST "foo"
+	0x04, 0x05, 0x00, 0x03, 0x66, 0x6F, 0x6F, // 0x14: CONST "foo"
+	0x0B, 0x23                                // 0x1B: EQUALSS
+};
+
+// Add two float constants
+static const byte kNCSFloat[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x1B,
+	0x04, 0x04, 0x3F, 0xC0, 0x00, 0x00, // 0x0D: CONST 1.5
+	0x04, 0x04, 0x40, 0x00, 0x00, 0x00, // 0x13: CONST 2.0
+	0x14, 0x21                          // 0x19: ADDFF
+};
+
+// A script with an illegal instruction that's never reached
+static const byte kNCSIllegalUnreached[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x17,
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x05, // 0x0D: CONST 5
+	0x20, 0x00,                         // 0x13: RETN
+	0xFF, 0x00                          // 0x15: Illegal
+};
+
+// A script starting with an illegal instruction
+static const byte kNCSIllegal[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x0F,
+	0xFF, 0x00 // 0x0D: Illegal
+};
+
+// A script with a truncated instruction at the end
+static const byte kNCSTruncated[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x17,
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x05, // 0x0D: CONST 5
+	0x1D, 0x00, 0x00, 0x00              // 0x13: JMP, missing two bytes
+};
+
+// A script jumping into the middle of an instruction
+static const byte kNCSJumpInvalid[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x13,
+	0x1D, 0x00, 0x00, 0x00, 0x00, 0x03 // 0x0D: JMP 0x10
+};
+
+// Call the same engine function three times, through a subroutine
+static const byte kNCSAction[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x2E,
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x20, // 0x0D: CONST 32
+	0x1E, 0x00, 0x00, 0x00, 0x00, 0x14, // 0x13: JSR 0x27
+	0x1E, 0x00, 0x00, 0x00, 0x00, 0x0E, // 0x19: JSR 0x27
+	0x1E, 0x00, 0x00, 0x00, 0x00, 0x08, // 0x1F: JSR 0x27
+	0x20, 0x00,                         // 0x25: RETN
+	0x05, 0x00, 0x00, 0x00, 0x01,       // 0x27: ACTION 0, 1
+	0x20, 0x00                          // 0x2C: RETN
+};
+
+static std::vector<int32> actionArguments;
+
+/** int add(int a, int b = 10): returns a + b if a < 50, and scribbles over b. */
+static void actionAdd(Aurora::NWScript::FunctionContext &ctx) {
+	const int32 a = ctx.getParams()[0].getInt();
+	const int32 b = ctx.getParams()[1].getInt();
+
+	actionArguments.push_back(a);
+	actionArguments.push_back(b);
+
+	if (a < 50)
+		ctx.getReturn() = a + b;
+
+	ctx.getParams()[1] = 0;
+}
+
+static void registerAdd() {
+	Aurora::NWScript::Signature signature;
+	signature.push_back(Aurora::NWScript::kTypeInt);
+	signature.push_back(Aurora::NWScript::kTypeInt);
+	signature.push_back(Aurora::NWScript::kTypeInt);
+
+	Aurora::NWScript::Parameters defaults;
+	defaults.push_back(Aurora::NWScript::Variable((int32) 10));
+
+	FunctionMan.registerFunction("Add", 0, &actionAdd, signature, defaults);
+}
+
+template<size_t N>
+static const Aurora::NWScript::Variable run(const byte (&data)[N], uint32 offset = 13) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(data));
+
+	Aurora::NWScript::ScriptState state = Aurora::NWScript::NCSFile::getEmptyState();
+	state.offset = offset;
+
+	return ncs.run(state, (Aurora::NWScript::Object *) 0);
+}
+
+GTEST_TEST(NCSFile, loop) {
+	const Aurora::NWScript::Variable result = run(kNCSLoop);
+
+	ASSERT_EQ(result.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(result.getInt(), 55);
+}
+
+GTEST_TEST(NCSFile, subroutine) {
+	const Aurora::NWScript::Variable result = run(kNCSSubroutine);
+
+	ASSERT_EQ(result.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(result.getInt(), 42);
+}
+
+GTEST_TEST(NCSFile, runState) {
+	const Aurora::NWScript::Variable result = run(kNCSSubroutine, 0x15);
+
+	ASSERT_EQ(result.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(result.getInt(), 42);
+
+	EXPECT_THROW(run(kNCSSubroutine, 0x16), Common::Exception);
+}
+
+GTEST_TEST(NCSFile, constString) {
+	const Aurora::NWScript::Variable result = run(kNCSString);
+
+	ASSERT_EQ(result.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(result.getInt(), 1);
+}
+
+GTEST_TEST(NCSFile, constFloat) {
+	const Aurora::NWScript::Variable result = run(kNCSFloat);
+
+	ASSERT_EQ(result.getType(), Aurora::NWScript::kTypeFloat);
+	EXPECT_FLOAT_EQ(result.getFloat(), 3.5f);
+}
+
+GTEST_TEST(NCSFile, illegal) {
+	const Aurora::NWScript::Variable result = run(kNCSIllegalUnreached);
+
+	ASSERT_EQ(result.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(result.getInt(), 5);
+
+	EXPECT_THROW(run(kNCSIllegal), Common::Exception);
+	EXPECT_THROW(run(kNCSTruncated), Common::Exception);
+	EXPECT_THROW(run(kNCSJumpInvalid), Common::Exception);
+}
+
+GTEST_TEST(NCSFile, action) {
+	registerAdd();
+	actionArguments.clear();
+
+	const Aurora::NWScript::Variable result = run(kNCSAction);
+
+	// The reused context has to start out fresh for every call
+	ASSERT_EQ(actionArguments.size(), 6);
+	EXPECT_EQ(actionArguments[0], 32);
+	EXPECT_EQ(actionArguments[1], 10);
+	EXPECT_EQ(actionArguments[2], 42);
+	EXPECT_EQ(actionArguments[3], 10);
+	EXPECT_EQ(actionArguments[4], 52);
+	EXPECT_EQ(actionArguments[5], 10);
+
+	ASSERT_EQ(result.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(result.getInt(), 0);
+
+	FunctionMan.clear();
+}
+
+GTEST_TEST(NCSFile, actionUnknown) {
+	EXPECT_THROW(run(kNCSAction), Common::Exception);
+
+	// Functions are looked up when the script is loaded
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSAction));
+
+	registerAdd();
+	actionArguments.clear();
+
+	const Aurora::NWScript::Variable result = ncs.run((Aurora::NWScript::Object *) 0);
+
+	EXPECT_EQ(actionArguments.size(), 6);
+
+	ASSERT_EQ(result.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(result.getInt(), 0);
+
+	FunctionMan.clear();
+}
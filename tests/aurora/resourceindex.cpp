@@ -0,0 +1,193 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the flat resource hash index.
+ */
+
+#include <map>
+
+#include "gtest/gtest.h"
+
+#include "src/aurora/resourceindex.h"
+
+static const Aurora::ResourceIndex::Entry *kNoEntry = 0;
+
+GTEST_TEST(ResourceIndex, empty) {
+	Aurora::ResourceIndex index;
+
+	EXPECT_TRUE(index.empty());
+	EXPECT_EQ(index.size(), 0);
+	EXPECT_TRUE(index.begin() == index.end());
+
+	size_t count;
+	EXPECT_EQ(index.find(23, count), kNoEntry);
+	EXPECT_EQ(count, 0);
+
+	EXPECT_EQ(index.findTop(23), kNoEntry);
+	EXPECT_FALSE(index.remove(23, 0));
+}
+
+GTEST_TEST(ResourceIndex, add) {
+	Aurora::ResourceIndex index;
+
+	index.add(23, 0, 10);
+	index.add(42, 1, 10);
+
+	EXPECT_FALSE(index.empty());
+	EXPECT_EQ(index.size(), 2);
+
+	const Aurora::ResourceIndex::Entry *entry = index.findTop(23);
+	ASSERT_NE(entry, kNoEntry);
+
+	EXPECT_EQ(entry->id, 0);
+	EXPECT_EQ(entry->priority, 10);
+
+	entry = index.findTop(42);
+	ASSERT_NE(entry, kNoEntry);
+
+	EXPECT_EQ(entry->id, 1);
+	EXPECT_EQ(entry->priority, 10);
+
+	EXPECT_EQ(index.findTop(5), kNoEntry);
+}
+
+GTEST_TEST(ResourceIndex, priority) {
+	Aurora::ResourceIndex index;
+
+	index.add(23, 0, 10);
+	index.add(23, 1, 30);
+	index.add(23, 2, 20);
+	index.add(23, 3, 10);
+	index.add(23, 4,  5);
+
+	EXPECT_EQ(index.size(), 1);
+
+	size_t count;
+	const Aurora::ResourceIndex::Entry *entries = index.find(23, count);
+	ASSERT_NE(entries, kNoEntry);
+	ASSERT_EQ(count, 5);
+
+	// Sorted by priority, the last added one of the same priority last
+	EXPECT_EQ(entries[0].id, 4);
+	EXPECT_EQ(entries[1].id, 0);
+	EXPECT_EQ(entries[2].id, 3);
+	EXPECT_EQ(entries[3].id, 2);
+	EXPECT_EQ(entries[4].id, 1);
+
+	EXPECT_EQ(index.findTop(23)->id, 1);
+}
+
+GTEST_TEST(ResourceIndex, remove) {
+	Aurora::ResourceIndex index;
+
+	index.add(23, 0, 10);
+	index.add(23, 1, 30);
+	index.add(23, 2, 20);
+	index.add(42, 3, 10);
+
+	EXPECT_FALSE(index.remove(23, 3));
+	EXPECT_FALSE(index.remove(5, 0));
+
+	EXPECT_TRUE(index.remove(23, 1));
+	EXPECT_EQ(index.findTop(23)->id, 2);
+
+	EXPECT_TRUE(index.remove(23, 2));
+	EXPECT_EQ(index.findTop(23)->id, 0);
+
+	EXPECT_TRUE(index.remove(23, 0));
+	EXPECT_EQ(index.findTop(23), kNoEntry);
+
+	EXPECT_EQ(index.size(), 1);
+	EXPECT_EQ(index.findTop(42)->id, 3);
+}
+
+GTEST_TEST(ResourceIndex, iterate) {
+	Aurora::ResourceIndex index;
+
+	index.add(23, 0, 10);
+	index.add(42, 1, 10);
+	index.add(42, 2, 20);
+
+	std::map<uint64, size_t> found;
+	for (Aurora::ResourceIndex::const_iterator it = index.begin(); it != index.end(); ++it) {
+		size_t count;
+		ASSERT_NE(it.getEntries(count), kNoEntry);
+
+		found[it.getHash()] = count;
+	}
+
+	ASSERT_EQ(found.size(), 2);
+	EXPECT_EQ(found[23], 1);
+	EXPECT_EQ(found[42], 2);
+}
+
+GTEST_TEST(ResourceIndex, many) {
+	Aurora::ResourceIndex index;
+
+	// Lots of hashes, with only the lower bits differing, forcing collisions and growth
+	for (uint32 i = 0; i < 10000; i++) {
+		index.add(i, i, 1);
+
+		if ((i % 3) == 0)
+			index.add(i, i + 10000, 2);
+	}
+
+	EXPECT_EQ(index.size(), 10000);
+
+	// Remove every other hash entirely
+	for (uint32 i = 0; i < 10000; i += 2) {
+		EXPECT_TRUE(index.remove(i, i));
+
+		if ((i % 3) == 0) {
+			EXPECT_TRUE(index.remove(i, i + 10000));
+		}
+	}
+
+	EXPECT_EQ(index.size(), 5000);
+
+	for (uint32 i = 0; i < 10000; i++) {
+		const Aurora::ResourceIndex::Entry *entry = index.findTop(i);
+
+		if ((i % 2) == 0) {
+			EXPECT_EQ(entry, kNoEntry);
+			continue;
+		}
+
+		ASSERT_NE(entry, kNoEntry);
+		EXPECT_EQ(entry->id, ((i % 3) == 0) ? (i + 10000) : i);
+	}
+}
+
+GTEST_TEST(ResourceIndex, clear) {
+	Aurora::ResourceIndex index;
+
+	index.add(23, 0, 10);
+	index.add(23, 1, 10);
+	index.add(23, 2, 10);
+
+	index.clear();
+
+	EXPECT_TRUE(index.empty());
+	EXPECT_EQ(index.findTop(23), kNoEntry);
+
+	index.add(23, 3, 10);
+	EXPECT_EQ(index.findTop(23)->id, 3);
+}
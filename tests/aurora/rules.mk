@@ -184,3 +184,23 @@ check_PROGRAMS                                 += tests/aurora/test_thewitchersa
 tests_aurora_test_thewitchersavewriter_SOURCES  = tests/aurora/thewitchersavewriter.cpp
 tests_aurora_test_thewitchersavewriter_LDADD    = $(aurora_LIBS)
 tests_aurora_test_thewitchersavewriter_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                          += tests/aurora/test_resourceindex
+tests_aurora_test_resourceindex_SOURCES  = tests/aurora/resourceindex.cpp
+tests_aurora_test_resourceindex_LDADD    = $(aurora_LIBS)
+tests_aurora_test_resourceindex_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/aurora/test_indexcache
+tests_aurora_test_indexcache_SOURCES  = tests/aurora/indexcache.cpp
+tests_aurora_test_indexcache_LDADD    = $(aurora_LIBS)
+tests_aurora_test_indexcache_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                    += tests/aurora/test_archive
+tests_aurora_test_archive_SOURCES  = tests/aurora/archive.cpp
+tests_aurora_test_archive_LDADD    = $(aurora_LIBS)
+tests_aurora_test_archive_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                    += tests/aurora/test_ncsfile
+tests_aurora_test_ncsfile_SOURCES  = tests/aurora/ncsfile.cpp
+tests_aurora_test_ncsfile_LDADD    = $(aurora_LIBS)
+tests_aurora_test_ncsfile_CXXFLAGS = $(test_CXXFLAGS)
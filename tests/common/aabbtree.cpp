@@ -0,0 +1,224 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our dynamic AABB tree.
+ */
+
+#include <cmath>
+
+#include <vector>
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/aabbtree.h"
+#include "src/common/boundingbox.h"
+
+/** A simple deterministic pseudo-random number generator. */
+class Random {
+public:
+	Random(uint32 seed) : _seed(seed) {
+	}
+
+	/** Return a random float in [min, max]. */
+	float get(float min, float max) {
+		_seed = _seed * 1103515245 + 12345;
+
+		return min + (max - min) * (((_seed >> 8) & 0xFFFF) / 65535.0f);
+	}
+
+	glm::vec3 getVector(float min, float max) {
+		const float x = get(min, max);
+		const float y = get(min, max);
+		const float z = get(min, max);
+
+		return glm::vec3(x, y, z);
+	}
+
+private:
+	uint32 _seed;
+};
+
+struct Object {
+	glm::vec3 min;
+	glm::vec3 max;
+
+	uint32 proxy;
+};
+
+static void randomBox(Random &random, Object &object) {
+	object.min = random.getVector(-100.0f, 100.0f);
+	object.max = object.min + random.getVector(0.1f, 5.0f);
+}
+
+/** Does the line intersect the box? Checked with the separate implementation in BoundingBox. */
+static bool intersects(const glm::vec3 &from, const glm::vec3 &to, const Object &object) {
+	Common::BoundingBox box;
+
+	box.add(object.min.x, object.min.y, object.min.z);
+	box.add(object.max.x, object.max.y, object.max.z);
+
+	return box.isIn(from.x, from.y, from.z, to.x, to.y, to.z);
+}
+
+GTEST_TEST(AABBTree, empty) {
+	Common::AABBTree tree;
+
+	EXPECT_EQ(tree.size(), 0);
+	EXPECT_EQ(tree.getHeight(), 0);
+
+	std::vector<Common::AABBTree::Hit> hits;
+	tree.findLine(glm::vec3(0.0f), glm::vec3(1.0f), hits);
+
+	EXPECT_TRUE(hits.empty());
+}
+
+GTEST_TEST(AABBTree, findLineOrder) {
+	Common::AABBTree tree;
+
+	int objects[3];
+
+	tree.insert(glm::vec3( 5.0f, -1.0f, -1.0f), glm::vec3( 6.0f, 1.0f, 1.0f), &objects[0]);
+	tree.insert(glm::vec3( 1.0f, -1.0f, -1.0f), glm::vec3( 2.0f, 1.0f, 1.0f), &objects[1]);
+	tree.insert(glm::vec3( 3.0f,  2.0f, -1.0f), glm::vec3( 4.0f, 3.0f, 1.0f), &objects[2]);
+
+	EXPECT_EQ(tree.size(), 3);
+
+	std::vector<Common::AABBTree::Hit> hits;
+	tree.findLine(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(10.0f, 0.0f, 0.0f), hits);
+
+	ASSERT_EQ(hits.size(), 2);
+
+	EXPECT_EQ(hits[0].data, &objects[1]);
+	EXPECT_FLOAT_EQ(hits[0].distance, 0.1f);
+
+	EXPECT_EQ(hits[1].data, &objects[0]);
+	EXPECT_FLOAT_EQ(hits[1].distance, 0.5f);
+
+	// Starting within a box
+	tree.findLine(glm::vec3(1.5f, 0.0f, 0.0f), glm::vec3(-10.0f, 0.0f, 0.0f), hits);
+
+	ASSERT_EQ(hits.size(), 1);
+
+	EXPECT_EQ(hits[0].data, &objects[1]);
+	EXPECT_FLOAT_EQ(hits[0].distance, 0.0f);
+}
+
+GTEST_TEST(AABBTree, update) {
+	Common::AABBTree tree(0.5f);
+
+	int object;
+	const uint32 proxy = tree.insert(glm::vec3(0.0f), glm::vec3(1.0f), &object);
+
+	EXPECT_EQ(tree.getData(proxy), &object);
+
+	// Moving a bit stays within the fat box
+	EXPECT_FALSE(tree.update(proxy, glm::vec3(0.25f), glm::vec3(1.25f)));
+
+	std::vector<Common::AABBTree::Hit> hits;
+
+	// The exact box is used for the intersection, not the fat box
+	tree.findLine(glm::vec3(0.1f, 0.5f, 0.5f), glm::vec3(0.2f, 0.5f, 0.5f), hits);
+	EXPECT_TRUE(hits.empty());
+
+	EXPECT_TRUE(tree.update(proxy, glm::vec3(10.0f), glm::vec3(11.0f)));
+
+	tree.findLine(glm::vec3(0.0f), glm::vec3(20.0f), hits);
+	ASSERT_EQ(hits.size(), 1);
+	EXPECT_EQ(hits[0].data, &object);
+
+	tree.remove(proxy);
+	EXPECT_EQ(tree.size(), 0);
+
+	tree.findLine(glm::vec3(0.0f), glm::vec3(20.0f), hits);
+	EXPECT_TRUE(hits.empty());
+}
+
+GTEST_TEST(AABBTree, random) {
+	Random random(0);
+
+	Common::AABBTree tree;
+
+	std::vector<Object> objects(2000);
+	for (size_t i = 0; i < objects.size(); i++) {
+		randomBox(random, objects[i]);
+
+		objects[i].proxy = tree.insert(objects[i].min, objects[i].max, &objects[i]);
+	}
+
+	size_t hitCount = 0;
+	for (size_t round = 0; round < 4; round++) {
+		// Move, remove and re-add some of the objects
+		for (size_t i = 0; i < objects.size(); i++) {
+			if ((i % 5) == 0) {
+				const glm::vec3 offset = random.getVector(-0.3f, 0.3f);
+
+				objects[i].min += offset;
+				objects[i].max += offset;
+
+				tree.update(objects[i].proxy, objects[i].min, objects[i].max);
+
+			} else if ((i % 7) == round) {
+				randomBox(random, objects[i]);
+
+				tree.update(objects[i].proxy, objects[i].min, objects[i].max);
+
+			} else if ((i % 11) == round) {
+				tree.remove(objects[i].proxy);
+
+				randomBox(random, objects[i]);
+				objects[i].proxy = tree.insert(objects[i].min, objects[i].max, &objects[i]);
+			}
+		}
+
+		EXPECT_EQ(tree.size(), objects.size());
+
+		// The tree should stay balanced
+		EXPECT_LE(tree.getHeight(), 4 * std::log2(objects.size()));
+
+		for (int i = 0; i < 200; i++) {
+			const glm::vec3 from = random.getVector(-120.0f, 120.0f);
+			const glm::vec3 to   = random.getVector(-120.0f, 120.0f);
+
+			std::vector<Common::AABBTree::Hit> hits;
+			tree.findLine(from, to, hits);
+
+			std::set<const Object *> found;
+			for (size_t j = 0; j < hits.size(); j++) {
+				found.insert(static_cast<const Object *>(hits[j].data));
+
+				if (j > 0) {
+					EXPECT_LE(hits[j - 1].distance, hits[j].distance);
+				}
+			}
+
+			EXPECT_EQ(found.size(), hits.size());
+			hitCount += hits.size();
+
+			for (size_t j = 0; j < objects.size(); j++)
+				EXPECT_EQ(found.count(&objects[j]) != 0, intersects(from, to, objects[j])) << "Object " << j;
+		}
+	}
+
+	// Make sure we actually found something
+	EXPECT_GT(hitCount, 0U);
+}
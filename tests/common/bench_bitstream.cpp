@@ -0,0 +1,223 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmark for our bit stream readers.
+ */
+
+#include <cstdio>
+
+#include <vector>
+#include <chrono>
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/ustring.h"
+#include "src/common/huffman.h"
+#include "src/common/bitstream.h"
+#include "src/common/memreadstream.h"
+
+#include "src/sound/decoders/wmadata.h"
+#include "src/video/codecs/binkdata.h"
+
+static const size_t kDataSize    = 4 * 1024 * 1024;
+static const size_t kSymbolCount = 1000000;
+
+static uint32 nextRandom(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+
+	return seed >> 8;
+}
+
+/** A mix of reads, peeks and skips, the way the decoders use a bit stream. */
+template<class Stream>
+static uint32 readMixed(Stream &bits, const std::vector<uint8> &counts) {
+	uint32 checksum = 0;
+
+	for (std::vector<uint8>::const_iterator c = counts.begin(); c != counts.end(); ++c) {
+		switch (*c & 3) {
+			case 0:
+				checksum += bits.getBit();
+				break;
+
+			case 1:
+				checksum += bits.peekBits(*c >> 2);
+				bits.skip(*c >> 3);
+				break;
+
+			default:
+				checksum += bits.getBits(*c >> 2);
+				break;
+		}
+	}
+
+	return checksum;
+}
+
+template<class Stream>
+static uint32 readSymbols(Stream &bits, const Common::Huffman &huffman) {
+	uint32 checksum = 0;
+
+	for (size_t i = 0; i < kSymbolCount; i++)
+		checksum += huffman.getSymbol(bits);
+
+	return checksum;
+}
+
+template<class Function>
+static double measure(Function function, uint32 &checksum) {
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	checksum = function();
+
+	const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+	return time.count();
+}
+
+static bool report(const char *name, double streamTime, double memoryTime,
+                   uint32 streamChecksum, uint32 memoryChecksum, size_t count, const char *unit) {
+
+	std::printf("%-20s: stream %8.2f, memory %8.2f %s/s (%5.2fx)\n",
+	            name, count / streamTime / 1000000.0, count / memoryTime / 1000000.0, unit,
+	            streamTime / memoryTime);
+
+	if (streamChecksum != memoryChecksum) {
+		std::fprintf(stderr, "%s: Read values differ\n", name);
+		return false;
+	}
+
+	return true;
+}
+
+/** Read the same random operations with the stream-based and the memory bit stream. */
+template<class Stream, class MemoryStream>
+static bool benchmarkMixed(const char *name) {
+	std::vector<byte> data(kDataSize);
+
+	uint32 seed = 0x1234;
+	for (size_t i = 0; i < data.size(); i++)
+		data[i] = nextRandom(seed);
+
+	// Bit counts of up to 24 bits, in total fitting well into the data
+	std::vector<uint8> counts;
+	for (size_t bits = 0; (bits + 32) < (kDataSize * 4); ) {
+		const uint8 count = nextRandom(seed) % 25;
+
+		counts.push_back((count << 2) | (nextRandom(seed) & 3));
+		bits += count;
+	}
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+
+	Stream       streamBits(stream);
+	MemoryStream memoryBits(&data[0], data.size());
+
+	// Before, the decoders read through the virtual BitStream interface
+	Common::BitStream &virtualBits = streamBits;
+
+	uint32 streamChecksum = 0, memoryChecksum = 0;
+
+	const double streamTime = measure([&]() { return readMixed(virtualBits, counts); }, streamChecksum);
+	const double memoryTime = measure([&]() { return readMixed(memoryBits , counts); }, memoryChecksum);
+
+	return report(name, streamTime, memoryTime, streamChecksum, memoryChecksum, counts.size(), "MOps");
+}
+
+/** Write a code, in the order a byte-wise bit stream will read it. */
+static void writeCode(std::vector<byte> &data, size_t &pos, uint32 code, uint8 length, bool msbFirst) {
+	for (uint8 i = 0; i < length; i++, pos++) {
+		const uint32 bit = msbFirst ? ((code >> (length - 1 - i)) & 1) : ((code >> i) & 1);
+
+		if ((pos / 8) >= data.size())
+			data.push_back(0);
+
+		if (bit)
+			data[pos / 8] |= msbFirst ? (0x80 >> (pos % 8)) : (1 << (pos % 8));
+	}
+}
+
+/** Decode the same random Huffman symbols with the stream-based and the memory bit stream. */
+template<class Stream, class MemoryStream>
+static bool benchmarkHuffman(const char *name, size_t codeCount,
+                             const uint32 *codes, const uint8 *lengths, bool msbFirst) {
+
+	std::vector<byte> data;
+	size_t size = 0;
+
+	uint32 seed = codeCount;
+	for (size_t i = 0; i < kSymbolCount; i++) {
+		const size_t symbol = nextRandom(seed) % codeCount;
+
+		writeCode(data, size, codes[symbol], lengths[symbol], msbFirst);
+	}
+
+	// Padding, so that the 32-bit streams can read the last value
+	data.resize(data.size() + 4, 0);
+
+	const Common::Huffman huffman(0, codeCount, codes, lengths);
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+
+	Stream       streamBits(stream);
+	MemoryStream memoryBits(&data[0], data.size());
+
+	Common::BitStream &virtualBits = streamBits;
+
+	uint32 streamChecksum = 0, memoryChecksum = 0;
+
+	const double streamTime = measure([&]() { return readSymbols(virtualBits, huffman); }, streamChecksum);
+	const double memoryTime = measure([&]() { return readSymbols(memoryBits , huffman); }, memoryChecksum);
+
+	return report(name, streamTime, memoryTime, streamChecksum, memoryChecksum, kSymbolCount, "MSymbols");
+}
+
+int main() {
+	try {
+		bool success = true;
+
+		success = benchmarkMixed<Common::BitStream8MSB   , Common::MemoryBitStream8MSB   >("8MSB (WMA)")    && success;
+		success = benchmarkMixed<Common::BitStream32LELSB, Common::MemoryBitStream32LELSB>("32LELSB (Bink)") && success;
+		success = benchmarkMixed<Common::BitStream32LEMSB, Common::MemoryBitStream32LEMSB>("32LEMSB (WMV2)") && success;
+
+		for (size_t i = 0; i < ARRAYSIZE(binkHuffmanCodes); i += 4) {
+			const Common::UString name = Common::UString::format("Bink Huffman %u", (uint)i);
+
+			success = benchmarkHuffman<Common::BitStream32LELSB, Common::MemoryBitStream32LELSB>(name.c_str(), 16,
+			          binkHuffmanCodes[i], binkHuffmanLengths[i], false) && success;
+		}
+
+		for (size_t i = 0; i < ARRAYSIZE(Sound::coefHuffmanParam); i += 2) {
+			const Sound::WMACoefHuffmanParam &param = Sound::coefHuffmanParam[i];
+			const Common::UString name = Common::UString::format("WMA coef %u", (uint)i);
+
+			success = benchmarkHuffman<Common::BitStream8MSB, Common::MemoryBitStream8MSB>(name.c_str(), param.n,
+			          param.huffCodes, param.huffBits, true) && success;
+		}
+
+		return success ? 0 : 1;
+
+	} catch (...) {
+		Common::exceptionDispatcherError();
+	}
+
+	return 1;
+}
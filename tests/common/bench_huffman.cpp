@@ -0,0 +1,184 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmark for our Huffman decoder.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+#include <list>
+#include <chrono>
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/ustring.h"
+#include "src/common/huffman.h"
+#include "src/common/bitstream.h"
+#include "src/common/memreadstream.h"
+
+#include "src/sound/decoders/wmadata.h"
+#include "src/video/codecs/binkdata.h"
+
+static const size_t kSymbolCount = 1000000;
+
+/** The way we used to decode Huffman codes: bit by bit, searching through all codes of that length. */
+class LinearHuffman {
+public:
+	LinearHuffman(uint8 maxLength, size_t codeCount, const uint32 *codes, const uint8 *lengths) {
+		_codes.resize(maxLength);
+
+		for (size_t i = 0; i < codeCount; i++)
+			_codes[lengths[i] - 1].push_back(Symbol(codes[i], i));
+	}
+
+	uint32 getSymbol(Common::BitStream &bits) const {
+		uint32 code = 0;
+
+		for (size_t i = 0; i < _codes.size(); i++) {
+			bits.addBit(code, i);
+
+			for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
+				if (code == cCode->code)
+					return cCode->symbol;
+		}
+
+		throw Common::Exception("Unknown Huffman code");
+	}
+
+private:
+	struct Symbol {
+		uint32 code;
+		uint32 symbol;
+
+		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+		}
+	};
+
+	typedef std::list<Symbol> CodeList;
+
+	std::vector<CodeList> _codes;
+};
+
+/** Write a code, in the order the bit stream will read it. */
+static void writeCode(std::vector<byte> &data, size_t &pos, uint32 code, uint8 length, bool msbFirst) {
+	for (uint8 i = 0; i < length; i++, pos++) {
+		const uint32 bit = msbFirst ? ((code >> (length - 1 - i)) & 1) : ((code >> i) & 1);
+
+		if ((pos / 8) >= data.size())
+			data.push_back(0);
+
+		if (bit)
+			data[pos / 8] |= msbFirst ? (0x80 >> (pos % 8)) : (1 << (pos % 8));
+	}
+}
+
+template<class Decoder, class Stream>
+static double decode(const Decoder &decoder, const std::vector<byte> &data, uint32 &checksum) {
+	Common::MemoryReadStream stream(&data[0], data.size());
+	Stream bits(stream);
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < kSymbolCount; i++)
+		checksum += decoder.getSymbol(bits);
+
+	const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+	return time.count();
+}
+
+template<class Stream>
+static bool benchmark(const char *name, uint8 maxLength, size_t codeCount,
+                      const uint32 *codes, const uint8 *lengths, bool msbFirst) {
+
+	if (maxLength == 0)
+		for (size_t i = 0; i < codeCount; i++)
+			maxLength = MAX(maxLength, lengths[i]);
+
+	// Random symbols, encoded with the codebook
+
+	std::vector<byte> data;
+	size_t size = 0;
+
+	uint32 seed = codeCount;
+	for (size_t i = 0; i < kSymbolCount; i++) {
+		seed = seed * 1103515245 + 12345;
+
+		const size_t symbol = (seed >> 8) % codeCount;
+		writeCode(data, size, codes[symbol], lengths[symbol], msbFirst);
+	}
+
+	// Padding, so that the 32-bit streams can read the last value
+	data.resize(data.size() + 4, 0);
+
+	const LinearHuffman   linear(maxLength, codeCount, codes, lengths);
+	const Common::Huffman table (maxLength, codeCount, codes, lengths);
+
+	uint32 linearChecksum = 0, tableChecksum = 0;
+
+	const double linearTime = decode<LinearHuffman  , Stream>(linear, data, linearChecksum);
+	const double tableTime  = decode<Common::Huffman, Stream>(table , data, tableChecksum);
+
+	std::printf("%-12s: %4u codes, up to %2u bits: linear %8.2f, table %8.2f MSymbols/s (%5.2fx)\n",
+	            name, (uint)codeCount, maxLength, kSymbolCount / linearTime / 1000000.0,
+	            kSymbolCount / tableTime / 1000000.0, linearTime / tableTime);
+
+	if (linearChecksum != tableChecksum) {
+		std::fprintf(stderr, "%s: Decoded symbols differ\n", name);
+		return false;
+	}
+
+	return true;
+}
+
+int main() {
+	try {
+		bool success = true;
+
+		for (size_t i = 0; i < ARRAYSIZE(binkHuffmanCodes); i++) {
+			const Common::UString name = Common::UString::format("Bink %u", (uint)i);
+
+			success = benchmark<Common::BitStream32LELSB>(name.c_str(), binkHuffmanLengths[i][15], 16,
+			                                              binkHuffmanCodes[i], binkHuffmanLengths[i], false) && success;
+		}
+
+		for (size_t i = 0; i < ARRAYSIZE(Sound::coefHuffmanParam); i++) {
+			const Sound::WMACoefHuffmanParam &param = Sound::coefHuffmanParam[i];
+			const Common::UString name = Common::UString::format("WMA coef %u", (uint)i);
+
+			success = benchmark<Common::BitStream8MSB>(name.c_str(), 0, param.n,
+			                                           param.huffCodes, param.huffBits, true) && success;
+		}
+
+		success = benchmark<Common::BitStream8MSB>("WMA scale", 0, ARRAYSIZE(Sound::scaleHuffCodes),
+		                                           Sound::scaleHuffCodes, Sound::scaleHuffBits, true) && success;
+
+		return success ? 0 : 1;
+
+	} catch (...) {
+		Common::exceptionDispatcherError();
+	}
+
+	return 1;
+}
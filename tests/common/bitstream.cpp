@@ -192,3 +192,160 @@ GTEST_TEST(BitStream, BitStream64BELSB) {
 
 	testBitStream(bitStream, compValues);
 }
+
+GTEST_TEST(BitStream, peekBitsMSB) {
+	static const byte data[2] = { 0x12, 0x34 };
+	Common::MemoryReadStream stream(data);
+	Common::BitStream8MSB bitStream(stream);
+
+	EXPECT_EQ(bitStream.peekBits(12), 0x123);
+	EXPECT_EQ(bitStream.pos(), 0);
+
+	EXPECT_EQ(bitStream.getBits(4), 0x1);
+	EXPECT_EQ(bitStream.peekBits(4), 0x2);
+	EXPECT_EQ(bitStream.peekBits(8), 0x23);
+	EXPECT_EQ(bitStream.getBits(8), 0x23);
+
+	// Past the end, we get zeros
+	EXPECT_EQ(bitStream.peekBits(8), 0x40);
+	EXPECT_EQ(bitStream.pos(), 12);
+
+	EXPECT_EQ(bitStream.getBits(4), 0x4);
+	EXPECT_EQ(bitStream.peekBits(8), 0x00);
+}
+
+GTEST_TEST(BitStream, peekBitsLSB) {
+	static const byte data[2] = { 0x12, 0x34 };
+	Common::MemoryReadStream stream(data);
+	Common::BitStream8LSB bitStream(stream);
+
+	EXPECT_EQ(bitStream.peekBits(12), 0x412);
+	EXPECT_EQ(bitStream.pos(), 0);
+
+	EXPECT_EQ(bitStream.getBits(4), 0x2);
+	EXPECT_EQ(bitStream.peekBits(4), 0x1);
+	EXPECT_EQ(bitStream.peekBits(8), 0x41);
+	EXPECT_EQ(bitStream.getBits(8), 0x41);
+
+	// Past the end, we get zeros
+	EXPECT_EQ(bitStream.peekBits(8), 0x03);
+	EXPECT_EQ(bitStream.pos(), 12);
+
+	EXPECT_EQ(bitStream.getBits(4), 0x3);
+	EXPECT_EQ(bitStream.peekBits(8), 0x00);
+}
+
+GTEST_TEST(MemoryBitStream, MemoryBitStream8MSB) {
+	static const byte compValues[11] = { 0, 0, 0, 1, 0, 0, 1, 0, 0x03, 0x04, 0x02 };
+	static const byte data[8] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF };
+	Common::MemoryBitStream8MSB bitStream(data, sizeof(data));
+
+	testBitStream(bitStream, compValues);
+}
+
+GTEST_TEST(MemoryBitStream, MemoryBitStream32LELSB) {
+	static const byte compValues[11] = { 0, 1, 0, 0, 1, 0, 0, 0, 0x04, 0x03, 0x01 };
+	static const byte data[8] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF };
+	Common::MemoryBitStream32LELSB bitStream(data, sizeof(data));
+
+	testBitStream(bitStream, compValues);
+}
+
+GTEST_TEST(MemoryBitStream, MemoryBitStream64BELSB) {
+	static const byte compValues[11] = { 1, 1, 1, 1, 0, 1, 1, 1, 0x0D, 0x0C, 0x03 };
+	static const byte data[8] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF };
+	Common::MemoryBitStream64BELSB bitStream(data, sizeof(data));
+
+	testBitStream(bitStream, compValues);
+}
+
+GTEST_TEST(MemoryBitStream, readStream) {
+	static const byte data[4] = { 0x00, 0x12, 0x34, 0x56 };
+	Common::MemoryReadStream stream(data);
+
+	stream.skip(1);
+
+	Common::MemoryBitStream8MSB bitStream(stream);
+
+	EXPECT_EQ(bitStream.size(), 24);
+	EXPECT_EQ(bitStream.getBits(24), 0x123456);
+	EXPECT_TRUE(bitStream.eos());
+}
+
+GTEST_TEST(MemoryBitStream, eos) {
+	static const byte data[4] = { 0x12, 0x34, 0x56, 0x78 };
+	Common::MemoryBitStream16LEMSB bitStream(data, 3);
+
+	// Only whole values count
+	EXPECT_EQ(bitStream.size(), 16);
+
+	bitStream.skip(12);
+	EXPECT_EQ(bitStream.pos(), 12);
+
+	EXPECT_EQ(bitStream.peekBits(8), 0x20);
+	EXPECT_THROW(bitStream.getBits(8), Common::Exception);
+	EXPECT_THROW(bitStream.skip(8), Common::Exception);
+
+	EXPECT_EQ(bitStream.getBits(4), 0x2);
+	EXPECT_TRUE(bitStream.eos());
+	EXPECT_THROW(bitStream.getBit(), Common::Exception);
+}
+
+/** Read the same data in random steps with both bit stream implementations, comparing the results. */
+template<class Stream, class MemoryStream>
+static void compareBitStreams(uint32 seed) {
+	byte data[256];
+	for (size_t i = 0; i < ARRAYSIZE(data); i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = seed >> 16;
+	}
+
+	Common::MemoryReadStream stream(data);
+
+	Stream       bitStream1(stream);
+	MemoryStream bitStream2(data, sizeof(data));
+
+	while ((bitStream1.size() - bitStream1.pos()) > 64) {
+		seed = seed * 1103515245 + 12345;
+
+		const size_t n = ((seed >> 16) % 32) + 1;
+
+		switch ((seed >> 8) % 4) {
+			case 0:
+				ASSERT_EQ(bitStream2.getBits(n), bitStream1.getBits(n)) << "At " << bitStream1.pos();
+				break;
+
+			case 1:
+				ASSERT_EQ(bitStream2.peekBits(n), bitStream1.peekBits(n)) << "At " << bitStream1.pos();
+				break;
+
+			case 2:
+				bitStream1.skip(n * 3);
+				bitStream2.skip(n * 3);
+				break;
+
+			case 3:
+				ASSERT_EQ(bitStream2.getBit(), bitStream1.getBit()) << "At " << bitStream1.pos();
+				break;
+		}
+
+		ASSERT_EQ(bitStream2.pos(), bitStream1.pos());
+	}
+}
+
+GTEST_TEST(MemoryBitStream, compare) {
+	compareBitStreams<Common::BitStream8MSB    , Common::MemoryBitStream8MSB    >( 1);
+	compareBitStreams<Common::BitStream8LSB    , Common::MemoryBitStream8LSB    >( 2);
+	compareBitStreams<Common::BitStream16LEMSB , Common::MemoryBitStream16LEMSB >( 3);
+	compareBitStreams<Common::BitStream16LELSB , Common::MemoryBitStream16LELSB >( 4);
+	compareBitStreams<Common::BitStream16BEMSB , Common::MemoryBitStream16BEMSB >( 5);
+	compareBitStreams<Common::BitStream16BELSB , Common::MemoryBitStream16BELSB >( 6);
+	compareBitStreams<Common::BitStream32LEMSB , Common::MemoryBitStream32LEMSB >( 7);
+	compareBitStreams<Common::BitStream32LELSB , Common::MemoryBitStream32LELSB >( 8);
+	compareBitStreams<Common::BitStream32BEMSB , Common::MemoryBitStream32BEMSB >( 9);
+	compareBitStreams<Common::BitStream32BELSB , Common::MemoryBitStream32BELSB >(10);
+	compareBitStreams<Common::BitStream64LEMSB , Common::MemoryBitStream64LEMSB >(11);
+	compareBitStreams<Common::BitStream64LELSB , Common::MemoryBitStream64LELSB >(12);
+	compareBitStreams<Common::BitStream64BEMSB , Common::MemoryBitStream64BEMSB >(13);
+	compareBitStreams<Common::BitStream64BELSB , Common::MemoryBitStream64BELSB >(14);
+}
@@ -0,0 +1,101 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our view frustum.
+ */
+
+#include "gtest/gtest.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "src/common/maths.h"
+#include "src/common/frustum.h"
+
+static Common::Frustum createFrustum(const glm::mat4 &modelview = glm::mat4()) {
+	// Looking down the negative z axis, 90° field of view, 1 to 100 units deep
+	const glm::mat4 projection = glm::perspective(Common::deg2rad(90.0f), 1.0f, 1.0f, 100.0f);
+
+	Common::Frustum frustum;
+	frustum.set(projection * modelview);
+
+	return frustum;
+}
+
+GTEST_TEST(Frustum, everything) {
+	const Common::Frustum frustum;
+
+	EXPECT_TRUE(frustum.isVisible(glm::vec3(0.0f, 0.0f, 0.0f)));
+	EXPECT_TRUE(frustum.isVisible(glm::vec3(1000.0f, -1000.0f, 1000.0f)));
+	EXPECT_TRUE(frustum.isVisible(glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f)));
+}
+
+GTEST_TEST(Frustum, points) {
+	const Common::Frustum frustum = createFrustum();
+
+	EXPECT_TRUE (frustum.isVisible(glm::vec3(  0.0f,  0.0f,  -10.0f)));
+	EXPECT_TRUE (frustum.isVisible(glm::vec3(  9.0f, -9.0f,  -10.0f)));
+	EXPECT_TRUE (frustum.isVisible(glm::vec3(  0.0f,  0.0f,  -99.0f)));
+
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(  0.0f,  0.0f,   10.0f))); // Behind
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(  0.0f,  0.0f,   -0.5f))); // Before the near plane
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(  0.0f,  0.0f, -101.0f))); // After the far plane
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(-11.0f,  0.0f,  -10.0f))); // Left
+	EXPECT_FALSE(frustum.isVisible(glm::vec3( 11.0f,  0.0f,  -10.0f))); // Right
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(  0.0f, 11.0f,  -10.0f))); // Top
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(  0.0f,-11.0f,  -10.0f))); // Bottom
+}
+
+GTEST_TEST(Frustum, boxes) {
+	const Common::Frustum frustum = createFrustum();
+
+	// Fully inside
+	EXPECT_TRUE(frustum.isVisible(glm::vec3(-1.0f, -1.0f, -11.0f), glm::vec3(1.0f, 1.0f, -9.0f)));
+
+	// Crossing the left plane
+	EXPECT_TRUE(frustum.isVisible(glm::vec3(-20.0f, -1.0f, -11.0f), glm::vec3(-9.0f, 1.0f, -9.0f)));
+
+	// Containing the whole frustum
+	EXPECT_TRUE(frustum.isVisible(glm::vec3(-1000.0f), glm::vec3(1000.0f)));
+
+	// Containing the camera
+	EXPECT_TRUE(frustum.isVisible(glm::vec3(-2.0f), glm::vec3(2.0f)));
+
+	// Fully outside
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(-1.0f, -1.0f,    1.0f), glm::vec3(1.0f, 1.0f,    5.0f)));
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(12.0f, -1.0f,  -11.0f), glm::vec3(14.0f, 1.0f,  -9.0f)));
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(-1.0f, -1.0f, -120.0f), glm::vec3(1.0f, 1.0f, -110.0f)));
+}
+
+GTEST_TEST(Frustum, modelview) {
+	// Move the camera 50 units along the x axis, and turn it to look down the positive x axis
+	glm::mat4 modelview;
+	modelview = glm::rotate(modelview, Common::deg2rad(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	modelview = glm::translate(modelview, glm::vec3(-50.0f, 0.0f, 0.0f));
+
+	const Common::Frustum frustum = createFrustum(modelview);
+
+	EXPECT_TRUE (frustum.isVisible(glm::vec3( 60.0f, 0.0f,   0.0f)));
+	EXPECT_FALSE(frustum.isVisible(glm::vec3( 40.0f, 0.0f,   0.0f)));
+	EXPECT_FALSE(frustum.isVisible(glm::vec3(  0.0f, 0.0f, -10.0f)));
+
+	EXPECT_TRUE (frustum.isVisible(glm::vec3( 55.0f, -1.0f, -1.0f), glm::vec3( 65.0f, 1.0f, 1.0f)));
+	EXPECT_FALSE(frustum.isVisible(glm::vec3( 35.0f, -1.0f, -1.0f), glm::vec3( 45.0f, 1.0f, 1.0f)));
+}
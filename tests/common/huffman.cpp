@@ -22,14 +22,20 @@
  *  Unit tests for our Huffman decoder.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "src/common/huffman.h"
 #include "src/common/error.h"
 #include "src/common/util.h"
+#include "src/common/scopedptr.h"
 #include "src/common/memreadstream.h"
 #include "src/common/bitstream.h"
 
+#include "src/sound/decoders/wmadata.h"
+#include "src/video/codecs/binkdata.h"
+
 static const uint32 kCodes  [] = {  0,   4,   5,   6,   7  };
 static const uint8  kLengths[] = {  1,   3,   3,   3,   3  };
 static const uint32 kSymbols[] = { 'A', 'B', 'C', 'D', 'E' };
@@ -120,3 +126,193 @@ GTEST_TEST(Huffman, invalidSymbol) {
 
 	EXPECT_THROW(huffman.getSymbol(bitStream), Common::Exception);
 }
+
+GTEST_TEST(Huffman, getSymbolLSB) {
+	// The same codes, but with the bits read in the opposite order
+	static const uint32 kCodesLSB[] = { 0, 1, 5, 3, 7 };
+	static const byte   kHuffmanDataLSB[] = { 0xA2, 0xE6 };
+
+	Common::MemoryReadStream byteStream(kHuffmanDataLSB);
+	Common::BitStream8LSB    bitStream (byteStream);
+
+	Common::Huffman huffman(kMaxLength, ARRAYSIZE(kCodesLSB), kCodesLSB, kLengths, kSymbols);
+
+	for (size_t i = 0; i < ARRAYSIZE(kDeHuffmanDataSymbols); i++)
+		EXPECT_EQ(huffman.getSymbol(bitStream), kDeHuffmanDataSymbols[i]) << "At index " << i;
+
+	EXPECT_THROW(huffman.getSymbol(bitStream), Common::Exception);
+}
+
+GTEST_TEST(Huffman, longCodes) {
+	// Codes longer than what's looked up in one go
+	static const uint32 kLongCodes  [] = { 0, 2, 6, 0x380, 0x381, 0x1E000 };
+	static const uint8  kLongLengths[] = { 1, 2, 3,    10,    10,      17 };
+
+	// 0, 10, 110, 1110000000, 1110000001, 11110000000000000, padding
+	static const byte kLongData[] = { 0x5B, 0x80, 0xE0, 0x7C, 0x00, 0x00 };
+	static const uint32 kLongSymbols[] = { 0, 1, 2, 3, 4, 5 };
+
+	Common::MemoryReadStream byteStream(kLongData);
+	Common::BitStream8MSB    bitStream (byteStream);
+
+	Common::Huffman huffman(0, ARRAYSIZE(kLongCodes), kLongCodes, kLongLengths);
+
+	for (size_t i = 0; i < ARRAYSIZE(kLongSymbols); i++)
+		EXPECT_EQ(huffman.getSymbol(bitStream), kLongSymbols[i]) << "At index " << i;
+
+	EXPECT_EQ(bitStream.pos(), 43);
+}
+
+namespace {
+
+/** A Huffman codebook used by one of our decoders. */
+struct Codebook {
+	uint8 maxLength;
+	size_t codeCount;
+
+	const uint32 *codes;
+	const uint8  *lengths;
+};
+
+/** Write the bits of a code, in the order addBit() expects them. */
+void writeCode(std::vector<byte> &data, size_t &pos, uint32 code, uint8 length, bool msbFirst) {
+	for (uint8 i = 0; i < length; i++, pos++) {
+		const uint32 bit = msbFirst ? ((code >> (length - 1 - i)) & 1) : ((code >> i) & 1);
+
+		if ((pos / 8) >= data.size())
+			data.push_back(0);
+
+		if (bit)
+			data[pos / 8] |= msbFirst ? (0x80 >> (pos % 8)) : (1 << (pos % 8));
+	}
+}
+
+/** Read a symbol bit by bit, comparing against all codes of that length. */
+bool referenceGetSymbol(Common::BitStream &bits, const Codebook &codebook, uint32 &symbol) {
+	uint32 code = 0;
+
+	for (uint8 length = 1; length <= codebook.maxLength; length++) {
+		bits.addBit(code, length - 1);
+
+		for (size_t i = 0; i < codebook.codeCount; i++) {
+			if ((codebook.lengths[i] == length) && (codebook.codes[i] == code)) {
+				symbol = i;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+uint32 nextRandom(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+
+	return seed >> 8;
+}
+
+void testCodebook(const Codebook &codebook, bool msbFirst, uint32 seed) {
+	Common::Huffman huffman(codebook.maxLength, codebook.codeCount, codebook.codes, codebook.lengths);
+
+	// Encode random symbols and decode them again
+
+	std::vector<uint32> symbols(1000);
+	std::vector<byte> data;
+	size_t size = 0;
+
+	for (size_t i = 0; i < symbols.size(); i++) {
+		symbols[i] = nextRandom(seed) % codebook.codeCount;
+
+		writeCode(data, size, codebook.codes[symbols[i]], codebook.lengths[symbols[i]], msbFirst);
+	}
+
+	{
+		Common::MemoryReadStream byteStream(&data[0], data.size());
+		Common::ScopedPtr<Common::BitStream> bitStream;
+		if (msbFirst)
+			bitStream.reset(new Common::BitStream8MSB(byteStream));
+		else
+			bitStream.reset(new Common::BitStream8LSB(byteStream));
+
+		for (size_t i = 0; i < symbols.size(); i++)
+			ASSERT_EQ(huffman.getSymbol(*bitStream), symbols[i]) << "At index " << i;
+
+		EXPECT_EQ(bitStream->pos(), size);
+	}
+
+	// Decode random data, and compare against the reference decoder
+
+	for (std::vector<byte>::iterator d = data.begin(); d != data.end(); ++d)
+		*d = nextRandom(seed);
+
+	Common::MemoryReadStream byteStream1(&data[0], data.size()), byteStream2(&data[0], data.size());
+	Common::ScopedPtr<Common::BitStream> bitStream1, bitStream2;
+	if (msbFirst) {
+		bitStream1.reset(new Common::BitStream8MSB(byteStream1));
+		bitStream2.reset(new Common::BitStream8MSB(byteStream2));
+	} else {
+		bitStream1.reset(new Common::BitStream8LSB(byteStream1));
+		bitStream2.reset(new Common::BitStream8LSB(byteStream2));
+	}
+
+	for (size_t i = 0; ; i++) {
+		uint32 expected = 0;
+		bool valid = false;
+
+		try {
+			valid = referenceGetSymbol(*bitStream1, codebook, expected);
+		} catch (...) {
+			// The reference ran out of data
+			EXPECT_THROW(huffman.getSymbol(*bitStream2), Common::Exception) << "At index " << i;
+			break;
+		}
+
+		if (!valid) {
+			EXPECT_THROW(huffman.getSymbol(*bitStream2), Common::Exception) << "At index " << i;
+			break;
+		}
+
+		ASSERT_EQ(huffman.getSymbol(*bitStream2), expected) << "At index " << i;
+		ASSERT_EQ(bitStream2->pos(), bitStream1->pos()) << "At index " << i;
+	}
+}
+
+} // End of anonymous namespace
+
+// Bink reads its codes LSB first, WMA MSB first
+
+GTEST_TEST(Huffman, codebooksBink) {
+	for (size_t i = 0; i < ARRAYSIZE(binkHuffmanCodes); i++) {
+		const Codebook codebook = { binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i] };
+
+		SCOPED_TRACE(i);
+		testCodebook(codebook, false, i);
+	}
+}
+
+GTEST_TEST(Huffman, codebooksWMA) {
+	for (size_t i = 0; i < ARRAYSIZE(Sound::coefHuffmanParam); i++) {
+		const Sound::WMACoefHuffmanParam &param = Sound::coefHuffmanParam[i];
+
+		uint8 maxLength = 0;
+		for (int j = 0; j < param.n; j++)
+			maxLength = MAX(maxLength, param.huffBits[j]);
+
+		const Codebook codebook = { maxLength, (size_t) param.n, param.huffCodes, param.huffBits };
+
+		SCOPED_TRACE(i);
+		testCodebook(codebook, true, i);
+	}
+
+	const Codebook hgain = { 0, ARRAYSIZE(Sound::hgainHuffCodes), Sound::hgainHuffCodes, Sound::hgainHuffBits };
+	const Codebook scale = { 0, ARRAYSIZE(Sound::scaleHuffCodes), Sound::scaleHuffCodes, Sound::scaleHuffBits };
+
+	Codebook codebooks[] = { hgain, scale };
+	for (size_t i = 0; i < ARRAYSIZE(codebooks); i++) {
+		for (size_t j = 0; j < codebooks[i].codeCount; j++)
+			codebooks[i].maxLength = MAX(codebooks[i].maxLength, codebooks[i].lengths[j]);
+
+		SCOPED_TRACE(i);
+		testCodebook(codebooks[i], true, 100 + i);
+	}
+}
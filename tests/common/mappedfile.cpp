@@ -0,0 +1,137 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our memory-mapped file read stream.
+ */
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/platform.h"
+#include "src/common/mappedfile.h"
+
+static const byte kData[10] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF, 0x01, 0x23 };
+
+boost::filesystem::path kFilePath;
+
+class MappedFile : public ::testing::Test {
+protected:
+	static void SetUpTestCase() {
+		Common::Platform::init();
+
+		boost::filesystem::path tmpPath    = boost::filesystem::temp_directory_path();
+		boost::filesystem::path uniquePath = boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		kFilePath = tmpPath / uniquePath;
+
+		boost::filesystem::ofstream testFile(kFilePath, std::ofstream::binary);
+
+		testFile.write(reinterpret_cast<const char *>(kData), ARRAYSIZE(kData));
+		testFile.close();
+	}
+
+	static void TearDownTestCase() {
+		if (!kFilePath.empty())
+			boost::filesystem::remove(kFilePath);
+	}
+};
+
+GTEST_TEST_F(MappedFile, read) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	Common::MappedReadStream file(kFilePath.generic_string());
+
+	EXPECT_EQ(file.size(), ARRAYSIZE(kData));
+
+	byte readData[ARRAYSIZE(kData)];
+	EXPECT_EQ(file.read(readData, sizeof(readData)), ARRAYSIZE(readData));
+
+	for (size_t i = 0; i < ARRAYSIZE(kData); i++)
+		EXPECT_EQ(readData[i], kData[i]) << "At index " << i;
+
+	EXPECT_EQ(file.read(readData, 1), 0);
+	EXPECT_TRUE(file.eos());
+}
+
+GTEST_TEST_F(MappedFile, readStream) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream;
+
+	{
+		Common::MappedReadStream file(kFilePath.generic_string());
+
+		file.seek(2);
+		stream.reset(file.readStream(5));
+
+		EXPECT_EQ(file.pos(), 7);
+
+		// The new stream references the mapping directly
+		EXPECT_EQ(stream->getData(), file.getData() + 2);
+	}
+
+	// And still works after the original stream is gone
+	ASSERT_EQ(stream->size(), 5);
+
+	for (size_t i = 0; i < 5; i++)
+		EXPECT_EQ(stream->readByte(), kData[2 + i]) << "At index " << i;
+
+	// Streams of streams still reference the same mapping
+	stream->seek(1);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream2(stream->readStream(3));
+	ASSERT_EQ(stream2->size(), 3);
+
+	EXPECT_EQ(stream2->getData(), stream->getData() + 1);
+	EXPECT_EQ(stream2->readByte(), kData[3]);
+
+	EXPECT_THROW(stream->readStream(2), Common::Exception);
+	EXPECT_TRUE(stream->eos());
+}
+
+GTEST_TEST_F(MappedFile, subStream) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	Common::MappedReadStream file(kFilePath.generic_string());
+
+	Common::ScopedPtr<Common::MappedReadStream> stream(file.subStream(4, 8));
+	EXPECT_EQ(file.pos(), 0);
+
+	ASSERT_EQ(stream->size(), 4);
+	EXPECT_EQ(stream->getData(), file.getData() + 4);
+
+	for (size_t i = 0; i < 4; i++)
+		EXPECT_EQ(stream->readByte(), kData[4 + i]) << "At index " << i;
+
+	EXPECT_THROW(file.subStream(4, 11), Common::Exception);
+	EXPECT_THROW(file.subStream(5, 4), Common::Exception);
+}
+
+GTEST_TEST_F(MappedFile, missing) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	EXPECT_THROW(Common::MappedReadStream file(kFilePath.generic_string() + ".missing"), Common::Exception);
+}
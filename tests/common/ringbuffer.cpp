@@ -0,0 +1,162 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our lock-free ring buffer.
+ */
+
+#include <thread>
+
+#include <boost/bind.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/ringbuffer.h"
+#include "src/common/threadpool.h"
+
+static const size_t kValueCount = 100000;
+
+/** Write an increasing sequence of values, in chunks of changing sizes. */
+static void writeSequence(Common::RingBuffer<uint32> *buffer) {
+	uint32 chunk[97];
+
+	uint32 value = 0;
+	for (size_t size = 1; value < kValueCount; size = (size % ARRAYSIZE(chunk)) + 1) {
+		const size_t count = MIN<size_t>(size, kValueCount - value);
+		for (size_t i = 0; i < count; i++)
+			chunk[i] = value + i;
+
+		for (size_t written = 0; written < count; ) {
+			const size_t n = buffer->write(chunk + written, count - written);
+			if (n == 0)
+				std::this_thread::yield();
+
+			written += n;
+		}
+
+		value += count;
+	}
+}
+
+GTEST_TEST(RingBuffer, empty) {
+	Common::RingBuffer<uint32> buffer(8);
+
+	EXPECT_EQ(buffer.getCapacity(), 8);
+	EXPECT_EQ(buffer.getReadable(), 0);
+	EXPECT_EQ(buffer.getWritable(), 8);
+	EXPECT_TRUE(buffer.empty());
+
+	uint32 value;
+	EXPECT_EQ(buffer.read(&value, 1), 0);
+}
+
+GTEST_TEST(RingBuffer, readWrite) {
+	Common::RingBuffer<uint32> buffer(8);
+
+	static const uint32 kData[] = { 1, 2, 3, 4, 5 };
+	EXPECT_EQ(buffer.write(kData, ARRAYSIZE(kData)), ARRAYSIZE(kData));
+
+	EXPECT_EQ(buffer.getReadable(), 5);
+	EXPECT_EQ(buffer.getWritable(), 3);
+	EXPECT_FALSE(buffer.empty());
+
+	uint32 data[8];
+	EXPECT_EQ(buffer.read(data, 3), 3);
+
+	EXPECT_EQ(data[0], 1);
+	EXPECT_EQ(data[1], 2);
+	EXPECT_EQ(data[2], 3);
+
+	EXPECT_EQ(buffer.getReadable(), 2);
+	EXPECT_EQ(buffer.getWritable(), 6);
+}
+
+GTEST_TEST(RingBuffer, full) {
+	Common::RingBuffer<uint32> buffer(4);
+
+	static const uint32 kData[] = { 1, 2, 3, 4, 5, 6 };
+	EXPECT_EQ(buffer.write(kData, ARRAYSIZE(kData)), 4);
+	EXPECT_EQ(buffer.write(kData, ARRAYSIZE(kData)), 0);
+
+	EXPECT_EQ(buffer.getReadable(), 4);
+	EXPECT_EQ(buffer.getWritable(), 0);
+
+	uint32 data[8];
+	EXPECT_EQ(buffer.read(data, ARRAYSIZE(data)), 4);
+
+	EXPECT_EQ(data[0], 1);
+	EXPECT_EQ(data[3], 4);
+
+	EXPECT_TRUE(buffer.empty());
+}
+
+GTEST_TEST(RingBuffer, wrapAround) {
+	Common::RingBuffer<uint32> buffer(5);
+
+	uint32 value = 0, expected = 0;
+	for (size_t i = 0; i < 20; i++) {
+		uint32 data[3];
+
+		for (size_t j = 0; j < ARRAYSIZE(data); j++)
+			data[j] = value++;
+
+		ASSERT_EQ(buffer.write(data, ARRAYSIZE(data)), ARRAYSIZE(data));
+		ASSERT_EQ(buffer.read(data, ARRAYSIZE(data)), ARRAYSIZE(data));
+
+		for (size_t j = 0; j < ARRAYSIZE(data); j++)
+			EXPECT_EQ(data[j], expected++);
+	}
+}
+
+GTEST_TEST(RingBuffer, clear) {
+	Common::RingBuffer<uint32> buffer(4);
+
+	static const uint32 kData[] = { 1, 2, 3 };
+	buffer.write(kData, ARRAYSIZE(kData));
+
+	buffer.clear();
+
+	EXPECT_TRUE(buffer.empty());
+	EXPECT_EQ(buffer.getWritable(), 4);
+}
+
+GTEST_TEST(RingBuffer, threaded) {
+	Common::RingBuffer<uint32> buffer(61);
+	Common::ThreadPool pool(1);
+
+	pool.add(boost::bind(&writeSequence, &buffer));
+
+	uint32 value = 0;
+	bool inOrder = true;
+
+	uint32 data[53];
+	while (value < kValueCount) {
+		const size_t count = buffer.read(data, ARRAYSIZE(data));
+		if (count == 0)
+			std::this_thread::yield();
+
+		for (size_t i = 0; i < count; i++, value++)
+			inOrder = inOrder && (data[i] == value);
+	}
+
+	EXPECT_TRUE(pool.wait());
+	EXPECT_TRUE(inOrder);
+	EXPECT_TRUE(buffer.empty());
+}
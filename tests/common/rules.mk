@@ -246,7 +246,64 @@ tests_common_test_boundingbox_SOURCES  = tests/common/boundingbox.cpp
 tests_common_test_boundingbox_LDADD    = $(common_LIBS)
 tests_common_test_boundingbox_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                     += tests/common/test_aabbtree
+tests_common_test_aabbtree_SOURCES  = tests/common/aabbtree.cpp
+tests_common_test_aabbtree_LDADD    = $(common_LIBS)
+tests_common_test_aabbtree_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                    += tests/common/test_frustum
+tests_common_test_frustum_SOURCES  = tests/common/frustum.cpp
+tests_common_test_frustum_LDADD    = $(common_LIBS)
+tests_common_test_frustum_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                        += tests/common/test_spatialhash
+tests_common_test_spatialhash_SOURCES  = tests/common/spatialhash.cpp
+tests_common_test_spatialhash_LDADD    = $(common_LIBS)
+tests_common_test_spatialhash_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/common/test_threadpool
+tests_common_test_threadpool_SOURCES  = tests/common/threadpool.cpp
+tests_common_test_threadpool_LDADD    = $(common_LIBS)
+tests_common_test_threadpool_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/common/test_ringbuffer
+tests_common_test_ringbuffer_SOURCES  = tests/common/ringbuffer.cpp
+tests_common_test_ringbuffer_LDADD    = $(common_LIBS)
+tests_common_test_ringbuffer_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                     += tests/common/test_workpass
+tests_common_test_workpass_SOURCES  = tests/common/workpass.cpp
+tests_common_test_workpass_LDADD    = $(common_LIBS)
+tests_common_test_workpass_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                 += tests/common/test_rect
 tests_common_test_rect_SOURCES  = tests/common/rect.cpp
 tests_common_test_rect_LDADD    = $(common_LIBS)
 tests_common_test_rect_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                        += tests/common/test_stringarena
+tests_common_test_stringarena_SOURCES  = tests/common/stringarena.cpp
+tests_common_test_stringarena_LDADD    = $(common_LIBS)
+tests_common_test_stringarena_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/common/test_mappedfile
+tests_common_test_mappedfile_SOURCES  = tests/common/mappedfile.cpp
+tests_common_test_mappedfile_LDADD    = $(common_LIBS)
+tests_common_test_mappedfile_CXXFLAGS = $(test_CXXFLAGS)
+
+# Benchmarks
+
+common_BENCH_LIBS = \
+    src/common/libcommon.la \
+    tests/version/libversion.la \
+    $(LDADD)
+
+BENCHMARKS                          += tests/common/bench_huffman
+tests_common_bench_huffman_SOURCES  = tests/common/bench_huffman.cpp
+tests_common_bench_huffman_LDADD    = $(common_BENCH_LIBS)
+tests_common_bench_huffman_CXXFLAGS = $(AM_CXXFLAGS)
+
+BENCHMARKS                            += tests/common/bench_bitstream
+tests_common_bench_bitstream_SOURCES  = tests/common/bench_bitstream.cpp
+tests_common_bench_bitstream_LDADD    = $(common_BENCH_LIBS)
+tests_common_bench_bitstream_CXXFLAGS = $(AM_CXXFLAGS)
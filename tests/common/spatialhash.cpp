@@ -0,0 +1,216 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our spatial hash.
+ */
+
+#include <cfloat>
+
+#include <vector>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "src/common/spatialhash.h"
+
+/** A simple deterministic pseudo-random number generator. */
+class Random {
+public:
+	Random(uint32 seed) : _seed(seed) {
+	}
+
+	/** Return a random float in [min, max]. */
+	float get(float min, float max) {
+		_seed = _seed * 1103515245 + 12345;
+
+		return min + (max - min) * (((_seed >> 8) & 0xFFFF) / 65535.0f);
+	}
+
+private:
+	uint32 _seed;
+};
+
+struct Object {
+	float minX;
+	float minY;
+	float maxX;
+	float maxY;
+
+	uint32 proxy;
+};
+
+static void randomRect(Random &random, Object &object) {
+	object.minX = random.get(-100.0f, 100.0f);
+	object.minY = random.get(-100.0f, 100.0f);
+	object.maxX = object.minX + random.get(0.0f, 20.0f);
+	object.maxY = object.minY + random.get(0.0f, 20.0f);
+}
+
+/** Find all objects overlapping the rectangle, the brute-force way. */
+static void findBruteForce(std::vector<Object> &objects, float minX, float minY, float maxX, float maxY,
+                           std::vector<void *> &data) {
+
+	data.clear();
+
+	for (size_t i = 0; i < objects.size(); i++)
+		if ((objects[i].proxy != Common::SpatialHash::kInvalidProxy) &&
+		    (objects[i].minX <= maxX) && (objects[i].maxX >= minX) &&
+		    (objects[i].minY <= maxY) && (objects[i].maxY >= minY))
+			data.push_back(&objects[i]);
+}
+
+GTEST_TEST(SpatialHash, empty) {
+	Common::SpatialHash hash;
+
+	EXPECT_EQ(hash.size(), 0);
+
+	std::vector<void *> data;
+	hash.find(0.0f, 0.0f, data);
+
+	EXPECT_TRUE(data.empty());
+}
+
+GTEST_TEST(SpatialHash, find) {
+	Common::SpatialHash hash(4.0f);
+
+	int objects[3];
+
+	const uint32 proxy0 = hash.insert( 0.0f,  0.0f,  2.0f,  2.0f, &objects[0]);
+	const uint32 proxy1 = hash.insert(-1.0f, -1.0f, 10.0f,  1.0f, &objects[1]);
+	const uint32 proxy2 = hash.insert(20.0f, 20.0f, 21.0f, 21.0f, &objects[2]);
+
+	EXPECT_EQ(hash.size(), 3);
+
+	EXPECT_EQ(hash.getData(proxy0), &objects[0]);
+	EXPECT_EQ(hash.getData(proxy1), &objects[1]);
+	EXPECT_EQ(hash.getData(proxy2), &objects[2]);
+
+	std::vector<void *> data;
+
+	hash.find(0.5f, 0.5f, data);
+	ASSERT_EQ(data.size(), 2);
+	EXPECT_EQ(data[0], &objects[0]);
+	EXPECT_EQ(data[1], &objects[1]);
+
+	// Object 1 spans several cells, but must only be found once
+	hash.find(-5.0f, -5.0f, 15.0f, 0.0f, data);
+	ASSERT_EQ(data.size(), 2);
+	EXPECT_EQ(data[0], &objects[0]);
+	EXPECT_EQ(data[1], &objects[1]);
+
+	hash.find(9.0f, 0.5f, data);
+	ASSERT_EQ(data.size(), 1);
+	EXPECT_EQ(data[0], &objects[1]);
+
+	hash.find(20.5f, 20.5f, data);
+	ASSERT_EQ(data.size(), 1);
+	EXPECT_EQ(data[0], &objects[2]);
+
+	// In the same cell as object 2, but outside of its rectangle
+	hash.find(22.0f, 22.0f, data);
+	EXPECT_TRUE(data.empty());
+
+	// Everything
+	hash.find(-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX, data);
+	EXPECT_EQ(data.size(), 3);
+}
+
+GTEST_TEST(SpatialHash, updateRemove) {
+	Common::SpatialHash hash(4.0f);
+
+	int objects[2];
+
+	const uint32 proxy0 = hash.insert(0.0f, 0.0f, 1.0f, 1.0f, &objects[0]);
+	const uint32 proxy1 = hash.insert(0.0f, 0.0f, 1.0f, 1.0f, &objects[1]);
+
+	std::vector<void *> data;
+
+	hash.update(proxy0, 50.0f, 50.0f, 51.0f, 51.0f);
+
+	hash.find(0.5f, 0.5f, data);
+	ASSERT_EQ(data.size(), 1);
+	EXPECT_EQ(data[0], &objects[1]);
+
+	hash.find(50.5f, 50.5f, data);
+	ASSERT_EQ(data.size(), 1);
+	EXPECT_EQ(data[0], &objects[0]);
+
+	hash.remove(proxy1);
+	EXPECT_EQ(hash.size(), 1);
+
+	hash.find(0.5f, 0.5f, data);
+	EXPECT_TRUE(data.empty());
+
+	// The freed proxy is reused
+	EXPECT_EQ(hash.insert(0.0f, 0.0f, 1.0f, 1.0f, &objects[1]), proxy1);
+
+	hash.clear();
+	EXPECT_EQ(hash.size(), 0);
+
+	hash.find(50.5f, 50.5f, data);
+	EXPECT_TRUE(data.empty());
+}
+
+GTEST_TEST(SpatialHash, random) {
+	Common::SpatialHash hash(8.0f);
+	Random random(23);
+
+	std::vector<Object> objects(500);
+	for (size_t i = 0; i < objects.size(); i++) {
+		randomRect(random, objects[i]);
+
+		objects[i].proxy = hash.insert(objects[i].minX, objects[i].minY,
+		                               objects[i].maxX, objects[i].maxY, &objects[i]);
+	}
+
+	std::vector<void *> data, expected;
+
+	for (int step = 0; step < 1000; step++) {
+		Object &object = objects[(size_t) random.get(0.0f, objects.size() - 1)];
+
+		// Randomly move, remove or re-add an object
+		if (object.proxy == Common::SpatialHash::kInvalidProxy) {
+			randomRect(random, object);
+
+			object.proxy = hash.insert(object.minX, object.minY, object.maxX, object.maxY, &object);
+		} else if (random.get(0.0f, 1.0f) < 0.1f) {
+			hash.remove(object.proxy);
+
+			object.proxy = Common::SpatialHash::kInvalidProxy;
+		} else {
+			object.minX += random.get(-2.0f, 2.0f);
+			object.minY += random.get(-2.0f, 2.0f);
+			object.maxX  = object.minX + random.get(0.0f, 20.0f);
+			object.maxY  = object.minY + random.get(0.0f, 20.0f);
+
+			hash.update(object.proxy, object.minX, object.minY, object.maxX, object.maxY);
+		}
+
+		Object query;
+		randomRect(random, query);
+
+		hash.find(query.minX, query.minY, query.maxX, query.maxY, data);
+		findBruteForce(objects, query.minX, query.minY, query.maxX, query.maxY, expected);
+
+		std::sort(data.begin(), data.end());
+		ASSERT_EQ(data, expected);
+	}
+}
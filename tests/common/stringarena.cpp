@@ -0,0 +1,122 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our interned string arena.
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "src/common/stringarena.h"
+
+GTEST_TEST(StringArena, intern) {
+	Common::StringArena arena;
+
+	const char *foo = arena.intern("foo");
+	const char *bar = arena.intern(Common::UString("bar"));
+
+	EXPECT_STREQ(foo, "foo");
+	EXPECT_STREQ(bar, "bar");
+
+	EXPECT_EQ(arena.size(), 2);
+}
+
+GTEST_TEST(StringArena, deduplicate) {
+	Common::StringArena arena;
+
+	const char *foo1 = arena.intern("foo");
+	const char *foo2 = arena.intern(Common::UString("foo"));
+	const char *fooo = arena.intern("fooo");
+
+	EXPECT_EQ(foo1, foo2);
+	EXPECT_NE(foo1, fooo);
+
+	EXPECT_EQ(arena.size(), 2);
+}
+
+GTEST_TEST(StringArena, empty) {
+	Common::StringArena arena;
+
+	const char *empty1 = arena.intern("");
+	const char *empty2 = arena.intern(Common::UString());
+
+	EXPECT_STREQ(empty1, "");
+	EXPECT_EQ(empty1, empty2);
+
+	EXPECT_EQ(arena.size(), 0);
+}
+
+GTEST_TEST(StringArena, find) {
+	Common::StringArena arena;
+
+	EXPECT_EQ(arena.find("foo"), static_cast<const char *>(0));
+
+	const char *foo = arena.intern("foo");
+
+	EXPECT_EQ(arena.find("foo"), foo);
+	EXPECT_EQ(arena.find("fo") , static_cast<const char *>(0));
+	EXPECT_EQ(arena.find("bar"), static_cast<const char *>(0));
+}
+
+GTEST_TEST(StringArena, many) {
+	Common::StringArena arena(256);
+
+	std::vector<const char *> strings;
+	for (size_t i = 0; i < 5000; i++)
+		strings.push_back(arena.intern(Common::UString::format("string%u", (uint) i)));
+
+	// Also add a string that's too big for the blocks
+	const Common::UString bigString(' ', 1000);
+	const char *big = arena.intern(bigString);
+
+	EXPECT_EQ(arena.size(), 5001);
+
+	for (size_t i = 0; i < 5000; i++) {
+		const Common::UString string = Common::UString::format("string%u", (uint) i);
+
+		EXPECT_STREQ(strings[i], string.c_str());
+		EXPECT_EQ(arena.intern(string), strings[i]);
+	}
+
+	EXPECT_EQ(std::strlen(big), 1000);
+	EXPECT_EQ(arena.intern(bigString), big);
+
+	EXPECT_EQ(arena.size(), 5001);
+}
+
+GTEST_TEST(StringArena, clear) {
+	Common::StringArena arena;
+
+	arena.intern("foo");
+	arena.intern("bar");
+
+	EXPECT_GT(arena.getMemoryUsage(), 0);
+
+	arena.clear();
+
+	EXPECT_EQ(arena.size(), 0);
+	EXPECT_EQ(arena.getMemoryUsage(), 0);
+	EXPECT_EQ(arena.find("foo"), static_cast<const char *>(0));
+
+	EXPECT_STREQ(arena.intern("foo"), "foo");
+	EXPECT_EQ(arena.size(), 1);
+}
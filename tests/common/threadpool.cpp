@@ -0,0 +1,133 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our thread pool.
+ */
+
+#include <boost/bind.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/threadpool.h"
+#include "src/common/atomic.h"
+
+static void count(boost::atomic<uint32> *counter) {
+	counter->fetch_add(1);
+}
+
+static void countAndAdd(Common::ThreadPool *pool, boost::atomic<uint32> *counter, uint32 depth) {
+	counter->fetch_add(1);
+
+	if (depth > 0) {
+		pool->add(boost::bind(&countAndAdd, pool, counter, depth - 1));
+		pool->add(boost::bind(&countAndAdd, pool, counter, depth - 1));
+	}
+}
+
+static void fail() {
+	throw Common::Exception("Job failed");
+}
+
+static void block(Common::Semaphore *semaphore) {
+	semaphore->lock();
+	semaphore->unlock();
+}
+
+GTEST_TEST(ThreadPool, noThreads) {
+	Common::ThreadPool pool(0);
+
+	EXPECT_EQ(pool.getThreadCount(), 0);
+
+	boost::atomic<uint32> counter(0);
+
+	pool.add(boost::bind(&count, &counter));
+
+	// Without threads, the job is run right away
+	EXPECT_EQ(counter.load(), 1);
+	EXPECT_EQ(pool.getPendingCount(), 0);
+	EXPECT_EQ(pool.getFinishedCount(), 1);
+
+	EXPECT_TRUE(pool.wait());
+}
+
+GTEST_TEST(ThreadPool, run) {
+	Common::ThreadPool pool(4);
+
+	EXPECT_EQ(pool.getThreadCount(), 4);
+
+	boost::atomic<uint32> counter(0);
+
+	for (size_t i = 0; i < 1000; i++)
+		pool.add(boost::bind(&count, &counter));
+
+	EXPECT_TRUE(pool.wait());
+
+	EXPECT_EQ(counter.load(), 1000);
+	EXPECT_EQ(pool.getPendingCount(), 0);
+	EXPECT_EQ(pool.getFinishedCount(), 1000);
+}
+
+GTEST_TEST(ThreadPool, addFromJob) {
+	Common::ThreadPool pool(4);
+
+	boost::atomic<uint32> counter(0);
+
+	pool.add(boost::bind(&countAndAdd, &pool, &counter, 6));
+
+	EXPECT_TRUE(pool.wait());
+
+	// A full binary tree of depth 6
+	EXPECT_EQ(counter.load(), 127);
+}
+
+GTEST_TEST(ThreadPool, exception) {
+	Common::ThreadPool pool(2);
+
+	boost::atomic<uint32> counter(0);
+
+	pool.add(boost::bind(&count, &counter));
+	pool.add(&fail);
+	pool.add(boost::bind(&count, &counter));
+
+	EXPECT_THROW(pool.wait(), Common::Exception);
+
+	// The other jobs still ran
+	EXPECT_EQ(counter.load(), 2);
+
+	// The exception is only thrown once
+	EXPECT_TRUE(pool.wait());
+}
+
+GTEST_TEST(ThreadPool, timeout) {
+	Common::ThreadPool pool(1);
+
+	Common::Semaphore semaphore(0);
+
+	pool.add(boost::bind(&block, &semaphore));
+
+	EXPECT_FALSE(pool.wait(10));
+	EXPECT_EQ(pool.getPendingCount(), 1);
+
+	semaphore.unlock();
+
+	EXPECT_TRUE(pool.wait());
+	EXPECT_EQ(pool.getPendingCount(), 0);
+}
@@ -0,0 +1,131 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our work pass shared between threads.
+ */
+
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/workpass.h"
+#include "src/common/threadpool.h"
+#include "src/common/atomic.h"
+
+struct Item {
+	boost::atomic<uint32> claimed;
+
+	Item() : claimed(0) {
+	}
+};
+
+static void claimAll(Common::WorkPass<Item> *pass) {
+	Item *item = 0;
+	while (pass->claim(item))
+		item->claimed.fetch_add(1);
+}
+
+GTEST_TEST(WorkPass, empty) {
+	Common::WorkPass<Item> pass;
+
+	EXPECT_EQ(pass.size(), 0);
+	EXPECT_TRUE(pass.done());
+
+	Item *item = 0;
+	EXPECT_FALSE(pass.claim(item));
+}
+
+GTEST_TEST(WorkPass, claim) {
+	Item items[3];
+
+	Common::WorkPass<Item> pass;
+	for (size_t i = 0; i < 3; i++)
+		pass.add(&items[i]);
+
+	EXPECT_EQ(pass.size(), 3);
+	EXPECT_FALSE(pass.done());
+
+	// The items are claimed in order
+	for (size_t i = 0; i < 3; i++) {
+		Item *item = 0;
+		ASSERT_TRUE(pass.claim(item)) << "At index " << i;
+		EXPECT_EQ(item, &items[i]) << "At index " << i;
+	}
+
+	EXPECT_TRUE(pass.done());
+
+	Item *item = 0;
+	EXPECT_FALSE(pass.claim(item));
+
+	pass.clear();
+	EXPECT_EQ(pass.size(), 0);
+	EXPECT_TRUE(pass.done());
+}
+
+GTEST_TEST(WorkPass, remove) {
+	Item items[4];
+
+	Common::WorkPass<Item> pass;
+	for (size_t i = 0; i < 4; i++)
+		pass.add(&items[i]);
+
+	Item *item = 0;
+	ASSERT_TRUE(pass.claim(item));
+	EXPECT_EQ(item, &items[0]);
+
+	// Removing an item in the middle of the pass skips it, without moving the others
+	pass.remove(&items[1]);
+	pass.remove(&items[3]);
+
+	ASSERT_TRUE(pass.claim(item));
+	EXPECT_EQ(item, &items[2]);
+
+	EXPECT_FALSE(pass.claim(item));
+	EXPECT_TRUE(pass.done());
+}
+
+GTEST_TEST(WorkPass, threaded) {
+	static const size_t kItemCount   = 10000;
+	static const size_t kThreadCount = 4;
+
+	std::vector<Item> items(kItemCount);
+
+	Common::WorkPass<Item> pass;
+	for (size_t i = 0; i < kItemCount; i++)
+		pass.add(&items[i]);
+
+	// Remove every tenth item, as if it was unregistered before the pass got to it
+	for (size_t i = 0; i < kItemCount; i += 10)
+		pass.remove(&items[i]);
+
+	Common::ThreadPool pool(kThreadCount);
+	for (size_t i = 0; i < kThreadCount; i++)
+		pool.add(boost::bind(&claimAll, &pass));
+
+	EXPECT_TRUE(pool.wait());
+	EXPECT_TRUE(pass.done());
+
+	// Every item was claimed by exactly one thread
+	for (size_t i = 0; i < kItemCount; i++)
+		EXPECT_EQ(items[i].claimed.load(), ((i % 10) == 0) ? 0 : 1) << "At index " << i;
+}
@@ -0,0 +1,261 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the compiled key frame tracks and their interpolation.
+ */
+
+#include <cmath>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+
+#include "src/graphics/aurora/keyframetrack.h"
+
+/** A simple deterministic pseudo-random number generator. */
+class Random {
+public:
+	Random(uint32 seed) : _seed(seed) {
+	}
+
+	/** Return a random float in [min, max]. */
+	float get(float min, float max) {
+		_seed = _seed * 1103515245 + 12345;
+
+		return min + (max - min) * (((_seed >> 8) & 0xFFFF) / 65535.0f);
+	}
+
+private:
+	uint32 _seed;
+};
+
+/** Create a track with random, ascending key times and random values. */
+static void createTrack(Graphics::Aurora::KeyFrameTrack &track, size_t count, Random &random) {
+	float time = random.get(0.0f, 0.5f);
+
+	for (size_t i = 0; i < count; i++) {
+		track.addKeyFrame(time, random.get(-1.0f, 1.0f), random.get(-1.0f, 1.0f),
+		                        random.get(-1.0f, 1.0f), random.get(-1.0f, 1.0f));
+
+		time += random.get(0.01f, 0.5f);
+	}
+}
+
+/** Find the key frames the way the animations originally did, by walking the whole track. */
+static bool findLinear(const Graphics::Aurora::KeyFrameTrack &track, float time, size_t &frame, float &factor) {
+	frame  = 0;
+	factor = 0.0f;
+
+	if (track.size() == 1)
+		return false;
+
+	for (size_t i = 0; i < track.size(); i++) {
+		if (track.getTime(i) >= time)
+			break;
+
+		frame = i;
+	}
+
+	if (((frame + 1) >= track.size()) || (track.getTime(frame) >= time))
+		return false;
+
+	factor = (time - track.getTime(frame)) / (track.getTime(frame + 1) - track.getTime(frame));
+	return true;
+}
+
+/** Fill a batch with random interpolations between the key frames of a track. */
+static void fillBatch(Graphics::Aurora::KeyFrameBatch &batch, const Graphics::Aurora::KeyFrameTrack &track,
+                      size_t count, Random &random) {
+
+	for (size_t i = 0; i < count; i++) {
+		const size_t frame = MIN<size_t>(random.get(0.0f, track.size() - 1.0f), track.size() - 2);
+
+		batch.add(track, frame, random.get(0.0f, 1.0f), i);
+	}
+}
+
+GTEST_TEST(KeyFrameTrack, findEdges) {
+	Graphics::Aurora::KeyFrameTrack track;
+
+	track.addKeyFrame(1.0f, 1.0f, 2.0f, 3.0f);
+	track.addKeyFrame(2.0f, 4.0f, 5.0f, 6.0f);
+	track.addKeyFrame(4.0f, 7.0f, 8.0f, 9.0f);
+
+	size_t frame;
+	float factor;
+
+	EXPECT_FALSE(track.find(0.5f, frame, factor));
+	EXPECT_EQ(frame, 0);
+
+	EXPECT_FALSE(track.find(1.0f, frame, factor));
+	EXPECT_EQ(frame, 0);
+
+	EXPECT_TRUE(track.find(1.5f, frame, factor));
+	EXPECT_EQ(frame, 0);
+	EXPECT_FLOAT_EQ(factor, 0.5f);
+
+	EXPECT_TRUE(track.find(2.0f, frame, factor));
+	EXPECT_EQ(frame, 0);
+	EXPECT_FLOAT_EQ(factor, 1.0f);
+
+	EXPECT_TRUE(track.find(3.0f, frame, factor));
+	EXPECT_EQ(frame, 1);
+	EXPECT_FLOAT_EQ(factor, 0.5f);
+
+	EXPECT_TRUE(track.find(4.0f, frame, factor));
+	EXPECT_EQ(frame, 1);
+	EXPECT_FLOAT_EQ(factor, 1.0f);
+
+	EXPECT_FALSE(track.find(5.0f, frame, factor));
+	EXPECT_EQ(frame, 2);
+
+	Graphics::Aurora::KeyFrameTrack single;
+	single.addKeyFrame(1.0f, 1.0f, 2.0f, 3.0f);
+
+	EXPECT_FALSE(single.find(0.0f, frame, factor));
+	EXPECT_EQ(frame, 0);
+	EXPECT_FALSE(single.find(2.0f, frame, factor));
+	EXPECT_EQ(frame, 0);
+}
+
+GTEST_TEST(KeyFrameTrack, findMatchesLinear) {
+	Random random(23);
+
+	for (size_t size = 1; size < 40; size++) {
+		Graphics::Aurora::KeyFrameTrack track;
+		createTrack(track, size, random);
+
+		const float end = track.getTime(size - 1) + 1.0f;
+
+		for (size_t i = 0; i < 100; i++) {
+			const float time = random.get(-0.5f, end);
+
+			size_t frame1, frame2;
+			float factor1, factor2;
+
+			const bool interpolate1 = track.find(time, frame1, factor1);
+			const bool interpolate2 = findLinear(track, time, frame2, factor2);
+
+			ASSERT_EQ(interpolate1, interpolate2) << size << ": " << time;
+			ASSERT_EQ(frame1, frame2) << size << ": " << time;
+			ASSERT_EQ(factor1, factor2) << size << ": " << time;
+		}
+	}
+}
+
+GTEST_TEST(KeyFrameBatch, interpolatePositions) {
+	Random random(42);
+
+	Graphics::Aurora::KeyFrameTrack track;
+	createTrack(track, 20, random);
+
+	// A batch size that doesn't fit evenly into the SIMD lanes
+	Graphics::Aurora::KeyFrameBatch batch;
+	fillBatch(batch, track, 103, random);
+
+	batch.interpolatePositions(false);
+
+	std::vector<float> scalar;
+	for (size_t i = 0; i < batch.size(); i++)
+		for (size_t c = 0; c < 3; c++)
+			scalar.push_back(batch.getResult(i, c));
+
+	batch.interpolatePositions(true);
+
+	for (size_t i = 0; i < batch.size(); i++)
+		for (size_t c = 0; c < 3; c++)
+			ASSERT_EQ(batch.getResult(i, c), scalar[i * 3 + c]) << i << "." << c;
+
+	// Check against the interpolation the batch was filled with
+	Random check(42);
+
+	Graphics::Aurora::KeyFrameTrack checkTrack;
+	createTrack(checkTrack, 20, check);
+
+	for (size_t i = 0; i < batch.size(); i++) {
+		const size_t frame = MIN<size_t>(check.get(0.0f, checkTrack.size() - 1.0f), checkTrack.size() - 2);
+		const float factor = check.get(0.0f, 1.0f);
+
+		EXPECT_EQ(batch.getTag(i), i);
+
+		for (size_t c = 0; c < 3; c++) {
+			const float from = checkTrack.getValue(frame    , c);
+			const float to   = checkTrack.getValue(frame + 1, c);
+
+			ASSERT_NEAR(batch.getResult(i, c), from + (to - from) * factor, 1e-5f) << i << "." << c;
+		}
+	}
+}
+
+GTEST_TEST(KeyFrameBatch, interpolateOrientations) {
+	Random random(1337);
+
+	Graphics::Aurora::KeyFrameTrack track;
+	createTrack(track, 20, random);
+
+	Graphics::Aurora::KeyFrameBatch batch;
+	fillBatch(batch, track, 103, random);
+
+	batch.interpolateOrientations(false);
+
+	std::vector<float> scalar;
+	for (size_t i = 0; i < batch.size(); i++)
+		for (size_t c = 0; c < 4; c++)
+			scalar.push_back(batch.getResult(i, c));
+
+	batch.interpolateOrientations(true);
+
+	for (size_t i = 0; i < batch.size(); i++) {
+		float length = 0.0f;
+
+		for (size_t c = 0; c < 4; c++) {
+			ASSERT_EQ(batch.getResult(i, c), scalar[i * 4 + c]) << i << "." << c;
+
+			length += batch.getResult(i, c) * batch.getResult(i, c);
+		}
+
+		ASSERT_NEAR(length, 1.0f, 1e-5f) << i;
+	}
+}
+
+GTEST_TEST(KeyFrameBatch, interpolateOrientationsShorterArc) {
+	Graphics::Aurora::KeyFrameTrack track;
+
+	// The same rotation, once with a flipped sign
+	track.addKeyFrame(0.0f,  0.0f,  0.0f,  0.6f,  0.8f);
+	track.addKeyFrame(1.0f, -0.0f, -0.0f, -0.6f, -0.8f);
+
+	Graphics::Aurora::KeyFrameBatch batch;
+	for (size_t i = 0; i < 5; i++)
+		batch.add(track, 0, i * 0.25f, i);
+
+	for (size_t simd = 0; simd < 2; simd++) {
+		batch.interpolateOrientations(simd != 0);
+
+		// Going the shorter way, the rotation never changes
+		for (size_t i = 0; i < batch.size(); i++) {
+			EXPECT_NEAR(batch.getResult(i, 2), 0.6f, 1e-6f) << i;
+			EXPECT_NEAR(batch.getResult(i, 3), 0.8f, 1e-6f) << i;
+		}
+	}
+}
@@ -0,0 +1,149 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the data shared between instances of the same model.
+ */
+
+#include "gtest/gtest.h"
+
+#include "src/graphics/aurora/modelprototype.h"
+#include "src/graphics/aurora/animation.h"
+
+using Graphics::Aurora::ModelPrototype;
+using Graphics::Aurora::ModelPrototypePtr;
+using Graphics::Aurora::Animation;
+
+GTEST_TEST(ModelPrototypeManager, get) {
+	const size_t count = ModelProtoMan.getCount();
+
+	ModelPrototypePtr prototype1 = ModelProtoMan.get("foobar");
+	ASSERT_TRUE(prototype1);
+
+	EXPECT_STREQ(prototype1->getName().c_str(), "foobar");
+	EXPECT_EQ(ModelProtoMan.getCount(), count + 1);
+
+	ModelPrototypePtr prototype2 = ModelProtoMan.get("FooBar");
+	EXPECT_EQ(prototype2.get(), prototype1.get());
+	EXPECT_EQ(ModelProtoMan.getCount(), count + 1);
+
+	ModelPrototypePtr prototype3 = ModelProtoMan.get("barfoo");
+	EXPECT_NE(prototype3.get(), prototype1.get());
+	EXPECT_EQ(ModelProtoMan.getCount(), count + 2);
+}
+
+GTEST_TEST(ModelPrototypeManager, getCount) {
+	const size_t count = ModelProtoMan.getCount();
+
+	ModelPrototypePtr prototype1 = ModelProtoMan.get("foobar");
+	ModelPrototypePtr prototype2 = ModelProtoMan.get("foobar");
+	EXPECT_EQ(ModelProtoMan.getCount(), count + 1);
+
+	// The prototype stays as long as any model references it
+	prototype1.reset();
+	EXPECT_EQ(ModelProtoMan.getCount(), count + 1);
+
+	prototype2.reset();
+	EXPECT_EQ(ModelProtoMan.getCount(), count);
+}
+
+GTEST_TEST(ModelPrototypeManager, getReleased) {
+	const size_t count = ModelProtoMan.getCount();
+
+	ModelPrototype::AnimationMap animations;
+
+	ModelPrototypePtr prototype = ModelProtoMan.get("foobar");
+	prototype->setAnimations(animations);
+
+	prototype.reset();
+	EXPECT_EQ(ModelProtoMan.getCount(), count);
+
+	// Once released, the prototype is created anew, without the old data
+	prototype = ModelProtoMan.get("foobar");
+	ASSERT_TRUE(prototype);
+
+	EXPECT_FALSE(prototype->getAnimations(animations));
+	EXPECT_EQ(ModelProtoMan.getCount(), count + 1);
+}
+
+GTEST_TEST(ModelPrototype, getAnimations) {
+	ModelPrototype prototype("foobar");
+
+	ModelPrototype::AnimationMap animations;
+	EXPECT_FALSE(prototype.getAnimations(animations));
+	EXPECT_TRUE(animations.empty());
+}
+
+GTEST_TEST(ModelPrototype, setAnimations) {
+	ModelPrototype prototype("foobar");
+
+	ModelPrototype::AnimationMap animations1;
+	animations1["walk"].reset(new Animation);
+	animations1["run"].reset(new Animation);
+
+	prototype.setAnimations(animations1);
+
+	ModelPrototype::AnimationMap animations2;
+	ASSERT_TRUE(prototype.getAnimations(animations2));
+	ASSERT_EQ(animations2.size(), 2);
+
+	EXPECT_EQ(animations2["WALK"].get(), animations1["walk"].get());
+	EXPECT_EQ(animations2["Run"].get() , animations1["run"].get());
+}
+
+GTEST_TEST(ModelPrototype, setAnimationsTwice) {
+	ModelPrototype prototype("foobar");
+
+	ModelPrototype::AnimationMap animations1;
+	animations1["walk"].reset(new Animation);
+
+	prototype.setAnimations(animations1);
+
+	// Another instance read the animations at the same time
+	ModelPrototype::AnimationMap animations2;
+	animations2["walk"].reset(new Animation);
+	animations2["run"].reset(new Animation);
+
+	prototype.setAnimations(animations2);
+
+	ASSERT_EQ(animations2.size(), 1);
+	EXPECT_EQ(animations2["walk"].get(), animations1["walk"].get());
+}
+
+GTEST_TEST(ModelPrototype, animationsOutliveModel) {
+	ModelPrototype prototype("foobar");
+
+	boost::shared_ptr<Animation> animation(new Animation);
+
+	{
+		ModelPrototype::AnimationMap animations;
+		animations["walk"] = animation;
+
+		prototype.setAnimations(animations);
+	}
+
+	EXPECT_EQ(animation.use_count(), 2);
+
+	ModelPrototype::AnimationMap animations;
+	ASSERT_TRUE(prototype.getAnimations(animations));
+
+	EXPECT_EQ(animations["walk"].get(), animation.get());
+	EXPECT_EQ(animation.use_count(), 3);
+}
@@ -0,0 +1,268 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the graphics queue manager.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+
+#include "src/graphics/queueman.h"
+#include "src/graphics/queueable.h"
+
+using Graphics::QueueManager;
+
+/** A queueable object that's ordered by a simple number. */
+class TestQueueable : public Graphics::Queueable {
+public:
+	TestQueueable(int order = 0, int id = 0) : _order(order), _id(id) {
+	}
+
+	bool operator<(const Graphics::Queueable &q) const {
+		return _order < static_cast<const TestQueueable &>(q)._order;
+	}
+
+	int getOrder() const {
+		return _order;
+	}
+
+	int getID() const {
+		return _id;
+	}
+
+	void setOrder(int order) {
+		_order = order;
+	}
+
+	using Graphics::Queueable::isInQueue;
+	using Graphics::Queueable::addToQueue;
+	using Graphics::Queueable::removeFromQueue;
+	using Graphics::Queueable::sortQueue;
+
+private:
+	int _order;
+	int _id;
+};
+
+static const TestQueueable &getObject(Graphics::QueueType queue, size_t i) {
+	return *static_cast<const TestQueueable *>(QueueMan.getQueue(queue)[i]);
+}
+
+/** Is this object exactly once in the queue? */
+static bool isQueuedOnce(Graphics::QueueType queue, const TestQueueable &object) {
+	const QueueManager::Queue &q = QueueMan.getQueue(queue);
+
+	size_t count = 0;
+	for (size_t i = 0; i < q.size(); i++)
+		if (q[i] == &object)
+			count++;
+
+	return count == 1;
+}
+
+/** A simple deterministic pseudo-random number generator. */
+static int getRandom(uint32 &seed, int max) {
+	seed = seed * 1103515245 + 12345;
+
+	return ((seed >> 8) & 0xFFFF) % max;
+}
+
+GTEST_TEST(QueueManager, sortQueue) {
+	const Graphics::QueueType queue = Graphics::kQueueVisibleWorldObject;
+
+	TestQueueable objects[] = { TestQueueable(3), TestQueueable(1), TestQueueable(4), TestQueueable(1),
+	                            TestQueueable(5), TestQueueable(9), TestQueueable(2), TestQueueable(6) };
+
+	for (size_t i = 0; i < ARRAYSIZE(objects); i++)
+		objects[i].addToQueue(queue);
+
+	objects[0].sortQueue(queue);
+
+	ASSERT_EQ(QueueMan.getQueue(queue).size(), ARRAYSIZE(objects));
+	for (size_t i = 1; i < ARRAYSIZE(objects); i++)
+		EXPECT_LE(getObject(queue, i - 1).getOrder(), getObject(queue, i).getOrder()) << "At index " << i;
+
+	// Removing an object after sorting needs to find it at its new position
+	for (size_t i = 0; i < ARRAYSIZE(objects); i++) {
+		objects[i].removeFromQueue(queue);
+		EXPECT_FALSE(objects[i].isInQueue(queue));
+
+		for (size_t j = i + 1; j < ARRAYSIZE(objects); j++)
+			EXPECT_TRUE(isQueuedOnce(queue, objects[j])) << "At index " << i << ", " << j;
+	}
+
+	EXPECT_TRUE(QueueMan.isQueueEmpty(queue));
+}
+
+GTEST_TEST(QueueManager, sortQueueStable) {
+	const Graphics::QueueType queue = Graphics::kQueueVisibleWorldObject;
+
+	// Objects of equal order keep their order within the queue
+	TestQueueable objects[] = { TestQueueable(2, 0), TestQueueable(1, 1), TestQueueable(2, 2),
+	                            TestQueueable(1, 3), TestQueueable(2, 4), TestQueueable(1, 5) };
+
+	for (size_t i = 0; i < ARRAYSIZE(objects); i++)
+		objects[i].addToQueue(queue);
+
+	objects[0].sortQueue(queue);
+
+	static const int kIDs[] = { 1, 3, 5, 0, 2, 4 };
+
+	ASSERT_EQ(QueueMan.getQueue(queue).size(), ARRAYSIZE(kIDs));
+	for (size_t i = 0; i < ARRAYSIZE(kIDs); i++)
+		EXPECT_EQ(getObject(queue, i).getID(), kIDs[i]) << "At index " << i;
+
+	for (size_t i = 0; i < ARRAYSIZE(objects); i++)
+		objects[i].removeFromQueue(queue);
+}
+
+GTEST_TEST(QueueManager, sortQueueFallback) {
+	const Graphics::QueueType queue = Graphics::kQueueVisibleWorldObject;
+
+	/* A queue sorted the wrong way round needs far too many moves for the
+	 * insertion sort, and is sorted completely instead. Equal objects are
+	 * given in order, so that the result is still stable. */
+
+	std::vector<TestQueueable> objects;
+	for (int i = 0; i < 1000; i++)
+		objects.push_back(TestQueueable((999 - i) / 2, i));
+
+	for (size_t i = 0; i < objects.size(); i++)
+		objects[i].addToQueue(queue);
+
+	objects[0].sortQueue(queue);
+
+	ASSERT_EQ(QueueMan.getQueue(queue).size(), objects.size());
+	for (size_t i = 1; i < objects.size(); i++) {
+		const TestQueueable &a = getObject(queue, i - 1);
+		const TestQueueable &b = getObject(queue, i);
+
+		ASSERT_LE(a.getOrder(), b.getOrder()) << "At index " << i;
+		if (a.getOrder() == b.getOrder()) {
+			ASSERT_LT(a.getID(), b.getID()) << "At index " << i;
+		}
+	}
+
+	// All indices were updated by the full sort as well
+	for (size_t i = 0; i < objects.size(); i += 2) {
+		objects[i].removeFromQueue(queue);
+
+		ASSERT_FALSE(objects[i].isInQueue(queue));
+		if ((i + 1) < objects.size()) {
+			ASSERT_TRUE(isQueuedOnce(queue, objects[i + 1])) << "At index " << i;
+		}
+	}
+
+	ASSERT_EQ(QueueMan.getQueue(queue).size(), objects.size() / 2);
+	for (size_t i = 1; i < objects.size(); i += 2)
+		objects[i].removeFromQueue(queue);
+
+	EXPECT_TRUE(QueueMan.isQueueEmpty(queue));
+}
+
+GTEST_TEST(QueueManager, sortQueueResort) {
+	const Graphics::QueueType queue = Graphics::kQueueVisibleWorldObject;
+
+	std::vector<TestQueueable> objects;
+	for (int i = 0; i < 100; i++)
+		objects.push_back(TestQueueable(i));
+
+	for (size_t i = 0; i < objects.size(); i++)
+		objects[i].addToQueue(queue);
+
+	// Move a few objects a bit, like the camera moving
+	uint32 seed = 0;
+	for (int n = 0; n < 10; n++) {
+		for (int i = 0; i < 5; i++)
+			objects[getRandom(seed, objects.size())].setOrder(getRandom(seed, 100));
+
+		objects[0].sortQueue(queue);
+
+		ASSERT_EQ(QueueMan.getQueue(queue).size(), objects.size());
+		for (size_t i = 1; i < objects.size(); i++)
+			ASSERT_LE(getObject(queue, i - 1).getOrder(), getObject(queue, i).getOrder()) << "At index " << i;
+	}
+
+	for (size_t i = 0; i < objects.size(); i++)
+		objects[i].removeFromQueue(queue);
+
+	EXPECT_TRUE(QueueMan.isQueueEmpty(queue));
+}
+
+GTEST_TEST(QueueManager, removeFromOrderedQueue) {
+	const Graphics::QueueType queue = Graphics::kQueueVisibleWorldObject;
+
+	TestQueueable objects[] = { TestQueueable(0, 0), TestQueueable(0, 1), TestQueueable(0, 2),
+	                            TestQueueable(0, 3), TestQueueable(0, 4) };
+
+	for (size_t i = 0; i < ARRAYSIZE(objects); i++)
+		objects[i].addToQueue(queue);
+
+	objects[1].removeFromQueue(queue);
+	objects[3].removeFromQueue(queue);
+
+	// The remaining objects stay in order
+	static const int kIDs[] = { 0, 2, 4 };
+
+	ASSERT_EQ(QueueMan.getQueue(queue).size(), ARRAYSIZE(kIDs));
+	for (size_t i = 0; i < ARRAYSIZE(kIDs); i++)
+		EXPECT_EQ(getObject(queue, i).getID(), kIDs[i]) << "At index " << i;
+
+	for (size_t i = 0; i < ARRAYSIZE(objects); i++)
+		objects[i].removeFromQueue(queue);
+
+	EXPECT_TRUE(QueueMan.isQueueEmpty(queue));
+}
+
+GTEST_TEST(QueueManager, removeFromUnorderedQueue) {
+	const Graphics::QueueType queue = Graphics::kQueueWorldObject;
+
+	std::vector<TestQueueable> objects;
+	for (int i = 0; i < 100; i++)
+		objects.push_back(TestQueueable(0, i));
+
+	for (size_t i = 0; i < objects.size(); i++)
+		objects[i].addToQueue(queue);
+
+	// Remove the objects in a random order, to move around the remaining ones
+	std::vector<size_t> remaining;
+	for (size_t i = 0; i < objects.size(); i++)
+		remaining.push_back(i);
+
+	uint32 seed = 0;
+	while (!remaining.empty()) {
+		const size_t r = getRandom(seed, remaining.size());
+
+		objects[remaining[r]].removeFromQueue(queue);
+		ASSERT_FALSE(objects[remaining[r]].isInQueue(queue));
+
+		remaining.erase(remaining.begin() + r);
+
+		ASSERT_EQ(QueueMan.getQueue(queue).size(), remaining.size());
+		for (size_t i = 0; i < remaining.size(); i++)
+			ASSERT_TRUE(isQueuedOnce(queue, objects[remaining[i]])) << "At index " << i;
+	}
+
+	EXPECT_TRUE(QueueMan.isQueueEmpty(queue));
+}
@@ -0,0 +1,54 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+
+# Unit tests for the Graphics namespace.
+
+graphics_LIBS = \
+    $(test_LIBS) \
+    src/graphics/libgraphics.la \
+    src/aurora/libaurora.la \
+    src/common/libcommon.la \
+    tests/version/libversion.la \
+    $(LDADD)
+
+check_PROGRAMS                           += tests/graphics/test_walkmeshgrid
+tests_graphics_test_walkmeshgrid_SOURCES  = tests/graphics/walkmeshgrid.cpp
+tests_graphics_test_walkmeshgrid_LDADD    = $(graphics_LIBS)
+tests_graphics_test_walkmeshgrid_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                            += tests/graphics/test_keyframetrack
+tests_graphics_test_keyframetrack_SOURCES  = tests/graphics/keyframetrack.cpp
+tests_graphics_test_keyframetrack_LDADD    = $(graphics_LIBS)
+tests_graphics_test_keyframetrack_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/graphics/test_skinning
+tests_graphics_test_skinning_SOURCES  = tests/graphics/skinning.cpp
+tests_graphics_test_skinning_LDADD    = $(graphics_LIBS)
+tests_graphics_test_skinning_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                             += tests/graphics/test_modelprototype
+tests_graphics_test_modelprototype_SOURCES  = tests/graphics/modelprototype.cpp
+tests_graphics_test_modelprototype_LDADD    = $(graphics_LIBS)
+tests_graphics_test_modelprototype_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/graphics/test_queueman
+tests_graphics_test_queueman_SOURCES  = tests/graphics/queueman.cpp
+tests_graphics_test_queueman_LDADD    = $(graphics_LIBS)
+tests_graphics_test_queueman_CXXFLAGS = $(test_CXXFLAGS)
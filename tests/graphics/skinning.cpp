@@ -0,0 +1,181 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for skinning vertices with a palette of bone matrices.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "src/common/util.h"
+
+#include "src/graphics/aurora/skinning.h"
+
+/** A simple deterministic pseudo-random number generator. */
+class Random {
+public:
+	Random(uint32 seed) : _seed(seed) {
+	}
+
+	/** Return a random float in [min, max]. */
+	float get(float min, float max) {
+		_seed = _seed * 1103515245 + 12345;
+
+		return min + (max - min) * (((_seed >> 8) & 0xFFFF) / 65535.0f);
+	}
+
+private:
+	uint32 _seed;
+};
+
+/** Create a random transformation, like a bone would have. */
+static glm::mat4 createTransform(Random &random) {
+	glm::mat4 m;
+
+	m = glm::translate(m, glm::vec3(random.get(-2.0f, 2.0f), random.get(-2.0f, 2.0f), random.get(-2.0f, 2.0f)));
+	m = glm::rotate(m, random.get(-3.0f, 3.0f), glm::vec3(random.get(0.1f, 1.0f), random.get(-1.0f, 1.0f),
+	                                                      random.get(-1.0f, 1.0f)));
+
+	return m;
+}
+
+struct SkinData {
+	std::vector<float> vertices;
+	std::vector<float> boneIDs;
+	std::vector<float> boneWeights;
+
+	std::vector<glm::mat4> palette;
+};
+
+static void createSkin(SkinData &skin, size_t vertexCount, size_t boneCount, Random &random) {
+	for (size_t i = 0; i < boneCount; i++)
+		skin.palette.push_back(createTransform(random));
+
+	for (size_t i = 0; i < vertexCount; i++) {
+		for (size_t c = 0; c < 3; c++)
+			skin.vertices.push_back(random.get(-1.0f, 1.0f));
+
+		float weights[4], sum = 0.0f;
+		for (size_t j = 0; j < 4; j++)
+			sum += (weights[j] = random.get(0.0f, 1.0f));
+
+		for (size_t j = 0; j < 4; j++) {
+			// Leave some bone slots unused
+			const bool unused = random.get(0.0f, 1.0f) < 0.2f;
+
+			skin.boneIDs.push_back(unused ? -1.0f : (float) MIN<size_t>(random.get(0.0f, boneCount), boneCount - 1));
+			skin.boneWeights.push_back(weights[j] / sum);
+		}
+	}
+}
+
+static glm::vec4 transform(const glm::mat4 &m, const glm::vec4 &v) {
+	const glm::vec4 r = m * v;
+
+	return r / r.w;
+}
+
+GTEST_TEST(Skinning, matchesBoneChain) {
+	Random random(7);
+
+	/* Skin the way the animations originally did it: for each bone,
+	 * transform the vertex through the whole chain of matrices. */
+
+	const glm::mat4 bindPose    = createTransform(random);
+	const glm::mat4 invBindPose = glm::inverse(bindPose);
+
+	std::vector<glm::mat4> boneTransforms, boneInvBindPoses;
+	for (size_t i = 0; i < 16; i++) {
+		boneTransforms.push_back(createTransform(random));
+		boneInvBindPoses.push_back(glm::inverse(createTransform(random)));
+	}
+
+	SkinData skin;
+	createSkin(skin, 100, 16, random);
+
+	for (size_t i = 0; i < 16; i++)
+		skin.palette[i] = invBindPose * boneTransforms[i] * boneInvBindPoses[i] * bindPose;
+
+	std::vector<float> skinned(skin.vertices.size());
+	Graphics::Aurora::skinVertices(&skinned[0], &skin.vertices[0], &skin.boneIDs[0], &skin.boneWeights[0], 100,
+	                               &skin.palette[0], skin.palette.size());
+
+	for (size_t i = 0; i < 100; i++) {
+		const glm::vec4 v(skin.vertices[i * 3 + 0], skin.vertices[i * 3 + 1], skin.vertices[i * 3 + 2], 1.0f);
+
+		glm::vec3 expected;
+		for (size_t j = 0; j < 4; j++) {
+			const int bone = skin.boneIDs[i * 4 + j];
+			if (bone == -1)
+				continue;
+
+			glm::vec4 t = transform(bindPose, v);
+			t = transform(boneInvBindPoses[bone], t);
+			t = transform(boneTransforms[bone], t);
+			t = transform(invBindPose, t);
+
+			expected += glm::vec3(t) * skin.boneWeights[i * 4 + j];
+		}
+
+		for (size_t c = 0; c < 3; c++)
+			ASSERT_NEAR(skinned[i * 3 + c], expected[c], 1e-4f) << i << "." << c;
+	}
+}
+
+GTEST_TEST(Skinning, simdMatchesScalar) {
+	Random random(99);
+
+	SkinData skin;
+	createSkin(skin, 1000, 32, random);
+
+	std::vector<float> scalar(skin.vertices.size()), simd(skin.vertices.size());
+
+	Graphics::Aurora::skinVertices(&scalar[0], &skin.vertices[0], &skin.boneIDs[0], &skin.boneWeights[0], 1000,
+	                               &skin.palette[0], skin.palette.size(), false);
+	Graphics::Aurora::skinVertices(&simd[0], &skin.vertices[0], &skin.boneIDs[0], &skin.boneWeights[0], 1000,
+	                               &skin.palette[0], skin.palette.size(), true);
+
+	for (size_t i = 0; i < scalar.size(); i++)
+		ASSERT_EQ(simd[i], scalar[i]) << i;
+}
+
+GTEST_TEST(Skinning, ignoreMissingBones) {
+	const float vertex[3] = { 1.0f, 2.0f, 3.0f };
+
+	// One real bone, one outside the palette, one unused slot, and a negative ID
+	const float boneIDs[4]     = { 0.0f, 5.0f, -1.0f, -3.0f };
+	const float boneWeights[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+
+	const glm::mat4 palette = glm::translate(glm::mat4(), glm::vec3(2.0f, 4.0f, 6.0f));
+
+	for (size_t simd = 0; simd < 2; simd++) {
+		float skinned[3];
+		Graphics::Aurora::skinVertices(skinned, vertex, boneIDs, boneWeights, 1, &palette, 1, simd != 0);
+
+		EXPECT_FLOAT_EQ(skinned[0], 1.5f);
+		EXPECT_FLOAT_EQ(skinned[1], 3.0f);
+		EXPECT_FLOAT_EQ(skinned[2], 4.5f);
+	}
+}
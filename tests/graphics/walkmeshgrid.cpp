@@ -0,0 +1,251 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the walkmesh grid.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/maths.h"
+
+#include "src/graphics/aurora/walkmeshgrid.h"
+
+/** A simple deterministic pseudo-random number generator. */
+class Random {
+public:
+	Random(uint32 seed) : _seed(seed) {
+	}
+
+	/** Return a random float in [min, max]. */
+	float get(float min, float max) {
+		_seed = _seed * 1103515245 + 12345;
+
+		return min + (max - min) * (((_seed >> 8) & 0xFFFF) / 65535.0f);
+	}
+
+private:
+	uint32 _seed;
+};
+
+static void addVertex(std::vector<float> &vertices, float x, float y, float z) {
+	vertices.push_back(x);
+	vertices.push_back(y);
+	vertices.push_back(z);
+}
+
+static void addFace(std::vector<uint32> &indices, uint32 a, uint32 b, uint32 c) {
+	indices.push_back(a);
+	indices.push_back(b);
+	indices.push_back(c);
+}
+
+/** Create a bumpy terrain of size x size quads, each split into two faces. */
+static void createTerrain(std::vector<float> &vertices, std::vector<uint32> &indices,
+                          uint32 size, float offsetX, float offsetY, Random &random) {
+
+	const uint32 first = vertices.size() / 3;
+
+	for (uint32 y = 0; y <= size; y++)
+		for (uint32 x = 0; x <= size; x++)
+			addVertex(vertices, offsetX + x, offsetY + y, random.get(-0.5f, 0.5f));
+
+	for (uint32 y = 0; y < size; y++) {
+		for (uint32 x = 0; x < size; x++) {
+			const uint32 v = first + y * (size + 1) + x;
+
+			addFace(indices, v, v + 1, v + size + 2);
+			addFace(indices, v, v + size + 2, v + size + 1);
+		}
+	}
+}
+
+/** Create a number of random, overlapping faces of different sizes. */
+static void createSoup(std::vector<float> &vertices, std::vector<uint32> &indices,
+                       uint32 count, float extent, Random &random) {
+
+	for (uint32 i = 0; i < count; i++) {
+		const uint32 first = vertices.size() / 3;
+
+		const float x    = random.get(0.0f, extent);
+		const float y    = random.get(0.0f, extent);
+		const float z    = random.get(-10.0f, 10.0f);
+		const float size = random.get(0.1f, (i % 10) ? 3.0f : 30.0f);
+
+		for (int j = 0; j < 3; j++)
+			addVertex(vertices, x + random.get(-size, size), y + random.get(-size, size), z + random.get(-size, size));
+
+		addFace(indices, first, first + 1, first + 2);
+	}
+}
+
+/** Make sure the grid finds the same elevations and faces as the brute-force search. */
+static void compareElevation(const Graphics::Aurora::WalkmeshGrid &grid, float x, float y) {
+	uint32 gridFace = 0xFFFFFFFF, bruteFace = 0xFFFFFFFF;
+
+	const float gridZ  = grid.getElevationAt(x, y, gridFace, false);
+	const float bruteZ = grid.getElevationAt(x, y, bruteFace, true);
+
+	ASSERT_EQ(gridZ, bruteZ) << "At " << x << ", " << y;
+	if (bruteZ != FLT_MIN) {
+		ASSERT_EQ(gridFace, bruteFace) << "At " << x << ", " << y;
+	}
+}
+
+static void compareCollision(const Graphics::Aurora::WalkmeshGrid &grid, const glm::vec3 &orig, const glm::vec3 &dest) {
+	ASSERT_EQ(grid.testCollision(orig, dest, false), grid.testCollision(orig, dest, true))
+		<< "From " << orig.x << ", " << orig.y << ", " << orig.z << " to " << dest.x << ", " << dest.y << ", " << dest.z;
+}
+
+GTEST_TEST(WalkmeshGrid, empty) {
+	Graphics::Aurora::WalkmeshGrid grid;
+
+	grid.build(std::vector<float>(), std::vector<uint32>());
+	EXPECT_EQ(grid.getFaceCount(), 0);
+
+	uint32 face;
+	EXPECT_EQ(grid.getElevationAt(0.0f, 0.0f, face), FLT_MIN);
+	EXPECT_FALSE(grid.testCollision(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 0.0f)));
+}
+
+GTEST_TEST(WalkmeshGrid, elevation) {
+	Random random(0);
+
+	std::vector<float> vertices;
+	std::vector<uint32> indices;
+
+	addVertex(vertices, 0.0f, 0.0f, 1.0f);
+	addVertex(vertices, 2.0f, 0.0f, 1.0f);
+	addVertex(vertices, 0.0f, 2.0f, 3.0f);
+	addFace(indices, 0, 1, 2);
+
+	// Some faces in between, to make sure the face indices match up
+	createSoup(vertices, indices, 100, 100.0f, random);
+
+	addVertex(vertices, 10.0f, 10.0f, 5.0f);
+	addVertex(vertices, 12.0f, 10.0f, 5.0f);
+	addVertex(vertices, 10.0f, 12.0f, 5.0f);
+	addFace(indices, vertices.size() / 3 - 3, vertices.size() / 3 - 2, vertices.size() / 3 - 1);
+
+	Graphics::Aurora::WalkmeshGrid grid;
+	grid.build(vertices, indices);
+
+	EXPECT_EQ(grid.getFaceCount(), 102);
+
+	uint32 face = 0xFFFFFFFF;
+	EXPECT_FLOAT_EQ(grid.getElevationAt(0.5f, 0.5f, face), 1.5f);
+	EXPECT_EQ(face, 0);
+
+	EXPECT_FLOAT_EQ(grid.getElevationAt(10.5f, 10.5f, face), 5.0f);
+	EXPECT_EQ(face, 101);
+
+	EXPECT_EQ(grid.getElevationAt(-50.0f, -50.0f, face), FLT_MIN);
+}
+
+GTEST_TEST(WalkmeshGrid, terrainElevation) {
+	Random random(1);
+
+	std::vector<float> vertices;
+	std::vector<uint32> indices;
+
+	createTerrain(vertices, indices, 40, -20.0f, 5.0f, random);
+
+	Graphics::Aurora::WalkmeshGrid grid;
+	grid.build(vertices, indices);
+
+	// Random points, on and around the terrain
+	for (int i = 0; i < 20000; i++)
+		compareElevation(grid, random.get(-25.0f, 25.0f), random.get(0.0f, 50.0f));
+
+	// Points exactly on the vertices, edges and midpoints
+	for (int y = 0; y <= 160; y++)
+		for (int x = 0; x <= 160; x++)
+			compareElevation(grid, -20.0f + x * 0.25f, 5.0f + y * 0.25f);
+}
+
+GTEST_TEST(WalkmeshGrid, soupElevation) {
+	Random random(2);
+
+	std::vector<float> vertices;
+	std::vector<uint32> indices;
+
+	createSoup(vertices, indices, 3000, 200.0f, random);
+
+	Graphics::Aurora::WalkmeshGrid grid;
+	grid.build(vertices, indices);
+
+	for (int i = 0; i < 20000; i++)
+		compareElevation(grid, random.get(-40.0f, 240.0f), random.get(-40.0f, 240.0f));
+
+	// Points exactly on vertices
+	for (size_t i = 0; i < vertices.size(); i += 3)
+		compareElevation(grid, vertices[i + 0], vertices[i + 1]);
+}
+
+GTEST_TEST(WalkmeshGrid, collision) {
+	Random random(3);
+
+	std::vector<float> vertices;
+	std::vector<uint32> indices;
+
+	// Vertical walls
+	for (int i = 0; i < 500; i++) {
+		const uint32 first = vertices.size() / 3;
+
+		const float x1 = random.get(0.0f, 100.0f), y1 = random.get(0.0f, 100.0f);
+		const float x2 = x1 + random.get(-5.0f, 5.0f), y2 = y1 + random.get(-5.0f, 5.0f);
+
+		addVertex(vertices, x1, y1, -2.0f);
+		addVertex(vertices, x2, y2, -2.0f);
+		addVertex(vertices, x2, y2,  4.0f);
+		addVertex(vertices, x1, y1,  4.0f);
+
+		addFace(indices, first, first + 1, first + 2);
+		addFace(indices, first, first + 2, first + 3);
+	}
+
+	// Horizontal obstacles
+	createSoup(vertices, indices, 500, 100.0f, random);
+
+	Graphics::Aurora::WalkmeshGrid grid;
+	grid.build(vertices, indices);
+
+	size_t collisions = 0;
+	for (int i = 0; i < 20000; i++) {
+		const glm::vec3 orig(random.get(-10.0f, 110.0f), random.get(-10.0f, 110.0f), random.get(-1.0f, 1.0f));
+
+		const float length = (i % 4) ? 1.0f : 20.0f;
+		const glm::vec3 dest = orig + glm::vec3(random.get(-length, length), random.get(-length, length), random.get(-0.1f, 0.1f));
+
+		compareCollision(grid, orig, dest);
+
+		collisions += grid.testCollision(orig, dest) ? 1 : 0;
+	}
+
+	// Make sure we actually tested both cases
+	EXPECT_GT(collisions, 0);
+	EXPECT_LT(collisions, 20000);
+
+	// Not moving at all
+	compareCollision(grid, glm::vec3(50.0f, 50.0f, 0.0f), glm::vec3(50.0f, 50.0f, 0.0f));
+}
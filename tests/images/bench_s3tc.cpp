@@ -0,0 +1,114 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmark for our S3TC DXTn decompression methods.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+#include <chrono>
+
+#include "src/common/types.h"
+#include "src/common/memreadstream.h"
+
+#include "src/graphics/images/s3tc.h"
+
+static const uint32 kWidth  = 1024;
+static const uint32 kHeight = 1024;
+
+enum Decoder {
+	kDecoderStream,
+	kDecoderScalar,
+	kDecoderSIMD
+};
+
+static const char * const kDecoderNames[] = { "stream", "scalar", "SIMD" };
+
+static void decompress(int dxt, Decoder decoder, byte *dest, const std::vector<byte> &data) {
+	if (decoder == kDecoderStream) {
+		Common::MemoryReadStream stream(&data[0], data.size());
+
+		if      (dxt == 1)
+			Graphics::decompressDXT1(dest, stream, kWidth, kHeight, kWidth * 4);
+		else if (dxt == 3)
+			Graphics::decompressDXT3(dest, stream, kWidth, kHeight, kWidth * 4);
+		else if (dxt == 5)
+			Graphics::decompressDXT5(dest, stream, kWidth, kHeight, kWidth * 4);
+
+		return;
+	}
+
+	const bool simd = decoder == kDecoderSIMD;
+
+	if      (dxt == 1)
+		Graphics::decompressDXT1(dest, &data[0], data.size(), kWidth, kHeight, kWidth * 4, simd);
+	else if (dxt == 3)
+		Graphics::decompressDXT3(dest, &data[0], data.size(), kWidth, kHeight, kWidth * 4, simd);
+	else if (dxt == 5)
+		Graphics::decompressDXT5(dest, &data[0], data.size(), kWidth, kHeight, kWidth * 4, simd);
+}
+
+static void benchmark(int dxt, Decoder decoder, int iterations) {
+	std::vector<byte> data(kWidth * kHeight / ((dxt == 1) ? 2 : 1));
+	std::vector<byte> output(kWidth * kHeight * 4);
+
+	uint32 seed = dxt;
+	for (std::vector<byte>::iterator d = data.begin(); d != data.end(); ++d) {
+		seed = seed * 1103515245 + 12345;
+
+		*d = seed >> 16;
+	}
+
+	// Warm up the caches
+	decompress(dxt, decoder, &output[0], data);
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < iterations; i++)
+		decompress(dxt, decoder, &output[0], data);
+
+	const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+	const double pixels = (double) kWidth * kHeight * iterations;
+
+	std::printf("DXT%d %-6s: %8.3f ms per %ux%u image, %8.2f MPixels/s\n", dxt, kDecoderNames[decoder],
+	            time.count() * 1000.0 / iterations, kWidth, kHeight, pixels / time.count() / 1000000.0);
+}
+
+int main(int argc, char **argv) {
+	const int iterations = (argc > 1) ? std::atoi(argv[1]) : 20;
+	if (iterations <= 0) {
+		std::fprintf(stderr, "Usage: %s [<iterations>]\n", argv[0]);
+		return 1;
+	}
+
+	for (int dxt = 1; dxt <= 5; dxt += 2) {
+		benchmark(dxt, kDecoderStream, iterations);
+		benchmark(dxt, kDecoderScalar, iterations);
+
+		if (Graphics::hasSIMDDXTDecompression())
+			benchmark(dxt, kDecoderSIMD, iterations);
+	}
+
+	return 0;
+}
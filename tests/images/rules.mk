@@ -41,3 +41,27 @@ check_PROGRAMS                       += tests/images/test_xoreositex
 tests_images_test_xoreositex_SOURCES  = tests/images/xoreositex.cpp
 tests_images_test_xoreositex_LDADD    = $(images_LIBS)
 tests_images_test_xoreositex_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                 += tests/images/test_s3tc
+tests_images_test_s3tc_SOURCES  = tests/images/s3tc.cpp
+tests_images_test_s3tc_LDADD    = $(images_LIBS)
+tests_images_test_s3tc_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                += tests/images/test_tpc
+tests_images_test_tpc_SOURCES  = tests/images/tpc.cpp
+tests_images_test_tpc_LDADD    = $(images_LIBS)
+tests_images_test_tpc_CXXFLAGS = $(test_CXXFLAGS)
+
+# Benchmarks
+
+images_BENCH_LIBS = \
+    src/graphics/libgraphics.la \
+    src/aurora/libaurora.la \
+    src/common/libcommon.la \
+    tests/version/libversion.la \
+    $(LDADD)
+
+BENCHMARKS                      += tests/images/bench_s3tc
+tests_images_bench_s3tc_SOURCES  = tests/images/bench_s3tc.cpp
+tests_images_bench_s3tc_LDADD    = $(images_BENCH_LIBS)
+tests_images_bench_s3tc_CXXFLAGS = $(AM_CXXFLAGS)
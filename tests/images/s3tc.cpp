@@ -0,0 +1,183 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our S3TC DXTn decompression methods.
+ */
+
+#include <cstring>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+
+#include "src/graphics/images/s3tc.h"
+
+enum DXTFormat {
+	kDXT1,
+	kDXT3,
+	kDXT5
+};
+
+static size_t getBlockSize(DXTFormat format) {
+	return (format == kDXT1) ? 8 : 16;
+}
+
+static size_t getDataSize(DXTFormat format, uint32 width, uint32 height) {
+	return ((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(format);
+}
+
+/** Fill the data with deterministic pseudo-random bytes. */
+static void fillRandom(std::vector<byte> &data, uint32 seed) {
+	for (std::vector<byte>::iterator d = data.begin(); d != data.end(); ++d) {
+		seed = seed * 1103515245 + 12345;
+
+		*d = seed >> 16;
+	}
+}
+
+static void decompressStream(DXTFormat format, byte *dest, const std::vector<byte> &data,
+                             uint32 width, uint32 height) {
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+
+	if      (format == kDXT1)
+		Graphics::decompressDXT1(dest, stream, width, height, width * 4);
+	else if (format == kDXT3)
+		Graphics::decompressDXT3(dest, stream, width, height, width * 4);
+	else if (format == kDXT5)
+		Graphics::decompressDXT5(dest, stream, width, height, width * 4);
+}
+
+static void decompressMemory(DXTFormat format, byte *dest, const std::vector<byte> &data,
+                             uint32 width, uint32 height, bool simd) {
+
+	if      (format == kDXT1)
+		Graphics::decompressDXT1(dest, &data[0], data.size(), width, height, width * 4, simd);
+	else if (format == kDXT3)
+		Graphics::decompressDXT3(dest, &data[0], data.size(), width, height, width * 4, simd);
+	else if (format == kDXT5)
+		Graphics::decompressDXT5(dest, &data[0], data.size(), width, height, width * 4, simd);
+}
+
+/** Decompress the data with all decoders, and make sure the results are identical. */
+static void compareDecoders(DXTFormat format, const std::vector<byte> &data, uint32 width, uint32 height) {
+	const size_t size = width * height * 4;
+
+	std::vector<byte> reference(size, 0xCD);
+	decompressStream(format, &reference[0], data, width, height);
+
+	for (int simd = 0; simd < 2; simd++) {
+		std::vector<byte> output(size, 0xCD);
+		decompressMemory(format, &output[0], data, width, height, simd != 0);
+
+		for (size_t i = 0; i < size; i++) {
+			ASSERT_EQ(output[i], reference[i]) << "DXT" << ((format == kDXT1) ? 1 : ((format == kDXT3) ? 3 : 5))
+			                                   << ", " << width << "x" << height << ", SIMD " << simd
+			                                   << ", pixel " << (i / 4) << ", channel " << (i % 4);
+		}
+	}
+}
+
+static void compareRandom(DXTFormat format) {
+	static const uint32 kSizes[][2] = {
+		{  1,  1 }, {  2,  2 }, {  3,  3 }, {  1,  4 }, {  4,  1 }, {  2,  8 }, {  8,  2 },
+		{  4,  4 }, {  6,  6 }, {  8,  8 }, { 12, 20 }, { 20, 12 }, { 64, 64 }, { 256, 32 }
+	};
+
+	for (size_t i = 0; i < ARRAYSIZE(kSizes); i++) {
+		const uint32 width  = kSizes[i][0];
+		const uint32 height = kSizes[i][1];
+
+		std::vector<byte> data(getDataSize(format, width, height));
+		fillRandom(data, i);
+
+		compareDecoders(format, data, width, height);
+	}
+}
+
+/** Create blocks with all combinations of the two endpoints in every channel. */
+static void compareEndpoints(DXTFormat format) {
+	const uint32 width = 1024, height = 256;
+
+	std::vector<byte> data(getDataSize(format, width, height));
+	fillRandom(data, 0);
+
+	const size_t blockSize = getBlockSize(format);
+	for (size_t i = 0; i < data.size() / blockSize; i++) {
+		byte *block = &data[i * blockSize];
+
+		if (format == kDXT5) {
+			block[0] = i & 0xFF;
+			block[1] = (i >> 8) & 0xFF;
+		}
+
+		if (format != kDXT1)
+			block += 8;
+
+		const uint16 color0 = (((i >>  6) & 0x1F) << 11) | (((i >> 6) & 0x3F) << 5) | ((i >> 6) & 0x1F);
+		const uint16 color1 = (( i        & 0x1F) << 11) | (( i       & 0x3F) << 5) | ( i       & 0x1F);
+
+		// Flip the endpoints every 4096 blocks, to see both DXT1 modes for all pairs
+		const bool flip = (i & 0x1000) != 0;
+
+		WRITE_LE_UINT16(block + 0, flip ? color1 : color0);
+		WRITE_LE_UINT16(block + 2, flip ? color0 : color1);
+	}
+
+	compareDecoders(format, data, width, height);
+}
+
+GTEST_TEST(S3TC, decompressDXT1) {
+	compareRandom(kDXT1);
+}
+
+GTEST_TEST(S3TC, decompressDXT3) {
+	compareRandom(kDXT3);
+}
+
+GTEST_TEST(S3TC, decompressDXT5) {
+	compareRandom(kDXT5);
+}
+
+GTEST_TEST(S3TC, decompressDXT1Endpoints) {
+	compareEndpoints(kDXT1);
+}
+
+GTEST_TEST(S3TC, decompressDXT3Endpoints) {
+	compareEndpoints(kDXT3);
+}
+
+GTEST_TEST(S3TC, decompressDXT5Endpoints) {
+	compareEndpoints(kDXT5);
+}
+
+GTEST_TEST(S3TC, decompressTooSmall) {
+	std::vector<byte> data(getDataSize(kDXT5, 8, 8) - 1);
+	std::vector<byte> output(8 * 8 * 4);
+
+	EXPECT_THROW(Graphics::decompressDXT1(&output[0], &data[0], 31, 8, 8, 8 * 4), Common::Exception);
+	EXPECT_THROW(Graphics::decompressDXT3(&output[0], &data[0], data.size(), 8, 8, 8 * 4), Common::Exception);
+	EXPECT_THROW(Graphics::decompressDXT5(&output[0], &data[0], data.size(), 8, 8, 8 * 4), Common::Exception);
+}
@@ -0,0 +1,110 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for BioWare's TPC texture format.
+ */
+
+#include <cstring>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+
+#include "src/graphics/images/tpc.h"
+#include "src/graphics/images/txi.h"
+
+/** Create a 4x4 uncompressed RGB TPC with a single mip map, and an optional TXI. */
+static std::vector<byte> createTPC(const char *txi) {
+	std::vector<byte> tpc(128 + 4 * 4 * 3, 0x00);
+
+	tpc[ 8] = 4;    // Width
+	tpc[10] = 4;    // Height
+	tpc[12] = 0x02; // Encoding: RGB
+	tpc[13] = 1;    // Mip map count
+
+	for (size_t i = 128; i < tpc.size(); i++)
+		tpc[i] = i - 128;
+
+	if (txi)
+		tpc.insert(tpc.end(), txi, txi + std::strlen(txi));
+
+	return tpc;
+}
+
+static const char *kTXI = "decal 1\r\nalphamean 1.0\r\nenvmaptexture CM_Baremetal\r\n";
+
+GTEST_TEST(TPC, getTXI) {
+	const std::vector<byte> data = createTPC(kTXI);
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+	const Graphics::TPC image(stream);
+
+	ASSERT_EQ(image.getMipMapCount(), 1);
+	EXPECT_EQ(image.getMipMap(0).width, 4);
+	EXPECT_EQ(image.getMipMap(0).height, 4);
+	EXPECT_EQ(image.getMipMap(0).data[47], 47);
+
+	const Graphics::TXI::Features &features = image.getTXI().getFeatures();
+
+	EXPECT_FALSE(image.getTXI().empty());
+	EXPECT_TRUE(features.decal);
+	EXPECT_FLOAT_EQ(features.alphaMean, 1.0f);
+	EXPECT_STREQ(features.envMapTexture.c_str(), "CM_Baremetal");
+}
+
+GTEST_TEST(TPC, readEmbeddedTXI) {
+	const std::vector<byte> data = createTPC(kTXI);
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+
+	Graphics::TXI txi;
+	ASSERT_TRUE(Graphics::TPC::readEmbeddedTXI(stream, txi));
+
+	const Graphics::TXI::Features &features = txi.getFeatures();
+
+	EXPECT_FALSE(txi.empty());
+	EXPECT_TRUE(features.decal);
+	EXPECT_FLOAT_EQ(features.alphaMean, 1.0f);
+	EXPECT_STREQ(features.envMapTexture.c_str(), "CM_Baremetal");
+}
+
+GTEST_TEST(TPC, readEmbeddedTXIMissing) {
+	const std::vector<byte> data = createTPC(0);
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+
+	Graphics::TXI txi;
+	EXPECT_FALSE(Graphics::TPC::readEmbeddedTXI(stream, txi));
+	EXPECT_TRUE(txi.empty());
+}
+
+GTEST_TEST(TPC, readEmbeddedTXITruncated) {
+	std::vector<byte> data = createTPC(0);
+	data.resize(100);
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+
+	Graphics::TXI txi;
+	EXPECT_THROW(Graphics::TPC::readEmbeddedTXI(stream, txi), Common::Exception);
+}
@@ -39,7 +39,20 @@ include tests/engines/rules.mk
 include tests/version/rules.mk
 include tests/common/rules.mk
 include tests/aurora/rules.mk
+include tests/graphics/rules.mk
 include tests/images/rules.mk
+include tests/video/rules.mk
+include tests/sound/rules.mk
 include tests/engines/nwn2/rules.mk
 
 TESTS += $(check_PROGRAMS)
+
+# Benchmarks. These are neither built nor run by default, only by "make bench"
+
+EXTRA_PROGRAMS += $(BENCHMARKS)
+CLEANFILES     += $(BENCHMARKS)
+
+bench: $(BENCHMARKS)
+	@for b in $(BENCHMARKS); do echo "$$b"; ./$$b || exit 1; done
+
+.PHONY: bench
@@ -0,0 +1,172 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the bookkeeping of the sound channel slots.
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+
+#include "src/sound/channelslots.h"
+
+/** Does the list of used slots hold exactly these slots, in any order? */
+static bool isUsedExactly(const Sound::ChannelSlots &slots, std::vector<size_t> expected) {
+	std::vector<size_t> used = slots.getUsed();
+
+	std::sort(used.begin(), used.end());
+	std::sort(expected.begin(), expected.end());
+
+	return used == expected;
+}
+
+GTEST_TEST(ChannelSlots, allocate) {
+	Sound::ChannelSlots slots(4);
+
+	EXPECT_EQ(slots.getCount(), 4);
+	EXPECT_FALSE(slots.isFull());
+	EXPECT_TRUE(slots.getUsed().empty());
+
+	// The lowest slots are handed out first
+	for (size_t i = 0; i < 4; i++) {
+		EXPECT_FALSE(slots.isUsed(i));
+
+		EXPECT_EQ(slots.allocate(), i);
+		EXPECT_TRUE(slots.isUsed(i));
+	}
+
+	EXPECT_TRUE(slots.isFull());
+	EXPECT_THROW(slots.allocate(), Common::Exception);
+
+	EXPECT_FALSE(slots.isUsed(4));
+}
+
+GTEST_TEST(ChannelSlots, reuseLastFreed) {
+	Sound::ChannelSlots slots(8);
+
+	for (size_t i = 0; i < 4; i++)
+		slots.allocate();
+
+	slots.free(1);
+	slots.free(3);
+
+	// Freed slots are kept on a stack
+	EXPECT_EQ(slots.allocate(), 3);
+	EXPECT_EQ(slots.allocate(), 1);
+	EXPECT_EQ(slots.allocate(), 4);
+}
+
+GTEST_TEST(ChannelSlots, freeUnused) {
+	Sound::ChannelSlots slots(4);
+
+	slots.allocate();
+
+	// Freeing a slot twice, or one out of range, does nothing
+	slots.free(0);
+	slots.free(0);
+	slots.free(2);
+	slots.free(23);
+
+	EXPECT_TRUE(slots.getUsed().empty());
+
+	EXPECT_EQ(slots.allocate(), 0);
+	EXPECT_EQ(slots.allocate(), 1);
+	EXPECT_EQ(slots.allocate(), 2);
+	EXPECT_EQ(slots.allocate(), 3);
+	EXPECT_TRUE(slots.isFull());
+}
+
+GTEST_TEST(ChannelSlots, freeSwapsLast) {
+	Sound::ChannelSlots slots(8);
+
+	for (size_t i = 0; i < 5; i++)
+		slots.allocate();
+
+	// The last used slot takes the place of the freed one
+	slots.free(1);
+
+	const size_t kUsed1[] = { 0, 4, 2, 3 };
+	ASSERT_EQ(slots.getUsed().size(), ARRAYSIZE(kUsed1));
+	for (size_t i = 0; i < ARRAYSIZE(kUsed1); i++)
+		EXPECT_EQ(slots.getUsed()[i], kUsed1[i]) << "At index " << i;
+
+	// Freeing the last used slot just removes it
+	slots.free(3);
+
+	const size_t kUsed2[] = { 0, 4, 2 };
+	ASSERT_EQ(slots.getUsed().size(), ARRAYSIZE(kUsed2));
+	for (size_t i = 0; i < ARRAYSIZE(kUsed2); i++)
+		EXPECT_EQ(slots.getUsed()[i], kUsed2[i]) << "At index " << i;
+
+	// The moved slot can still be found and freed
+	slots.free(4);
+
+	const size_t kUsed3[] = { 0, 2 };
+	ASSERT_EQ(slots.getUsed().size(), ARRAYSIZE(kUsed3));
+	for (size_t i = 0; i < ARRAYSIZE(kUsed3); i++)
+		EXPECT_EQ(slots.getUsed()[i], kUsed3[i]) << "At index " << i;
+}
+
+GTEST_TEST(ChannelSlots, freeRandom) {
+	Sound::ChannelSlots slots(64);
+
+	std::vector<size_t> used;
+	for (size_t i = 0; i < 64; i++)
+		used.push_back(slots.allocate());
+
+	// Free the slots in a scrambled order, and take a few new ones in between
+	uint32 seed = 0;
+	for (size_t n = 0; n < 200; n++) {
+		seed = seed * 1103515245 + 12345;
+
+		if (!used.empty() && (((seed >> 8) % 3) != 0)) {
+			const size_t r = (seed >> 12) % used.size();
+
+			slots.free(used[r]);
+			EXPECT_FALSE(slots.isUsed(used[r]));
+
+			used.erase(used.begin() + r);
+		} else if (!slots.isFull())
+			used.push_back(slots.allocate());
+
+		ASSERT_TRUE(isUsedExactly(slots, used)) << "At step " << n;
+	}
+}
+
+GTEST_TEST(ChannelSlots, clear) {
+	Sound::ChannelSlots slots(4);
+
+	slots.allocate();
+	slots.allocate();
+	slots.free(0);
+
+	slots.clear();
+
+	EXPECT_TRUE(slots.getUsed().empty());
+	EXPECT_FALSE(slots.isUsed(1));
+
+	EXPECT_EQ(slots.allocate(), 0);
+	EXPECT_EQ(slots.allocate(), 1);
+}
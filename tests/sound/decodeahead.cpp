@@ -0,0 +1,227 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+/** @file
+ *  Unit tests for decoding audio streams ahead of time.
+ */
+
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/atomic.h"
+#include "src/common/mutex.h"
+#include "src/common/scopedptr.h"
+#include "src/common/threadpool.h"
+
+#include "src/sound/audiostream.h"
+#include "src/sound/decodeahead.h"
+
+/** A mono stream of consecutive sample values, remembering how far it was read. */
+class CountingStream : public Sound::RewindableAudioStream {
+public:
+	CountingStream(size_t size, uint64 length, boost::atomic<size_t> *pos, boost::atomic<bool> *deleted) :
+		_size(size), _length(length), _pos(pos), _deleted(deleted) {
+
+		_pos->store(0);
+		_deleted->store(false);
+	}
+
+	~CountingStream() {
+		_deleted->store(true);
+	}
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples) {
+		const size_t pos     = _pos->load();
+		const size_t samples = MIN(numSamples, _size - pos);
+
+		for (size_t i = 0; i < samples; i++)
+			buffer[i] = (int16) (pos + i);
+
+		_pos->store(pos + samples);
+		return samples;
+	}
+
+	int getChannels() const {
+		return 1;
+	}
+
+	int getRate() const {
+		return 22050;
+	}
+
+	bool endOfData() const {
+		return _pos->load() >= _size;
+	}
+
+	bool rewind() {
+		_pos->store(0);
+		return true;
+	}
+
+	uint64 getLength() const {
+		return _length;
+	}
+
+private:
+	size_t _size;   ///< The number of samples the stream actually has.
+	uint64 _length; ///< The length the stream claims to have.
+
+	boost::atomic<size_t> *_pos;
+	boost::atomic<bool> *_deleted;
+};
+
+static const uint64 kInvalidLength = Sound::RewindableAudioStream::kInvalidLength;
+
+/** Read a stream from pos until it ends, and check that all samples came out in the right order. */
+static void readAll(Sound::AudioStream &stream, size_t chunkSize, size_t expectedSize, size_t pos = 0) {
+	std::vector<int16> chunk(chunkSize);
+
+	while (!stream.endOfStream()) {
+		const size_t samples = stream.readBuffer(&chunk[0], chunkSize);
+		ASSERT_NE(samples, (size_t) Sound::AudioStream::kSizeInvalid);
+		ASSERT_LE(pos + samples, expectedSize);
+
+		for (size_t i = 0; i < samples; i++)
+			ASSERT_EQ(chunk[i], (int16) (pos + i)) << "At sample " << (pos + i);
+
+		pos += samples;
+	}
+
+	EXPECT_EQ(pos, expectedSize);
+	EXPECT_TRUE(stream.endOfData());
+}
+
+static void block(Common::Semaphore *semaphore) {
+	semaphore->lock();
+	semaphore->unlock();
+}
+
+GTEST_TEST(DecodeAheadStream, read) {
+	// Without threads, the decoding job runs right inside readBuffer()
+	Common::ThreadPool pool(0);
+
+	boost::atomic<size_t> pos;
+	boost::atomic<bool> deleted;
+
+	Common::ScopedPtr<Sound::AudioStream>
+		stream(Sound::makeDecodeAheadStream(new CountingStream(500000, kInvalidLength, &pos, &deleted), pool));
+
+	EXPECT_EQ(stream->getChannels(), 1);
+	EXPECT_EQ(stream->getRate(), 22050);
+
+	readAll(*stream, 4096, 500000);
+}
+
+GTEST_TEST(DecodeAheadStream, bufferSize) {
+	Common::ThreadPool pool(0);
+
+	boost::atomic<size_t> pos;
+	boost::atomic<bool> deleted;
+
+	int16 buffer[16];
+
+	// Without a known length, we decode the whole 163840 samples ahead
+	Common::ScopedPtr<Sound::AudioStream>
+		stream(Sound::makeDecodeAheadStream(new CountingStream(500000, kInvalidLength, &pos, &deleted), pool));
+
+	ASSERT_EQ(stream->readBuffer(buffer, 16), 16);
+	EXPECT_EQ(pos.load(), 16 + 163840);
+
+	// A short stream only decodes as much ahead as it's long
+	stream.reset(Sound::makeDecodeAheadStream(new CountingStream(500000, 1000, &pos, &deleted), pool));
+
+	ASSERT_EQ(stream->readBuffer(buffer, 16), 16);
+	EXPECT_EQ(pos.load(), 16 + 1000);
+
+	// Decoding still goes on past the claimed length, it's only the buffer that's smaller
+	readAll(*stream, 16, 500000, 16);
+}
+
+GTEST_TEST(DecodeAheadStream, readThreaded) {
+	Common::ThreadPool pool(1);
+
+	boost::atomic<size_t> pos;
+	boost::atomic<bool> deleted;
+
+	Common::ScopedPtr<Sound::AudioStream>
+		stream(Sound::makeDecodeAheadStream(new CountingStream(1000000, kInvalidLength, &pos, &deleted), pool));
+
+	/* The reads hand the stream back and forth between us and the decoding
+	 * thread. No matter who decoded what, every sample comes out once. */
+	readAll(*stream, 4000, 1000000);
+
+	EXPECT_TRUE(pool.wait());
+}
+
+GTEST_TEST(DecodeAheadStream, endOfStream) {
+	Common::ThreadPool pool(1);
+
+	boost::atomic<size_t> pos;
+	boost::atomic<bool> deleted;
+
+	Common::ScopedPtr<Sound::AudioStream>
+		stream(Sound::makeDecodeAheadStream(new CountingStream(100, 100, &pos, &deleted), pool));
+
+	EXPECT_FALSE(stream->endOfData());
+	EXPECT_FALSE(stream->endOfStream());
+
+	readAll(*stream, 4096, 100);
+
+	int16 buffer[16];
+	EXPECT_EQ(stream->readBuffer(buffer, 16), 0);
+
+	EXPECT_TRUE(stream->endOfData());
+	EXPECT_TRUE(stream->endOfStream());
+
+	EXPECT_TRUE(pool.wait());
+}
+
+GTEST_TEST(DecodeAheadStream, stopWhileQueued) {
+	Common::ThreadPool pool(1);
+
+	// Keep the only thread busy, so that the decoding job stays queued
+	Common::Semaphore semaphore(0);
+	pool.add(boost::bind(&block, &semaphore));
+
+	boost::atomic<size_t> pos;
+	boost::atomic<bool> deleted;
+
+	Common::ScopedPtr<Sound::AudioStream>
+		stream(Sound::makeDecodeAheadStream(new CountingStream(500000, kInvalidLength, &pos, &deleted), pool));
+
+	// Nothing decoded yet, so this reads directly, and queues a decoding job
+	int16 buffer[16];
+	ASSERT_EQ(stream->readBuffer(buffer, 16), 16);
+	EXPECT_EQ(pos.load(), 16);
+
+	// The queued job still holds onto the input stream
+	stream.reset();
+	EXPECT_FALSE(deleted.load());
+
+	semaphore.unlock();
+	EXPECT_TRUE(pool.wait());
+
+	// The job saw the stop, didn't decode anything, and let go of the stream
+	EXPECT_EQ(pos.load(), 16);
+	EXPECT_TRUE(deleted.load());
+}
@@ -0,0 +1,306 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+/** @file
+ *  Unit tests for the cache of decoded sounds.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/strutil.h"
+#include "src/common/scopedptr.h"
+
+#include "src/sound/audiostream.h"
+#include "src/sound/pcmcache.h"
+
+/** A mono stream of consecutive sample values, starting at a given value. */
+class CountingStream : public Sound::RewindableAudioStream {
+public:
+	CountingStream(size_t size, bool knownLength = true, int16 start = 0) :
+		_size(size), _knownLength(knownLength), _start(start), _pos(0) {
+
+	}
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples) {
+		const size_t samples = MIN(numSamples, _size - _pos);
+
+		for (size_t i = 0; i < samples; i++)
+			buffer[i] = (int16) (_start + _pos + i);
+
+		_pos += samples;
+		return samples;
+	}
+
+	int getChannels() const {
+		return 1;
+	}
+
+	int getRate() const {
+		return 22050;
+	}
+
+	bool endOfData() const {
+		return _pos >= _size;
+	}
+
+	bool rewind() {
+		_pos = 0;
+		return true;
+	}
+
+	uint64 getLength() const {
+		return _knownLength ? _size : kInvalidLength;
+	}
+
+	size_t getPos() const {
+		return _pos;
+	}
+
+private:
+	size_t _size;
+	bool _knownLength;
+	int16 _start;
+
+	size_t _pos;
+};
+
+/** Does the stream hold exactly size consecutive samples, starting at start? */
+static bool isCounting(Sound::AudioStream &stream, size_t size, int16 start = 0) {
+	std::vector<int16> buffer(size + 1);
+
+	if (stream.readBuffer(&buffer[0], size + 1) != size)
+		return false;
+
+	for (size_t i = 0; i < size; i++)
+		if (buffer[i] != (int16) (start + i))
+			return false;
+
+	return stream.endOfData();
+}
+
+GTEST_TEST(PCMCache, add) {
+	Sound::PCMCache cache(1000, 100);
+
+	EXPECT_FALSE(cache.has("foo"));
+	EXPECT_EQ(cache.get("foo"), static_cast<Sound::RewindableAudioStream *>(0));
+
+	CountingStream stream(50);
+	EXPECT_TRUE(cache.add("foo", stream));
+
+	EXPECT_TRUE(cache.has("foo"));
+	EXPECT_TRUE(cache.has("FOO"));
+	EXPECT_EQ(cache.getSize(), 100);
+
+	Common::ScopedPtr<Sound::RewindableAudioStream> cached(cache.get("Foo"));
+	ASSERT_TRUE(cached);
+
+	EXPECT_EQ(cached->getChannels(), 1);
+	EXPECT_EQ(cached->getRate(), 22050);
+	EXPECT_EQ(cached->getLength(), 50);
+
+	EXPECT_TRUE(isCounting(*cached, 50));
+
+	EXPECT_TRUE(cached->rewind());
+	EXPECT_TRUE(isCounting(*cached, 50));
+}
+
+GTEST_TEST(PCMCache, addTwice) {
+	Sound::PCMCache cache(1000, 100);
+
+	CountingStream stream1(50, true, 0);
+	CountingStream stream2(50, true, 1000);
+
+	EXPECT_TRUE(cache.add("foo", stream1));
+	EXPECT_TRUE(cache.add("foo", stream2));
+
+	// The second stream wasn't touched, the first one is still cached
+	EXPECT_EQ(stream2.getPos(), 0);
+	EXPECT_EQ(cache.getSize(), 100);
+
+	Common::ScopedPtr<Sound::RewindableAudioStream> cached(cache.get("foo"));
+	ASSERT_TRUE(cached);
+
+	EXPECT_TRUE(isCounting(*cached, 50, 0));
+}
+
+GTEST_TEST(PCMCache, evictLeastRecentlyUsed) {
+	// Room for three sounds of 100 bytes each
+	Sound::PCMCache cache(300, 100);
+
+	CountingStream stream1(50), stream2(50), stream3(50), stream4(50);
+
+	EXPECT_TRUE(cache.add("1", stream1));
+	EXPECT_TRUE(cache.add("2", stream2));
+	EXPECT_TRUE(cache.add("3", stream3));
+
+	// Playing the first sound makes the second one the least recently used
+	delete cache.get("1");
+
+	EXPECT_TRUE(cache.add("4", stream4));
+
+	EXPECT_TRUE(cache.has("1"));
+	EXPECT_FALSE(cache.has("2"));
+	EXPECT_TRUE(cache.has("3"));
+	EXPECT_TRUE(cache.has("4"));
+}
+
+GTEST_TEST(PCMCache, sizeBound) {
+	Sound::PCMCache cache(1000, 400);
+
+	for (size_t i = 0; i < 20; i++) {
+		CountingStream stream(50 + i * 5);
+
+		EXPECT_TRUE(cache.add(Common::composeString(i), stream));
+		EXPECT_LE(cache.getSize(), 1000);
+	}
+
+	// The most recent sound is always kept
+	EXPECT_TRUE(cache.has("19"));
+	EXPECT_FALSE(cache.has("0"));
+
+	cache.clear();
+
+	EXPECT_EQ(cache.getSize(), 0);
+	EXPECT_FALSE(cache.has("19"));
+}
+
+GTEST_TEST(PCMCache, tooLong) {
+	Sound::PCMCache cache(1000000, 100000);
+
+	// We know the length beforehand, so we don't even start decoding
+	CountingStream stream1(100000);
+	EXPECT_FALSE(cache.add("1", stream1));
+	EXPECT_FALSE(cache.has("1"));
+	EXPECT_EQ(stream1.getPos(), 0);
+
+	// We only notice while decoding, so the stream needs to be rewound
+	CountingStream stream2(100000, false);
+	EXPECT_FALSE(cache.add("2", stream2));
+	EXPECT_FALSE(cache.has("2"));
+	EXPECT_EQ(stream2.getPos(), 0);
+
+	EXPECT_EQ(cache.getSize(), 0);
+
+	// The sound is remembered as too long, and not decoded again
+	CountingStream stream3(100000, false);
+	EXPECT_FALSE(cache.add("2", stream3));
+	EXPECT_EQ(stream3.getPos(), 0);
+
+	// Just short enough
+	CountingStream stream4(50000, false);
+	EXPECT_TRUE(cache.add("3", stream4));
+	EXPECT_EQ(cache.getSize(), 100000);
+}
+
+GTEST_TEST(PCMCache, streamOutlivesEntry) {
+	Sound::PCMCache cache(100, 100);
+
+	CountingStream stream1(50, true, 0);
+	EXPECT_TRUE(cache.add("1", stream1));
+
+	Common::ScopedPtr<Sound::RewindableAudioStream> cached(cache.get("1"));
+	ASSERT_TRUE(cached);
+
+	// Pushes out the first sound, which we're still playing
+	CountingStream stream2(50, true, 1000);
+	EXPECT_TRUE(cache.add("2", stream2));
+
+	EXPECT_FALSE(cache.has("1"));
+
+	EXPECT_TRUE(isCounting(*cached, 50, 0));
+
+	cache.clear();
+
+	EXPECT_TRUE(cached->rewind());
+	EXPECT_TRUE(isCounting(*cached, 50, 0));
+}
+
+GTEST_TEST(PCMCache, reserve) {
+	Sound::PCMCache cache(1000, 100);
+
+	EXPECT_TRUE(cache.reserve("foo"));
+
+	// Somebody else is already adding the sound
+	EXPECT_FALSE(cache.reserve("FOO"));
+	EXPECT_FALSE(cache.has("foo"));
+
+	CountingStream stream(50);
+	EXPECT_TRUE(cache.add("foo", stream));
+
+	// Already cached
+	EXPECT_FALSE(cache.reserve("foo"));
+
+	cache.clear();
+
+	EXPECT_TRUE(cache.reserve("foo"));
+}
+
+GTEST_TEST(PCMCache, reject) {
+	Sound::PCMCache cache(1000, 100);
+
+	EXPECT_TRUE(cache.reserve("foo"));
+
+	cache.reject("foo");
+
+	EXPECT_FALSE(cache.reserve("foo"));
+
+	CountingStream stream(50);
+	EXPECT_FALSE(cache.add("foo", stream));
+	EXPECT_EQ(stream.getPos(), 0);
+
+	// Too long sounds can't be reserved either
+	CountingStream stream2(100, false);
+	EXPECT_FALSE(cache.add("bar", stream2));
+	EXPECT_FALSE(cache.reserve("bar"));
+}
+
+/** A stream that clears the cache while it's being decoded. */
+class ClearingStream : public CountingStream {
+public:
+	ClearingStream(size_t size, Sound::PCMCache &cache) : CountingStream(size), _cache(&cache) {
+	}
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples) {
+		_cache->clear();
+
+		return CountingStream::readBuffer(buffer, numSamples);
+	}
+
+private:
+	Sound::PCMCache *_cache;
+};
+
+GTEST_TEST(PCMCache, clearWhileAdding) {
+	Sound::PCMCache cache(1000, 100);
+
+	EXPECT_TRUE(cache.reserve("foo"));
+
+	// The decoded sound might be outdated, so it's dropped
+	ClearingStream stream(50, cache);
+	EXPECT_FALSE(cache.add("foo", stream));
+
+	EXPECT_FALSE(cache.has("foo"));
+	EXPECT_EQ(cache.getSize(), 0);
+
+	// But it's not remembered as impossible to cache
+	EXPECT_TRUE(cache.reserve("foo"));
+}
@@ -0,0 +1,195 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmark for decoding Bink video frames, without the need for a GL context.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <vector>
+#include <chrono>
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/strutil.h"
+#include "src/common/scopedptr.h"
+#include "src/common/readfile.h"
+#include "src/common/memreadstream.h"
+
+#include "src/graphics/images/surface.h"
+
+#include "src/video/codecs/binkvideo.h"
+
+static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
+static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
+static const uint32 kBIKhID = MKTAG('B', 'I', 'K', 'h');
+static const uint32 kBIKiID = MKTAG('B', 'I', 'K', 'i');
+
+static const uint32 kVideoFlagAlpha = 0x00100000;
+
+/** A Bink file, reduced to what the video codec needs. */
+struct BinkFile {
+	uint32 id;
+	uint32 width;
+	uint32 height;
+	uint32 flags;
+
+	uint32 audioTrackCount;
+
+	std::vector<uint32> frameOffsets;
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream;
+};
+
+static void loadBink(BinkFile &bink, const char *fileName) {
+	bink.stream.reset(new Common::ReadFile(fileName));
+
+	bink.id = bink.stream->readUint32BE();
+	if ((bink.id != kBIKfID) && (bink.id != kBIKgID) && (bink.id != kBIKhID) && (bink.id != kBIKiID))
+		throw Common::Exception("Unsupported Bink FourCC %s", Common::debugTag(bink.id).c_str());
+
+	bink.stream->skip(4);
+
+	const uint32 frameCount = bink.stream->readUint32LE();
+
+	bink.stream->skip(8);
+
+	bink.width  = bink.stream->readUint32LE();
+	bink.height = bink.stream->readUint32LE();
+
+	bink.stream->skip(8);
+
+	bink.flags = bink.stream->readUint32LE();
+
+	bink.audioTrackCount = bink.stream->readUint32LE();
+	bink.stream->skip(12 * bink.audioTrackCount);
+
+	if (frameCount == 0)
+		throw Common::Exception("No frames");
+
+	bink.frameOffsets.resize(frameCount + 1);
+	for (uint32 i = 0; i < frameCount; i++)
+		bink.frameOffsets[i] = bink.stream->readUint32LE() & ~1;
+
+	bink.frameOffsets[frameCount] = bink.stream->size();
+}
+
+/** Decode all frames of the video, returning the time it took. */
+static double decode(BinkFile &bink, size_t threadCount, std::vector<byte> &frames, uint32 &parallelFrames) {
+	const bool swapPlanes = (bink.id == kBIKhID) || (bink.id == kBIKiID);
+	const bool hasAlpha   = (bink.flags & kVideoFlagAlpha) != 0;
+
+	Video::BinkVideoCodec codec(bink.width, bink.height, bink.id, swapPlanes, hasAlpha, threadCount);
+	Graphics::Surface surface(bink.width, bink.height);
+
+	const size_t frameSize  = bink.width * bink.height * 4;
+	const size_t frameCount = bink.frameOffsets.size() - 1;
+
+	frames.resize(frameSize * frameCount);
+
+	std::chrono::steady_clock::duration time = std::chrono::steady_clock::duration::zero();
+
+	for (size_t i = 0; i < frameCount; i++) {
+		bink.stream->seek(bink.frameOffsets[i]);
+
+		// Skip over the audio tracks
+		for (uint32 j = 0; j < bink.audioTrackCount; j++)
+			bink.stream->skip(bink.stream->readUint32LE());
+
+		Common::ScopedPtr<Common::MemoryReadStream>
+			packet(bink.stream->readStream(bink.frameOffsets[i + 1] - bink.stream->pos()));
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		codec.decodeFrame(surface, *packet);
+
+		time += std::chrono::steady_clock::now() - start;
+
+		std::memcpy(&frames[i * frameSize], surface.getData(), frameSize);
+	}
+
+	parallelFrames = codec.getParallelFrameCount();
+
+	return std::chrono::duration<double>(time).count();
+}
+
+static bool benchmark(const char *fileName, size_t threadCount) {
+	BinkFile bink;
+	loadBink(bink, fileName);
+
+	const size_t frameCount = bink.frameOffsets.size() - 1;
+
+	std::vector<byte> sequentialFrames, parallelFrames;
+	uint32 sequentialCount = 0, parallelCount = 0;
+
+	const double sequentialTime = decode(bink, 0          , sequentialFrames, sequentialCount);
+	const double parallelTime   = decode(bink, threadCount, parallelFrames  , parallelCount);
+
+	std::printf("%s: %s, %ux%u, %u frames\n", fileName, Common::debugTag(bink.id).c_str(),
+	            bink.width, bink.height, (uint)frameCount);
+	std::printf("  1 thread : %8.2f frames/s\n", frameCount / sequentialTime);
+	std::printf("  %u threads: %8.2f frames/s, %u frames decoded in parallel\n",
+	            (uint)(threadCount + 1), frameCount / parallelTime, parallelCount);
+
+	if (sequentialFrames != parallelFrames) {
+		std::fprintf(stderr, "%s: Parallel decoding produced different frames\n", fileName);
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv) {
+	int arg = 1;
+
+	size_t threadCount = 2;
+	if ((argc > 2) && !std::strcmp(argv[1], "-t")) {
+		const int count = std::atoi(argv[2]);
+		if (count <= 0) {
+			std::fprintf(stderr, "Usage: %s [-t <threads>] [<file.bik> ...]\n", argv[0]);
+			return 1;
+		}
+
+		threadCount = count - 1;
+		arg += 2;
+	}
+
+	if (arg >= argc) {
+		std::printf("No Bink videos given, skipping\n");
+		return 0;
+	}
+
+	try {
+		bool success = true;
+		for (; arg < argc; arg++)
+			success = benchmark(argv[arg], threadCount) && success;
+
+		return success ? 0 : 1;
+
+	} catch (...) {
+		Common::exceptionDispatcherError();
+	}
+
+	return 1;
+}
@@ -0,0 +1,128 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the Bink video IDCT.
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+
+#include "src/video/codecs/binkdsp.h"
+
+static const uint32 kPitch = 13;
+
+/** Fill the block with deterministic pseudo-random coefficients.
+ *
+ *  The coefficients cover the full int16 range, while most of the
+ *  AC coefficients of real videos are zero. Mix both cases. */
+static void fillRandom(int16 *block, uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+	const uint32 sparse = (seed >> 16) & 3;
+
+	for (int i = 0; i < 64; i++) {
+		seed = seed * 1103515245 + 12345;
+
+		int16 value = (int16) (seed >> 16);
+		if      (sparse == 1)
+			value = (i == 0) ? value : 0;
+		else if (sparse == 2)
+			value = ((value & 0x0700) == 0) ? (value >> 4) : 0;
+		else if (sparse == 3)
+			value >>= 6;
+
+		block[i] = value;
+	}
+}
+
+static void fillRandom(byte *data, size_t size, uint32 &seed) {
+	for (size_t i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+
+		data[i] = seed >> 16;
+	}
+}
+
+GTEST_TEST(BinkDSP, IDCT) {
+	uint32 seed = 0;
+
+	for (int n = 0; n < 20000; n++) {
+		int16 block[64];
+		fillRandom(block, seed);
+
+		int16 scalar[64], simd[64];
+		std::memcpy(scalar, block, sizeof(block));
+		std::memcpy(simd  , block, sizeof(block));
+
+		Video::binkIDCT(scalar, false);
+		Video::binkIDCT(simd  , true);
+
+		for (int i = 0; i < 64; i++)
+			ASSERT_EQ(simd[i], scalar[i]) << "At block " << n << ", coefficient " << i;
+	}
+}
+
+GTEST_TEST(BinkDSP, IDCTPut) {
+	uint32 seed = 1;
+
+	for (int n = 0; n < 20000; n++) {
+		int16 block[64];
+		fillRandom(block, seed);
+
+		byte scalar[8 * kPitch], simd[8 * kPitch];
+		std::memset(scalar, 0xCD, sizeof(scalar));
+		std::memset(simd  , 0xCD, sizeof(simd));
+
+		Video::binkIDCTPut(scalar, kPitch, block, false);
+		Video::binkIDCTPut(simd  , kPitch, block, true);
+
+		for (size_t i = 0; i < sizeof(scalar); i++)
+			ASSERT_EQ(simd[i], scalar[i]) << "At block " << n << ", pixel " << (i % kPitch) << "." << (i / kPitch);
+	}
+}
+
+GTEST_TEST(BinkDSP, IDCTAdd) {
+	uint32 seed = 2;
+
+	for (int n = 0; n < 20000; n++) {
+		int16 block[64];
+		fillRandom(block, seed);
+
+		byte scalar[8 * kPitch], simd[8 * kPitch];
+		fillRandom(scalar, sizeof(scalar), seed);
+		std::memcpy(simd, scalar, sizeof(scalar));
+
+		int16 scalarBlock[64], simdBlock[64];
+		std::memcpy(scalarBlock, block, sizeof(block));
+		std::memcpy(simdBlock  , block, sizeof(block));
+
+		Video::binkIDCTAdd(scalar, kPitch, scalarBlock, false);
+		Video::binkIDCTAdd(simd  , kPitch, simdBlock  , true);
+
+		for (size_t i = 0; i < sizeof(scalar); i++)
+			ASSERT_EQ(simd[i], scalar[i]) << "At block " << n << ", pixel " << (i % kPitch) << "." << (i / kPitch);
+
+		for (int i = 0; i < 64; i++)
+			ASSERT_EQ(simdBlock[i], scalarBlock[i]) << "At block " << n << ", coefficient " << i;
+	}
+}
@@ -0,0 +1,193 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the Bink video codec.
+ */
+
+#include <cstring>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/memreadstream.h"
+
+#include "src/graphics/images/surface.h"
+
+#include "src/video/codecs/binkvideo.h"
+
+static const uint32 kBIKiID = MKTAG('B', 'I', 'K', 'i');
+
+static const uint32 kWidth  = 64;
+static const uint32 kHeight = 48;
+
+/** For videos this small, all bundle element counts are 10 bits wide. */
+static const size_t kCountLength = 10;
+
+static const uint32 kBlockFill = 6;
+
+/** Writes the bits of a Bink video packet, LSB to MSB. */
+class PacketWriter {
+public:
+	PacketWriter() : _pos(0) {
+	}
+
+	size_t pos() const {
+		return _pos;
+	}
+
+	void putBits(uint32 value, size_t n) {
+		for (size_t i = 0; i < n; i++, _pos++) {
+			if ((_pos / 8) >= _data.size())
+				_data.push_back(0);
+
+			_data[_pos / 8] |= ((value >> i) & 1) << (_pos % 8);
+		}
+	}
+
+	void align() {
+		while (_pos & 31)
+			putBits(0, 1);
+	}
+
+	void patchUint32(size_t pos, uint32 value) {
+		WRITE_LE_UINT32(&_data[pos / 8], value);
+	}
+
+	const std::vector<byte> &getData() const {
+		return _data;
+	}
+
+private:
+	std::vector<byte> _data;
+	size_t _pos;
+};
+
+/** Write a plane made of 8x8 blocks filled with a single color each, one color per block row. */
+static void writePlane(PacketWriter &packet, uint32 blockWidth, uint32 blockHeight, byte color) {
+	// Raw nibble Huffman codebooks for all bundles except the DCs
+	packet.putBits(0, 4); // Block types
+	packet.putBits(0, 4); // Sub block types
+	for (int i = 0; i < 16; i++)
+		packet.putBits(0, 4); // High color nibbles
+	packet.putBits(0, 4); // Colors
+	packet.putBits(0, 4); // Patterns
+	packet.putBits(0, 4); // X offsets
+	packet.putBits(0, 4); // Y offsets
+	packet.putBits(0, 4); // Runs
+
+	for (uint32 y = 0; y < blockHeight; y++, color += 7) {
+		// Block types, all the same
+		packet.putBits(blockWidth, kCountLength);
+		packet.putBits(1, 1);
+		packet.putBits(kBlockFill, 4);
+
+		// No sub block types
+		if (y == 0)
+			packet.putBits(0, kCountLength);
+
+		// Colors, all the same
+		packet.putBits(blockWidth, kCountLength);
+		packet.putBits(1, 1);
+		packet.putBits(color >> 4, 4);
+		packet.putBits(color & 15, 4);
+
+		// No patterns, motion values, DCs or runs
+		if (y == 0)
+			for (int i = 0; i < 6; i++)
+				packet.putBits(0, kCountLength);
+	}
+
+	packet.align();
+}
+
+/** Write a BIKi packet with an alpha plane. The plane offset values hold the absolute byte
+ *  offset of the next plane, shifted by offsetError. */
+static std::vector<byte> writePacket(byte color, uint32 offsetError = 0) {
+	PacketWriter packet;
+
+	const size_t alphaValue = packet.pos();
+	packet.putBits(0, 32);
+	writePlane(packet, kWidth >> 3, kHeight >> 3, color);
+
+	packet.patchUint32(alphaValue, packet.pos() / 8 + offsetError);
+
+	const size_t lumaValue = packet.pos();
+	packet.putBits(0, 32);
+	writePlane(packet, kWidth >> 3, kHeight >> 3, color + 50);
+
+	packet.patchUint32(lumaValue, packet.pos() / 8 + offsetError);
+
+	writePlane(packet, kWidth >> 4, kHeight >> 4, color + 100);
+	writePlane(packet, kWidth >> 4, kHeight >> 4, color + 150);
+
+	return packet.getData();
+}
+
+static void decodeFrame(Video::BinkVideoCodec &codec, Graphics::Surface &surface, const std::vector<byte> &packet) {
+	Common::MemoryReadStream stream(&packet[0], packet.size());
+
+	codec.decodeFrame(surface, stream);
+}
+
+GTEST_TEST(BinkVideoCodec, decodeParallel) {
+	Video::BinkVideoCodec sequential(kWidth, kHeight, kBIKiID, true, true, 0);
+	Video::BinkVideoCodec parallel  (kWidth, kHeight, kBIKiID, true, true, 2);
+
+	Graphics::Surface sequentialSurface(kWidth, kHeight);
+	Graphics::Surface parallelSurface  (kWidth, kHeight);
+
+	for (byte i = 0; i < 4; i++) {
+		const std::vector<byte> packet = writePacket(i * 16);
+
+		decodeFrame(sequential, sequentialSurface, packet);
+		decodeFrame(parallel  , parallelSurface  , packet);
+
+		EXPECT_EQ(std::memcmp(sequentialSurface.getData(), parallelSurface.getData(), kWidth * kHeight * 4), 0)
+			<< "At frame " << (uint)i;
+	}
+
+	// The first frame is always decoded sequentially, to learn where the planes start
+	EXPECT_EQ(sequential.getParallelFrameCount(), 0);
+	EXPECT_EQ(parallel.getParallelFrameCount(), 3);
+}
+
+GTEST_TEST(BinkVideoCodec, decodeParallelOffsetMismatch) {
+	Video::BinkVideoCodec sequential(kWidth, kHeight, kBIKiID, true, true, 0);
+	Video::BinkVideoCodec parallel  (kWidth, kHeight, kBIKiID, true, true, 2);
+
+	Graphics::Surface sequentialSurface(kWidth, kHeight);
+	Graphics::Surface parallelSurface  (kWidth, kHeight);
+
+	for (byte i = 0; i < 4; i++) {
+		// After the first frame, the offset values stop pointing to the planes
+		const std::vector<byte> packet = writePacket(i * 16, (i == 0) ? 0 : 4);
+
+		decodeFrame(sequential, sequentialSurface, packet);
+		decodeFrame(parallel  , parallelSurface  , packet);
+
+		EXPECT_EQ(std::memcmp(sequentialSurface.getData(), parallelSurface.getData(), kWidth * kHeight * 4), 0)
+			<< "At frame " << (uint)i;
+	}
+
+	EXPECT_EQ(parallel.getParallelFrameCount(), 0);
+}
@@ -0,0 +1,60 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+
+# Unit tests and benchmarks for the video decoders and their conversion kernels.
+
+video_LIBS = \
+    $(test_LIBS) \
+    src/video/codecs/libcodecs.la \
+    src/graphics/libgraphics.la \
+    src/aurora/libaurora.la \
+    src/common/libcommon.la \
+    tests/version/libversion.la \
+    $(LDADD)
+
+check_PROGRAMS                      += tests/video/test_binkvideo
+tests_video_test_binkvideo_SOURCES  = tests/video/binkvideo.cpp
+tests_video_test_binkvideo_LDADD    = $(video_LIBS)
+tests_video_test_binkvideo_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                    += tests/video/test_binkdsp
+tests_video_test_binkdsp_SOURCES  = tests/video/binkdsp.cpp
+tests_video_test_binkdsp_LDADD    = $(video_LIBS)
+tests_video_test_binkdsp_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/video/test_yuv_to_rgb
+tests_video_test_yuv_to_rgb_SOURCES  = tests/video/yuv_to_rgb.cpp
+tests_video_test_yuv_to_rgb_LDADD    = $(video_LIBS)
+tests_video_test_yuv_to_rgb_CXXFLAGS = $(test_CXXFLAGS)
+
+# Benchmarks
+
+video_BENCH_LIBS = \
+    src/video/codecs/libcodecs.la \
+    src/graphics/libgraphics.la \
+    src/aurora/libaurora.la \
+    src/common/libcommon.la \
+    tests/version/libversion.la \
+    $(LDADD)
+
+BENCHMARKS                     += tests/video/bench_bink
+tests_video_bench_bink_SOURCES  = tests/video/bench_bink.cpp
+tests_video_bench_bink_LDADD    = $(video_BENCH_LIBS)
+tests_video_bench_bink_CXXFLAGS = $(AM_CXXFLAGS)
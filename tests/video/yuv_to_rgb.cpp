@@ -0,0 +1,139 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the YUV to RGB conversion.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+
+#include "src/graphics/yuv_to_rgb.h"
+
+/** Fill the data with deterministic pseudo-random bytes. */
+static void fillRandom(std::vector<byte> &data, uint32 seed) {
+	for (std::vector<byte>::iterator d = data.begin(); d != data.end(); ++d) {
+		seed = seed * 1103515245 + 12345;
+
+		*d = seed >> 16;
+	}
+}
+
+/** Convert a random image with and without SIMD, and make sure the results are identical. */
+static void compareConversion(Graphics::YUVToRGBManager::LuminanceScale scale, bool alpha, int width, int height) {
+	// Pad all pitches, to make sure nothing outside the image is read or written
+	const int yPitch   = width + 5;
+	const int uvPitch  = width / 2 + 3;
+	const int dstPitch = width * 4 + 12;
+
+	std::vector<byte> y(yPitch * height), a(yPitch * height);
+	std::vector<byte> u(uvPitch * height / 2), v(uvPitch * height / 2);
+
+	fillRandom(y, width * 3 + height);
+	fillRandom(a, width * 5 + height);
+	fillRandom(u, width * 7 + height);
+	fillRandom(v, width * 9 + height);
+
+	std::vector<byte> output[2];
+	for (int simd = 0; simd < 2; simd++) {
+		output[simd].resize(dstPitch * height, 0xCD);
+
+		if (alpha)
+			YUVToRGBMan.convert420(scale, &output[simd][0], dstPitch, &y[0], &u[0], &v[0], &a[0],
+			                       width, height, yPitch, uvPitch, simd != 0);
+		else
+			YUVToRGBMan.convert420(scale, &output[simd][0], dstPitch, &y[0], &u[0], &v[0],
+			                       width, height, yPitch, uvPitch, simd != 0);
+	}
+
+	for (size_t i = 0; i < output[0].size(); i++) {
+		ASSERT_EQ(output[1][i], output[0][i]) << width << "x" << height << ", scale " << (int) scale
+		                                      << ", alpha " << alpha << ", pixel " << ((i % dstPitch) / 4)
+		                                      << "." << (i / dstPitch) << ", channel " << (i % 4);
+	}
+}
+
+static void compareConversion(Graphics::YUVToRGBManager::LuminanceScale scale, bool alpha) {
+	static const int kSizes[][2] = {
+		{  2,  2 }, { 14,  2 }, { 16,  2 }, { 18,  4 }, { 30,  6 }, { 32, 32 },
+		{ 34, 10 }, { 50, 20 }, { 64, 48 }, { 98, 14 }, { 320, 240 }
+	};
+
+	for (size_t i = 0; i < ARRAYSIZE(kSizes); i++)
+		compareConversion(scale, alpha, kSizes[i][0], kSizes[i][1]);
+}
+
+GTEST_TEST(YUVToRGB, convert420Full) {
+	compareConversion(Graphics::YUVToRGBManager::kScaleFull, false);
+}
+
+GTEST_TEST(YUVToRGB, convert420FullAlpha) {
+	compareConversion(Graphics::YUVToRGBManager::kScaleFull, true);
+}
+
+GTEST_TEST(YUVToRGB, convert420ITU) {
+	compareConversion(Graphics::YUVToRGBManager::kScaleITU, false);
+}
+
+GTEST_TEST(YUVToRGB, convert420ITUAlpha) {
+	compareConversion(Graphics::YUVToRGBManager::kScaleITU, true);
+}
+
+/** Go through all combinations of luminance and chroma values. */
+static void compareAllValues(Graphics::YUVToRGBManager::LuminanceScale scale) {
+	const int width = 512, height = 512, uvPitch = width / 2;
+
+	std::vector<byte> y(width * height), u(uvPitch * height / 2), v(uvPitch * height / 2);
+
+	for (int i = 0; i < 256; i++) {
+		for (int j = 0; j < 256; j++) {
+			u[j * uvPitch + i] = i;
+			v[j * uvPitch + i] = j;
+		}
+	}
+
+	for (int k = 0; k < 256; k++) {
+		for (size_t i = 0; i < y.size(); i++)
+			y[i] = i + k;
+
+		std::vector<byte> output[2];
+		for (int simd = 0; simd < 2; simd++) {
+			output[simd].resize(width * height * 4);
+
+			YUVToRGBMan.convert420(scale, &output[simd][0], width * 4, &y[0], &u[0], &v[0],
+			                       width, height, width, uvPitch, simd != 0);
+		}
+
+		for (size_t i = 0; i < output[0].size(); i++)
+			ASSERT_EQ(output[1][i], output[0][i]) << "Scale " << (int) scale << ", luminance offset " << k
+			                                      << ", pixel " << (i / 4) << ", channel " << (i % 4);
+	}
+}
+
+GTEST_TEST(YUVToRGB, convert420AllValuesFull) {
+	compareAllValues(Graphics::YUVToRGBManager::kScaleFull);
+}
+
+GTEST_TEST(YUVToRGB, convert420AllValuesITU) {
+	compareAllValues(Graphics::YUVToRGBManager::kScaleITU);
+}